@@ -0,0 +1,61 @@
+# SPDX-License-Identifier: GPL-3.0-or-later
+# EMStudioHeadless – QtCore-only command line front end of EMStudio (-run, -check, -combine, ...)
+
+QT       = core
+CONFIG  += console c++17
+CONFIG  -= app_bundle
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+include(emstudio_core.pri)
+SOURCES += src/headlessmain.cpp
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
+
+# -----------------------------------------------------------------------------
+# Versioning: MAJOR.MINOR
+# - MAJOR is set manually
+# - MINOR = number of commits since tag v<MAJOR>.0
+# - If tag does not exist, fallback to total commit count
+# -----------------------------------------------------------------------------
+
+EMSTUDIO_MAJOR = 1
+EMSTUDIO_TAG   = v$${EMSTUDIO_MAJOR}.0
+EMSTUDIO_MINOR = 0
+
+win32 {
+    GIT_EXISTS = $$system(git --version >NUL 2>NUL && echo yes)
+
+    equals(GIT_EXISTS, yes) {
+        HAS_TAG = $$system(git rev-parse -q --verify refs/tags/$${EMSTUDIO_TAG} >NUL 2>NUL && echo yes)
+
+        equals(HAS_TAG, yes) {
+            EMSTUDIO_MINOR = $$system(git rev-list --count $${EMSTUDIO_TAG}..HEAD)
+        } else {
+            EMSTUDIO_MINOR = $$system(git rev-list --count HEAD)
+        }
+    }
+}
+
+unix {
+    GIT_EXISTS = $$system(git --version >/dev/null 2>&1 && echo yes)
+
+    equals(GIT_EXISTS, yes) {
+        HAS_TAG = $$system(git rev-parse -q --verify refs/tags/$${EMSTUDIO_TAG} >/dev/null 2>&1 && echo yes)
+
+        equals(HAS_TAG, yes) {
+            EMSTUDIO_MINOR = $$system(git rev-list --count $${EMSTUDIO_TAG}..HEAD)
+        } else {
+            EMSTUDIO_MINOR = $$system(git rev-list --count HEAD)
+        }
+    }
+}
+
+EMSTUDIO_VERSION = $${EMSTUDIO_MAJOR}.$${EMSTUDIO_MINOR}
+
+message(EMStudio version: $${EMSTUDIO_VERSION})
+
+DEFINES += EMSTUDIO_VERSION_STR=\\\"$${EMSTUDIO_VERSION}\\\"
+DEFINES += EMSTUDIO_MAJOR=$$EMSTUDIO_MAJOR
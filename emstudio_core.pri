@@ -0,0 +1,60 @@
+# emstudio_core.pri
+# Simulation run pipeline, result readers and command line modes: QtCore only.
+# Shared by the GUI (via emstudio_sources.pri), the tests and EMStudioHeadless.pro.
+
+isEmpty(TOP): TOP = $$PWD
+TOP = $$clean_path($$TOP)
+
+INCLUDEPATH += $$TOP/src
+
+# parallelfor.h runs kernels on std::thread (-pthread on Unix).
+CONFIG += thread
+
+SOURCES += \
+    $$TOP/src/commandline.cpp \
+    $$TOP/src/elmerresults.cpp \
+    $$TOP/src/hardwaretopology.cpp \
+    $$TOP/src/headlessrun.cpp \
+    $$TOP/src/palacesparameters.cpp \
+    $$TOP/src/parametersweep.cpp \
+    $$TOP/src/pathprobe.cpp \
+    $$TOP/src/processtelemetry.cpp \
+    $$TOP/src/pythonparser.cpp \
+    $$TOP/src/resultstore.cpp \
+    $$TOP/src/runcache.cpp \
+    $$TOP/src/runreport.cpp \
+    $$TOP/src/shellsession.cpp \
+    $$TOP/src/simulationloganalyzer.cpp \
+    $$TOP/src/simulationqueue.cpp \
+    $$TOP/src/simulationrunner.cpp \
+    $$TOP/src/sparameterchecks.cpp \
+    $$TOP/src/sparametercombiner.cpp \
+    $$TOP/src/touchstone.cpp \
+    $$TOP/src/tracer.cpp \
+    $$TOP/src/vectorfit.cpp \
+    $$TOP/src/wslHelper.cpp
+
+HEADERS += \
+    $$TOP/src/commandline.h \
+    $$TOP/src/elmerresults.h \
+    $$TOP/src/hardwaretopology.h \
+    $$TOP/src/headlessrun.h \
+    $$TOP/src/palacesparameters.h \
+    $$TOP/src/parallelfor.h \
+    $$TOP/src/parametersweep.h \
+    $$TOP/src/pathprobe.h \
+    $$TOP/src/processtelemetry.h \
+    $$TOP/src/pythonparser.h \
+    $$TOP/src/resultstore.h \
+    $$TOP/src/runcache.h \
+    $$TOP/src/runreport.h \
+    $$TOP/src/shellsession.h \
+    $$TOP/src/simulationloganalyzer.h \
+    $$TOP/src/simulationqueue.h \
+    $$TOP/src/simulationrunner.h \
+    $$TOP/src/sparameterchecks.h \
+    $$TOP/src/sparametercombiner.h \
+    $$TOP/src/touchstone.h \
+    $$TOP/src/tracer.h \
+    $$TOP/src/vectorfit.h \
+    $$TOP/src/wslHelper.h
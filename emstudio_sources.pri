@@ -7,9 +7,9 @@ TOP = $$clean_path($$TOP)
 
 INCLUDEPATH += $$TOP $$TOP/src $$TOP/extension $$TOP/QtPropertyBrowser
 
+include($$TOP/emstudio_core.pri)
+
 SOURCES += \
-    $$TOP/src/headless.cpp \
-    $$TOP/src/wslHelper.cpp \
     $$TOP/src/about.cpp \
     $$TOP/src/tips.cpp \
     $$TOP/src/keywordseditor.cpp \
@@ -37,17 +37,20 @@ SOURCES += \
     $$TOP/src/pythonToEditor.cpp \
     $$TOP/src/pythonToStudio.cpp \
     $$TOP/src/pythoneditor.cpp \
-    $$TOP/src/pythonparser.cpp \
     $$TOP/src/pythonsyntaxhighlighter.cpp \
     $$TOP/src/runOpenEms.cpp \
     $$TOP/src/runPalace.cpp \
+    $$TOP/src/runQueue.cpp \
+    $$TOP/src/simulationlog.cpp \
+    $$TOP/src/sparameterviewer.cpp \
     $$TOP/src/substrate.cpp \
     $$TOP/src/substrateview.cpp \
+    $$TOP/src/telemetrysparklines.cpp \
+    $$TOP/src/textsearchengine.cpp \
     $$TOP/src/verification.cpp \
     $$TOP/src/xmlreader.cpp
 
 HEADERS += \
-    $$TOP/src/wslHelper.h \
     $$TOP/src/about.h \
     $$TOP/src/keywordseditor.h \
     $$TOP/QtPropertyBrowser/qtbuttonpropertybrowser.h \
@@ -72,7 +75,10 @@ HEADERS += \
     $$TOP/src/material.h \
     $$TOP/src/preferences.h \
     $$TOP/src/pythoneditor.h \
-    $$TOP/src/pythonparser.h \
     $$TOP/src/pythonsyntaxhighlighter.h \
+    $$TOP/src/simulationlog.h \
+    $$TOP/src/sparameterviewer.h \
     $$TOP/src/substrate.h \
-    $$TOP/src/substrateview.h
+    $$TOP/src/substrateview.h \
+    $$TOP/src/telemetrysparklines.h \
+    $$TOP/src/textsearchengine.h
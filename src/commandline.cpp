@@ -0,0 +1,344 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QTimer>
+#include <QDebug>
+#include <QFileInfo>
+#include <QCoreApplication>
+
+#include <cstdio>
+
+#include "commandline.h"
+#include "headlessrun.h"
+#include "resultstore.h"
+#include "runreport.h"
+#include "sparameterchecks.h"
+
+/*!*******************************************************************************************************************
+ * \brief Selects the mode of the command line; a second, different mode is an error.
+ **********************************************************************************************************************/
+static bool selectMode(CommandLine::Options &out, CommandLine::Mode mode, const QString &arg, QString &outError)
+{
+    if (out.mode != CommandLine::Mode::Gui && out.mode != mode) {
+        outError = QString("%1 cannot be combined with another command").arg(arg);
+        return false;
+    }
+    out.mode = mode;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses the command line arguments.
+ *
+ * Nothing is executed here; -trace only records the trace file, so the caller decides when tracing starts.
+ *
+ * \param args      Arguments including the program name, as returned by QCoreApplication::arguments().
+ * \param out       Receives the parsed options; Mode::Gui if no command was given.
+ * \param outError  Receives a message for unknown, malformed or conflicting arguments.
+ * \return True if the arguments are valid.
+ **********************************************************************************************************************/
+bool CommandLine::parse(const QStringList &args, Options &out, QString &outError)
+{
+    out = Options();
+
+    for (int i = 1; i < args.size(); ++i) {
+        const QString &arg = args[i];
+
+        if (arg == "-h" || arg == "--help") {
+            out.mode = Mode::Help;
+            return true;
+        } else if (arg == "-gdsfile" && i + 1 < args.size()) {
+            out.gdsFile = args[++i];
+        } else if (arg == "-topcell" && i + 1 < args.size()) {
+            out.topCell = args[++i];
+        } else if (arg == "-run") {
+            if (!selectMode(out, Mode::Run, arg, outError))
+                return false;
+        } else if (arg == "-palace") {
+            out.runTool = "palace";
+        } else if (arg == "-openems") {
+            out.runTool = "openems";
+        } else if (arg == "-sweep" && i + 1 < args.size()) {
+            out.sweepFile = args[++i];
+        } else if (arg == "-nocache") {
+            out.useRunCache = false;
+        } else if (arg == "-pipeline") {
+            out.pipelined = true;
+        } else if (arg == "-aggregate-reports" && i + 1 < args.size()) {
+            if (!selectMode(out, Mode::AggregateReports, arg, outError))
+                return false;
+            out.target = args[++i];
+        } else if (arg == "-results" && i + 1 < args.size()) {
+            if (!selectMode(out, Mode::Results, arg, outError))
+                return false;
+            out.target = args[++i];
+        } else if (arg == "-golden" && i + 1 < args.size()) {
+            if (!selectMode(out, Mode::Golden, arg, outError))
+                return false;
+            out.target = args[++i];
+        } else if (arg == "-check" && i + 1 < args.size()) {
+            if (!selectMode(out, Mode::Check, arg, outError))
+                return false;
+            out.target = args[++i];
+        } else if (arg == "-combine" && i + 2 < args.size()) {
+            if (!selectMode(out, Mode::Combine, arg, outError))
+                return false;
+            out.target = args[++i];
+            while (i + 1 < args.size() && !args[i + 1].startsWith(QLatin1Char('-')))
+                out.inputs << args[++i];
+        } else if (arg == "-interp" && i + 1 < args.size()) {
+            if (!SParameterCombiner::parseInterpolation(args[++i], out.combineOptions.interpolation)) {
+                outError = QString("Unknown interpolation: %1").arg(args[i]);
+                return false;
+            }
+        } else if (arg == "-grid" && i + 1 < args.size()) {
+            const QStringList parts = args[++i].split(QLatin1Char(':'));
+            if (parts.size() != 3 || parts.at(2).toInt() < 1) {
+                outError = QString("Malformed grid, expected fmin:fmax:n in GHz: %1").arg(args[i]);
+                return false;
+            }
+            out.combineOptions.targetFrequencies = SParameterCombiner::linearGrid(parts.at(0).toDouble() * 1e9,
+                                                                                  parts.at(1).toDouble() * 1e9,
+                                                                                  parts.at(2).toInt());
+        } else if (arg == "-nodc") {
+            out.combineOptions.extendToDc = false;
+        } else if (arg == "-vectorfit" && i + 1 < args.size()) {
+            if (!selectMode(out, Mode::VectorFit, arg, outError))
+                return false;
+            out.target = args[++i];
+        } else if (arg == "-poles" && i + 1 < args.size()) {
+            out.vectorFitOptions.poles = args[++i].toInt();
+        } else if (arg == "-nopassivity") {
+            out.vectorFitOptions.enforcePassivity = false;
+        } else if (arg == "-trace" && i + 1 < args.size()) {
+            out.traceFile = args[++i];
+        } else if (arg == "-cores" && i + 1 < args.size()) {
+            out.coreBudget = args[++i].toInt();
+        } else if (arg.endsWith(".py", Qt::CaseInsensitive)) {
+            out.pythonFiles << arg;
+        } else {
+            outError = QString("Unknown or malformed argument: %1").arg(arg);
+            return false;
+        }
+    }
+
+    if (out.mode == Mode::Run && out.runTool.isEmpty()) {
+        outError = "Headless mode requires backend: use -palace or -openems together with -run";
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns whether the raw arguments request a mode without GUI.
+ *
+ * Used before the application object exists, to create a plain QCoreApplication for these modes: they never
+ * instantiate widgets, so they need neither a display nor a Qt platform plugin.
+ **********************************************************************************************************************/
+bool CommandLine::requestsHeadless(int argc, char *argv[])
+{
+    static const char *const commands[] = {
+        "-h", "--help", "-run", "-aggregate-reports", "-results", "-golden", "-check", "-combine", "-vectorfit"
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        for (const char *command : commands) {
+            if (!qstrcmp(argv[i], command))
+                return true;
+        }
+    }
+    return false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Executes a mode that needs no GUI; requires a QCoreApplication.
+ *
+ * \param options Parsed options; Mode::Gui is rejected.
+ * \return The process exit code.
+ **********************************************************************************************************************/
+int CommandLine::exec(const Options &options)
+{
+    switch (options.mode) {
+    case Mode::Help:
+        printHelp();
+        return 0;
+    case Mode::Run:
+        return execRun(options);
+    case Mode::AggregateReports: {
+        const QByteArray csv = RunReport::aggregateCsv(RunReport::findReports(options.target));
+        fwrite(csv.constData(), 1, size_t(csv.size()), stdout);
+        return 0;
+    }
+    case Mode::Results: {
+        const QByteArray csv = ResultStore().summaryCsv(options.target == "all" ? QString() : options.target, 20);
+        fwrite(csv.constData(), 1, size_t(csv.size()), stdout);
+        return 0;
+    }
+    case Mode::Golden: {
+        ResultStore store;
+        const ResultStore::RunInfo info = store.run(options.target);
+        QString err;
+        if (!store.setGolden(info.cell, info.id, err)) {
+            qWarning() << (info.isValid() ? err : QString("Unknown run %1").arg(options.target));
+            return 1;
+        }
+        return 0;
+    }
+    case Mode::Check:
+        return execCheck(options);
+    case Mode::Combine:
+        return execCombine(options);
+    case Mode::VectorFit:
+        return execVectorFit(options);
+    case Mode::Gui:
+        break;
+    }
+
+    qWarning() << "No command given; the GUI is not available here";
+    printHelp();
+    return 1;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Simulates the models of a -run through HeadlessRun and returns its exit code.
+ **********************************************************************************************************************/
+int CommandLine::execRun(const Options &options)
+{
+    QStringList pythonFiles = options.pythonFiles;
+    if (pythonFiles.isEmpty())
+        pythonFiles << QString();
+
+    QList<HeadlessRun::Options> runs;
+    for (const QString &file : pythonFiles) {
+        HeadlessRun::Options run;
+        run.simKey     = options.runTool;
+        run.pythonFile = file;
+        run.gdsFile    = options.gdsFile;
+        run.topCell    = options.topCell;
+        runs << run;
+    }
+
+    HeadlessRun run(runs, options.coreBudget);
+    run.setSweepFile(options.sweepFile);
+    run.setRunCacheEnabled(options.useRunCache);
+    run.setPipelined(options.pipelined);
+    QTimer::singleShot(0, &run, [&run]() {
+        run.start();
+    });
+    return QCoreApplication::exec();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks an S-parameter file for passivity, reciprocity and causality; exit code 1 if a check fails.
+ **********************************************************************************************************************/
+int CommandLine::execCheck(const Options &options)
+{
+    Touchstone::Network network;
+    QString err;
+    if (!SParameterCombiner::readSweep(options.target, network, err)) {
+        qWarning() << err;
+        return 1;
+    }
+    const SParameterChecks::Result result = SParameterChecks::check(network);
+    const QByteArray text = result.summary().join(QLatin1Char('\n')).toUtf8() + '\n';
+    fwrite(text.constData(), 1, size_t(text.size()), stdout);
+    return result.passed() ? 0 : 1;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Merges the -combine input sweeps and writes the result as Touchstone file.
+ **********************************************************************************************************************/
+int CommandLine::execCombine(const Options &options)
+{
+    Touchstone::Network network;
+    QString err;
+    if (!SParameterCombiner::combine(options.inputs, options.combineOptions, network, err) ||
+        !Touchstone::write(options.target, network, Touchstone::WriteOptions(), err)) {
+        qWarning() << err;
+        return 1;
+    }
+    return 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Fits a rational model to an S-parameter file and writes it as JSON and SPICE subcircuit next to it.
+ **********************************************************************************************************************/
+int CommandLine::execVectorFit(const Options &options)
+{
+    Touchstone::Network network;
+    VectorFit::Model model;
+    QString err;
+    const QFileInfo info(options.target);
+    const QString base = QDir(info.absolutePath()).filePath(info.completeBaseName() + "_vf");
+    if (!SParameterCombiner::readSweep(options.target, network, err) ||
+        !VectorFit::fit(network, options.vectorFitOptions, model, err) ||
+        !VectorFit::writeJson(base + ".json", model, err) ||
+        !VectorFit::writeSpice(base + ".cir", model, err)) {
+        qWarning() << err;
+        return 1;
+    }
+    const QByteArray text = model.summary().join(QLatin1Char('\n')).toUtf8() + '\n';
+    fwrite(text.constData(), 1, size_t(text.size()), stdout);
+    return model.passive || !options.vectorFitOptions.enforcePassivity ? 0 : 1;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Prints usage information for the EMStudio application.
+ *
+ * This function outputs the command-line usage and available options for the application.
+ **********************************************************************************************************************/
+void CommandLine::printHelp()
+{
+    qDebug() << "Usage: EMStudio [options] [model.py]";
+    qDebug() << "       EMStudioHeadless [options] [model.py]   (all options except the GUI, QtCore only)";
+    qDebug() << "\nOptions:";
+    qDebug() << "  -h, --help            Show this help message";
+    qDebug() << "  -gdsfile <path>       Specify path to GDS file";
+    qDebug() << "  -topcell <name>       Specify name of the top cell in the GDS file";
+    qDebug() << "  -run                  Run simulation headless (no GUI, no display required)";
+    qDebug() << "  -palace               Select Palace backend (with -run)";
+    qDebug() << "  -openems              Select OpenEMS backend (with -run)";
+    qDebug() << "  -cores <n>            Core budget shared by all models of a -run (default: detected cores)";
+    qDebug() << "  -sweep <file>         Run a parameter sweep over the model (with -run)";
+    qDebug() << "  -nocache              Always run the full pipeline, ignoring cached runs (with -run)";
+    qDebug() << "  -pipeline             Run the models back to back, preprocessing the next model while";
+    qDebug() << "                        the current solver runs (with -run)";
+    qDebug() << "  -aggregate-reports <dir>  Print the run_report.json files found below <dir> as CSV";
+    qDebug() << "  -results <cell>       Print the latest 20 stored runs of <cell> as CSV, with their deviation";
+    qDebug() << "                        from the golden run (\"all\" lists every cell)";
+    qDebug() << "  -golden <run id>      Mark a stored run as golden reference of its cell";
+    qDebug() << "  -check <file>         Check a Touchstone file (or Palace port-S.csv, Elmer .names) for";
+    qDebug() << "                        passivity, reciprocity and causality; exit code 1 if a check fails";
+    qDebug() << "  -combine <out> <in>...  Merge sweeps of one model (Touchstone, port-S.csv, Elmer .names),";
+    qDebug() << "                        extend them to DC and write Touchstone file <out>";
+    qDebug() << "  -interp <method>      Interpolation for -combine -grid: linear, spline (default), rational";
+    qDebug() << "  -grid <fmin:fmax:n>   Resample the -combine result onto n points from fmin to fmax (GHz)";
+    qDebug() << "  -nodc                 Do not extend the -combine result to DC";
+    qDebug() << "  -vectorfit <file>     Fit a passive rational model to an S-parameter file and write it next to";
+    qDebug() << "                        it as <name>_vf.json and SPICE subcircuit <name>_vf.cir";
+    qDebug() << "  -poles <n>            Number of poles for -vectorfit (default 16)";
+    qDebug() << "  -nopassivity          Do not enforce passivity of the -vectorfit model";
+    qDebug() << "  -trace <file>         Write a Chrome trace (chrome://tracing, ui.perfetto.dev) of EMStudio";
+    qDebug() << "                        itself to <file> on exit; also enabled by EMSTUDIO_TRACE=<file>";
+    qDebug() << "\nArguments:";
+    qDebug() << "  model.py              Python model to load (optional, but usually needed);";
+    qDebug() << "                        with -run several models are simulated concurrently";
+}
@@ -0,0 +1,77 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <QString>
+#include <QStringList>
+
+#include "sparametercombiner.h"
+#include "vectorfit.h"
+
+/*!*******************************************************************************************************************
+ * \class CommandLine
+ * \brief Parses the EMStudio command line and executes the modes that need no GUI.
+ *
+ * Headless runs (-run), report aggregation, result store queries and the S-parameter tools (-check, -combine,
+ * -vectorfit) depend on QtCore only. Both the GUI executable and the QtCore-only EMStudioHeadless executable
+ * parse their arguments here and hand every mode except Mode::Gui to exec(), so the two accept the same
+ * options and behave the same.
+ **********************************************************************************************************************/
+class CommandLine
+{
+public:
+    enum class Mode { Gui, Help, Run, AggregateReports, Results, Golden, Check, Combine, VectorFit };
+
+    struct Options
+    {
+        Mode                        mode = Mode::Gui;
+
+        QString                     gdsFile;
+        QString                     topCell;
+        QStringList                 pythonFiles;
+        QString                     traceFile;
+
+        QString                     runTool;        // "palace" or "openems" (with -run)
+        int                         coreBudget = 0;
+        QString                     sweepFile;
+        bool                        useRunCache = true;
+        bool                        pipelined = false;
+
+        QString                     target;         // report directory, cell, run id or S-parameter file
+        QStringList                 inputs;         // -combine input sweeps
+        SParameterCombiner::Options combineOptions;
+        VectorFit::Options          vectorFitOptions;
+    };
+
+    static bool                 parse(const QStringList &args, Options &out, QString &outError);
+    static bool                 requestsHeadless(int argc, char *argv[]);
+    static int                  exec(const Options &options);
+    static void                 printHelp();
+
+private:
+    static int                  execRun(const Options &options);
+    static int                  execCheck(const Options &options);
+    static int                  execCombine(const Options &options);
+    static int                  execVectorFit(const Options &options);
+};
+
+#endif // COMMANDLINE_H
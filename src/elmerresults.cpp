@@ -0,0 +1,349 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QJsonObject>
+#include <QDirIterator>
+#include <QJsonDocument>
+
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+
+#include "elmerresults.h"
+#include "sparametercombiner.h"
+
+namespace {
+
+constexpr double kTwoPi = 6.28318530717958647692;
+
+/*!*******************************************************************************************************************
+ * \brief Returns the index of the first of \a names present in \a columns, or -1.
+ **********************************************************************************************************************/
+int indexOfAny(const QStringList &columns, std::initializer_list<const char *> names)
+{
+    for (const char *name : names) {
+        const int i = columns.indexOf(QLatin1String(name));
+        if (i >= 0)
+            return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Reads the column names of an Elmer .names file.
+ *
+ * Column lines start with their 1-based number followed by a colon ("  2: res: cmf 1 1"); the name is the text
+ * after the second colon, or after the first if there is only one. Header lines are skipped.
+ *
+ * \param namesPath  Path of the .names file.
+ * \param outColumns Receives the column names in file order.
+ * \param outError   Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ElmerResults::readNames(const QString &namesPath, QStringList &outColumns, QString &outError)
+{
+    QFile file(namesPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        outError = QString("Cannot open Elmer names file %1").arg(QDir::toNativeSeparators(namesPath));
+        return false;
+    }
+
+    outColumns.clear();
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || !line.at(0).isDigit())
+            continue;
+
+        const QStringList parts = line.split(QLatin1Char(':'));
+        if (parts.size() < 2)
+            continue;
+        outColumns << (parts.size() >= 3 ? parts.at(2) : parts.at(1)).trimmed();
+    }
+
+    if (outColumns.isEmpty()) {
+        outError = QString("No columns listed in %1").arg(QDir::toNativeSeparators(namesPath));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Locates frequency and S-parameter columns.
+ *
+ * The port count follows from the number of "cmf" columns (real and imaginary block of ports^2 each); the
+ * imaginary block must directly follow the real one.
+ *
+ * \param columns  Column names from readNames().
+ * \param out      Receives the layout.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ElmerResults::layoutFromColumns(const QStringList &columns, Layout &out, QString &outError)
+{
+    out = Layout();
+    out.columns = columns.size();
+
+    int cmfCount = 0;
+    for (const QString &name : columns)
+        if (name.startsWith(QLatin1String("cmf")))
+            ++cmfCount;
+
+    out.ports = int(std::lround(std::sqrt(cmfCount / 2.0)));
+    if (out.ports <= 0 || 2 * out.ports * out.ports != cmfCount) {
+        outError = QString("Unexpected number of cmf columns (%1)").arg(cmfCount);
+        return false;
+    }
+
+    out.omegaColumn = columns.indexOf(QLatin1String("angular frequency"));
+    out.realColumn  = indexOfAny(columns, { "cmf 1 1", "cmf 11" });
+    out.imagColumn  = indexOfAny(columns, { "cmf im 1 1", "cmf im 11" });
+
+    if (out.omegaColumn < 0) {
+        outError = QStringLiteral("No angular frequency column");
+        return false;
+    }
+    if (out.realColumn < 0 || out.imagColumn < 0) {
+        outError = QStringLiteral("No cmf 1 1 / cmf im 1 1 columns");
+        return false;
+    }
+    if (out.realColumn + out.ports * out.ports != out.imagColumn ||
+        out.imagColumn + out.ports * out.ports > out.columns) {
+        outError = QString("cmf columns do not match a %1-port S-matrix").arg(out.ports);
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses Elmer scalar result rows into a network.
+ *
+ * One row per line; blank lines are skipped. A last line without line break that stops before the needed columns
+ * (the solver is still writing) is ignored; a complete line that does is an error.
+ *
+ * \param begin    Start of the data.
+ * \param end      End of the data.
+ * \param layout   Column layout from layoutFromColumns().
+ * \param out      Receives the network (S-parameters, 50 ohm references).
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ElmerResults::parseData(const char *begin, const char *end, const Layout &layout,
+                             Touchstone::Network &out, QString &outError)
+{
+    const int ports = layout.ports;
+    const int perPoint = ports * ports;
+    const int lastColumn = qMax(layout.omegaColumn, layout.imagColumn + perPoint - 1);
+
+    out = Touchstone::Network();
+    out.resize(ports, 0);
+
+    QVector<double> row(lastColumn + 1);
+    double *fields = row.data();
+
+    int lineNumber = 0;
+    const char *pos = begin;
+    while (pos < end) {
+        const char *eol = static_cast<const char *>(std::memchr(pos, '\n', size_t(end - pos)));
+        const bool complete = eol != nullptr;
+        if (!eol)
+            eol = end;
+        ++lineNumber;
+
+        const char *p = pos;
+        pos = complete ? eol + 1 : end;
+
+        int n = 0;
+        while (n <= lastColumn && Touchstone::parseNumber(p, eol, fields[n]))
+            ++n;
+
+        if (n == 0) {
+            while (p < eol && (*p == ' ' || *p == '\t' || *p == '\r'))
+                ++p;
+            if (p == eol)
+                continue;
+        }
+        if (n <= lastColumn) {
+            if (!complete)
+                break;
+            outError = QString("Line %1: expected at least %2 values").arg(lineNumber).arg(lastColumn + 1);
+            return false;
+        }
+
+        if (out.frequencies.isEmpty()) {
+            // Rows have the same length: size the arrays once from the first one.
+            const qint64 estimate = qint64(end - begin) / qMax<qint64>(1, qint64(eol - begin) + 1);
+            out.frequencies.reserve(int(qMin<qint64>(estimate + 1, 1 << 24)));
+            out.values.reserve(out.frequencies.capacity() * perPoint);
+        }
+
+        out.frequencies.append(fields[layout.omegaColumn] / kTwoPi);
+        const double *re = fields + layout.realColumn;
+        const double *im = fields + layout.imagColumn;
+        for (int k = 0; k < perPoint; ++k)
+            out.values.append(Touchstone::Complex(re[k], -im[k]));
+    }
+
+    if (out.frequencies.isEmpty()) {
+        outError = QStringLiteral("No data rows");
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads an Elmer result pair; the data file is the .names path without its suffix.
+ *
+ * \param namesPath Path of the .names file.
+ * \param out       Receives the network.
+ * \param outError  Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ElmerResults::read(const QString &namesPath, Touchstone::Network &out, QString &outError)
+{
+    QStringList columns;
+    Layout layout;
+    if (!readNames(namesPath, columns, outError))
+        return false;
+    if (!layoutFromColumns(columns, layout, outError)) {
+        outError = QString("%1: %2").arg(QDir::toNativeSeparators(namesPath), outError);
+        return false;
+    }
+
+    QString dataPath = namesPath;
+    if (dataPath.endsWith(QLatin1String(".names")))
+        dataPath.chop(6);
+
+    QFile file(dataPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        outError = QString("Cannot open Elmer data file %1").arg(QDir::toNativeSeparators(dataPath));
+        return false;
+    }
+
+    const qint64 size = file.size();
+    QByteArray buffer;
+    const char *data = nullptr;
+
+    if (size > 0)
+        data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        buffer = file.readAll();
+        data = buffer.constData();
+    }
+
+    if (!parseData(data, data + size, layout, out, outError)) {
+        outError = QString("%1: %2").arg(QDir::toNativeSeparators(dataPath), outError);
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the most recently modified scalar_results.names below \a runDir, or an empty string.
+ **********************************************************************************************************************/
+QString ElmerResults::findNamesFile(const QString &runDir)
+{
+    if (runDir.isEmpty() || !QFileInfo(runDir).isDir())
+        return QString();
+
+    QString best;
+    QDateTime bestTime;
+
+    QDirIterator it(runDir, QStringList() << QStringLiteral("scalar_results.names"), QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        if (best.isEmpty() || fi.lastModified() > bestTime) {
+            best = fi.absoluteFilePath();
+            bestTime = fi.lastModified();
+        }
+    }
+    return best;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the port_information.json written by gds2palace, two or one level(s) above \a dataDir.
+ *
+ * \param dataDir Directory of the Elmer data file.
+ * \param out     Receives the port impedances (Z0) in port number order and the model name.
+ * \return True if a port information file was found and parsed.
+ **********************************************************************************************************************/
+bool ElmerResults::readPortInformation(const QString &dataDir, PortInformation &out)
+{
+    out = PortInformation();
+
+    const QDir dir(dataDir);
+    QFile file(QDir::cleanPath(dir.filePath(QStringLiteral("../../port_information.json"))));
+    if (!file.exists())
+        file.setFileName(QDir::cleanPath(dir.filePath(QStringLiteral("../port_information.json"))));
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QJsonObject info = QJsonDocument::fromJson(file.readAll()).object();
+    if (info.isEmpty())
+        return false;
+
+    QMap<int, double> z0;
+    int next = 1;
+    for (const QJsonValue &v : info.value(QStringLiteral("ports")).toArray()) {
+        const QJsonObject port = v.toObject();
+        const int number = port.value(QStringLiteral("portnumber")).toInt(next);
+        next = number + 1;
+        if (port.contains(QStringLiteral("Z0")))
+            z0.insert(number, port.value(QStringLiteral("Z0")).toDouble(50.0));
+    }
+    for (double value : z0)
+        out.references << value;
+
+    out.name = info.value(QStringLiteral("name")).toString().trimmed();
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts an Elmer result pair to a Touchstone file next to the data file.
+ *
+ * The file is named after the data directory, or after the model name from port_information.json if the
+ * directory is Elmer's generic "mesh". Uniform port impedances are written as v1 file, mixed ones as v2 file
+ * with a [Reference] line. Data are written in DB format with frequencies in GHz.
+ *
+ * \param namesPath          Path of the .names file.
+ * \param outTouchstonePath  Receives the path of the written file.
+ * \param outError           Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ElmerResults::convert(const QString &namesPath, QString &outTouchstonePath, QString &outError)
+{
+    Touchstone::Network network;
+    if (!read(namesPath, network, outError))
+        return false;
+
+    network.comments << QStringLiteral("Converted from Elmer scalar results by EMStudio");
+    return SParameterCombiner::writeNextToResults(network, QFileInfo(namesPath).absolutePath(), QString(),
+                                                  outTouchstonePath, outError);
+}
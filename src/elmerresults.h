@@ -0,0 +1,75 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef ELMERRESULTS_H
+#define ELMERRESULTS_H
+
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class ElmerResults
+ * \brief Reader for Elmer scalar results (\c scalar_results.names + \c scalar_results) and converter to Touchstone.
+ *
+ * The .names file lists one column per line ("  3: res: cmf 1 2"). Of the data file only the angular frequency
+ * column and the two contiguous blocks of "cmf" (real part) and "cmf im" (imaginary part) columns are used:
+ * the file is memory-mapped and scanned row by row with Touchstone::parseNumber(), and each row's values go
+ * straight into the complex [frequency][row][column] array of a Touchstone::Network. Columns after the last
+ * needed one are skipped without conversion.
+ *
+ * Elmer reports the conjugate of the S-parameters in the e^{+jwt} convention used by Touchstone; the reader
+ * conjugates them, as scripts/combine_extend_snp.py does.
+ *
+ * convert() writes \c <name>.sNp next to the data file, with port impedances and the model name taken from the
+ * port_information.json written by gds2palace (one or two levels above the data file) if present.
+ **********************************************************************************************************************/
+class ElmerResults
+{
+public:
+    struct Layout
+    {
+        int                     columns = 0;        // number of columns listed in the .names file
+        int                     omegaColumn = -1;
+        int                     realColumn = -1;    // S11 real part; S[m][n] at realColumn + m * ports + n
+        int                     imagColumn = -1;    // S11 imaginary part, same layout
+        int                     ports = 0;
+    };
+
+    struct PortInformation
+    {
+        QVector<double>         references;         // ohms, one per port
+        QString                 name;
+    };
+
+    static bool                 readNames(const QString &namesPath, QStringList &outColumns, QString &outError);
+    static bool                 layoutFromColumns(const QStringList &columns, Layout &out, QString &outError);
+    static bool                 parseData(const char *begin, const char *end, const Layout &layout,
+                                          Touchstone::Network &out, QString &outError);
+    static bool                 read(const QString &namesPath, Touchstone::Network &out, QString &outError);
+
+    static QString              findNamesFile(const QString &runDir);
+    static bool                 readPortInformation(const QString &dataDir, PortInformation &out);
+    static bool                 convert(const QString &namesPath, QString &outTouchstonePath, QString &outError);
+};
+
+#endif // ELMERRESULTS_H
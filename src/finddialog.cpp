@@ -39,7 +39,9 @@
  * - Buttons for highlighting all occurrences and clearing existing highlights.
  *
  * The dialog operates in a non-modal state, allowing the user to continue editing while it remains open.
- * Each button emits a corresponding signal carrying the current search parameters.
+ * Each button emits a corresponding signal carrying the current search parameters. After "Highlight All"
+ * was pressed, editing the query or toggling an option re-emits sigHighlightAll() until highlights are
+ * cleared, so the editor can update its matches incrementally.
  *
  * \param parent Parent widget (optional).
  **********************************************************************************************************************/
@@ -90,8 +92,22 @@ FindDialog::FindDialog(QWidget *parent)
     });
 
     connect(m_btnHighlight, &QPushButton::clicked, this, [this]{
+        m_liveHighlight = true;
         emit sigHighlightAll(m_edit->text(), m_case->isChecked(), m_whole->isChecked(), m_regex->isChecked());
     });
 
-    connect(m_btnClear, &QPushButton::clicked, this, [this]{ emit sigClearHighlights(); });
+    connect(m_btnClear, &QPushButton::clicked, this, [this]{
+        m_liveHighlight = false;
+        emit sigClearHighlights();
+    });
+
+    // Once "Highlight All" was pressed, keep the highlights in sync while the query is edited
+    auto updateLiveHighlight = [this]{
+        if (m_liveHighlight)
+            emit sigHighlightAll(m_edit->text(), m_case->isChecked(), m_whole->isChecked(), m_regex->isChecked());
+    };
+    connect(m_edit,  &QLineEdit::textEdited, this, updateLiveHighlight);
+    connect(m_case,  &QCheckBox::toggled,    this, updateLiveHighlight);
+    connect(m_whole, &QCheckBox::toggled,    this, updateLiveHighlight);
+    connect(m_regex, &QCheckBox::toggled,    this, updateLiveHighlight);
 }
@@ -69,6 +69,7 @@ private:
     QPushButton *m_btnPrev;
     QPushButton *m_btnHighlight;
     QPushButton *m_btnClear;
+    bool         m_liveHighlight = false;
 };
 
 #endif // FINDDIALOG_H
@@ -19,16 +19,20 @@
  ************************************************************************/
 
 
+#include <QMap>
 #include <QSet>
 #include <QPair>
 #include <QFile>
 #include <QDebug>
 #include <QString>
+#include <QtEndian>
 #include <QFileInfo>
 #include <QDataStream>
 #include <QStringList>
+#include <QRegularExpression>
 
 #include "mainwindow.h"
+#include "tracer.h"
 
 /*!*******************************************************************************************************************
  * \brief Extracts the list of cell names from a GDSII file.
@@ -41,6 +45,7 @@
  **********************************************************************************************************************/
 QStringList MainWindow::extractGdsCellNames(const QString &filePath)
 {
+    EMSTUDIO_TRACE_SCOPE("gds.scanCellNames", filePath);
     QFile file(filePath);
     QStringList cellNames;
 
@@ -111,6 +116,7 @@ QStringList MainWindow::extractGdsCellNames(const QString &filePath)
  **********************************************************************************************************************/
 QSet<QPair<int, int>> MainWindow::extractGdsLayerNumbers(const QString &filePath)
 {
+    EMSTUDIO_TRACE_SCOPE("gds.scanLayers", filePath);
     QFile file(filePath);
     QSet<QPair<int, int>> layers;
 
@@ -172,3 +178,336 @@ QSet<QPair<int, int>> MainWindow::extractGdsLayerNumbers(const QString &filePath
     file.close();
     return layers;
 }
+
+/*!*******************************************************************************************************************
+ * \brief Extracts TEXT labels and polygon bounding boxes from a GDSII file.
+ *
+ * Walks the record stream once and collects every TEXT element (layer, STRING, XY) and every
+ * BOUNDARY/BOX element (layer, datatype, bounding box of XY). Coordinates are kept in database
+ * units. Only elements that belong to \a topCell are collected; references into other cells are
+ * not flattened, so labels and port shapes are expected to be drawn in the top cell itself.
+ * If \a topCell is empty, elements of all cells are collected.
+ *
+ * \param filePath  Path to the GDSII file.
+ * \param topCell   Name of the cell whose elements are collected, or empty for all cells.
+ * \param outLabels Receives the TEXT labels.
+ * \param outShapes Receives the polygon bounding boxes.
+ * \param outError  Receives a human-readable error message on failure.
+ *
+ * \return true if the file could be read, false otherwise.
+ **********************************************************************************************************************/
+bool MainWindow::extractGdsPortGeometry(const QString &filePath,
+                                        const QString &topCell,
+                                        QVector<GdsLabel> &outLabels,
+                                        QVector<GdsShape> &outShapes,
+                                        QString &outError)
+{
+    EMSTUDIO_TRACE_SCOPE("gds.scanPortGeometry", filePath);
+    outLabels.clear();
+    outShapes.clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        outError = tr("Cannot open GDS file: %1").arg(filePath);
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    enum class Element { None, Text, Boundary };
+
+    bool         inCell   = topCell.isEmpty();
+    Element      element  = Element::None;
+    int          layer    = -1;
+    int          datatype = 0;
+    QString      text;
+    QVector<QPoint> points;
+
+    QByteArray payload;
+
+    while (file.bytesAvailable() >= 4) {
+
+        quint16 size = 0;
+        quint8 recordType = 0, dataType = 0;
+        stream >> size >> recordType >> dataType;
+
+        if (stream.status() != QDataStream::Ok)
+            break;
+
+        if (size < 4 || (size & 1) != 0)
+            break;
+
+        const qint64 dataSize = qint64(size) - 4;
+        if (dataSize > file.bytesAvailable())
+            break;
+
+        payload.resize(int(dataSize));
+        if (dataSize > 0 && stream.readRawData(payload.data(), int(dataSize)) != dataSize)
+            break;
+
+        const char *d = payload.constData();
+
+        switch (recordType) {
+        case 0x06: // STRNAME
+            inCell = topCell.isEmpty() ||
+                     QString::fromLatin1(payload).remove(QChar('\0')).trimmed() == topCell;
+            break;
+
+        case 0x07: // ENDSTR
+            inCell = topCell.isEmpty();
+            break;
+
+        case 0x08: // BOUNDARY
+        case 0x2D: // BOX
+            element  = Element::Boundary;
+            layer    = -1;
+            datatype = 0;
+            points.clear();
+            break;
+
+        case 0x0C: // TEXT
+            element  = Element::Text;
+            layer    = -1;
+            datatype = 0;
+            text.clear();
+            points.clear();
+            break;
+
+        case 0x0D: // LAYER
+            if (dataSize >= 2)
+                layer = int(qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(d)));
+            break;
+
+        case 0x0E: // DATATYPE
+        case 0x16: // TEXTTYPE
+        case 0x2E: // BOXTYPE
+            if (dataSize >= 2)
+                datatype = int(qFromBigEndian<quint16>(reinterpret_cast<const uchar*>(d)));
+            break;
+
+        case 0x10: // XY (pairs of signed 4-byte integers)
+            if (element != Element::None) {
+                const int n = int(dataSize / 8);
+                points.reserve(n);
+                for (int i = 0; i < n; ++i) {
+                    const qint32 x = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(d + 8 * i));
+                    const qint32 y = qFromBigEndian<qint32>(reinterpret_cast<const uchar*>(d + 8 * i + 4));
+                    points.push_back(QPoint(int(x), int(y)));
+                }
+            }
+            break;
+
+        case 0x19: // STRING
+            if (element == Element::Text)
+                text = QString::fromLatin1(payload).remove(QChar('\0')).trimmed();
+            break;
+
+        case 0x11: // ENDEL
+            if (inCell && element == Element::Text && !points.isEmpty() && !text.isEmpty()) {
+                GdsLabel lbl;
+                lbl.text  = text;
+                lbl.layer = layer;
+                lbl.pos   = points.first();
+                outLabels.push_back(lbl);
+            } else if (inCell && element == Element::Boundary && !points.isEmpty()) {
+                int minX = points.first().x(), maxX = minX;
+                int minY = points.first().y(), maxY = minY;
+                for (const QPoint &pt : qAsConst(points)) {
+                    minX = qMin(minX, pt.x()); maxX = qMax(maxX, pt.x());
+                    minY = qMin(minY, pt.y()); maxY = qMax(maxY, pt.y());
+                }
+
+                GdsShape shape;
+                shape.layer    = layer;
+                shape.datatype = datatype;
+                shape.bbox     = QRect(QPoint(minX, minY), QPoint(maxX, maxY));
+                outShapes.push_back(shape);
+            }
+            element = Element::None;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    file.close();
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Proposes simulation ports from TEXT labels and port-layer polygons of a GDSII file.
+ *
+ * Labels of the form \c P<n> / \c PORT<n> (case-insensitive, optional separator) define a port
+ * with number \c n. Optional whitespace-separated tokens after the number are interpreted as:
+ *  - a direction (\c x, \c y, \c z, \c -x, \c -y, \c -z),
+ *  - one layer (target layer) or two layers (from/to layers), given as GDS number or substrate name.
+ *
+ * The source layer is the layer of the smallest port-layer polygon containing the label origin,
+ * or the label layer itself if no polygon contains it. Without explicit layer tokens, the label
+ * layer is used as target layer when it is a substrate layer. Without explicit direction, vertical
+ * ports (from/to given) get \c z and in-plane ports get the axis of the shorter polygon side.
+ *
+ * Port-layer polygons without any label are proposed as well, one port per layer, numbered after
+ * the highest labelled port in ascending layer order.
+ *
+ * Layer numbers are resolved to substrate names through \c m_gdsToSubName, so the caller should
+ * run rebuildLayerMapping() first.
+ *
+ * \param filePath   Path to the GDSII file.
+ * \param topCell    Cell to scan, or empty for all cells.
+ * \param portLayers GDS layers holding port polygons; if empty, every layer that is not part of
+ *                   the substrate mapping is treated as port layer.
+ * \param outError   Receives an error message if the file cannot be read.
+ *
+ * \return Proposed ports sorted by port number.
+ **********************************************************************************************************************/
+QVector<MainWindow::PortInfo> MainWindow::proposePortsFromGds(const QString &filePath,
+                                                              const QString &topCell,
+                                                              const QSet<int> &portLayers,
+                                                              QString &outError)
+{
+    EMSTUDIO_TRACE_SCOPE("gds.proposePorts", filePath);
+    QVector<PortInfo> out;
+
+    QVector<GdsLabel> labels;
+    QVector<GdsShape> shapes;
+    if (!extractGdsPortGeometry(filePath, topCell, labels, shapes, outError))
+        return out;
+
+    auto isPortLayer = [&](int layer) -> bool {
+        return portLayers.isEmpty() ? !m_gdsToSubName.contains(layer)
+                                    : portLayers.contains(layer);
+    };
+
+    auto layerText = [&](int layer) -> QString {
+        return m_gdsToSubName.value(layer, QString::number(layer));
+    };
+
+    auto resolveLayerToken = [&](const QString &tok) -> QString {
+        bool ok = false;
+        const int n = tok.toInt(&ok);
+        if (ok && m_gdsToSubName.contains(n))
+            return m_gdsToSubName.value(n);
+        return tok;
+    };
+
+    QVector<GdsShape> portShapes;
+    portShapes.reserve(shapes.size());
+    for (const GdsShape &s : qAsConst(shapes)) {
+        if (isPortLayer(s.layer))
+            portShapes.push_back(s);
+    }
+
+    static const QRegularExpression labelRe(
+        R"(^\s*(?:P|PORT)[\s_\-]*(\d+)\b(.*)$)",
+        QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression dirRe(R"(^-?[xyz]$)", QRegularExpression::CaseInsensitiveOption);
+
+    QMap<int, PortInfo> byNumber;
+    QSet<int>           labelledLayers;
+
+    for (const GdsLabel &lbl : qAsConst(labels)) {
+        const auto m = labelRe.match(lbl.text);
+        if (!m.hasMatch())
+            continue;
+
+        const int num = m.captured(1).toInt();
+        if (num <= 0 || byNumber.contains(num))
+            continue;
+
+        PortInfo p;
+        p.portnumber = num;
+        p.voltage    = 1.0;
+        p.z0         = 50.0;
+
+        const GdsShape *hit = nullptr;
+        for (const GdsShape &s : qAsConst(portShapes)) {
+            if (!s.bbox.contains(lbl.pos))
+                continue;
+            if (!hit || qint64(s.bbox.width()) * s.bbox.height() <
+                            qint64(hit->bbox.width()) * hit->bbox.height())
+                hit = &s;
+        }
+
+        p.sourceLayer    = QString::number(hit ? hit->layer : lbl.layer);
+        p.sourceIsNumber = true;
+        if (hit)
+            labelledLayers.insert(hit->layer);
+
+        QStringList layerToks;
+        const QStringList toks = m.captured(2).split(QRegularExpression(R"([\s,;:]+)"), Qt::SkipEmptyParts);
+        for (const QString &t : toks) {
+            if (dirRe.match(t).hasMatch())
+                p.direction = t.toLower();
+            else
+                layerToks << resolveLayerToken(t);
+        }
+
+        if (layerToks.size() >= 2) {
+            p.fromLayer = layerToks.at(0);
+            p.toLayer   = layerToks.at(1);
+        } else if (layerToks.size() == 1) {
+            p.toLayer = layerToks.at(0);
+        } else if (m_gdsToSubName.contains(lbl.layer) && (!hit || hit->layer != lbl.layer)) {
+            p.toLayer = layerText(lbl.layer);
+        }
+
+        if (p.direction.isEmpty()) {
+            if (!p.fromLayer.isEmpty() && !p.toLayer.isEmpty())
+                p.direction = QStringLiteral("z");
+            else if (hit && hit->bbox.width() < hit->bbox.height())
+                p.direction = QStringLiteral("x");
+            else if (hit && hit->bbox.height() < hit->bbox.width())
+                p.direction = QStringLiteral("y");
+            else
+                p.direction = QStringLiteral("z");
+        }
+
+        byNumber.insert(num, p);
+    }
+
+    // Port-layer polygons without any label: one port per layer
+    QMap<int, QRect> unlabelled;
+    for (const GdsShape &s : qAsConst(portShapes)) {
+        if (labelledLayers.contains(s.layer))
+            continue;
+        bool hasLabel = false;
+        for (const GdsLabel &lbl : qAsConst(labels)) {
+            if (s.bbox.contains(lbl.pos) && labelRe.match(lbl.text).hasMatch()) {
+                hasLabel = true;
+                break;
+            }
+        }
+        if (hasLabel)
+            continue;
+        unlabelled[s.layer] = unlabelled.contains(s.layer) ? unlabelled[s.layer].united(s.bbox) : s.bbox;
+    }
+
+    int nextNum = byNumber.isEmpty() ? 1 : byNumber.lastKey() + 1;
+    for (auto it = unlabelled.cbegin(); it != unlabelled.cend(); ++it) {
+        PortInfo p;
+        p.portnumber     = nextNum++;
+        p.voltage        = 1.0;
+        p.z0             = 50.0;
+        p.sourceLayer    = QString::number(it.key());
+        p.sourceIsNumber = true;
+
+        const QRect &r = it.value();
+        if (r.width() < r.height())
+            p.direction = QStringLiteral("x");
+        else if (r.height() < r.width())
+            p.direction = QStringLiteral("y");
+        else
+            p.direction = QStringLiteral("z");
+
+        byNumber.insert(p.portnumber, p);
+    }
+
+    out.reserve(byNumber.size());
+    for (auto it = byNumber.cbegin(); it != byNumber.cend(); ++it)
+        out.push_back(it.value());
+
+    return out;
+}
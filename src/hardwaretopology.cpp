@@ -0,0 +1,365 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <algorithm>
+
+#include <QDir>
+#include <QSet>
+#include <QFile>
+#include <QHash>
+#include <QRegularExpression>
+
+#include "wslHelper.h"
+#include "hardwaretopology.h"
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of physical cores left for a run after keeping \a reservedCores free (at least 1).
+ *
+ * Falls back to the logical CPU count if the core topology is unknown.
+ **********************************************************************************************************************/
+int HardwareTopology::Topology::usableCores(int reservedCores) const
+{
+    const int cores = physicalCores > 0 ? physicalCores : logicalCpus;
+    return qMax(1, cores - qMax(0, reservedCores));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a short human-readable description of the topology for the simulation log.
+ **********************************************************************************************************************/
+QString HardwareTopology::Topology::summary() const
+{
+    if (!isValid())
+        return QStringLiteral("topology unknown");
+
+    return QString("%1 physical cores (%2 logical) on %3 socket(s), %4 NUMA node(s)")
+        .arg(physicalCores)
+        .arg(logicalCpus)
+        .arg(sockets)
+        .arg(nodes.size());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Probes the CPU topology once per WSL distribution (Windows) or once per process (Linux).
+ *
+ * \param distro WSL distribution to probe on Windows; ignored on Linux.
+ * \return The cached topology; invalid if sysfs could not be read.
+ **********************************************************************************************************************/
+HardwareTopology::Topology HardwareTopology::probe(const QString &distro)
+{
+    static QHash<QString, Topology> cache;
+
+#ifdef Q_OS_WIN
+    const QString key = distro.trimmed();
+#else
+    Q_UNUSED(distro);
+    const QString key;
+#endif
+
+    const auto it = cache.constFind(key);
+    if (it != cache.constEnd())
+        return it.value();
+
+    Topology topology;
+#ifdef Q_OS_WIN
+    const QString dump = runWslCmdCapture(key, QStringList() << "sh" << "-c" << sysfsDumpCommand(), 5000);
+    topology = fromSysfs(parseSysfsDump(dump));
+    topology.source = QStringLiteral("WSL sysfs");
+#else
+    topology = fromSysfs(readSysfs(QStringLiteral("/sys/devices/system")));
+    topology.source = QStringLiteral("sysfs");
+#endif
+
+    cache.insert(key, topology);
+    return topology;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Builds a topology from sysfs file contents.
+ *
+ * \param files Map of paths relative to /sys/devices/system ("cpu/online", "cpu/cpu3/topology/core_id",
+ *              "cpu/cpu3/topology/physical_package_id", "node/node1/cpulist") to their trimmed content.
+ **********************************************************************************************************************/
+HardwareTopology::Topology HardwareTopology::fromSysfs(const QMap<QString, QString> &files)
+{
+    static const QRegularExpression reCore(QStringLiteral("^cpu/cpu(\\d+)/topology/core_id$"));
+    static const QRegularExpression reNode(QStringLiteral("^node/node(\\d+)/cpulist$"));
+
+    QMap<int, qint64> coreOfCpu; // cpu -> (package << 32) | core
+    QMap<int, QList<int>> nodeCpus;
+
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        QRegularExpressionMatch m = reCore.match(it.key());
+        if (m.hasMatch()) {
+            const int cpu = m.captured(1).toInt();
+            bool ok = false;
+            const int core = it.value().trimmed().toInt(&ok);
+            if (!ok)
+                continue;
+            const int package = files.value(QString("cpu/cpu%1/topology/physical_package_id").arg(cpu)).toInt();
+            coreOfCpu.insert(cpu, (qint64(package) << 32) | quint32(core));
+            continue;
+        }
+
+        m = reNode.match(it.key());
+        if (m.hasMatch())
+            nodeCpus.insert(m.captured(1).toInt(), parseCpuList(it.value()));
+    }
+
+    QList<int> online = parseCpuList(files.value(QStringLiteral("cpu/online")));
+    if (online.isEmpty())
+        online = coreOfCpu.keys();
+
+    const QSet<int> onlineSet(online.begin(), online.end());
+
+    Topology topology;
+    topology.logicalCpus = online.size();
+
+    QSet<qint64> cores;
+    QSet<qint64> packages;
+    for (int cpu : online) {
+        const auto it = coreOfCpu.constFind(cpu);
+        if (it == coreOfCpu.constEnd())
+            continue;
+        cores.insert(it.value());
+        packages.insert(it.value() >> 32);
+    }
+    topology.physicalCores = cores.size();
+    topology.sockets = packages.size();
+
+    if (nodeCpus.isEmpty() && topology.logicalCpus > 0)
+        nodeCpus.insert(0, online);
+
+    for (auto it = nodeCpus.constBegin(); it != nodeCpus.constEnd(); ++it) {
+        NumaNode node;
+        node.id = it.key();
+
+        QSet<qint64> nodeCores;
+        for (int cpu : it.value()) {
+            if (!onlineSet.contains(cpu))
+                continue;
+            node.cpus << cpu;
+            const auto core = coreOfCpu.constFind(cpu);
+            if (core != coreOfCpu.constEnd())
+                nodeCores.insert(core.value());
+        }
+        node.physicalCores = nodeCores.size();
+
+        if (!node.cpus.isEmpty())
+            topology.nodes << node;
+    }
+
+    return topology;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the sysfs files used by fromSysfs() below \a root (normally /sys/devices/system).
+ **********************************************************************************************************************/
+QMap<QString, QString> HardwareTopology::readSysfs(const QString &root)
+{
+    QMap<QString, QString> files;
+
+    auto readFile = [&files, &root](const QString &relPath) {
+        QFile f(QDir(root).filePath(relPath));
+        if (f.open(QIODevice::ReadOnly))
+            files.insert(relPath, QString::fromLatin1(f.readAll()).trimmed());
+    };
+
+    static const QRegularExpression reCpuDir(QStringLiteral("^cpu\\d+$"));
+    static const QRegularExpression reNodeDir(QStringLiteral("^node\\d+$"));
+
+    readFile(QStringLiteral("cpu/online"));
+
+    const QStringList cpuDirs = QDir(QDir(root).filePath(QStringLiteral("cpu"))).entryList(QDir::Dirs);
+    for (const QString &dir : cpuDirs) {
+        if (!reCpuDir.match(dir).hasMatch())
+            continue;
+        readFile(QString("cpu/%1/topology/core_id").arg(dir));
+        readFile(QString("cpu/%1/topology/physical_package_id").arg(dir));
+    }
+
+    const QStringList nodeDirs = QDir(QDir(root).filePath(QStringLiteral("node"))).entryList(QDir::Dirs);
+    for (const QString &dir : nodeDirs) {
+        if (reNodeDir.match(dir).hasMatch())
+            readFile(QString("node/%1/cpulist").arg(dir));
+    }
+
+    return files;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses the "path=content" lines printed by sysfsDumpCommand().
+ **********************************************************************************************************************/
+QMap<QString, QString> HardwareTopology::parseSysfsDump(const QString &dump)
+{
+    QMap<QString, QString> files;
+
+    const QStringList lines = QString(dump).remove(QLatin1Char('\r')).split(QLatin1Char('\n'), Qt::SkipEmptyParts);
+    for (const QString &line : lines) {
+        const int eq = line.indexOf(QLatin1Char('='));
+        if (eq > 0)
+            files.insert(line.left(eq).trimmed(), line.mid(eq + 1).trimmed());
+    }
+
+    return files;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a POSIX shell command that prints all sysfs files used by fromSysfs() as "path=content".
+ *
+ * Used on Windows to read the WSL topology with a single wsl.exe call.
+ **********************************************************************************************************************/
+QString HardwareTopology::sysfsDumpCommand()
+{
+    return QStringLiteral(
+        "cd /sys/devices/system && "
+        "for f in cpu/online cpu/cpu[0-9]*/topology/core_id cpu/cpu[0-9]*/topology/physical_package_id "
+        "node/node[0-9]*/cpulist; do [ -r \"$f\" ] && printf '%s=%s\\n' \"$f\" \"$(cat \"$f\")\"; done; true");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses a kernel CPU list such as "0-3,8-11".
+ *
+ * \return Sorted CPU numbers; empty for malformed input.
+ **********************************************************************************************************************/
+QList<int> HardwareTopology::parseCpuList(const QString &text)
+{
+    QList<int> cpus;
+
+    for (const QString &part : text.trimmed().split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const QStringList range = part.trimmed().split(QLatin1Char('-'));
+        bool ok1 = false, ok2 = true;
+        const int first = range.value(0).toInt(&ok1);
+        const int last  = range.size() > 1 ? range.at(1).toInt(&ok2) : first;
+        if (!ok1 || !ok2 || range.size() > 2 || last < first)
+            return QList<int>();
+
+        for (int cpu = first; cpu <= last; ++cpu)
+            cpus << cpu;
+    }
+
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return cpus;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the MPI launch settings from the preferences.
+ *
+ * Keys: PALACE_MPI_BINDING (0 = auto, 1 = no binding, 2 = bind to cores), PALACE_RANKS_PER_NUMA
+ * (0 = all cores of a node) and RESERVED_CORES.
+ **********************************************************************************************************************/
+HardwareTopology::LaunchOptions HardwareTopology::launchOptionsFromPreferences(
+    const QMap<QString, QVariant> &preferences)
+{
+    LaunchOptions options;
+
+    switch (preferences.value(QStringLiteral("PALACE_MPI_BINDING"), 0).toInt()) {
+    case 1:  options.binding = Binding::None; break;
+    case 2:  options.binding = Binding::Core; break;
+    default: options.binding = Binding::Auto; break;
+    }
+
+    options.ranksPerNumaNode = qMax(0, preferences.value(QStringLiteral("PALACE_RANKS_PER_NUMA"), 0).toInt());
+    options.reservedCores    = qMax(0, preferences.value(QStringLiteral("RESERVED_CORES"), 0).toInt());
+    return options;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Chooses the MPI rank count and Open MPI launcher arguments for a Palace run.
+ *
+ * The rank count is the number of usable physical cores, capped by the ranks per NUMA node and by the job
+ * core budget. In auto mode ranks are bound to cores and spread over the NUMA nodes when the run has the
+ * machine to itself and does not need more ranks than physical cores; runs sharing the machine with other
+ * queued jobs stay unbound (with oversubscription allowed), as independent jobs would otherwise be bound
+ * to the same cores.
+ **********************************************************************************************************************/
+HardwareTopology::LaunchPlan HardwareTopology::planMpiLaunch(const Topology &topology, const LaunchOptions &options)
+{
+    LaunchPlan plan;
+
+    const int physical = topology.physicalCores > 0 ? topology.physicalCores : qMax(1, topology.logicalCpus);
+    const int nodes    = qMax(1, topology.nodes.size());
+    const int usable   = topology.usableCores(options.reservedCores);
+
+    int ranks = usable;
+    if (options.ranksPerNumaNode > 0)
+        ranks = qMin(ranks, options.ranksPerNumaNode * nodes);
+    if (options.rankLimit > 0)
+        ranks = qMin(ranks, options.rankLimit);
+    ranks = qMax(1, ranks);
+
+    const bool shared = options.rankLimit > 0 && options.rankLimit < usable;
+
+    Binding binding = options.binding;
+    QString reason;
+    if (binding == Binding::Auto) {
+        if (!topology.isValid()) {
+            binding = Binding::None;
+            reason  = QStringLiteral("topology unknown");
+        } else if (shared) {
+            binding = Binding::None;
+            reason  = QStringLiteral("sharing the machine with other jobs");
+        } else {
+            binding = Binding::Core;
+        }
+    }
+    if (binding == Binding::Core && ranks > physical) {
+        binding = Binding::None;
+        reason  = QStringLiteral("more ranks than physical cores");
+    }
+
+    if (binding == Binding::Core) {
+        const int perNode = options.ranksPerNumaNode;
+        const QString mapBy = (perNode > 0 && perNode * nodes >= ranks)
+                                  ? QString("ppr:%1:numa").arg(perNode)
+                                  : QStringLiteral("numa");
+        plan.launcherArgs = QStringLiteral("--bind-to core --map-by ") + mapBy;
+    } else {
+        plan.launcherArgs = QStringLiteral("--oversubscribe");
+    }
+
+    plan.ranks   = ranks;
+    plan.binding = binding;
+
+    plan.description = QString("np = %1, %2 [%3]; %4")
+                           .arg(ranks)
+                           .arg(binding == Binding::Core ? QStringLiteral("bound to cores, mapped by NUMA node")
+                                                         : QStringLiteral("unbound"))
+                           .arg(plan.launcherArgs, topology.summary());
+    if (options.reservedCores > 0)
+        plan.description += QString(", %1 core(s) kept free").arg(options.reservedCores);
+    if (!reason.isEmpty())
+        plan.description += QString(" (%1: %2)").arg(bindingName(options.binding), reason);
+
+    return plan;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the preference name of a binding mode.
+ **********************************************************************************************************************/
+QString HardwareTopology::bindingName(Binding binding)
+{
+    switch (binding) {
+    case Binding::Auto: return QStringLiteral("auto");
+    case Binding::None: return QStringLiteral("no binding");
+    case Binding::Core: return QStringLiteral("bind to cores");
+    }
+    return QString();
+}
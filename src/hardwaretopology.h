@@ -0,0 +1,95 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef HARDWARETOPOLOGY_H
+#define HARDWARETOPOLOGY_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QVariant>
+
+/*!*******************************************************************************************************************
+ * \class HardwareTopology
+ * \brief CPU/NUMA topology probe and MPI launch planning for the Palace solver.
+ *
+ * The topology is read from the Linux sysfs tree (/sys/devices/system/cpu and /sys/devices/system/node):
+ * natively on Linux, and with a single shell call inside the configured WSL distribution on Windows.
+ * Probe results are cached for the lifetime of the process, so repeated runs neither spawn lscpu/nproc
+ * nor enter WSL again.
+ *
+ * planMpiLaunch() turns a topology into a rank count and Open MPI launcher arguments: ranks can be bound
+ * to physical cores and spread over NUMA nodes, limited per NUMA node, and a number of cores can be kept
+ * free for the GUI. The plan carries a one-line description that the runner writes to the simulation log.
+ **********************************************************************************************************************/
+class HardwareTopology
+{
+public:
+    enum class Binding { Auto, None, Core };
+
+    struct NumaNode
+    {
+        int                     id = 0;
+        QList<int>              cpus;
+        int                     physicalCores = 0;
+    };
+
+    struct Topology
+    {
+        int                     logicalCpus = 0;
+        int                     physicalCores = 0;
+        int                     sockets = 0;
+        QList<NumaNode>         nodes;
+        QString                 source;
+
+        bool                    isValid() const { return logicalCpus > 0; }
+        int                     usableCores(int reservedCores) const;
+        QString                 summary() const;
+    };
+
+    struct LaunchOptions
+    {
+        Binding                 binding = Binding::Auto;
+        int                     ranksPerNumaNode = 0;   // 0: all physical cores of a node
+        int                     reservedCores = 0;      // physical cores kept free
+        int                     rankLimit = 0;          // job core budget from SimulationQueue; 0: none
+    };
+
+    struct LaunchPlan
+    {
+        int                     ranks = 1;
+        Binding                 binding = Binding::None;
+        QString                 launcherArgs;
+        QString                 description;
+    };
+
+    static Topology             probe(const QString &distro = QString());
+    static Topology             fromSysfs(const QMap<QString, QString> &files);
+    static QMap<QString, QString> readSysfs(const QString &root);
+    static QMap<QString, QString> parseSysfsDump(const QString &dump);
+    static QString              sysfsDumpCommand();
+    static QList<int>           parseCpuList(const QString &text);
+
+    static LaunchOptions        launchOptionsFromPreferences(const QMap<QString, QVariant> &preferences);
+    static LaunchPlan           planMpiLaunch(const Topology &topology, const LaunchOptions &options);
+    static QString              bindingName(Binding binding);
+};
+
+#endif // HARDWARETOPOLOGY_H
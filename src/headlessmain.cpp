@@ -0,0 +1,59 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include "commandline.h"
+#include "tracer.h"
+
+#include <QDebug>
+#include <QCoreApplication>
+
+/*!*******************************************************************************************************************
+ * \brief Main entry point for EMStudioHeadless, the QtCore-only command line front end of EMStudio.
+ *
+ * Accepts the same options as EMStudio and executes every mode that needs no GUI (-run, -aggregate-reports,
+ * -results, -golden, -check, -combine, -vectorfit). The executable links QtCore only, so it runs on build and
+ * compute hosts without any Qt GUI libraries installed.
+ *
+ * \param argc Argument count from the command line.
+ * \param argv Argument vector from the command line.
+ * \return The exit status of the application.
+ **********************************************************************************************************************/
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Same application name as the GUI, so both read the same preferences.
+    QCoreApplication::setApplicationName("EMStudio");
+    QCoreApplication::setApplicationVersion(QStringLiteral(EMSTUDIO_VERSION_STR));
+    Tracer::startFromEnvironment();
+
+    CommandLine::Options options;
+    QString err;
+    if (!CommandLine::parse(QCoreApplication::arguments(), options, err)) {
+        qWarning().noquote() << err;
+        CommandLine::printHelp();
+        return 1;
+    }
+
+    if (!options.traceFile.isEmpty())
+        Tracer::start(options.traceFile);
+
+    return CommandLine::exec(options);
+}
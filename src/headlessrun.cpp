@@ -0,0 +1,367 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+#include <QFileInfo>
+#include <QSettings>
+#include <QCoreApplication>
+
+#include "wslHelper.h"
+#include "headlessrun.h"
+#include "pythonparser.h"
+#include "parametersweep.h"
+#include "simulationqueue.h"
+#include "simulationrunner.h"
+
+/*!*******************************************************************************************************************
+ * \brief Creates the headless driver and wires the runner output to stdout/stderr and the application exit code.
+ *
+ * \param runs       One entry per Python model given on the command line.
+ * \param coreBudget Total cores for queued runs; 0 uses the detected core count.
+ * \param parent     Optional QObject parent.
+ **********************************************************************************************************************/
+HeadlessRun::HeadlessRun(const QList<Options> &runs, int coreBudget, QObject *parent)
+    : QObject(parent)
+    , m_runs(runs)
+    , m_coreBudget(coreBudget)
+    , m_runner(new SimulationRunner(this))
+{
+    connect(m_runner, &SimulationRunner::output, this, [](const QByteArray &data) {
+        fwrite(data.constData(), 1, size_t(data.size()), stdout);
+        fflush(stdout);
+    });
+    connect(m_runner, &SimulationRunner::errorOccurred, this, [](const QString &message, bool) {
+        qCritical().noquote() << message;
+    });
+    connect(m_runner, &SimulationRunner::finished, this, [](int exitCode) {
+        QCoreApplication::exit(exitCode);
+    });
+}
+
+/*!*******************************************************************************************************************
+ * \brief Prepares the run from the command line options and starts the selected backend.
+ *
+ * Exits the application with code 1 if the model cannot be prepared; otherwise the exit code is
+ * reported by SimulationRunner::finished() or, for queued runs, once the queue is idle.
+ **********************************************************************************************************************/
+void HeadlessRun::start()
+{
+    QMap<QString, QVariant> preferences = loadPreferences();
+    if (!m_runCacheEnabled)
+        preferences["RUN_CACHE"] = false;
+    if (m_pipelined)
+        preferences["PIPELINE_PREPROCESSING"] = true;
+    exportWslDistroToEnv(preferences);
+
+    if (!m_sweepFile.isEmpty()) {
+        startSweep(preferences);
+        return;
+    }
+
+    if (m_runs.size() != 1 || m_coreBudget > 0 ||
+        preferences.value("PIPELINE_PREPROCESSING", false).toBool()) {
+        startQueued(preferences);
+        return;
+    }
+
+    QMap<QString, QVariant> simSettings;
+    QString simKey;
+    QString err;
+    if (!prepareSimSettings(m_runs.first(), simSettings, simKey, err)) {
+        qCritical().noquote() << err;
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    m_runner->setPreferences(preferences);
+    m_runner->setSimSettings(simSettings);
+    m_runner->setSimToolKey(simKey);
+
+    if (simKey == QLatin1String("openems"))
+        m_runner->runOpenEMS();
+    else
+        m_runner->runPalace();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Dispatches all models through a SimulationQueue sharing the core budget.
+ *
+ * Models that cannot be prepared are reported and make the run exit with code 1, the remaining models
+ * are still simulated.
+ **********************************************************************************************************************/
+void HeadlessRun::startQueued(const QMap<QString, QVariant> &preferences)
+{
+    connectQueue(preferences);
+
+    QList<SimulationQueue::JobSpec> specs;
+    for (const Options &options : m_runs) {
+        SimulationQueue::JobSpec spec;
+        QString err;
+        if (!prepareSimSettings(options, spec.simSettings, spec.simKey, err)) {
+            qCritical().noquote() << err;
+            m_exitCode = 1;
+            continue;
+        }
+        spec.name        = QFileInfo(options.pythonFile).completeBaseName();
+        spec.preferences = preferences;
+        specs.append(spec);
+    }
+
+    if (specs.isEmpty()) {
+        QCoreApplication::exit(m_exitCode != 0 ? m_exitCode : 1);
+        return;
+    }
+
+    for (const SimulationQueue::JobSpec &spec : specs)
+        m_queue->enqueue(spec);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates the job queue and mirrors job output, job state changes and the final exit code.
+ *
+ * \param preferences Preferences of the run; configure pipelined preprocessing of the queue.
+ **********************************************************************************************************************/
+void HeadlessRun::connectQueue(const QMap<QString, QVariant> &preferences)
+{
+    m_queue = new SimulationQueue(this);
+    if (m_coreBudget > 0)
+        m_queue->setCoreBudget(m_coreBudget);
+    m_queue->applyPreferences(preferences);
+
+    connect(m_queue, &SimulationQueue::jobOutput, this, &HeadlessRun::writeJobOutput);
+    connect(m_queue, &SimulationQueue::jobStateChanged, this,
+            [this](int id, SimulationQueue::JobState state) {
+                const SimulationQueue::JobInfo info = m_queue->jobInfo(id);
+                if (state == SimulationQueue::JobState::Running) {
+                    qInfo().noquote() << QString("[%1] started on %2 cores").arg(info.name).arg(info.cores);
+                    return;
+                }
+                if (state == SimulationQueue::JobState::Preprocessing) {
+                    qInfo().noquote() << QString("[%1] preprocessing").arg(info.name);
+                    return;
+                }
+                if (!SimulationQueue::isFinalState(state))
+                    return;
+
+                writeJobOutput(id, QByteArray("\n"));
+                qInfo().noquote() << QString("[%1] %2 (exit code %3)")
+                                         .arg(info.name, SimulationQueue::stateName(state))
+                                         .arg(info.exitCode);
+                if (state != SimulationQueue::JobState::Finished && m_exitCode == 0)
+                    m_exitCode = info.exitCode != 0 ? info.exitCode : 1;
+            });
+    connect(m_queue, &SimulationQueue::idle, this, &HeadlessRun::finishQueued);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Generates the sweep variants of the (single) model and dispatches them through the queue.
+ *
+ * Exits with code 1 if the sweep definition or the model cannot be prepared.
+ **********************************************************************************************************************/
+void HeadlessRun::startSweep(const QMap<QString, QVariant> &preferences)
+{
+    QString err;
+    QMap<QString, QVariant> simSettings;
+    QString simKey;
+
+    QFile file(m_sweepFile);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qCritical().noquote() << QString("Cannot open sweep file %1").arg(m_sweepFile);
+        QCoreApplication::exit(1);
+        return;
+    }
+    const QString definition = QString::fromUtf8(file.readAll());
+    file.close();
+
+    if (m_runs.size() != 1) {
+        qCritical().noquote() << "A parameter sweep requires exactly one Python model.";
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    connectQueue(preferences);
+
+    auto *sweep = new ParameterSweep(this);
+    if (!prepareSimSettings(m_runs.first(), simSettings, simKey, err) ||
+        !sweep->parseDefinition(definition, err) ||
+        !sweep->generate(simSettings.value("RunPythonScript").toString(), err)) {
+        qCritical().noquote() << err;
+        QCoreApplication::exit(1);
+        return;
+    }
+
+    connect(sweep, &ParameterSweep::finished, this, [](const QString &summaryPath) {
+        qInfo().noquote() << QString("Sweep summary: %1").arg(QDir::toNativeSeparators(summaryPath));
+    });
+
+    qInfo().noquote() << QString("Running %1 sweep variants").arg(sweep->variants().size());
+
+    if (!sweep->dispatch(m_queue, simKey, simSettings, preferences, err)) {
+        qCritical().noquote() << err;
+        QCoreApplication::exit(1);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes complete output lines of a queued job to stdout, prefixed with the job name.
+ *
+ * Partial lines are kept per job until their newline arrives so that concurrent jobs do not interleave
+ * within a line.
+ **********************************************************************************************************************/
+void HeadlessRun::writeJobOutput(int id, const QByteArray &data)
+{
+    QByteArray &pending = m_partialLines[id];
+    pending.append(data);
+
+    const int last = pending.lastIndexOf('\n');
+    if (last < 0)
+        return;
+
+    const QByteArray prefix = "[" + m_queue->jobInfo(id).name.toUtf8() + "] ";
+    const QList<QByteArray> lines = pending.left(last).split('\n');
+    pending.remove(0, last + 1);
+
+    for (const QByteArray &line : lines) {
+        if (line.trimmed().isEmpty())
+            continue;
+        fwrite(prefix.constData(), 1, size_t(prefix.size()), stdout);
+        fwrite(line.constData(), 1, size_t(line.size()), stdout);
+        fputc('\n', stdout);
+    }
+    fflush(stdout);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Exits the application once all queued jobs are done.
+ **********************************************************************************************************************/
+void HeadlessRun::finishQueued()
+{
+    QCoreApplication::exit(m_exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the "Preferences" group saved by the GUI.
+ **********************************************************************************************************************/
+QMap<QString, QVariant> HeadlessRun::loadPreferences()
+{
+    QMap<QString, QVariant> preferences;
+
+    QSettings settings("EMStudio", "EMStudioApp");
+    settings.beginGroup("Preferences");
+    for (const QString &key : settings.childKeys())
+        preferences[key] = settings.value(key);
+    settings.endGroup();
+
+    return preferences;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Derives the simulation settings and backend key for a headless run from the Python model.
+ *
+ * The settings mirror what the GUI holds after loading the model: the parsed top-level variables and
+ * settings[...] entries, the model path as RunPythonScript, its folder as RunDir, and the resolved
+ * GDS/substrate files and top cell. A "-palace" run of a model that enables Elmer is dispatched to the
+ * Elmer workflow, just as the GUI selects the Elmer tool when loading such a model.
+ *
+ * \param options     Command line options of the run.
+ * \param outSettings Simulation settings for SimulationRunner.
+ * \param outSimKey   Backend key: "palace", "elmer" or "openems".
+ * \param outError    Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool HeadlessRun::prepareSimSettings(const Options &options,
+                                     QMap<QString, QVariant> &outSettings,
+                                     QString &outSimKey,
+                                     QString &outError)
+{
+    outSettings.clear();
+    outSimKey.clear();
+
+    const QString requested = options.simKey.trimmed().toLower();
+    if (requested != QLatin1String("palace") && requested != QLatin1String("openems")) {
+        outError = QString("Unknown backend for headless run: %1").arg(options.simKey);
+        return false;
+    }
+
+    const QFileInfo fi(options.pythonFile);
+    if (options.pythonFile.trimmed().isEmpty() || !fi.exists()) {
+        outError = QString("Python file '%1' does not exist.").arg(options.pythonFile);
+        return false;
+    }
+
+    QFile file(fi.absoluteFilePath());
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        outError = QString("Cannot open file %1").arg(fi.absoluteFilePath());
+        return false;
+    }
+    const QString text = QString::fromUtf8(file.readAll());
+    file.close();
+
+    const PythonParser::Result res = PythonParser::parseSettings(fi.absoluteFilePath());
+    if (!res.ok) {
+        outError = QString("Failed to parse Python model file:\n%1").arg(res.error);
+        return false;
+    }
+
+    for (auto it = res.topLevel.constBegin(); it != res.topLevel.constEnd(); ++it)
+        outSettings[it.key()] = it.value();
+    for (auto it = res.settings.constBegin(); it != res.settings.constEnd(); ++it)
+        outSettings[it.key()] = it.value();
+
+    const QDir modelDir(fi.absolutePath());
+    auto resolveModelPath = [&modelDir](const QString &path) -> QString {
+#ifdef Q_OS_WIN
+        QString p = SimulationRunner::wslToWinPath(path);
+#else
+        QString p = path;
+#endif
+        return QFileInfo(p).isRelative() ? modelDir.filePath(p) : p;
+    };
+
+    QString gdsPath = options.gdsFile.trimmed();
+    if (gdsPath.isEmpty() && !res.gdsFilename.isEmpty())
+        gdsPath = resolveModelPath(res.gdsFilename);
+    if (!gdsPath.isEmpty())
+        outSettings["GdsFile"] = gdsPath;
+
+    if (!res.xmlFilename.isEmpty())
+        outSettings["SubstrateFile"] = resolveModelPath(res.xmlFilename);
+
+    QString topCell = options.topCell.trimmed();
+    if (topCell.isEmpty())
+        topCell = res.getCellName().trimmed();
+    if (!topCell.isEmpty()) {
+        outSettings["TopCell"]      = topCell;
+        outSettings["gds_cellname"] = topCell;
+    }
+
+    outSettings["RunPythonScript"] = fi.absoluteFilePath();
+    outSettings["RunDir"]          = fi.absolutePath();
+
+    if (requested == QLatin1String("palace") &&
+        PythonParser::detectSimToolKey(text, &res) == QLatin1String("elmer"))
+        outSimKey = QStringLiteral("elmer");
+    else
+        outSimKey = requested;
+
+    return true;
+}
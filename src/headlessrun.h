@@ -0,0 +1,96 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef HEADLESSRUN_H
+#define HEADLESSRUN_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+
+class SimulationQueue;
+class SimulationRunner;
+
+/*!*******************************************************************************************************************
+ * \class HeadlessRun
+ * \brief Command line driver for "-run": runs Python models through SimulationRunner without any widgets.
+ *
+ * Loads the saved preferences, parses each Python model, derives the simulation settings the GUI would hold
+ * after loading the same model and starts the selected backend. A single model runs on one SimulationRunner
+ * that uses all detected cores; several models (or an explicit core budget) are dispatched concurrently
+ * through a SimulationQueue, with every output line prefixed by the model name. Process output is mirrored
+ * to stdout, errors go to stderr and the application exits with the run's exit code (the first non-zero
+ * job exit code for queued runs). With a sweep file the single model is fanned out by ParameterSweep and
+ * all variants run through the queue. In pipelined mode the models run back to back through the queue, with
+ * the preprocessing of the next model overlapping the solver of the current one.
+ **********************************************************************************************************************/
+class HeadlessRun : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options
+    {
+        QString simKey;              // "palace" or "openems" as given on the command line
+        QString pythonFile;
+        QString gdsFile;             // optional -gdsfile override
+        QString topCell;             // optional -topcell override
+    };
+
+    explicit HeadlessRun(const QList<Options> &runs, int coreBudget = 0, QObject *parent = nullptr);
+
+    void                        setSweepFile(const QString &path) { m_sweepFile = path; }
+    void                        setRunCacheEnabled(bool enabled) { m_runCacheEnabled = enabled; }
+    void                        setPipelined(bool enabled) { m_pipelined = enabled; }
+    void                        start();
+
+    SimulationRunner           *runner() const { return m_runner; }
+    SimulationQueue            *queue() const { return m_queue; }
+
+    static QMap<QString, QVariant> loadPreferences();
+    static bool                 prepareSimSettings(const Options &options,
+                                                   QMap<QString, QVariant> &outSettings,
+                                                   QString &outSimKey,
+                                                   QString &outError);
+
+private:
+    void                        startQueued(const QMap<QString, QVariant> &preferences);
+    void                        startSweep(const QMap<QString, QVariant> &preferences);
+    void                        connectQueue(const QMap<QString, QVariant> &preferences);
+    void                        writeJobOutput(int id, const QByteArray &data);
+    void                        finishQueued();
+
+private:
+    QList<Options>              m_runs;
+    int                         m_coreBudget = 0;
+    QString                     m_sweepFile;
+    bool                        m_runCacheEnabled = true;
+    bool                        m_pipelined = false;
+
+    SimulationRunner           *m_runner = nullptr;
+    SimulationQueue            *m_queue = nullptr;
+
+    QMap<int, QByteArray>       m_partialLines;
+    int                         m_exitCode = 0;
+};
+
+#endif // HEADLESSRUN_H
@@ -71,40 +71,36 @@
  **********************************************************************************************************************/
 
 #include "mainwindow.h"
+#include "commandline.h"
+#include "tracer.h"
 
 #include <QTimer>
 #include <QDebug>
 #include <QPixmap>
 #include <QFileInfo>
-#include <QMessageBox>
 #include <QApplication>
 #include <QSplashScreen>
 #include <QCoreApplication>
 
 /*!*******************************************************************************************************************
- * \brief Prints usage information for the EMStudio application.
+ * \brief Creates the application object: a plain QCoreApplication for headless runs, QApplication otherwise.
  *
- * This function outputs the command-line usage and available options for the application.
+ * Headless runs, report aggregation and result store queries never instantiate widgets, so they need neither a
+ * display nor a Qt platform plugin.
  **********************************************************************************************************************/
-void printHelp()
+static QCoreApplication *createApplication(int &argc, char *argv[])
 {
-    qDebug() << "Usage: EMStudio [options] [model.py]";
-    qDebug() << "\nOptions:";
-    qDebug() << "  -h, --help            Show this help message";
-    qDebug() << "  -gdsfile <path>       Specify path to GDS file";
-    qDebug() << "  -topcell <name>       Specify name of the top cell in the GDS file";
-    qDebug() << "  -run                  Run simulation headless (no GUI)";
-    qDebug() << "  -palace               Select Palace backend (with -run)";
-    qDebug() << "  -openems              Select OpenEMS backend (with -run)";
-    qDebug() << "\nArguments:";
-    qDebug() << "  model.py              Python model to load (optional, but usually needed)";
+    if (CommandLine::requestsHeadless(argc, argv))
+        return new QCoreApplication(argc, argv);
+    return new QApplication(argc, argv);
 }
 
 /*!*******************************************************************************************************************
  * \brief Main entry point for the EMStudio application.
  *
  * Initializes the Qt application, shows the splash screen, handles command-line arguments,
- * optionally loads a simulation JSON file, and starts the event loop.
+ * optionally loads a simulation JSON file, and starts the event loop. Modes without GUI are handed to
+ * CommandLine, which also drives the QtCore-only EMStudioHeadless executable.
  *
  * \param argc Argument count from the command line.
  * \param argv Argument vector from the command line.
@@ -112,84 +108,49 @@ void printHelp()
  **********************************************************************************************************************/
 int main(int argc, char *argv[])
 {
-    QApplication a(argc, argv);
+    QScopedPointer<QCoreApplication> app(createApplication(argc, argv));
 
     QCoreApplication::setApplicationName("EMStudio");
     QCoreApplication::setApplicationVersion(QStringLiteral(EMSTUDIO_VERSION_STR));
-
-    QString gdsFile;
-    QString topCell;
-    QString pythonFile;
-
-    bool headlessRun = false;
-    QString runTool;
-
-    const QStringList args = QCoreApplication::arguments();
-    for (int i = 1; i < args.size(); ++i) {
-        const QString &arg = args[i];
-
-        if (arg == "-h" || arg == "--help") {
-            printHelp();
-            return 0;
-        } else if (arg == "-gdsfile" && i + 1 < args.size()) {
-            gdsFile = args[++i];
-        } else if (arg == "-topcell" && i + 1 < args.size()) {
-            topCell = args[++i];
-        } else if (arg == "-run") {
-            headlessRun = true;
-        } else if (arg == "-palace") {
-            runTool = "palace";
-        } else if (arg == "-openems") {
-            runTool = "openems";
-        } else if (arg.endsWith(".py", Qt::CaseInsensitive)) {
-            pythonFile = arg;
-        } else {
-            qWarning() << "Unknown or malformed argument:" << arg;
-            printHelp();
-            return 1;
-        }
+    Tracer::startFromEnvironment();
+
+    CommandLine::Options options;
+    QString err;
+    if (!CommandLine::parse(QCoreApplication::arguments(), options, err)) {
+        qWarning().noquote() << err;
+        CommandLine::printHelp();
+        return 1;
     }
 
-    if (headlessRun) {
-        if (runTool.isEmpty()) {
-            qWarning() << "Headless mode requires backend: use -palace or -openems together with -run";
-            printHelp();
-            return 1;
-        }
-    }
+    if (!options.traceFile.isEmpty())
+        Tracer::start(options.traceFile);
 
-    QScopedPointer<QSplashScreen> splash;
-    if (!headlessRun) {
-        QPixmap pixmap(":/logo");
-        QPixmap scaledPixmap = pixmap.scaled(
-            pixmap.width() / 3,
-            pixmap.height() / 3,
-            Qt::KeepAspectRatio,
-            Qt::SmoothTransformation
-            );
-        splash.reset(new QSplashScreen(scaledPixmap));
-        splash->show();
-        a.processEvents();
-    }
+    if (options.mode != CommandLine::Mode::Gui)
+        return CommandLine::exec(options);
+
+    QPixmap pixmap(":/logo");
+    QPixmap scaledPixmap = pixmap.scaled(
+        pixmap.width() / 3,
+        pixmap.height() / 3,
+        Qt::KeepAspectRatio,
+        Qt::SmoothTransformation
+        );
+    QScopedPointer<QSplashScreen> splash(new QSplashScreen(scaledPixmap));
+    splash->show();
+    app->processEvents();
 
     MainWindow w;
 
+    const QString pythonFile = options.pythonFiles.isEmpty() ? QString() : options.pythonFiles.last();
     if (!pythonFile.isEmpty() && QFileInfo::exists(pythonFile)) {
         w.loadPythonModel(pythonFile);
     }
 
-    if (!gdsFile.isEmpty())
-        w.setGdsFile(gdsFile);
-
-    if (!topCell.isEmpty())
-        w.setTopCell(topCell);
+    if (!options.gdsFile.isEmpty())
+        w.setGdsFile(options.gdsFile);
 
-    if (headlessRun) {
-        QTimer::singleShot(0, &w, [&w, runTool]() {
-            w.runHeadless(runTool);
-        });
-        return a.exec();
-    }
+    if (!options.topCell.isEmpty())
+        w.setTopCell(options.topCell);
 
     QTimer::singleShot(1000, [&]() {
         if (splash) splash->finish(&w);
@@ -197,5 +158,5 @@ int main(int argc, char *argv[])
         w.show();
     });
 
-    return a.exec();
+    return app->exec();
 }
@@ -24,7 +24,6 @@
 #include <QDebug>
 #include <QTimer>
 #include <QAction>
-#include <QPointer>
 #include <QProcess>
 #include <QFileInfo>
 #include <QSettings>
@@ -32,6 +31,7 @@
 #include <QScrollBar>
 #include <QJsonValue>
 #include <QFileDialog>
+#include <QInputDialog>
 #include <QTextStream>
 #include <QJsonObject>
 #include <QMessageBox>
@@ -52,9 +52,18 @@
 #include "mainwindow.h"
 #include "preferences.h"
 #include "ui_mainwindow.h"
+#include "simulationlog.h"
+#include "simulationqueue.h"
+#include "simulationrunner.h"
+#include "simulationloganalyzer.h"
+#include "processtelemetry.h"
+#include "telemetrysparklines.h"
+#include "sparameterviewer.h"
 #include "substrateview.h"
 #include "pythonparser.h"
+#include "pathprobe.h"
 #include "keywordseditor.h"
+#include "tracer.h"
 
 
 /*!*******************************************************************************************************************
@@ -235,6 +244,62 @@ MainWindow::MainWindow(QWidget *parent)
     QFont mono = QFontDatabase::systemFont(QFontDatabase::FixedFont);
     m_ui->editSimulationLog->setFont(mono);
 
+    m_simLog = new SimulationLog(m_ui->editSimulationLog, this);
+    m_simLog->setMaxLines(m_sysSettings.value("SimulationLogMaxLines", SimulationLog::kDefaultMaxLines).toInt());
+    m_sysSettings["SimulationLogMaxLines"] = m_simLog->maxLines();
+
+    m_runner = new SimulationRunner(this);
+    connect(m_runner, &SimulationRunner::started, m_simLog, &SimulationLog::clear);
+    connect(m_runner, &SimulationRunner::started, this, [this]() { m_shownQueueJob = 0; });
+    connect(m_runner, &SimulationRunner::output, this, &MainWindow::appendToSimulationLog);
+    connect(m_runner, &SimulationRunner::errorOccurred, this, [this](const QString &message, bool clearLog) {
+        error(message, clearLog);
+    });
+    connect(m_runner, &SimulationRunner::runDirectoryDetected, this, [this](const QString &runDir) {
+        m_simSettings["RunDir"] = runDir;
+        m_resultsView->setRunDirectory(runDir);
+    });
+    connect(m_runner, &SimulationRunner::finished, this, &MainWindow::onSimulationFinished);
+    connect(m_runner->logAnalyzer(), &SimulationLogAnalyzer::progressChanged,
+            this, &MainWindow::onSimulationProgress);
+
+    m_telemetryView = new TelemetrySparklines(this);
+    m_ui->horizontalLayout_6->insertWidget(1, m_telemetryView);
+    connect(m_runner, &SimulationRunner::started, m_telemetryView, &TelemetrySparklines::clear);
+    connect(m_runner->telemetry(), &ProcessTelemetry::sampled,
+            m_telemetryView, &TelemetrySparklines::addSample);
+
+    m_queue = new SimulationQueue(this);
+    connect(m_queue, &SimulationQueue::jobAdded, this, &MainWindow::onQueueJobChanged);
+    connect(m_queue, &SimulationQueue::jobStateChanged, this, [this](int id, SimulationQueue::JobState) {
+        onQueueJobChanged(id);
+    });
+    connect(m_queue, &SimulationQueue::jobOutput, this, [this](int id, const QByteArray &data) {
+        if (id == m_shownQueueJob)
+            m_simLog->append(data);
+    });
+    connect(m_ui->tblQueue, &QTableWidget::itemSelectionChanged, this, [this]() {
+        const QList<QTableWidgetItem*> sel = m_ui->tblQueue->selectedItems();
+        if (!sel.isEmpty())
+            showQueueJob(m_ui->tblQueue->item(sel.first()->row(), 0)->data(Qt::UserRole).toInt());
+    });
+    addDockWidget(Qt::BottomDockWidgetArea, m_ui->dockQueue);
+    tabifyDockWidget(m_ui->dockLog, m_ui->dockQueue);
+
+    m_resultsView = new SParameterViewer(this);
+    m_ui->verticalLayout_results->addWidget(m_resultsView);
+    connect(m_runner, &SimulationRunner::started, this, [this]() {
+        m_resultsView->clear();
+        m_resultsView->setLive(true);
+    });
+    connect(m_runner, &SimulationRunner::finished, m_resultsView, [this]() { m_resultsView->setLive(false); });
+    addDockWidget(Qt::BottomDockWidgetArea, m_ui->dockResults);
+    tabifyDockWidget(m_ui->dockQueue, m_ui->dockResults);
+    m_ui->dockLog->raise();
+
+    m_ui->progressSimulation->setRange(0, 1000);
+    onSimulationProgress(0.0, -1, QString());
+
     //hide python code button and text line
     m_ui->lblRunPythonScript->setVisible(false);
     m_ui->btnRunPythonScript->setVisible(false);
@@ -315,7 +380,7 @@ void MainWindow::onTopCellChanged(const QString &text)
  * \brief Connects Window menu actions with dock widgets and keeps their visibility in sync.
  *
  * Binds checkable actions from the "Window" menu to their corresponding QDockWidget
- * instances (Run Control and Log). The action state reflects the current dock visibility,
+ * instances (Run Control, Log, Run Queue and Results). The action state reflects the current dock visibility,
  * and toggling the action shows or hides the dock. Closing a dock via its title bar
  * button also updates the associated menu action.
  *
@@ -336,13 +401,15 @@ void MainWindow::setupWindowMenuDocks()
 
     bind(m_ui->actionRun_Control, m_ui->dockRunControl);
     bind(m_ui->actionLog,         m_ui->dockLog);
+    bind(m_ui->actionRun_Queue,   m_ui->dockQueue);
+    bind(m_ui->actionResults,     m_ui->dockResults);
 }
 
 /*!*******************************************************************************************************************
  * \brief Rebuilds the "Simulation Tool" combo box (cbxSimTool) based on configured install paths.
  *
  * Reads configured tool paths from \c m_preferences, validates them with
- * pathIsExecutablePortable(), and repopulates \c cbxSimTool with the available tools
+ * one batched PathProbe query, and repopulates \c cbxSimTool with the available tools
  * ("OpenEMS", "Palace", "Elmer").
  * If none are valid, a placeholder item is shown and the combo is disabled. Emits an info() message
  * summarizing what is enabled.
@@ -358,33 +425,20 @@ void MainWindow::refreshSimToolOptions()
 
     const QString distro = m_preferences.value("WSL_DISTRO").toString().trimmed();
 
-    const bool hasOpenEMS = !openemsPath.isEmpty() && pathIsExecutablePortable(openemsPath, distro, 8000);
-
-    bool hasPalaceInstall = false;
-    if (!palacePath.isEmpty()) {
-#ifdef Q_OS_WIN
-        const QString palaceRootLinux = toLinuxPathPortable(palacePath, distro, 8000);
-        const QString palaceExeLinux  = QDir(palaceRootLinux).filePath("bin/palace");
-        hasPalaceInstall = !palaceRootLinux.isEmpty() && pathIsExecutablePortable(palaceExeLinux, distro, 8000);
-#else
-        const QString palaceExe = QDir(palacePath).filePath("bin/palace");
-        hasPalaceInstall = pathIsExecutablePortable(palaceExe, distro, 800);
-#endif
-    }
-
-    bool hasPalaceScript = false;
-    if (!palaceScriptPath.isEmpty()) {
-#ifdef Q_OS_WIN
-        hasPalaceScript = pathIsExecutablePortable(palaceScriptPath, distro, 8000);
-#else
-        hasPalaceScript = pathIsExecutablePortable(palaceScriptPath, distro, 800);
-#endif
-    }
+    const QString palaceRootLinux = palacePath.isEmpty() ? QString() : toLinuxPathPortable(palacePath, distro, 8000);
+    const QString palaceExeLinux  = palaceRootLinux.isEmpty() ? QString() : QDir(palaceRootLinux).filePath("bin/palace");
 
-    const bool hasPalace = hasPalaceInstall || hasPalaceScript;
+    // All executables in one batch: a single WSL round trip on Windows, cached by PathProbe.
+    const QList<PathProbe::Result> found = PathProbe::shared().resolve({
+        {PathProbe::Query::Executable, openemsPath},
+        {PathProbe::Query::Executable, palaceExeLinux},
+        {PathProbe::Query::Executable, palaceScriptPath},
+        {PathProbe::Query::Executable, elmerSolverPath}
+    }, distro, 8000);
 
-    const bool hasElmer = !elmerSolverPath.isEmpty()
-        && pathIsExecutablePortable(elmerSolverPath, distro, 800);
+    const bool hasOpenEMS = found.at(0).ok;
+    const bool hasPalace  = found.at(1).ok || found.at(2).ok;
+    const bool hasElmer   = found.at(3).ok;
 
     m_ui->cbxSimTool->clear();
 
@@ -489,19 +543,7 @@ bool MainWindow::fileLooksValid(const QString &path) const
  **********************************************************************************************************************/
 QString MainWindow::toWslPath(const QString &winPath) const
 {
-    if (winPath.startsWith('~')) return winPath;
-    if (winPath.startsWith('/')) return winPath;
-    if (winPath.startsWith("\\\\wsl$")) return winPath;
-
-    QString p = winPath;
-    p.replace('\\', '/');
-    if (p.size() >= 2 && p[1] == ':') {
-        const QChar drive = p[0].toLower();
-        p.remove(0, 2); // remove "C:"
-        if (!p.startsWith('/')) p.prepend('/');
-        p.prepend(QString("/mnt/%1").arg(drive));
-    }
-    return p;
+    return SimulationRunner::toWslPath(winPath);
 }
 
 /*!*******************************************************************************************************************
@@ -537,6 +579,42 @@ QString MainWindow::fromWslPath(const QString &path) const
 #endif
 }
 
+/*!*******************************************************************************************************************
+ * \brief Checks whether a path exists in a platform-portable way (Windows / Linux / WSL).
+ *
+ * On Linux, this function delegates to \c QFileInfo::exists().
+ *
+ * On Windows:
+ *  - If \a path starts with '/', it is treated as a WSL absolute path and checked
+ *    inside the WSL distribution via \c test -e (answers are cached by PathProbe).
+ *  - Otherwise it is treated as a Windows path and checked via \c QFileInfo::exists().
+ *
+ * \param path      Path to check (Windows path or WSL absolute path).
+ * \param distro    WSL distribution name (Windows only; ignored on Linux).
+ * \param timeoutMs Timeout for WSL checks in milliseconds (Windows only; ignored on Linux).
+ * \return True if the path exists in the respective environment; false otherwise.
+ **********************************************************************************************************************/
+bool MainWindow::pathExistsPortable(const QString &path, const QString &distro, int timeoutMs) const
+{
+    return PathProbe::shared().exists(path, distro, timeoutMs);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks whether a path is executable; see isExecutablePortable().
+ **********************************************************************************************************************/
+bool MainWindow::pathIsExecutablePortable(const QString &path, const QString &distro, int timeoutMs) const
+{
+    return isExecutablePortable(path, distro, timeoutMs);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts a path to its Linux/WSL form; see ::toLinuxPathPortable().
+ **********************************************************************************************************************/
+QString MainWindow::toLinuxPathPortable(const QString &path, const QString &distro, int timeoutMs) const
+{
+    return ::toLinuxPathPortable(path, distro, timeoutMs);
+}
+
 
 
 /*!*******************************************************************************************************************
@@ -792,6 +870,7 @@ void MainWindow::loadSettings()
  **********************************************************************************************************************/
 void MainWindow::setupSettingsPanel()
 {
+    EMSTUDIO_TRACE_SCOPE("propertyTree.setupSettingsPanel");
     m_propertyBrowser = new QtTreePropertyBrowser(this);
     m_variantManager  = new VariantManager(m_propertyBrowser);
 
@@ -1762,6 +1841,7 @@ bool MainWindow::isStateChanged() const
  **********************************************************************************************************************/
 void MainWindow::drawSubstrate(const QString &filePath)
 {
+    EMSTUDIO_TRACE_SCOPE("mainwindow.drawSubstrate", filePath);
     if (filePath.isEmpty()) {
         error("Substrate file path is empty", false);
         return;
@@ -1796,6 +1876,7 @@ void MainWindow::on_actionPrefernces_triggered()
     Preferences dlg(m_preferences, this);
     dlg.exec();
 
+    PathProbe::shared().invalidate();
     refreshSimToolOptions();
     refreshKeywordTipsForCurrentTool();
 
@@ -1957,20 +2038,7 @@ void MainWindow::updateBoundaryTooltipsForCurrentTool()
  **********************************************************************************************************************/
 void MainWindow::on_btnRun_clicked()
 {
-    const QString comboKey = currentSimToolKey();
-
-    const QString scriptText = m_ui->editRunPythonScript->toPlainText();
-
-    QString modelType = detectPythonModelSimKey(scriptText);
-    if (modelType == QLatin1String("unknown"))
-        modelType = QStringLiteral("palace");
-
-    QString key = comboKey;
-    if (key.isEmpty()) {
-        if (modelType == QLatin1String("openems") || modelType == QLatin1String("palace"))
-            key = modelType;
-    }
-
+    const QString key = runToolKeyForCurrentModel();
     if (key.isEmpty()) {
         error("No simulation tool selected/configured.");
         return;
@@ -1987,6 +2055,30 @@ void MainWindow::on_btnRun_clicked()
     }
 }
 
+/*!*******************************************************************************************************************
+ * \brief Returns the backend key used to run the current model.
+ *
+ * Uses the selected simulation tool; if none is selected, falls back to the backend implied by the model
+ * in the editor ("palace" for models of unknown type).
+ *
+ * \return "openems", "palace" or "elmer", or an empty string if no backend can be determined.
+ **********************************************************************************************************************/
+QString MainWindow::runToolKeyForCurrentModel() const
+{
+    const QString comboKey = currentSimToolKey();
+    if (!comboKey.isEmpty())
+        return comboKey;
+
+    QString modelType = detectPythonModelSimKey(m_ui->editRunPythonScript->toPlainText());
+    if (modelType == QLatin1String("unknown"))
+        modelType = QStringLiteral("palace");
+
+    if (modelType == QLatin1String("openems") || modelType == QLatin1String("palace"))
+        return modelType;
+
+    return QString();
+}
+
 /*!*******************************************************************************************************************
  * \brief Returns the stable key of the currently selected sim tool ("openems"/"palace"/"elmer"), or empty if none.
  **********************************************************************************************************************/
@@ -2005,50 +2097,7 @@ QString MainWindow::currentSimToolKey() const
 QString MainWindow::detectPythonModelSimKey(const QString &text,
                                             const PythonParser::Result *parsed) const
 {
-    if (text.contains(QStringLiteral("from openEMS import openEMS")))
-        return QStringLiteral("openems");
-
-    auto isTruthy = [](const QVariant &v) -> bool {
-        if (!v.isValid())
-            return false;
-        if (v.type() == QVariant::Bool)
-            return v.toBool();
-        const QString s = v.toString().trimmed();
-        return s.compare(QLatin1String("True"), Qt::CaseInsensitive) == 0
-            || s == QLatin1String("1");
-    };
-
-    if (parsed) {
-        for (auto it = parsed->settings.constBegin(); it != parsed->settings.constEnd(); ++it) {
-            if (it.key().compare(QLatin1String("elmer"), Qt::CaseInsensitive) != 0)
-                continue;
-            if (it.value().type() == QVariant::Bool && !it.value().toBool())
-                return QStringLiteral("palace");
-            if (isTruthy(it.value()))
-                return QStringLiteral("elmer");
-        }
-    }
-
-    if (QRegularExpression(R"(\[\s*['"]elmer['"]\s*\]\s*=\s*False)", QRegularExpression::CaseInsensitiveOption)
-            .match(text)
-            .hasMatch())
-        return QStringLiteral("palace");
-
-    if (QRegularExpression(R"(\[\s*['"]elmer['"]\s*\]\s*=\s*True)", QRegularExpression::CaseInsensitiveOption)
-            .match(text)
-            .hasMatch())
-        return QStringLiteral("elmer");
-
-    if (text.contains(QStringLiteral("create_elmer")) ||
-        text.contains(QStringLiteral("create_elmer_run_script")) ||
-        text.contains(QStringLiteral("./run_elmer")))
-        return QStringLiteral("elmer");
-
-    QRegularExpression re(R"(\w+\s*\[\s*['"][^'"]+['"]\s*\]\s*=)");
-    if (re.match(text).hasMatch())
-        return QStringLiteral("palace");
-
-    return QStringLiteral("unknown");
+    return PythonParser::detectSimToolKey(text, parsed);
 }
 
 /*!*******************************************************************************************************************
@@ -2082,25 +2131,13 @@ void MainWindow::selectSimToolByKey(const QString &simKey)
  **********************************************************************************************************************/
 void MainWindow::on_btnStop_clicked()
 {
-    if (!m_simProcess || m_simProcess->state() != QProcess::Running) {
+    if (!m_runner->isRunning()) {
         info("No simulation is currently running.", false);
         return;
     }
 
-    m_palacePhase = PalacePhase::None;
     info("Stopping simulation...", false);
-
-    QPointer<QProcess> p = m_simProcess;
-    p->terminate();
-
-    auto *t = new QTimer(p);
-    t->setSingleShot(true);
-    connect(t, &QTimer::timeout, p, [p]() {
-        if (p && p->state() != QProcess::NotRunning)
-            p->kill();
-    });
-
-    t->start(1500);
+    m_runner->stop();
 }
 
 
@@ -2163,6 +2200,7 @@ void MainWindow::setTopCell(const QString &cellName)
  **********************************************************************************************************************/
 void MainWindow::rebuildLayerMapping()
 {
+    EMSTUDIO_TRACE_SCOPE("mainwindow.rebuildLayerMapping");
     m_gdsToSubName.clear();
     m_subNameToGds.clear();
 
@@ -2469,6 +2507,217 @@ void MainWindow::importPortsFromEditor()
     }
 }
 
+/*!*******************************************************************************************************************
+ * \brief Compares proposed ports with the current ones by port number.
+ *
+ * Layer fields are compared after mapping GDS numbers to substrate names through
+ * \c m_gdsToSubName, so "8" and "Metal1" are treated as equal when they refer to the same layer.
+ * Directions are compared case-insensitively, an empty direction counts as \c z.
+ *
+ * \param current  Ports currently defined (usually parsed from the script).
+ * \param proposed Ports proposed by proposePortsFromGds().
+ *
+ * \return Diff with added, changed, unchanged and script-only ports.
+ **********************************************************************************************************************/
+MainWindow::PortDiff MainWindow::diffPorts(const QVector<PortInfo> &current,
+                                           const QVector<PortInfo> &proposed) const
+{
+    auto canonLayer = [&](const QString &s) -> QString {
+        const QString t = s.trimmed();
+        bool ok = false;
+        const int n = t.toInt(&ok);
+        if (ok && m_gdsToSubName.contains(n))
+            return m_gdsToSubName.value(n);
+        return t;
+    };
+
+    auto canonDir = [](const QString &s) -> QString {
+        const QString t = s.trimmed().toLower();
+        return t.isEmpty() ? QStringLiteral("z") : t;
+    };
+
+    auto samePort = [&](const PortInfo &a, const PortInfo &b) -> bool {
+        return canonLayer(a.sourceLayer) == canonLayer(b.sourceLayer) &&
+               canonLayer(a.fromLayer)   == canonLayer(b.fromLayer) &&
+               canonLayer(a.toLayer)     == canonLayer(b.toLayer) &&
+               canonDir(a.direction)     == canonDir(b.direction);
+    };
+
+    QHash<int, PortInfo> currentByNum;
+    for (const PortInfo &p : current)
+        currentByNum.insert(p.portnumber, p);
+
+    PortDiff diff;
+    QSet<int> seen;
+
+    for (const PortInfo &p : proposed) {
+        seen.insert(p.portnumber);
+
+        auto it = currentByNum.constFind(p.portnumber);
+        if (it == currentByNum.constEnd())
+            diff.added.push_back(p);
+        else if (samePort(it.value(), p))
+            diff.unchanged.push_back(p);
+        else
+            diff.changed.push_back(qMakePair(it.value(), p));
+    }
+
+    for (const PortInfo &p : current) {
+        if (!seen.contains(p.portnumber))
+            diff.scriptOnly.push_back(p);
+    }
+
+    return diff;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Formats a port diff as plain text, one line per port.
+ *
+ * Lines are prefixed with \c + (new), \c ~ (changed), \c = (unchanged) or \c - (only in script).
+ *
+ * \param diff Diff produced by diffPorts().
+ * \return Multi-line diff text.
+ **********************************************************************************************************************/
+QString MainWindow::formatPortDiff(const PortDiff &diff) const
+{
+    auto describe = [](const PortInfo &p) -> QString {
+        QString s = QStringLiteral("P%1 src=%2").arg(p.portnumber).arg(p.sourceLayer);
+        if (!p.fromLayer.isEmpty())
+            s += QStringLiteral(" from=%1").arg(p.fromLayer);
+        if (!p.toLayer.isEmpty())
+            s += QStringLiteral(" to=%1").arg(p.toLayer);
+        s += QStringLiteral(" dir=%1").arg(p.direction.isEmpty() ? QStringLiteral("z") : p.direction);
+        return s;
+    };
+
+    QStringList lines;
+    for (const PortInfo &p : diff.added)
+        lines << QStringLiteral("+ ") + describe(p);
+    for (const auto &c : diff.changed)
+        lines << QStringLiteral("~ %1  ->  %2").arg(describe(c.first), describe(c.second));
+    for (const PortInfo &p : diff.unchanged)
+        lines << QStringLiteral("= ") + describe(p);
+    for (const PortInfo &p : diff.scriptOnly)
+        lines << QStringLiteral("- ") + describe(p);
+
+    return lines.join('\n');
+}
+
+/*!*******************************************************************************************************************
+ * \brief Bulk-inserts proposed ports into the Ports table.
+ *
+ * Rows whose port number is part of \a ports are replaced, all other rows are kept. Table updates
+ * and change notifications are suspended while rows are rebuilt, so hundreds of ports are inserted in one step.
+ *
+ * \param ports Ports to insert.
+ **********************************************************************************************************************/
+void MainWindow::applyProposedPorts(const QVector<PortInfo> &ports)
+{
+    if (ports.isEmpty())
+        return;
+
+    QSet<int> numbers;
+    for (const PortInfo &p : ports)
+        numbers.insert(p.portnumber);
+
+    m_blockPortChanges = true;
+    m_ui->tblPorts->setUpdatesEnabled(false);
+
+    for (int row = m_ui->tblPorts->rowCount() - 1; row >= 0; --row) {
+        const auto *item = m_ui->tblPorts->item(row, 0);
+        bool ok = false;
+        const int num = item ? item->text().trimmed().toInt(&ok) : 0;
+        if (ok && numbers.contains(num))
+            m_ui->tblPorts->removeRow(row);
+    }
+
+    appendParsedPortsToTable(ports);
+
+    if (m_ui->cbSubLayerNames->isEnabled() && m_ui->cbSubLayerNames->isChecked())
+        applySubLayerNamesToPorts(true);
+
+    m_ui->tblPorts->setUpdatesEnabled(true);
+    m_blockPortChanges = false;
+
+    setStateChanged();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Proposes ports from the GDS file and inserts them into the Ports table after a dry-run diff.
+ *
+ * Asks for the GDS layers holding port polygons (empty = every non-substrate layer), proposes ports
+ * from TEXT labels and port-layer polygons of the current top cell, and shows the diff against the
+ * ports defined in the Python script. The ports are inserted only after confirmation.
+ **********************************************************************************************************************/
+void MainWindow::on_btnGenPortsFromGds_clicked()
+{
+    const QString gdsPath = m_ui->txtGdsFile->text().trimmed();
+    if (!QFileInfo(gdsPath).exists()) {
+        error(tr("GDS file not found: %1").arg(gdsPath), true);
+        return;
+    }
+
+    bool ok = false;
+    const QString layersText = QInputDialog::getText(
+        this, tr("Generate Ports from GDS"),
+        tr("Port layers (GDS numbers, comma separated; empty = all non-substrate layers):"),
+        QLineEdit::Normal, m_sysSettings.value("GdsPortLayers").toString(), &ok);
+    if (!ok)
+        return;
+
+    m_sysSettings["GdsPortLayers"] = layersText.trimmed();
+
+    QSet<int> portLayers;
+    for (const QString &tok : layersText.split(QRegularExpression(R"([\s,;]+)"), Qt::SkipEmptyParts)) {
+        bool isNum = false;
+        const int n = tok.toInt(&isNum);
+        if (!isNum) {
+            error(tr("Invalid port layer: %1").arg(tok), true);
+            return;
+        }
+        portLayers.insert(n);
+    }
+
+    rebuildLayerMapping();
+
+    QString err;
+    const QVector<PortInfo> proposed =
+        proposePortsFromGds(gdsPath, m_ui->cbxTopCell->currentText().trimmed(), portLayers, err);
+    if (!err.isEmpty()) {
+        error(err, true);
+        return;
+    }
+    if (proposed.isEmpty()) {
+        info(tr("No port labels or port-layer polygons found in the top cell."), true);
+        return;
+    }
+
+    const PortDiff diff   = diffPorts(parsePortsFromScript(m_ui->editRunPythonScript->toPlainText()), proposed);
+    const QString details = formatPortDiff(diff);
+    const QString summary = tr("%1 new, %2 changed, %3 unchanged, %4 only in script.")
+                                .arg(diff.added.size())
+                                .arg(diff.changed.size())
+                                .arg(diff.unchanged.size())
+                                .arg(diff.scriptOnly.size());
+
+    info(tr("Ports proposed from GDS: %1\n%2").arg(summary, details), true);
+
+    QMessageBox msg(this);
+    msg.setIcon(QMessageBox::Question);
+    msg.setWindowTitle(tr("Generate Ports from GDS"));
+    msg.setText(tr("%1 ports proposed from GDS.\n%2\n\nInsert them into the port table?")
+                    .arg(proposed.size()).arg(summary));
+    msg.setDetailedText(details);
+    QPushButton *applyBtn = msg.addButton(tr("&Apply"), QMessageBox::AcceptRole);
+    msg.addButton(QMessageBox::Cancel);
+    msg.setDefaultButton(applyBtn);
+
+    msg.exec();
+
+    if (msg.clickedButton() == applyBtn)
+        applyProposedPorts(proposed);
+}
+
 /*!*******************************************************************************************************************
  * \brief Generates and inserts the default Python simulation script into the editor.
  *
@@ -2742,7 +2991,7 @@ void MainWindow::loadPythonModel(const QString &fileName)
     if (fileName.isEmpty())
         return;
 
-    m_ui->editSimulationLog->clear();
+    clearSimulationLog();
 
     const QFileInfo fi(fileName);
     m_preferences["PALACE_MODEL_DIR"]  = fi.absolutePath();
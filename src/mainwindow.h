@@ -24,18 +24,22 @@
 #include <QMap>
 #include <QSet>
 #include <QPair>
+#include <QRect>
 #include <QVariant>
 #include <QMainWindow>
 
 #include "pythonparser.h"
 
-class QProcess;
-class QProcessEnvironment;
 class QLineEdit;
 class QComboBox;
 class QtProperty;
 class QListWidgetItem;
+class SimulationLog;
+class SimulationQueue;
+class SimulationRunner;
+class SParameterViewer;
 class QtVariantProperty;
+class TelemetrySparklines;
 class QtTreePropertyBrowser;
 class QtVariantEditorFactory;
 class QtVariantPropertyManager;
@@ -65,8 +69,6 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
     enum class ModelType { Palace, OpenEMS, Unknown };
-    enum class PalacePhase { None, PythonModel, PalaceSolver };
-    enum class Gds2PalaceSolverKind { Unknown, Palace, Elmer };
     enum class RequiredFolderDecision { ChooseAnotherDir, SaveAnyway, Cancel };
 
     /*!*******************************************************************************************************************
@@ -84,49 +86,44 @@ class MainWindow : public QMainWindow
         QString     direction;
     };
 
-    struct PalacePropInfo
+    /*!*******************************************************************************************************************
+    * \brief Text label (GDS TEXT element) found in the top cell of a layout.
+    **********************************************************************************************************************/
+    struct GdsLabel
     {
-        int         propType = QVariant::String;
-        QVariant    value;
-        int         decimals = 12;
-        double      step = 0.0;
+        QString     text;
+        int         layer       = -1;
+        QPoint      pos;
     };
 
-    struct PalaceRunContext
+    /*!*******************************************************************************************************************
+    * \brief Bounding box of a polygon (GDS BOUNDARY/BOX element) found in the top cell of a layout.
+    **********************************************************************************************************************/
+    struct GdsShape
     {
-        QString simKeyLower;
-
-        QString modelWin;
-        QString launcherWin;
-        int     runMode = 0;
-
-        QString baseName;
-        QString runDirGuessWin;
-
-        QString palaceRoot;
-        QString distro;
-        QString pythonCmd;
-        QStringList pythonArgs;
-
-        bool    useWsl = true;
-
-        QString palaceExeLinux;
-        QString modelDirLinux;
-        QString modelLinux;
-
-        QString detectedRunDirWin;
-        QString searchDirWin;
-
-        QString configPathWin;
-        QString configLinux;
+        int         layer       = -1;
+        int         datatype    = 0;
+        QRect       bbox;
     };
 
-    struct CoreCountResult
+    /*!*******************************************************************************************************************
+    * \brief Result of comparing proposed ports against the ports currently defined in the script.
+    **********************************************************************************************************************/
+    struct PortDiff
     {
-        QString cores;
-        QString source;  // "physical (lscpu)" / "logical (nproc)"
+        QVector<PortInfo>                   added;
+        QVector<QPair<PortInfo, PortInfo>>  changed;     // (current, proposed)
+        QVector<PortInfo>                   unchanged;
+        QVector<PortInfo>                   scriptOnly;
     };
 
+    struct PalacePropInfo
+    {
+        int         propType = QVariant::String;
+        QVariant    value;
+        int         decimals = 12;
+        double      step = 0.0;
+    };
 
 public:
     MainWindow(QWidget *parent = nullptr);
@@ -137,7 +134,6 @@ public:
     void                            setSubstrateFile(const QString &filePath);
     void                            tryAutoLoadRecentPythonForTopCell();
     void                            loadPythonModel(const QString &fileName);
-    void                            runHeadless(const QString& simKeyLower);
 
 #ifdef EMSTUDIO_TESTING
     friend class OpenemsGolden;
@@ -160,8 +156,6 @@ public:
     void                            testSetRunPythonScriptPath(const QString& path);
     void                            testRunOpenems(bool interactive = false);
     void                            testRunPalace(bool interactive = false);
-    void                            testRunHeadless(const QString& simKeyLower);
-    bool                            testIsHeadless() const;
     QString                         testToLinuxPathPortable(const QString& path,
                                     const QString& distro,
                                     int timeoutMs) const;
@@ -172,6 +166,12 @@ public:
     QString                         testPortCellText(int row, int col) const;
     QString                         testPortComboText(int row, int col) const;
     void                            testClickAddPort();
+    QVector<PortInfo>               testProposePortsFromGds(const QString& gdsPath,
+                                                            const QString& topCell,
+                                                            const QSet<int>& portLayers,
+                                                            QString* outError = nullptr);
+    QString                         testDiffProposedPorts(const QVector<PortInfo>& proposed);
+    void                            testApplyProposedPorts(const QVector<PortInfo>& proposed);
     void                            testClickRemoveCurrentPort();
     void                            testRemoveAllPorts();
     void                            testSetCurrentPortRow(int row);
@@ -244,6 +244,7 @@ private slots:
 
     void                            on_txtGdsFile_textChanged(const QString &arg1);
     void                            on_btnAddPort_clicked();
+    void                            on_btnGenPortsFromGds_clicked();
 
     void                            on_btnReomovePort_clicked();
     void                            on_btnRemovePorts_clicked();
@@ -260,6 +261,9 @@ private slots:
 
     void                            on_btnRun_clicked();
     void                            on_btnStop_clicked();
+    void                            on_btnQueue_clicked();
+    void                            on_btnCancelJob_clicked();
+    void                            on_actionParameter_Sweep_triggered();
 
     void                            on_cbSubLayerNames_stateChanged(int arg1);
     void                            on_btnGenDefaultPython_clicked();
@@ -295,6 +299,19 @@ private:
 
     QStringList                     extractGdsCellNames(const QString &filePath);
     QSet<QPair<int, int>>           extractGdsLayerNumbers(const QString &filePath);
+    bool                            extractGdsPortGeometry(const QString &filePath,
+                                                           const QString &topCell,
+                                                           QVector<GdsLabel> &outLabels,
+                                                           QVector<GdsShape> &outShapes,
+                                                           QString &outError);
+    QVector<PortInfo>               proposePortsFromGds(const QString &filePath,
+                                                        const QString &topCell,
+                                                        const QSet<int> &portLayers,
+                                                        QString &outError);
+    PortDiff                        diffPorts(const QVector<PortInfo> &current,
+                                              const QVector<PortInfo> &proposed) const;
+    QString                         formatPortDiff(const PortDiff &diff) const;
+    void                            applyProposedPorts(const QVector<PortInfo> &ports);
 
     QStringList                     readSubstrateLayers(const QString &xmlFilePath);
     QHash<int, QString>             readSubstrateLayerMap(const QString &xmlFilePath);
@@ -307,7 +324,6 @@ private:
     void                            loadPythonScriptToEditor(const QString &filePath);
     void                            setLineEditPalette(QLineEdit* lineEdit, const QString& path);
     void                            applySimSettingsToScript(QString &script, const QString &simKeyLower);
-    bool                            variantToPythonLiteral(const QVariant &v, QString *outLiteral);
     bool                            keyIsExcludedForEm(const QString &key);
     void                            applyOpenEmsSettings(QString &script);
     void                            applyPalaceSettings(QString &script);
@@ -399,57 +415,22 @@ private:
     void                            runPalace(bool interactive = true);
     void                            runOpenEMS(bool interactive = true);
 
-    bool                            buildPalaceRunContext(PalaceRunContext &ctx, QString &outError);
-    void                            logPalaceStartupInfo(const PalaceRunContext &ctx);
-
-    void                            startPalacePythonStage(const PalaceRunContext &ctx);
-    void                            startPalaceSolverStage(PalaceRunContext &ctx);
-    void                            startElmerSolverStage(PalaceRunContext &ctx);
-    Gds2PalaceSolverKind            detectGds2PalaceSolverKind(const QString &runDir,
-                                                               const QString &simKeyLower) const;
-    QString                         resolveGds2PalaceRunDir(const PalaceRunContext &ctx) const;
-    QString                         buildElmerEnvShellPrefix() const;
-    void                            applyElmerHomeToProcessEnv(QProcessEnvironment &env) const;
-    bool                            resolveElmerPythonLaunch(QString &outExe, QStringList &outArgs) const;
-    void                            patchElmerSifFilesNoMumps(const QString &runDir) const;
-
-    void                            failPalaceSolver(const QString &message, bool showDialog);
-
-    bool                            startPalaceLauncherStage(PalaceRunContext &ctx);
-    bool                            preparePalaceSolverLaunch(PalaceRunContext &ctx,
-                                                              QString &outWorkDirLinux,
-                                                              QString &outCmd,
-                                                              QString &outCores);
-
-    bool                            runPalaceSolverWindows(const PalaceRunContext &ctx, const QString &cmd);
-    bool                            runPalaceSolverLinux(const PalaceRunContext &ctx,
-                                                         const QString &workDirLinux,
-                                                         const QString &cmd);
-
-    QString                         queryWslCpuCores(const QString &distro) const;
-    CoreCountResult                 detectMpiCoreCount() const;
-
-    void                            connectPalaceProcessIo();
-    void                            onPalaceProcessFinished(int exitCode);
-    QString                         detectPhysicalCoreCountLinux() const;
-
+    void                            syncRunnerState();
     void                            appendToSimulationLog(const QByteArray &data);
-    QString                         detectRunDirFromLog() const;
-
-    QString                         guessDefaultPalaceRunDir(const QString &modelFile, const QString &baseName) const;
-    QString                         chooseSearchDir(const QString &detectedRunDir, const QString &defaultRunDir) const;
+    void                            clearSimulationLog();
+    void                            onSimulationProgress(double fraction, qint64 etaSeconds, const QString &status);
+    void                            onSimulationFinished(int exitCode);
 
-    QString                         findPalaceConfigJson(const QString &runDir) const;
+    QString                         runToolKeyForCurrentModel() const;
+    bool                            prepareModelForQueue(QString &outKey);
+    void                            onQueueJobChanged(int id);
+    void                            showQueueJob(int id);
+    int                             queueRowForJob(int id) const;
 
     bool                            pathExistsPortable(const QString &path, const QString &distro, int timeoutMs) const;
     bool                            pathIsExecutablePortable(const QString &path, const QString &distro, int timeoutMs) const;
     QString                         toLinuxPathPortable(const QString &path, const QString &distro, int timeoutMs) const;
 
-#ifdef Q_OS_WIN
-    bool                            ensureWslAvailable(QString &outError) const;
-    QString                         wslToWinPath(const QString &p) const;
-#endif
-
     void                            setupWindowMenuDocks();
 
     void                            refreshSimToolOptions();
@@ -468,7 +449,6 @@ private:
 
     QString                         m_modelGdsKey;
     QString                         m_modelXmlKey;
-    QString                         m_palacePythonOutput;
 
     QStringList                     m_cells;
     QSet<QPair<int, int>>           m_layers;
@@ -485,7 +465,12 @@ private:
     bool                            m_headless = false;
     bool                            m_blockPortChanges;
 
-    QProcess                        *m_simProcess = nullptr;
+    SimulationLog                   *m_simLog = nullptr;
+    SimulationRunner                *m_runner = nullptr;
+    TelemetrySparklines             *m_telemetryView = nullptr;
+    SParameterViewer                *m_resultsView = nullptr;
+    SimulationQueue                 *m_queue = nullptr;
+    int                             m_shownQueueJob = 0;
 
     QtVariantPropertyManager        *m_variantManager = nullptr;
     QtTreePropertyBrowser           *m_propertyBrowser = nullptr;
@@ -498,8 +483,6 @@ private:
 
     PythonParser::Result            m_curPythonData;
 
-    PalacePhase                     m_palacePhase = PalacePhase::None;
-
 };
 
 #endif // MAINWINDOW_H
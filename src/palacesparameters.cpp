@@ -0,0 +1,439 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDirIterator>
+#include <QRegularExpression>
+
+#include <cmath>
+#include <limits>
+#include <cstring>
+#include <algorithm>
+
+#include "palacesparameters.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/*!*******************************************************************************************************************
+ * \brief Returns the factor from the frequency unit \a unit (Hz, kHz, MHz, GHz, THz) to Hz, or 0 if unknown.
+ **********************************************************************************************************************/
+double frequencyScale(const QString &unit)
+{
+    const QString u = unit.trimmed().toLower();
+    if (u == QLatin1String("hz"))  return 1.0;
+    if (u == QLatin1String("khz")) return 1e3;
+    if (u == QLatin1String("mhz")) return 1e6;
+    if (u == QLatin1String("ghz")) return 1e9;
+    if (u == QLatin1String("thz")) return 1e12;
+    return 0.0;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Creates a reader for the port-S.csv file at \a path; nothing is read before poll().
+ **********************************************************************************************************************/
+PalaceSParameters::PalaceSParameters(const QString &path)
+    : m_path(path)
+{
+}
+
+/*!*******************************************************************************************************************
+ * \brief Switches to another file and drops all data read so far.
+ **********************************************************************************************************************/
+void PalaceSParameters::setPath(const QString &path)
+{
+    m_path = path;
+    reset();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Drops all data and starts reading the file from the beginning at the next poll(); the band is kept.
+ **********************************************************************************************************************/
+void PalaceSParameters::reset()
+{
+    m_offset = 0;
+    m_pending.clear();
+    m_header.clear();
+
+    m_ports = 0;
+    m_columns = 0;
+    m_scale = 0.0;
+    m_entries.clear();
+    m_row.clear();
+
+    m_index.clear();
+    m_frequencies.clear();
+    m_values.clear();
+
+    m_bandDirty = false;
+    m_bandChange = -1.0;
+    m_stableUpdates = 0;
+    m_bandSamples.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the bytes appended to the file since the previous call.
+ *
+ * A missing file is not an error (the solver may not have written it yet).
+ *
+ * \param outError Human-readable error message; set only on failure.
+ * \return True if rows were added or updated; false if nothing changed or on failure.
+ **********************************************************************************************************************/
+bool PalaceSParameters::poll(QString &outError)
+{
+    QFile file(m_path);
+    if (!file.exists())
+        return false;
+    if (!file.open(QIODevice::ReadOnly)) {
+        outError = QString("Cannot open %1").arg(QDir::toNativeSeparators(m_path));
+        return false;
+    }
+
+    const qint64 size = file.size();
+    if (size < m_offset || (!m_header.isEmpty() && file.read(m_header.size()) != m_header))
+        reset();
+    if (size == m_offset)
+        return false;
+
+    if (!file.seek(m_offset)) {
+        outError = QString("Cannot read %1").arg(QDir::toNativeSeparators(m_path));
+        return false;
+    }
+
+    const QByteArray data = file.read(size - m_offset);
+    m_offset += data.size();
+    return append(data, outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Feeds appended file content; complete lines are parsed, an unfinished last line is kept for later.
+ *
+ * \param data     Bytes following the previously fed ones.
+ * \param outError Human-readable error message; set only on failure.
+ * \return True if rows were added or updated.
+ **********************************************************************************************************************/
+bool PalaceSParameters::append(const QByteArray &data, QString &outError)
+{
+    m_pending += data;
+
+    const int last = m_pending.lastIndexOf('\n');
+    if (last < 0)
+        return false;
+
+    bool changed = false;
+    const char *begin = m_pending.constData();
+    const char *end = begin + last + 1;
+    const char *pos = begin;
+
+    while (pos < end) {
+        const char *eol = static_cast<const char *>(std::memchr(pos, '\n', size_t(end - pos)));
+        const char *line = pos;
+        pos = eol + 1;
+
+        if (m_header.isEmpty()) {
+            const QByteArray header(line, int(pos - line));
+            if (!parseHeader(header, outError)) {
+                m_pending.clear();
+                return false;
+            }
+            m_header = header;
+            continue;
+        }
+
+        if (parseRow(line, eol))
+            changed = true;
+    }
+
+    m_pending.remove(0, last + 1);
+
+    if (changed && hasBand())
+        updateBand();
+    return changed;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses the header: "f (GHz)" followed by "|S[i][j]| (dB)" and "arg(S[i][j]) (deg.)" columns.
+ **********************************************************************************************************************/
+bool PalaceSParameters::parseHeader(const QByteArray &line, QString &outError)
+{
+    static const QRegularExpression unitRe(QStringLiteral("\\((\\w*Hz)\\)"), QRegularExpression::CaseInsensitiveOption);
+    static const QRegularExpression indexRe(QStringLiteral("S\\[(\\d+)\\]\\[(\\d+)\\]"));
+
+    const QList<QByteArray> names = line.split(',');
+    const QRegularExpressionMatch unit = unitRe.match(QString::fromUtf8(names.first()));
+    m_scale = unit.hasMatch() ? frequencyScale(unit.captured(1)) : 0.0;
+    if (m_scale <= 0.0) {
+        outError = QString("%1: missing frequency column").arg(QDir::toNativeSeparators(m_path));
+        return false;
+    }
+
+    struct Column
+    {
+        int     row;
+        int     column;
+        int     index;
+        bool    phase;
+    };
+
+    QVector<Column> found;
+    m_ports = 0;
+    for (int i = 1; i < names.size(); ++i) {
+        const QString name = QString::fromUtf8(names.at(i)).trimmed();
+        const QRegularExpressionMatch m = indexRe.match(name);
+        if (!m.hasMatch())
+            continue;
+        const Column c { m.captured(1).toInt() - 1, m.captured(2).toInt() - 1, i,
+                         name.startsWith(QLatin1String("arg")) };
+        if (c.row < 0 || c.column < 0)
+            continue;
+        found.append(c);
+        m_ports = qMax(m_ports, qMax(c.row, c.column) + 1);
+    }
+    if (m_ports <= 0) {
+        outError = QString("%1: no S-parameter columns").arg(QDir::toNativeSeparators(m_path));
+        return false;
+    }
+
+    QMap<int, Entry> entries;
+    for (const Column &c : found) {
+        Entry &e = entries[c.row * m_ports + c.column];
+        e.index = c.row * m_ports + c.column;
+        (c.phase ? e.argColumn : e.dbColumn) = c.index;
+    }
+    m_entries.clear();
+    for (const Entry &e : entries)
+        if (e.dbColumn >= 0)
+            m_entries.append(e);
+
+    m_columns = names.size();
+    m_row.resize(m_columns);
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses one data row and merges it into the S-matrix of its frequency.
+ *
+ * Non-numeric S-parameter cells ("nan", "NULL") leave their entry unchanged, so entries of excitations not solved
+ * yet stay NaN.
+ *
+ * \return False for rows with too few fields or a malformed frequency, which are skipped.
+ **********************************************************************************************************************/
+bool PalaceSParameters::parseRow(const char *begin, const char *end)
+{
+    const char *p = begin;
+    double *fields = m_row.data();
+
+    for (int n = 0; n < m_columns; ++n) {
+        if (!Touchstone::parseNumber(p, end, fields[n])) {
+            if (n == 0 || p == end)
+                return false;
+            fields[n] = std::numeric_limits<double>::quiet_NaN();
+            while (p < end && *p != ',')
+                ++p;
+        }
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            ++p;
+        if (p < end && *p == ',')
+            ++p;
+    }
+
+    const double f = fields[0] * m_scale;
+    const int perPoint = m_ports * m_ports;
+
+    int slot = m_index.value(f, -1);
+    if (slot < 0) {
+        slot = m_frequencies.size();
+        m_index.insert(f, slot);
+        m_frequencies.append(f);
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        m_values.insert(m_values.size(), perPoint, Touchstone::Complex(nan, nan));
+    }
+
+    Touchstone::Complex *values = m_values.data() + qint64(slot) * perPoint;
+    for (const Entry &e : m_entries) {
+        if (std::isnan(fields[e.dbColumn]))
+            continue;
+        const double magnitude = std::pow(10.0, fields[e.dbColumn] / 20.0);
+        const double phase = e.argColumn >= 0 ? fields[e.argColumn] * kPi / 180.0 : 0.0;
+        values[e.index] = std::polar(magnitude, phase);
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the S-parameters read so far, sorted by frequency.
+ **********************************************************************************************************************/
+Touchstone::Network PalaceSParameters::network() const
+{
+    Touchstone::Network out;
+    if (m_ports <= 0)
+        return out;
+
+    const int perPoint = m_ports * m_ports;
+    out.resize(m_ports, m_frequencies.size());
+    out.comments << QString("Palace %1").arg(QFileInfo(m_path).fileName());
+
+    int f = 0;
+    for (auto it = m_index.constBegin(); it != m_index.constEnd(); ++it, ++f) {
+        out.frequencies[f] = it.key();
+        std::copy_n(m_values.constData() + qint64(it.value()) * perPoint, perPoint,
+                    out.values.data() + qint64(f) * perPoint);
+    }
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the band of interest for bandConverged(); an empty band disables the tracking.
+ *
+ * \param fMinHz    Lower band edge in Hz.
+ * \param fMaxHz    Upper band edge in Hz.
+ * \param tolerance Largest change of any interpolated S-parameter (linear magnitude of the complex difference)
+ *                  between two updates that still counts as converged.
+ **********************************************************************************************************************/
+void PalaceSParameters::setBand(double fMinHz, double fMaxHz, double tolerance)
+{
+    m_bandMin = fMinHz;
+    m_bandMax = fMaxHz;
+    m_tolerance = tolerance;
+    m_bandChange = -1.0;
+    m_stableUpdates = 0;
+    m_bandSamples.clear();
+
+    if (hasBand() && !m_frequencies.isEmpty())
+        updateBand();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true once the band is covered, fully reported and stayed within the tolerance for kStableUpdates
+ *        updates.
+ **********************************************************************************************************************/
+bool PalaceSParameters::bandConverged() const
+{
+    return hasBand() && m_stableUpdates >= kStableUpdates;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Re-samples the band and compares the samples with those of the previous update.
+ **********************************************************************************************************************/
+void PalaceSParameters::updateBand()
+{
+    const int perPoint = m_ports * m_ports;
+    const QVector<double> keys = m_index.keys().toVector();
+
+    if (keys.isEmpty() || keys.first() > m_bandMin || keys.last() < m_bandMax) {
+        m_bandSamples.clear();
+        m_bandChange = -1.0;
+        m_stableUpdates = 0;
+        return;
+    }
+
+    QVector<Touchstone::Complex> samples(kBandSamples * perPoint);
+    for (int k = 0; k < kBandSamples; ++k) {
+        const double f = m_bandMin + (m_bandMax - m_bandMin) * k / (kBandSamples - 1);
+        int hi = int(std::lower_bound(keys.constBegin(), keys.constEnd(), f) - keys.constBegin());
+        hi = qBound(0, hi, keys.size() - 1);
+        const int lo = keys.at(hi) > f && hi > 0 ? hi - 1 : hi;
+
+        const Touchstone::Complex *a = m_values.constData() + qint64(m_index.value(keys.at(lo))) * perPoint;
+        const Touchstone::Complex *b = m_values.constData() + qint64(m_index.value(keys.at(hi))) * perPoint;
+        const double t = hi == lo ? 0.0 : (f - keys.at(lo)) / (keys.at(hi) - keys.at(lo));
+
+        Touchstone::Complex *out = samples.data() + qint64(k) * perPoint;
+        for (int i = 0; i < perPoint; ++i)
+            out[i] = a[i] + (b[i] - a[i]) * t;
+    }
+
+    if (m_bandSamples.size() == samples.size()) {
+        double change = 0.0;
+        bool complete = true;
+        for (int i = 0; i < samples.size(); ++i) {
+            const double d = std::abs(samples.at(i) - m_bandSamples.at(i));
+            if (std::isfinite(d))
+                change = qMax(change, d);
+            else
+                complete = false;   // entry not reported yet, e.g. a later excitation
+        }
+        m_bandChange = change;
+        m_stableUpdates = complete && change <= m_tolerance ? m_stableUpdates + 1 : 0;
+    } else {
+        m_bandChange = -1.0;
+        m_stableUpdates = 0;
+    }
+
+    m_bandSamples = samples;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the most recently modified port-S.csv below \a runDir, or an empty string.
+ **********************************************************************************************************************/
+QString PalaceSParameters::findFile(const QString &runDir)
+{
+    if (runDir.isEmpty() || !QFileInfo(runDir).isDir())
+        return QString();
+
+    QString best;
+    QDateTime bestTime;
+
+    QDirIterator it(runDir, QStringList() << QStringLiteral("port-S.csv"), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        if (best.isEmpty() || fi.lastModified() > bestTime) {
+            best = fi.absoluteFilePath();
+            bestTime = fi.lastModified();
+        }
+    }
+    return best;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads a complete port-S.csv file in one go.
+ *
+ * \param path     File to read.
+ * \param out      Receives the network, sorted by frequency.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool PalaceSParameters::read(const QString &path, Touchstone::Network &out, QString &outError)
+{
+    PalaceSParameters reader(path);
+    if (!QFileInfo::exists(path)) {
+        outError = QString("Cannot open %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    outError.clear();
+    reader.poll(outError);
+    if (!outError.isEmpty())
+        return false;
+
+    out = reader.network();
+    if (!out.isValid()) {
+        outError = QString("%1 contains no frequency points").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
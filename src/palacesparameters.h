@@ -0,0 +1,110 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef PALACESPARAMETERS_H
+#define PALACESPARAMETERS_H
+
+#include <QMap>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class PalaceSParameters
+ * \brief Incremental reader ("tail") of the port-S.csv table that Palace writes during a frequency sweep.
+ *
+ * poll() reads only the bytes appended since the previous call, parses the complete rows among them and merges
+ * them into an in-memory S-matrix per frequency; an unfinished last row is kept until its line break arrives.
+ * If the file shrinks or its header changes (a new run), the reader starts over. Rows of a frequency seen before
+ * (one row per excitation) update that frequency; entries never reported stay NaN.
+ *
+ * With setBand() the reader also tracks convergence of a band of interest: after each poll that changed the
+ * band, the S-matrix is sampled by linear interpolation at kBandSamples frequencies across the band and compared
+ * to the previous sampling. The band counts as converged once the samples cover it, no sampled entry is NaN (in a
+ * multi-port run the later excitations may not have reached the band yet) and the largest change stayed below the
+ * tolerance for kStableUpdates consecutive updates.
+ **********************************************************************************************************************/
+class PalaceSParameters
+{
+public:
+    explicit PalaceSParameters(const QString &path = QString());
+
+    void                        setPath(const QString &path);
+    QString                     path() const { return m_path; }
+    void                        reset();
+
+    bool                        poll(QString &outError);
+    bool                        append(const QByteArray &data, QString &outError);
+
+    int                         ports() const { return m_ports; }
+    int                         frequencyCount() const { return m_frequencies.size(); }
+    Touchstone::Network         network() const;
+
+    void                        setBand(double fMinHz, double fMaxHz, double tolerance);
+    bool                        hasBand() const { return m_bandMax > m_bandMin; }
+    bool                        bandConverged() const;
+    double                      lastBandChange() const { return m_bandChange; }
+
+    static QString              findFile(const QString &runDir);
+    static bool                 read(const QString &path, Touchstone::Network &out, QString &outError);
+
+    static constexpr int        kBandSamples = 64;
+    static constexpr int        kStableUpdates = 2;
+
+private:
+    struct Entry
+    {
+        int                     index = 0;      // row * ports + column
+        int                     dbColumn = -1;
+        int                     argColumn = -1;
+    };
+
+    bool                        parseHeader(const QByteArray &line, QString &outError);
+    bool                        parseRow(const char *begin, const char *end);
+    void                        updateBand();
+
+private:
+    QString                     m_path;
+    qint64                      m_offset = 0;
+    QByteArray                  m_pending;      // unfinished last line
+    QByteArray                  m_header;
+
+    int                         m_ports = 0;
+    int                         m_columns = 0;
+    double                      m_scale = 0.0;  // frequency unit -> Hz
+    QVector<Entry>              m_entries;
+    QVector<double>             m_row;
+
+    QMap<double, int>           m_index;        // frequency (Hz) -> slot
+    QVector<double>             m_frequencies;  // Hz, in order of first appearance
+    QVector<Touchstone::Complex> m_values;      // [slot][row][column]
+
+    double                      m_bandMin = 0.0;
+    double                      m_bandMax = 0.0;
+    double                      m_tolerance = 1e-3;
+    bool                        m_bandDirty = false;
+    double                      m_bandChange = -1.0;
+    int                         m_stableUpdates = 0;
+    QVector<Touchstone::Complex> m_bandSamples;
+};
+
+#endif // PALACESPARAMETERS_H
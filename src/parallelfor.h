@@ -0,0 +1,69 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of worker threads to use: \a requested if positive, the hardware concurrency otherwise.
+ **********************************************************************************************************************/
+inline int parallelThreadCount(int requested)
+{
+    return requested > 0 ? requested : qMax(1, int(std::thread::hardware_concurrency()));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Calls fn(index, scratch) for every index in [0, count) on up to \a threads threads.
+ *
+ * Used by the S-parameter kernels, which process independent frequencies or matrix entries. Indices are handed
+ * out one at a time, so uneven work per index is balanced; every thread owns one default-constructed Scratch
+ * object for its buffers. Small counts run on the calling thread only.
+ *
+ * \param count   Number of indices.
+ * \param threads Upper limit of threads, including the calling one (see parallelThreadCount()).
+ * \param fn      Callable taking (int index, Scratch &scratch); must be safe to call concurrently.
+ **********************************************************************************************************************/
+template <typename Scratch, typename Fn>
+void parallelFor(int count, int threads, Fn fn)
+{
+    threads = qBound(1, threads, qMax(1, count / 4));
+
+    std::atomic<int> next(0);
+    auto work = [&]() {
+        Scratch scratch;
+        for (int i = next++; i < count; i = next++)
+            fn(i, scratch);
+    };
+
+    std::vector<std::thread> workers;
+    for (int t = 1; t < threads; ++t)
+        workers.emplace_back(work);
+    work();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+#endif // PARALLELFOR_H
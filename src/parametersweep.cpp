@@ -0,0 +1,525 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <cmath>
+
+#include <QDir>
+#include <QSet>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QDirIterator>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+
+#include "pythonparser.h"
+#include "parametersweep.h"
+#include "simulationqueue.h"
+
+/*!*******************************************************************************************************************
+ * \brief Constructs an empty cartesian sweep.
+ *
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+ParameterSweep::ParameterSweep(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses a sweep definition ("key = values" lines, optional "mode = cartesian|listed").
+ *
+ * Empty lines and '#' comments are ignored. Each key may appear only once.
+ *
+ * \param text     Sweep definition text.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ParameterSweep::parseDefinition(const QString &text, QString &outError)
+{
+    m_axes.clear();
+    m_mode = Mode::Cartesian;
+
+    const QStringList lines = text.split('\n');
+    for (int i = 0; i < lines.size(); ++i) {
+        QString line = lines.at(i);
+        const int hash = line.indexOf('#');
+        if (hash >= 0)
+            line.truncate(hash);
+        line = line.trimmed();
+        if (line.isEmpty())
+            continue;
+
+        const int eq = line.indexOf('=');
+        if (eq <= 0) {
+            outError = QString("Sweep line %1: expected 'key = values'.").arg(i + 1);
+            return false;
+        }
+
+        const QString key   = line.left(eq).trimmed();
+        const QString value = line.mid(eq + 1).trimmed();
+
+        if (key.compare(QLatin1String("mode"), Qt::CaseInsensitive) == 0) {
+            if (value.compare(QLatin1String("cartesian"), Qt::CaseInsensitive) == 0) {
+                m_mode = Mode::Cartesian;
+            } else if (value.compare(QLatin1String("listed"), Qt::CaseInsensitive) == 0) {
+                m_mode = Mode::Listed;
+            } else {
+                outError = QString("Sweep line %1: unknown mode '%2'.").arg(i + 1).arg(value);
+                return false;
+            }
+            continue;
+        }
+
+        for (const Axis &axis : m_axes) {
+            if (axis.key == key) {
+                outError = QString("Sweep line %1: key '%2' is defined twice.").arg(i + 1).arg(key);
+                return false;
+            }
+        }
+
+        QString err;
+        const QVariantList values = parseValues(value, err);
+        if (values.isEmpty()) {
+            outError = QString("Sweep line %1: %2").arg(i + 1).arg(err);
+            return false;
+        }
+
+        addAxis(key, values);
+    }
+
+    if (m_axes.isEmpty()) {
+        outError = QStringLiteral("Sweep definition has no parameters.");
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds a swept key with its values.
+ **********************************************************************************************************************/
+void ParameterSweep::addAxis(const QString &key, const QVariantList &values)
+{
+    Axis axis;
+    axis.key    = key.trimmed();
+    axis.values = values;
+    m_axes.append(axis);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses a value list: comma separated literals or an inclusive "start:step:stop" range.
+ *
+ * Literals are converted to int, double or bool (True/False); quoted text stays a string. A range yields
+ * integers if start, step and stop are integers.
+ *
+ * \param text     Value list text.
+ * \param outError Human-readable error message if no value could be parsed.
+ * \return Parsed values; empty on error.
+ **********************************************************************************************************************/
+QVariantList ParameterSweep::parseValues(const QString &text, QString &outError)
+{
+    QVariantList values;
+
+    const QStringList range = text.split(':');
+    if (range.size() == 3) {
+        bool ok1 = false, ok2 = false, ok3 = false;
+        const double start = range.at(0).trimmed().toDouble(&ok1);
+        const double step  = range.at(1).trimmed().toDouble(&ok2);
+        const double stop  = range.at(2).trimmed().toDouble(&ok3);
+        if (!ok1 || !ok2 || !ok3) {
+            outError = QString("invalid range '%1'.").arg(text);
+            return values;
+        }
+        if (step == 0.0 || (stop - start) / step < 0.0) {
+            outError = QString("range '%1' does not reach its end value.").arg(text);
+            return values;
+        }
+
+        const double count = std::floor((stop - start) / step + 1e-9) + 1.0;
+        if (count > kMaxVariants) {
+            outError = QString("range '%1' has more than %2 values.").arg(text).arg(kMaxVariants);
+            return values;
+        }
+
+        bool i1 = false, i2 = false, i3 = false;
+        range.at(0).trimmed().toInt(&i1);
+        range.at(1).trimmed().toInt(&i2);
+        range.at(2).trimmed().toInt(&i3);
+        const bool integral = i1 && i2 && i3;
+
+        for (int i = 0; i < int(count); ++i) {
+            const double v = start + i * step;
+            if (integral)
+                values << QVariant(int(std::lround(v)));
+            else
+                values << QVariant(v);
+        }
+        return values;
+    }
+
+    for (QString item : text.split(',')) {
+        item = item.trimmed();
+        if (item.isEmpty())
+            continue;
+
+        bool ok = false;
+        const int i = item.toInt(&ok);
+        if (ok) {
+            values << QVariant(i);
+            continue;
+        }
+
+        const double d = item.toDouble(&ok);
+        if (ok) {
+            values << QVariant(d);
+            continue;
+        }
+
+        if (item == QLatin1String("True") || item == QLatin1String("False")) {
+            values << QVariant(item == QLatin1String("True"));
+            continue;
+        }
+
+        if (item.size() >= 2 && (item.startsWith('"') || item.startsWith('\'')) && item.endsWith(item.at(0)))
+            item = item.mid(1, item.size() - 2);
+        values << QVariant(item);
+    }
+
+    if (values.isEmpty())
+        outError = QStringLiteral("no values given.");
+
+    return values;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Expands the axes into the list of setting combinations.
+ *
+ * Cartesian sweeps combine every value of every key; listed sweeps zip value lists of equal length.
+ *
+ * \param outError Human-readable error message in case of failure.
+ * \return One key/value map per combination; empty on error.
+ **********************************************************************************************************************/
+QList<QMap<QString, QVariant>> ParameterSweep::combinations(QString &outError) const
+{
+    QList<QMap<QString, QVariant>> result;
+
+    if (m_axes.isEmpty()) {
+        outError = QStringLiteral("Sweep definition has no parameters.");
+        return result;
+    }
+
+    if (m_mode == Mode::Listed) {
+        const int n = m_axes.first().values.size();
+        for (const Axis &axis : m_axes) {
+            if (axis.values.size() != n) {
+                outError = QStringLiteral("Listed sweep requires value lists of equal length.");
+                return result;
+            }
+        }
+        for (int i = 0; i < n; ++i) {
+            QMap<QString, QVariant> combo;
+            for (const Axis &axis : m_axes)
+                combo[axis.key] = axis.values.at(i);
+            result << combo;
+        }
+        return result;
+    }
+
+    qint64 total = 1;
+    for (const Axis &axis : m_axes) {
+        total *= axis.values.size();
+        if (total > kMaxVariants) {
+            outError = QString("Sweep has more than %1 variants.").arg(kMaxVariants);
+            return result;
+        }
+    }
+
+    result << QMap<QString, QVariant>();
+    for (const Axis &axis : m_axes) {
+        QList<QMap<QString, QVariant>> next;
+        for (const QMap<QString, QVariant> &partial : result) {
+            for (const QVariant &v : axis.values) {
+                QMap<QString, QVariant> combo = partial;
+                combo[axis.key] = v;
+                next << combo;
+            }
+        }
+        result = next;
+    }
+
+    return result;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes one model script per distinct settings combination next to the base model.
+ *
+ * Every swept key must be assigned in the base model (top-level or settings[...]); the values are written
+ * with PythonParser::writeSetting(). Combinations producing an identical script are skipped.
+ *
+ * \param baseScriptPath Python model to derive the variants from.
+ * \param outError       Human-readable error message in case of failure.
+ * \return True if at least one variant was written; false otherwise.
+ **********************************************************************************************************************/
+bool ParameterSweep::generate(const QString &baseScriptPath, QString &outError)
+{
+    m_variants.clear();
+    m_baseScriptPath = QFileInfo(baseScriptPath).absoluteFilePath();
+
+    QFile file(m_baseScriptPath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        outError = QString("Cannot open file %1").arg(m_baseScriptPath);
+        return false;
+    }
+    const QString text = QString::fromUtf8(file.readAll());
+    file.close();
+
+    const PythonParser::Result parsed = PythonParser::parseSettings(m_baseScriptPath);
+    if (!parsed.ok) {
+        outError = QString("Failed to parse Python model file:\n%1").arg(parsed.error);
+        return false;
+    }
+
+    for (const Axis &axis : m_axes) {
+        if (parsed.writeMode.value(axis.key, PythonParser::SettingWriteMode::Unknown) ==
+            PythonParser::SettingWriteMode::Unknown) {
+            outError = QString("Sweep key '%1' is not assigned in %2.")
+                           .arg(axis.key, QFileInfo(m_baseScriptPath).fileName());
+            return false;
+        }
+    }
+
+    const QList<QMap<QString, QVariant>> combos = combinations(outError);
+    if (combos.isEmpty())
+        return false;
+
+    const QFileInfo fi(m_baseScriptPath);
+    const QDir modelDir(fi.absolutePath());
+
+    QSet<QByteArray> seen;
+    for (const QMap<QString, QVariant> &combo : combos) {
+        QString script = text;
+        for (auto it = combo.constBegin(); it != combo.constEnd(); ++it) {
+            if (!PythonParser::writeSetting(script, it.key(), it.value(), parsed.writeMode.value(it.key()))) {
+                outError = QString("Cannot write value '%1' for sweep key '%2'.")
+                               .arg(it.value().toString(), it.key());
+                return false;
+            }
+        }
+
+        const QByteArray digest = QCryptographicHash::hash(script.toUtf8(), QCryptographicHash::Sha1);
+        if (seen.contains(digest))
+            continue;
+        seen.insert(digest);
+
+        Variant variant;
+        variant.name       = QString("%1_sweep_%2").arg(fi.completeBaseName()).arg(m_variants.size() + 1, 3, 10, QLatin1Char('0'));
+        variant.scriptPath = modelDir.filePath(variant.name + QStringLiteral(".py"));
+        variant.values     = combo;
+
+        QFile out(variant.scriptPath);
+        if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            outError = QString("Cannot write sweep model %1").arg(variant.scriptPath);
+            return false;
+        }
+        out.write(script.toUtf8());
+        out.close();
+
+        m_variants << variant;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the folder the sweep results are collected into ("<model dir>/<model>_sweep").
+ **********************************************************************************************************************/
+QString ParameterSweep::resultDir() const
+{
+    const QFileInfo fi(m_baseScriptPath);
+    return QDir(fi.absolutePath()).filePath(fi.completeBaseName() + QStringLiteral("_sweep"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Enqueues all generated variants as jobs of \a queue.
+ *
+ * Each job gets the base simulation settings overlaid with its swept values and its own model script.
+ * finished() is emitted with the summary path once every job has ended.
+ *
+ * \param queue       Queue that runs the variants in parallel.
+ * \param simKey      Backend key ("openems", "palace" or "elmer").
+ * \param simSettings Simulation settings of the base model.
+ * \param preferences Preferences used for all jobs.
+ * \param outError    Human-readable error message in case of failure.
+ * \return True if the jobs were enqueued; false otherwise.
+ **********************************************************************************************************************/
+bool ParameterSweep::dispatch(SimulationQueue *queue,
+                              const QString &simKey,
+                              const QMap<QString, QVariant> &simSettings,
+                              const QMap<QString, QVariant> &preferences,
+                              QString &outError)
+{
+    if (!queue || m_variants.isEmpty()) {
+        outError = QStringLiteral("No sweep variants to run.");
+        return false;
+    }
+
+    m_queue = queue;
+    connect(m_queue, &SimulationQueue::jobStateChanged, this, [this](int id, SimulationQueue::JobState) {
+        onJobStateChanged(id);
+    });
+
+    for (Variant &variant : m_variants) {
+        SimulationQueue::JobSpec spec;
+        spec.name        = variant.name;
+        spec.simKey      = simKey;
+        spec.simSettings = simSettings;
+        spec.preferences = preferences;
+
+        for (auto it = variant.values.constBegin(); it != variant.values.constEnd(); ++it)
+            spec.simSettings[it.key()] = it.value();
+        spec.simSettings["RunPythonScript"] = variant.scriptPath;
+        spec.simSettings["RunDir"]          = QFileInfo(variant.scriptPath).absolutePath();
+
+        variant.jobId = m_queue->enqueue(spec);
+        variant.state = SimulationQueue::stateName(SimulationQueue::JobState::Queued);
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true once every dispatched variant job has finished, failed or was cancelled.
+ **********************************************************************************************************************/
+bool ParameterSweep::isDone() const
+{
+    if (!m_queue || m_variants.isEmpty())
+        return false;
+
+    for (const Variant &variant : m_variants) {
+        if (!SimulationQueue::isFinalState(m_queue->jobInfo(variant.jobId).state))
+            return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records the state of a variant job and collects the results once the sweep is done.
+ **********************************************************************************************************************/
+void ParameterSweep::onJobStateChanged(int id)
+{
+    bool ours = false;
+    for (Variant &variant : m_variants) {
+        if (variant.jobId != id)
+            continue;
+
+        const SimulationQueue::JobInfo info = m_queue->jobInfo(id);
+        variant.state    = SimulationQueue::stateName(info.state);
+        variant.exitCode = info.exitCode;
+        ours = true;
+        break;
+    }
+
+    if (ours && isDone())
+        emit finished(collectResults());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Copies the Touchstone files of all variants into resultDir() and writes sweep_summary.csv.
+ *
+ * Results are looked up in the run directory reported by the job, or in the model folder for backends that
+ * write next to the model.
+ *
+ * \return Path of the summary table, or an empty string if it could not be written.
+ **********************************************************************************************************************/
+QString ParameterSweep::collectResults()
+{
+    const QString outDir = resultDir();
+    QDir().mkpath(outDir);
+
+    const QString modelDir = QFileInfo(m_baseScriptPath).absolutePath();
+
+    for (Variant &variant : m_variants) {
+        variant.touchstoneFiles.clear();
+
+        QString searchDir = m_queue ? m_queue->jobInfo(variant.jobId).runDir : QString();
+        if (searchDir.isEmpty() || QDir(searchDir) == QDir(modelDir) || !QDir(searchDir).exists())
+            searchDir = modelDir;
+
+        for (const QString &src : findTouchstoneFiles(searchDir, variant.name)) {
+            if (QFileInfo(src).absolutePath() == QFileInfo(outDir).absoluteFilePath())
+                continue;
+
+            const QString dest = QDir(outDir).filePath(variant.name + QLatin1Char('.') + QFileInfo(src).suffix());
+            QFile::remove(dest);
+            if (QFile::copy(src, dest))
+                variant.touchstoneFiles << dest;
+        }
+    }
+
+    const QString summaryPath = QDir(outDir).filePath(QStringLiteral("sweep_summary.csv"));
+    QFile summary(summaryPath);
+    if (!summary.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+        return QString();
+
+    QTextStream ts(&summary);
+    ts << "variant";
+    for (const Axis &axis : m_axes)
+        ts << ',' << axis.key;
+    ts << ",state,exit_code,touchstone\n";
+
+    for (const Variant &variant : m_variants) {
+        ts << variant.name;
+        for (const Axis &axis : m_axes)
+            ts << ',' << variant.values.value(axis.key).toString();
+        ts << ',' << variant.state << ',' << variant.exitCode << ','
+           << QFileInfo(variant.touchstoneFiles.value(0)).fileName() << '\n';
+    }
+
+    return summaryPath;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Finds Touchstone files (*.sNp) below \a dir whose path contains \a baseName.
+ *
+ * \param dir      Folder to search recursively.
+ * \param baseName Model base name that identifies the run; empty matches all files.
+ * \return Sorted absolute file paths.
+ **********************************************************************************************************************/
+QStringList ParameterSweep::findTouchstoneFiles(const QString &dir, const QString &baseName)
+{
+    static const QRegularExpression reSnp(QStringLiteral("\\.s\\d+p$"), QRegularExpression::CaseInsensitiveOption);
+
+    QStringList files;
+    QDirIterator it(dir, QStringList() << QStringLiteral("*.s*p") << QStringLiteral("*.S*P"),
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        if (!reSnp.match(it.fileName()).hasMatch())
+            continue;
+        if (!baseName.isEmpty() && !QDir(dir).relativeFilePath(path).contains(baseName))
+            continue;
+        files << path;
+    }
+
+    files.removeDuplicates();
+    files.sort();
+    return files;
+}
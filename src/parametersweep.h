@@ -0,0 +1,115 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QStringList>
+
+class SimulationQueue;
+
+/*!*******************************************************************************************************************
+ * \class ParameterSweep
+ * \brief Fans a Python model out into settings variants and runs them as parallel SimulationQueue jobs.
+ *
+ * A sweep definition assigns value lists to simulation setting keys, one key per line:
+ * \code
+ *   mode = cartesian                  # or "listed" (values are zipped)
+ *   cells_per_wavelength = 10, 20, 40
+ *   fstep = 1e9:1e9:5e9               # start:step:stop (inclusive)
+ * \endcode
+ *
+ * Every combination is written into a copy of the model next to the original ("<model>_sweep_001.py", ...)
+ * through PythonParser::writeSetting(), the same write-back path the GUI uses for its settings panel.
+ * Combinations that produce an identical script are generated only once. After all jobs are done the
+ * resulting Touchstone files are collected into "<model>_sweep/" together with a sweep_summary.csv
+ * table listing the swept values, job state and result file of every variant side by side.
+ **********************************************************************************************************************/
+class ParameterSweep : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Mode { Cartesian, Listed };
+
+    struct Axis
+    {
+        QString                 key;
+        QVariantList            values;
+    };
+
+    struct Variant
+    {
+        QString                 name;
+        QString                 scriptPath;
+        QMap<QString, QVariant> values;
+        int                     jobId = 0;
+        QString                 state;
+        int                     exitCode = 0;
+        QStringList             touchstoneFiles;
+    };
+
+    explicit ParameterSweep(QObject *parent = nullptr);
+
+    bool                        parseDefinition(const QString &text, QString &outError);
+    void                        setMode(Mode mode) { m_mode = mode; }
+    Mode                        mode() const { return m_mode; }
+    void                        addAxis(const QString &key, const QVariantList &values);
+    const QList<Axis>          &axes() const { return m_axes; }
+
+    QList<QMap<QString, QVariant>> combinations(QString &outError) const;
+    bool                        generate(const QString &baseScriptPath, QString &outError);
+    const QList<Variant>       &variants() const { return m_variants; }
+    QString                     resultDir() const;
+
+    bool                        dispatch(SimulationQueue *queue,
+                                         const QString &simKey,
+                                         const QMap<QString, QVariant> &simSettings,
+                                         const QMap<QString, QVariant> &preferences,
+                                         QString &outError);
+    bool                        isDone() const;
+    QString                     collectResults();
+
+    static QVariantList         parseValues(const QString &text, QString &outError);
+    static QStringList          findTouchstoneFiles(const QString &dir, const QString &baseName);
+
+    static constexpr int        kMaxVariants = 1000;
+
+signals:
+    void                        finished(const QString &summaryPath);
+
+private:
+    void                        onJobStateChanged(int id);
+
+private:
+    Mode                        m_mode = Mode::Cartesian;
+    QList<Axis>                 m_axes;
+
+    QString                     m_baseScriptPath;
+    QList<Variant>              m_variants;
+    SimulationQueue            *m_queue = nullptr;
+};
+
+#endif // PARAMETERSWEEP_H
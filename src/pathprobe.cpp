@@ -0,0 +1,328 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFileInfo>
+
+#include "pathprobe.h"
+#include "shellsession.h"
+#include "wslHelper.h"
+
+namespace {
+
+/*!*******************************************************************************************************************
+ * \brief Returns true for paths that live in the Linux file system ("/..." or "~...").
+ **********************************************************************************************************************/
+bool isLinuxStylePath(const QString &path)
+{
+    return path.startsWith('/') || path.startsWith('~');
+}
+
+/*!*******************************************************************************************************************
+ * \brief Quotes a path for the shell; "~" is expanded via $HOME and host paths are translated with wslpath.
+ **********************************************************************************************************************/
+QString shellPathArgument(const QString &path)
+{
+    if (path == QLatin1String("~"))
+        return QStringLiteral("\"$HOME\"");
+    if (path.startsWith(QLatin1String("~/")))
+        return QStringLiteral("\"$HOME\"") + shellQuoteSingle(path.mid(1));
+    if (path.startsWith('/'))
+        return shellQuoteSingle(path);
+
+    return QStringLiteral("\"$(wslpath -a %1)\"").arg(shellQuoteSingle(QDir::toNativeSeparators(path)));
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Creates a probe.
+ *
+ * \param session Shell used for Linux paths instead of the shared WSL session (tests); not owned.
+ **********************************************************************************************************************/
+PathProbe::PathProbe(ShellSession *session)
+    : m_session(session)
+{
+    m_clock.start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the probe used by the wslHelper path functions.
+ **********************************************************************************************************************/
+PathProbe &PathProbe::shared()
+{
+    static PathProbe probe;
+    return probe;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Answers a list of path queries; all WSL queries not in the cache are sent in one batch.
+ *
+ * \param requests  Queries in any mix; paths are trimmed.
+ * \param distro    WSL distribution (Windows only; empty for the default distribution).
+ * \param timeoutMs Maximum time to wait for the batch.
+ * \return One result per request, in order. Queries that got no answer (timeout) fail and are not cached.
+ **********************************************************************************************************************/
+QList<PathProbe::Result> PathProbe::resolve(const QList<Request> &requests, const QString &distro, int timeoutMs)
+{
+    QList<Result> results;
+    QList<int> pending;
+    QStringList commands;
+
+    const qint64 now = m_clock.elapsed();
+
+    for (int i = 0; i < requests.size(); ++i) {
+        Request request = requests.at(i);
+        request.path = request.path.trimmed();
+
+        Result result;
+        if (resolveLocally(request, result)) {
+            results << result;
+            continue;
+        }
+
+        const auto it = m_cache.constFind(cacheKey(request, distro));
+        if (it != m_cache.constEnd() && it->expiresMs > now) {
+            ++m_cacheHits;
+            results << it->result;
+            continue;
+        }
+
+        results << Result();
+        pending << i;
+        commands << command(request);
+    }
+
+    if (commands.isEmpty())
+        return results;
+
+    ++m_roundTrips;
+    const QList<ShellSession::Reply> replies = session(distro)->runBatch(commands, timeoutMs);
+
+    for (int j = 0; j < pending.size(); ++j) {
+        const ShellSession::Reply &reply = replies.at(j);
+
+        QString text;
+        if (reply.ok) {
+            text = reply.exitCode == 0 ? reply.text() : QString();
+        } else if (!reply.timedOut && !m_session) {
+            // The WSL session could not be started: one process per query as before.
+            text = runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << commands.at(j), timeoutMs);
+        } else {
+            continue;
+        }
+
+        Request request = requests.at(pending.at(j));
+        request.path = request.path.trimmed();
+
+        Result result;
+        if (request.query == Query::LinuxPath) {
+            result.linuxPath = text;
+            result.ok = !text.isEmpty();
+        } else {
+            result.ok = text == QLatin1String("1");
+        }
+        results[pending.at(j)] = result;
+
+        Entry entry;
+        entry.result = result;
+        entry.expiresMs = m_clock.elapsed() + (result.ok ? m_ttlMs : m_negativeTtlMs);
+        m_cache.insert(cacheKey(request, distro), entry);
+    }
+
+    return results;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks whether \a path exists (host path, or Linux path inside WSL on Windows).
+ **********************************************************************************************************************/
+bool PathProbe::exists(const QString &path, const QString &distro, int timeoutMs)
+{
+    return resolve({{Query::Exists, path}}, distro, timeoutMs).first().ok;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks readability on the host first, then inside WSL (host paths are translated with wslpath).
+ **********************************************************************************************************************/
+bool PathProbe::isReadable(const QString &path, const QString &distro, int timeoutMs)
+{
+    return resolve({{Query::Readable, path}}, distro, timeoutMs).first().ok;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks whether \a path is executable (host path, or Linux path inside WSL on Windows).
+ **********************************************************************************************************************/
+bool PathProbe::isExecutable(const QString &path, const QString &distro, int timeoutMs)
+{
+    return resolve({{Query::Executable, path}}, distro, timeoutMs).first().ok;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the Linux form of \a path ("~" expanded inside WSL), or an empty string on failure.
+ *
+ * Without WSL the path is returned unchanged.
+ **********************************************************************************************************************/
+QString PathProbe::toLinuxPath(const QString &path, const QString &distro, int timeoutMs)
+{
+    if (!hasRemote())
+        return path;
+
+    return resolve({{Query::LinuxPath, path}}, distro, timeoutMs).first().linuxPath;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Identifies a program inside WSL by its resolved path, size and modification time.
+ *
+ * Bare names are looked up with \c bash \c -lc, the login shell the solver and Python run in, so PATH entries set
+ * in the profile (a spack environment, a venv) resolve to the binary the run uses. The answer is not cached.
+ *
+ * \param program   Linux path, host path (translated with wslpath) or program name.
+ * \param distro    WSL distribution (empty for the default distribution).
+ * \param timeoutMs Maximum time to wait for the shell.
+ * \return "<path>|<size>|<mtime>", or an empty string if there is no WSL or the program cannot be found.
+ **********************************************************************************************************************/
+QString PathProbe::toolStamp(const QString &program, const QString &distro, int timeoutMs)
+{
+    const QString p = program.trimmed();
+    if (p.isEmpty() || !hasRemote())
+        return QString();
+
+    const bool isPath = p.contains('/') || p.contains('\\') || p.startsWith('~');
+    // The last line only: profiles may print to stdout.
+    const QString lookup = shellQuoteSingle(QStringLiteral("command -v ") + shellQuoteSingle(p));
+    const QString arg = isPath ? shellPathArgument(p)
+                               : QStringLiteral("\"$(bash -lc %1 2>/dev/null | tail -n 1)\"").arg(lookup);
+
+    ++m_roundTrips;
+    const ShellSession::Reply reply = session(distro)->run(QString("stat -L -c '%n|%s|%Y' %1").arg(arg), timeoutMs);
+    return reply.ok && reply.exitCode == 0 ? reply.text() : QString();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets how long positive and negative answers are reused, in milliseconds (0 disables caching).
+ **********************************************************************************************************************/
+void PathProbe::setTtl(int ttlMs, int negativeTtlMs)
+{
+    m_ttlMs = qMax(0, ttlMs);
+    m_negativeTtlMs = qMax(0, negativeTtlMs);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Drops all cached answers.
+ **********************************************************************************************************************/
+void PathProbe::invalidate()
+{
+    m_cache.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if Linux paths are probed through a shell (WSL on Windows, or a test session).
+ *
+ * Windows without WSL has no Linux file system: every path is then checked on the host, as before PathProbe.
+ **********************************************************************************************************************/
+bool PathProbe::hasRemote() const
+{
+#ifdef Q_OS_WIN
+    return m_session != nullptr || isWslAvailable();
+#else
+    return m_session != nullptr;
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the shell used for \a distro.
+ **********************************************************************************************************************/
+ShellSession *PathProbe::session(const QString &distro) const
+{
+    return m_session ? m_session : &ShellSession::shared(distro);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Answers requests that need no shell: host paths, readable host files and paths already in Linux form.
+ *
+ * \return True if \a result holds the answer.
+ **********************************************************************************************************************/
+bool PathProbe::resolveLocally(const Request &request, Result &result) const
+{
+    const QString &p = request.path;
+
+    if (p.isEmpty())
+        return true;
+
+    if (!hasRemote()) {
+        switch (request.query) {
+        case Query::Exists:     result.ok = QFileInfo::exists(p); break;
+        case Query::Readable:   result.ok = QFileInfo(p).isReadable(); break;
+        case Query::Executable: result.ok = QFileInfo(p).isExecutable(); break;
+        case Query::LinuxPath:  result.ok = true; result.linuxPath = p; break;
+        }
+        return true;
+    }
+
+    switch (request.query) {
+    case Query::Exists:
+        if (isLinuxStylePath(p))
+            return false;
+        result.ok = QFileInfo::exists(p);
+        return true;
+    case Query::Executable:
+        if (isLinuxStylePath(p))
+            return false;
+        result.ok = QFileInfo(p).isExecutable();
+        return true;
+    case Query::Readable:
+        if (!QFileInfo(p).isReadable())
+            return false;
+        result.ok = true;
+        return true;
+    case Query::LinuxPath:
+        if (!p.startsWith('/'))
+            return false;
+        result.ok = true;
+        result.linuxPath = p;
+        return true;
+    }
+    return false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the shell command answering \a request: "1" for a passed check, or the translated path.
+ **********************************************************************************************************************/
+QString PathProbe::command(const Request &request)
+{
+    const QString arg = shellPathArgument(request.path);
+
+    switch (request.query) {
+    case Query::Exists:     return QString("test -e %1 && echo 1").arg(arg);
+    case Query::Readable:   return QString("test -r %1 && echo 1").arg(arg);
+    case Query::Executable: return QString("test -x %1 && echo 1").arg(arg);
+    case Query::LinuxPath:  return QString("printf '%s' %1").arg(arg);
+    }
+    return QString();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the cache key of \a request in \a distro.
+ **********************************************************************************************************************/
+QString PathProbe::cacheKey(const Request &request, const QString &distro)
+{
+    return QString::number(int(request.query)) + QLatin1Char('\x1f') + distro.trimmed() + QLatin1Char('\x1f') +
+           request.path;
+}
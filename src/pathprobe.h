@@ -0,0 +1,108 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef PATHPROBE_H
+#define PATHPROBE_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QElapsedTimer>
+
+class ShellSession;
+
+/*!*******************************************************************************************************************
+ * \class PathProbe
+ * \brief Batched, memoized existence/readability/executability checks and Linux path translation.
+ *
+ * Host paths are checked directly with QFileInfo. Linux paths ("/..." or "~...") on Windows are checked inside WSL
+ * through the persistent ShellSession of the distribution; resolve() sends all such requests of a call in a
+ * single batch and caches the answers. Positive answers are kept for ttlMs(), negative ones for the shorter
+ * negativeTtlMs(), since missing files tend to appear (a run directory, a freshly installed solver). invalidate()
+ * drops the cache; MainWindow calls it whenever the preferences change.
+ *
+ * Elsewhere, and on Windows without WSL, Linux paths are host paths and translation returns the path unchanged.
+ * For tests a session can be passed to the constructor; Linux paths are then probed through it as on Windows.
+ *
+ * toolStamp() identifies a program inside WSL by path, size and modification time; it is never cached, so
+ * an upgraded solver is noticed by the next run.
+ *
+ * shared() is the instance used by the wslHelper functions (GUI thread only).
+ **********************************************************************************************************************/
+class PathProbe
+{
+public:
+    enum class Query { Exists, Readable, Executable, LinuxPath };
+
+    struct Request
+    {
+        Query                   query = Query::Exists;
+        QString                 path;
+    };
+
+    struct Result
+    {
+        bool                    ok = false;         // check passed / translation succeeded
+        QString                 linuxPath;          // LinuxPath only
+    };
+
+    explicit PathProbe(ShellSession *session = nullptr);
+
+    static PathProbe           &shared();
+
+    QList<Result>               resolve(const QList<Request> &requests, const QString &distro, int timeoutMs);
+
+    bool                        exists(const QString &path, const QString &distro, int timeoutMs);
+    bool                        isReadable(const QString &path, const QString &distro, int timeoutMs);
+    bool                        isExecutable(const QString &path, const QString &distro, int timeoutMs);
+    QString                     toLinuxPath(const QString &path, const QString &distro, int timeoutMs);
+    QString                     toolStamp(const QString &program, const QString &distro, int timeoutMs);
+
+    void                        setTtl(int ttlMs, int negativeTtlMs);
+    int                         ttlMs() const { return m_ttlMs; }
+    int                         negativeTtlMs() const { return m_negativeTtlMs; }
+    void                        invalidate();
+
+    int                         roundTrips() const { return m_roundTrips; }
+    int                         cacheHits() const { return m_cacheHits; }
+
+private:
+    struct Entry
+    {
+        Result                  result;
+        qint64                  expiresMs = 0;
+    };
+
+    bool                        hasRemote() const;
+    ShellSession               *session(const QString &distro) const;
+    bool                        resolveLocally(const Request &request, Result &result) const;
+    static QString              command(const Request &request);
+    static QString              cacheKey(const Request &request, const QString &distro);
+
+    ShellSession               *m_session = nullptr;
+    QHash<QString, Entry>       m_cache;
+    QElapsedTimer               m_clock;
+    int                         m_ttlMs = 10000;
+    int                         m_negativeTtlMs = 2000;
+    int                         m_roundTrips = 0;
+    int                         m_cacheHits = 0;
+};
+
+#endif // PATHPROBE_H
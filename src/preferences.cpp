@@ -74,9 +74,11 @@ void Preferences::on_btnCancel_clicked()
  *
  * Creates a QtTreePropertyBrowser with a custom VariantManager/VariantFactory and populates it with
  * grouped settings:
- *  - EMStudio: paths to model templates shipped with (or used by) the application.
+ *  - EMStudio: paths to model templates shipped with (or used by) the application, the run cache switch
+ *    and the number of CPU cores kept free.
  *  - OpenEMS: Python executable and OpenEMS install root.
- *  - Palace: WSL Python, run mode (executable vs. script) and corresponding path.
+ *  - Palace: WSL Python, run mode (executable vs. script) and corresponding path, MPI binding, ranks
+ *    per NUMA node and the band/tolerance for stopping the solver early.
  *  - Elmer: path to ElmerSolver executable.
  *  - KLayout: executable path and optional launch options.
  *
@@ -144,6 +146,84 @@ void Preferences::setupPreferencesPanel()
     tmplDirProp->setValue(QDir::toNativeSeparators(tmplDir));
     emstudioGroup->addSubProperty(tmplDirProp);
 
+    QtVariantProperty *runCacheProp =
+        m_variantManager->addProperty(QVariant::Bool, QLatin1String("RUN_CACHE"));
+    runCacheProp->setToolTip(tr("Reuse earlier simulation runs with identical inputs.\n\n"
+                                "A run is skipped if a previous run of the same model, GDS, substrate and "
+                                "solver left complete results. If only the solver changed, the gds2palace "
+                                "mesh is reused and only the solver runs again."));
+    runCacheProp->setValue(m_preferences.value(QStringLiteral("RUN_CACHE"), true).toBool());
+    emstudioGroup->addSubProperty(runCacheProp);
+
+    QtVariantProperty *reservedCoresProp =
+        m_variantManager->addProperty(QVariant::Int, QLatin1String("RESERVED_CORES"));
+    reservedCoresProp->setToolTip(tr("Number of physical CPU cores kept free for EMStudio and other desktop work.\n"
+                                     "Simulations and the run queue use the remaining cores."));
+    reservedCoresProp->setAttribute(QStringLiteral("minimum"), 0);
+    reservedCoresProp->setValue(m_preferences.value(QStringLiteral("RESERVED_CORES"), 0).toInt());
+    emstudioGroup->addSubProperty(reservedCoresProp);
+
+    QtVariantProperty *pipelineProp =
+        m_variantManager->addProperty(QVariant::Bool, QLatin1String("PIPELINE_PREPROCESSING"));
+    pipelineProp->setToolTip(tr("Run the gds2palace preprocessing of the next queued Palace/Elmer model "
+                                "while the solver of the current model runs.\n"
+                                "Solvers still run one after the other."));
+    pipelineProp->setValue(m_preferences.value(QStringLiteral("PIPELINE_PREPROCESSING"), false).toBool());
+    emstudioGroup->addSubProperty(pipelineProp);
+
+    QtVariantProperty *preprocessCoresProp =
+        m_variantManager->addProperty(QVariant::Int, QLatin1String("PREPROCESS_CORES"));
+    preprocessCoresProp->setToolTip(tr("Cores of the run queue budget reserved for pipelined preprocessing.\n"
+                                       "Also the number of models preprocessed ahead of the running solver."));
+    preprocessCoresProp->setAttribute(QStringLiteral("minimum"), 1);
+    preprocessCoresProp->setValue(m_preferences.value(QStringLiteral("PREPROCESS_CORES"), 1).toInt());
+    emstudioGroup->addSubProperty(preprocessCoresProp);
+
+    QtVariantProperty *telemetryIntervalProp =
+        m_variantManager->addProperty(QVariant::Int, QLatin1String("TELEMETRY_INTERVAL_MS"));
+    telemetryIntervalProp->setToolTip(tr("Sampling interval in milliseconds for CPU, memory, I/O and thread usage "
+                                         "of the simulation processes (Linux).\n"
+                                         "0 disables the process telemetry."));
+    telemetryIntervalProp->setAttribute(QStringLiteral("minimum"), 0);
+    telemetryIntervalProp->setValue(m_preferences.value(QStringLiteral("TELEMETRY_INTERVAL_MS"), 1000).toInt());
+    emstudioGroup->addSubProperty(telemetryIntervalProp);
+
+    QtVariantProperty *telemetryFormatProp =
+        m_variantManager->addProperty(QtVariantPropertyManager::enumTypeId(), QLatin1String("TELEMETRY_FORMAT"));
+    telemetryFormatProp->setToolTip(tr("File format of the telemetry written next to the run directory "
+                                       "(<run dir>_telemetry.csv or .json)."));
+    {
+        QStringList formats;
+        formats << tr("CSV") << tr("JSON");
+        telemetryFormatProp->setAttribute(QStringLiteral("enumNames"), formats);
+        telemetryFormatProp->setValue(m_preferences.value(QStringLiteral("TELEMETRY_FORMAT"), 0));
+    }
+    emstudioGroup->addSubProperty(telemetryFormatProp);
+
+    QtVariantProperty *runReportProp =
+        m_variantManager->addProperty(QVariant::Bool, QLatin1String("RUN_REPORT"));
+    runReportProp->setToolTip(tr("Write run_report.json with stage timings, exit codes, cores and input "
+                                 "fingerprints into the run directory.\n"
+                                 "Collect reports with EMStudio -aggregate-reports <dir>."));
+    runReportProp->setValue(m_preferences.value(QStringLiteral("RUN_REPORT"), true).toBool());
+    emstudioGroup->addSubProperty(runReportProp);
+
+    QtVariantProperty *resultStoreProp =
+        m_variantManager->addProperty(QVariant::Bool, QLatin1String("RESULT_STORE"));
+    resultStoreProp->setToolTip(tr("Store the S-parameters, fingerprint and stage timings of every successful run "
+                                   "in the local result store.\n"
+                                   "List and compare stored runs with EMStudio -results <cell>."));
+    resultStoreProp->setValue(m_preferences.value(QStringLiteral("RESULT_STORE"), true).toBool());
+    emstudioGroup->addSubProperty(resultStoreProp);
+
+    QtVariantProperty *sparamChecksProp =
+        m_variantManager->addProperty(QVariant::Bool, QLatin1String("SPARAM_CHECKS"));
+    sparamChecksProp->setToolTip(tr("Check the S-parameters of every successful run for passivity (largest singular "
+                                    "value), reciprocity and causality and log a pass/fail summary.\n"
+                                    "Check any Touchstone file with EMStudio -check <file.sNp>."));
+    sparamChecksProp->setValue(m_preferences.value(QStringLiteral("SPARAM_CHECKS"), true).toBool());
+    emstudioGroup->addSubProperty(sparamChecksProp);
+
     m_propertyBrowser->addProperty(emstudioGroup);
 
     // -------------------------------------------------------------------------------------------------------------
@@ -256,6 +336,47 @@ void Preferences::setupPreferencesPanel()
     m_palaceRunScriptProp->setValue(m_preferences.value(QStringLiteral("PALACE_RUN_SCRIPT"), QString()));
     palaceGroup->addSubProperty(m_palaceRunScriptProp);
 
+    QtVariantProperty *mpiBindingProp =
+        m_variantManager->addProperty(QtVariantPropertyManager::enumTypeId(), QLatin1String("PALACE_MPI_BINDING"));
+    mpiBindingProp->setToolTip(tr("How MPI ranks of the Palace solver are placed on the CPU:\n"
+                                  "  - Auto: bind ranks to physical cores and spread them over NUMA nodes when\n"
+                                  "    the run has the machine to itself, otherwise leave them unbound\n"
+                                  "  - No binding: let the OS scheduler place the ranks (--oversubscribe)\n"
+                                  "  - Bind to cores: always use --bind-to core --map-by numa\n\n"
+                                  "The chosen binding is written to the simulation log."));
+    {
+        QStringList bindings;
+        bindings << tr("Auto") << tr("No binding") << tr("Bind to cores");
+        mpiBindingProp->setAttribute(QStringLiteral("enumNames"), bindings);
+        mpiBindingProp->setValue(m_preferences.value(QStringLiteral("PALACE_MPI_BINDING"), 0));
+    }
+    palaceGroup->addSubProperty(mpiBindingProp);
+
+    QtVariantProperty *ranksPerNumaProp =
+        m_variantManager->addProperty(QVariant::Int, QLatin1String("PALACE_RANKS_PER_NUMA"));
+    ranksPerNumaProp->setToolTip(tr("Maximum number of MPI ranks per NUMA node.\n"
+                                    "0 uses all physical cores of every node."));
+    ranksPerNumaProp->setAttribute(QStringLiteral("minimum"), 0);
+    ranksPerNumaProp->setValue(m_preferences.value(QStringLiteral("PALACE_RANKS_PER_NUMA"), 0).toInt());
+    palaceGroup->addSubProperty(ranksPerNumaProp);
+
+    QtVariantProperty *stopBandProp =
+        m_variantManager->addProperty(QVariant::String, QLatin1String("SPARAM_STOP_BAND_GHZ"));
+    stopBandProp->setToolTip(tr("Band of interest in GHz, e.g. \"2-8\". Empty disables early stopping.\n\n"
+                                "While Palace runs, EMStudio reads the rows appended to port-S.csv and stops the\n"
+                                "solver once the S-parameters in this band no longer change."));
+    stopBandProp->setValue(m_preferences.value(QStringLiteral("SPARAM_STOP_BAND_GHZ"), QString()).toString());
+    palaceGroup->addSubProperty(stopBandProp);
+
+    QtVariantProperty *stopToleranceProp =
+        m_variantManager->addProperty(QVariant::Double, QLatin1String("SPARAM_STOP_TOLERANCE"));
+    stopToleranceProp->setToolTip(tr("Largest change of any S-parameter in the band of interest between two\n"
+                                     "updates of port-S.csv that still counts as converged."));
+    stopToleranceProp->setAttribute(QStringLiteral("decimals"), 6);
+    stopToleranceProp->setAttribute(QStringLiteral("minimum"), 0.0);
+    stopToleranceProp->setValue(m_preferences.value(QStringLiteral("SPARAM_STOP_TOLERANCE"), 1e-3).toDouble());
+    palaceGroup->addSubProperty(stopToleranceProp);
+
     // -------------------------------------------------------------------------------------------------------------
     // Elmer
     // -------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,502 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+#ifdef Q_OS_LINUX
+#include <unistd.h>
+#endif
+
+#include "processtelemetry.h"
+
+namespace {
+
+/*!*******************************************************************************************************************
+ * \brief Reads a small /proc file completely; returns an empty array if it cannot be opened.
+ **********************************************************************************************************************/
+QByteArray readProcFile(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the value of a "Key: value" line of /proc/<pid>/status or io, or -1 if the key is missing.
+ **********************************************************************************************************************/
+qint64 keyValue(const QByteArray &data, const QByteArray &key)
+{
+    int pos = 0;
+    while (pos < data.size()) {
+        int end = data.indexOf('\n', pos);
+        if (end < 0)
+            end = data.size();
+
+        const QByteArray line = data.mid(pos, end - pos);
+        if (line.startsWith(key) && line.size() > key.size() && line.at(key.size()) == ':') {
+            const QList<QByteArray> parts = line.mid(key.size() + 1).simplified().split(' ');
+            bool ok = false;
+            const qint64 value = parts.value(0).toLongLong(&ok);
+            return ok ? value : -1;
+        }
+        pos = end + 1;
+    }
+    return -1;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Returns a one-line description of the stage figures for the simulation log.
+ **********************************************************************************************************************/
+QString ProcessTelemetry::StageSummary::toString() const
+{
+    auto mib = [](qint64 bytes) { return QString::number(double(bytes) / (1024.0 * 1024.0), 'f', 1); };
+
+    return QString("%1: %2 s, CPU avg %3 % / max %4 %, peak RSS %5 MiB, read %6 MiB, written %7 MiB, "
+                   "%8 threads")
+        .arg(stage)
+        .arg(QString::number(double(durationMs) / 1000.0, 'f', 1))
+        .arg(QString::number(avgCpuPercent, 'f', 0))
+        .arg(QString::number(maxCpuPercent, 'f', 0))
+        .arg(mib(peakRssBytes), mib(readBytes), mib(writeBytes))
+        .arg(maxThreads);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates an idle sampler with the default interval of one second.
+ *
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+ProcessTelemetry::ProcessTelemetry(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    qRegisterMetaType<ProcessTelemetry::Sample>();
+
+#ifdef Q_OS_LINUX
+    const long ticks = sysconf(_SC_CLK_TCK);
+    if (ticks > 0)
+        m_ticksPerSecond = ticks;
+#endif
+
+    m_timer->setInterval(m_intervalMs);
+    connect(m_timer, &QTimer::timeout, this, &ProcessTelemetry::sampleNow);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the sampling interval; 0 disables sampling.
+ **********************************************************************************************************************/
+void ProcessTelemetry::setInterval(int msecs)
+{
+    m_intervalMs = qMax(0, msecs);
+    if (m_intervalMs > 0)
+        m_timer->setInterval(qMax(50, m_intervalMs));
+    else
+        m_timer->stop();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Detaches and drops all recorded samples; the elapsed time of new samples starts at zero.
+ **********************************************************************************************************************/
+void ProcessTelemetry::reset()
+{
+    detach();
+
+    m_samples.clear();
+    m_lastTicks.clear();
+    m_readByPid.clear();
+    m_writeByPid.clear();
+    m_peakRssBytes = 0;
+    m_lastSampleMs = 0;
+    m_clock.start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts sampling the process tree below the given process.
+ *
+ * Attaching to the next stage process continues the recorded series. The CPU time the tree has used so far
+ * is taken as baseline, so the first sample only reflects the time since attaching.
+ *
+ * \param pid   Root process id (the QProcess of the current stage).
+ * \param stage Stage name recorded with the samples, e.g. "preprocess" or "solver".
+ **********************************************************************************************************************/
+void ProcessTelemetry::attach(qint64 pid, const QString &stage)
+{
+    if (!isSupported() && m_procRoot == QLatin1String("/proc"))
+        return;
+    if (pid <= 0 || m_intervalMs <= 0)
+        return;
+
+    if (!m_clock.isValid())
+        m_clock.start();
+
+    m_rootPid = pid;
+    m_stage = stage;
+    m_lastTicks = ticksByPid(readProcessTree(m_procRoot, pid));
+    m_lastSampleMs = m_clock.elapsed();
+
+    m_timer->start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Stops sampling; the recorded samples are kept.
+ **********************************************************************************************************************/
+void ProcessTelemetry::detach()
+{
+    m_timer->stop();
+    m_rootPid = 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records one sample of the attached process tree and emits \c sampled().
+ *
+ * Nothing is recorded once the tree has exited. Read and written bytes are accumulated per process, so
+ * the figures of processes that exited between two samples are kept.
+ **********************************************************************************************************************/
+void ProcessTelemetry::sampleNow()
+{
+    if (m_rootPid <= 0)
+        return;
+
+    const QList<ProcessStat> tree = readProcessTree(m_procRoot, m_rootPid);
+    if (tree.isEmpty())
+        return;
+
+    const qint64 now = m_clock.elapsed();
+    const double seconds = double(qMax<qint64>(1, now - m_lastSampleMs)) / 1000.0;
+
+    Sample sample;
+    sample.elapsedMs = now;
+    sample.stage     = m_stage;
+    sample.processes = tree.size();
+
+    qint64 deltaTicks = 0;
+    for (const ProcessStat &p : tree) {
+        deltaTicks += qMax<qint64>(0, p.cpuTicks - m_lastTicks.value(p.pid, 0));
+        sample.threads  += p.threads;
+        sample.rssBytes += p.rssBytes;
+
+        m_readByPid[p.pid]  = qMax(m_readByPid.value(p.pid), p.readBytes);
+        m_writeByPid[p.pid] = qMax(m_writeByPid.value(p.pid), p.writeBytes);
+    }
+
+    sample.cpuPercent = 100.0 * double(deltaTicks) / (double(m_ticksPerSecond) * seconds);
+
+    for (qint64 bytes : qAsConst(m_readByPid))
+        sample.readBytes += bytes;
+    for (qint64 bytes : qAsConst(m_writeByPid))
+        sample.writeBytes += bytes;
+
+    m_peakRssBytes = qMax(m_peakRssBytes, sample.rssBytes);
+    sample.peakRssBytes = m_peakRssBytes;
+
+    m_lastTicks = ticksByPid(tree);
+    m_lastSampleMs = now;
+
+    m_samples.append(sample);
+    emit sampled(sample);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Groups the recorded samples by stage, in the order the stages were first seen.
+ *
+ * Read and written bytes of a stage are the increase of the cumulative run totals during that stage.
+ **********************************************************************************************************************/
+QList<ProcessTelemetry::StageSummary> ProcessTelemetry::stageSummaries() const
+{
+    QList<StageSummary> out;
+    QMap<QString, int> index;
+    QMap<QString, qint64> firstMs;
+    QMap<QString, int> counts;
+
+    qint64 prevRead = 0;
+    qint64 prevWrite = 0;
+    for (const Sample &s : m_samples) {
+        if (!index.contains(s.stage)) {
+            index.insert(s.stage, out.size());
+            StageSummary summary;
+            summary.stage = s.stage;
+            out.append(summary);
+            firstMs.insert(s.stage, s.elapsedMs);
+        }
+
+        StageSummary &summary = out[index.value(s.stage)];
+        const int n = ++counts[s.stage];
+        summary.durationMs    = s.elapsedMs - firstMs.value(s.stage) + m_intervalMs;
+        summary.avgCpuPercent += (s.cpuPercent - summary.avgCpuPercent) / n;
+        summary.maxCpuPercent = qMax(summary.maxCpuPercent, s.cpuPercent);
+        summary.peakRssBytes  = qMax(summary.peakRssBytes, s.rssBytes);
+        summary.readBytes    += s.readBytes - prevRead;
+        summary.writeBytes   += s.writeBytes - prevWrite;
+        summary.maxThreads    = qMax(summary.maxThreads, s.threads);
+
+        prevRead  = s.readBytes;
+        prevWrite = s.writeBytes;
+    }
+
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the recorded samples to a file.
+ *
+ * \param path     Output file.
+ * \param format   CSV (one row per sample) or JSON (samples and per-stage summary).
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ProcessTelemetry::write(const QString &path, Format format, QString &outError) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write telemetry file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    file.write(format == Format::Json ? toJson() : toCsv());
+    if (!file.commit()) {
+        outError = QString("Cannot write telemetry file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the samples as CSV with a header row.
+ **********************************************************************************************************************/
+QByteArray ProcessTelemetry::toCsv() const
+{
+    QByteArray out = "elapsed_ms,stage,processes,threads,cpu_percent,rss_bytes,peak_rss_bytes,read_bytes,write_bytes\n";
+    for (const Sample &s : m_samples) {
+        out += QString("%1,%2,%3,%4,%5,%6,%7,%8,%9\n")
+                   .arg(s.elapsedMs)
+                   .arg(s.stage)
+                   .arg(s.processes)
+                   .arg(s.threads)
+                   .arg(QString::number(s.cpuPercent, 'f', 1))
+                   .arg(s.rssBytes)
+                   .arg(s.peakRssBytes)
+                   .arg(s.readBytes)
+                   .arg(s.writeBytes)
+                   .toUtf8();
+    }
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the samples and the per-stage summary as an indented JSON document.
+ **********************************************************************************************************************/
+QByteArray ProcessTelemetry::toJson() const
+{
+    QJsonArray samples;
+    for (const Sample &s : m_samples) {
+        QJsonObject o;
+        o["elapsed_ms"]     = double(s.elapsedMs);
+        o["stage"]          = s.stage;
+        o["processes"]      = s.processes;
+        o["threads"]        = s.threads;
+        o["cpu_percent"]    = s.cpuPercent;
+        o["rss_bytes"]      = double(s.rssBytes);
+        o["peak_rss_bytes"] = double(s.peakRssBytes);
+        o["read_bytes"]     = double(s.readBytes);
+        o["write_bytes"]    = double(s.writeBytes);
+        samples.append(o);
+    }
+
+    QJsonArray stages;
+    for (const StageSummary &s : stageSummaries()) {
+        QJsonObject o;
+        o["stage"]           = s.stage;
+        o["duration_ms"]     = double(s.durationMs);
+        o["avg_cpu_percent"] = s.avgCpuPercent;
+        o["max_cpu_percent"] = s.maxCpuPercent;
+        o["peak_rss_bytes"]  = double(s.peakRssBytes);
+        o["read_bytes"]      = double(s.readBytes);
+        o["write_bytes"]     = double(s.writeBytes);
+        o["max_threads"]     = s.maxThreads;
+        stages.append(o);
+    }
+
+    QJsonObject root;
+    root["version"]     = 1;
+    root["interval_ms"] = m_intervalMs;
+    root["stages"]      = stages;
+    root["samples"]     = samples;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if process telemetry can be sampled on this platform (Linux /proc).
+ **********************************************************************************************************************/
+bool ProcessTelemetry::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return QFileInfo(QStringLiteral("/proc/self/stat")).exists();
+#else
+    return false;
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the telemetry file placed next to a run directory: "<parent>/<run dir name>_telemetry.csv|json".
+ *
+ * The file is kept outside the run directory so it is never mistaken for a solver configuration.
+ **********************************************************************************************************************/
+QString ProcessTelemetry::filePathFor(const QString &runDir, Format format)
+{
+    const QFileInfo fi(QDir::cleanPath(runDir));
+    const QString suffix = format == Format::Json ? QStringLiteral("json") : QStringLiteral("csv");
+    return QDir(fi.absolutePath()).filePath(QString("%1_telemetry.%2").arg(fi.fileName(), suffix));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses /proc/<pid>/stat: pid, parent pid, command name, CPU ticks and thread count.
+ *
+ * The command name may contain spaces and parentheses, so the fields are split after its last ')'.
+ *
+ * \return True if the line could be parsed; false otherwise.
+ **********************************************************************************************************************/
+bool ProcessTelemetry::parseStat(const QByteArray &data, ProcessStat &out)
+{
+    const int open = data.indexOf('(');
+    const int close = data.lastIndexOf(')');
+    if (open <= 0 || close < open)
+        return false;
+
+    bool ok = false;
+    out.pid = data.left(open).trimmed().toLongLong(&ok);
+    if (!ok)
+        return false;
+    out.name = QString::fromUtf8(data.mid(open + 1, close - open - 1));
+
+    // Fields from field 3 (state) on; utime/stime are fields 14/15, num_threads is field 20.
+    const QList<QByteArray> f = data.mid(close + 1).simplified().split(' ');
+    if (f.size() < 18)
+        return false;
+
+    out.ppid     = f.at(1).toLongLong();
+    out.cpuTicks = f.at(11).toLongLong() + f.at(12).toLongLong();
+    out.threads  = f.at(17).toInt();
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses /proc/<pid>/status: resident (VmRSS) and peak resident (VmHWM) memory and thread count.
+ **********************************************************************************************************************/
+void ProcessTelemetry::parseStatus(const QByteArray &data, ProcessStat &out)
+{
+    const qint64 rssKb = keyValue(data, "VmRSS");
+    const qint64 hwmKb = keyValue(data, "VmHWM");
+    const qint64 threads = keyValue(data, "Threads");
+
+    if (rssKb >= 0)
+        out.rssBytes = rssKb * 1024;
+    if (hwmKb >= 0)
+        out.peakRssBytes = hwmKb * 1024;
+    if (threads > 0)
+        out.threads = int(threads);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses /proc/<pid>/io: bytes read from and written to storage.
+ *
+ * The file is only readable for processes of the same user; missing values stay 0.
+ **********************************************************************************************************************/
+void ProcessTelemetry::parseIo(const QByteArray &data, ProcessStat &out)
+{
+    const qint64 read = keyValue(data, "read_bytes");
+    const qint64 written = keyValue(data, "write_bytes");
+
+    if (read >= 0)
+        out.readBytes = read;
+    if (written >= 0)
+        out.writeBytes = written;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the process tree below a root process.
+ *
+ * Scans the stat files of all processes to find the descendants of \a rootPid, then reads status and io of
+ * the tree members only.
+ *
+ * \param procRoot Root of the proc file system ("/proc", or a directory with the same layout in tests).
+ * \param rootPid  Process id of the tree root.
+ * \return The root followed by its descendants (breadth first); empty if the root does not exist.
+ **********************************************************************************************************************/
+QList<ProcessTelemetry::ProcessStat> ProcessTelemetry::readProcessTree(const QString &procRoot, qint64 rootPid)
+{
+    QMap<qint64, ProcessStat> all;
+    QMap<qint64, QList<qint64>> children;
+
+    const QDir dir(procRoot);
+    for (const QString &entry : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool ok = false;
+        const qint64 pid = entry.toLongLong(&ok);
+        if (!ok)
+            continue;
+
+        ProcessStat stat;
+        if (!parseStat(readProcFile(dir.filePath(entry + QStringLiteral("/stat"))), stat))
+            continue;
+
+        all.insert(pid, stat);
+        children[stat.ppid].append(pid);
+    }
+
+    QList<ProcessStat> tree;
+    if (!all.contains(rootPid))
+        return tree;
+
+    QList<qint64> pending;
+    pending.append(rootPid);
+    while (!pending.isEmpty()) {
+        const qint64 pid = pending.takeFirst();
+        ProcessStat stat = all.value(pid);
+
+        const QString base = dir.filePath(QString::number(pid));
+        parseStatus(readProcFile(base + QStringLiteral("/status")), stat);
+        parseIo(readProcFile(base + QStringLiteral("/io")), stat);
+
+        tree.append(stat);
+        pending.append(children.value(pid));
+    }
+
+    return tree;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the CPU ticks of every process of a tree by pid.
+ **********************************************************************************************************************/
+QMap<qint64, qint64> ProcessTelemetry::ticksByPid(const QList<ProcessStat> &tree) const
+{
+    QMap<qint64, qint64> ticks;
+    for (const ProcessStat &p : tree)
+        ticks.insert(p.pid, p.cpuTicks);
+    return ticks;
+}
@@ -0,0 +1,145 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef PROCESSTELEMETRY_H
+#define PROCESSTELEMETRY_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+class QTimer;
+
+/*!*******************************************************************************************************************
+ * \class ProcessTelemetry
+ * \brief Samples CPU, memory, I/O and thread usage of a simulation process tree from /proc.
+ *
+ * While attached to a process, the sampler walks the tree below it (the Python model, mpirun and all solver
+ * ranks) through /proc/<pid>/stat, status and io at a fixed interval and records one aggregated Sample per
+ * tick: CPU usage in percent of one core, resident and peak resident memory, bytes read from and written to
+ * storage and the number of processes and threads. Every sample is tagged with the current stage name, so a
+ * Palace run yields separate figures for preprocessing and solver.
+ *
+ * The recorded series can be written as CSV or JSON, together with a per-stage summary. Sampling requires a
+ * Linux /proc file system; on other platforms attach() is a no-op and no samples are recorded.
+ **********************************************************************************************************************/
+class ProcessTelemetry : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Format { Csv, Json };
+
+    struct ProcessStat
+    {
+        qint64                  pid = 0;
+        qint64                  ppid = 0;
+        QString                 name;
+        qint64                  cpuTicks = 0;           // utime + stime
+        qint64                  rssBytes = 0;
+        qint64                  peakRssBytes = 0;
+        qint64                  readBytes = 0;
+        qint64                  writeBytes = 0;
+        int                     threads = 0;
+    };
+
+    struct Sample
+    {
+        qint64                  elapsedMs = 0;
+        QString                 stage;
+        int                     processes = 0;
+        int                     threads = 0;
+        double                  cpuPercent = 0.0;       // 100 = one fully used core
+        qint64                  rssBytes = 0;
+        qint64                  peakRssBytes = 0;
+        qint64                  readBytes = 0;          // cumulative over the run
+        qint64                  writeBytes = 0;         // cumulative over the run
+    };
+
+    struct StageSummary
+    {
+        QString                 stage;
+        qint64                  durationMs = 0;
+        double                  avgCpuPercent = 0.0;
+        double                  maxCpuPercent = 0.0;
+        qint64                  peakRssBytes = 0;
+        qint64                  readBytes = 0;
+        qint64                  writeBytes = 0;
+        int                     maxThreads = 0;
+
+        QString                 toString() const;
+    };
+
+    explicit ProcessTelemetry(QObject *parent = nullptr);
+
+    void                        setInterval(int msecs);
+    int                         interval() const { return m_intervalMs; }
+    void                        setProcRoot(const QString &root) { m_procRoot = root; }
+
+    void                        reset();
+    void                        attach(qint64 pid, const QString &stage);
+    void                        detach();
+    bool                        isAttached() const { return m_rootPid > 0; }
+    void                        sampleNow();
+
+    const QList<Sample>        &samples() const { return m_samples; }
+    QList<StageSummary>         stageSummaries() const;
+
+    bool                        write(const QString &path, Format format, QString &outError) const;
+    QByteArray                  toCsv() const;
+    QByteArray                  toJson() const;
+
+    static bool                 isSupported();
+    static QString              filePathFor(const QString &runDir, Format format);
+    static bool                 parseStat(const QByteArray &data, ProcessStat &out);
+    static void                 parseStatus(const QByteArray &data, ProcessStat &out);
+    static void                 parseIo(const QByteArray &data, ProcessStat &out);
+    static QList<ProcessStat>   readProcessTree(const QString &procRoot, qint64 rootPid);
+
+signals:
+    void                        sampled(const ProcessTelemetry::Sample &sample);
+
+private:
+    QMap<qint64, qint64>        ticksByPid(const QList<ProcessStat> &tree) const;
+
+private:
+    QTimer                     *m_timer = nullptr;
+    int                         m_intervalMs = 1000;
+    QString                     m_procRoot = QStringLiteral("/proc");
+    long                        m_ticksPerSecond = 100;
+
+    qint64                      m_rootPid = 0;
+    QString                     m_stage;
+    QElapsedTimer               m_clock;
+    qint64                      m_lastSampleMs = 0;
+    QMap<qint64, qint64>        m_lastTicks;
+    QMap<qint64, qint64>        m_readByPid;
+    QMap<qint64, qint64>        m_writeByPid;
+    qint64                      m_peakRssBytes = 0;
+
+    QList<Sample>               m_samples;
+};
+
+Q_DECLARE_METATYPE(ProcessTelemetry::Sample)
+
+#endif // PROCESSTELEMETRY_H
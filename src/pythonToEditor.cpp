@@ -49,114 +49,7 @@
 #include "ui_mainwindow.h"
 #include "substrateview.h"
 #include "pythonparser.h"
-
-/*!*******************************************************************************************************************
- * \brief Checks whether a simulation setting represents a file path (GDS or XML).
- *
- * Determines whether the given setting should be treated as a file path rather than
- * a numeric or boolean simulation parameter. This is used to correctly serialize
- * file paths into Python string literals when updating Palace models.
- *
- * The check is based on:
- *  - Known canonical keys (e.g. "GdsFile", "SubstrateFile")
- *  - File extension heuristics (".gds", ".gdsii", ".xml")
- *
- * \param key  Setting key name.
- * \param v    Setting value.
- *
- * \return True if the setting represents a GDS or XML file path; otherwise false.
- **********************************************************************************************************************/
-static bool isFilePathSetting(const QString& key, const QVariant& v)
-{
-    if (v.type() != QVariant::String)
-        return false;
-
-    const QString s = v.toString().trimmed();
-    if (s.isEmpty())
-        return false;
-
-    if (key.compare("GdsFile", Qt::CaseInsensitive) == 0 ||
-        key.compare("SubstrateFile", Qt::CaseInsensitive) == 0)
-        return true;
-
-    const QString lower = s.toLower();
-    return lower.endsWith(".gds") || lower.endsWith(".gdsii") ||
-           lower.endsWith(".xml");
-}
-
-/*!*******************************************************************************************************************
- * \brief Converts a native file system path into a quoted Python string literal.
- *
- * Escapes backslashes and single quotes so that the resulting string can be safely
- * embedded into a Python script as a file path. The returned value is always wrapped
- * in single quotes.
- *
- * This function does not perform any existence checks and operates purely on the
- * string representation of the path.
- *
- * \param path  Native file system path.
- *
- * \return Python-compatible quoted string representing \a path.
- **********************************************************************************************************************/
-static QString toPythonQuotedPath(QString s)
-{
-    s = QDir::fromNativeSeparators(s);
-
-    s.replace("\\", "\\\\");
-    s.replace("\"", "\\\"");
-
-    return QString("\"%1\"").arg(s);
-}
-
-/*!*******************************************************************************************************************
- * \brief Replaces a top-level Python assignment with a new value.
- *
- * Searches the script for a line of the form:
- * \code
- *   <key> = <value>   # optional comment
- * \endcode
- * and replaces only the value part with \a pyValue while preserving indentation
- * and an optional trailing comment.
- *
- * \param script  Python script text to be modified in-place.
- * \param key     Variable name to replace (left-hand side of assignment).
- * \param pyValue New Python literal/expression to put on the right-hand side.
- **********************************************************************************************************************/
-static void replaceTopLevelVar(QString &script, const QString &key, const QString &pyValue)
-{
-    QRegularExpression reVar(
-        QString(R"((?m)^([ \t]*%1\b[ \t]*=[ \t]*)([^#\r\n]*?)([ \t]*#.*)?$)")
-            .arg(QRegularExpression::escape(key)));
-
-    script.replace(reVar, QStringLiteral("\\1%1\\3").arg(pyValue));
-}
-
-/*!*******************************************************************************************************************
- * \brief Replaces any dict-style Python assignment for a given key with a new value.
- *
- * Searches the script for lines of the form:
- * \code
- *   <dict>['key'] = <value>   # optional comment
- *   <dict>["key"] = <value>   # optional comment
- * \endcode
- * and replaces only the value part with \a pyValue while preserving indentation
- * and an optional trailing comment.
- *
- * This helper is intentionally generic and does not restrict the dict variable name.
- *
- * \param script  Python script text to be modified in-place.
- * \param key     Dictionary key string to replace.
- * \param pyValue New Python literal/expression to put on the right-hand side.
- **********************************************************************************************************************/
-static void replaceAnyDictVar(QString &script, const QString &key, const QString &pyValue)
-{
-    QRegularExpression reDict(
-        QString(R"(^(\s*(\w+)\s*\[\s*['"]%1['"]\s*\]\s*=\s*)([^#\n]*?)(\s*#.*)?$)")
-            .arg(QRegularExpression::escape(key)),
-        QRegularExpression::MultilineOption);
-
-    script.replace(reDict, QStringLiteral("\\1%1\\4").arg(pyValue));
-}
+#include "tracer.h"
 
 /*!*******************************************************************************************************************
  * \brief Automatically enables the "SubLayer Names" option when substrate and ports are available.
@@ -245,49 +138,6 @@ void MainWindow::applySimSettingsToScript(QString &script, const QString &simKey
     }
 }
 
-/*!*******************************************************************************************************************
- * \brief Converts a QVariant into a Python literal string suitable for embedding into a script.
- *
- * Supported types:
- * - Double   -> formatted with \c 'g' precision 12
- * - Integer  -> decimal
- * - Bool     -> \c True / \c False
- *
- * \param v           Input QVariant.
- * \param outLiteral  Output string receiving the Python literal.
- *
- * \return \c true if conversion succeeded, \c false if the type is unsupported.
- **********************************************************************************************************************/
-bool MainWindow::variantToPythonLiteral(const QVariant &v, QString *outLiteral)
-{
-    if (!outLiteral)
-        return false;
-
-    if (v.type() == QVariant::Double) {
-        *outLiteral = QString::number(v.toDouble(), 'g', 12);
-        return true;
-    }
-
-    if (v.type() == QVariant::Int) {
-        *outLiteral = QString::number(v.toInt());
-        return true;
-    }
-
-    if (v.type() == QVariant::LongLong ||
-        v.type() == QVariant::UInt ||
-        v.type() == QVariant::ULongLong) {
-        *outLiteral = QString::number(v.toLongLong());
-        return true;
-    }
-
-    if (v.type() == QVariant::Bool) {
-        *outLiteral = v.toBool() ? QStringLiteral("True") : QStringLiteral("False");
-        return true;
-    }
-
-    return false;
-}
-
 /*!*******************************************************************************************************************
  * \brief Applies OpenEMS-related settings updates to the script.
  *
@@ -345,28 +195,7 @@ void MainWindow::applyOneSettingToScript(QString &script,
         return;
     }
 
-    const auto mode = itMode.value();
-
-    QString pyValue;
-    if (isFilePathSetting(key, val)) {
-        pyValue = toPythonQuotedPath(val.toString());
-    } else {
-        if (!variantToPythonLiteral(val, &pyValue))
-            return;
-    }
-
-    switch (mode) {
-    case PythonParser::SettingWriteMode::TopLevel:
-        replaceTopLevelVar(script, key, pyValue);
-        break;
-
-    case PythonParser::SettingWriteMode::DictAssign:
-        replaceAnyDictVar(script, key, pyValue);
-        break;
-
-    case PythonParser::SettingWriteMode::Unknown:
-        break;
-    }
+    PythonParser::writeSetting(script, key, val, itMode.value());
 }
 
 /*!*******************************************************************************************************************
@@ -426,7 +255,7 @@ void MainWindow::applyPalaceWorkflowToScript(QString &script)
 {
     QRegularExpression reElmerKey(R"(\w+\s*\[\s*['"]elmer['"]\s*\]\s*=)");
     if (reElmerKey.match(script).hasMatch())
-        replaceAnyDictVar(script, QStringLiteral("elmer"), QStringLiteral("False"));
+        PythonParser::replaceDictAssignment(script, QStringLiteral("elmer"), QStringLiteral("False"));
 
     script.replace(
         QRegularExpression(R"(utilities\.create_elmer_run_script\s*\(\s*sim_path\s*,\s*settings\s*\))"),
@@ -438,7 +267,7 @@ void MainWindow::applyPalaceWorkflowToScript(QString &script)
 
     QRegularExpression reIterKey(R"(\w+\s*\[\s*['"]iterative['"]\s*\]\s*=)");
     if (reIterKey.match(script).hasMatch())
-        replaceAnyDictVar(script, QStringLiteral("iterative"), QStringLiteral("False"));
+        PythonParser::replaceDictAssignment(script, QStringLiteral("iterative"), QStringLiteral("False"));
 }
 
 /*!*******************************************************************************************************************
@@ -446,6 +275,7 @@ void MainWindow::applyPalaceWorkflowToScript(QString &script)
  **********************************************************************************************************************/
 void MainWindow::syncGuiSettingsToPythonEditor()
 {
+    EMSTUDIO_TRACE_SCOPE("settings.writeBack");
     QString script = m_ui->editRunPythonScript->toPlainText();
     const QString simKey = currentSimToolKey().toLower();
 
@@ -465,7 +295,7 @@ void MainWindow::applyElmerWorkflowToScript(QString &script)
 {
     QRegularExpression reElmerKey(R"(\w+\s*\[\s*['"]elmer['"]\s*\]\s*=)");
     if (reElmerKey.match(script).hasMatch()) {
-        replaceAnyDictVar(script, QStringLiteral("elmer"), QStringLiteral("True"));
+        PythonParser::replaceDictAssignment(script, QStringLiteral("elmer"), QStringLiteral("True"));
     } else {
         QRegularExpression reCreate(
             R"(config_name,\s*data_dir\s*=\s*simulation_setup\.create_(?:palace|elmer)\s*\()");
@@ -476,7 +306,7 @@ void MainWindow::applyElmerWorkflowToScript(QString &script)
 
     QRegularExpression reIterKey(R"(\w+\s*\[\s*['"]iterative['"]\s*\]\s*=)");
     if (reIterKey.match(script).hasMatch()) {
-        replaceAnyDictVar(script, QStringLiteral("iterative"), QStringLiteral("True"));
+        PythonParser::replaceDictAssignment(script, QStringLiteral("iterative"), QStringLiteral("True"));
     } else {
         QRegularExpression reElmerLine(R"(settings\s*\[\s*['"]elmer['"]\s*\]\s*=\s*True)");
         const QRegularExpressionMatch m = reElmerLine.match(script);
@@ -836,6 +666,7 @@ void MainWindow::replaceOrInsertPortSection(QString &script, const QString &port
  **********************************************************************************************************************/
 void MainWindow::setEditorScriptPreservingState(const QString &script)
 {
+    EMSTUDIO_TRACE_SCOPE("settings.setEditorScript");
     // Save editor state
     QTextCursor oldCursor = m_ui->editRunPythonScript->textCursor();
     int oldPos    = oldCursor.position();
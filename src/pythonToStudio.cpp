@@ -49,6 +49,7 @@
 #include "ui_mainwindow.h"
 #include "substrateview.h"
 #include "pythonparser.h"
+#include "tracer.h"
 
 /*!*******************************************************************************************************************
  * \brief Saves the current Python script, re-parses it and updates the simulation setup.
@@ -65,6 +66,7 @@
  **********************************************************************************************************************/
 bool MainWindow::applyPythonScriptFromEditor()
 {
+    EMSTUDIO_TRACE_SCOPE("settings.applyFromEditor");
     QString filePath = m_ui->txtRunPythonScript->text().trimmed();
 
     info(filePath, true);
@@ -177,6 +179,7 @@ void MainWindow::rebuildSimulationSettingsFromPalace(const QMap<QString, QVarian
                                                      const QMap<QString, QString>& tips,
                                                      const QMap<QString, QVariant>& topLevelVars)
 {
+    EMSTUDIO_TRACE_SCOPE("propertyTree.rebuildSimSettings");
     if (!m_simSettingsGroup || !m_variantManager)
         return;
 
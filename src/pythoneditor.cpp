@@ -20,13 +20,17 @@
 
 #include "finddialog.h"
 #include "pythoneditor.h"
+#include "textsearchengine.h"
 #include "pythonsyntaxhighlighter.h"
 
 #include <QPalette>
 #include <QKeyEvent>
+#include <QShowEvent>
+#include <QResizeEvent>
 #include <QShortcut>
 #include <QScrollBar>
 #include <QTextCursor>
+#include <QTextLayout>
 #include <QVBoxLayout>
 #include <QWheelEvent>
 #include <QApplication>
@@ -34,6 +38,7 @@
 #include <QRegularExpression>
 
 static constexpr qreal ZOOM_STEP = 1.10;
+static constexpr int   IDENTIFIER_PUBLISH_DELAY_MS = 150;
 
 /*!*******************************************************************************************************************
  * \brief Constructs the PythonEditor widget with syntax highlighting and autocompletion.
@@ -60,7 +65,17 @@ PythonEditor::PythonEditor(QWidget *parent)
     completer->setCompletionMode(QCompleter::PopupCompletion);
     setCompleter(completer);
 
-    connect(this, &QTextEdit::textChanged, this, &PythonEditor::updateVariableList);
+    m_publishTimer.setSingleShot(true);
+    m_publishTimer.setInterval(IDENTIFIER_PUBLISH_DELAY_MS);
+    connect(&m_publishTimer, &QTimer::timeout, this, &PythonEditor::updateVariableList);
+
+    m_blockIdentifiers.resize(document()->blockCount());
+    connect(document(), &QTextDocument::contentsChange, this, &PythonEditor::onContentsChange);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &PythonEditor::refreshVisibleHighlighting);
+
+    m_search = new TextSearchEngine(document(), this);
+    connect(m_search, &TextSearchEngine::matchesUpdated, this, &PythonEditor::refreshSearchSelections);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, &PythonEditor::refreshSearchSelections);
 
     for (const auto& k : m_keywords)
         m_keywordsLower.insert(k.toLower());
@@ -158,6 +173,11 @@ void PythonEditor::keyPressEvent(QKeyEvent *e)
 
     QString completionPrefix = textUnderCursor();
 
+    if (completionPrefix.length() >= 2 && m_publishTimer.isActive()) {
+        m_publishTimer.stop();
+        updateVariableList();
+    }
+
     if (completionPrefix.length() < 2) {
         m_completer->popup()->hide();
         return;
@@ -187,29 +207,167 @@ QString PythonEditor::textUnderCursor() const
 }
 
 /*!*******************************************************************************************************************
- * \brief Scans the editor content and updates the completion list with variables and keywords.
+ * \brief Publishes the completion list built from the identifier index and the Python keywords.
+ *
+ * Called by the debounce timer after document changes. The index itself is kept up to date by
+ * onContentsChange(), so no document scan happens here. The completer model is only reset when
+ * the list actually changed.
  **********************************************************************************************************************/
 void PythonEditor::updateVariableList()
 {
-    const QString text = this->toPlainText();
-    QSet<QString> identifiers;
-    QRegularExpression re(R"(\b([A-Za-z_][A-Za-z0-9_]*)\b)");
-    QRegularExpressionMatchIterator i = re.globalMatch(text);
+    QStringList fullList = m_keywords;
+    fullList.reserve(m_keywords.size() + m_identifierRefs.size());
+    for (auto it = m_identifierRefs.cbegin(); it != m_identifierRefs.cend(); ++it)
+        fullList.append(it.key());
+
+    fullList.removeDuplicates();
+    fullList.sort(Qt::CaseInsensitive);
+
+    if (fullList != m_model->stringList())
+        m_model->setStringList(fullList);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Updates the identifier index for the blocks touched by a document change.
+ *
+ * The blocks between \a position and \a position + \a charsAdded are rescanned. The number of
+ * replaced old blocks follows from the change of the document block count, so block entries
+ * after the edited range are shifted without being rescanned. Publishing the completion list
+ * is debounced.
+ *
+ * \param position     Position of the change.
+ * \param charsRemoved Number of removed characters.
+ * \param charsAdded   Number of added characters.
+ **********************************************************************************************************************/
+void PythonEditor::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved);
+
+    QTextDocument *doc = document();
+
+    const QTextBlock firstBlock = doc->findBlock(position);
+    QTextBlock lastBlock = doc->findBlock(position + charsAdded);
+    if (!lastBlock.isValid())
+        lastBlock = doc->lastBlock();
+
+    const int first   = firstBlock.isValid() ? firstBlock.blockNumber() : -1;
+    const int lastNew = lastBlock.blockNumber();
+    const int lastOld = lastNew - (doc->blockCount() - m_blockIdentifiers.size());
+
+    if (first < 0 || lastOld < first - 1 || lastOld >= m_blockIdentifiers.size()) {
+        rebuildIdentifierIndex();
+        m_publishTimer.start();
+        return;
+    }
+
+    for (int i = first; i <= lastOld; ++i)
+        releaseIdentifiers(m_blockIdentifiers.at(i));
+    m_blockIdentifiers.remove(first, lastOld - first + 1);
+
+    QVector<QStringList> fresh;
+    fresh.reserve(lastNew - first + 1);
+    for (QTextBlock b = firstBlock; b.isValid() && b.blockNumber() <= lastNew; b = b.next()) {
+        QStringList ids = scanBlockIdentifiers(b.text());
+        retainIdentifiers(ids);
+        fresh.push_back(ids);
+    }
 
-    while (i.hasNext()) {
-        QRegularExpressionMatch match = i.next();
-        QString word = match.captured(1);
+    if (fresh.size() == 1) {
+        m_blockIdentifiers.insert(first, fresh.first());
+    } else {
+        QVector<QStringList> merged;
+        merged.reserve(m_blockIdentifiers.size() + fresh.size());
+        merged += m_blockIdentifiers.mid(0, first);
+        merged += fresh;
+        merged += m_blockIdentifiers.mid(first);
+        m_blockIdentifiers.swap(merged);
+    }
 
-        if (!m_keywordsLower.contains(word.toLower())) {
-            identifiers.insert(word);
+    m_publishTimer.start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Extracts the unique non-keyword identifiers of one block.
+ *
+ * An identifier is a run of word characters starting with a letter or underscore that is not
+ * preceded by another word character (same as \c \b[A-Za-z_][A-Za-z0-9_]*\b).
+ *
+ * \param text Block text.
+ * \return Unique identifiers of the block.
+ **********************************************************************************************************************/
+QStringList PythonEditor::scanBlockIdentifiers(const QString &text) const
+{
+    auto isWordChar = [](QChar c) {
+        return (c >= QLatin1Char('a') && c <= QLatin1Char('z')) ||
+               (c >= QLatin1Char('A') && c <= QLatin1Char('Z')) ||
+               (c >= QLatin1Char('0') && c <= QLatin1Char('9')) ||
+               c == QLatin1Char('_');
+    };
+
+    QStringList ids;
+    const int n = text.size();
+    int i = 0;
+
+    while (i < n) {
+        if (!isWordChar(text.at(i))) {
+            ++i;
+            continue;
         }
+
+        const int start = i;
+        while (i < n && isWordChar(text.at(i)))
+            ++i;
+
+        if (text.at(start).isDigit())
+            continue;
+
+        const QString word = text.mid(start, i - start);
+        if (!m_keywordsLower.contains(word.toLower()) && !ids.contains(word))
+            ids.append(word);
     }
 
-    QStringList fullList = m_keywords;
-    fullList.append(identifiers.values());
-    fullList.removeDuplicates();
-    fullList.sort(Qt::CaseInsensitive);
-    m_model->setStringList(fullList);
+    return ids;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Increments the document-wide reference counts of \a ids.
+ **********************************************************************************************************************/
+void PythonEditor::retainIdentifiers(const QStringList &ids)
+{
+    for (const QString &id : ids)
+        ++m_identifierRefs[id];
+}
+
+/*!*******************************************************************************************************************
+ * \brief Decrements the document-wide reference counts of \a ids and drops unused identifiers.
+ **********************************************************************************************************************/
+void PythonEditor::releaseIdentifiers(const QStringList &ids)
+{
+    for (const QString &id : ids) {
+        auto it = m_identifierRefs.find(id);
+        if (it == m_identifierRefs.end())
+            continue;
+        if (--it.value() <= 0)
+            m_identifierRefs.erase(it);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Rebuilds the identifier index for the whole document.
+ *
+ * Fallback used when a change notification cannot be mapped onto the current index.
+ **********************************************************************************************************************/
+void PythonEditor::rebuildIdentifierIndex()
+{
+    m_identifierRefs.clear();
+    m_blockIdentifiers.clear();
+    m_blockIdentifiers.reserve(document()->blockCount());
+
+    for (QTextBlock b = document()->firstBlock(); b.isValid(); b = b.next()) {
+        QStringList ids = scanBlockIdentifiers(b.text());
+        retainIdentifiers(ids);
+        m_blockIdentifiers.push_back(ids);
+    }
 }
 
 
@@ -290,6 +448,8 @@ void PythonEditor::findPrev(const QString &pat, bool matchCase, bool wholeWords,
  *
  * Searches forward or backward depending on the \a forward flag. Supports regular expressions,
  * whole-word matching, and wrap-around. Updates the text cursor position if a match is found.
+ * If the same query is active in highlight-all mode and fully scanned, the cached match
+ * offsets are used instead of searching the document again.
  *
  * \param pat        Search string or regular expression pattern.
  * \param forward    Direction of search: true for forward, false for backward.
@@ -312,6 +472,14 @@ bool PythonEditor::doFind(const QString &pat, bool forward, bool matchCase, bool
     QTextCursor start = textCursor();
     QTextCursor found;
 
+    if (m_search && m_search->isFinished() && m_search->hasQuery(pat, matchCase, wholeWords, useRegex)) {
+        const int from = forward ? start.selectionEnd() : start.selectionStart();
+        found = m_search->findFrom(from, forward, wrap);
+        if (!found.isNull())
+            setTextCursor(found);
+        return !found.isNull();
+    }
+
     if (useRegex) {
         QString expr = pat;
         if (wholeWords) expr = QStringLiteral("\\b%1\\b").arg(pat);
@@ -351,9 +519,10 @@ bool PythonEditor::doFind(const QString &pat, bool forward, bool matchCase, bool
 /*!*******************************************************************************************************************
  * \brief Highlights all occurrences of a search pattern within the text editor.
  *
- * Applies a background highlight to every match of the given pattern across the entire document.
- * Supports both plain text and regular expression searches, with optional case sensitivity and
- * whole-word matching.
+ * Hands the query to the TextSearchEngine, which scans the document in time slices and caches
+ * the match offsets per block. Only matches in the visible blocks are turned into
+ * ExtraSelections (see refreshSearchSelections()). Extending a plain-text pattern reuses the
+ * previous matches.
  *
  * \param pat        Search string or regular expression pattern.
  * \param matchCase  Enables case-sensitive matching if true.
@@ -362,63 +531,67 @@ bool PythonEditor::doFind(const QString &pat, bool forward, bool matchCase, bool
  **********************************************************************************************************************/
 void PythonEditor::highlightAll(const QString &pat, bool matchCase, bool wholeWords, bool useRegex)
 {
-    m_searchSelections.clear();
-    if (pat.isEmpty()) { applyHighlights(m_searchSelections); return; }
-
-    auto bg = palette().color(QPalette::Highlight).lighter(130);
-    QTextCursor cur(document());
-    cur.beginEditBlock();
-
-    auto flags = QTextDocument::FindFlags{};
-    if (matchCase)  flags |= QTextDocument::FindCaseSensitively;
-    if (wholeWords) flags |= QTextDocument::FindWholeWords;
-
-    QTextCursor found;
-    if (useRegex) {
-        QString expr = pat;
-        if (wholeWords) expr = QStringLiteral("\\b%1\\b").arg(pat);
-        QRegularExpression re(expr,
-            matchCase ? QRegularExpression::NoPatternOption
-                      : QRegularExpression::CaseInsensitiveOption);
-
-        QTextCursor c(document()->begin());
-        while (true) {
-            found = document()->find(re, c, flags);
-            if (found.isNull()) break;
-            QTextEdit::ExtraSelection sel;
-            sel.cursor = found;
-            sel.format.setBackground(bg);
-            m_searchSelections.push_back(sel);
-            c = found;
-        }
-    } else {
-        QTextCursor c(document()->begin());
-        while (true) {
-            found = document()->find(pat, c, flags);
-            if (found.isNull()) break;
-            QTextEdit::ExtraSelection sel;
-            sel.cursor = found;
-            sel.format.setBackground(bg);
-            m_searchSelections.push_back(sel);
-            c = found;
-        }
+    if (pat.isEmpty()) {
+        clearHighlights();
+        return;
     }
 
-    cur.endEditBlock();
-    applyHighlights(m_searchSelections);
+    m_search->setPattern(pat, matchCase, wholeWords, useRegex);
+    refreshSearchSelections();
 }
 
 /*!*******************************************************************************************************************
  * \brief Removes all current search highlights from the editor.
  *
- * Clears the internal list of ExtraSelections used for highlighting and refreshes the display.
+ * Clears the search query, the internal list of ExtraSelections and refreshes the display.
  **********************************************************************************************************************/
 void PythonEditor::clearHighlights()
 {
+    if (m_search)
+        m_search->clear();
+
     m_searchSelections.clear();
     applyHighlights(m_searchSelections);
 }
 
+/*!*******************************************************************************************************************
+ * \brief Rebuilds the search ExtraSelections for the visible blocks.
+ *
+ * Called when the search engine reports new matches and when the viewport scrolls. While the
+ * editor is hidden there is no viewport, so all cached matches are materialized.
+ **********************************************************************************************************************/
+void PythonEditor::refreshSearchSelections()
+{
+    if (!m_search || !m_search->isActive()) {
+        if (!m_searchSelections.isEmpty()) {
+            m_searchSelections.clear();
+            applyHighlights(m_searchSelections);
+        }
+        return;
+    }
+
+    QTextBlock first, last;
+    if (isVisible()) {
+        visibleBlockRange(first, last);
+    } else {
+        first = document()->firstBlock();
+        last  = document()->lastBlock();
+    }
+
+    const QColor bg = palette().color(QPalette::Highlight).lighter(130);
+
+    m_searchSelections.clear();
+    const QVector<QTextCursor> cursors = m_search->cursorsInRange(first, last);
+    for (const QTextCursor &c : cursors) {
+        QTextEdit::ExtraSelection sel;
+        sel.cursor = c;
+        sel.format.setBackground(bg);
+        m_searchSelections.push_back(sel);
+    }
+
+    applyHighlights(m_searchSelections);
+}
+
 /*!*******************************************************************************************************************
  * \brief Applies the provided set of text highlights to the editor.
  *
@@ -544,15 +717,70 @@ void PythonEditor::setExtraHighlightKeywords(const QStringList &words)
 {
     if (m_highlighter)
         m_highlighter->setExtraKeywords(words);
+
+    refreshVisibleHighlighting();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Determines the first and last text blocks currently visible in the viewport.
+ *
+ * \param first Receives the first visible block.
+ * \param last  Receives the last visible block.
+ **********************************************************************************************************************/
+void PythonEditor::visibleBlockRange(QTextBlock &first, QTextBlock &last) const
+{
+    const QRect r = viewport()->rect();
+    first = cursorForPosition(r.topLeft()).block();
+    last  = cursorForPosition(r.bottomRight()).block();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Rehighlights stale blocks in the visible region.
+ *
+ * Called after extra keywords change and whenever the viewport scrolls, grows or is shown, so
+ * that keyword changes are applied lazily instead of rehighlighting the whole document. Does
+ * nothing while the editor is hidden.
+ **********************************************************************************************************************/
+void PythonEditor::refreshVisibleHighlighting()
+{
+    if (!m_highlighter || !isVisible())
+        return;
+
+    QTextBlock first, last;
+    visibleBlockRange(first, last);
+    m_highlighter->rehighlightVisible(first, last);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Refreshes syntax and search highlighting of the visible blocks when the editor becomes visible.
+ * \param e Show event.
+ **********************************************************************************************************************/
+void PythonEditor::showEvent(QShowEvent *e)
+{
+    QTextEdit::showEvent(e);
+    refreshVisibleHighlighting();
+    refreshSearchSelections();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Refreshes syntax and search highlighting of newly exposed blocks when the editor is resized.
+ * \param e Resize event.
+ **********************************************************************************************************************/
+void PythonEditor::resizeEvent(QResizeEvent *e)
+{
+    QTextEdit::resizeEvent(e);
+    refreshVisibleHighlighting();
+    refreshSearchSelections();
 }
 
 #ifdef EMSTUDIO_TESTING
 
 /*!*******************************************************************************************************************
- * \brief Test helper that exposes updateVariableList() in test builds.
+ * \brief Test helper that publishes the completion list immediately in test builds.
  **********************************************************************************************************************/
 void PythonEditor::testUpdateVariableList()
 {
+    m_publishTimer.stop();
     updateVariableList();
 }
 
@@ -580,6 +808,35 @@ void PythonEditor::testOpenFindDialog()
     openFindDialog();
 }
 
+/*!*******************************************************************************************************************
+ * \brief Test helper: returns the number of matches cached by the search engine.
+ **********************************************************************************************************************/
+int PythonEditor::testSearchMatchCount() const
+{
+    return m_search ? m_search->matchCount() : 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper: checks whether the character at \a position carries the extra keyword format.
+ *
+ * \param position Document position.
+ * \return true if the highlighter applied the DemiBold extra keyword format at this position.
+ **********************************************************************************************************************/
+bool PythonEditor::testIsExtraKeywordFormatAt(int position) const
+{
+    const QTextBlock block = document()->findBlock(position);
+    if (!block.isValid() || !block.layout())
+        return false;
+
+    const int rel = position - block.position();
+    const auto formats = block.layout()->formats();
+    for (const QTextLayout::FormatRange &r : formats) {
+        if (rel >= r.start && rel < r.start + r.length)
+            return r.format.fontWeight() == QFont::DemiBold;
+    }
+    return false;
+}
+
 #endif
 
 /*!*******************************************************************************************************************
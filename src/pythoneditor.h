@@ -22,11 +22,16 @@
 #define PYTHONEDITOR_H
 
 #include <QSet>
+#include <QHash>
+#include <QTimer>
+#include <QVector>
 #include <QTextEdit>
+#include <QTextBlock>
 #include <QCompleter>
 #include <QStringListModel>
 
 class FindDialog;
+class TextSearchEngine;
 class PythonSyntaxHighlighter;
 
 /*!*******************************************************************************************************************
@@ -39,7 +44,9 @@ class PythonSyntaxHighlighter;
  * Features:
  * - Highlighting of keywords, strings, comments, numbers, and functions.
  * - Dynamic autocompletion as the user types.
- * - Tracking and updating of variables used in the script.
+ * - Tracking and updating of variables used in the script. Identifiers are indexed per text
+ *   block and updated incrementally from QTextDocument::contentsChange; the sorted completion
+ *   list is published after a short debounce delay.
  *
  * Usage:
  *  \code
@@ -65,6 +72,8 @@ public:
     void                                testZoomInText();
     void                                testZoomOutText();
     void                                testOpenFindDialog();
+    bool                                testIsExtraKeywordFormatAt(int position) const;
+    int                                 testSearchMatchCount() const;
 #endif
 
 signals:
@@ -79,11 +88,16 @@ public slots:
 
 private slots:
     void                                updateVariableList();
+    void                                onContentsChange(int position, int charsRemoved, int charsAdded);
+    void                                refreshVisibleHighlighting();
+    void                                refreshSearchSelections();
 
 protected:
     void                                wheelEvent(QWheelEvent *e) override;
     void                                keyPressEvent(QKeyEvent *e) override;
     void                                focusInEvent(QFocusEvent *e) override;
+    void                                resizeEvent(QResizeEvent *e) override;
+    void                                showEvent(QShowEvent *e) override;
 
 private:
     void                                zoomInText();
@@ -92,16 +106,27 @@ private:
     QString                             textUnderCursor() const;
     bool                                doFind(const QString &pat, bool forward, bool matchCase, bool wholeWords, bool useRegex, bool wrap = true);
     void                                applyHighlights(const QList<QTextEdit::ExtraSelection> &sel);
+    void                                visibleBlockRange(QTextBlock &first, QTextBlock &last) const;
+
+    QStringList                         scanBlockIdentifiers(const QString &text) const;
+    void                                retainIdentifiers(const QStringList &ids);
+    void                                releaseIdentifiers(const QStringList &ids);
+    void                                rebuildIdentifierIndex();
 
 private:
     QStringListModel                    *m_model;
     QStringList                         m_keywords;
     QSet<QString>                       m_keywordsLower;
 
+    QVector<QStringList>                m_blockIdentifiers;
+    QHash<QString, int>                 m_identifierRefs;
+    QTimer                              m_publishTimer;
+
     QCompleter                          *m_completer = nullptr;
 
     FindDialog                          *m_find = nullptr;
     QList<QTextEdit::ExtraSelection>    m_searchSelections;
+    TextSearchEngine                    *m_search = nullptr;
 
     PythonSyntaxHighlighter*            m_highlighter = nullptr;
 };
@@ -28,6 +28,8 @@
 
 #include <QRegularExpression>
 
+#include "tracer.h"
+
 namespace
 {
 
@@ -48,6 +50,130 @@ static void inferCellNameFromTopLevel(PythonParser::Result& result)
     if (!b.isEmpty()) { result.cellName = b; return; }
 }
 
+/*!*******************************************************************************************************************
+ * \brief Checks whether a simulation setting represents a file path (GDS or XML).
+ *
+ * Determines whether the given setting should be treated as a file path rather than
+ * a numeric or boolean simulation parameter. This is used to correctly serialize
+ * file paths into Python string literals when updating Palace models.
+ *
+ * The check is based on:
+ *  - Known canonical keys (e.g. "GdsFile", "SubstrateFile")
+ *  - File extension heuristics (".gds", ".gdsii", ".xml")
+ *
+ * \param key  Setting key name.
+ * \param v    Setting value.
+ *
+ * \return True if the setting represents a GDS or XML file path; otherwise false.
+ **********************************************************************************************************************/
+static bool isFilePathSetting(const QString& key, const QVariant& v)
+{
+    if (v.type() != QVariant::String)
+        return false;
+
+    const QString s = v.toString().trimmed();
+    if (s.isEmpty())
+        return false;
+
+    if (key.compare("GdsFile", Qt::CaseInsensitive) == 0 ||
+        key.compare("SubstrateFile", Qt::CaseInsensitive) == 0)
+        return true;
+
+    const QString lower = s.toLower();
+    return lower.endsWith(".gds") || lower.endsWith(".gdsii") ||
+           lower.endsWith(".xml");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts a native file system path into a quoted Python string literal.
+ *
+ * Escapes backslashes and single quotes so that the resulting string can be safely
+ * embedded into a Python script as a file path. The returned value is always wrapped
+ * in single quotes.
+ *
+ * This function does not perform any existence checks and operates purely on the
+ * string representation of the path.
+ *
+ * \param path  Native file system path.
+ *
+ * \return Python-compatible quoted string representing \a path.
+ **********************************************************************************************************************/
+static QString toPythonQuotedPath(QString s)
+{
+    s = QDir::fromNativeSeparators(s);
+
+    s.replace("\\", "\\\\");
+    s.replace("\"", "\\\"");
+
+    return QString("\"%1\"").arg(s);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Replaces a top-level Python assignment with a new value.
+ *
+ * Searches the script for a line of the form:
+ * \code
+ *   <key> = <value>   # optional comment
+ * \endcode
+ * and replaces only the value part with \a pyValue while preserving indentation
+ * and an optional trailing comment.
+ *
+ * \param script  Python script text to be modified in-place.
+ * \param key     Variable name to replace (left-hand side of assignment).
+ * \param pyValue New Python literal/expression to put on the right-hand side.
+ **********************************************************************************************************************/
+static void replaceTopLevelVar(QString &script, const QString &key, const QString &pyValue)
+{
+    QRegularExpression reVar(
+        QString(R"((?m)^([ \t]*%1\b[ \t]*=[ \t]*)([^#\r\n]*?)([ \t]*#.*)?$)")
+            .arg(QRegularExpression::escape(key)));
+
+    script.replace(reVar, QStringLiteral("\\1%1\\3").arg(pyValue));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts a QVariant into a Python literal string suitable for embedding into a script.
+ *
+ * Supported types:
+ * - Double   -> formatted with \c 'g' precision 12
+ * - Integer  -> decimal
+ * - Bool     -> \c True / \c False
+ *
+ * \param v           Input QVariant.
+ * \param outLiteral  Output string receiving the Python literal.
+ *
+ * \return \c true if conversion succeeded, \c false if the type is unsupported.
+ **********************************************************************************************************************/
+static bool variantToPythonLiteral(const QVariant &v, QString *outLiteral)
+{
+    if (!outLiteral)
+        return false;
+
+    if (v.type() == QVariant::Double) {
+        *outLiteral = QString::number(v.toDouble(), 'g', 12);
+        return true;
+    }
+
+    if (v.type() == QVariant::Int) {
+        *outLiteral = QString::number(v.toInt());
+        return true;
+    }
+
+    if (v.type() == QVariant::LongLong ||
+        v.type() == QVariant::UInt ||
+        v.type() == QVariant::ULongLong) {
+        *outLiteral = QString::number(v.toLongLong());
+        return true;
+    }
+
+    if (v.type() == QVariant::Bool) {
+        *outLiteral = v.toBool() ? QStringLiteral("True") : QStringLiteral("False");
+        return true;
+    }
+
+    return false;
+}
+
 /*!*******************************************************************************************************************
  * \brief Parses a simple Python literal into a QVariant.
  *
@@ -830,14 +956,27 @@ PythonParser::Result parseSettingsImpl(const QString &content,
                                        const QString &baseName,
                                        const QString &contextForErrors)
 {
+    EMSTUDIO_TRACE_SCOPE("parser.parseSettings", contextForErrors);
     PythonParser::Result result;
 
-    parseSettingsAssignments(content, result);
-    parseLegacyFileVars(content, result);
-    inferFilesFromSettings(result);
-    parseSettingTips(content, result);
-    parseTopLevelAssignments(content, &result.topLevel);
-    inferCellNameFromTopLevel(result);
+    {
+        EMSTUDIO_TRACE_SCOPE("parser.settingsAssignments");
+        parseSettingsAssignments(content, result);
+    }
+    {
+        EMSTUDIO_TRACE_SCOPE("parser.legacyFileVars");
+        parseLegacyFileVars(content, result);
+        inferFilesFromSettings(result);
+    }
+    {
+        EMSTUDIO_TRACE_SCOPE("parser.settingTips");
+        parseSettingTips(content, result);
+    }
+    {
+        EMSTUDIO_TRACE_SCOPE("parser.topLevelAssignments");
+        parseTopLevelAssignments(content, &result.topLevel);
+        inferCellNameFromTopLevel(result);
+    }
     finalizeResult(scriptDir, baseName, contextForErrors, result);
 
     for (auto it = result.topLevel.begin(); it != result.topLevel.end(); ++it) {
@@ -913,3 +1052,124 @@ PythonParser::Result PythonParser::parseSettingsFromText(const QString &content,
 {
     return parseSettingsImpl(content, scriptDir, baseName, QString());
 }
+
+/*!*******************************************************************************************************************
+ * \brief Detects the simulation backend implied by a Python model script.
+ *
+ * \param text   Script text.
+ * \param parsed Optional parse result of \a text; an explicit \c elmer setting takes precedence.
+ * \return "openems", "palace", "elmer" or "unknown".
+ **********************************************************************************************************************/
+QString PythonParser::detectSimToolKey(const QString &text, const Result *parsed)
+{
+    if (text.contains(QStringLiteral("from openEMS import openEMS")))
+        return QStringLiteral("openems");
+
+    auto isTruthy = [](const QVariant &v) -> bool {
+        if (!v.isValid())
+            return false;
+        if (v.type() == QVariant::Bool)
+            return v.toBool();
+        const QString s = v.toString().trimmed();
+        return s.compare(QLatin1String("True"), Qt::CaseInsensitive) == 0
+            || s == QLatin1String("1");
+    };
+
+    if (parsed) {
+        for (auto it = parsed->settings.constBegin(); it != parsed->settings.constEnd(); ++it) {
+            if (it.key().compare(QLatin1String("elmer"), Qt::CaseInsensitive) != 0)
+                continue;
+            if (it.value().type() == QVariant::Bool && !it.value().toBool())
+                return QStringLiteral("palace");
+            if (isTruthy(it.value()))
+                return QStringLiteral("elmer");
+        }
+    }
+
+    if (QRegularExpression(R"(\[\s*['"]elmer['"]\s*\]\s*=\s*False)", QRegularExpression::CaseInsensitiveOption)
+            .match(text)
+            .hasMatch())
+        return QStringLiteral("palace");
+
+    if (QRegularExpression(R"(\[\s*['"]elmer['"]\s*\]\s*=\s*True)", QRegularExpression::CaseInsensitiveOption)
+            .match(text)
+            .hasMatch())
+        return QStringLiteral("elmer");
+
+    if (text.contains(QStringLiteral("create_elmer")) ||
+        text.contains(QStringLiteral("create_elmer_run_script")) ||
+        text.contains(QStringLiteral("./run_elmer")))
+        return QStringLiteral("elmer");
+
+    QRegularExpression re(R"(\w+\s*\[\s*['"][^'"]+['"]\s*\]\s*=)");
+    if (re.match(text).hasMatch())
+        return QStringLiteral("palace");
+
+    return QStringLiteral("unknown");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Replaces any dict-style Python assignment for a given key with a new value.
+ *
+ * Searches the script for lines of the form:
+ * \code
+ *   <dict>['key'] = <value>   # optional comment
+ *   <dict>["key"] = <value>   # optional comment
+ * \endcode
+ * and replaces only the value part with \a pyValue while preserving indentation
+ * and an optional trailing comment.
+ *
+ * This helper is intentionally generic and does not restrict the dict variable name.
+ *
+ * \param script  Python script text to be modified in-place.
+ * \param key     Dictionary key string to replace.
+ * \param pyValue New Python literal/expression to put on the right-hand side.
+ **********************************************************************************************************************/
+void PythonParser::replaceDictAssignment(QString &script, const QString &key, const QString &pyValue)
+{
+    QRegularExpression reDict(
+        QString(R"(^(\s*(\w+)\s*\[\s*['"]%1['"]\s*\]\s*=\s*)([^#\n]*?)(\s*#.*)?$)")
+            .arg(QRegularExpression::escape(key)),
+        QRegularExpression::MultilineOption);
+
+    script.replace(reDict, QStringLiteral("\\1%1\\4").arg(pyValue));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes one simulation setting back into a Python model script.
+ *
+ * Serializes \a value as a Python literal (numbers, booleans, or quoted paths for GDS/XML file settings) and
+ * replaces the existing assignment of \a key according to \a mode: a top-level assignment (\c key = value) or a
+ * dict-style assignment (\c someDict['key'] = value). Indentation and trailing comments are preserved.
+ *
+ * \param script Python script text to be modified in-place.
+ * \param key    Setting key.
+ * \param value  New value.
+ * \param mode   Write mode reported by the parser for \a key.
+ * \return True if the value could be serialized and the mode is known; false otherwise.
+ **********************************************************************************************************************/
+bool PythonParser::writeSetting(QString &script, const QString &key, const QVariant &value, SettingWriteMode mode)
+{
+    QString pyValue;
+    if (isFilePathSetting(key, value)) {
+        pyValue = toPythonQuotedPath(value.toString());
+    } else {
+        if (!variantToPythonLiteral(value, &pyValue))
+            return false;
+    }
+
+    switch (mode) {
+    case SettingWriteMode::TopLevel:
+        replaceTopLevelVar(script, key, pyValue);
+        return true;
+
+    case SettingWriteMode::DictAssign:
+        replaceDictAssignment(script, key, pyValue);
+        return true;
+
+    case SettingWriteMode::Unknown:
+        break;
+    }
+
+    return false;
+}
@@ -68,6 +68,11 @@ public:
     static Result parseSettingsFromText(const QString &content,
                                         const QString &scriptDir = QString(),
                                         const QString &baseName  = QString());
+
+    static QString detectSimToolKey(const QString &text, const Result *parsed = nullptr);
+
+    static bool writeSetting(QString &script, const QString &key, const QVariant &value, SettingWriteMode mode);
+    static void replaceDictAssignment(QString &script, const QString &key, const QString &pyValue);
 };
 
 #endif // PYTHONPARSER_H
@@ -20,19 +20,60 @@
 
 #include "pythonsyntaxhighlighter.h"
 
+#include <QTextDocument>
+
+/*!*******************************************************************************************************************
+ * \brief Per-block marker holding the keyword generation the block was highlighted with.
+ **********************************************************************************************************************/
+struct HighlightGenerationData : public QTextBlockUserData
+{
+    int generation = -1;
+};
+
+/*!*******************************************************************************************************************
+ * \brief Helper: finds the end of a string literal, honoring backslash escapes.
+ *
+ * \param text   Block text.
+ * \param from   Index right after the opening delimiter.
+ * \param delim  Closing delimiter (one or three quote characters).
+ * \return Index right after the closing delimiter, or -1 if the string is not closed in \a text.
+ **********************************************************************************************************************/
+static int findStringEnd(const QString &text, int from, const QString &delim)
+{
+    const int n = text.size();
+    const QChar q = delim.at(0);
+
+    for (int i = from; i < n; ++i) {
+        const QChar c = text.at(i);
+        if (c == QLatin1Char('\\')) {
+            ++i;
+            continue;
+        }
+        if (c == q && text.midRef(i, delim.size()) == delim)
+            return i + delim.size();
+    }
+    return -1;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Helper: checks whether \a c may be part of a Python identifier.
+ **********************************************************************************************************************/
+static inline bool isIdentChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_');
+}
+
 /*!*******************************************************************************************************************
  * \brief Constructs a Python syntax highlighter for the given QTextDocument.
  *
- * Initializes formatting rules for Python keywords, strings, comments, numbers,
- * and function definitions using regular expressions.
+ * Initializes the keyword set and the formats for keywords, strings, comments, numbers
+ * and function definitions.
  *
  * \param parent Pointer to the QTextDocument to apply the syntax highlighter to.
  **********************************************************************************************************************/
 PythonSyntaxHighlighter::PythonSyntaxHighlighter(QTextDocument *parent)
     : QSyntaxHighlighter(parent)
 {
-    HighlightingRule rule;
-
     m_pythonKeywords = QStringList{
         "and", "as", "assert", "break", "class", "continue", "def", "del",
         "elif", "else", "except", "False", "finally", "for", "from", "global",
@@ -59,103 +100,205 @@ PythonSyntaxHighlighter::PythonSyntaxHighlighter(QTextDocument *parent)
 
     functionFormat.setForeground(Qt::darkCyan);
     functionFormat.setFontItalic(true);
-
-    rebuildRules();
 }
 
 /*!*******************************************************************************************************************
- * \brief Applies syntax highlighting rules to the provided text block.
+ * \brief Highlights one text block in a single left-to-right pass.
  *
- * Iterates through all defined highlighting rules and applies formatting to matches
- * in the given block of text.
+ * The block starts inside a triple-quoted string if the previous block ended in one
+ * (previousBlockState()). Comments end the scan, strings are skipped as a whole, identifiers
+ * are looked up in the keyword hash sets, and the name following \c def gets the function
+ * format. The resulting string state is stored with setCurrentBlockState(), so QSyntaxHighlighter
+ * only continues into the next block when that state actually changes.
  *
  * \param text The text block to be syntax highlighted.
  **********************************************************************************************************************/
 void PythonSyntaxHighlighter::highlightBlock(const QString &text)
 {
-    for (const HighlightingRule &rule : qAsConst(highlightingRules)) {
-        QRegularExpressionMatchIterator it = rule.pattern.globalMatch(text);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            setFormat(match.capturedStart(), match.capturedLength(), rule.format);
+    auto *data = static_cast<HighlightGenerationData*>(currentBlockUserData());
+    if (!data) {
+        data = new HighlightGenerationData;
+        setCurrentBlockUserData(data);
+    }
+    data->generation = m_generation;
+
+    setCurrentBlockState(Normal);
+
+    const int n = text.size();
+    int i = 0;
+
+    const int prevState = previousBlockState();
+    if (prevState == InTripleSingle || prevState == InTripleDouble) {
+        const QString delim(3, prevState == InTripleSingle ? QLatin1Char('\'') : QLatin1Char('"'));
+        const int end = findStringEnd(text, 0, delim);
+        if (end < 0) {
+            setFormat(0, n, stringFormat);
+            setCurrentBlockState(prevState);
+            return;
         }
+        setFormat(0, end, stringFormat);
+        i = end;
+    }
+
+    bool afterDef = false;
+
+    while (i < n) {
+        const QChar c = text.at(i);
+
+        if (c == QLatin1Char('#')) {
+            setFormat(i, n - i, commentFormat);
+            break;
+        }
+
+        if (c == QLatin1Char('"') || c == QLatin1Char('\'')) {
+            const int end = highlightString(text, i, i);
+            if (end < 0)
+                return;
+            i = end;
+            afterDef = false;
+            continue;
+        }
+
+        if (c.isLetter() || c == QLatin1Char('_')) {
+            int j = i + 1;
+            while (j < n && isIdentChar(text.at(j)))
+                ++j;
+
+            const int len = j - i;
+
+            // String prefixes: r'', b"", f'', rb"", ...
+            if (len <= 2 && j < n &&
+                (text.at(j) == QLatin1Char('"') || text.at(j) == QLatin1Char('\'')) &&
+                QStringLiteral("rRbBfFuU").contains(text.at(i)) &&
+                (len == 1 || QStringLiteral("rRbBfF").contains(text.at(i + 1)))) {
+                const int end = highlightString(text, i, j);
+                if (end < 0)
+                    return;
+                i = end;
+                afterDef = false;
+                continue;
+            }
+
+            const QString word = text.mid(i, len);
+
+            if (afterDef) {
+                setFormat(i, len, functionFormat);
+                afterDef = false;
+            } else if (m_pythonKeywordSet.contains(word)) {
+                setFormat(i, len, keywordFormat);
+                afterDef = (word == QLatin1String("def"));
+            } else if (m_extraKeywordSet.contains(word)) {
+                setFormat(i, len, extraKeywordFormat);
+            }
+
+            i = j;
+            continue;
+        }
+
+        if (c.isDigit() || (c == QLatin1Char('.') && i + 1 < n && text.at(i + 1).isDigit())) {
+            int j = i + 1;
+            while (j < n) {
+                const QChar d = text.at(j);
+                if (isIdentChar(d) || d == QLatin1Char('.')) {
+                    ++j;
+                } else if ((d == QLatin1Char('+') || d == QLatin1Char('-')) &&
+                           (text.at(j - 1) == QLatin1Char('e') || text.at(j - 1) == QLatin1Char('E'))) {
+                    ++j;
+                } else {
+                    break;
+                }
+            }
+            setFormat(i, j - i, numberFormat);
+            i = j;
+            continue;
+        }
+
+        if (!c.isSpace())
+            afterDef = false;
+        ++i;
     }
 }
 
 /*!*******************************************************************************************************************
- * \brief Sets extra user-defined keywords to highlight (e.g. tips keywords).
+ * \brief Formats a string literal starting at \a start whose opening quote is at \a quotePos.
  *
- * These keywords are highlighted with lower priority than built-in Python keywords.
- * Calling this function rebuilds internal rules and triggers rehighlight().
+ * Handles single- and triple-quoted strings. An unterminated triple-quoted string is formatted
+ * to the end of the block and recorded in the block state.
  *
- * \param words List of extra keywords.
+ * \param text     Block text.
+ * \param start    Start of the literal, including any prefix such as \c r or \c f.
+ * \param quotePos Index of the opening quote.
+ * \return Index right after the literal, or -1 if the literal continues in the next block.
  **********************************************************************************************************************/
-void PythonSyntaxHighlighter::setExtraKeywords(const QStringList& words)
+int PythonSyntaxHighlighter::highlightString(const QString &text, int start, int quotePos)
 {
-    m_extraKeywords = words;
-    rebuildRules();
-    rehighlight();
+    const int n = text.size();
+    const QChar q = text.at(quotePos);
+    const QString triple(3, q);
+
+    if (text.midRef(quotePos, 3) == triple) {
+        const int end = findStringEnd(text, quotePos + 3, triple);
+        if (end < 0) {
+            setFormat(start, n - start, stringFormat);
+            setCurrentBlockState(q == QLatin1Char('\'') ? InTripleSingle : InTripleDouble);
+            return -1;
+        }
+        setFormat(start, end - start, stringFormat);
+        return end;
+    }
+
+    int end = findStringEnd(text, quotePos + 1, QString(q));
+    if (end < 0)
+        end = n;
+
+    setFormat(start, end - start, stringFormat);
+    return end;
 }
 
 /*!*******************************************************************************************************************
- * \brief Helper: builds a word-boundary regex for a single identifier.
+ * \brief Sets extra user-defined keywords to highlight (e.g. tips keywords).
+ *
+ * These keywords are highlighted with lower priority than built-in Python keywords. The
+ * document is not rehighlighted here; all blocks become stale and are refreshed lazily by
+ * rehighlightVisible() or when they are edited.
+ *
+ * \param words List of extra keywords.
  **********************************************************************************************************************/
-QRegularExpression PythonSyntaxHighlighter::makeWordRegex(const QString& word)
+void PythonSyntaxHighlighter::setExtraKeywords(const QStringList& words)
 {
-    return QRegularExpression(QStringLiteral("\\b%1\\b").arg(QRegularExpression::escape(word)));
+    m_extraKeywords = words;
+
+    m_extraKeywordSet.clear();
+    m_extraKeywordSet.reserve(words.size());
+    for (const QString& w0 : words) {
+        const QString w = w0.trimmed();
+        if (w.isEmpty() || m_pythonKeywordSet.contains(w))
+            continue;
+        m_extraKeywordSet.insert(w);
+    }
+
+    ++m_generation;
 }
 
 /*!*******************************************************************************************************************
- * \brief Rebuilds the list of highlighting rules in the correct priority order.
+ * \brief Rehighlights stale blocks between \a first and \a last (inclusive).
+ *
+ * A block is stale if it was highlighted before the last setExtraKeywords() call.
+ * Blocks that are up to date are skipped, so calling this on every scroll is cheap.
  *
- * Priority (later rules overwrite earlier if they overlap):
- *  1) strings/comments (so they can override keyword highlighting inside them)
- *  2) extra keywords (lower priority than Python keywords)
- *  3) Python keywords (highest among keywords)
- *  4) numbers, function defs, etc. (you can reorder if you want different behavior)
+ * \param first First block of the range (usually the first visible block).
+ * \param last  Last block of the range (usually the last visible block).
  **********************************************************************************************************************/
-void PythonSyntaxHighlighter::rebuildRules()
+void PythonSyntaxHighlighter::rehighlightVisible(const QTextBlock &first, const QTextBlock &last)
 {
-    highlightingRules.clear();
-    HighlightingRule rule;
+    if (!first.isValid())
+        return;
 
-    // 1) extra keywords
-    for (const QString& w0 : m_extraKeywords) {
-        const QString w = w0.trimmed();
-        if (w.isEmpty())
-            continue;
-        if (m_pythonKeywordSet.contains(w))
-            continue;
-
-        rule.pattern = makeWordRegex(w);
-        rule.format  = extraKeywordFormat;
-        highlightingRules.append(rule);
-    }
+    const int lastNumber = last.isValid() ? last.blockNumber() : first.blockNumber();
 
-    // 2) Python keywords
-    for (const QString& word : m_pythonKeywords) {
-        rule.pattern = makeWordRegex(word);
-        rule.format  = keywordFormat;
-        highlightingRules.append(rule);
+    for (QTextBlock b = first; b.isValid() && b.blockNumber() <= lastNumber; b = b.next()) {
+        const auto *data = static_cast<const HighlightGenerationData*>(b.userData());
+        if (!data || data->generation != m_generation)
+            rehighlightBlock(b);
     }
-
-    // 3) Numbers
-    rule.pattern = QRegularExpression(R"(\b[0-9]+(\.[0-9]+)?\b)");
-    rule.format  = numberFormat;
-    highlightingRules.append(rule);
-
-    // 4) Function definitions
-    rule.pattern = QRegularExpression(R"(\bdef\s+([A-Za-z_][A-Za-z0-9_]*)\b)");
-    rule.format  = functionFormat;
-    highlightingRules.append(rule);
-
-    // 5) Strings (apply late so they override keywords/numbers inside)
-    rule.pattern = QRegularExpression(R"((["'])(?:\\.|(?!\1).)*\1)");
-    rule.format  = stringFormat;
-    highlightingRules.append(rule);
-
-    // 6) Comments (LAST so they override everything inside)
-    rule.pattern = QRegularExpression(R"(#[^\n]*)");
-    rule.format  = commentFormat;
-    highlightingRules.append(rule);
 }
@@ -23,37 +23,35 @@
 
 #include <QSyntaxHighlighter>
 #include <QTextCharFormat>
-#include <QRegularExpression>
 #include <QStringList>
+#include <QTextBlock>
 #include <QSet>
-#include <QVector>
 
 /*!*******************************************************************************************************************
  * \class PythonSyntaxHighlighter
  * \brief Provides syntax highlighting for Python code in QTextDocument-based editors.
  *
- * Implements QSyntaxHighlighter to define and apply formatting rules for:
+ * Uses a single-pass lexer per block instead of one regular expression per rule. Identifiers
+ * are classified with hash-set lookups, so the cost per block does not grow with the number of
+ * keywords. Formats are applied for:
  *  - Built-in Python keywords (highest priority)
  *  - Extra keywords (e.g., tips from EMStudio keywords CSV) (lower priority)
- *  - Strings
+ *  - Strings, including triple-quoted strings spanning several blocks (tracked in block state)
  *  - Comments
  *  - Numbers
  *  - Function names
  *
- * Extra keywords are intended as a "soft" highlight layer: they should not override
- * the built-in Python keyword highlighting.
+ * Changing the extra keywords does not rehighlight the whole document. Blocks are tagged with
+ * the keyword generation they were highlighted with, and rehighlightVisible() refreshes only
+ * stale blocks in the given range; the editor calls it for the visible region.
  *
- * \see QSyntaxHighlighter, QTextCharFormat, QRegularExpression
+ * \see QSyntaxHighlighter, QTextCharFormat
  **********************************************************************************************************************/
 class PythonSyntaxHighlighter : public QSyntaxHighlighter
 {
     Q_OBJECT
 
-    struct HighlightingRule
-    {
-        QRegularExpression pattern;
-        QTextCharFormat    format;
-    };
+    enum BlockState { Normal = 0, InTripleSingle = 1, InTripleDouble = 2 };
 
 public:
     explicit PythonSyntaxHighlighter(QTextDocument *parent = nullptr);
@@ -61,21 +59,22 @@ public:
     void                        setExtraKeywords(const QStringList &words);
     QStringList                 extraKeywords() const { return m_extraKeywords; }
 
+    void                        rehighlightVisible(const QTextBlock &first, const QTextBlock &last);
+
 protected:
     void                        highlightBlock(const QString &text) override;
 
 private:
-    void                        rebuildRules();
-
-    static QRegularExpression   makeWordRegex(const QString &word);
+    int                         highlightString(const QString &text, int start, int quotePos);
 
 private:
-    QVector<HighlightingRule>   highlightingRules;
-
     QStringList                 m_pythonKeywords;
     QSet<QString>               m_pythonKeywordSet;
 
     QStringList                 m_extraKeywords;
+    QSet<QString>               m_extraKeywordSet;
+
+    int                         m_generation = 0;
 
     QTextCharFormat             keywordFormat;
     QTextCharFormat             extraKeywordFormat;
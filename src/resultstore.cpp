@@ -0,0 +1,726 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QStandardPaths>
+
+#include <algorithm>
+#include <cstring>
+
+#include "resultstore.h"
+
+const char *ResultStore::kIndexFileName = "index.json";
+const char *ResultStore::kBlockSuffix = ".emsr";
+
+namespace {
+
+const char kBlockMagic[8] = { 'E', 'M', 'S', 'R', 'B', 'L', 'K', '\0' };
+const quint32 kBlockVersion = 1;
+const int kMaxPorts = 4096;
+
+/*!*******************************************************************************************************************
+ * \brief Fixed header at the start of every block file; all offsets are in bytes from the start of the file.
+ **********************************************************************************************************************/
+struct BlockHeader
+{
+    char                        magic[8];
+    quint32                     version;
+    quint32                     ports;
+    quint64                     frequencies;
+    quint64                     referenceOffset;    // double[ports]
+    quint64                     frequencyOffset;    // double[frequencies]
+    quint64                     valueOffset;        // Complex[ports * ports][frequencies]
+    quint64                     reserved[2];
+};
+
+static_assert(sizeof(BlockHeader) == 64, "block header must stay 64 bytes");
+
+/*!*******************************************************************************************************************
+ * \brief Read-only memory mapping of one block file; the mapping is released with the object.
+ **********************************************************************************************************************/
+class MappedBlock
+{
+public:
+    ~MappedBlock()
+    {
+        if (m_data)
+            m_file.unmap(m_data);
+    }
+
+    bool open(const QString &path, QString &outError)
+    {
+        m_file.setFileName(path);
+        if (!m_file.open(QIODevice::ReadOnly)) {
+            outError = QString("Cannot open result block %1").arg(QDir::toNativeSeparators(path));
+            return false;
+        }
+
+        const quint64 size = quint64(m_file.size());
+        if (size >= sizeof(BlockHeader))
+            m_data = m_file.map(0, qint64(size));
+        if (!m_data) {
+            outError = QString("Cannot map result block %1").arg(QDir::toNativeSeparators(path));
+            return false;
+        }
+
+        std::memcpy(&m_header, m_data, sizeof(BlockHeader));
+        const quint64 ports = m_header.ports;
+        const quint64 nf = m_header.frequencies;
+        const bool valid = std::memcmp(m_header.magic, kBlockMagic, sizeof(kBlockMagic)) == 0 &&
+                           m_header.version == kBlockVersion && ports > 0 && ports <= quint64(kMaxPorts) &&
+                           nf > 0 && nf <= size / sizeof(double) &&
+                           m_header.referenceOffset <= size && m_header.frequencyOffset <= size &&
+                           m_header.valueOffset <= size &&
+                           ports <= (size - m_header.referenceOffset) / sizeof(double) &&
+                           nf <= (size - m_header.frequencyOffset) / sizeof(double) &&
+                           ports * ports <= (size - m_header.valueOffset) / sizeof(Touchstone::Complex) / nf;
+        if (!valid) {
+            outError = QString("Invalid or incompatible result block %1").arg(QDir::toNativeSeparators(path));
+            return false;
+        }
+        return true;
+    }
+
+    int ports() const { return int(m_header.ports); }
+    int frequencyCount() const { return int(m_header.frequencies); }
+
+    void references(QVector<double> &out) const
+    {
+        out.resize(ports());
+        std::memcpy(out.data(), m_data + m_header.referenceOffset, size_t(out.size()) * sizeof(double));
+    }
+
+    void frequencies(QVector<double> &out) const
+    {
+        out.resize(frequencyCount());
+        std::memcpy(out.data(), m_data + m_header.frequencyOffset, size_t(out.size()) * sizeof(double));
+    }
+
+    // Copies the column of entry S[row][column] (index row * ports + column).
+    void entry(int index, QVector<Touchstone::Complex> &out) const
+    {
+        const size_t bytes = size_t(frequencyCount()) * sizeof(Touchstone::Complex);
+        out.resize(frequencyCount());
+        std::memcpy(out.data(), m_data + m_header.valueOffset + size_t(index) * bytes, bytes);
+    }
+
+private:
+    QFile                       m_file;
+    uchar                      *m_data = nullptr;
+    BlockHeader                 m_header;
+};
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Creates a store rooted at the given folder.
+ *
+ * \param rootDir Folder holding the index and the block files; empty selects defaultRootDir().
+ **********************************************************************************************************************/
+ResultStore::ResultStore(const QString &rootDir)
+    : m_rootDir(rootDir.isEmpty() ? defaultRootDir() : rootDir)
+{
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the per-user location of the result store.
+ **********************************************************************************************************************/
+QString ResultStore::defaultRootDir()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+        .filePath(QStringLiteral("result_store"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the path of the JSON index of the store.
+ **********************************************************************************************************************/
+QString ResultStore::indexPath() const
+{
+    return QDir(m_rootDir).filePath(QLatin1String(kIndexFileName));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the path of the block file of a run.
+ **********************************************************************************************************************/
+QString ResultStore::blockPath(const QString &runId) const
+{
+    return QDir(m_rootDir).filePath(runId + QLatin1String(kBlockSuffix));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds the network of a finished run to the store.
+ *
+ * The block file is written first; the run becomes visible to queries once the index is saved.
+ *
+ * \param network  S-parameters of the run.
+ * \param info     Metadata of the run; receives the new run id, the creation time (if unset) and the port and
+ *                 frequency count.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ResultStore::ingest(const Touchstone::Network &network, RunInfo &info, QString &outError)
+{
+    if (!network.isValid() || network.ports > kMaxPorts) {
+        outError = QStringLiteral("Cannot store an empty or invalid network");
+        return false;
+    }
+
+    loadIndex();
+
+    if (!QDir().mkpath(m_rootDir)) {
+        outError = QString("Cannot create result store %1").arg(QDir::toNativeSeparators(m_rootDir));
+        return false;
+    }
+
+    if (!info.created.isValid())
+        info.created = QDateTime::currentDateTime();
+    info.ports = network.ports;
+    info.frequencies = network.frequencyCount();
+
+    const QString stamp = info.created.toUTC().toString(QStringLiteral("yyyyMMdd-HHmmsszzz"));
+    info.id = stamp;
+    for (int n = 2; QFileInfo::exists(blockPath(info.id)) || run(info.id).isValid(); ++n)
+        info.id = QString("%1-%2").arg(stamp).arg(n);
+
+    const int ports = network.ports;
+    const int nf = network.frequencyCount();
+    const int entries = ports * ports;
+
+    BlockHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kBlockMagic, sizeof(kBlockMagic));
+    header.version         = kBlockVersion;
+    header.ports           = quint32(ports);
+    header.frequencies     = quint64(nf);
+    header.referenceOffset = sizeof(BlockHeader);
+    header.frequencyOffset = header.referenceOffset + quint64(ports) * sizeof(double);
+    header.valueOffset     = header.frequencyOffset + quint64(nf) * sizeof(double);
+
+    QVector<double> references = network.references;
+    if (references.size() != ports)
+        references.fill(50.0, ports);
+
+    const QString path = blockPath(info.id);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write result block %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(references.constData()), qint64(ports) * qint64(sizeof(double)));
+    file.write(reinterpret_cast<const char *>(network.frequencies.constData()), qint64(nf) * qint64(sizeof(double)));
+
+    // Transpose [frequency][entry] into one contiguous column per entry.
+    QVector<Touchstone::Complex> column(nf);
+    const Touchstone::Complex *values = network.values.constData();
+    for (int e = 0; e < entries; ++e) {
+        for (int f = 0; f < nf; ++f)
+            column[f] = values[size_t(f) * size_t(entries) + size_t(e)];
+        file.write(reinterpret_cast<const char *>(column.constData()),
+                   qint64(nf) * qint64(sizeof(Touchstone::Complex)));
+    }
+
+    if (!file.commit()) {
+        outError = QString("Cannot write result block %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    m_runs.append(info);
+    if (!saveIndex(outError)) {
+        m_runs.removeLast();
+        QFile::remove(path);
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Removes a run and its block file from the store; a golden mark on the run is dropped as well.
+ *
+ * \return False if the index could not be written; removing an unknown run succeeds.
+ **********************************************************************************************************************/
+bool ResultStore::remove(const QString &runId, QString &outError)
+{
+    loadIndex();
+
+    bool found = false;
+    for (int i = m_runs.size() - 1; i >= 0; --i) {
+        if (m_runs.at(i).id == runId) {
+            m_runs.removeAt(i);
+            found = true;
+        }
+    }
+    for (auto it = m_golden.begin(); it != m_golden.end();) {
+        if (it.value() == runId)
+            it = m_golden.erase(it);
+        else
+            ++it;
+    }
+
+    if (!found)
+        return true;
+
+    QFile::remove(blockPath(runId));
+    return saveIndex(outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the stored runs, newest first.
+ *
+ * \param cell  Only runs of this cell; empty returns the runs of all cells.
+ * \param limit Maximum number of runs; negative returns all.
+ **********************************************************************************************************************/
+QList<ResultStore::RunInfo> ResultStore::runs(const QString &cell, int limit) const
+{
+    loadIndex();
+
+    QList<RunInfo> result;
+    for (int i = m_runs.size() - 1; i >= 0 && (limit < 0 || result.size() < limit); --i) {
+        if (cell.isEmpty() || m_runs.at(i).cell == cell)
+            result.append(m_runs.at(i));
+    }
+    return result;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the metadata of a run, or an invalid entry if the run is not stored.
+ **********************************************************************************************************************/
+ResultStore::RunInfo ResultStore::run(const QString &runId) const
+{
+    loadIndex();
+
+    for (const RunInfo &info : qAsConst(m_runs)) {
+        if (info.id == runId)
+            return info;
+    }
+    return RunInfo();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the complete network of a stored run.
+ *
+ * \param runId    Run to read.
+ * \param out      Receives the network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ResultStore::readNetwork(const QString &runId, Touchstone::Network &out, QString &outError) const
+{
+    MappedBlock block;
+    if (!block.open(blockPath(runId), outError))
+        return false;
+
+    const int ports = block.ports();
+    const int nf = block.frequencyCount();
+    const int entries = ports * ports;
+
+    out = Touchstone::Network();
+    block.references(out.references);
+    out.resize(ports, nf);
+    block.frequencies(out.frequencies);
+
+    QVector<Touchstone::Complex> column;
+    for (int e = 0; e < entries; ++e) {
+        block.entry(e, column);
+        for (int f = 0; f < nf; ++f)
+            out.values[f * entries + e] = column.at(f);
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads one matrix entry S[row][column] of a stored run over all frequencies.
+ *
+ * \param runId    Run to read.
+ * \param row      Zero-based row (receiving port).
+ * \param column   Zero-based column (excited port).
+ * \param out      Receives the frequencies and values.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool ResultStore::readTrace(const QString &runId, int row, int column, Trace &out, QString &outError) const
+{
+    MappedBlock block;
+    if (!block.open(blockPath(runId), outError))
+        return false;
+
+    if (row < 0 || column < 0 || row >= block.ports() || column >= block.ports()) {
+        outError = QString("Run %1 has no S%2%3 (%4 ports)").arg(runId).arg(row + 1).arg(column + 1)
+                       .arg(block.ports());
+        return false;
+    }
+
+    out.runId = runId;
+    block.frequencies(out.frequencies);
+    block.entry(row * block.ports() + column, out.values);
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns one matrix entry of the latest runs of a cell, newest first, e.g. to overlay S21 of the last
+ *        20 runs. Runs whose block cannot be read or that lack the entry are left out.
+ **********************************************************************************************************************/
+QList<ResultStore::Trace> ResultStore::overlay(const QString &cell, int row, int column, int limit) const
+{
+    QList<Trace> traces;
+    QString err;
+    for (const RunInfo &info : runs(cell, limit)) {
+        Trace trace;
+        if (readTrace(info.id, row, column, trace, err))
+            traces.append(trace);
+    }
+    return traces;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Marks a run as the golden reference of a cell.
+ *
+ * \return False if the run is not stored or the index could not be written.
+ **********************************************************************************************************************/
+bool ResultStore::setGolden(const QString &cell, const QString &runId, QString &outError)
+{
+    if (!run(runId).isValid()) {
+        outError = QString("Unknown run %1").arg(runId);
+        return false;
+    }
+
+    m_golden.insert(cell, runId);
+    return saveIndex(outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the id of the golden run of a cell, or an empty string.
+ **********************************************************************************************************************/
+QString ResultStore::golden(const QString &cell) const
+{
+    loadIndex();
+    return m_golden.value(cell);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Computes the largest deviation |S_run - S_reference| of a run from a reference run.
+ *
+ * The reference is linearly interpolated onto the frequencies of the run; run frequencies outside the reference
+ * sweep are ignored. Frequencies of both runs must be ascending, as in Touchstone files.
+ *
+ * \param runId       Run to check.
+ * \param referenceId Reference run, e.g. the golden run of the cell.
+ * \param out         Receives the largest deviation and where it occurs.
+ * \param outError    Human-readable error message in case of failure.
+ * \return True on success; false if a block cannot be read, the port counts differ or the sweeps do not overlap.
+ **********************************************************************************************************************/
+bool ResultStore::compare(const QString &runId, const QString &referenceId, Deviation &out, QString &outError) const
+{
+    MappedBlock block;
+    MappedBlock reference;
+    if (!block.open(blockPath(runId), outError) || !reference.open(blockPath(referenceId), outError))
+        return false;
+
+    if (block.ports() != reference.ports()) {
+        outError = QString("Runs %1 and %2 have different port counts").arg(runId, referenceId);
+        return false;
+    }
+
+    QVector<double> freqs;
+    QVector<double> refFreqs;
+    block.frequencies(freqs);
+    reference.frequencies(refFreqs);
+
+    // Interpolation interval and weight of every run frequency, computed once for all entries.
+    struct Sample
+    {
+        int                     index;      // run frequency
+        int                     lower;      // reference frequency at or below it
+        double                  weight;     // of reference frequency lower + 1
+    };
+
+    QVector<Sample> samples;
+    samples.reserve(freqs.size());
+    for (int i = 0; i < freqs.size(); ++i) {
+        const double f = freqs.at(i);
+        if (f < refFreqs.first() || f > refFreqs.last())
+            continue;
+
+        const int upper = int(std::upper_bound(refFreqs.constBegin(), refFreqs.constEnd(), f) - refFreqs.constBegin());
+        const int lower = qMax(0, upper - 1);
+        const double span = upper < refFreqs.size() ? refFreqs.at(upper) - refFreqs.at(lower) : 0.0;
+        samples.append({ i, lower, span > 0.0 ? (f - refFreqs.at(lower)) / span : 0.0 });
+    }
+
+    if (samples.isEmpty()) {
+        outError = QString("Runs %1 and %2 have no frequencies in common").arg(runId, referenceId);
+        return false;
+    }
+
+    out = Deviation();
+    out.runId = runId;
+    out.referenceId = referenceId;
+
+    const int ports = block.ports();
+    const int last = refFreqs.size() - 1;
+    QVector<Touchstone::Complex> values;
+    QVector<Touchstone::Complex> refValues;
+    for (int e = 0; e < ports * ports; ++e) {
+        block.entry(e, values);
+        reference.entry(e, refValues);
+
+        for (const Sample &s : qAsConst(samples)) {
+            Touchstone::Complex expected = refValues.at(s.lower);
+            if (s.weight > 0.0 && s.lower < last)
+                expected += s.weight * (refValues.at(s.lower + 1) - expected);
+
+            const double deviation = std::abs(values.at(s.index) - expected);
+            if (deviation > out.maxDeviation) {
+                out.maxDeviation = deviation;
+                out.frequency    = freqs.at(s.index);
+                out.row          = e / ports;
+                out.column       = e % ports;
+            }
+        }
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Compares the latest runs of a cell with its golden run, newest first.
+ *
+ * \return One entry per run that could be compared; empty if the cell has no golden run.
+ **********************************************************************************************************************/
+QList<ResultStore::Deviation> ResultStore::deviationsFromGolden(const QString &cell, int limit) const
+{
+    QList<Deviation> deviations;
+    const QString reference = golden(cell);
+    if (reference.isEmpty())
+        return deviations;
+
+    QString err;
+    for (const RunInfo &info : runs(cell, limit)) {
+        Deviation d;
+        if (info.id != reference && compare(info.id, reference, d, err))
+            deviations.append(d);
+    }
+    return deviations;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Lists the latest runs of a cell as CSV, newest first, with their deviation from the golden run.
+ *
+ * The fixed columns are followed by one "<stage>_s" column per stage name found in any listed run and by the
+ * largest deviation from the golden run, the entry and the frequency where it occurs (empty for the golden run
+ * itself and if the cell has none).
+ *
+ * \param cell  Cell to list; empty lists the runs of all cells.
+ * \param limit Maximum number of runs; negative lists all.
+ * \return CSV text with a header row.
+ **********************************************************************************************************************/
+QByteArray ResultStore::summaryCsv(const QString &cell, int limit) const
+{
+    const QList<RunInfo> list = runs(cell, limit);
+
+    QStringList stageNames;
+    for (const RunInfo &info : list) {
+        for (auto it = info.stageMs.constBegin(); it != info.stageMs.constEnd(); ++it) {
+            if (!stageNames.contains(it.key()))
+                stageNames << it.key();
+        }
+    }
+
+    QStringList header;
+    header << "id" << "created" << "cell" << "sim_key" << "ports" << "frequencies";
+    for (const QString &name : qAsConst(stageNames))
+        header << name + QStringLiteral("_s");
+    header << "golden" << "max_deviation" << "deviation_entry" << "deviation_ghz" << "fingerprint";
+
+    QByteArray out = header.join(QLatin1Char(',')).toUtf8() + '\n';
+    for (const RunInfo &info : list) {
+        const QString reference = golden(info.cell);
+
+        QStringList fields;
+        fields << info.id << info.created.toString(Qt::ISODate) << info.cell << info.simKey
+               << QString::number(info.ports) << QString::number(info.frequencies);
+        for (const QString &name : qAsConst(stageNames))
+            fields << (info.stageMs.contains(name) ? QString::number(info.stageMs.value(name) / 1000.0, 'f', 3)
+                                                   : QString());
+        fields << (info.id == reference ? QStringLiteral("1") : QStringLiteral("0"));
+
+        Deviation d;
+        QString err;
+        if (!reference.isEmpty() && info.id != reference && compare(info.id, reference, d, err))
+            fields << QString::number(d.maxDeviation, 'g', 6)
+                   << QString("S%1%2").arg(d.row + 1).arg(d.column + 1)
+                   << QString::number(d.frequency / 1e9, 'g', 9);
+        else
+            fields << QString() << QString() << QString();
+        fields << info.fingerprint;
+
+        for (QString &field : fields) {
+            if (field.contains(QLatin1Char(',')) || field.contains(QLatin1Char('"')))
+                field = QLatin1Char('"') + QString(field).replace(QLatin1Char('"'), QStringLiteral("\"\"")) +
+                        QLatin1Char('"');
+        }
+        out += fields.join(QLatin1Char(',')).toUtf8() + '\n';
+    }
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Builds the metadata of a run from its run report (see RunReport::toJson()).
+ *
+ * The cell is the base name of the model; stage durations of repeated stages are summed.
+ **********************************************************************************************************************/
+ResultStore::RunInfo ResultStore::infoFromReport(const QJsonObject &report)
+{
+    RunInfo info;
+    info.cell        = QFileInfo(report.value(QStringLiteral("model")).toString()).completeBaseName();
+    info.simKey      = report.value(QStringLiteral("sim_key")).toString();
+    info.fingerprint = report.value(QStringLiteral("fingerprints")).toObject().value(QStringLiteral("run")).toString();
+    info.created     = QDateTime::fromString(report.value(QStringLiteral("started")).toString(), Qt::ISODateWithMs);
+
+    for (const QJsonValue &v : report.value(QStringLiteral("stages")).toArray()) {
+        const QJsonObject stage = v.toObject();
+        info.stageMs[stage.value(QStringLiteral("name")).toString()] +=
+            qint64(stage.value(QStringLiteral("duration_ms")).toDouble());
+    }
+    return info;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Loads the index unless the cached copy is up to date; a missing or unreadable index is an empty store.
+ **********************************************************************************************************************/
+void ResultStore::loadIndex() const
+{
+    const QFileInfo fi(indexPath());
+    if (!fi.isFile()) {
+        m_runs.clear();
+        m_golden.clear();
+        m_indexSize = -1;
+        return;
+    }
+
+    if (fi.size() == m_indexSize && fi.lastModified() == m_indexModified)
+        return;
+
+    m_runs.clear();
+    m_golden.clear();
+    m_indexSize = fi.size();
+    m_indexModified = fi.lastModified();
+
+    QFile f(fi.absoluteFilePath());
+    if (!f.open(QIODevice::ReadOnly))
+        return;
+
+    const QJsonObject index = QJsonDocument::fromJson(f.readAll()).object();
+    for (const QJsonValue &v : index.value(QStringLiteral("runs")).toArray()) {
+        const RunInfo info = fromJson(v.toObject());
+        if (info.isValid())
+            m_runs.append(info);
+    }
+
+    const QJsonObject golden = index.value(QStringLiteral("golden")).toObject();
+    for (auto it = golden.constBegin(); it != golden.constEnd(); ++it)
+        m_golden.insert(it.key(), it.value().toString());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the cached index and remembers its file stamp, so the next query does not reload it.
+ **********************************************************************************************************************/
+bool ResultStore::saveIndex(QString &outError) const
+{
+    QJsonArray runs;
+    for (const RunInfo &info : qAsConst(m_runs))
+        runs.append(toJson(info));
+
+    QJsonObject golden;
+    for (auto it = m_golden.constBegin(); it != m_golden.constEnd(); ++it)
+        golden.insert(it.key(), it.value());
+
+    QJsonObject index;
+    index.insert(QStringLiteral("version"), 1);
+    index.insert(QStringLiteral("runs"), runs);
+    index.insert(QStringLiteral("golden"), golden);
+
+    QDir().mkpath(m_rootDir);
+
+    QSaveFile f(indexPath());
+    if (!f.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write result store index %1").arg(QDir::toNativeSeparators(indexPath()));
+        return false;
+    }
+
+    f.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        outError = QString("Cannot write result store index %1").arg(QDir::toNativeSeparators(indexPath()));
+        return false;
+    }
+
+    const QFileInfo fi(indexPath());
+    m_indexSize = fi.size();
+    m_indexModified = fi.lastModified();
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Serializes the metadata of a run for the index.
+ **********************************************************************************************************************/
+QJsonObject ResultStore::toJson(const RunInfo &info)
+{
+    QJsonObject stages;
+    for (auto it = info.stageMs.constBegin(); it != info.stageMs.constEnd(); ++it)
+        stages.insert(it.key(), double(it.value()));
+
+    QJsonObject o;
+    o["id"]          = info.id;
+    o["cell"]        = info.cell;
+    o["sim_key"]     = info.simKey;
+    o["fingerprint"] = info.fingerprint;
+    o["source"]      = info.source;
+    o["created"]     = info.created.toString(Qt::ISODateWithMs);
+    o["ports"]       = info.ports;
+    o["frequencies"] = info.frequencies;
+    o["stages_ms"]   = stages;
+    return o;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the metadata of a run from the index.
+ **********************************************************************************************************************/
+ResultStore::RunInfo ResultStore::fromJson(const QJsonObject &o)
+{
+    RunInfo info;
+    info.id          = o.value(QStringLiteral("id")).toString();
+    info.cell        = o.value(QStringLiteral("cell")).toString();
+    info.simKey      = o.value(QStringLiteral("sim_key")).toString();
+    info.fingerprint = o.value(QStringLiteral("fingerprint")).toString();
+    info.source      = o.value(QStringLiteral("source")).toString();
+    info.created     = QDateTime::fromString(o.value(QStringLiteral("created")).toString(), Qt::ISODateWithMs);
+    info.ports       = o.value(QStringLiteral("ports")).toInt();
+    info.frequencies = o.value(QStringLiteral("frequencies")).toInt();
+
+    const QJsonObject stages = o.value(QStringLiteral("stages_ms")).toObject();
+    for (auto it = stages.constBegin(); it != stages.constEnd(); ++it)
+        info.stageMs.insert(it.key(), qint64(it.value().toDouble()));
+    return info;
+}
@@ -0,0 +1,132 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef RESULTSTORE_H
+#define RESULTSTORE_H
+
+#include <QMap>
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QDateTime>
+#include <QJsonObject>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class ResultStore
+ * \brief Local columnar store of the S-parameters of all finished runs, for fast comparison across runs.
+ *
+ * Every ingested run gets one binary block file, written once and memory-mapped on read:
+ *  - a fixed 64-byte header (magic, version, port and frequency count, section offsets),
+ *  - the port reference impedances and the frequencies (Hz) as doubles,
+ *  - one column per matrix entry S[row][column]: the complex values of all frequencies, contiguous.
+ *
+ * Reading one trace (e.g. S21) of a run therefore copies a single contiguous slice of the mapped file, without
+ * parsing or touching the other entries. The metadata of all runs (cell, sim key, run fingerprint, stage
+ * timings from run_report.json, source file) lives in a JSON index next to the blocks, which is cached in memory
+ * and reloaded only when the file changed. Per cell, one run can be marked as golden reference.
+ *
+ * The store lives in the application data folder by default (defaultRootDir()); SimulationRunner ingests the
+ * results of every successful run (RESULT_STORE preference).
+ **********************************************************************************************************************/
+class ResultStore
+{
+public:
+    struct RunInfo
+    {
+        QString                 id;
+        QString                 cell;               // model name, e.g. the base name of the Python model
+        QString                 simKey;
+        QString                 fingerprint;        // run key of the RunCache, if known
+        QString                 source;             // result file the run was ingested from
+        QDateTime               created;
+        int                     ports = 0;
+        int                     frequencies = 0;
+        QMap<QString, qint64>   stageMs;            // stage name -> duration
+
+        bool                    isValid() const { return !id.isEmpty(); }
+    };
+
+    struct Trace
+    {
+        QString                 runId;
+        QVector<double>         frequencies;        // Hz
+        QVector<Touchstone::Complex> values;
+    };
+
+    struct Deviation
+    {
+        QString                 runId;
+        QString                 referenceId;
+        double                  maxDeviation = -1.0;    // largest |S_run - S_reference| over all entries
+        double                  frequency = 0.0;        // Hz, where the largest deviation occurs
+        int                     row = -1;
+        int                     column = -1;
+    };
+
+    explicit ResultStore(const QString &rootDir = QString());
+
+    QString                     rootDir() const { return m_rootDir; }
+    QString                     indexPath() const;
+
+    bool                        ingest(const Touchstone::Network &network, RunInfo &info, QString &outError);
+    bool                        remove(const QString &runId, QString &outError);
+
+    QList<RunInfo>              runs(const QString &cell = QString(), int limit = -1) const;
+    RunInfo                     run(const QString &runId) const;
+
+    bool                        readNetwork(const QString &runId, Touchstone::Network &out, QString &outError) const;
+    bool                        readTrace(const QString &runId, int row, int column, Trace &out,
+                                          QString &outError) const;
+    QList<Trace>                overlay(const QString &cell, int row, int column, int limit) const;
+
+    bool                        setGolden(const QString &cell, const QString &runId, QString &outError);
+    QString                     golden(const QString &cell) const;
+
+    bool                        compare(const QString &runId, const QString &referenceId, Deviation &out,
+                                        QString &outError) const;
+    QList<Deviation>            deviationsFromGolden(const QString &cell, int limit) const;
+    QByteArray                  summaryCsv(const QString &cell, int limit) const;
+
+    static RunInfo              infoFromReport(const QJsonObject &report);
+    static QString              defaultRootDir();
+
+    static const char          *kIndexFileName;
+    static const char          *kBlockSuffix;
+
+private:
+    void                        loadIndex() const;
+    bool                        saveIndex(QString &outError) const;
+    QString                     blockPath(const QString &runId) const;
+
+    static QJsonObject          toJson(const RunInfo &info);
+    static RunInfo              fromJson(const QJsonObject &o);
+
+private:
+    QString                     m_rootDir;
+
+    mutable QList<RunInfo>      m_runs;             // oldest first
+    mutable QMap<QString, QString> m_golden;        // cell -> run id
+    mutable QDateTime           m_indexModified;
+    mutable qint64              m_indexSize = -1;
+};
+
+#endif // RESULTSTORE_H
@@ -0,0 +1,215 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFileInfo>
+#include <QInputDialog>
+
+#include "mainwindow.h"
+#include "simulationlog.h"
+#include "parametersweep.h"
+#include "simulationqueue.h"
+#include "ui_mainwindow.h"
+
+/*!*******************************************************************************************************************
+ * \brief Applies the GUI pre-steps of an interactive run and saves the model for queued execution.
+ *
+ * \param[out] outKey Backend key of the model.
+ * \return True if the model was saved and can be queued; false otherwise (an error has been reported).
+ **********************************************************************************************************************/
+bool MainWindow::prepareModelForQueue(QString &outKey)
+{
+    outKey = runToolKeyForCurrentModel();
+    if (outKey.isEmpty()) {
+        error("No simulation tool selected/configured.");
+        return false;
+    }
+
+    if (outKey == QLatin1String("elmer")) {
+        m_simSettings[QStringLiteral("elmer")] = true;
+        m_simSettings[QStringLiteral("iterative")] = true;
+    }
+
+    if (outKey != QLatin1String("openems"))
+        syncGuiSettingsToPythonEditor();
+    on_actionSave_triggered();
+
+    const QString scriptPath = m_simSettings.value("RunPythonScript").toString().trimmed();
+    if (scriptPath.isEmpty() || !QFileInfo::exists(scriptPath)) {
+        error("Save the Python model before adding it to the run queue.");
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Saves the current model and adds it to the run queue.
+ *
+ * Applies the same GUI pre-steps as an interactive run and enqueues a snapshot of the current simulation
+ * settings and preferences. The queue dispatches the job as soon as enough cores of its budget are free,
+ * so several models can be queued and simulated concurrently. With PIPELINE_PREPROCESSING enabled, the
+ * gds2palace stage of the next model runs while the solver of the current one is busy.
+ **********************************************************************************************************************/
+void MainWindow::on_btnQueue_clicked()
+{
+    QString key;
+    if (!prepareModelForQueue(key))
+        return;
+
+    const QString scriptPath = m_simSettings.value("RunPythonScript").toString().trimmed();
+
+    SimulationQueue::JobSpec spec;
+    spec.name        = QFileInfo(scriptPath).completeBaseName();
+    spec.simKey      = key;
+    spec.simSettings = m_simSettings;
+    spec.preferences = m_preferences;
+
+    m_queue->applyPreferences(m_preferences);
+    const int id = m_queue->enqueue(spec);
+    info(QString("Queued job %1: %2 (%3)").arg(id).arg(spec.name, key), false);
+
+    m_ui->dockQueue->show();
+    m_ui->dockQueue->raise();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Runs a parameter sweep over the current model.
+ *
+ * Asks for a sweep definition (see ParameterSweep), writes one model variant per distinct combination
+ * and queues all variants. When every variant has finished, the Touchstone results and a summary table
+ * are collected into the "<model>_sweep" folder.
+ **********************************************************************************************************************/
+void MainWindow::on_actionParameter_Sweep_triggered()
+{
+    bool ok = false;
+    const QString definition = QInputDialog::getMultiLineText(
+        this, tr("Parameter Sweep"),
+        tr("One setting per line, e.g.\n"
+           "  cells_per_wavelength = 10, 20, 40\n"
+           "  fstep = 1e9:1e9:5e9   (start:step:stop)\n"
+           "  mode = listed         (zip the lists instead of all combinations)"),
+        m_sysSettings.value("SweepDefinition").toString(), &ok);
+    if (!ok || definition.trimmed().isEmpty())
+        return;
+
+    m_sysSettings["SweepDefinition"] = definition;
+
+    QString key;
+    if (!prepareModelForQueue(key))
+        return;
+
+    m_queue->applyPreferences(m_preferences);
+
+    auto *sweep = new ParameterSweep(this);
+    QString err;
+    if (!sweep->parseDefinition(definition, err) ||
+        !sweep->generate(m_simSettings.value("RunPythonScript").toString(), err) ||
+        !sweep->dispatch(m_queue, key, m_simSettings, m_preferences, err)) {
+        error(err);
+        sweep->deleteLater();
+        return;
+    }
+
+    connect(sweep, &ParameterSweep::finished, this, [this, sweep](const QString &summaryPath) {
+        info(QString("Parameter sweep finished, results collected in %1")
+                 .arg(QDir::toNativeSeparators(QFileInfo(summaryPath).absolutePath())), false);
+        sweep->deleteLater();
+    });
+
+    info(QString("Queued parameter sweep with %1 variants.").arg(sweep->variants().size()), false);
+
+    m_ui->dockQueue->show();
+    m_ui->dockQueue->raise();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Cancels the job selected in the run queue table.
+ **********************************************************************************************************************/
+void MainWindow::on_btnCancelJob_clicked()
+{
+    const QList<QTableWidgetItem*> sel = m_ui->tblQueue->selectedItems();
+    if (sel.isEmpty()) {
+        info("No queued job selected.", false);
+        return;
+    }
+
+    const int id = m_ui->tblQueue->item(sel.first()->row(), 0)->data(Qt::UserRole).toInt();
+    if (!m_queue->cancel(id))
+        info(QString("Job %1 is not queued or running.").arg(id), false);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds or updates the run queue table row of a job.
+ *
+ * \param id Job id.
+ **********************************************************************************************************************/
+void MainWindow::onQueueJobChanged(int id)
+{
+    const SimulationQueue::JobInfo job = m_queue->jobInfo(id);
+
+    int row = queueRowForJob(id);
+    if (row < 0) {
+        row = m_ui->tblQueue->rowCount();
+        m_ui->tblQueue->insertRow(row);
+        for (int col = 0; col < m_ui->tblQueue->columnCount(); ++col)
+            m_ui->tblQueue->setItem(row, col, new QTableWidgetItem);
+        m_ui->tblQueue->item(row, 0)->setData(Qt::UserRole, id);
+    }
+
+    m_ui->tblQueue->item(row, 0)->setText(QString::number(id));
+    m_ui->tblQueue->item(row, 1)->setText(job.name);
+    m_ui->tblQueue->item(row, 1)->setToolTip(QDir::toNativeSeparators(job.scriptPath));
+    m_ui->tblQueue->item(row, 2)->setText(job.simKey);
+    m_ui->tblQueue->item(row, 3)->setText(job.cores > 0 ? QString::number(job.cores) : QString());
+
+    QString state = SimulationQueue::stateName(job.state);
+    if (job.state == SimulationQueue::JobState::Failed)
+        state += QString(" (%1)").arg(job.exitCode);
+    m_ui->tblQueue->item(row, 4)->setText(state);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Shows the collected output of a queued job in the simulation log and follows its live output.
+ *
+ * \param id Job id.
+ **********************************************************************************************************************/
+void MainWindow::showQueueJob(int id)
+{
+    if (id == m_shownQueueJob || !m_queue->hasJob(id))
+        return;
+
+    m_shownQueueJob = id;
+    m_simLog->clear();
+    m_simLog->append(m_queue->jobLog(id));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the run queue table row of a job, or -1 if the job has no row yet.
+ **********************************************************************************************************************/
+int MainWindow::queueRowForJob(int id) const
+{
+    for (int row = 0; row < m_ui->tblQueue->rowCount(); ++row) {
+        const QTableWidgetItem *item = m_ui->tblQueue->item(row, 0);
+        if (item && item->data(Qt::UserRole).toInt() == id)
+            return row;
+    }
+    return -1;
+}
@@ -0,0 +1,462 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QHash>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QDirIterator>
+#include <QJsonDocument>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QRegularExpression>
+
+#include "runcache.h"
+
+const char *RunCache::kStampFileName = ".emstudio_run_cache";
+
+/*!*******************************************************************************************************************
+ * \brief Creates a cache backed by the given index file.
+ *
+ * \param indexPath Path of the JSON index; empty selects defaultIndexPath().
+ **********************************************************************************************************************/
+RunCache::RunCache(const QString &indexPath)
+    : m_indexPath(indexPath.isEmpty() ? defaultIndexPath() : indexPath)
+{
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the per-user location of the run cache index.
+ **********************************************************************************************************************/
+QString RunCache::defaultIndexPath()
+{
+    return QDir(QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation))
+        .filePath(QStringLiteral("run_cache.json"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Looks up the complete results of a run with the same run key.
+ *
+ * \param key Fingerprint of the run about to start.
+ * \return The cached run directory and its result files, or an invalid entry if the run directory was
+ *         overwritten since or one of the recorded result files is missing or has changed size.
+ **********************************************************************************************************************/
+RunCache::Entry RunCache::lookupResults(const Key &key) const
+{
+    Entry entry;
+    if (!key.isValid())
+        return entry;
+
+    const QJsonObject run = loadIndex().value(QStringLiteral("runs")).toObject().value(key.run).toObject();
+    const QString runDir = run.value(QStringLiteral("dir")).toString();
+    if (runDir.isEmpty() || readStamp(runDir).value(QStringLiteral("run")).toString() != key.run)
+        return entry;
+
+    const QJsonArray results = run.value(QStringLiteral("results")).toArray();
+    if (results.isEmpty())
+        return entry;
+
+    QStringList files;
+    for (const QJsonValue &v : results) {
+        const QJsonObject r = v.toObject();
+        const QFileInfo fi(QDir(runDir).filePath(r.value(QStringLiteral("path")).toString()));
+        if (!fi.isFile() || fi.size() != qint64(r.value(QStringLiteral("size")).toDouble()))
+            return entry;
+        files << fi.absoluteFilePath();
+    }
+
+    entry.runDir  = runDir;
+    entry.results = files;
+    return entry;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Looks up a run directory whose preprocessing (mesh and solver input) was done with the same inputs.
+ *
+ * \param key Fingerprint of the run about to start.
+ * \return The cached run directory, or an invalid entry if there is none or it was overwritten since.
+ **********************************************************************************************************************/
+RunCache::Entry RunCache::lookupPreprocessed(const Key &key) const
+{
+    Entry entry;
+    if (key.prep.isEmpty())
+        return entry;
+
+    const QString runDir = loadIndex().value(QStringLiteral("prep")).toObject().value(key.prep).toString();
+    if (runDir.isEmpty() || readStamp(runDir).value(QStringLiteral("prep")).toString() != key.prep)
+        return entry;
+
+    entry.runDir = runDir;
+    return entry;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records that \a runDir holds the preprocessing output for \a key.
+ *
+ * The stamp of the folder is reset to the preprocessing key only, so results of an earlier solver run in the
+ * same folder are no longer considered valid.
+ *
+ * \return False if the stamp or the index could not be written.
+ **********************************************************************************************************************/
+bool RunCache::recordPreprocessed(const Key &key, const QString &runDir, QString &outError)
+{
+    if (key.prep.isEmpty() || runDir.isEmpty())
+        return true;
+
+    Key stamp;
+    stamp.prep = key.prep;
+    if (!writeStamp(runDir, stamp, outError))
+        return false;
+
+    QJsonObject index = loadIndex();
+    QJsonObject prep = index.value(QStringLiteral("prep")).toObject();
+    prep.insert(key.prep, QFileInfo(runDir).absoluteFilePath());
+    index.insert(QStringLiteral("prep"), prep);
+
+    return saveIndex(index, outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records the complete results of a finished run.
+ *
+ * \param key     Fingerprint the run was started with.
+ * \param runDir  Folder holding the run data.
+ * \param results Result files produced by the run (see collectResultFiles()).
+ * \return False if the stamp or the index could not be written.
+ **********************************************************************************************************************/
+bool RunCache::recordResults(const Key &key, const QString &runDir, const QStringList &results, QString &outError)
+{
+    if (!key.isValid() || runDir.isEmpty() || results.isEmpty())
+        return true;
+
+    if (!writeStamp(runDir, key, outError))
+        return false;
+
+    const QDir dir(runDir);
+    QJsonArray files;
+    for (const QString &path : results) {
+        QJsonObject r;
+        r.insert(QStringLiteral("path"), dir.relativeFilePath(path));
+        r.insert(QStringLiteral("size"), double(QFileInfo(path).size()));
+        files.append(r);
+    }
+
+    QJsonObject run;
+    run.insert(QStringLiteral("dir"), dir.absolutePath());
+    run.insert(QStringLiteral("created"), QDateTime::currentDateTime().toString(Qt::ISODate));
+    run.insert(QStringLiteral("results"), files);
+
+    QJsonObject index = loadIndex();
+    QJsonObject runs = index.value(QStringLiteral("runs")).toObject();
+    runs.insert(key.run, run);
+    index.insert(QStringLiteral("runs"), runs);
+
+    if (!key.prep.isEmpty()) {
+        QJsonObject prep = index.value(QStringLiteral("prep")).toObject();
+        prep.insert(key.prep, dir.absolutePath());
+        index.insert(QStringLiteral("prep"), prep);
+    }
+
+    return saveIndex(index, outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Marks the content of \a runDir as unknown before a run starts writing into it.
+ **********************************************************************************************************************/
+void RunCache::invalidate(const QString &runDir)
+{
+    if (!runDir.isEmpty())
+        QFile::remove(QDir(runDir).filePath(QLatin1String(kStampFileName)));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Computes the cache keys of a run.
+ *
+ * Input files are hashed by content; tools are identified by toolIdentity(), or wslToolIdentity() for runs
+ * inside WSL. Missing input files are part of the key as well, so a run never matches one that had the file.
+ *
+ * \return The keys, or an invalid key if the model script cannot be read or a tool cannot be identified.
+ **********************************************************************************************************************/
+RunCache::Key RunCache::fingerprint(const Inputs &inputs)
+{
+    Key key;
+
+    const QByteArray script = hashFile(inputs.scriptPath);
+    if (script.isEmpty())
+        return key;
+
+    auto inputHash = [](const QString &path) -> QByteArray {
+        if (path.trimmed().isEmpty())
+            return QByteArray();
+        const QByteArray h = hashFile(path);
+        return h.isEmpty() ? QByteArrayLiteral("missing") : h;
+    };
+
+    auto identity = [&inputs](const QString &program) -> QString {
+        return inputs.useWsl ? wslToolIdentity(program, inputs.distro) : toolIdentity(program);
+    };
+
+    const QString python = identity(inputs.preprocessor);
+    if (python.isEmpty())
+        return key;
+
+    QCryptographicHash prep(QCryptographicHash::Sha256);
+    prep.addData("emstudio-run-cache/1\n");
+    prep.addData("tool=" + inputs.simKey.trimmed().toLower().toUtf8() + '\n');
+    prep.addData("script=" + script + '\n');
+    prep.addData("gds=" + inputHash(inputs.gdsPath) + '\n');
+    prep.addData("substrate=" + inputHash(inputs.substratePath) + '\n');
+    prep.addData("python=" + python.toUtf8() + '\n');
+    const QByteArray prepKey = prep.result().toHex();
+
+    if (inputs.solver.trimmed().isEmpty()) {
+        key.run = QString::fromLatin1(prepKey);
+        return key;
+    }
+
+    const QString solver = identity(inputs.solver);
+    if (solver.isEmpty())
+        return key;
+
+    QCryptographicHash run(QCryptographicHash::Sha256);
+    run.addData(prepKey + '\n');
+    run.addData("solver=" + solver.toUtf8() + '\n');
+
+    key.prep = QString::fromLatin1(prepKey);
+    key.run  = QString::fromLatin1(run.result().toHex());
+    return key;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the hex SHA-256 of a file's content.
+ *
+ * Hashes are memoized per path, size and modification time, so large GDS files are read only once per
+ * session as long as they do not change.
+ *
+ * \return Hex digest, or an empty array if the file cannot be read.
+ **********************************************************************************************************************/
+QByteArray RunCache::hashFile(const QString &path)
+{
+    static QHash<QString, QPair<QString, QByteArray>> memo;
+
+    const QFileInfo fi(path);
+    if (path.trimmed().isEmpty() || !fi.isFile())
+        return QByteArray();
+
+    const QString absPath = fi.absoluteFilePath();
+    const QString stamp = QString("%1:%2").arg(fi.size()).arg(fi.lastModified().toMSecsSinceEpoch());
+
+    const auto it = memo.constFind(absPath);
+    if (it != memo.constEnd() && it.value().first == stamp)
+        return it.value().second;
+
+    QFile f(absPath);
+    if (!f.open(QIODevice::ReadOnly))
+        return QByteArray();
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&f))
+        return QByteArray();
+
+    const QByteArray digest = hash.result().toHex();
+    memo.insert(absPath, qMakePair(stamp, digest));
+    return digest;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Identifies a tool by its resolved path, size and modification time.
+ *
+ * An upgraded or replaced binary changes its identity without having to start it for a version query.
+ *
+ * \param program Executable path or name looked up in PATH.
+ * \return The identity, or an empty string if the program cannot be found on the host.
+ **********************************************************************************************************************/
+QString RunCache::toolIdentity(const QString &program)
+{
+    const QString p = program.trimmed();
+    if (p.isEmpty())
+        return QString();
+
+    QFileInfo fi(p);
+    if (!fi.isFile()) {
+        const QString found = QStandardPaths::findExecutable(p);
+        if (!found.isEmpty())
+            fi.setFile(found);
+    }
+
+    if (!fi.isFile())
+        return QString();
+
+    return QString("%1|%2|%3")
+        .arg(fi.canonicalFilePath())
+        .arg(fi.size())
+        .arg(fi.lastModified().toMSecsSinceEpoch());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Identifies a tool inside WSL by its resolved path, size and modification time.
+ *
+ * The host cannot see the WSL file system, so the program is stat'ed through the distribution's shell
+ * (see PathProbe::toolStamp()). Upgrading Palace inside WSL thus changes the identity like a host upgrade does.
+ *
+ * \param program Linux path, host path or program name looked up in the login PATH of the distribution.
+ * \param distro  WSL distribution (empty for the default distribution).
+ * \param probe   Probe running the query.
+ * \return The identity, or an empty string if the program cannot be found.
+ **********************************************************************************************************************/
+QString RunCache::wslToolIdentity(const QString &program, const QString &distro, PathProbe &probe)
+{
+    const QString stamp = probe.toolStamp(program, distro, 5000);
+    return stamp.isEmpty() ? QString() : QStringLiteral("wsl|") + stamp;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Lists the result files a run wrote into \a runDir.
+ *
+ * Results are Touchstone files (*.sNp) anywhere below the folder and, for Palace, every file in the output
+ * folder named by "Problem.Output" of config.json. Only files written since \a since are considered.
+ *
+ * \return Sorted absolute file paths.
+ **********************************************************************************************************************/
+QStringList RunCache::collectResultFiles(const QString &runDir, const QDateTime &since)
+{
+    static const QRegularExpression reSnp(QStringLiteral("\\.s\\d+p$"), QRegularExpression::CaseInsensitiveOption);
+
+    QStringList files;
+    if (runDir.isEmpty() || !QDir(runDir).exists())
+        return files;
+
+    QString outputDir;
+    QFile config(QDir(runDir).filePath(QStringLiteral("config.json")));
+    if (config.open(QIODevice::ReadOnly)) {
+        const QJsonObject problem =
+            QJsonDocument::fromJson(config.readAll()).object().value(QStringLiteral("Problem")).toObject();
+        const QString output = problem.value(QStringLiteral("Output")).toString();
+        if (!output.isEmpty())
+            outputDir = QDir::cleanPath(QDir(runDir).absoluteFilePath(output)) + QLatin1Char('/');
+    }
+
+    QDirIterator it(runDir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo fi = it.fileInfo();
+        if (fi.lastModified() < since)
+            continue;
+
+        if (reSnp.match(fi.fileName()).hasMatch() ||
+            (!outputDir.isEmpty() && fi.absoluteFilePath().startsWith(outputDir)))
+            files << fi.absoluteFilePath();
+    }
+
+    files.sort();
+    return files;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the cache index; a missing or unreadable index is an empty cache.
+ **********************************************************************************************************************/
+QJsonObject RunCache::loadIndex() const
+{
+    QFile f(m_indexPath);
+    if (!f.open(QIODevice::ReadOnly))
+        return QJsonObject();
+
+    return QJsonDocument::fromJson(f.readAll()).object();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the cache index after dropping entries whose run directory no longer carries their stamp.
+ **********************************************************************************************************************/
+bool RunCache::saveIndex(QJsonObject index, QString &outError) const
+{
+    auto prune = [](const QJsonObject &entries, const QString &stampKey, bool nested) {
+        QJsonObject kept;
+        for (auto it = entries.constBegin(); it != entries.constEnd(); ++it) {
+            const QString runDir = nested ? it.value().toObject().value(QStringLiteral("dir")).toString()
+                                          : it.value().toString();
+            if (readStamp(runDir).value(stampKey).toString() == it.key())
+                kept.insert(it.key(), it.value());
+        }
+        return kept;
+    };
+
+    index.insert(QStringLiteral("version"), 1);
+    index.insert(QStringLiteral("prep"),
+                 prune(index.value(QStringLiteral("prep")).toObject(), QStringLiteral("prep"), false));
+    index.insert(QStringLiteral("runs"),
+                 prune(index.value(QStringLiteral("runs")).toObject(), QStringLiteral("run"), true));
+
+    QDir().mkpath(QFileInfo(m_indexPath).absolutePath());
+
+    QSaveFile f(m_indexPath);
+    if (!f.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write run cache index %1").arg(m_indexPath);
+        return false;
+    }
+
+    f.write(QJsonDocument(index).toJson(QJsonDocument::Indented));
+    if (!f.commit()) {
+        outError = QString("Cannot write run cache index %1").arg(m_indexPath);
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the keys stamped into a run directory.
+ **********************************************************************************************************************/
+QJsonObject RunCache::readStamp(const QString &runDir)
+{
+    if (runDir.isEmpty())
+        return QJsonObject();
+
+    QFile f(QDir(runDir).filePath(QLatin1String(kStampFileName)));
+    if (!f.open(QIODevice::ReadOnly))
+        return QJsonObject();
+
+    return QJsonDocument::fromJson(f.readAll()).object();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Stamps a run directory with the keys of the run that produced its content.
+ **********************************************************************************************************************/
+bool RunCache::writeStamp(const QString &runDir, const Key &key, QString &outError)
+{
+    QJsonObject stamp;
+    stamp.insert(QStringLiteral("prep"), key.prep);
+    stamp.insert(QStringLiteral("run"), key.run);
+
+    QSaveFile f(QDir(runDir).filePath(QLatin1String(kStampFileName)));
+    if (!f.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write run cache stamp in %1").arg(runDir);
+        return false;
+    }
+
+    f.write(QJsonDocument(stamp).toJson(QJsonDocument::Compact));
+    if (!f.commit()) {
+        outError = QString("Cannot write run cache stamp in %1").arg(runDir);
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,119 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef RUNCACHE_H
+#define RUNCACHE_H
+
+#include <QString>
+#include <QDateTime>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QStringList>
+
+#include "pathprobe.h"
+
+/*!*******************************************************************************************************************
+ * \class RunCache
+ * \brief Content-addressed index of finished simulation runs, used to skip runs whose inputs did not change.
+ *
+ * A run is fingerprinted by hashing the generated Python model, the GDS file, the substrate XML and the
+ * identity of the tools that process them. Two keys are derived:
+ *  - the preprocessing key covers everything gds2palace consumes (model, GDS, substrate, Python);
+ *  - the run key additionally covers the solver binary or launcher.
+ *
+ * Tools are identified by path, size and modification time, inside WSL through the distribution's shell. A run
+ * whose tools cannot be identified gets no key and always runs, so an upgraded solver never matches old results.
+ *
+ * A run key hit whose recorded result files are still in place means the whole run can be skipped. A
+ * preprocessing key hit alone is a partial hit: the generated mesh and solver input are reused and only the
+ * solver is started again, e.g. after switching the Palace installation or after an interrupted solver run.
+ *
+ * The index lives in a JSON file (by default in the application data folder). Every cached run directory
+ * carries a stamp file with the keys of the run that produced its content; entries whose stamp no longer
+ * matches (the folder was overwritten by a run with other inputs) are treated as misses and pruned.
+ **********************************************************************************************************************/
+class RunCache
+{
+public:
+    struct Inputs
+    {
+        QString                 simKey;
+        QString                 scriptPath;
+        QString                 gdsPath;
+        QString                 substratePath;
+        QString                 preprocessor;   // Python interpreter running the model
+        QString                 solver;         // solver binary or launcher; empty for single-stage runs
+        bool                    useWsl = false; // preprocessor and solver run inside WSL
+        QString                 distro;         // WSL distribution (empty for the default distribution)
+    };
+
+    struct Key
+    {
+        QString                 prep;           // empty for backends without a separate solver stage
+        QString                 run;
+
+        bool                    isValid() const { return !run.isEmpty(); }
+    };
+
+    struct Entry
+    {
+        QString                 runDir;
+        QStringList             results;
+
+        bool                    isValid() const { return !runDir.isEmpty(); }
+    };
+
+    explicit RunCache(const QString &indexPath = QString());
+
+    QString                     indexPath() const { return m_indexPath; }
+
+    Entry                       lookupResults(const Key &key) const;
+    Entry                       lookupPreprocessed(const Key &key) const;
+
+    bool                        recordPreprocessed(const Key &key, const QString &runDir, QString &outError);
+    bool                        recordResults(const Key &key,
+                                              const QString &runDir,
+                                              const QStringList &results,
+                                              QString &outError);
+    void                        invalidate(const QString &runDir);
+
+    static Key                  fingerprint(const Inputs &inputs);
+    static QByteArray           hashFile(const QString &path);
+    static QString              toolIdentity(const QString &program);
+    static QString              wslToolIdentity(const QString &program,
+                                                const QString &distro,
+                                                PathProbe &probe = PathProbe::shared());
+    static QStringList          collectResultFiles(const QString &runDir, const QDateTime &since);
+    static QString              defaultIndexPath();
+
+    static const char          *kStampFileName;
+
+private:
+    QJsonObject                 loadIndex() const;
+    bool                        saveIndex(QJsonObject index, QString &outError) const;
+
+    static QJsonObject          readStamp(const QString &runDir);
+    static bool                 writeStamp(const QString &runDir, const Key &key, QString &outError);
+
+private:
+    QString                     m_indexPath;
+};
+
+#endif // RUNCACHE_H
@@ -0,0 +1,309 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QDirIterator>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include "runreport.h"
+
+namespace {
+
+/*!*******************************************************************************************************************
+ * \brief Quotes a CSV field if it contains a separator, quote or line break.
+ **********************************************************************************************************************/
+QString csvField(const QString &value)
+{
+    if (!value.contains(QLatin1Char(',')) && !value.contains(QLatin1Char('"')) && !value.contains(QLatin1Char('\n')))
+        return value;
+
+    QString quoted = value;
+    quoted.replace(QLatin1String("\""), QLatin1String("\"\""));
+    return QLatin1Char('"') + quoted + QLatin1Char('"');
+}
+
+/*!*******************************************************************************************************************
+ * \brief Formats milliseconds as seconds with millisecond resolution.
+ **********************************************************************************************************************/
+QString seconds(double ms)
+{
+    return QString::number(ms / 1000.0, 'f', 3);
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Starts a new report and drops all data of the previous run.
+ *
+ * \param simKey    Backend key ("palace", "elmer" or "openems").
+ * \param modelPath Python model of the run.
+ **********************************************************************************************************************/
+void RunReport::begin(const QString &simKey, const QString &modelPath)
+{
+    *this = RunReport();
+
+    m_simKey = simKey;
+    m_model = modelPath;
+    m_started = QDateTime::currentDateTime();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Closes an open stage and records the end time and exit code of the run.
+ **********************************************************************************************************************/
+void RunReport::finish(int exitCode)
+{
+    if (m_open)
+        endStage(exitCode);
+
+    m_exitCode = exitCode;
+    m_finished = QDateTime::currentDateTime();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records the run cache fingerprints of the run inputs.
+ **********************************************************************************************************************/
+void RunReport::setFingerprint(const QString &prep, const QString &run)
+{
+    m_prepFingerprint = prep;
+    m_runFingerprint = run;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records an input file (e.g. "gds", "substrate") with its size and modification time.
+ **********************************************************************************************************************/
+void RunReport::setInput(const QString &key, const QString &path)
+{
+    if (path.trimmed().isEmpty())
+        return;
+
+    const QFileInfo fi(path);
+    QJsonObject input;
+    input["path"] = QDir::toNativeSeparators(fi.absoluteFilePath());
+    if (fi.exists()) {
+        input["size"] = double(fi.size());
+        input["modified"] = fi.lastModified().toString(Qt::ISODateWithMs);
+    }
+    m_inputs[key] = input;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds a finished stage that ran before the runner took over (e.g. saving the model in the GUI).
+ **********************************************************************************************************************/
+void RunReport::addStage(const QString &name, const QDateTime &started, qint64 durationMs)
+{
+    Stage stage;
+    stage.name = name;
+    stage.started = started;
+    stage.finished = started.addMSecs(durationMs);
+    m_stages.append(stage);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Opens a stage; an already open stage is closed with exit code 0 first.
+ **********************************************************************************************************************/
+void RunReport::beginStage(const QString &name)
+{
+    if (m_open)
+        endStage(0);
+
+    Stage stage;
+    stage.name = name;
+    stage.started = QDateTime::currentDateTime();
+    m_stages.append(stage);
+    m_open = true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Closes the open stage.
+ *
+ * \param exitCode Exit code of the stage process.
+ * \return The closed stage, or a stage with an empty name if no stage was open.
+ **********************************************************************************************************************/
+RunReport::Stage RunReport::endStage(int exitCode)
+{
+    if (!m_open)
+        return Stage();
+
+    Stage &stage = m_stages.last();
+    stage.finished = QDateTime::currentDateTime();
+    stage.exitCode = exitCode;
+    m_open = false;
+    return stage;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the report as JSON object (the content of run_report.json).
+ **********************************************************************************************************************/
+QJsonObject RunReport::toJson() const
+{
+    QJsonArray stages;
+    for (const Stage &stage : m_stages) {
+        QJsonObject o;
+        o["name"]        = stage.name;
+        o["started"]     = stage.started.toString(Qt::ISODateWithMs);
+        o["finished"]    = stage.finished.toString(Qt::ISODateWithMs);
+        o["duration_ms"] = double(stage.durationMs());
+        o["exit_code"]   = stage.exitCode;
+        stages.append(o);
+    }
+
+    QJsonObject fingerprints;
+    fingerprints["prep"] = m_prepFingerprint;
+    fingerprints["run"]  = m_runFingerprint;
+
+    QJsonObject root;
+    root["version"]          = 1;
+    root["emstudio_version"] = QCoreApplication::applicationVersion();
+    root["sim_key"]          = m_simKey;
+    root["model"]            = QDir::toNativeSeparators(m_model);
+    root["started"]          = m_started.toString(Qt::ISODateWithMs);
+    root["finished"]         = m_finished.toString(Qt::ISODateWithMs);
+    root["wall_ms"]          = double(m_started.msecsTo(m_finished));
+    root["exit_code"]        = m_exitCode;
+    root["cores"]            = m_cores;
+    root["cache"]            = m_cacheStatus;
+    root["fingerprints"]     = fingerprints;
+    root["inputs"]           = m_inputs;
+    root["stages"]           = stages;
+    return root;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the report as indented JSON.
+ *
+ * \param path     Output file, usually "<run dir>/run_report.json".
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool RunReport::write(const QString &path, QString &outError) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write run report %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        outError = QString("Cannot write run report %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns all run reports below a directory, sorted by path.
+ **********************************************************************************************************************/
+QStringList RunReport::findReports(const QString &dir)
+{
+    QStringList reports;
+    QDirIterator it(dir, QStringList() << fileName(), QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+        reports << it.next();
+
+    reports.sort();
+    return reports;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Flattens run reports into one CSV table, one row per run in start order.
+ *
+ * The fixed columns are followed by one "<stage>_s" column per stage name found in any report (in order of
+ * first appearance); repeated stages of one run are summed. Unreadable files are skipped.
+ *
+ * \param reportPaths run_report.json files.
+ * \return CSV text with a header row.
+ **********************************************************************************************************************/
+QByteArray RunReport::aggregateCsv(const QStringList &reportPaths)
+{
+    struct Row
+    {
+        QJsonObject             report;
+        QString                 path;
+        QMap<QString, double>   stageMs;
+    };
+
+    QList<Row> rows;
+    QStringList stageNames;
+
+    for (const QString &path : reportPaths) {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            continue;
+
+        const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+        if (!doc.isObject())
+            continue;
+
+        Row row;
+        row.report = doc.object();
+        row.path = path;
+        for (const QJsonValue &value : row.report.value("stages").toArray()) {
+            const QJsonObject stage = value.toObject();
+            const QString name = stage.value("name").toString();
+            if (name.isEmpty())
+                continue;
+            if (!stageNames.contains(name))
+                stageNames << name;
+            row.stageMs[name] += stage.value("duration_ms").toDouble();
+        }
+        rows.append(row);
+    }
+
+    std::stable_sort(rows.begin(), rows.end(), [](const Row &a, const Row &b) {
+        return a.report.value("started").toString() < b.report.value("started").toString();
+    });
+
+    QStringList header;
+    header << "started" << "model" << "sim_key" << "exit_code" << "cores" << "cache" << "wall_s";
+    for (const QString &name : stageNames)
+        header << name + QStringLiteral("_s");
+    header << "report";
+
+    QByteArray out = header.join(QLatin1Char(',')).toUtf8() + '\n';
+    for (const Row &row : rows) {
+        QStringList fields;
+        fields << row.report.value("started").toString()
+               << QFileInfo(row.report.value("model").toString()).completeBaseName()
+               << row.report.value("sim_key").toString()
+               << QString::number(row.report.value("exit_code").toInt())
+               << QString::number(row.report.value("cores").toInt())
+               << row.report.value("cache").toString()
+               << seconds(row.report.value("wall_ms").toDouble());
+        for (const QString &name : stageNames)
+            fields << (row.stageMs.contains(name) ? seconds(row.stageMs.value(name)) : QString());
+        fields << QDir::toNativeSeparators(row.path);
+
+        for (QString &field : fields)
+            field = csvField(field);
+        out += fields.join(QLatin1Char(',')).toUtf8() + '\n';
+    }
+
+    return out;
+}
@@ -0,0 +1,98 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef RUNREPORT_H
+#define RUNREPORT_H
+
+#include <QList>
+#include <QString>
+#include <QDateTime>
+#include <QByteArray>
+#include <QJsonObject>
+#include <QStringList>
+
+/*!*******************************************************************************************************************
+ * \class RunReport
+ * \brief Machine-readable record of one simulation run: stage timings, exit codes, cores and input fingerprints.
+ *
+ * SimulationRunner opens a stage whenever a stage process starts (preprocess, solver, openems) and closes it
+ * when the process exits; the work after the solver (result collection, run cache, telemetry) is recorded as
+ * the postprocess stage, and the GUI adds the time it spent saving the model before the run. At the end of
+ * the run the report is written as run_report.json into the run directory.
+ *
+ * aggregateCsv() flattens any number of reports into one CSV table with a column per stage, so throughput can
+ * be tracked across runs and EMStudio versions.
+ **********************************************************************************************************************/
+class RunReport
+{
+public:
+    struct Stage
+    {
+        QString                 name;
+        QDateTime               started;
+        QDateTime               finished;
+        int                     exitCode = 0;
+
+        qint64                  durationMs() const { return started.msecsTo(finished); }
+    };
+
+    void                        begin(const QString &simKey, const QString &modelPath);
+    void                        finish(int exitCode);
+    bool                        isActive() const { return m_started.isValid() && !m_finished.isValid(); }
+
+    void                        setCacheStatus(const QString &status) { m_cacheStatus = status; }
+    QString                     cacheStatus() const { return m_cacheStatus; }
+    void                        setFingerprint(const QString &prep, const QString &run);
+    void                        setCores(int cores) { m_cores = cores; }
+    void                        setInput(const QString &key, const QString &path);
+
+    void                        addStage(const QString &name, const QDateTime &started, qint64 durationMs);
+    void                        beginStage(const QString &name);
+    Stage                       endStage(int exitCode);
+    bool                        hasOpenStage() const { return m_open; }
+
+    const QList<Stage>         &stages() const { return m_stages; }
+    int                         exitCode() const { return m_exitCode; }
+
+    QJsonObject                 toJson() const;
+    bool                        write(const QString &path, QString &outError) const;
+
+    static QString              fileName() { return QStringLiteral("run_report.json"); }
+    static QStringList          findReports(const QString &dir);
+    static QByteArray           aggregateCsv(const QStringList &reportPaths);
+
+private:
+    QString                     m_simKey;
+    QString                     m_model;
+    QString                     m_cacheStatus;
+    QString                     m_prepFingerprint;
+    QString                     m_runFingerprint;
+    QJsonObject                 m_inputs;
+    int                         m_cores = 0;
+
+    QDateTime                   m_started;
+    QDateTime                   m_finished;
+    int                         m_exitCode = 0;
+
+    QList<Stage>                m_stages;
+    bool                        m_open = false;
+};
+
+#endif // RUNREPORT_H
@@ -0,0 +1,240 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QHash>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QRandomGenerator>
+
+#include "shellsession.h"
+#include "wslHelper.h"
+
+namespace {
+
+QHash<QString, ShellSession *> &sharedSessions()
+{
+    static QHash<QString, ShellSession *> sessions;
+    return sessions;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Creates a session; the shell is started lazily by the first request.
+ *
+ * \param program   Shell executable (default /bin/sh), or wsl.exe with \a arguments selecting distro and shell.
+ * \param arguments Arguments passed to \a program.
+ **********************************************************************************************************************/
+ShellSession::ShellSession(const QString &program, const QStringList &arguments)
+    : m_program(program)
+    , m_arguments(arguments)
+    , m_nonce(QByteArray::number(QRandomGenerator::global()->generate64(), 16))
+{
+}
+
+ShellSession::~ShellSession()
+{
+    close();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the session used for path probes in \a distro (GUI thread only).
+ *
+ * On Windows the session runs \c sh inside the WSL distribution (the default distribution if \a distro is
+ * empty); elsewhere it is a local /bin/sh. Sessions are closed when the application object is destroyed.
+ **********************************************************************************************************************/
+ShellSession &ShellSession::shared(const QString &distro)
+{
+    QHash<QString, ShellSession *> &sessions = sharedSessions();
+    const QString key = distro.trimmed();
+
+    ShellSession *session = sessions.value(key);
+    if (!session) {
+        if (sessions.isEmpty())
+            qAddPostRoutine(ShellSession::closeShared);
+#ifdef Q_OS_WIN
+        QStringList args;
+        if (!key.isEmpty())
+            args << "-d" << key;
+        args << "--" << "sh";
+        session = new ShellSession(wslExePath(), args);
+#else
+        session = new ShellSession();
+#endif
+        sessions.insert(key, session);
+    }
+    return *session;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Closes and deletes all shared sessions.
+ **********************************************************************************************************************/
+void ShellSession::closeShared()
+{
+    QHash<QString, ShellSession *> &sessions = sharedSessions();
+    qDeleteAll(sessions);
+    sessions.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the shell if it is not running.
+ *
+ * \return True if the shell is running.
+ **********************************************************************************************************************/
+bool ShellSession::start(int timeoutMs)
+{
+    if (isRunning())
+        return true;
+
+    close();
+    if (m_program.isEmpty())
+        return false;
+
+    m_process.reset(new QProcess);
+    m_process->setProcessChannelMode(QProcess::SeparateChannels);
+    m_process->setStandardErrorFile(QProcess::nullDevice());
+    m_process->start(m_program, m_arguments);
+    ++m_startCount;
+
+    if (!m_process->waitForStarted(timeoutMs)) {
+        m_process.reset();
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true while the shell process is running.
+ **********************************************************************************************************************/
+bool ShellSession::isRunning() const
+{
+    return m_process && m_process->state() == QProcess::Running;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Ends the shell (exit, then kill if it does not terminate promptly).
+ **********************************************************************************************************************/
+void ShellSession::close()
+{
+    if (!m_process)
+        return;
+
+    if (m_process->state() == QProcess::Running) {
+        m_process->write("exit\n");
+        m_process->closeWriteChannel();
+        if (!m_process->waitForFinished(200)) {
+            m_process->kill();
+            m_process->waitForFinished(200);
+        }
+    }
+
+    m_process.reset();
+    m_buffer.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Executes one command in the session.
+ *
+ * \param command   Shell command; its stdin is /dev/null and its stderr is discarded.
+ * \param timeoutMs Maximum time to wait for the reply (and for the shell to start).
+ * \return Reply with the command's stdout and exit status; \c ok is false if no reply arrived.
+ **********************************************************************************************************************/
+ShellSession::Reply ShellSession::run(const QString &command, int timeoutMs)
+{
+    return runBatch(QStringList() << command, timeoutMs).first();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Executes several commands with a single write and returns their replies in order.
+ *
+ * \param commands  Shell commands, executed one after the other.
+ * \param timeoutMs Maximum time to wait for all replies.
+ * \return One reply per command. After a failure the remaining replies are not ok.
+ **********************************************************************************************************************/
+QList<ShellSession::Reply> ShellSession::runBatch(const QStringList &commands, int timeoutMs)
+{
+    QList<Reply> replies;
+    for (int i = 0; i < commands.size(); ++i)
+        replies << Reply();
+
+    if (commands.isEmpty())
+        return replies;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    if (!start(timeoutMs))
+        return replies;
+
+    QByteArray payload;
+    QList<QByteArray> markers;
+    for (const QString &command : commands) {
+        const QByteArray marker = "__emstudio_" + m_nonce + '_' + QByteArray::number(++m_sequence) + "__";
+        markers << marker;
+        payload += "{ " + command.toUtf8() + "\n} </dev/null\n";
+        payload += "printf '\\n%s %d\\n' " + marker + " $?\n";
+    }
+
+    m_process->write(payload);
+
+    for (int i = 0; i < markers.size(); ++i) {
+        if (!readFrame(markers.at(i), replies[i], timer, timeoutMs)) {
+            close();
+            break;
+        }
+    }
+
+    return replies;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads output until the frame line of \a marker and fills \a reply.
+ *
+ * \return False if the shell ended or the timeout expired before the frame line arrived.
+ **********************************************************************************************************************/
+bool ShellSession::readFrame(const QByteArray &marker, Reply &reply, const QElapsedTimer &timer, int timeoutMs)
+{
+    const QByteArray frame = '\n' + marker + ' ';
+
+    for (;;) {
+        const int pos = m_buffer.indexOf(frame);
+        const int end = pos >= 0 ? m_buffer.indexOf('\n', pos + frame.size()) : -1;
+        if (end >= 0) {
+            reply.output = m_buffer.left(pos);
+            reply.exitCode = m_buffer.mid(pos + frame.size(), end - pos - frame.size()).trimmed().toInt();
+            reply.ok = true;
+            m_buffer.remove(0, end + 1);
+            return true;
+        }
+
+        const qint64 remaining = timeoutMs - timer.elapsed();
+        if (remaining <= 0) {
+            reply.timedOut = true;
+            return false;
+        }
+
+        if (!m_process->waitForReadyRead(int(remaining))) {
+            reply.timedOut = m_process->state() == QProcess::Running;
+            return false;
+        }
+        m_buffer += m_process->readAllStandardOutput();
+    }
+}
@@ -0,0 +1,96 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SHELLSESSION_H
+#define SHELLSESSION_H
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+#include <QScopedPointer>
+
+class QProcess;
+class QElapsedTimer;
+
+/*!*******************************************************************************************************************
+ * \class ShellSession
+ * \brief Long-lived POSIX shell that executes framed commands over one pipe.
+ *
+ * Starting a process per check (\c wsl.exe ... bash -lc "test -e ...") costs tens to hundreds of milliseconds on
+ * Windows. A ShellSession starts the shell once (a local /bin/sh, or \c sh inside a WSL distribution) and writes
+ * each request to its stdin followed by a frame line carrying a per-session marker and the exit status:
+ *
+ * \code
+ * { <command>
+ * } </dev/null
+ * printf '\n%s %d\n' <marker>-<seq> $?
+ * \endcode
+ *
+ * The reply is everything the command wrote to stdout up to the frame line. runBatch() writes several requests
+ * at once and collects their replies in order, so a group of probes costs a single round trip. If a command
+ * ends the shell or a reply times out, the session is closed and restarted on the next request.
+ *
+ * A session is used synchronously from the thread that created it. shared() keeps one session per WSL
+ * distribution for the GUI thread.
+ **********************************************************************************************************************/
+class ShellSession
+{
+public:
+    struct Reply
+    {
+        bool                    ok = false;         // frame received
+        bool                    timedOut = false;
+        int                     exitCode = -1;
+        QByteArray              output;
+
+        QString                 text() const { return QString::fromUtf8(output).trimmed(); }
+    };
+
+    explicit ShellSession(const QString &program = QStringLiteral("/bin/sh"),
+                          const QStringList &arguments = QStringList());
+    ~ShellSession();
+
+    static ShellSession        &shared(const QString &distro);
+    static void                 closeShared();
+
+    bool                        start(int timeoutMs = 5000);
+    bool                        isRunning() const;
+    void                        close();
+
+    Reply                       run(const QString &command, int timeoutMs = 2000);
+    QList<Reply>                runBatch(const QStringList &commands, int timeoutMs = 2000);
+
+    int                         startCount() const { return m_startCount; }
+
+private:
+    bool                        readFrame(const QByteArray &marker, Reply &reply, const QElapsedTimer &timer,
+                                          int timeoutMs);
+
+    QString                     m_program;
+    QStringList                 m_arguments;
+    QScopedPointer<QProcess>    m_process;
+    QByteArray                  m_buffer;
+    QByteArray                  m_nonce;
+    quint64                     m_sequence = 0;
+    int                         m_startCount = 0;
+};
+
+#endif // SHELLSESSION_H
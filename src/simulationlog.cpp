@@ -0,0 +1,280 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QUrl>
+#include <QFile>
+#include <QMenu>
+#include <QAction>
+#include <QScrollBar>
+#include <QTextCodec>
+#include <QTextCursor>
+#include <QSignalBlocker>
+#include <QPlainTextEdit>
+#include <QTemporaryFile>
+#include <QDesktopServices>
+
+#include "simulationlog.h"
+#include "tracer.h"
+
+/*!*******************************************************************************************************************
+ * \brief Constructs the log front end for the given view.
+ *
+ * Configures the view as a bounded ring of kDefaultMaxLines lines and installs a context menu entry
+ * that opens the complete spooled log.
+ *
+ * \param view   Plain text view that displays the most recent log lines.
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+SimulationLog::SimulationLog(QPlainTextEdit *view, QObject *parent)
+    : QObject(parent)
+    , m_view(view)
+    , m_decoder(QTextCodec::codecForName("UTF-8")->makeDecoder())
+{
+    m_flushTimer.setSingleShot(true);
+    m_flushTimer.setInterval(kFlushIntervalMs);
+    connect(&m_flushTimer, &QTimer::timeout, this, &SimulationLog::flush);
+
+    if (m_view) {
+        m_view->setMaximumBlockCount(m_maxLines);
+        m_view->setContextMenuPolicy(Qt::CustomContextMenu);
+        connect(m_view, &QWidget::customContextMenuRequested, this, &SimulationLog::showContextMenu);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Destroys the log; the temporary spool file is removed.
+ **********************************************************************************************************************/
+SimulationLog::~SimulationLog() = default;
+
+/*!*******************************************************************************************************************
+ * \brief Queues raw process output for display and writes it to the spool file.
+ *
+ * The view is not touched here; pending bytes are appended by the next timer-driven flush().
+ *
+ * \param data Raw UTF-8 encoded output chunk.
+ **********************************************************************************************************************/
+void SimulationLog::append(const QByteArray &data)
+{
+    EMSTUDIO_TRACE_SCOPE("log.append");
+    if (data.isEmpty())
+        return;
+
+    if (ensureSpoolFile())
+        m_spool->write(data);
+
+    m_pending.append(data);
+
+    if (!m_flushTimer.isActive())
+        m_flushTimer.start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Convenience overload of append() for status text produced by EMStudio itself.
+ *
+ * \param text Text to append.
+ **********************************************************************************************************************/
+void SimulationLog::appendText(const QString &text)
+{
+    append(text.toUtf8());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Discards pending output, clears the view and truncates the spool file.
+ **********************************************************************************************************************/
+void SimulationLog::clear()
+{
+    m_flushTimer.stop();
+    m_pending.clear();
+    m_decoder.reset(QTextCodec::codecForName("UTF-8")->makeDecoder());
+
+    if (m_view) {
+        QSignalBlocker blocker(m_view);
+        m_view->clear();
+    }
+
+    if (m_spool) {
+        m_spool->resize(0);
+        m_spool->seek(0);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Appends all pending output to the view in a single edit.
+ *
+ * Incomplete UTF-8 sequences at the end of a chunk are kept by the stateful decoder until the next
+ * flush. Only the last maxLines() lines of a large batch are inserted, since the view would drop the
+ * rest immediately. The view follows the end of the log only if it was already scrolled to the bottom.
+ **********************************************************************************************************************/
+void SimulationLog::flush()
+{
+    EMSTUDIO_TRACE_SCOPE("log.flush");
+    m_flushTimer.stop();
+
+    if (m_pending.isEmpty() || !m_view)
+        return;
+
+    QString chunk = m_decoder->toUnicode(m_pending);
+    m_pending.clear();
+
+    if (m_maxLines > 0)
+        chunk = tailLines(chunk, m_maxLines);
+
+    if (chunk.isEmpty())
+        return;
+
+    QScrollBar *bar = m_view->verticalScrollBar();
+    const bool followTail = !bar || bar->value() >= bar->maximum();
+
+    QSignalBlocker blocker(m_view);
+    QTextCursor cursor(m_view->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(chunk);
+
+    if (followTail && bar)
+        bar->setValue(bar->maximum());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the number of lines kept in the view.
+ *
+ * \param maxLines Line limit; 0 keeps everything.
+ **********************************************************************************************************************/
+void SimulationLog::setMaxLines(int maxLines)
+{
+    m_maxLines = qMax(0, maxLines);
+
+    if (m_view)
+        m_view->setMaximumBlockCount(m_maxLines);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the text currently held by the view, after flushing pending output.
+ *
+ * \return Most recent log lines (bounded by maxLines()).
+ **********************************************************************************************************************/
+QString SimulationLog::text()
+{
+    flush();
+    return m_view ? m_view->toPlainText() : QString();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the complete log read back from the spool file.
+ *
+ * Falls back to text() if no spool file could be created.
+ *
+ * \return Full log text since the last clear().
+ **********************************************************************************************************************/
+QString SimulationLog::fullText()
+{
+    flush();
+
+    if (!m_spool)
+        return text();
+
+    m_spool->flush();
+
+    QFile file(m_spool->fileName());
+    if (!file.open(QIODevice::ReadOnly))
+        return text();
+
+    return QString::fromUtf8(file.readAll());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the path of the spool file, or an empty string if nothing was logged yet.
+ **********************************************************************************************************************/
+QString SimulationLog::spoolFilePath() const
+{
+    return m_spool ? m_spool->fileName() : QString();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Opens the complete spooled log with the system's default text viewer.
+ **********************************************************************************************************************/
+void SimulationLog::openFullLog()
+{
+    flush();
+
+    if (!m_spool)
+        return;
+
+    m_spool->flush();
+    QDesktopServices::openUrl(QUrl::fromLocalFile(m_spool->fileName()));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Shows the standard text context menu extended by an "Open Full Log" entry.
+ *
+ * \param pos Requested menu position in viewport coordinates.
+ **********************************************************************************************************************/
+void SimulationLog::showContextMenu(const QPoint &pos)
+{
+    if (!m_view)
+        return;
+
+    QMenu *menu = m_view->createStandardContextMenu();
+    menu->addSeparator();
+
+    QAction *openAction = menu->addAction(tr("Open Full Log"));
+    openAction->setEnabled(m_spool && m_spool->size() > 0);
+    connect(openAction, &QAction::triggered, this, &SimulationLog::openFullLog);
+
+    menu->exec(m_view->viewport()->mapToGlobal(pos));
+    delete menu;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Lazily creates the temporary spool file.
+ *
+ * \return True if the spool file is open for writing.
+ **********************************************************************************************************************/
+bool SimulationLog::ensureSpoolFile()
+{
+    if (m_spool)
+        return m_spool->isOpen();
+
+    m_spool.reset(new QTemporaryFile(QDir(QDir::tempPath()).filePath(QStringLiteral("emstudio_simlog_XXXXXX.log"))));
+    if (!m_spool->open()) {
+        m_spool.reset();
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns at most the last \p maxLines lines of \p text.
+ *
+ * \param text     Decoded output batch.
+ * \param maxLines Maximum number of lines to keep.
+ * \return Tail of the text.
+ **********************************************************************************************************************/
+QString SimulationLog::tailLines(const QString &text, int maxLines) const
+{
+    int seen = 0;
+    for (int i = text.size() - 2; i >= 0; --i) {
+        if (text.at(i) == QLatin1Char('\n') && ++seen == maxLines)
+            return text.mid(i + 1);
+    }
+
+    return text;
+}
@@ -0,0 +1,86 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SIMULATIONLOG_H
+#define SIMULATIONLOG_H
+
+#include <QTimer>
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QScopedPointer>
+
+class QTextDecoder;
+class QTemporaryFile;
+class QPlainTextEdit;
+
+/*!*******************************************************************************************************************
+ * \class SimulationLog
+ * \brief Batched, memory-bounded front end for the simulation log view.
+ *
+ * Solver processes can emit output in thousands of small chunks per second. Instead of touching the
+ * QPlainTextEdit for every chunk, SimulationLog collects incoming bytes and appends them to the view
+ * at most once per flush interval (~30 Hz). The view only keeps the most recent lines (a ring bounded
+ * by QPlainTextEdit::maximumBlockCount), while the complete output is spooled to a temporary file
+ * that can be opened on demand from the log context menu.
+ **********************************************************************************************************************/
+class SimulationLog : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SimulationLog(QPlainTextEdit *view, QObject *parent = nullptr);
+    ~SimulationLog() override;
+
+    void                        append(const QByteArray &data);
+    void                        appendText(const QString &text);
+    void                        clear();
+    void                        flush();
+
+    void                        setMaxLines(int maxLines);
+    int                         maxLines() const { return m_maxLines; }
+
+    QString                     text();
+    QString                     fullText();
+    QString                     spoolFilePath() const;
+
+    static constexpr int        kDefaultMaxLines = 20000;
+    static constexpr int        kFlushIntervalMs = 33;
+
+private slots:
+    void                        openFullLog();
+    void                        showContextMenu(const QPoint &pos);
+
+private:
+    bool                        ensureSpoolFile();
+    QString                     tailLines(const QString &text, int maxLines) const;
+
+private:
+    QPlainTextEdit              *m_view = nullptr;
+
+    QByteArray                  m_pending;
+    QScopedPointer<QTextDecoder> m_decoder;
+    QScopedPointer<QTemporaryFile> m_spool;
+
+    QTimer                      m_flushTimer;
+    int                         m_maxLines = kDefaultMaxLines;
+};
+
+#endif // SIMULATIONLOG_H
@@ -0,0 +1,260 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QtGlobal>
+
+#include "simulationloganalyzer.h"
+
+namespace {
+
+constexpr int kMaxPartialLineBytes = 64 * 1024;
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Constructs the analyzer and compiles the line patterns once.
+ *
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+SimulationLogAnalyzer::SimulationLogAnalyzer(QObject *parent)
+    : QObject(parent)
+    , m_reRunDir(QStringLiteral(R"(Simulation data directory:\s*(\S+))"))
+    , m_rePalaceSweep(QStringLiteral(R"(^\s*It\s+(\d+)\s*/\s*(\d+)\s*:(?:.*?=\s*([-+0-9.eE]+)\s*GHz)?)"))
+    , m_rePalaceConverged(QStringLiteral(R"(converged in\s+(\d+)\s+iteration)"),
+                          QRegularExpression::CaseInsensitiveOption)
+    , m_rePalaceResidual(QStringLiteral(R"(^\s*(\d+)\s+KSP residual norm.*?=\s*([-+0-9.eE]+))"))
+    , m_reOpenEmsTimestep(QStringLiteral(
+          R"(Timestep:\s*(\d+).*Energy:\s*~?\s*[-+0-9.eE]+\s*\(\s*([-+0-9.eE]+)\s*dB\s*\))"))
+    , m_reElmerStep(QStringLiteral(R"(MAIN:\s*(?:Scanning|Time):\s*(\d+)\s*/\s*(\d+))"),
+                    QRegularExpression::CaseInsensitiveOption)
+    , m_reElmerChange(QStringLiteral(
+          R"(ComputeChange:.*\(ITER=(\d+)\).*\(NRM,RELC\):\s*\(\s*[-+0-9.eE]+\s+([-+0-9.eE]+))"))
+{
+    m_clock.start();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Consumes a chunk of process output.
+ *
+ * Complete lines (terminated by '\n' or '\r') are parsed immediately; a trailing incomplete line is
+ * kept until the next chunk or finish(). Overlong lines without terminator are discarded.
+ *
+ * \param data Raw UTF-8 encoded output chunk.
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::feed(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    m_partialLine.append(data);
+
+    int start = 0;
+    for (int i = 0; i < m_partialLine.size(); ++i) {
+        const char c = m_partialLine.at(i);
+        if (c != '\n' && c != '\r')
+            continue;
+
+        if (i > start)
+            parseLine(QString::fromUtf8(m_partialLine.constData() + start, i - start));
+        start = i + 1;
+    }
+
+    m_partialLine.remove(0, start);
+
+    if (m_partialLine.size() > kMaxPartialLineBytes)
+        m_partialLine.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses the pending incomplete line, e.g. after the process has exited.
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::finish()
+{
+    if (!m_partialLine.isEmpty())
+        parseLine(QString::fromUtf8(m_partialLine));
+
+    m_partialLine.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Forgets all state of the previous run and restarts the ETA clock.
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::reset()
+{
+    m_partialLine.clear();
+    m_runDirectory.clear();
+    m_statusText.clear();
+    m_progress   = 0.0;
+    m_etaSeconds = -1;
+    m_clock.restart();
+
+    emit progressChanged(m_progress, m_etaSeconds, m_statusText);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Matches a single output line against the known progress messages.
+ *
+ * Cheap substring checks select the candidate pattern so that ordinary lines cost no regex match.
+ *
+ * \param line One line of output without terminator.
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::parseLine(const QString &line)
+{
+    if (m_runDirectory.isEmpty() && line.contains(QLatin1String("Simulation data directory:"))) {
+        const QRegularExpressionMatch m = m_reRunDir.match(line);
+        if (m.hasMatch()) {
+            m_runDirectory = m.captured(1).trimmed();
+
+            Event ev;
+            ev.type = EventType::RunDirectory;
+            ev.text = m_runDirectory;
+            emitEvent(ev, tr("Run directory: %1").arg(m_runDirectory));
+        }
+        return;
+    }
+
+    if (line.contains(QLatin1String("Timestep:"))) {
+        const QRegularExpressionMatch m = m_reOpenEmsTimestep.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type  = EventType::TimeStep;
+            ev.text  = line;
+            ev.step  = m.captured(1).toInt();
+            ev.value = m.captured(2).toDouble();
+
+            if (m_energyLimitDb < 0.0)
+                updateProgress(qBound(0.0, ev.value / m_energyLimitDb, 1.0));
+
+            emitEvent(ev, tr("openEMS: timestep %1, energy %2 dB (limit %3 dB)")
+                              .arg(ev.step).arg(ev.value, 0, 'f', 1).arg(m_energyLimitDb, 0, 'f', 0));
+        }
+        return;
+    }
+
+    if (line.contains(QLatin1String("It "))) {
+        const QRegularExpressionMatch m = m_rePalaceSweep.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type  = EventType::SweepStep;
+            ev.text  = line;
+            ev.step  = m.captured(1).toInt();
+            ev.total = m.captured(2).toInt();
+            ev.value = m.captured(3).toDouble();
+
+            if (ev.total > 0)
+                updateProgress(double(ev.step - 1) / ev.total);
+
+            const QString status = m.captured(3).isEmpty()
+                ? tr("Palace: step %1/%2").arg(ev.step).arg(ev.total)
+                : tr("Palace: step %1/%2 (%3 GHz)").arg(ev.step).arg(ev.total).arg(ev.value, 0, 'g', 6);
+            emitEvent(ev, status);
+            return;
+        }
+    }
+
+    if (line.contains(QLatin1String("KSP residual norm"))) {
+        const QRegularExpressionMatch m = m_rePalaceResidual.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type  = EventType::ResidualNorm;
+            ev.text  = line;
+            ev.step  = m.captured(1).toInt();
+            ev.value = m.captured(2).toDouble();
+            emitEvent(ev, m_statusText);
+        }
+        return;
+    }
+
+    if (line.contains(QLatin1String("converged"), Qt::CaseInsensitive)) {
+        const QRegularExpressionMatch m = m_rePalaceConverged.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type = EventType::SolverConverged;
+            ev.text = line;
+            ev.step = m.captured(1).toInt();
+            emitEvent(ev, m_statusText);
+            return;
+        }
+    }
+
+    if (line.contains(QLatin1String("MAIN:"))) {
+        const QRegularExpressionMatch m = m_reElmerStep.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type  = EventType::SolverStep;
+            ev.text  = line;
+            ev.step  = m.captured(1).toInt();
+            ev.total = m.captured(2).toInt();
+
+            if (ev.total > 0)
+                updateProgress(double(ev.step - 1) / ev.total);
+
+            emitEvent(ev, tr("Elmer: step %1/%2").arg(ev.step).arg(ev.total));
+        }
+        return;
+    }
+
+    if (line.contains(QLatin1String("ComputeChange:"))) {
+        const QRegularExpressionMatch m = m_reElmerChange.match(line);
+        if (m.hasMatch()) {
+            Event ev;
+            ev.type  = EventType::ResidualNorm;
+            ev.text  = line;
+            ev.step  = m.captured(1).toInt();
+            ev.value = m.captured(2).toDouble();
+            emitEvent(ev, m_statusText);
+        }
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Publishes a parsed event together with the current progress state.
+ *
+ * \param event  Parsed event.
+ * \param status Human readable status line for the progress display.
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::emitEvent(const Event &event, const QString &status)
+{
+    m_statusText = status;
+
+    emit eventParsed(event);
+    emit progressChanged(m_progress, m_etaSeconds, m_statusText);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Advances the overall progress and re-estimates the remaining time.
+ *
+ * Progress never moves backwards (e.g. when openEMS energy rises again before decaying). The ETA is
+ * extrapolated linearly from the wall time elapsed since reset().
+ *
+ * \param fraction Completed fraction in [0, 1].
+ **********************************************************************************************************************/
+void SimulationLogAnalyzer::updateProgress(double fraction)
+{
+    if (fraction <= m_progress)
+        return;
+
+    m_progress = qMin(fraction, 1.0);
+
+    const qint64 elapsedMs = m_clock.elapsed();
+    m_etaSeconds = (m_progress > 0.0 && m_progress < 1.0)
+        ? qint64(elapsedMs * (1.0 - m_progress) / m_progress / 1000.0)
+        : (m_progress >= 1.0 ? 0 : -1);
+}
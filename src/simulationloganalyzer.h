@@ -0,0 +1,103 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SIMULATIONLOGANALYZER_H
+#define SIMULATIONLOGANALYZER_H
+
+#include <QObject>
+#include <QString>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QRegularExpression>
+
+/*!*******************************************************************************************************************
+ * \class SimulationLogAnalyzer
+ * \brief Line-oriented streaming parser for solver output.
+ *
+ * Process output is fed in arbitrary chunks; only the current incomplete line is buffered, so the
+ * accumulated log never has to be materialized as a string. Each complete line is matched against the
+ * progress messages of the supported tools:
+ *  - gds2palace: "Simulation data directory: <dir>"
+ *  - Palace: frequency sweep steps "It i/n: ..." and linear solver convergence/residual lines
+ *  - openEMS: "Timestep: ... Energy: ~x (y dB)" lines, with progress measured against the energy limit
+ *  - Elmer: "MAIN: Scanning/Time: i/n" steps and ComputeChange convergence lines
+ *
+ * Recognized lines are reported as structured events; progress and an ETA derived from the elapsed
+ * wall time are published whenever the overall fraction advances.
+ **********************************************************************************************************************/
+class SimulationLogAnalyzer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class EventType { RunDirectory, SweepStep, SolverConverged, ResidualNorm, TimeStep, SolverStep };
+
+    struct Event
+    {
+        EventType type  = EventType::RunDirectory;
+        QString   text;              // run directory or matched line
+        int       step  = 0;         // sweep/scan step or timestep or iteration count
+        int       total = 0;         // number of steps, 0 if unknown
+        double    value = 0.0;       // frequency [GHz], residual or energy [dB]
+    };
+
+    explicit SimulationLogAnalyzer(QObject *parent = nullptr);
+
+    void                        feed(const QByteArray &data);
+    void                        finish();
+    void                        reset();
+
+    void                        setEnergyLimitDb(double limitDb) { m_energyLimitDb = limitDb; }
+
+    QString                     runDirectory() const { return m_runDirectory; }
+    double                      progress() const { return m_progress; }
+    qint64                      etaSeconds() const { return m_etaSeconds; }
+    QString                     statusText() const { return m_statusText; }
+
+signals:
+    void                        eventParsed(const SimulationLogAnalyzer::Event &event);
+    void                        progressChanged(double fraction, qint64 etaSeconds, const QString &status);
+
+private:
+    void                        parseLine(const QString &line);
+    void                        emitEvent(const Event &event, const QString &status);
+    void                        updateProgress(double fraction);
+
+private:
+    QByteArray                  m_partialLine;
+
+    QString                     m_runDirectory;
+    QString                     m_statusText;
+    double                      m_progress = 0.0;
+    qint64                      m_etaSeconds = -1;
+    double                      m_energyLimitDb = -40.0;
+
+    QElapsedTimer               m_clock;
+
+    const QRegularExpression    m_reRunDir;
+    const QRegularExpression    m_rePalaceSweep;
+    const QRegularExpression    m_rePalaceConverged;
+    const QRegularExpression    m_rePalaceResidual;
+    const QRegularExpression    m_reOpenEmsTimestep;
+    const QRegularExpression    m_reElmerStep;
+    const QRegularExpression    m_reElmerChange;
+};
+
+#endif // SIMULATIONLOGANALYZER_H
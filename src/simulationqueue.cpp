@@ -0,0 +1,616 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QTimer>
+
+#include "simulationqueue.h"
+#include "simulationrunner.h"
+
+/*!*******************************************************************************************************************
+ * \brief Constructs an empty queue; the core budget is detected when the first job is dispatched.
+ *
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+SimulationQueue::SimulationQueue(QObject *parent)
+    : QObject(parent)
+{
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the total number of cores shared by all running jobs; 0 re-enables auto-detection.
+ *
+ * Lowering the budget does not affect running jobs, it only delays the dispatch of queued ones.
+ **********************************************************************************************************************/
+void SimulationQueue::setCoreBudget(int cores)
+{
+    m_budget = qMax(0, cores);
+    schedule();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Enables or disables pipelined preprocessing for jobs that have not been dispatched yet.
+ **********************************************************************************************************************/
+void SimulationQueue::setPipelined(bool enabled)
+{
+    m_pipelined = enabled;
+    schedule();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the number of cores reserved for preprocessing in pipelined mode (at least 1).
+ *
+ * The reservation is also the number of jobs that may be preprocessed ahead of the running solver.
+ **********************************************************************************************************************/
+void SimulationQueue::setPreprocessCores(int cores)
+{
+    m_preprocessCores = qMax(1, cores);
+    schedule();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Applies the queue preferences: pipelined preprocessing (PIPELINE_PREPROCESSING) and its core
+ *        reservation (PREPROCESS_CORES).
+ **********************************************************************************************************************/
+void SimulationQueue::applyPreferences(const QMap<QString, QVariant> &preferences)
+{
+    m_preprocessCores = qMax(1, preferences.value(QStringLiteral("PREPROCESS_CORES"), 1).toInt());
+    setPipelined(preferences.value(QStringLiteral("PIPELINE_PREPROCESSING"), false).toBool());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds a job to the end of the queue.
+ *
+ * Dispatch is deferred to the event loop, so jobs enqueued in one go (a command line batch or a sweep) are
+ * dispatched together and share the free cores instead of the first job taking all of them.
+ *
+ * \param spec Model, backend and settings snapshot of the job.
+ * \return Id of the new job.
+ **********************************************************************************************************************/
+int SimulationQueue::enqueue(const JobSpec &spec)
+{
+    Job job;
+    job.spec = spec;
+    job.spec.simKey = spec.simKey.trimmed().toLower();
+
+    job.info.id             = m_nextId++;
+    job.info.name           = spec.name;
+    job.info.simKey         = job.spec.simKey;
+    job.info.scriptPath     = spec.simSettings.value("RunPythonScript").toString().trimmed();
+    job.info.runDir         = spec.simSettings.value("RunDir").toString().trimmed();
+    job.info.requestedCores = qMax(0, spec.cores);
+
+    if (job.info.name.isEmpty())
+        job.info.name = QString("Job %1").arg(job.info.id);
+
+    const int id = job.info.id;
+    m_jobs.insert(id, job);
+    m_order.append(id);
+
+    emit jobAdded(id);
+    scheduleLater();
+    return id;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Cancels a job: queued jobs are dropped, dispatched jobs are stopped.
+ *
+ * \param id Job id.
+ * \return True if the job was queued or dispatched; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationQueue::cancel(int id)
+{
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end())
+        return false;
+
+    Job &job = it.value();
+    if (job.info.state == JobState::Queued) {
+        job.info.state = JobState::Cancelled;
+        emit jobStateChanged(id, job.info.state);
+        if (isIdle())
+            emit idle();
+        return true;
+    }
+
+    if (!isFinalState(job.info.state) && job.runner) {
+        job.cancelRequested = true;
+        job.runner->stop();
+        return true;
+    }
+
+    return false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Cancels all waiting jobs first and then stops all jobs with a running process.
+ **********************************************************************************************************************/
+void SimulationQueue::cancelAll()
+{
+    for (int id : m_order) {
+        const JobState state = m_jobs.value(id).info.state;
+        if (state == JobState::Queued || state == JobState::Preprocessed)
+            cancel(id);
+    }
+    for (int id : m_order) {
+        if (!isFinalState(m_jobs.value(id).info.state))
+            cancel(id);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a snapshot of the job state, or a default JobInfo (id 0) for unknown ids.
+ **********************************************************************************************************************/
+SimulationQueue::JobInfo SimulationQueue::jobInfo(int id) const
+{
+    return m_jobs.value(id).info;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the collected output of a job (the most recent kMaxJobLogBytes bytes).
+ **********************************************************************************************************************/
+QByteArray SimulationQueue::jobLog(int id) const
+{
+    return m_jobs.value(id).log;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the runner of a running job, or nullptr if the job is not running.
+ **********************************************************************************************************************/
+SimulationRunner *SimulationQueue::jobRunner(int id) const
+{
+    return m_jobs.value(id).runner;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of jobs with a running process (preprocessing or solver stage).
+ **********************************************************************************************************************/
+int SimulationQueue::runningCount() const
+{
+    int n = 0;
+    for (const Job &job : m_jobs) {
+        if (job.info.state == JobState::Running || job.info.state == JobState::Preprocessing)
+            ++n;
+    }
+    return n;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of jobs waiting for dispatch or, once preprocessed, for their solver stage.
+ **********************************************************************************************************************/
+int SimulationQueue::pendingCount() const
+{
+    int n = 0;
+    for (const Job &job : m_jobs) {
+        if (job.info.state == JobState::Queued || job.info.state == JobState::Preprocessed)
+            ++n;
+    }
+    return n;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if no job is queued or running.
+ **********************************************************************************************************************/
+bool SimulationQueue::isIdle() const
+{
+    return runningCount() == 0 && pendingCount() == 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a display name for a job state.
+ **********************************************************************************************************************/
+QString SimulationQueue::stateName(JobState state)
+{
+    switch (state) {
+    case JobState::Queued:        return QStringLiteral("Queued");
+    case JobState::Preprocessing: return QStringLiteral("Preprocessing");
+    case JobState::Preprocessed:  return QStringLiteral("Waiting for solver");
+    case JobState::Running:       return QStringLiteral("Running");
+    case JobState::Finished:      return QStringLiteral("Finished");
+    case JobState::Failed:        return QStringLiteral("Failed");
+    case JobState::Cancelled:     return QStringLiteral("Cancelled");
+    }
+    return QString();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true for the end states of a job: finished, failed or cancelled.
+ **********************************************************************************************************************/
+bool SimulationQueue::isFinalState(JobState state)
+{
+    return state == JobState::Finished || state == JobState::Failed || state == JobState::Cancelled;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Computes the number of cores assigned to the next job.
+ *
+ * A job with an explicit request gets that many cores, clamped to the budget. Otherwise the free cores
+ * are split evenly over the jobs still waiting, so a single job gets the whole machine and a long queue
+ * runs one single-core job per core.
+ *
+ * \param requested   Cores requested by the job, 0 for automatic.
+ * \param freeCores   Cores not used by running jobs.
+ * \param budget      Total core budget.
+ * \param waitingJobs Number of waiting jobs including this one.
+ * \return Cores to assign; 0 if nothing can be assigned.
+ **********************************************************************************************************************/
+int SimulationQueue::coresForJob(int requested, int freeCores, int budget, int waitingJobs)
+{
+    if (budget <= 0)
+        return 0;
+
+    if (requested > 0)
+        return qMin(requested, budget);
+
+    if (freeCores <= 0)
+        return 0;
+
+    return qMax(1, freeCores / qMax(1, waitingJobs));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Schedules a single dispatch pass on the next event loop iteration.
+ **********************************************************************************************************************/
+void SimulationQueue::scheduleLater()
+{
+    if (m_dispatchPending)
+        return;
+
+    m_dispatchPending = true;
+    QTimer::singleShot(0, this, [this]() {
+        m_dispatchPending = false;
+        schedule();
+    });
+}
+
+/*!*******************************************************************************************************************
+ * \brief Dispatches queued jobs in FIFO order while enough cores are free.
+ *
+ * Jobs of a Python model that is already running are skipped until that run has finished. Re-entrant
+ * calls (a job failing synchronously while it is started) are folded into another pass of the loop.
+ * In pipelined mode, and after switching it off until the preprocessed jobs have drained, the pass is
+ * delegated to schedulePipelined().
+ **********************************************************************************************************************/
+void SimulationQueue::schedule()
+{
+    if (m_scheduling) {
+        m_rescheduleRequested = true;
+        return;
+    }
+
+    m_scheduling = true;
+    do {
+        m_rescheduleRequested = false;
+
+        bool staged = false;
+        for (const Job &job : m_jobs) {
+            if (job.info.state == JobState::Preprocessing || job.info.state == JobState::Preprocessed)
+                staged = true;
+        }
+
+        if (m_pipelined || staged) {
+            schedulePipelined();
+            continue;
+        }
+
+        QList<int> waiting;
+        for (int id : m_order) {
+            if (m_jobs.value(id).info.state == JobState::Queued)
+                waiting.append(id);
+        }
+
+        auto dispatchable = [this](int id) {
+            const Job &job = m_jobs[id];
+            return job.info.state == JobState::Queued &&
+                   (job.info.scriptPath.isEmpty() || !scriptIsRunning(job.info.scriptPath));
+        };
+
+        for (int i = 0; i < waiting.size(); ++i) {
+            if (!dispatchable(waiting.at(i)))
+                continue;
+
+            int waitingJobs = 0;
+            for (int k = i; k < waiting.size(); ++k) {
+                if (dispatchable(waiting.at(k)))
+                    ++waitingJobs;
+            }
+
+            Job &job = m_jobs[waiting.at(i)];
+            ensureCoreBudget(job.spec.preferences);
+
+            const int freeCores = m_budget - m_usedCores;
+            const int cores = coresForJob(job.info.requestedCores, freeCores, m_budget, waitingJobs);
+            if (cores <= 0 || cores > freeCores)
+                break;
+
+            startJob(job, cores);
+        }
+    } while (m_rescheduleRequested);
+    m_scheduling = false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief One dispatch pass of the pipelined stage graph.
+ *
+ * Solver stages first: preprocessed jobs (and openEMS jobs, which have no preprocessing stage) are started in
+ * FIFO order on the cores not reserved for preprocessing. Then queued Palace/Elmer jobs start their
+ * preprocessing stage on one reserved core each, as long as fewer jobs than reserved cores are being
+ * preprocessed or waiting for their solver.
+ **********************************************************************************************************************/
+void SimulationQueue::schedulePipelined()
+{
+    auto scriptFree = [this](const Job &job) {
+        return job.info.scriptPath.isEmpty() || !scriptIsRunning(job.info.scriptPath);
+    };
+
+    for (int id : m_order) {
+        Job &job = m_jobs[id];
+        const bool ready = job.info.state == JobState::Preprocessed ||
+                           (job.info.state == JobState::Queued && !hasPreprocessingStage(job) && scriptFree(job));
+        if (!ready)
+            continue;
+
+        ensureCoreBudget(job.spec.preferences);
+
+        const int solverBudget = qMax(1, m_budget - m_preprocessCores);
+        int solverCores = 0;
+        for (const Job &other : m_jobs) {
+            if (other.info.state == JobState::Running)
+                solverCores += other.info.cores;
+        }
+
+        const int freeCores = solverBudget - solverCores;
+        const int cores = coresForJob(job.info.requestedCores, freeCores, solverBudget, 1);
+        if (cores <= 0 || cores > freeCores)
+            break;
+
+        startSolverStage(job, cores);
+    }
+
+    if (!m_pipelined)
+        return;
+
+    int ahead = 0;
+    for (const Job &job : m_jobs) {
+        if (job.info.state == JobState::Preprocessing || job.info.state == JobState::Preprocessed)
+            ++ahead;
+    }
+
+    for (int id : m_order) {
+        if (ahead >= m_preprocessCores)
+            break;
+
+        Job &job = m_jobs[id];
+        if (job.info.state != JobState::Queued || !hasPreprocessingStage(job) || !scriptFree(job))
+            continue;
+
+        ensureCoreBudget(job.spec.preferences);
+        startJob(job, 1);
+        ++ahead;
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates the runner of a job, assigns its cores and starts the selected backend.
+ *
+ * In pipelined mode Palace/Elmer jobs start in the Preprocessing state and their runner holds before the
+ * solver stage until startSolverStage() assigns the solver cores.
+ **********************************************************************************************************************/
+void SimulationQueue::startJob(Job &job, int cores)
+{
+    const int id = job.info.id;
+
+    job.runner = new SimulationRunner(this);
+    job.runner->setPreferences(job.spec.preferences);
+    job.runner->setSimSettings(job.spec.simSettings);
+    job.runner->setSimToolKey(job.spec.simKey);
+    job.runner->setCoreLimit(cores);
+
+    connect(job.runner, &SimulationRunner::output, this, [this, id](const QByteArray &data) {
+        auto it = m_jobs.find(id);
+        if (it == m_jobs.end())
+            return;
+        appendJobLog(it.value(), data);
+        emit jobOutput(id, data);
+    });
+    connect(job.runner, &SimulationRunner::errorOccurred, this, [this, id](const QString &message, bool) {
+        auto it = m_jobs.find(id);
+        if (it == m_jobs.end())
+            return;
+        const QByteArray data = QString("[Error] %1\n").arg(message).toUtf8();
+        appendJobLog(it.value(), data);
+        emit jobOutput(id, data);
+    });
+    connect(job.runner, &SimulationRunner::runDirectoryDetected, this, [this, id](const QString &runDir) {
+        auto it = m_jobs.find(id);
+        if (it != m_jobs.end())
+            it.value().info.runDir = runDir;
+    });
+    connect(job.runner, &SimulationRunner::preprocessingFinished, this, [this, id](const QString &) {
+        onJobPreprocessed(id);
+    });
+    connect(job.runner, &SimulationRunner::finished, this, [this, id](int exitCode) {
+        onJobFinished(id, exitCode);
+    });
+
+    const bool pipelined = m_pipelined && hasPreprocessingStage(job);
+    job.runner->setHoldBeforeSolver(pipelined);
+
+    job.info.cores = cores;
+    job.info.state = pipelined ? JobState::Preprocessing : JobState::Running;
+    m_usedCores += cores;
+
+    emit jobStateChanged(id, job.info.state);
+
+    const QByteArray header = QString(pipelined ? "[Job %1] %2 (%3, preprocessing on %4 reserved core)\n"
+                                                : "[Job %1] %2 (%3, %4 cores)\n")
+                                  .arg(id)
+                                  .arg(job.info.name, job.info.simKey)
+                                  .arg(cores)
+                                  .toUtf8();
+    appendJobLog(job, header);
+    emit jobOutput(id, header);
+
+    SimulationRunner *runner = job.runner;
+    if (job.spec.simKey == QLatin1String("openems"))
+        runner->runOpenEMS();
+    else
+        runner->runPalace();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the solver stage of a job on the given cores.
+ *
+ * Jobs without a preprocessing stage are started from scratch; preprocessed jobs resume their held runner
+ * with the solver core limit.
+ **********************************************************************************************************************/
+void SimulationQueue::startSolverStage(Job &job, int cores)
+{
+    if (job.info.state == JobState::Queued) {
+        startJob(job, cores);
+        return;
+    }
+
+    const int id = job.info.id;
+
+    job.info.cores = cores;
+    job.info.state = JobState::Running;
+    m_usedCores += cores;
+
+    emit jobStateChanged(id, job.info.state);
+
+    const QByteArray header = QString("[Job %1] solver stage (%2 cores)\n").arg(id).arg(cores).toUtf8();
+    appendJobLog(job, header);
+    emit jobOutput(id, header);
+
+    SimulationRunner *runner = job.runner;
+    runner->setCoreLimit(cores);
+    runner->continueWithSolver();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Releases the preprocessing core of a job whose runner holds before the solver stage.
+ **********************************************************************************************************************/
+void SimulationQueue::onJobPreprocessed(int id)
+{
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end())
+        return;
+
+    Job &job = it.value();
+    if (job.info.state != JobState::Preprocessing)
+        return;
+
+    m_usedCores -= job.info.cores;
+    job.info.cores = 0;
+    job.info.state = JobState::Preprocessed;
+
+    emit jobStateChanged(id, job.info.state);
+
+    schedule();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Releases the cores of a finished job, records its final state and dispatches further jobs.
+ *
+ * Also handles jobs ending in their preprocessing stage or while waiting for their solver.
+ **********************************************************************************************************************/
+void SimulationQueue::onJobFinished(int id, int exitCode)
+{
+    auto it = m_jobs.find(id);
+    if (it == m_jobs.end())
+        return;
+
+    Job &job = it.value();
+    if (job.info.state == JobState::Queued || isFinalState(job.info.state))
+        return;
+
+    m_usedCores -= job.info.cores;
+
+    job.info.exitCode = exitCode;
+    if (job.cancelRequested)
+        job.info.state = JobState::Cancelled;
+    else
+        job.info.state = exitCode == 0 ? JobState::Finished : JobState::Failed;
+
+    if (job.runner) {
+        job.runner->deleteLater();
+        job.runner = nullptr;
+    }
+
+    emit jobStateChanged(id, job.info.state);
+
+    schedule();
+
+    if (isIdle())
+        emit idle();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Appends output to the job log, dropping the oldest complete lines beyond kMaxJobLogBytes.
+ **********************************************************************************************************************/
+void SimulationQueue::appendJobLog(Job &job, const QByteArray &data)
+{
+    job.log.append(data);
+    if (job.log.size() <= kMaxJobLogBytes)
+        return;
+
+    int cut = job.log.size() - kMaxJobLogBytes;
+    const int nl = job.log.indexOf('\n', cut);
+    if (nl >= 0)
+        cut = nl + 1;
+    job.log.remove(0, cut);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if a dispatched, not yet finished job uses the given Python model.
+ **********************************************************************************************************************/
+bool SimulationQueue::scriptIsRunning(const QString &scriptPath) const
+{
+    for (const Job &job : m_jobs) {
+        if (job.info.state != JobState::Queued && !isFinalState(job.info.state) &&
+            job.info.scriptPath == scriptPath)
+            return true;
+    }
+    return false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if the job runs the gds2palace preprocessing stage before its solver (Palace, Elmer).
+ **********************************************************************************************************************/
+bool SimulationQueue::hasPreprocessingStage(const Job &job) const
+{
+    return job.spec.simKey != QLatin1String("openems");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Detects the core budget from the given preferences unless it was set explicitly.
+ **********************************************************************************************************************/
+void SimulationQueue::ensureCoreBudget(const QMap<QString, QVariant> &preferences)
+{
+    if (m_budget > 0)
+        return;
+
+    SimulationRunner probe;
+    probe.setPreferences(preferences);
+
+    bool ok = false;
+    const int cores = probe.detectMpiCoreCount().cores.toInt(&ok);
+    m_budget = (ok && cores > 0) ? cores : 1;
+}
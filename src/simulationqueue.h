@@ -0,0 +1,159 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SIMULATIONQUEUE_H
+#define SIMULATIONQUEUE_H
+
+#include <QMap>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QByteArray>
+
+class SimulationRunner;
+
+/*!*******************************************************************************************************************
+ * \class SimulationQueue
+ * \brief Job scheduler that runs several simulation models concurrently within a global CPU-core budget.
+ *
+ * Every job owns its own SimulationRunner, log buffer and state. When a job is dispatched it is assigned
+ * a share of the free cores (its requested count, or an even split of the free cores over the waiting
+ * jobs) which the runner uses as MPI rank count / thread count. Jobs are started in FIFO order as long as
+ * cores are available; two jobs of the same Python model never run at the same time because they would
+ * write into the same run directory.
+ *
+ * The budget defaults to the core count reported by SimulationRunner::detectMpiCoreCount() for the
+ * preferences of the first dispatched job. The queue depends on QtCore only and is shared by the GUI and
+ * the headless command line runner.
+ *
+ * In pipelined mode every Palace/Elmer job runs as a two-stage graph: Queued -> Preprocessing -> Preprocessed
+ * -> Running (solver). A fixed reservation of preprocessing cores is taken out of the budget; the gds2palace
+ * stage of the next jobs runs on those cores while the solver of the current job uses the rest, and solvers
+ * are started back to back in FIFO order. openEMS jobs have no separate solver stage and go straight to
+ * Running.
+ **********************************************************************************************************************/
+class SimulationQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class JobState { Queued, Preprocessing, Preprocessed, Running, Finished, Failed, Cancelled };
+    Q_ENUM(JobState)
+
+    struct JobSpec
+    {
+        QString                 name;
+        QString                 simKey;                 // "openems", "palace" or "elmer"
+        QMap<QString, QVariant> simSettings;
+        QMap<QString, QVariant> preferences;
+        int                     cores = 0;              // 0 = share of the free budget
+    };
+
+    struct JobInfo
+    {
+        int                     id = 0;
+        QString                 name;
+        QString                 simKey;
+        QString                 scriptPath;
+        QString                 runDir;
+        int                     requestedCores = 0;
+        int                     cores = 0;
+        JobState                state = JobState::Queued;
+        int                     exitCode = 0;
+    };
+
+    explicit SimulationQueue(QObject *parent = nullptr);
+
+    void                        setCoreBudget(int cores);
+    int                         coreBudget() const { return m_budget; }
+    int                         usedCores() const { return m_usedCores; }
+
+    void                        setPipelined(bool enabled);
+    void                        setPreprocessCores(int cores);
+    void                        applyPreferences(const QMap<QString, QVariant> &preferences);
+    bool                        isPipelined() const { return m_pipelined; }
+    int                         preprocessCores() const { return m_preprocessCores; }
+
+    int                         enqueue(const JobSpec &spec);
+    bool                        cancel(int id);
+    void                        cancelAll();
+
+    QList<int>                  jobIds() const { return m_order; }
+    bool                        hasJob(int id) const { return m_jobs.contains(id); }
+    JobInfo                     jobInfo(int id) const;
+    QByteArray                  jobLog(int id) const;
+    SimulationRunner           *jobRunner(int id) const;
+
+    int                         runningCount() const;
+    int                         pendingCount() const;
+    bool                        isIdle() const;
+
+    static QString              stateName(JobState state);
+    static bool                 isFinalState(JobState state);
+    static int                  coresForJob(int requested, int freeCores, int budget, int waitingJobs);
+
+    static constexpr int        kMaxJobLogBytes = 4 * 1024 * 1024;
+
+signals:
+    void                        jobAdded(int id);
+    void                        jobStateChanged(int id, SimulationQueue::JobState state);
+    void                        jobOutput(int id, const QByteArray &data);
+    void                        idle();
+
+private:
+    struct Job
+    {
+        JobSpec                 spec;
+        JobInfo                 info;
+        QByteArray              log;
+        SimulationRunner       *runner = nullptr;
+        bool                    cancelRequested = false;
+    };
+
+    void                        schedule();
+    void                        scheduleLater();
+    void                        schedulePipelined();
+    void                        startJob(Job &job, int cores);
+    void                        startSolverStage(Job &job, int cores);
+    void                        onJobPreprocessed(int id);
+    void                        onJobFinished(int id, int exitCode);
+    bool                        hasPreprocessingStage(const Job &job) const;
+    void                        appendJobLog(Job &job, const QByteArray &data);
+    bool                        scriptIsRunning(const QString &scriptPath) const;
+    void                        ensureCoreBudget(const QMap<QString, QVariant> &preferences);
+
+private:
+    QMap<int, Job>              m_jobs;
+    QList<int>                  m_order;
+    int                         m_nextId = 1;
+
+    int                         m_budget = 0;
+    int                         m_usedCores = 0;
+
+    bool                        m_pipelined = false;
+    int                         m_preprocessCores = 1;
+
+    bool                        m_dispatchPending = false;
+    bool                        m_scheduling = false;
+    bool                        m_rescheduleRequested = false;
+};
+
+#endif // SIMULATIONQUEUE_H
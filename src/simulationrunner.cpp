@@ -0,0 +1,2403 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QSet>
+#include <QFile>
+#include <QTimer>
+#include <QPointer>
+#include <QProcess>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QRegularExpression>
+
+#include "runcache.h"
+#include "tracer.h"
+#include "wslHelper.h"
+#include "resultstore.h"
+#include "sparameterchecks.h"
+#include "sparametercombiner.h"
+#include "elmerresults.h"
+#include "palacesparameters.h"
+#include "hardwaretopology.h"
+#include "processtelemetry.h"
+#include "simulationrunner.h"
+#include "simulationloganalyzer.h"
+
+namespace {
+
+/*!*******************************************************************************************************************
+ * \brief Parses a band given as two frequencies in GHz ("2-8", "2:8" or "2 8").
+ **********************************************************************************************************************/
+bool parseStopBand(const QString &text, double &outMinHz, double &outMaxHz)
+{
+    static const QRegularExpression re(
+        QStringLiteral("^\\s*([0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)\\s*[-:,\\s]\\s*([0-9]*\\.?[0-9]+(?:[eE][-+]?[0-9]+)?)\\s*$"));
+    const QRegularExpressionMatch m = re.match(text);
+    if (!m.hasMatch())
+        return false;
+
+    outMinHz = m.captured(1).toDouble() * 1e9;
+    outMaxHz = m.captured(2).toDouble() * 1e9;
+    return outMaxHz > outMinHz;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the Touchstone files next to \a resultPath that are not older than it.
+ **********************************************************************************************************************/
+QStringList touchstoneFilesSince(const QString &resultPath)
+{
+    static const QRegularExpression reSnp(QStringLiteral("\\.s\\d+p$"), QRegularExpression::CaseInsensitiveOption);
+
+    const QFileInfo result(resultPath);
+    QStringList files;
+    for (const QFileInfo &fi : result.absoluteDir().entryInfoList(QDir::Files, QDir::Name))
+        if (reSnp.match(fi.fileName()).hasMatch() && fi.lastModified() >= result.lastModified())
+            files << fi.absoluteFilePath();
+    return files;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Constructs an idle runner with an empty configuration.
+ *
+ * \param parent Optional QObject parent.
+ **********************************************************************************************************************/
+SimulationRunner::SimulationRunner(QObject *parent)
+    : QObject(parent)
+    , m_logAnalyzer(new SimulationLogAnalyzer(this))
+    , m_telemetry(new ProcessTelemetry(this))
+    , m_convergenceTimer(new QTimer(this))
+{
+    m_convergenceTimer->setInterval(kConvergencePollMs);
+    connect(m_convergenceTimer, &QTimer::timeout, this, &SimulationRunner::pollConvergence);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the preferences (tool paths, run modes, WSL distro) used for the next run.
+ **********************************************************************************************************************/
+void SimulationRunner::setPreferences(const QMap<QString, QVariant> &preferences)
+{
+    m_preferences = preferences;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the simulation settings (RunPythonScript, RunDir, model keywords) used for the next run.
+ **********************************************************************************************************************/
+void SimulationRunner::setSimSettings(const QMap<QString, QVariant> &simSettings)
+{
+    m_simSettings = simSettings;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the simulation backend key ("palace", "elmer" or "openems").
+ **********************************************************************************************************************/
+void SimulationRunner::setSimToolKey(const QString &simKey)
+{
+    m_simToolKey = simKey.trimmed().toLower();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Limits the number of cores a run may use; 0 (default) uses all detected cores.
+ *
+ * Set by SimulationQueue to the share of the core budget assigned to a job. The limit replaces the detected
+ * MPI rank count of the Palace solver and is exported as OMP_NUM_THREADS to the openEMS and Elmer processes.
+ **********************************************************************************************************************/
+void SimulationRunner::setCoreLimit(int cores)
+{
+    m_coreLimit = qMax(0, cores);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true while a simulation process is running.
+ **********************************************************************************************************************/
+bool SimulationRunner::isRunning() const
+{
+    return m_process && m_process->state() == QProcess::Running;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace/Elmer simulation workflow.
+ *
+ * Runs the simulation in two stages:
+ *  - Stage 1: Executes the gds2palace Python model script to generate the run directory.
+ *  - Stage 2: Locates the generated configuration and launches the Palace or Elmer solver.
+ *
+ * Depending on platform and preferences, execution may occur natively, under WSL,
+ * or via an external launcher script.
+ *
+ * With the run cache enabled, a run with unchanged inputs and complete cached results finishes
+ * immediately, and a run whose preprocessing inputs are unchanged skips Stage 1.
+ *
+ * \return True if the run was started or served from the cache; false if the run could not be started,
+ *         in which case \c finished() has already been emitted.
+ **********************************************************************************************************************/
+bool SimulationRunner::runPalace()
+{
+    if (isRunning() || isWaitingForSolver())
+        return false;
+
+    PalaceRunContext ctx;
+    QString err;
+    if (!buildPalaceRunContext(ctx, err)) {
+        emit errorOccurred(err, true);
+        emit finished(1);
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    m_cacheKey = computeRunCacheKey(ctx.pythonCmd, gds2PalaceSolverIdentity(ctx), ctx.useWsl, ctx.distro);
+#else
+    m_cacheKey = computeRunCacheKey(ctx.pythonCmd, gds2PalaceSolverIdentity(ctx));
+#endif
+    m_cacheRunDir.clear();
+    m_solverRunDir.clear();
+    m_stoppedConverged = false;
+    m_runStarted = QDateTime::currentDateTime();
+
+    m_logAnalyzer->reset();
+    beginRunTelemetry();
+    beginRunReport();
+    emit started();
+
+    if (reuseCachedResults())
+        return true;
+
+    const RunCache::Entry preprocessed =
+        m_cacheKey.isValid() ? RunCache().lookupPreprocessed(m_cacheKey) : RunCache::Entry();
+    const bool reusePreprocessed =
+        preprocessed.isValid() &&
+        detectGds2PalaceSolverKind(preprocessed.runDir, QString()) != SolverKind::Unknown;
+
+    if (!reusePreprocessed)
+        logPalaceStartupInfo(ctx);
+
+    createPalaceProcess();
+    m_phase = Phase::PythonModel;
+
+    if (reusePreprocessed) {
+        appendText(QString("[Run cache partial hit: model, GDS and substrate unchanged, reusing the "
+                           "preprocessed run directory %1 and skipping gds2palace]\n")
+                       .arg(QDir::toNativeSeparators(preprocessed.runDir)));
+
+        m_simSettings["RunDir"] = preprocessed.runDir;
+        emit runDirectoryDetected(preprocessed.runDir);
+        m_report.setCacheStatus(QStringLiteral("partial"));
+
+        enterSolverStage(preprocessed.runDir);
+        return m_process != nullptr || isWaitingForSolver();
+    }
+
+    if (m_cacheKey.isValid())
+        RunCache().invalidate(ctx.runDirGuessWin);
+
+    startPalacePythonStage(ctx);
+
+    if (!m_process->waitForStarted(3000)) {
+        if (ctx.simKeyLower == QLatin1String("elmer"))
+            emit errorOccurred("Failed to start gds2palace Python preprocessing (Windows native).", false);
+#ifdef Q_OS_WIN
+        else if (!ctx.useWsl)
+            emit errorOccurred("Failed to start Palace Python preprocessing.", false);
+        else
+            emit errorOccurred("Failed to start Palace Python preprocessing under WSL.", false);
+#else
+        else
+            emit errorOccurred("Failed to start Palace Python preprocessing.", false);
+#endif
+        finishRun(3);
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the openEMS Python model with the configured interpreter and environment.
+ *
+ * A run whose model, GDS, substrate and interpreter match an earlier run with complete results is served
+ * from the run cache; successful runs record the Touchstone files written into their data directory.
+ *
+ * \return True if the process was started or the run was served from the cache; false if the run could not be started,
+ *         in which case \c finished() has already been emitted.
+ **********************************************************************************************************************/
+bool SimulationRunner::runOpenEMS()
+{
+    if (isRunning())
+        return false;
+
+    QString pythonPath = m_preferences.value("Python Path").toString().trimmed();
+    if (pythonPath.isEmpty()) {
+        pythonPath = QStringLiteral("python");
+    } else if (!QFileInfo::exists(pythonPath)) {
+        emit errorOccurred(QString("Python executable not found: %1").arg(pythonPath), true);
+        emit finished(1);
+        return false;
+    }
+
+    const QString scriptPath = m_simSettings.value("RunPythonScript").toString().trimmed();
+    if (scriptPath.isEmpty() || !QFileInfo::exists(scriptPath)) {
+        emit errorOccurred(QString("Python file '%1' does not exist.").arg(scriptPath), true);
+        emit finished(1);
+        return false;
+    }
+
+    QString runDir = m_simSettings.value("RunDir").toString().trimmed();
+    if (runDir.isEmpty() || !QDir(runDir).exists()) {
+        runDir = QFileInfo(scriptPath).absolutePath();
+    }
+
+    m_cacheKey = computeRunCacheKey(pythonPath, QString());
+    m_runStarted = QDateTime::currentDateTime();
+
+    m_logAnalyzer->reset();
+    m_logAnalyzer->setEnergyLimitDb(m_simSettings.value("energy_limit", -40.0).toDouble());
+    beginRunTelemetry();
+    beginRunReport();
+    emit started();
+
+    if (reuseCachedResults())
+        return true;
+
+    m_process = new QProcess(this);
+    m_phase = Phase::Solver;
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    for (auto it = m_preferences.constBegin(); it != m_preferences.constEnd(); ++it) {
+        const QString key = it.key();
+        const QString value = it.value().toString();
+
+        if (key == QLatin1String("Python Path")) {
+            QFileInfo pythonFile(value);
+            const QString pythonDir = pythonFile.absolutePath();
+            const QString currentPath = env.value(QStringLiteral("PATH"));
+
+            if (!currentPath.contains(pythonDir, Qt::CaseInsensitive)) {
+                env.insert(QStringLiteral("PATH"), pythonDir + QDir::listSeparator() + currentPath);
+            }
+        } else if (!env.contains(key)) {
+            env.insert(key, value);
+        }
+    }
+
+    const QString origScriptPath = QFileInfo(scriptPath).absolutePath();
+#ifdef Q_OS_WIN
+    const QString pathSep = ";";
+#else
+    const QString pathSep = ":";
+#endif
+    if (env.contains(QStringLiteral("PYTHONPATH"))) {
+        env.insert(QStringLiteral("PYTHONPATH"),
+                   origScriptPath + pathSep + env.value(QStringLiteral("PYTHONPATH")));
+    } else {
+        env.insert(QStringLiteral("PYTHONPATH"), origScriptPath);
+    }
+
+    env.remove(QStringLiteral("PYTHONHOME"));
+
+    if (m_coreLimit > 0)
+        env.insert(QStringLiteral("OMP_NUM_THREADS"), QString::number(m_coreLimit));
+
+    m_process->setProcessEnvironment(env);
+    m_process->setWorkingDirectory(runDir);
+
+    connectProcessIo();
+
+    connect(m_process,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this,
+            [this, runDir](int exitCode, QProcess::ExitStatus)
+            {
+                appendText(QString("\n[Simulation finished with exit code %1]\n").arg(exitCode));
+
+                m_logAnalyzer->finish();
+                beginReportStage(QStringLiteral("postprocess"));
+                const QString simDir = detectRunDirFromLog();
+                if (!simDir.isEmpty()) {
+                    const QString dataDir = QDir(runDir).absoluteFilePath(simDir);
+                    if (exitCode == 0)
+                        storeRunCacheResults(dataDir);
+                    else if (m_cacheKey.isValid())
+                        RunCache().invalidate(dataDir);
+                }
+
+                finishRun(exitCode);
+            });
+
+    appendText("Starting OpenEMS simulation...\n");
+    appendText(QString("[RUN] %1 %2\n")
+                   .arg(QDir::toNativeSeparators(pythonPath),
+                        QDir::toNativeSeparators(scriptPath)));
+
+    m_process->start(pythonPath, QStringList() << scriptPath);
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred("Failed to start simulation process.", false);
+        finishRun(3);
+        return false;
+    }
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Resumes a run held after its preprocessing stage and starts the solver stage.
+ *
+ * The solver uses the core limit in effect at this point, so a scheduler can assign the solver cores only
+ * when they become free.
+ *
+ * \return True if the solver stage was started; false if the run was not waiting for its solver or the solver
+ *         could not be started, in which case \c finished() has already been emitted.
+ **********************************************************************************************************************/
+bool SimulationRunner::continueWithSolver()
+{
+    if (!isWaitingForSolver())
+        return false;
+
+    m_phase = Phase::None;
+    createPalaceProcess();
+
+    startGds2PalaceSolver(m_preprocessedRunDir);
+    return m_process != nullptr;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Stops the running simulation process.
+ *
+ * Requests termination and kills the process if it is still alive after 1.5 s. The process
+ * finished handler then completes the run with the process exit code. A run held between its
+ * preprocessing and solver stages has no process and finishes immediately with exit code 1.
+ **********************************************************************************************************************/
+void SimulationRunner::stop()
+{
+    if (isWaitingForSolver()) {
+        appendText("\n[Run stopped before the solver stage]\n");
+        finishRun(1);
+        return;
+    }
+
+    if (!isRunning())
+        return;
+
+    m_phase = Phase::None;
+    terminateProcess();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Requests termination of the current process and kills it if it is still alive after 1.5 s.
+ **********************************************************************************************************************/
+void SimulationRunner::terminateProcess()
+{
+    QPointer<QProcess> p = m_process;
+    p->terminate();
+
+    auto *t = new QTimer(p);
+    t->setSingleShot(true);
+    connect(t, &QTimer::timeout, p, [p]() {
+        if (p && p->state() != QProcess::NotRunning)
+            p->kill();
+    });
+
+    t->start(1500);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Feeds raw process output to the log analyzer and forwards it to the listeners.
+ *
+ * \param data Raw UTF-8 encoded output from a running process or a runner banner.
+ **********************************************************************************************************************/
+void SimulationRunner::appendOutput(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    m_logAnalyzer->feed(data);
+    emit output(data);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Convenience overload of appendOutput() for banner text.
+ **********************************************************************************************************************/
+void SimulationRunner::appendText(const QString &text)
+{
+    appendOutput(text.toUtf8());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Forwards standard output and standard error of the current process to appendOutput().
+ **********************************************************************************************************************/
+void SimulationRunner::connectProcessIo()
+{
+    QProcess *p = m_process;
+
+    connect(p, &QProcess::readyReadStandardOutput, this, [this, p]() {
+        appendOutput(p->readAllStandardOutput());
+    });
+    connect(p, &QProcess::readyReadStandardError, this, [this, p]() {
+        appendOutput(p->readAllStandardError());
+    });
+    connect(p, &QProcess::started, this, [this, p]() {
+        m_telemetry->attach(p->processId(), stageName());
+        beginReportStage(stageName());
+        if (m_phase == Phase::Solver && m_simToolKey == QLatin1String("palace"))
+            startConvergenceWatch();
+    });
+    connect(p, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this](int exitCode, QProcess::ExitStatus) { endReportStage(exitCode); });
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates the process of a Palace/Elmer stage and routes its completion to onPalaceProcessFinished().
+ **********************************************************************************************************************/
+void SimulationRunner::createPalaceProcess()
+{
+    m_process = new QProcess(this);
+
+    connectProcessIo();
+
+    connect(m_process,
+            QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
+            this,
+            [this](int exitCode, QProcess::ExitStatus) { onPalaceProcessFinished(exitCode); });
+}
+
+/*!*******************************************************************************************************************
+ * \brief Schedules the current process for deletion and resets the phase.
+ **********************************************************************************************************************/
+void SimulationRunner::releaseProcess()
+{
+    if (m_process) {
+        m_process->deleteLater();
+        m_process = nullptr;
+    }
+
+    m_phase = Phase::None;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Single exit path of a run: releases the process and emits \c finished().
+ *
+ * \param exitCode Exit code reported for the run.
+ **********************************************************************************************************************/
+void SimulationRunner::finishRun(int exitCode)
+{
+    m_convergenceTimer->stop();
+
+    Touchstone::Network results;
+    QString resultSource;
+    if (readRunResults(exitCode, results, resultSource))
+        checkRunResults(results);
+
+    writeRunTelemetry();
+    writeRunReport(exitCode);
+    if (!resultSource.isEmpty())
+        ingestRunResults(results, resultSource);
+    releaseProcess();
+    emit finished(exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Clears the telemetry of the previous run and applies the sampling interval (TELEMETRY_INTERVAL_MS).
+ **********************************************************************************************************************/
+void SimulationRunner::beginRunTelemetry()
+{
+    m_telemetry->reset();
+    m_telemetry->setInterval(m_preferences.value(QStringLiteral("TELEMETRY_INTERVAL_MS"), 1000).toInt());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Stops sampling, logs the per-stage telemetry and writes the samples next to the run directory.
+ *
+ * The file format follows TELEMETRY_FORMAT (0 = CSV, 1 = JSON). Runs without samples (cache hits, runs that
+ * failed to start, unsupported platforms) write nothing.
+ **********************************************************************************************************************/
+void SimulationRunner::writeRunTelemetry()
+{
+    m_telemetry->detach();
+    if (m_telemetry->samples().isEmpty())
+        return;
+
+    for (const ProcessTelemetry::StageSummary &stage : m_telemetry->stageSummaries())
+        appendText(QString("[Telemetry] %1\n").arg(stage.toString()));
+
+    const QString runDir = resultRunDir();
+    if (runDir.isEmpty())
+        return;
+
+    const ProcessTelemetry::Format format =
+        m_preferences.value(QStringLiteral("TELEMETRY_FORMAT"), 0).toInt() == 1 ? ProcessTelemetry::Format::Json
+                                                                                : ProcessTelemetry::Format::Csv;
+    const QString path = ProcessTelemetry::filePathFor(runDir, format);
+
+    QString err;
+    if (m_telemetry->write(path, format, err))
+        appendText(QString("[Telemetry: %1]\n").arg(QDir::toNativeSeparators(path)));
+    else
+        appendText(QString("[Warning] %1\n").arg(err));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records a stage that ran before the next run was started, e.g. saving the model in the GUI.
+ *
+ * The stage is added to the report of the next run.
+ **********************************************************************************************************************/
+void SimulationRunner::notePreRunStage(const QString &stage, const QDateTime &started, qint64 durationMs)
+{
+    RunReport::Stage s;
+    s.name = stage;
+    s.started = started;
+    s.finished = started.addMSecs(durationMs);
+    m_preRunStages.append(s);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the report of a new run with its fingerprints, inputs, core limit and pre-run stages.
+ **********************************************************************************************************************/
+void SimulationRunner::beginRunReport()
+{
+    m_report.begin(m_simToolKey, m_simSettings.value("RunPythonScript").toString().trimmed());
+    m_report.setFingerprint(m_cacheKey.prep, m_cacheKey.run);
+    m_report.setCacheStatus(m_cacheKey.isValid() ? QStringLiteral("miss") : QStringLiteral("disabled"));
+    m_report.setCores(m_coreLimit);
+    m_report.setInput(QStringLiteral("model"), m_simSettings.value("RunPythonScript").toString());
+    m_report.setInput(QStringLiteral("gds"), m_simSettings.value("GdsFile").toString());
+    m_report.setInput(QStringLiteral("substrate"), m_simSettings.value("SubstrateFile").toString());
+
+    for (const RunReport::Stage &stage : qAsConst(m_preRunStages))
+        m_report.addStage(stage.name, stage.started, stage.durationMs());
+    m_preRunStages.clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Opens a report stage and emits \c stageStarted().
+ **********************************************************************************************************************/
+void SimulationRunner::beginReportStage(const QString &stage)
+{
+    if (!m_report.isActive())
+        return;
+
+    endReportStage(0);
+    m_report.beginStage(stage);
+    emit stageStarted(stage);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Closes the open report stage, if any, and emits \c stageFinished().
+ **********************************************************************************************************************/
+void SimulationRunner::endReportStage(int exitCode)
+{
+    if (!m_report.hasOpenStage())
+        return;
+
+    const RunReport::Stage stage = m_report.endStage(exitCode);
+    emit stageFinished(stage.name, stage.durationMs(), exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Completes the run report and writes it as run_report.json into the run directory.
+ *
+ * Disabled with the RUN_REPORT preference.
+ **********************************************************************************************************************/
+void SimulationRunner::writeRunReport(int exitCode)
+{
+    if (!m_report.isActive())
+        return;
+
+    endReportStage(exitCode);
+    m_report.finish(exitCode);
+
+    if (!m_preferences.value(QStringLiteral("RUN_REPORT"), true).toBool())
+        return;
+
+    const QString runDir = resultRunDir();
+    if (runDir.isEmpty() || !QDir(runDir).exists())
+        return;
+
+    const QString path = QDir(runDir).filePath(RunReport::fileName());
+    QString err;
+    if (m_report.write(path, err))
+        appendText(QString("[Run report: %1]\n").arg(QDir::toNativeSeparators(path)));
+    else
+        appendText(QString("[Warning] %1\n").arg(err));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the directory holding the results of the current run.
+ *
+ * This is the data directory reported in the log (relative paths are resolved against RunDir), or RunDir.
+ **********************************************************************************************************************/
+QString SimulationRunner::resultRunDir() const
+{
+    const QString baseDir = m_simSettings.value("RunDir").toString().trimmed();
+    const QString detected = detectRunDirFromLog();
+    return detected.isEmpty() ? baseDir : QDir(baseDir).absoluteFilePath(detected);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the stage name of the current process for telemetry and run reports.
+ **********************************************************************************************************************/
+QString SimulationRunner::stageName() const
+{
+    if (m_simToolKey == QLatin1String("openems"))
+        return QStringLiteral("openems");
+    if (m_phase == Phase::PythonModel)
+        return QStringLiteral("preprocess");
+    return QStringLiteral("solver");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses physical CPU core count from \c lscpu CSV output.
+ *
+ * Interprets the output of \c lscpu -p=CORE,SOCKET and counts unique
+ * (socket, core) pairs, effectively determining the number of
+ * physical CPU cores without hyper-threading.
+ *
+ * Comment lines (starting with '#') and malformed entries are ignored.
+ *
+ * \param out Raw CSV output produced by \c lscpu -p=CORE,SOCKET.
+ *
+ * \return Number of detected physical CPU cores as a string,
+ *         or an empty string if parsing fails.
+ **********************************************************************************************************************/
+QString SimulationRunner::parsePhysicalCoresFromLscpuCsv(QString out)
+{
+    out.replace('\r', "");
+
+    QSet<QString> cores; // "socket:core"
+    const QStringList lines = out.split('\n', Qt::SkipEmptyParts);
+
+    for (const QString &line : lines) {
+        if (line.startsWith('#'))
+            continue;
+
+        const QStringList parts = line.split(',', Qt::KeepEmptyParts);
+        if (parts.size() < 2)
+            continue;
+
+        const QString core   = parts.at(0).trimmed();
+        const QString socket = parts.at(1).trimmed();
+        if (core.isEmpty() || socket.isEmpty())
+            continue;
+
+        cores.insert(socket + ":" + core);
+    }
+
+    return cores.isEmpty() ? QString() : QString::number(cores.size());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts a Windows path (e.g. "C:\foo\bar") to a WSL path ("/mnt/c/foo/bar").
+ *        If the path already looks Linux-like, returns it unchanged.
+ **********************************************************************************************************************/
+QString SimulationRunner::toWslPath(const QString &winPath)
+{
+    if (winPath.startsWith('~')) return winPath;
+    if (winPath.startsWith('/')) return winPath;
+    if (winPath.startsWith("\\\\wsl$")) return winPath;
+
+    QString p = winPath;
+    p.replace('\\', '/');
+    if (p.size() >= 2 && p[1] == ':') {
+        const QChar drive = p[0].toLower();
+        p.remove(0, 2); // remove "C:"
+        if (!p.startsWith('/')) p.prepend('/');
+        p.prepend(QString("/mnt/%1").arg(drive));
+    }
+    return p;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Validates Palace-related settings and prepares execution context.
+ *
+ * Collects and validates all information required to run the Palace workflow,
+ * including model paths, run mode, launcher configuration, Python interpreter,
+ * Palace installation path, and platform-specific details.
+ *
+ * On success, fills \a ctx with resolved paths and parameters.
+ *
+ * \param[out] ctx       Execution context to be populated.
+ * \param[out] outError  Human-readable error message in case of failure.
+ *
+ * \return True if the context was successfully built; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationRunner::buildPalaceRunContext(PalaceRunContext &ctx, QString &outError) const
+{
+    ctx.simKeyLower = m_simToolKey.toLower();
+    if (ctx.simKeyLower != QLatin1String("palace") && ctx.simKeyLower != QLatin1String("elmer")) {
+        outError = QStringLiteral("Current simulation tool is not Palace or Elmer.");
+        return false;
+    }
+
+    ctx.modelWin = m_simSettings.value("RunPythonScript").toString().trimmed();
+    if (ctx.modelWin.isEmpty() || !QFileInfo::exists(ctx.modelWin)) {
+        outError = QStringLiteral("Palace Python model script is not specified or does not exist.");
+        return false;
+    }
+
+    ctx.runMode = m_preferences.value("PALACE_RUN_MODE", 0).toInt();
+
+    bool isScriptMode = false;
+    if (ctx.runMode == 1 && ctx.simKeyLower != QLatin1String("elmer")) {
+        ctx.launcherWin = m_preferences.value("PALACE_RUN_SCRIPT").toString().trimmed();
+        if (ctx.launcherWin.isEmpty()) {
+            outError = QStringLiteral("PALACE_RUN_SCRIPT is not configured.");
+            return false;
+        }
+
+#ifdef Q_OS_WIN
+        ctx.launcherWin = toLinuxPathPortable(ctx.launcherWin, ctx.distro, 8000);
+#endif
+
+        if (!isExecutablePortable(ctx.launcherWin, ctx.distro, 8000)) {
+            outError = QStringLiteral("PALACE_RUN_SCRIPT must point to an executable file.");
+            return false;
+        }
+
+        isScriptMode = true;
+    }
+
+
+    const QFileInfo fi(ctx.modelWin);
+    ctx.baseName = fi.completeBaseName();
+    if (ctx.baseName.isEmpty()) {
+        outError = QStringLiteral("Cannot infer Palace run directory (empty model basename).");
+        return false;
+    }
+
+    ctx.runDirGuessWin = QDir(fi.absolutePath())
+                             .filePath(QStringLiteral("palace_model/%1_data").arg(ctx.baseName));
+
+    ctx.palaceRoot = m_preferences.value("PALACE_INSTALL_PATH").toString().trimmed();
+    if (ctx.palaceRoot.isEmpty() && !isScriptMode && ctx.simKeyLower != QLatin1String("elmer")) {
+        outError = QStringLiteral("PALACE_INSTALL_PATH is not configured in Preferences.");
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    ctx.useWsl = (ctx.simKeyLower != QLatin1String("elmer"));
+
+    if (ctx.useWsl) {
+        if (!ensureWslAvailable(outError))
+            return false;
+
+        ctx.distro = m_preferences.value("WSL_DISTRO").toString().trimmed();
+
+        QString palaceRootLinux = ctx.palaceRoot;
+        if (!palaceRootLinux.startsWith('/') &&
+            !palaceRootLinux.startsWith('~')) {
+            palaceRootLinux = toWslPath(palaceRootLinux);
+        }
+
+        ctx.palaceExeLinux = QDir(palaceRootLinux).filePath("bin/palace");
+        ctx.modelDirLinux  = toWslPath(QFileInfo(ctx.modelWin).absolutePath());
+        ctx.modelLinux     = toWslPath(ctx.modelWin);
+
+        ctx.pythonCmd = m_preferences.value("PALACE_PYTHON").toString().trimmed();
+        if (ctx.pythonCmd.isEmpty())
+            ctx.pythonCmd = QStringLiteral("python3");
+    } else {
+        const QString solverPath =
+            m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+        if (solverPath.isEmpty() || !QFileInfo::exists(solverPath)) {
+            outError = QStringLiteral("ELMER_SOLVER_PATH is not configured or does not exist.");
+            return false;
+        }
+
+        ctx.modelDirLinux = QFileInfo(ctx.modelWin).absolutePath();
+        ctx.modelLinux    = ctx.modelWin;
+
+        if (!resolveElmerPythonLaunch(ctx.pythonCmd, ctx.pythonArgs)) {
+            outError = QStringLiteral("No Windows Python found for Elmer preprocessing. "
+                                      "Set ELMER_PYTHON in Preferences.");
+            return false;
+        }
+    }
+#else
+    ctx.palaceExeLinux = QDir(ctx.palaceRoot).filePath("bin/palace");
+    ctx.modelDirLinux  = QFileInfo(ctx.modelWin).absolutePath();
+    ctx.modelLinux     = ctx.modelWin;
+
+    if (ctx.simKeyLower == QLatin1String("elmer")) {
+        if (!resolveElmerPythonLaunch(ctx.pythonCmd, ctx.pythonArgs)) {
+            outError = QStringLiteral("No Python found for Elmer preprocessing. Set ELMER_PYTHON in Preferences.");
+            return false;
+        }
+    } else {
+        ctx.pythonCmd = m_preferences.value("PALACE_PYTHON").toString().trimmed();
+        if (ctx.pythonCmd.isEmpty())
+            ctx.pythonCmd = QStringLiteral("python3");
+    }
+#endif
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes Palace startup information to the simulation log.
+ *
+ * Prints a short banner describing the execution mode (native, WSL, launcher),
+ * selected Python interpreter, initial run directory guess, and optional launcher
+ * script information.
+ *
+ * \param ctx Prepared Palace execution context.
+ **********************************************************************************************************************/
+void SimulationRunner::logPalaceStartupInfo(const PalaceRunContext &ctx)
+{
+#ifdef Q_OS_WIN
+    if (!ctx.useWsl) {
+        appendText(
+            QStringLiteral("Starting gds2palace Python preprocessing (Windows native)...\n"));
+    } else if (ctx.runMode == 1) {
+        appendText(
+            QString("Starting Palace Python preprocessing in WSL (%1) [launcher mode]...\n").arg(ctx.distro));
+    } else {
+        appendText(
+            QString("Starting Palace Python preprocessing in WSL (%1)...\n").arg(ctx.distro));
+    }
+#else
+    if (ctx.simKeyLower == QLatin1String("elmer"))
+        appendText(
+            QStringLiteral("Starting gds2palace Python preprocessing (native)...\n"));
+    else if (ctx.runMode == 1)
+        appendText("Starting Palace Python preprocessing (launcher mode)...\n");
+    else
+        appendText("Starting Palace Python preprocessing (native)...\n");
+#endif
+
+    appendText(QString("[Using Python: %1]\n").arg(ctx.pythonCmd));
+    appendText(QString("[Initial Palace run directory guess: %1]\n").arg(ctx.runDirGuessWin));
+
+    if (ctx.simKeyLower == QLatin1String("elmer")) {
+        const QString solverPath =
+            m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+        if (!solverPath.isEmpty()) {
+            appendText(
+                QString("[Elmer tools from: %1]\n").arg(QDir::toNativeSeparators(solverPath)));
+        } else {
+            appendText(
+                "[Warning] ELMER_SOLVER_PATH is not set.\n");
+        }
+    }
+
+    if (ctx.runMode == 1 && ctx.useWsl) {
+        appendText(
+            QString("[Launcher script: %1]\n").arg(QDir::toNativeSeparators(ctx.launcherWin)));
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace Python preprocessing stage.
+ *
+ * Launches the Palace Python model script either natively or under WSL,
+ * depending on the current platform and configuration.
+ *
+ * The function assumes that \c m_process is already created.
+ *
+ * \param ctx Prepared Palace execution context.
+ **********************************************************************************************************************/
+void SimulationRunner::startPalacePythonStage(const PalaceRunContext &ctx)
+{
+#ifdef Q_OS_WIN
+    if (!ctx.useWsl) {
+        QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+        applyElmerHomeToProcessEnv(env);
+
+        m_process->setProcessEnvironment(env);
+        m_process->setWorkingDirectory(ctx.modelDirLinux);
+
+        QStringList args = ctx.pythonArgs;
+        args << ctx.modelLinux;
+        m_process->start(ctx.pythonCmd, args);
+        return;
+    }
+
+    const QString wslExe = wslExePath();
+    if (wslExe.isEmpty()) {
+        emit errorOccurred("WSL is not available (wsl.exe not found).", false);
+        return;
+    }
+
+    QStringList args;
+    args << "-d" << ctx.distro
+         << "--" << "bash" << "-lc"
+         << QString("cd %1 && %2 %3")
+                .arg(shellQuoteSingle(ctx.modelDirLinux),
+                     ctx.pythonCmd,
+                     shellQuoteSingle(ctx.modelLinux));
+
+    m_process->start(wslExe, args);
+#else
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    if (ctx.simKeyLower == QLatin1String("elmer"))
+        applyElmerHomeToProcessEnv(env);
+
+    m_process->setProcessEnvironment(env);
+    m_process->setWorkingDirectory(ctx.modelDirLinux);
+
+    QStringList args = ctx.pythonArgs;
+    args << ctx.modelLinux;
+    m_process->start(ctx.pythonCmd, args);
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Handles completion of Palace process stages.
+ *
+ * Dispatches the finished process to the completion handler of the stage it belongs to:
+ *  - PythonModel: completePreprocessingStage() detects the run directory and enters the solver stage.
+ *  - Solver:      completeSolverStage() finalizes logging and the run cache and ends the run.
+ *
+ * A process finishing in any other phase (a stopped run) ends the run with its exit code.
+ *
+ * \param exitCode Exit code returned by the finished process.
+ **********************************************************************************************************************/
+void SimulationRunner::onPalaceProcessFinished(int exitCode)
+{
+    switch (m_phase) {
+    case Phase::PythonModel:
+        completePreprocessingStage(exitCode);
+        return;
+    case Phase::Solver:
+        completeSolverStage(exitCode);
+        return;
+    case Phase::None:
+    case Phase::Preprocessed:
+        break;
+    }
+
+    finishRun(exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Completes the gds2palace Python preprocessing stage.
+ *
+ * A failed stage ends the run. Otherwise the generated run directory is detected from the log (falling back
+ * to the model folder) and published, and the run proceeds to the solver stage.
+ *
+ * \param exitCode Exit code of the Python model.
+ **********************************************************************************************************************/
+void SimulationRunner::completePreprocessingStage(int exitCode)
+{
+    if (exitCode != 0) {
+        appendOutput(
+            QString("\n[Palace Python preprocessing finished with exit code %1]\n")
+                .arg(exitCode).toUtf8());
+
+        if (m_cacheKey.isValid())
+            RunCache().invalidate(detectRunDirFromLog());
+
+        finishRun(exitCode);
+        return;
+    }
+
+    m_logAnalyzer->finish();
+    const QString detectedRunDir = detectRunDirFromLog();
+    if (!detectedRunDir.isEmpty()) {
+        m_simSettings["RunDir"] = detectedRunDir;
+    } else {
+        const QString scriptPath = m_simSettings.value("RunPythonScript").toString().trimmed();
+        if (scriptPath.isEmpty() || !QFileInfo::exists(scriptPath)) {
+            emit errorOccurred(QString("Python file '%1' does not exist.").arg(scriptPath), true);
+            finishRun(1);
+            return;
+        }
+
+        m_simSettings["RunDir"] = QFileInfo(scriptPath).absolutePath();
+    }
+    emit runDirectoryDetected(m_simSettings.value("RunDir").toString());
+
+    appendOutput(
+        "\n[gds2palace Python preprocessing finished successfully, searching for solver...]\n");
+
+    enterSolverStage(detectedRunDir);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Completes the solver stage: logs the exit code, converts Elmer results to Touchstone, records successful
+ *        results in the run cache and ends the run.
+ *
+ * A solver stopped by pollConvergence() counts as successful; its partial sweep is not recorded in the run cache.
+ *
+ * \param exitCode Exit code of the solver or launcher.
+ **********************************************************************************************************************/
+void SimulationRunner::completeSolverStage(int exitCode)
+{
+    const int runMode = m_preferences.value("PALACE_RUN_MODE", 0).toInt();
+
+    QString msg;
+    if (m_simToolKey == QLatin1String("elmer"))
+        msg = QString("\n[Elmer solver finished with exit code %1]\n").arg(exitCode);
+    else if (runMode == 1)
+        msg = QString("\n[Palace launcher finished with exit code %1]\n").arg(exitCode);
+    else
+        msg = QString("\n[Palace solver finished with exit code %1]\n").arg(exitCode);
+
+    appendOutput(msg.toUtf8());
+
+    if (m_stoppedConverged) {
+        appendText("[Solver was stopped after the band of interest converged, run counts as successful]\n");
+        exitCode = 0;
+    }
+
+    beginReportStage(QStringLiteral("postprocess"));
+    if (exitCode == 0)
+        convertSolverResults(m_solverRunDir);
+    if (exitCode == 0 && !m_stoppedConverged)
+        storeRunCacheResults(m_cacheRunDir);
+
+    finishRun(exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Edge from the preprocessing stage to the solver stage.
+ *
+ * Starts the solver right away, or, with setHoldBeforeSolver(), releases the finished preprocessing process,
+ * emits \c preprocessingFinished() and waits for continueWithSolver().
+ *
+ * \param detectedRunDir Run directory reported by the preprocessing stage; empty to use the default guess.
+ **********************************************************************************************************************/
+void SimulationRunner::enterSolverStage(const QString &detectedRunDir)
+{
+    if (!m_holdBeforeSolver) {
+        startGds2PalaceSolver(detectedRunDir);
+        return;
+    }
+
+    releaseProcess();
+    m_phase = Phase::Preprocessed;
+    m_preprocessedRunDir = detectedRunDir;
+
+    appendText("[Preprocessing done, solver stage waiting for free cores]\n");
+    emit preprocessingFinished(m_simSettings.value("RunDir").toString());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Detects the solver of a gds2palace run directory and starts its solver stage.
+ *
+ * Used after the Python preprocessing stage and for run cache partial hits, which reuse the preprocessed
+ * run directory of an earlier run. The directory is recorded in the run cache before the solver starts.
+ *
+ * \param detectedRunDir Run directory reported by the preprocessing stage; empty to use the default guess.
+ **********************************************************************************************************************/
+void SimulationRunner::startGds2PalaceSolver(const QString &detectedRunDir)
+{
+    PalaceRunContext ctx;
+    QString err;
+    if (!buildPalaceRunContext(ctx, err)) {
+        emit errorOccurred(err, true);
+        finishRun(1);
+        return;
+    }
+
+    ctx.detectedRunDirWin = detectedRunDir;
+
+    const QString runDir = resolveGds2PalaceRunDir(ctx);
+    const SolverKind solverKind =
+        detectGds2PalaceSolverKind(runDir, ctx.simKeyLower);
+
+    appendOutput(
+        QString("[Using simulation tool: %1]\n")
+            .arg(ctx.simKeyLower == QLatin1String("elmer") ? QStringLiteral("Elmer")
+                : ctx.simKeyLower == QLatin1String("palace") ? QStringLiteral("Palace")
+                                                            : solverKind == SolverKind::Elmer ? QStringLiteral("Elmer")
+                                                            : solverKind == SolverKind::Palace ? QStringLiteral("Palace")
+                                                                                                        : QStringLiteral("unknown"))
+            .toUtf8());
+
+    if (solverKind != SolverKind::Unknown && m_cacheKey.isValid()) {
+        m_cacheRunDir = runDir;
+        if (!RunCache().recordPreprocessed(m_cacheKey, runDir, err))
+            appendText(QString("[Warning] %1\n").arg(err));
+    }
+
+    if (solverKind == SolverKind::Elmer) {
+        startElmerSolverStage(ctx);
+    } else if (solverKind == SolverKind::Palace) {
+        startPalaceSolverStage(ctx);
+    } else {
+        failPalaceSolver(
+            QStringLiteral("Cannot determine solver in run directory: %1").arg(runDir),
+            true);
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true unless the run cache is disabled in the preferences (RUN_CACHE).
+ **********************************************************************************************************************/
+bool SimulationRunner::runCacheEnabled() const
+{
+    return m_preferences.value(QStringLiteral("RUN_CACHE"), true).toBool();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Fingerprints the current run from its model, GDS and substrate files and the tools processing them.
+ *
+ * \param preprocessor Python interpreter running the model.
+ * \param solver       Solver binary or launcher; empty for openEMS, where the model runs the solver itself.
+ * \param useWsl       True if both tools run inside WSL.
+ * \param distro       WSL distribution of the tools.
+ * \return The run cache keys, or an invalid key if the cache is disabled or a tool cannot be identified.
+ **********************************************************************************************************************/
+RunCache::Key SimulationRunner::computeRunCacheKey(const QString &preprocessor,
+                                                   const QString &solver,
+                                                   bool useWsl,
+                                                   const QString &distro) const
+{
+    if (!runCacheEnabled())
+        return RunCache::Key();
+
+    const QString scriptPath = m_simSettings.value("RunPythonScript").toString().trimmed();
+    const QDir modelDir(QFileInfo(scriptPath).absolutePath());
+    auto inputPath = [this, &modelDir](const char *key) -> QString {
+        const QString path = m_simSettings.value(QLatin1String(key)).toString().trimmed();
+        return path.isEmpty() ? path : modelDir.absoluteFilePath(path);
+    };
+
+    RunCache::Inputs inputs;
+    inputs.simKey        = m_simToolKey;
+    inputs.scriptPath    = scriptPath;
+    inputs.gdsPath       = inputPath("GdsFile");
+    inputs.substratePath = inputPath("SubstrateFile");
+    inputs.preprocessor  = preprocessor;
+    inputs.solver        = solver;
+    inputs.useWsl        = useWsl;
+    inputs.distro        = distro;
+
+    return RunCache::fingerprint(inputs);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the solver identity of a Palace/Elmer run for the run cache key.
+ **********************************************************************************************************************/
+QString SimulationRunner::gds2PalaceSolverIdentity(const PalaceRunContext &ctx) const
+{
+    if (ctx.simKeyLower == QLatin1String("elmer"))
+        return m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+    if (ctx.runMode == 1)
+        return ctx.launcherWin;
+    return ctx.palaceExeLinux;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Completes the run from the run cache if an identical run left complete results.
+ *
+ * Reports the cache hit and the reused result files and emits \c finished() with exit code 0. For Palace and
+ * Elmer the cached run directory is published as the run directory; openEMS keeps RunDir as its working folder.
+ *
+ * \return True on a cache hit.
+ **********************************************************************************************************************/
+bool SimulationRunner::reuseCachedResults()
+{
+    if (!m_cacheKey.isValid())
+        return false;
+
+    const RunCache::Entry cached = RunCache().lookupResults(m_cacheKey);
+    if (!cached.isValid())
+        return false;
+
+    appendText(QString("[Run cache hit: inputs unchanged, reusing %1 result file(s) from %2]\n")
+                   .arg(cached.results.size())
+                   .arg(QDir::toNativeSeparators(cached.runDir)));
+    for (const QString &file : cached.results)
+        appendText(QString("  %1\n").arg(QDir::toNativeSeparators(file)));
+
+    if (m_simToolKey != QLatin1String("openems")) {
+        m_simSettings["RunDir"] = cached.runDir;
+        emit runDirectoryDetected(cached.runDir);
+    }
+
+    appendText("\n[Simulation finished with exit code 0 (cached)]\n");
+    m_report.setCacheStatus(QStringLiteral("hit"));
+    finishRun(0);
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records the results a successful run wrote into \a runDir in the run cache.
+ *
+ * Runs without recognizable results leave the folder unstamped, so they are never reused.
+ **********************************************************************************************************************/
+void SimulationRunner::storeRunCacheResults(const QString &runDir)
+{
+    if (!m_cacheKey.isValid() || runDir.isEmpty())
+        return;
+
+    RunCache cache;
+    const QStringList results = RunCache::collectResultFiles(runDir, m_runStarted);
+    if (results.isEmpty()) {
+        cache.invalidate(runDir);
+        return;
+    }
+
+    QString err;
+    if (!cache.recordResults(m_cacheKey, runDir, results, err))
+        appendText(QString("[Warning] %1\n").arg(err));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts watching port-S.csv of a Palace solver for convergence of the band of interest.
+ *
+ * Active only if SPARAM_STOP_BAND_GHZ holds a band ("2-8"); SPARAM_STOP_TOLERANCE is the largest change of any
+ * S-parameter in the band between two updates that counts as converged (default 1e-3).
+ **********************************************************************************************************************/
+void SimulationRunner::startConvergenceWatch()
+{
+    m_stoppedConverged = false;
+    m_convergenceTimer->stop();
+
+    double fMin = 0.0;
+    double fMax = 0.0;
+    if (!parseStopBand(m_preferences.value(QStringLiteral("SPARAM_STOP_BAND_GHZ")).toString(), fMin, fMax))
+        return;
+
+    const double tolerance = m_preferences.value(QStringLiteral("SPARAM_STOP_TOLERANCE"), 1e-3).toDouble();
+    m_sparamTail.setPath(QString());
+    m_sparamTail.setBand(fMin, fMax, tolerance > 0.0 ? tolerance : 1e-3);
+    m_convergenceTimer->start();
+
+    appendText(QString("[Solver stops once S-parameters in %1 - %2 GHz change by less than %3]\n")
+                   .arg(fMin / 1e9).arg(fMax / 1e9).arg(tolerance));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the rows Palace appended to port-S.csv and stops the solver once the band has converged.
+ **********************************************************************************************************************/
+void SimulationRunner::pollConvergence()
+{
+    if (m_phase != Phase::Solver || !m_process) {
+        m_convergenceTimer->stop();
+        return;
+    }
+
+    if (m_sparamTail.path().isEmpty()) {
+        const QString path = PalaceSParameters::findFile(m_simSettings.value("RunDir").toString());
+        if (path.isEmpty())
+            return;
+        m_sparamTail.setPath(path);
+    }
+
+    QString err;
+    if (!m_sparamTail.poll(err)) {
+        if (!err.isEmpty())
+            appendText(QString("[Warning] %1\n").arg(err));
+        return;
+    }
+    if (!m_sparamTail.bandConverged())
+        return;
+
+    appendText(QString("\n[S-parameters converged after %1 frequency points (last change %2), stopping solver]\n")
+                   .arg(m_sparamTail.frequencyCount())
+                   .arg(m_sparamTail.lastBandChange(), 0, 'g', 3));
+
+    m_stoppedConverged = true;
+    m_convergenceTimer->stop();
+    terminateProcess();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the S-parameters of a finished solver run as Touchstone files.
+ *
+ * Picks the newest scalar_results.names (Elmer) or port-S.csv (Palace) below \a runDir and converts it with
+ * SParameterCombiner::convert(), which replaces scripts/combine_extend_snp.py for this step: \c <name>.sNp, plus
+ * \c <name>_dc.sNp if the sweep qualifies for DC extension. Failures are logged as warnings; they do not fail
+ * the run.
+ *
+ * The Palace launcher (PALACE_RUN_MODE 1) runs combine_extend_snp.py itself and writes the same file names, and
+ * derives \c _dc_deembedded from its own \c _dc file; its files are kept. Touchstone files newer than the result
+ * file are kept as well, so a run is converted only once. The log names the tool that wrote the files.
+ *
+ * \param runDir Solver run directory.
+ **********************************************************************************************************************/
+void SimulationRunner::convertSolverResults(const QString &runDir)
+{
+    EMSTUDIO_TRACE_SCOPE("results.convert");
+
+    if (runDir.isEmpty())
+        return;
+
+    const bool elmer = m_simToolKey == QLatin1String("elmer");
+    const QString resultPath = elmer ? ElmerResults::findNamesFile(runDir) : PalaceSParameters::findFile(runDir);
+    if (resultPath.isEmpty()) {
+        appendText(QString("[Warning] No %1 found in %2\n")
+                       .arg(elmer ? QStringLiteral("Elmer scalar_results.names") : QStringLiteral("Palace port-S.csv"),
+                            QDir::toNativeSeparators(runDir)));
+        return;
+    }
+
+    const bool launcher = !elmer && m_preferences.value("PALACE_RUN_MODE", 0).toInt() == 1;
+    const QStringList existing = touchstoneFilesSince(resultPath);
+    if (launcher || !existing.isEmpty()) {
+        const QString tool = launcher ? QStringLiteral("Palace launcher (combine_extend_snp.py)")
+                                      : QStringLiteral("solver postprocessing");
+        if (existing.isEmpty())
+            appendText(QString("[Warning] %1 wrote no Touchstone file next to %2\n")
+                           .arg(tool, QDir::toNativeSeparators(resultPath)));
+        for (const QString &path : existing)
+            appendText(QString("[S-parameters written by %1 to %2]\n").arg(tool, QDir::toNativeSeparators(path)));
+        return;
+    }
+
+    SParameterCombiner::Options options;
+    options.threads = m_coreLimit;
+
+    QStringList written;
+    QString err;
+    if (!SParameterCombiner::convert(resultPath, options, written, err)) {
+        appendText(QString("[Warning] %1\n").arg(err));
+        return;
+    }
+    for (const QString &path : written)
+        appendText(QString("[S-parameters written by EMStudio to %1]\n").arg(QDir::toNativeSeparators(path)));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads the S-parameters a successful run produced, for the result checks and the ResultStore.
+ *
+ * This is the newest Touchstone file written by the run (except DC-extended \c _dc copies, whose low points are
+ * extrapolated), or Palace's port-S.csv if there is none. Nothing is read for failed runs, cache hits (their
+ * results were handled when they were produced) or if both SPARAM_CHECKS and RESULT_STORE are off. Read errors
+ * are logged as warnings.
+ *
+ * \param exitCode  Exit code reported for the run.
+ * \param out       Receives the network.
+ * \param outSource Receives the file the network was read from.
+ * \return True if results were read.
+ **********************************************************************************************************************/
+bool SimulationRunner::readRunResults(int exitCode, Touchstone::Network &out, QString &outSource)
+{
+    static const QRegularExpression reSnp(QStringLiteral("(?<!_dc)\\.s\\d+p$"),
+                                          QRegularExpression::CaseInsensitiveOption);
+
+    if (exitCode != 0 || m_report.cacheStatus() == QLatin1String("hit"))
+        return false;
+    if (!m_preferences.value(QStringLiteral("SPARAM_CHECKS"), true).toBool() &&
+        !m_preferences.value(QStringLiteral("RESULT_STORE"), true).toBool())
+        return false;
+
+    const QString runDir = resultRunDir();
+    if (runDir.isEmpty() || !QDir(runDir).exists())
+        return false;
+
+    QString source;
+    QDateTime newest;
+    for (const QString &path : RunCache::collectResultFiles(runDir, m_runStarted)) {
+        const QFileInfo fi(path);
+        if (reSnp.match(fi.fileName()).hasMatch() && (source.isEmpty() || fi.lastModified() > newest)) {
+            source = path;
+            newest = fi.lastModified();
+        }
+    }
+
+    QString err;
+    bool ok = false;
+    if (!source.isEmpty()) {
+        ok = Touchstone::read(source, out, err);
+    } else {
+        source = PalaceSParameters::findFile(runDir);
+        if (source.isEmpty())
+            return false;
+        ok = PalaceSParameters::read(source, out, err);
+    }
+
+    if (!ok) {
+        appendText(QString("[Warning] %1\n").arg(err));
+        return false;
+    }
+
+    outSource = source;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks the S-parameters of a run for passivity, reciprocity and causality and logs a pass/fail summary.
+ *
+ * Runs in the postprocess stage on up to the run's core limit. Disabled with the SPARAM_CHECKS preference.
+ *
+ * \param network S-parameters of the run.
+ **********************************************************************************************************************/
+void SimulationRunner::checkRunResults(const Touchstone::Network &network)
+{
+    if (!m_preferences.value(QStringLiteral("SPARAM_CHECKS"), true).toBool())
+        return;
+
+    EMSTUDIO_TRACE_SCOPE("results.check");
+
+    SParameterChecks::Options options;
+    options.threads = m_coreLimit;
+    const SParameterChecks::Result result = SParameterChecks::check(network, options);
+
+    appendText(QString("\n[S-parameter checks: %1, %2 ports, %3 frequencies]\n")
+                   .arg(result.passed() ? QStringLiteral("passed") : QStringLiteral("FAILED"))
+                   .arg(result.ports)
+                   .arg(result.frequencies));
+    for (const QString &line : result.summary())
+        appendText(QString("  %1\n").arg(line));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Adds the S-parameters of a successful run to the ResultStore.
+ *
+ * Cell, fingerprint and stage timings are taken from the run report. Disabled with the RESULT_STORE preference;
+ * failures are logged as warnings.
+ *
+ * \param network S-parameters of the run.
+ * \param source  File the network was read from.
+ **********************************************************************************************************************/
+void SimulationRunner::ingestRunResults(const Touchstone::Network &network, const QString &source)
+{
+    if (!m_preferences.value(QStringLiteral("RESULT_STORE"), true).toBool())
+        return;
+
+    EMSTUDIO_TRACE_SCOPE("results.ingest");
+
+    ResultStore::RunInfo info = ResultStore::infoFromReport(m_report.toJson());
+    info.source = source;
+
+    QString err;
+    if (ResultStore().ingest(network, info, err))
+        appendText(QString("[Results stored as run %1 of %2]\n").arg(info.id, info.cell));
+    else
+        appendText(QString("[Warning] %1\n").arg(err));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the Palace simulation data directory reported in the log output.
+ *
+ * The directory is picked up by the streaming log analyzer as the output
+ * arrives; it is converted to a native path if required.
+ *
+ * \return Detected run directory path, or an empty string if not found.
+ **********************************************************************************************************************/
+QString SimulationRunner::detectRunDirFromLog() const
+{
+    const QString simDir = m_logAnalyzer->runDirectory();
+    if (simDir.isEmpty())
+        return QString();
+
+#ifdef Q_OS_WIN
+    return wslToWinPath(simDir);
+#else
+    return simDir;
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Constructs a default Palace run directory guess.
+ *
+ * Builds the expected Palace run directory based on the Python model location
+ * and model base name. The directory is only returned if it already exists.
+ *
+ * \param modelFile Full path to the Palace Python model file.
+ * \param baseName  Base name of the model without extension.
+ *
+ * \return Existing default run directory path, or an empty string if not found.
+ **********************************************************************************************************************/
+QString SimulationRunner::guessDefaultPalaceRunDir(const QString &modelFile, const QString &baseName) const
+{
+    const QString defRunDir = QFileInfo(modelFile).absolutePath()
+    + QStringLiteral("/palace_model/%1_data").arg(baseName);
+    if (!QFileInfo::exists(defRunDir))
+        return QString();
+    return defRunDir;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Selects the directory to search for Palace configuration files.
+ *
+ * Prefers a detected run directory (if available); otherwise falls back
+ * to a default guessed directory.
+ *
+ * \param detectedRunDir Run directory detected from log output.
+ * \param defaultRunDir  Fallback run directory guess.
+ *
+ * \return Directory path to be used for configuration search.
+ **********************************************************************************************************************/
+QString SimulationRunner::chooseSearchDir(const QString &detectedRunDir, const QString &defaultRunDir) const
+{
+    return detectedRunDir.isEmpty() ? defaultRunDir : detectedRunDir;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Finds a Palace configuration JSON file in the given directory.
+ *
+ * Searches for readable *.json files in \a runDir, preferring a file named
+ * "config.json" (case-insensitive). If not found, selects the newest JSON file. Run reports
+ * (run_report.json) are ignored.
+ *
+ * \param runDir Directory to search for Palace configuration files.
+ *
+ * \return Absolute path to the selected config file, or an empty string if none found.
+ **********************************************************************************************************************/
+QString SimulationRunner::findPalaceConfigJson(const QString &runDir) const
+{
+    QDir dir(runDir);
+    dir.setFilter(QDir::Files | QDir::Readable | QDir::NoSymLinks);
+    dir.setNameFilters(QStringList() << "*.json");
+    dir.setSorting(QDir::Time | QDir::Reversed);
+
+    const QFileInfoList files = dir.entryInfoList();
+    QString best;
+
+    for (const QFileInfo &fi : files) {
+        if (fi.fileName() == RunReport::fileName())
+            continue;
+        if (best.isEmpty())
+            best = fi.absoluteFilePath();
+        if (fi.completeBaseName().compare(QLatin1String("config"), Qt::CaseInsensitive) == 0 &&
+            fi.completeSuffix().compare(QLatin1String("json"), Qt::CaseInsensitive) == 0)
+        {
+            best = fi.absoluteFilePath();
+            break;
+        }
+    }
+
+    return best;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Queries the number of available CPU cores inside WSL.
+ *
+ * Executes the \c nproc command inside the specified WSL distribution and returns
+ * the number of logical CPU cores visible to Linux. This reflects possible limits
+ * imposed by .wslconfig (e.g. processors=).
+ *
+ * \param distro WSL distribution name (e.g. "Ubuntu").
+ *
+ * \return Number of CPU cores reported by \c nproc, or an empty string on failure.
+ **********************************************************************************************************************/
+QString SimulationRunner::queryWslCpuCores(const QString &distro) const
+{
+#ifdef Q_OS_WIN
+    return runWslCmdCapture(distro, QStringList() << "nproc", 3000).trimmed();
+#else
+    Q_UNUSED(distro);
+    return QString();
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Detects the number of available CPU cores for MPI execution.
+ *
+ * Uses the cached HardwareTopology probe (sysfs, inside WSL on Windows) and subtracts the cores reserved
+ * in the preferences (RESERVED_CORES). Only if the topology cannot be read, the core count is queried
+ * with \c lscpu and \c nproc (via WSL on Windows).
+ *
+ * If detection fails, returns "1" as a safe fallback.
+ *
+ * \return Number of available CPU cores as string.
+ **********************************************************************************************************************/
+SimulationRunner::CoreCountResult SimulationRunner::detectMpiCoreCount() const
+{
+    CoreCountResult r;
+
+    const QString distro = m_preferences.value("WSL_DISTRO").toString().trimmed();
+    const HardwareTopology::Topology topology = HardwareTopology::probe(distro);
+    if (topology.isValid()) {
+        const int reserved = HardwareTopology::launchOptionsFromPreferences(m_preferences).reservedCores;
+        r.cores  = QString::number(topology.usableCores(reserved));
+        r.source = QString("%1 (%2)").arg(topology.physicalCores > 0 ? QStringLiteral("physical")
+                                                                     : QStringLiteral("logical"),
+                                          topology.source);
+        if (reserved > 0)
+            r.source += QString(", %1 reserved").arg(reserved);
+        return r;
+    }
+
+#ifdef Q_OS_WIN
+
+    const QString lscpuOut = runWslCmdCapture(
+        distro, QStringList() << "lscpu" << "-p=CORE,SOCKET", 2000);
+
+    const QString phys = parsePhysicalCoresFromLscpuCsv(lscpuOut).trimmed();
+    if (!phys.isEmpty()) {
+        r.cores  = phys;
+        r.source = QStringLiteral("physical (lscpu)");
+        return r;
+    }
+
+    const QString nprocOut = runWslCmdCapture(
+                                 distro, QStringList() << "nproc", 2000).trimmed();
+
+    if (!nprocOut.isEmpty()) {
+        r.cores  = nprocOut;
+        r.source = QStringLiteral("logical (nproc)");
+        return r;
+    }
+
+    r.cores  = QStringLiteral("1");
+    r.source = QStringLiteral("fallback");
+    return r;
+#else
+    const QString phys = detectPhysicalCoreCountLinux().trimmed();
+    if (!phys.isEmpty()) {
+        r.cores  = phys;
+        r.source = QStringLiteral("physical (lscpu)");
+        return r;
+    }
+
+    QProcess p;
+    p.start(QStringLiteral("nproc"), QStringList());
+
+    if (p.waitForFinished(2000)) {
+        const QString out = QString::fromUtf8(p.readAllStandardOutput()).trimmed();
+        if (!out.isEmpty()) {
+            r.cores  = out;
+            r.source = QStringLiteral("logical (nproc)");
+            return r;
+        }
+    }
+
+    r.cores  = QStringLiteral("1");
+    r.source = QStringLiteral("fallback");
+    return r;
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Detects the number of physical CPU cores on Linux.
+ *
+ * Determines the number of hardware cores (without Hyper-Threading / SMT) by
+ * parsing the output of \c lscpu -p=CORE,SOCKET and counting unique (socket,core)
+ * pairs. This value is suitable for CPU-bound MPI runs where oversubscribing
+ * logical threads is undesirable.
+ *
+ * \return Number of physical CPU cores as string, or an empty string if detection fails.
+ **********************************************************************************************************************/
+QString SimulationRunner::detectPhysicalCoreCountLinux() const
+{
+    QProcess p;
+    p.start(QStringLiteral("lscpu"), QStringList() << "-p=CORE,SOCKET");
+
+    if (!p.waitForFinished(2000))
+        return QString();
+
+    if (p.exitStatus() != QProcess::NormalExit || p.exitCode() != 0)
+        return QString();
+
+    const QString out = QString::fromUtf8(p.readAllStandardOutput());
+
+    QSet<QString> cores; // "socket:core"
+    const QStringList lines = out.split('\n', Qt::SkipEmptyParts);
+
+    for (const QString &line : lines) {
+        if (line.startsWith('#'))
+            continue;
+
+        const QStringList parts = line.split(',', Qt::KeepEmptyParts);
+        if (parts.size() < 2)
+            continue;
+
+        const QString core   = parts.at(0).trimmed();
+        const QString socket = parts.at(1).trimmed();
+        if (core.isEmpty() || socket.isEmpty())
+            continue;
+
+        cores.insert(socket + ":" + core);
+    }
+
+    if (cores.isEmpty())
+        return QString();
+
+    return QString::number(cores.size());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Stops the current Palace run and resets internal solver state.
+ *
+ * Reports the given error message, schedules the active simulation process for
+ * deletion, resets the phase to \c Phase::None and emits \c finished() with
+ * exit code 1.
+ *
+ * This helper is intended to be used as a single exit path for all Palace stage
+ * failures to keep cleanup consistent.
+ *
+ * \param message    Error message to report. If empty, no error is shown.
+ * \param showDialog If true, the receiver clears the main log before reporting the error.
+ **********************************************************************************************************************/
+void SimulationRunner::failPalaceSolver(const QString &message, bool showDialog)
+{
+    if (!message.isEmpty())
+        emit errorOccurred(message, showDialog);
+
+    finishRun(1);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace solver stage.
+ *
+ * Resolves the Palace configuration file, handles launcher mode if enabled,
+ * prepares the solver command and MPI core count, logs execution details,
+ * and dispatches solver execution to the platform-specific runner.
+ *
+ * All common logic is platform-independent; OS-specific code is isolated
+ * to the final execution step.
+ *
+ * \param[in,out] ctx Palace execution context, updated with resolved paths.
+ **********************************************************************************************************************/
+QString SimulationRunner::resolveGds2PalaceRunDir(const PalaceRunContext &ctx) const
+{
+    const QString modelFile = m_simSettings.value("RunPythonScript").toString().trimmed();
+    QString defRunDir;
+    if (!modelFile.isEmpty()) {
+        defRunDir = guessDefaultPalaceRunDir(modelFile,
+                                             QFileInfo(modelFile).completeBaseName());
+    }
+    if (defRunDir.isEmpty() && !ctx.runDirGuessWin.isEmpty())
+        defRunDir = ctx.runDirGuessWin;
+
+    return chooseSearchDir(ctx.detectedRunDirWin, defRunDir);
+}
+
+QString SimulationRunner::buildElmerEnvShellPrefix() const
+{
+    const QString solverPath =
+        m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+    if (solverPath.isEmpty())
+        return QString();
+
+    const QFileInfo solverFi(solverPath);
+    if (!solverFi.exists())
+        return QString();
+
+    const QString binDir = solverFi.absolutePath();
+    const QString homeDir = QFileInfo(binDir).absolutePath();
+
+#ifdef Q_OS_WIN
+    const QString binPath = toWslPath(binDir);
+    const QString homePath = toWslPath(homeDir);
+#else
+    const QString binPath = binDir;
+    const QString homePath = homeDir;
+#endif
+
+    return QStringLiteral("export ELMER_HOME=%1 && export PATH=%2:$PATH && ")
+        .arg(shellQuoteSingle(homePath), shellQuoteSingle(binPath));
+}
+
+void SimulationRunner::applyElmerHomeToProcessEnv(QProcessEnvironment &env) const
+{
+    const QString solverPath =
+        m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+    if (solverPath.isEmpty())
+        return;
+
+    const QString binDir = QFileInfo(solverPath).absolutePath();
+    const QString homeDir = QFileInfo(binDir).absolutePath();
+
+    env.insert(QStringLiteral("ELMER_HOME"), homeDir);
+
+    const QString pathKey = QStringLiteral("PATH");
+    env.insert(pathKey, binDir + QDir::listSeparator() + env.value(pathKey));
+}
+
+bool SimulationRunner::resolveElmerPythonLaunch(QString &outExe, QStringList &outArgs) const
+{
+    outArgs.clear();
+
+    const QString configured = m_preferences.value(QStringLiteral("ELMER_PYTHON")).toString().trimmed();
+    if (!configured.isEmpty()) {
+        if (!QFileInfo::exists(configured))
+            return false;
+        outExe = configured;
+        return true;
+    }
+
+    QString py = QStandardPaths::findExecutable(QStringLiteral("python"));
+    if (!py.isEmpty()) {
+        outExe = py;
+        return true;
+    }
+
+    py = QStandardPaths::findExecutable(QStringLiteral("py"));
+    if (!py.isEmpty()) {
+        outExe = py;
+        outArgs << QStringLiteral("-3");
+        return true;
+    }
+
+    return false;
+}
+
+void SimulationRunner::patchElmerSifFilesNoMumps(const QString &runDir) const
+{
+    QDir dir(runDir);
+    const QFileInfoList files =
+        dir.entryInfoList(QStringList() << QStringLiteral("*.sif"), QDir::Files);
+
+    static const QRegularExpression reMumps(
+        R"(Linear\s+System\s+Direct\s+Method\s*=\s*zmumps)",
+        QRegularExpression::CaseInsensitiveOption);
+
+    for (const QFileInfo &fi : files) {
+        QFile f(fi.absoluteFilePath());
+        if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+            continue;
+
+        QString content = QString::fromUtf8(f.readAll());
+        f.close();
+
+        if (!reMumps.match(content).hasMatch())
+            continue;
+
+        content.replace(reMumps, QStringLiteral("Linear System Direct Method = umfpack"));
+
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate))
+            continue;
+
+        f.write(content.toUtf8());
+    }
+}
+
+SimulationRunner::SolverKind SimulationRunner::detectGds2PalaceSolverKind(
+    const QString &runDir,
+    const QString &simKeyLower) const
+{
+    if (runDir.isEmpty())
+        return SolverKind::Unknown;
+
+    if (simKeyLower == QLatin1String("elmer"))
+        return SolverKind::Elmer;
+    if (simKeyLower == QLatin1String("palace"))
+        return SolverKind::Palace;
+
+    const QDir dir(runDir);
+    const bool hasElmerMarkers =
+        QFileInfo::exists(dir.filePath(QStringLiteral("case.sif"))) ||
+        QFileInfo::exists(dir.filePath(QStringLiteral("ELMERSOLVER_STARTINFO"))) ||
+        QFileInfo::exists(dir.filePath(QStringLiteral("physics.sif")));
+    const bool hasRunElmer = QFileInfo::exists(dir.filePath(QStringLiteral("run_elmer")));
+
+    if (hasElmerMarkers || hasRunElmer)
+        return SolverKind::Elmer;
+
+    if (QFileInfo::exists(dir.filePath(QStringLiteral("config.json"))))
+        return SolverKind::Palace;
+
+    return SolverKind::Unknown;
+}
+
+void SimulationRunner::startPalaceSolverStage(PalaceRunContext &ctx)
+{
+    if (ctx.simKeyLower == QLatin1String("elmer") ||
+        m_simToolKey == QLatin1String("elmer")) {
+        startElmerSolverStage(ctx);
+        return;
+    }
+
+    ctx.searchDirWin = resolveGds2PalaceRunDir(ctx);
+    if (ctx.searchDirWin.isEmpty()) {
+        failPalaceSolver("Cannot determine Palace run directory to search for config.", true);
+        return;
+    }
+
+    m_solverRunDir = ctx.searchDirWin;
+
+    ctx.configPathWin = findPalaceConfigJson(ctx.searchDirWin);
+    if (ctx.configPathWin.isEmpty()) {
+        failPalaceSolver(QString("No Palace config (*.json) found in run directory: %1")
+                                 .arg(ctx.searchDirWin),
+                         true);
+        return;
+    }
+
+    appendOutput(QString("[Using Palace config: %1]\n").arg(QDir::toNativeSeparators(ctx.configPathWin)).toUtf8());
+
+    if (ctx.runMode == 1) {
+        if (!startPalaceLauncherStage(ctx))
+            failPalaceSolver(QString(), false);
+        return;
+    }
+
+    QString workDirLinux;
+    QString cmd;
+    QString cores;
+
+    if (!preparePalaceSolverLaunch(ctx, workDirLinux, cmd, cores)) {
+        failPalaceSolver(QString(), true);
+        return;
+    }
+
+    appendOutput(
+        QString("[Palace solver command] %1\n").arg(cmd).toUtf8());
+    appendOutput(
+        QString("[MPI cores] np = %1\n").arg(cores).toUtf8());
+
+#ifdef Q_OS_WIN
+    if (!runPalaceSolverWindows(ctx, cmd))
+        failPalaceSolver(QString(), false);
+#else
+    if (!runPalaceSolverLinux(ctx, workDirLinux, cmd))
+        failPalaceSolver(QString(), false);
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Elmer solver stage after gds2palace preprocessing.
+ *
+ * Runs \c run_elmer from the simulation data directory (same as gds2palace workflow),
+ * or invokes \c ELMER_SOLVER_PATH directly on Windows when configured.
+ **********************************************************************************************************************/
+void SimulationRunner::startElmerSolverStage(PalaceRunContext &ctx)
+{
+    ctx.searchDirWin = resolveGds2PalaceRunDir(ctx);
+    if (ctx.searchDirWin.isEmpty()) {
+        failPalaceSolver(QStringLiteral("Cannot determine Elmer run directory."), true);
+        return;
+    }
+
+    m_solverRunDir = ctx.searchDirWin;
+
+    appendOutput(
+        QString("[Using Elmer run directory: %1]\n")
+            .arg(QDir::toNativeSeparators(ctx.searchDirWin))
+            .toUtf8());
+
+    const QString runScriptWin = QDir(ctx.searchDirWin).filePath(QStringLiteral("run_elmer"));
+    const QString elmerExeWin =
+        m_preferences.value(QStringLiteral("ELMER_SOLVER_PATH")).toString().trimmed();
+
+#ifdef Q_OS_WIN
+    if (elmerExeWin.isEmpty() || !QFileInfo::exists(elmerExeWin)) {
+        failPalaceSolver(QStringLiteral("ELMER_SOLVER_PATH is not configured or does not exist."), true);
+        return;
+    }
+
+    patchElmerSifFilesNoMumps(ctx.searchDirWin);
+    appendOutput(
+        "\n[Patched Elmer .sif files: zmumps -> umfpack (Windows Elmer without MUMPS)]\n");
+
+    appendOutput("\n[Starting ElmerSolver (native)...]\n");
+    m_phase = Phase::Solver;
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    applyElmerHomeToProcessEnv(env);
+    if (m_coreLimit > 0)
+        env.insert(QStringLiteral("OMP_NUM_THREADS"), QString::number(m_coreLimit));
+    m_process->setProcessEnvironment(env);
+    m_process->setWorkingDirectory(ctx.searchDirWin);
+    m_process->start(QDir::toNativeSeparators(elmerExeWin), QStringList());
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred(QStringLiteral("Failed to start ElmerSolver."), false);
+        failPalaceSolver(QString(), false);
+    }
+    return;
+#else
+    if (!QFileInfo::exists(runScriptWin)) {
+        failPalaceSolver(
+            QStringLiteral("No run_elmer script found in: %1").arg(ctx.searchDirWin),
+            true);
+        return;
+    }
+
+    appendOutput("\n[Starting Elmer via run_elmer...]\n");
+    m_phase = Phase::Solver;
+
+    QProcessEnvironment env = QProcessEnvironment::systemEnvironment();
+    applyElmerHomeToProcessEnv(env);
+    if (m_coreLimit > 0)
+        env.insert(QStringLiteral("OMP_NUM_THREADS"), QString::number(m_coreLimit));
+    m_process->setProcessEnvironment(env);
+    m_process->setWorkingDirectory(ctx.searchDirWin);
+    m_process->start(QStringLiteral("bash"),
+                        QStringList() << QStringLiteral("-lc") << QStringLiteral("./run_elmer"));
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred(QStringLiteral("Failed to start Elmer solver."), false);
+        failPalaceSolver(QString(), false);
+    }
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace solver using an external launcher script.
+ *
+ * Executes the user-configured Palace launcher script instead of invoking the
+ * Palace binary directly. The launcher is started in the directory containing
+ * the Palace configuration file.
+ *
+ * This mode bypasses internal MPI command construction and delegates all
+ * execution details (including core count and environment setup) to the
+ * external script.
+ *
+ * On success, switches the internal state to \c Phase::Solver.
+ * On failure, reports an error and leaves the solver inactive.
+ *
+ * \param[in,out] ctx Palace execution context containing launcher path and
+ *                    resolved configuration file.
+ *
+ * \return True if the launcher process was started successfully; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationRunner::startPalaceLauncherStage(PalaceRunContext &ctx)
+{
+    appendOutput("\n[Starting Palace via external launcher script...]\n");
+
+    m_phase = Phase::Solver;
+
+    QString workDirWin = ctx.searchDirWin;
+    if (workDirWin.isEmpty())
+        workDirWin = QFileInfo(ctx.configPathWin).absolutePath();
+
+#ifdef Q_OS_WIN
+    const QString launcher = ctx.launcherWin.trimmed();
+    QString launcherNative = launcher;
+    if (launcherNative.startsWith(QLatin1Char('/')) || launcherNative.startsWith(QLatin1Char('~')))
+        launcherNative = wslToWinPath(launcherNative);
+
+    const bool launcherIsBatch =
+        launcherNative.endsWith(QStringLiteral(".cmd"), Qt::CaseInsensitive) ||
+        launcherNative.endsWith(QStringLiteral(".bat"), Qt::CaseInsensitive);
+
+    if (launcherIsBatch) {
+        if (launcherNative.contains(QStringLiteral("palace_launcher_stub"), Qt::CaseInsensitive)) {
+            appendOutput(
+                "[Warning] PALACE_RUN_SCRIPT points to the EMStudio test stub. "
+                "Configure a real Palace launcher (bash script in WSL) or use "
+                "PALACE_RUN_MODE = Executable.\n");
+        }
+
+        m_process->setWorkingDirectory(workDirWin);
+        m_process->start(
+            QStringLiteral("cmd.exe"),
+            QStringList() << QStringLiteral("/c")
+                          << QDir::toNativeSeparators(launcherNative)
+                          << QDir::toNativeSeparators(ctx.configPathWin));
+    } else if (launcher.startsWith(QLatin1Char('/')) || launcher.startsWith(QLatin1Char('~'))) {
+        const QString wslExe = wslExePath();
+        if (wslExe.isEmpty()) {
+            emit errorOccurred("WSL is not available (wsl.exe not found).", false);
+            return false;
+        }
+
+        const QString configLinux = toWslPath(ctx.configPathWin);
+        const QString workDirLinux = toWslPath(workDirWin);
+
+        QStringList args;
+        if (!ctx.distro.trimmed().isEmpty())
+            args << "-d" << ctx.distro.trimmed();
+
+        const QString cmd =
+            QString("cd %1 && %2 %3")
+                .arg(shellQuoteSingle(workDirLinux),
+                     shellQuoteSingle(launcher),
+                     shellQuoteSingle(configLinux));
+
+        args << "--" << "bash" << "-lc" << cmd;
+
+        m_process->start(wslExe, args);
+    } else {
+        m_process->setWorkingDirectory(workDirWin);
+        m_process->start(QDir::toNativeSeparators(launcher),
+                            QStringList() << QDir::toNativeSeparators(ctx.configPathWin));
+    }
+#else
+    m_process->setWorkingDirectory(workDirWin);
+    m_process->start(ctx.launcherWin,
+                        QStringList() << ctx.configPathWin);
+#endif
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred("Failed to start Palace launcher script.", false);
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!*******************************************************************************************************************
+ * \brief Prepares the Palace solver launch command and execution parameters.
+ *
+ * Resolves the Palace configuration path for the current platform, determines
+ * the working directory, plans the MPI rank count and core binding from the
+ * cached hardware topology (see HardwareTopology::planMpiLaunch()), and constructs
+ * the full solver launch command. The chosen binding is written to the log.
+ *
+ * This function performs only preparation and validation. It does not start
+ * the solver process itself.
+ *
+ * On success, all output parameters are filled with valid values suitable for
+ * passing to the platform-specific solver runner.
+ *
+ * \param[in,out] ctx           Palace execution context, updated with resolved paths.
+ * \param[out]    outWorkDirLinux Working directory for the solver execution.
+ * \param[out]    outCmd         Full shell command used to start the Palace solver.
+ * \param[out]    outCores       Detected number of MPI cores to be used.
+ *
+ * \return True if the solver launch information was prepared successfully;
+ *         false if a required setting is missing or preparation fails.
+ **********************************************************************************************************************/
+bool SimulationRunner::preparePalaceSolverLaunch(PalaceRunContext &ctx,
+                                           QString &outWorkDirLinux,
+                                           QString &outCmd,
+                                           QString &outCores)
+{
+    if (ctx.configPathWin.isEmpty()) {
+        emit errorOccurred("Internal error: Palace config path is empty.", true);
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    ctx.configLinux = toWslPath(ctx.configPathWin);
+#else
+    ctx.configLinux = ctx.configPathWin;
+#endif
+
+    const QString configDirLinux  = QFileInfo(ctx.configLinux).path();
+    const QString configBaseLinux = QFileInfo(ctx.configLinux).fileName();
+
+    outWorkDirLinux = configDirLinux;
+
+    QString launcherArgs = QStringLiteral("--oversubscribe");
+
+    const HardwareTopology::Topology topology = HardwareTopology::probe(ctx.distro);
+    if (topology.isValid()) {
+        HardwareTopology::LaunchOptions launch = HardwareTopology::launchOptionsFromPreferences(m_preferences);
+        launch.rankLimit = m_coreLimit;
+
+        const HardwareTopology::LaunchPlan plan = HardwareTopology::planMpiLaunch(topology, launch);
+        outCores     = QString::number(plan.ranks);
+        launcherArgs = plan.launcherArgs;
+
+        const QString source = m_coreLimit > 0 ? QStringLiteral("job core budget") : topology.source;
+        appendOutput(
+            QString("[MPI cores detected] np = %1 (%2)\n").arg(outCores, source).toUtf8());
+        appendOutput(
+            QString("[MPI binding] %1\n").arg(plan.description).toUtf8());
+    } else {
+        CoreCountResult cc;
+        if (m_coreLimit > 0) {
+            cc.cores  = QString::number(m_coreLimit);
+            cc.source = QStringLiteral("job core budget");
+        } else {
+            cc = detectMpiCoreCount();
+        }
+        outCores = cc.cores;
+        m_report.setCores(outCores.toInt());
+
+        appendOutput(
+            QString("[MPI cores detected] np = %1 (%2)\n").arg(outCores, cc.source).toUtf8());
+    }
+
+    const QString palaceCmd =
+        QString("\"%1\" --launcher-args \"%2\" -np %3 \"%4\"")
+            .arg(ctx.palaceExeLinux, launcherArgs, outCores, configBaseLinux);
+
+    outCmd = QString("cd \"%1\" && %2").arg(configDirLinux, palaceCmd);
+    return true;
+}
+
+#ifdef Q_OS_WIN
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace solver stage under Windows using WSL.
+ *
+ * Launches the Palace solver inside the configured WSL distribution by executing
+ * the prepared shell command via \c wsl.exe. The function assumes that all paths
+ * and command strings are already validated and prepared.
+ *
+ * On success, switches the internal state to \c Phase::Solver.
+ * On failure, reports an error and leaves the solver inactive.
+ *
+ * \param ctx Prepared Palace execution context (WSL distro is taken from it).
+ * \param cmd Full shell command to execute inside WSL.
+ *
+ * \return True if the solver process was started successfully; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationRunner::runPalaceSolverWindows(const PalaceRunContext &ctx, const QString &cmd)
+{
+    appendOutput("\n[Starting Palace solver in WSL...]\n");
+
+    const QString wslExe = wslExePath();
+    if (wslExe.isEmpty()) {
+        emit errorOccurred("WSL is not available (wsl.exe not found).", false);
+        return false;
+    }
+
+    m_phase = Phase::Solver;
+
+    QStringList args;
+    if (!ctx.distro.trimmed().isEmpty())
+        args << "-d" << ctx.distro.trimmed();
+
+    args << "--" << "bash" << "-lc" << cmd;
+
+    m_process->start(wslExe, args);
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred("Failed to start Palace solver under WSL.", false);
+        return false;
+    }
+
+    return true;
+}
+
+#endif
+
+/*!*******************************************************************************************************************
+ * \brief Starts the Palace solver stage natively on Linux.
+ *
+ * Launches the Palace solver directly using the native Palace binary.
+ * The working directory is set to the directory containing the Palace
+ * configuration file.
+ *
+ * On success, switches the internal state to \c Phase::Solver.
+ * On failure, reports an error and leaves the solver inactive.
+ *
+ * \param ctx Prepared Palace execution context (used to resolve config file name).
+ * \param workDirLinux Directory in which the solver should be executed.
+ *
+ * \return True if the solver process was started successfully; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationRunner::runPalaceSolverLinux(const PalaceRunContext &ctx,
+                                      const QString &workDirLinux,
+                                      const QString &cmd)
+{
+    Q_UNUSED(ctx);
+
+    appendOutput("\n[Starting Palace solver (native)...]\n");
+
+    m_phase = Phase::Solver;
+
+    m_process->setWorkingDirectory(workDirLinux);
+    m_process->start(QStringLiteral("bash"), QStringList() << "-lc" << cmd);
+
+    if (!m_process->waitForStarted(3000)) {
+        emit errorOccurred("Failed to start Palace solver.", false);
+        return false;
+    }
+
+    return true;
+}
+
+#ifdef Q_OS_WIN
+/*!*******************************************************************************************************************
+ * \brief Checks whether Windows Subsystem for Linux (WSL) is available.
+ *
+ * Verifies that the \c wsl executable can be found in the system PATH.
+ *
+ * \param[out] outError Error message describing the problem if WSL is unavailable.
+ *
+ * \return True if WSL is available; false otherwise.
+ **********************************************************************************************************************/
+bool SimulationRunner::ensureWslAvailable(QString &outError) const
+{
+    if (QStandardPaths::findExecutable("wsl").isEmpty()) {
+        outError = QStringLiteral("WSL is not available on this system. Install WSL or use Palace launcher mode.");
+        return false;
+    }
+    return true;
+}
+
+#endif
+
+/*!*******************************************************************************************************************
+ * \brief Converts a WSL-style path to a Windows path.
+ *
+ * Translates paths of the form "/mnt/<drive>/..." to "<Drive>:/...".
+ * If the input path does not follow this pattern, it is returned unchanged.
+ *
+ * \param p WSL-style path string.
+ *
+ * \return Best-effort Windows-style path.
+ **********************************************************************************************************************/
+QString SimulationRunner::wslToWinPath(const QString &p)
+{
+    if (p.startsWith("/mnt/") && p.size() > 6) {
+        const QChar drive = p.at(5).toUpper();
+        const QString rest = p.mid(6);
+        return QString("%1:/%2").arg(drive).arg(rest);
+    }
+    return p;
+}
+
+#ifdef EMSTUDIO_TESTING
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that exposes logPalaceStartupInfo() in test builds.
+ **********************************************************************************************************************/
+void SimulationRunner::testLogPalaceStartupInfo(const PalaceRunContext &ctx)
+{
+    logPalaceStartupInfo(ctx);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that exposes preparePalaceSolverLaunch() in test builds.
+ **********************************************************************************************************************/
+bool SimulationRunner::testPreparePalaceSolverLaunch(PalaceRunContext &ctx,
+                                                     QString &outWorkDirLinux,
+                                                     QString &outCmd,
+                                                     QString &outCores)
+{
+    return preparePalaceSolverLaunch(ctx, outWorkDirLinux, outCmd, outCores);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that exposes failPalaceSolver() in test builds.
+ **********************************************************************************************************************/
+void SimulationRunner::testFailPalaceSolver(const QString &message, bool showDialog)
+{
+    failPalaceSolver(message, showDialog);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that forces the pipeline phase in test builds.
+ **********************************************************************************************************************/
+void SimulationRunner::testSetPhase(Phase phase)
+{
+    m_phase = phase;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that exposes onPalaceProcessFinished() in test builds.
+ **********************************************************************************************************************/
+void SimulationRunner::testFinishPalaceProcess(int exitCode)
+{
+    onPalaceProcessFinished(exitCode);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that replaces the simulation process by a fresh, not started QProcess.
+ **********************************************************************************************************************/
+void SimulationRunner::testAttachDummyProcess()
+{
+    delete m_process;
+    m_process = new QProcess(this);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that reports whether a simulation process is attached.
+ **********************************************************************************************************************/
+bool SimulationRunner::testHasProcess() const
+{
+    return m_process != nullptr;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Test helper that starts the Palace solver stage from a prepared context in test builds.
+ **********************************************************************************************************************/
+void SimulationRunner::testStartPalaceSolverStage(PalaceRunContext &ctx)
+{
+    if (!m_process)
+        m_process = new QProcess(this);
+    startPalaceSolverStage(ctx);
+}
+
+#endif
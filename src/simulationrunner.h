@@ -0,0 +1,276 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SIMULATIONRUNNER_H
+#define SIMULATIONRUNNER_H
+
+#include <QMap>
+#include <QObject>
+#include <QString>
+#include <QVariant>
+#include <QDateTime>
+#include <QByteArray>
+#include <QStringList>
+
+#include "runcache.h"
+#include "runreport.h"
+#include "palacesparameters.h"
+
+class QTimer;
+class QProcess;
+class QProcessEnvironment;
+class ProcessTelemetry;
+class SimulationLogAnalyzer;
+
+/*!*******************************************************************************************************************
+ * \class SimulationRunner
+ * \brief Widget-free driver for the Palace, Elmer and openEMS simulation pipelines.
+ *
+ * Owns the simulation process and the streaming log analyzer and runs the complete pipeline from a
+ * snapshot of the preferences and simulation settings: Palace/Elmer runs execute the gds2palace Python
+ * model first and then dispatch the solver stage found in the generated run directory; openEMS runs start
+ * the Python model directly.
+ *
+ * The runner depends on QtCore only, so it can be driven both by MainWindow and by the headless command
+ * line runner on a QCoreApplication. All process output, banners and errors are reported through signals;
+ * \c finished() is emitted exactly once per run attempt, including runs that fail before a process starts.
+ *
+ * Runs are fingerprinted through the RunCache: a run whose inputs match an earlier run with complete results
+ * finishes immediately with those results, and a Palace/Elmer run whose preprocessing inputs match reuses
+ * the generated run directory and starts with the solver stage. Set the RUN_CACHE preference to false to
+ * always run the full pipeline.
+ *
+ * Every stage process is sampled by a ProcessTelemetry (TELEMETRY_INTERVAL_MS, 0 = off); at the end of a run the
+ * per-stage figures are written to the log and the samples to a telemetry file next to the run directory.
+ * Stage start and end are reported through \c stageStarted() / \c stageFinished() and collected in a RunReport,
+ * written as run_report.json into the run directory (RUN_REPORT preference).
+ * The S-parameters of every successful run are checked for passivity, reciprocity and causality
+ * (SParameterChecks, SPARAM_CHECKS preference) and ingested into the ResultStore together with the run's
+ * fingerprint and stage timings, for comparison across runs (RESULT_STORE preference).
+ *
+ * A Palace/Elmer run is a graph of stages: the preprocessing stage (gds2palace Python model) is followed by
+ * the solver stage. With setHoldBeforeSolver() the runner stops between the two, emits
+ * \c preprocessingFinished() and waits for continueWithSolver(), so a scheduler can preprocess the next model
+ * while the solver of the previous one still runs.
+ *
+ * With SPARAM_STOP_BAND_GHZ set, the port-S.csv of a running Palace solver is tailed by a PalaceSParameters and
+ * the solver is stopped as soon as the S-parameters in that band have converged.
+ **********************************************************************************************************************/
+class SimulationRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class Phase { None, PythonModel, Preprocessed, Solver };
+    enum class SolverKind { Unknown, Palace, Elmer };
+
+    struct PalaceRunContext
+    {
+        QString simKeyLower;
+
+        QString modelWin;
+        QString launcherWin;
+        int     runMode = 0;
+
+        QString baseName;
+        QString runDirGuessWin;
+
+        QString palaceRoot;
+        QString distro;
+        QString pythonCmd;
+        QStringList pythonArgs;
+
+        bool    useWsl = true;
+
+        QString palaceExeLinux;
+        QString modelDirLinux;
+        QString modelLinux;
+
+        QString detectedRunDirWin;
+        QString searchDirWin;
+
+        QString configPathWin;
+        QString configLinux;
+    };
+
+    struct CoreCountResult
+    {
+        QString cores;
+        QString source;  // "physical (sysfs)" / "physical (lscpu)" / "logical (nproc)"
+    };
+
+    explicit SimulationRunner(QObject *parent = nullptr);
+
+    void                        setPreferences(const QMap<QString, QVariant> &preferences);
+    void                        setSimSettings(const QMap<QString, QVariant> &simSettings);
+    void                        setSimToolKey(const QString &simKey);
+    void                        setCoreLimit(int cores);
+    void                        setHoldBeforeSolver(bool hold) { m_holdBeforeSolver = hold; }
+
+    const QMap<QString, QVariant> &preferences() const { return m_preferences; }
+    const QMap<QString, QVariant> &simSettings() const { return m_simSettings; }
+    QString                     simToolKey() const { return m_simToolKey; }
+    int                         coreLimit() const { return m_coreLimit; }
+    bool                        holdBeforeSolver() const { return m_holdBeforeSolver; }
+
+    bool                        isRunning() const;
+    bool                        isWaitingForSolver() const { return m_phase == Phase::Preprocessed; }
+    bool                        runCacheEnabled() const;
+    Phase                       phase() const { return m_phase; }
+    SimulationLogAnalyzer      *logAnalyzer() const { return m_logAnalyzer; }
+    ProcessTelemetry           *telemetry() const { return m_telemetry; }
+    const RunReport            &report() const { return m_report; }
+    void                        notePreRunStage(const QString &stage, const QDateTime &started, qint64 durationMs);
+
+    bool                        runPalace();
+    bool                        runOpenEMS();
+    bool                        continueWithSolver();
+    void                        stop();
+
+    bool                        buildPalaceRunContext(PalaceRunContext &ctx, QString &outError) const;
+    CoreCountResult             detectMpiCoreCount() const;
+    QString                     detectRunDirFromLog() const;
+
+    QString                     guessDefaultPalaceRunDir(const QString &modelFile, const QString &baseName) const;
+    QString                     chooseSearchDir(const QString &detectedRunDir, const QString &defaultRunDir) const;
+    QString                     findPalaceConfigJson(const QString &runDir) const;
+
+    static QString              toWslPath(const QString &winPath);
+    static QString              wslToWinPath(const QString &p);
+    static QString              parsePhysicalCoresFromLscpuCsv(QString out);
+
+signals:
+    void                        started();
+    void                        output(const QByteArray &data);
+    void                        errorOccurred(const QString &message, bool clearLog);
+    void                        runDirectoryDetected(const QString &runDir);
+    void                        preprocessingFinished(const QString &runDir);
+    void                        stageStarted(const QString &stage);
+    void                        stageFinished(const QString &stage, qint64 durationMs, int exitCode);
+    void                        finished(int exitCode);
+
+#ifdef EMSTUDIO_TESTING
+public:
+    void                        testLogPalaceStartupInfo(const PalaceRunContext &ctx);
+    bool                        testPreparePalaceSolverLaunch(PalaceRunContext &ctx,
+                                                              QString &outWorkDirLinux,
+                                                              QString &outCmd,
+                                                              QString &outCores);
+    void                        testFailPalaceSolver(const QString &message, bool showDialog);
+    void                        testSetPhase(Phase phase);
+    void                        testFinishPalaceProcess(int exitCode);
+    void                        testAttachDummyProcess();
+    bool                        testHasProcess() const;
+    void                        testStartPalaceSolverStage(PalaceRunContext &ctx);
+#endif
+
+private:
+    void                        appendOutput(const QByteArray &data);
+    void                        appendText(const QString &text);
+    void                        connectProcessIo();
+    void                        createPalaceProcess();
+    void                        releaseProcess();
+    void                        terminateProcess();
+    void                        finishRun(int exitCode);
+    void                        beginRunTelemetry();
+    void                        writeRunTelemetry();
+    void                        beginRunReport();
+    void                        beginReportStage(const QString &stage);
+    void                        endReportStage(int exitCode);
+    void                        writeRunReport(int exitCode);
+    QString                     stageName() const;
+    QString                     resultRunDir() const;
+
+    void                        logPalaceStartupInfo(const PalaceRunContext &ctx);
+    void                        startPalacePythonStage(const PalaceRunContext &ctx);
+    void                        onPalaceProcessFinished(int exitCode);
+    void                        completePreprocessingStage(int exitCode);
+    void                        completeSolverStage(int exitCode);
+    void                        enterSolverStage(const QString &detectedRunDir);
+    void                        startGds2PalaceSolver(const QString &detectedRunDir);
+    void                        startPalaceSolverStage(PalaceRunContext &ctx);
+    void                        startElmerSolverStage(PalaceRunContext &ctx);
+    bool                        startPalaceLauncherStage(PalaceRunContext &ctx);
+    bool                        preparePalaceSolverLaunch(PalaceRunContext &ctx,
+                                                          QString &outWorkDirLinux,
+                                                          QString &outCmd,
+                                                          QString &outCores);
+    bool                        runPalaceSolverWindows(const PalaceRunContext &ctx, const QString &cmd);
+    bool                        runPalaceSolverLinux(const PalaceRunContext &ctx,
+                                                     const QString &workDirLinux,
+                                                     const QString &cmd);
+    void                        failPalaceSolver(const QString &message, bool showDialog);
+
+    SolverKind                  detectGds2PalaceSolverKind(const QString &runDir, const QString &simKeyLower) const;
+    QString                     resolveGds2PalaceRunDir(const PalaceRunContext &ctx) const;
+    QString                     buildElmerEnvShellPrefix() const;
+    void                        applyElmerHomeToProcessEnv(QProcessEnvironment &env) const;
+    bool                        resolveElmerPythonLaunch(QString &outExe, QStringList &outArgs) const;
+    void                        patchElmerSifFilesNoMumps(const QString &runDir) const;
+
+    RunCache::Key               computeRunCacheKey(const QString &preprocessor,
+                                                   const QString &solver,
+                                                   bool useWsl = false,
+                                                   const QString &distro = QString()) const;
+    QString                     gds2PalaceSolverIdentity(const PalaceRunContext &ctx) const;
+    bool                        reuseCachedResults();
+    void                        storeRunCacheResults(const QString &runDir);
+    void                        convertSolverResults(const QString &runDir);
+    bool                        readRunResults(int exitCode, Touchstone::Network &out, QString &outSource);
+    void                        checkRunResults(const Touchstone::Network &network);
+    void                        ingestRunResults(const Touchstone::Network &network, const QString &source);
+    void                        startConvergenceWatch();
+    void                        pollConvergence();
+
+    QString                     queryWslCpuCores(const QString &distro) const;
+    QString                     detectPhysicalCoreCountLinux() const;
+#ifdef Q_OS_WIN
+    bool                        ensureWslAvailable(QString &outError) const;
+#endif
+
+private:
+    QMap<QString, QVariant>     m_preferences;
+    QMap<QString, QVariant>     m_simSettings;
+    QString                     m_simToolKey;
+    int                         m_coreLimit = 0;
+    bool                        m_holdBeforeSolver = false;
+    QString                     m_preprocessedRunDir;
+    QString                     m_solverRunDir;
+
+    QProcess                   *m_process = nullptr;
+    SimulationLogAnalyzer      *m_logAnalyzer = nullptr;
+    ProcessTelemetry           *m_telemetry = nullptr;
+    Phase                       m_phase = Phase::None;
+
+    RunCache::Key               m_cacheKey;
+    QString                     m_cacheRunDir;
+    QDateTime                   m_runStarted;
+
+    RunReport                   m_report;
+    QList<RunReport::Stage>     m_preRunStages;
+
+    QTimer                     *m_convergenceTimer = nullptr;
+    PalaceSParameters           m_sparamTail;
+    bool                        m_stoppedConverged = false;
+
+    static constexpr int        kConvergencePollMs = 2000;
+};
+
+#endif // SIMULATIONRUNNER_H
@@ -0,0 +1,374 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QtMath>
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "parallelfor.h"
+#include "sparameterchecks.h"
+
+namespace {
+
+const int kMaxPowerIterations = 300;
+const int kMaxCausalityPoints = 4096;
+
+/*!*******************************************************************************************************************
+ * \brief In-place radix-2 FFT of split real/imaginary arrays; \a n must be a power of two.
+ *
+ * \param sign -1 for the forward, +1 for the inverse transform (unscaled).
+ **********************************************************************************************************************/
+void fft(double *re, double *im, int n, int sign)
+{
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+        if (i < j) {
+            std::swap(re[i], re[j]);
+            std::swap(im[i], im[j]);
+        }
+    }
+
+    for (int len = 2; len <= n; len <<= 1) {
+        const double angle = sign * 2.0 * M_PI / len;
+        const double wr = std::cos(angle);
+        const double wi = std::sin(angle);
+        const int half = len / 2;
+
+        for (int i = 0; i < n; i += len) {
+            double cr = 1.0;
+            double ci = 0.0;
+            for (int k = 0; k < half; ++k) {
+                const int a = i + k;
+                const int b = a + half;
+                const double tr = re[b] * cr - im[b] * ci;
+                const double ti = re[b] * ci + im[b] * cr;
+                re[b] = re[a] - tr;
+                im[b] = im[a] - ti;
+                re[a] += tr;
+                im[a] += ti;
+
+                const double nr = cr * wr - ci * wi;
+                ci = cr * wi + ci * wr;
+                cr = nr;
+            }
+        }
+    }
+}
+
+struct MatrixScratch
+{
+    std::vector<double>         re;
+    std::vector<double>         im;
+};
+
+struct NoScratch
+{
+};
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Returns the largest singular value of the n x n matrix S = re + j im (row-major).
+ *
+ * Power iteration on S^H S, started from the column norms; the Rayleigh quotient |S x|^2 of the unit vector x
+ * increases monotonically towards the largest eigenvalue of S^H S and the iteration stops once it no longer
+ * changes in the 12th digit. For (nearly) lossless networks all singular values are close to 1 and the first
+ * steps are already accurate.
+ **********************************************************************************************************************/
+double SParameterChecks::largestSingularValue(const double *re, const double *im, int n)
+{
+    std::vector<double> xr(n, 0.0);
+    std::vector<double> xi(n, 0.0);
+    std::vector<double> yr(n);
+    std::vector<double> yi(n);
+
+    for (int r = 0; r < n; ++r) {
+        const double *ar = re + size_t(r) * n;
+        const double *ai = im + size_t(r) * n;
+        for (int c = 0; c < n; ++c)
+            xr[c] += ar[c] * ar[c] + ai[c] * ai[c];
+    }
+
+    double norm = 0.0;
+    for (int c = 0; c < n; ++c) {
+        xr[c] = std::sqrt(xr[c]);
+        norm += xr[c] * xr[c];
+    }
+    if (norm <= 0.0)
+        return 0.0;
+
+    norm = 1.0 / std::sqrt(norm);
+    for (int c = 0; c < n; ++c)
+        xr[c] *= norm;
+
+    double lambda = 0.0;
+    for (int iteration = 0; iteration < kMaxPowerIterations; ++iteration) {
+        // y = S x
+        double quotient = 0.0;
+        for (int r = 0; r < n; ++r) {
+            const double *ar = re + size_t(r) * n;
+            const double *ai = im + size_t(r) * n;
+            double sr = 0.0;
+            double si = 0.0;
+            for (int c = 0; c < n; ++c) {
+                sr += ar[c] * xr[c] - ai[c] * xi[c];
+                si += ar[c] * xi[c] + ai[c] * xr[c];
+            }
+            yr[r] = sr;
+            yi[r] = si;
+            quotient += sr * sr + si * si;
+        }
+
+        const bool converged = quotient - lambda <= 1e-12 * quotient;
+        lambda = qMax(lambda, quotient);
+        if (converged)
+            break;
+
+        // x = S^H y, normalized
+        std::fill(xr.begin(), xr.end(), 0.0);
+        std::fill(xi.begin(), xi.end(), 0.0);
+        for (int r = 0; r < n; ++r) {
+            const double *ar = re + size_t(r) * n;
+            const double *ai = im + size_t(r) * n;
+            const double br = yr[r];
+            const double bi = yi[r];
+            for (int c = 0; c < n; ++c) {
+                xr[c] += ar[c] * br + ai[c] * bi;
+                xi[c] += ar[c] * bi - ai[c] * br;
+            }
+        }
+
+        norm = 0.0;
+        for (int c = 0; c < n; ++c)
+            norm += xr[c] * xr[c] + xi[c] * xi[c];
+        if (norm <= 0.0)
+            break;
+
+        norm = 1.0 / std::sqrt(norm);
+        for (int c = 0; c < n; ++c) {
+            xr[c] *= norm;
+            xi[c] *= norm;
+        }
+    }
+
+    return std::sqrt(lambda);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the relative asymmetry |S - S^T|_F / |S|_F of the n x n matrix S = re + j im (row-major).
+ **********************************************************************************************************************/
+double SParameterChecks::asymmetry(const double *re, const double *im, int n)
+{
+    double total = 0.0;
+    const size_t size = size_t(n) * size_t(n);
+    for (size_t i = 0; i < size; ++i)
+        total += re[i] * re[i] + im[i] * im[i];
+    if (total <= 0.0)
+        return 0.0;
+
+    double difference = 0.0;
+    for (int r = 0; r < n; ++r) {
+        for (int c = r + 1; c < n; ++c) {
+            const double dr = re[size_t(r) * n + c] - re[size_t(c) * n + r];
+            const double di = im[size_t(r) * n + c] - im[size_t(c) * n + r];
+            difference += dr * dr + di * di;
+        }
+    }
+
+    return std::sqrt(2.0 * difference / total);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the share of the impulse response energy of one S-parameter found at negative times.
+ *
+ * The sweep is linearly resampled onto a uniform grid from DC to its highest frequency with about the mean point
+ * spacing of the data (the DC value is the real part of the lowest point), tapered with a half Hann window and
+ * transformed with a Hermitian-symmetric inverse FFT. For a causal response (Kramers-Kronig consistent data)
+ * the last quarter of the period, t in [-T/4, 0), holds only the window's leakage around t = 0; a guard band of
+ * two time resolution steps 1/(2 fmax), the half width of the window's main lobe, is excluded.
+ *
+ * \param frequencies Ascending frequencies (Hz).
+ * \param values      First value of the entry; the value of point k is values[k * stride].
+ * \param count       Number of points.
+ * \param stride      Distance between the values of consecutive frequencies.
+ * \return Energy share in [0, 1], or -1 if the sweep has fewer than kMinCausalitySamples points.
+ **********************************************************************************************************************/
+double SParameterChecks::nonCausalEnergy(const double *frequencies, const Touchstone::Complex *values, int count,
+                                         int stride)
+{
+    if (count < kMinCausalitySamples)
+        return -1.0;
+
+    const double fMin = frequencies[0];
+    const double fMax = frequencies[count - 1];
+    if (fMax <= 0.0 || fMax <= fMin)
+        return -1.0;
+
+    const double spacing = (fMax - qMax(fMin, 0.0)) / (count - 1);
+    const int points = qBound(16, int(fMax / spacing + 0.5) + 1, kMaxCausalityPoints);
+    int length = 1;
+    while (length < 2 * points)
+        length <<= 1;
+
+    std::vector<double> re(length, 0.0);
+    std::vector<double> im(length, 0.0);
+
+    const Touchstone::Complex dc(values[0].real(), 0.0);
+    int j = 0;
+    for (int k = 0; k < points; ++k) {
+        const double f = fMax * k / (points - 1);
+
+        Touchstone::Complex v;
+        if (f <= fMin) {
+            v = fMin > 0.0 ? dc + (f / fMin) * (values[0] - dc) : values[0];
+        } else {
+            while (j + 2 < count && frequencies[j + 1] < f)
+                ++j;
+            const double span = frequencies[j + 1] - frequencies[j];
+            const double t = span > 0.0 ? (f - frequencies[j]) / span : 0.0;
+            const Touchstone::Complex a = values[size_t(j) * stride];
+            v = a + t * (values[size_t(j + 1) * stride] - a);
+        }
+
+        const double window = 0.5 * (1.0 + std::cos(M_PI * k / (points - 1)));
+        re[k] = window * v.real();
+        im[k] = window * v.imag();
+        if (k > 0) {
+            re[length - k] = re[k];
+            im[length - k] = -im[k];
+        }
+    }
+
+    fft(re.data(), im.data(), length, 1);
+
+    double total = 0.0;
+    for (int i = 0; i < length; ++i)
+        total += re[i] * re[i];
+    if (total <= 0.0)
+        return 0.0;
+
+    const int guard = qMax(1, int(std::ceil(double(length) / (points - 1))));
+    double negative = 0.0;
+    for (int i = length - length / 4; i < length - guard; ++i)
+        negative += re[i] * re[i];
+
+    return negative / total;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Runs all checks on a network.
+ *
+ * \param network S-parameters to check; frequencies must be ascending.
+ * \param options Tolerances and thread count.
+ * \return Worst values, where they occur and the pass/fail state of each check.
+ **********************************************************************************************************************/
+SParameterChecks::Result SParameterChecks::check(const Touchstone::Network &network, const Options &options)
+{
+    Result result;
+    if (!network.isValid())
+        return result;
+
+    const int n = network.ports;
+    const int nf = network.frequencyCount();
+    const int entries = n * n;
+    const int threads = parallelThreadCount(options.threads);
+
+    result.ports = n;
+    result.frequencies = nf;
+
+    std::vector<double> sigma(nf);
+    std::vector<double> asym(nf);
+    const Touchstone::Complex *values = network.values.constData();
+
+    parallelFor<MatrixScratch>(nf, threads, [&](int f, MatrixScratch &scratch) {
+        scratch.re.resize(entries);
+        scratch.im.resize(entries);
+        const Touchstone::Complex *s = values + size_t(f) * entries;
+        for (int i = 0; i < entries; ++i) {
+            scratch.re[i] = s[i].real();
+            scratch.im[i] = s[i].imag();
+        }
+        sigma[f] = largestSingularValue(scratch.re.data(), scratch.im.data(), n);
+        asym[f] = asymmetry(scratch.re.data(), scratch.im.data(), n);
+    });
+
+    for (int f = 0; f < nf; ++f) {
+        if (sigma[f] > result.maxSingularValue) {
+            result.maxSingularValue = sigma[f];
+            result.singularValueFrequency = network.frequencies.at(f);
+        }
+        if (asym[f] > result.maxAsymmetry) {
+            result.maxAsymmetry = asym[f];
+            result.asymmetryFrequency = network.frequencies.at(f);
+        }
+    }
+
+    if (nf >= kMinCausalitySamples) {
+        std::vector<double> energy(entries);
+        parallelFor<NoScratch>(entries, threads, [&](int e, NoScratch &) {
+            energy[e] = nonCausalEnergy(network.frequencies.constData(), values + e, nf, entries);
+        });
+
+        for (int e = 0; e < entries; ++e) {
+            if (energy[e] > result.maxNonCausalEnergy) {
+                result.maxNonCausalEnergy = energy[e];
+                result.nonCausalRow = e / n;
+                result.nonCausalColumn = e % n;
+            }
+        }
+    }
+
+    result.passive    = result.maxSingularValue <= 1.0 + options.passivityTolerance;
+    result.reciprocal = result.maxAsymmetry <= options.reciprocityTolerance;
+    result.causal     = result.maxNonCausalEnergy <= options.causalityTolerance;
+    return result;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns one line per check for the simulation log, e.g. "passivity: PASS (max singular value ...)".
+ **********************************************************************************************************************/
+QStringList SParameterChecks::Result::summary() const
+{
+    auto state = [](bool ok) { return ok ? QStringLiteral("PASS") : QStringLiteral("FAIL"); };
+
+    QStringList lines;
+    lines << QString("passivity:   %1 (max singular value %2 at %3 GHz)")
+                 .arg(state(passive))
+                 .arg(maxSingularValue, 0, 'f', 6)
+                 .arg(singularValueFrequency / 1e9, 0, 'g', 6);
+    lines << QString("reciprocity: %1 (max |S - S^T| / |S| %2 at %3 GHz)")
+                 .arg(state(reciprocal))
+                 .arg(maxAsymmetry, 0, 'g', 3)
+                 .arg(asymmetryFrequency / 1e9, 0, 'g', 6);
+    if (maxNonCausalEnergy < 0.0)
+        lines << QString("causality:   skipped (fewer than %1 frequency points)").arg(kMinCausalitySamples);
+    else
+        lines << QString("causality:   %1 (max %2 % of impulse response energy at negative times, S%3%4)")
+                     .arg(state(causal))
+                     .arg(100.0 * maxNonCausalEnergy, 0, 'f', 2)
+                     .arg(nonCausalRow + 1)
+                     .arg(nonCausalColumn + 1);
+    return lines;
+}
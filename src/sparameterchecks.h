@@ -0,0 +1,86 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SPARAMETERCHECKS_H
+#define SPARAMETERCHECKS_H
+
+#include <QString>
+#include <QStringList>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class SParameterChecks
+ * \brief Physical consistency checks of S-parameter results: passivity, reciprocity and causality.
+ *
+ * - Passivity: the largest singular value of S must not exceed 1 at any frequency. It is computed by power
+ *   iteration on S^H S, which needs only matrix-vector products (O(n^2) per step) instead of a full SVD.
+ * - Reciprocity: the relative asymmetry |S - S^T|_F / |S|_F per frequency.
+ * - Causality (Kramers-Kronig style): every entry is resampled onto a uniform grid from DC to the highest
+ *   frequency, tapered with a half Hann window and transformed to the time domain; the share of the impulse
+ *   response energy at negative times (the last quarter of the period, outside a guard band around t = 0) must
+ *   stay small. Sweeps with fewer than kMinCausalitySamples points are not checked for causality.
+ *
+ * The kernels work on split real/imaginary arrays with unit-stride inner loops so the compiler can vectorize
+ * them. Frequencies (passivity, reciprocity) and matrix entries (causality) are distributed over worker threads.
+ **********************************************************************************************************************/
+class SParameterChecks
+{
+public:
+    struct Options
+    {
+        double                  passivityTolerance = 1e-3;      // largest singular value may reach 1 + this
+        double                  reciprocityTolerance = 1e-2;    // relative asymmetry
+        double                  causalityTolerance = 0.05;      // share of energy at negative times
+        int                     threads = 0;                    // 0 = hardware concurrency
+    };
+
+    struct Result
+    {
+        int                     ports = 0;
+        int                     frequencies = 0;
+
+        double                  maxSingularValue = 0.0;
+        double                  singularValueFrequency = 0.0;   // Hz
+        double                  maxAsymmetry = 0.0;
+        double                  asymmetryFrequency = 0.0;       // Hz
+        double                  maxNonCausalEnergy = -1.0;      // negative if causality was not checked
+        int                     nonCausalRow = -1;
+        int                     nonCausalColumn = -1;
+
+        bool                    passive = true;
+        bool                    reciprocal = true;
+        bool                    causal = true;
+
+        bool                    passed() const { return passive && reciprocal && causal; }
+        QStringList             summary() const;
+    };
+
+    static Result               check(const Touchstone::Network &network, const Options &options = Options());
+
+    static double               largestSingularValue(const double *re, const double *im, int n);
+    static double               asymmetry(const double *re, const double *im, int n);
+    static double               nonCausalEnergy(const double *frequencies, const Touchstone::Complex *values,
+                                                int count, int stride);
+
+    static constexpr int        kMinCausalitySamples = 8;
+};
+
+#endif // SPARAMETERCHECKS_H
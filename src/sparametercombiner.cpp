@@ -0,0 +1,700 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFileInfo>
+#include <QtMath>
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include "parallelfor.h"
+#include "elmerresults.h"
+#include "palacesparameters.h"
+#include "sparametercombiner.h"
+
+namespace {
+
+/*!*******************************************************************************************************************
+ * \brief Linear combination of source points per target frequency (linear and rational interpolation).
+ *
+ * Target t takes width source points starting at start[t] with the weights weights[t * width + k].
+ **********************************************************************************************************************/
+struct Stencil
+{
+    int                         width = 0;
+    QVector<int>                start;
+    QVector<double>             weights;
+};
+
+/*!*******************************************************************************************************************
+ * \brief Natural cubic spline through fixed nodes, evaluated at fixed targets.
+ *
+ * The tridiagonal system for the second derivatives depends on the nodes only; its forward elimination factors
+ * (denominator and modified upper diagonal, Thomas algorithm) are computed once and reused for every entry.
+ **********************************************************************************************************************/
+struct SplinePlan
+{
+    QVector<double>             h;          // node spacing
+    QVector<double>             denom;      // per interior node
+    QVector<double>             upper;      // per interior node
+    QVector<int>                interval;   // per target
+    QVector<double>             a;          // per target, weight of the left node
+};
+
+struct Scratch
+{
+    std::vector<double>         re;
+    std::vector<double>         im;
+    std::vector<double>         curvature;
+    std::vector<double>         rhs;
+};
+
+/*!*******************************************************************************************************************
+ * \brief Returns the interval j with x[j] <= f <= x[j + 1], clamped to the first and last interval.
+ **********************************************************************************************************************/
+int intervalOf(const QVector<double> &x, double f)
+{
+    const int upper = int(std::upper_bound(x.constBegin(), x.constEnd(), f) - x.constBegin());
+    return qBound(0, upper - 1, x.size() - 2);
+}
+
+Stencil linearStencil(const QVector<double> &x, const QVector<double> &target)
+{
+    Stencil s;
+    s.width = 2;
+    s.start.resize(target.size());
+    s.weights.resize(target.size() * 2);
+
+    for (int t = 0; t < target.size(); ++t) {
+        const int j = intervalOf(x, target.at(t));
+        const double w = qBound(0.0, (target.at(t) - x.at(j)) / (x.at(j + 1) - x.at(j)), 1.0);
+        s.start[t] = j;
+        s.weights[2 * t] = 1.0 - w;
+        s.weights[2 * t + 1] = w;
+    }
+    return s;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Floater-Hormann barycentric rational interpolation of degree 3 on a window of points around each target.
+ *
+ * Weights of node k of the window x_0..x_{W-1}: w_k = (-1)^(k-d) * sum over i in [max(0, k-d), min(k, W-1-d)] of
+ * prod over l = i..i+d, l != k of 1/|x_k - x_l|. The interpolant has no poles on the real axis.
+ **********************************************************************************************************************/
+Stencil rationalStencil(const QVector<double> &x, const QVector<double> &target)
+{
+    const int n = x.size();
+    const int width = qMin(int(SParameterCombiner::kRationalWindow), n);
+    const int d = qMin(3, width - 1);
+
+    Stencil s;
+    s.width = width;
+    s.start.resize(target.size());
+    s.weights.fill(0.0, target.size() * width);
+
+    std::vector<double> w(width);
+    for (int t = 0; t < target.size(); ++t) {
+        const double f = target.at(t);
+        const int start = qBound(0, intervalOf(x, f) - width / 2 + 1, n - width);
+        const double *xs = x.constData() + start;
+        double *weights = s.weights.data() + t * width;
+        s.start[t] = start;
+
+        if (f <= x.first()) {
+            weights[0] = 1.0;
+            continue;
+        }
+        if (f >= x.last()) {
+            weights[width - 1] = 1.0;
+            continue;
+        }
+
+        int exact = -1;
+        for (int k = 0; k < width; ++k) {
+            if (f == xs[k])
+                exact = k;
+        }
+        if (exact >= 0) {
+            weights[exact] = 1.0;
+            continue;
+        }
+
+        double sum = 0.0;
+        for (int k = 0; k < width; ++k) {
+            double wk = 0.0;
+            for (int i = qMax(0, k - d); i <= qMin(k, width - 1 - d); ++i) {
+                double product = 1.0;
+                for (int l = i; l <= i + d; ++l) {
+                    if (l != k)
+                        product /= std::abs(xs[k] - xs[l]);
+                }
+                wk += product;
+            }
+            w[k] = ((k + d) & 1 ? -wk : wk) / (f - xs[k]);
+            sum += w[k];
+        }
+        for (int k = 0; k < width; ++k)
+            weights[k] = w[k] / sum;
+    }
+    return s;
+}
+
+SplinePlan planSpline(const QVector<double> &x, const QVector<double> &target)
+{
+    const int n = x.size();
+
+    SplinePlan plan;
+    plan.h.resize(n - 1);
+    for (int i = 0; i + 1 < n; ++i)
+        plan.h[i] = x.at(i + 1) - x.at(i);
+
+    plan.denom.fill(1.0, n);
+    plan.upper.fill(0.0, n);
+    for (int i = 1; i + 1 < n; ++i) {
+        const double lower = plan.h.at(i - 1);
+        plan.denom[i] = 2.0 * (plan.h.at(i - 1) + plan.h.at(i)) - lower * plan.upper.at(i - 1);
+        plan.upper[i] = plan.h.at(i) / plan.denom.at(i);
+    }
+
+    plan.interval.resize(target.size());
+    plan.a.resize(target.size());
+    for (int t = 0; t < target.size(); ++t) {
+        const int j = intervalOf(x, target.at(t));
+        plan.interval[t] = j;
+        plan.a[t] = qBound(0.0, (x.at(j + 1) - target.at(t)) / plan.h.at(j), 1.0);
+    }
+    return plan;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Evaluates the natural cubic spline through (x, y) at the targets of \a plan into \a out.
+ **********************************************************************************************************************/
+void evaluateSpline(const SplinePlan &plan, const double *y, double *out, Scratch &scratch)
+{
+    const int n = plan.h.size() + 1;
+    scratch.curvature.assign(n, 0.0);
+    scratch.rhs.assign(n, 0.0);
+    double *m = scratch.curvature.data();
+    double *rhs = scratch.rhs.data();
+    const double *h = plan.h.constData();
+
+    for (int i = 1; i + 1 < n; ++i) {
+        const double r = 6.0 * ((y[i + 1] - y[i]) / h[i] - (y[i] - y[i - 1]) / h[i - 1]);
+        rhs[i] = (r - h[i - 1] * rhs[i - 1]) / plan.denom.at(i);
+    }
+    for (int i = n - 2; i >= 1; --i)
+        m[i] = rhs[i] - plan.upper.at(i) * m[i + 1];
+
+    const int count = plan.interval.size();
+    for (int t = 0; t < count; ++t) {
+        const int j = plan.interval.at(t);
+        const double a = plan.a.at(t);
+        const double b = 1.0 - a;
+        out[t] = a * y[j] + b * y[j + 1] + ((a * a * a - a) * m[j] + (b * b * b - b) * m[j + 1]) * h[j] * h[j] / 6.0;
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Replaces the values in re/im by magnitude and unwrapped phase.
+ **********************************************************************************************************************/
+void toPolar(std::vector<double> &re, std::vector<double> &im)
+{
+    double previous = 0.0;
+    for (size_t k = 0; k < re.size(); ++k) {
+        const double magnitude = std::hypot(re[k], im[k]);
+        double phase = std::atan2(im[k], re[k]);
+        if (k > 0)
+            phase -= 2.0 * M_PI * std::round((phase - previous) / (2.0 * M_PI));
+        re[k] = magnitude;
+        im[k] = phase;
+        previous = phase;
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Checks that the frequencies of a network are strictly ascending, as interpolation requires.
+ **********************************************************************************************************************/
+bool checkAscending(const Touchstone::Network &network, QString &outError)
+{
+    for (int f = 1; f < network.frequencyCount(); ++f) {
+        if (!(network.frequencies.at(f) > network.frequencies.at(f - 1))) {
+            outError = QStringLiteral("Frequencies must be strictly ascending; merge the sweep first");
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Reads a sweep from a Touchstone file, a Palace port-S.csv table or an Elmer .names file.
+ *
+ * \param path     File to read; the type is taken from the name.
+ * \param out      Receives the network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::readSweep(const QString &path, Touchstone::Network &out, QString &outError)
+{
+    const QString name = QFileInfo(path).fileName();
+    if (name.endsWith(QLatin1String(".csv"), Qt::CaseInsensitive))
+        return PalaceSParameters::read(path, out, outError);
+    if (name.endsWith(QLatin1String(".names"), Qt::CaseInsensitive))
+        return ElmerResults::read(path, out, outError);
+    return Touchstone::read(path, out, outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Merges sweeps of one model into one network sorted by frequency.
+ *
+ * Frequencies within \a duplicateTolerance (relative) of each other are one point. Of such points, every matrix
+ * entry is taken from the sweep listed last that has a value for it (Palace tables leave entries of excitations
+ * that did not run as NaN).
+ *
+ * \param sweeps             Sweeps with equal port count and reference impedances.
+ * \param duplicateTolerance Relative frequency tolerance.
+ * \param out                Receives the merged network.
+ * \param outError           Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::merge(const QList<Touchstone::Network> &sweeps, double duplicateTolerance,
+                               Touchstone::Network &out, QString &outError)
+{
+    if (sweeps.isEmpty()) {
+        outError = QStringLiteral("No sweeps to merge");
+        return false;
+    }
+
+    const Touchstone::Network &first = sweeps.first();
+    for (int s = 0; s < sweeps.size(); ++s) {
+        const Touchstone::Network &sweep = sweeps.at(s);
+        if (!sweep.isValid()) {
+            outError = QString("Sweep %1 is empty or invalid").arg(s + 1);
+            return false;
+        }
+        if (sweep.ports != first.ports || sweep.references != first.references) {
+            outError = QString("Sweep %1 has other ports or reference impedances than sweep 1").arg(s + 1);
+            return false;
+        }
+    }
+
+    struct Point
+    {
+        double                  frequency;
+        int                     sweep;
+        int                     index;
+    };
+
+    QVector<Point> points;
+    for (int s = 0; s < sweeps.size(); ++s) {
+        for (int f = 0; f < sweeps.at(s).frequencyCount(); ++f)
+            points.append({ sweeps.at(s).frequencies.at(f), s, f });
+    }
+    std::stable_sort(points.begin(), points.end(), [](const Point &a, const Point &b) {
+        return a.frequency < b.frequency;
+    });
+
+    const int entries = first.ports * first.ports;
+    QVector<double> frequencies;
+    QVector<Touchstone::Complex> values;
+    frequencies.reserve(points.size());
+    values.reserve(points.size() * entries);
+
+    for (int i = 0; i < points.size();) {
+        const double f0 = points.at(i).frequency;
+        int end = i + 1;
+        while (end < points.size() &&
+               std::abs(points.at(end).frequency - f0) <= duplicateTolerance * qMax(std::abs(f0), 1.0))
+            ++end;
+
+        const int row = values.size();
+        values.resize(row + entries);
+        std::fill(values.begin() + row, values.end(),
+                  Touchstone::Complex(std::nan(""), std::nan("")));
+
+        for (int p = i; p < end; ++p) {
+            const Point &point = points.at(p);
+            const Touchstone::Complex *src = sweeps.at(point.sweep).values.constData() + point.index * entries;
+            for (int e = 0; e < entries; ++e) {
+                if (!std::isnan(src[e].real()))
+                    values[row + e] = src[e];
+            }
+        }
+        frequencies.append(points.at(end - 1).frequency);
+        i = end;
+    }
+
+    out = Touchstone::Network();
+    out.ports       = first.ports;
+    out.parameter   = first.parameter;
+    out.references  = first.references;
+    out.frequencies = frequencies;
+    out.values      = values;
+    out.comments    = first.comments;
+    if (sweeps.size() > 1)
+        out.comments << QString("Merged from %1 sweeps by EMStudio").arg(sweeps.size());
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Interpolates a network onto other frequencies.
+ *
+ * \param in       Source network with strictly ascending frequencies.
+ * \param target   Target frequencies (Hz); targets outside the source sweep keep the nearest end value.
+ * \param method   Interpolation method.
+ * \param threads  Worker threads (see parallelThreadCount()).
+ * \param out      Receives the resampled network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::resample(const Touchstone::Network &in, const QVector<double> &target, Interpolation method,
+                                  int threads, Touchstone::Network &out, QString &outError)
+{
+    if (!in.isValid() || target.isEmpty()) {
+        outError = QStringLiteral("Nothing to resample");
+        return false;
+    }
+    if (!checkAscending(in, outError))
+        return false;
+
+    const int n = in.frequencyCount();
+    const int m = target.size();
+    const int entries = in.ports * in.ports;
+
+    Touchstone::Network result;
+    result.parameter  = in.parameter;
+    result.references = in.references;
+    result.comments   = in.comments;
+    result.resize(in.ports, m);
+    result.frequencies = target;
+
+    const Touchstone::Complex *src = in.values.constData();
+    Touchstone::Complex *dst = result.values.data();
+
+    if (n == 1) {
+        for (int t = 0; t < m; ++t)
+            std::copy(src, src + entries, dst + size_t(t) * entries);
+        out = result;
+        return true;
+    }
+
+    if (method == Interpolation::Spline) {
+        const SplinePlan plan = planSpline(in.frequencies, target);
+        parallelFor<Scratch>(entries, parallelThreadCount(threads), [&](int e, Scratch &s) {
+            s.re.resize(n);
+            s.im.resize(n);
+            for (int k = 0; k < n; ++k) {
+                s.re[k] = src[size_t(k) * entries + e].real();
+                s.im[k] = src[size_t(k) * entries + e].imag();
+            }
+            toPolar(s.re, s.im);
+
+            std::vector<double> magnitude(m);
+            std::vector<double> phase(m);
+            evaluateSpline(plan, s.re.data(), magnitude.data(), s);
+            evaluateSpline(plan, s.im.data(), phase.data(), s);
+            for (int t = 0; t < m; ++t)
+                dst[size_t(t) * entries + e] = std::polar(qMax(0.0, magnitude[t]), phase[t]);
+        });
+    } else {
+        const Stencil stencil = method == Interpolation::Rational ? rationalStencil(in.frequencies, target)
+                                                                  : linearStencil(in.frequencies, target);
+        parallelFor<Scratch>(entries, parallelThreadCount(threads), [&](int e, Scratch &s) {
+            s.re.resize(n);
+            s.im.resize(n);
+            for (int k = 0; k < n; ++k) {
+                s.re[k] = src[size_t(k) * entries + e].real();
+                s.im[k] = src[size_t(k) * entries + e].imag();
+            }
+
+            const int width = stencil.width;
+            for (int t = 0; t < m; ++t) {
+                const double *w = stencil.weights.constData() + size_t(t) * width;
+                const double *re = s.re.data() + stencil.start.at(t);
+                const double *im = s.im.data() + stencil.start.at(t);
+                double sr = 0.0;
+                double si = 0.0;
+                for (int k = 0; k < width; ++k) {
+                    sr += w[k] * re[k];
+                    si += w[k] * im[k];
+                }
+                dst[size_t(t) * entries + e] = Touchstone::Complex(sr, si);
+            }
+        });
+    }
+
+    out = result;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Extends a sweep down to DC.
+ *
+ * The DC value of every entry is the real part of the linear extrapolation from the two lowest points. The gap
+ * between DC and the lowest point is filled with points at about the spacing of the two lowest points (at most
+ * kMaxDcPoints), interpolated with natural cubic splines of magnitude and unwrapped phase through the DC point and
+ * the sweep. A sweep that already starts at DC is returned unchanged.
+ *
+ * \param in       Sweep with strictly ascending frequencies and at least two points.
+ * \param threads  Worker threads (see parallelThreadCount()).
+ * \param out      Receives the extended network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::extendToDc(const Touchstone::Network &in, int threads, Touchstone::Network &out,
+                                    QString &outError)
+{
+    if (!in.isValid() || in.frequencyCount() < 2) {
+        outError = QStringLiteral("DC extension needs at least two frequency points");
+        return false;
+    }
+    if (!checkAscending(in, outError))
+        return false;
+    if (in.frequencies.first() <= 0.0) {
+        out = in;
+        return true;
+    }
+
+    const int n = in.frequencyCount();
+    const int entries = in.ports * in.ports;
+    const double f0 = in.frequencies.at(0);
+    const double f1 = in.frequencies.at(1);
+    const int added = qBound(1, int(std::round(f0 / (f1 - f0))), int(kMaxDcPoints));
+
+    QVector<double> nodes;
+    nodes.reserve(n + 1);
+    nodes << 0.0 << in.frequencies;
+
+    QVector<double> low(added);
+    for (int i = 0; i < added; ++i)
+        low[i] = f0 * i / added;
+
+    Touchstone::Network result;
+    result.parameter  = in.parameter;
+    result.references = in.references;
+    result.comments   = in.comments;
+    result.resize(in.ports, added + n);
+    std::copy(low.constBegin(), low.constEnd(), result.frequencies.begin());
+    std::copy(in.frequencies.constBegin(), in.frequencies.constEnd(), result.frequencies.begin() + added);
+    std::copy(in.values.constBegin(), in.values.constEnd(), result.values.begin() + size_t(added) * entries);
+
+    const SplinePlan plan = planSpline(nodes, low);
+    const Touchstone::Complex *src = in.values.constData();
+    Touchstone::Complex *dst = result.values.data();
+
+    parallelFor<Scratch>(entries, parallelThreadCount(threads), [&](int e, Scratch &s) {
+        const Touchstone::Complex s0 = src[e];
+        const Touchstone::Complex s1 = src[size_t(entries) + e];
+        const double dc = (s0 - f0 * (s1 - s0) / (f1 - f0)).real();
+
+        s.re.resize(n + 1);
+        s.im.resize(n + 1);
+        s.re[0] = dc;
+        s.im[0] = 0.0;
+        for (int k = 0; k < n; ++k) {
+            s.re[k + 1] = src[size_t(k) * entries + e].real();
+            s.im[k + 1] = src[size_t(k) * entries + e].imag();
+        }
+        toPolar(s.re, s.im);
+
+        std::vector<double> magnitude(added);
+        std::vector<double> phase(added);
+        evaluateSpline(plan, s.re.data(), magnitude.data(), s);
+        evaluateSpline(plan, s.im.data(), phase.data(), s);
+        for (int t = 0; t < added; ++t)
+            dst[size_t(t) * entries + e] = std::polar(qMax(0.0, magnitude[t]), phase[t]);
+        dst[e] = Touchstone::Complex(dc, 0.0);
+    });
+
+    out = result;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns whether a sweep qualifies for DC extension: enabled, enough points and a low enough start.
+ **********************************************************************************************************************/
+bool SParameterCombiner::canExtendToDc(const Touchstone::Network &network, const Options &options)
+{
+    return options.extendToDc && network.frequencyCount() >= qMax(2, options.dcMinPoints) &&
+           network.frequencies.first() > 0.0 && network.frequencies.first() <= options.dcMaxStart;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads and merges sweeps, extends them to DC if they qualify and resamples onto the target grid.
+ *
+ * DC extension runs before resampling, so a target grid may start at or below the lowest measured point.
+ *
+ * \param paths    Sweep files (see readSweep()).
+ * \param options  Interpolation, target grid, DC extension and thread settings.
+ * \param out      Receives the combined network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::combine(const QStringList &paths, const Options &options, Touchstone::Network &out,
+                                 QString &outError)
+{
+    QList<Touchstone::Network> sweeps;
+    for (const QString &path : paths) {
+        Touchstone::Network sweep;
+        if (!readSweep(path, sweep, outError))
+            return false;
+        sweeps.append(sweep);
+    }
+
+    Touchstone::Network network;
+    if (!merge(sweeps, options.duplicateTolerance, network, outError))
+        return false;
+
+    if (canExtendToDc(network, options) && !extendToDc(network, options.threads, network, outError))
+        return false;
+
+    if (!options.targetFrequencies.isEmpty() &&
+        !resample(network, options.targetFrequencies, options.interpolation, options.threads, network, outError))
+        return false;
+
+    out = network;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts the result file of a run to Touchstone, as scripts/combine_extend_snp.py does.
+ *
+ * Writes \c <name>.sNp next to \a resultPath (see writeNextToResults()) and, if the sweep qualifies for DC
+ * extension, \c <name>_dc.sNp with the extended sweep. A non-empty target grid in \a options resamples both.
+ *
+ * \param resultPath Palace port-S.csv, Elmer scalar_results.names or Touchstone file.
+ * \param options    Interpolation, target grid, DC extension and thread settings.
+ * \param outFiles   Receives the written files.
+ * \param outError   Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::convert(const QString &resultPath, const Options &options, QStringList &outFiles,
+                                 QString &outError)
+{
+    outFiles.clear();
+
+    Touchstone::Network network;
+    if (!readSweep(resultPath, network, outError))
+        return false;
+
+    const QFileInfo fi(resultPath);
+    network.comments << QString("Converted from %1 by EMStudio").arg(fi.fileName());
+
+    Touchstone::Network extended;
+    const bool withDc = canExtendToDc(network, options);
+    if (withDc && !extendToDc(network, options.threads, extended, outError))
+        return false;
+    extended.comments << QStringLiteral("DC point added by extrapolation");
+
+    if (!options.targetFrequencies.isEmpty()) {
+        if (!resample(network, options.targetFrequencies, options.interpolation, options.threads, network, outError))
+            return false;
+        if (withDc && !resample(extended, options.targetFrequencies, options.interpolation, options.threads,
+                                extended, outError))
+            return false;
+    }
+
+    QString path;
+    if (!writeNextToResults(network, fi.absolutePath(), QString(), path, outError))
+        return false;
+    outFiles << path;
+
+    if (withDc) {
+        if (!writeNextToResults(extended, fi.absolutePath(), QStringLiteral("_dc"), path, outError))
+            return false;
+        outFiles << path;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes a network as Touchstone file into the directory of a run's result file.
+ *
+ * The file is named after the directory, or after the model name from port_information.json if the directory is
+ * Elmer's generic "mesh", followed by \a nameSuffix. Port impedances from port_information.json replace the
+ * network's references; uniform impedances are written as v1 file, mixed ones as v2 file with a [Reference] line.
+ * Data are written in DB format with frequencies in GHz.
+ *
+ * \param network    Network to write.
+ * \param dataDir    Directory of the result file.
+ * \param nameSuffix Appended to the base name, e.g. "_dc".
+ * \param outPath    Receives the path of the written file.
+ * \param outError   Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool SParameterCombiner::writeNextToResults(Touchstone::Network network, const QString &dataDir,
+                                            const QString &nameSuffix, QString &outPath, QString &outError)
+{
+    ElmerResults::PortInformation info;
+    const bool hasInfo = ElmerResults::readPortInformation(dataDir, info);
+
+    Touchstone::WriteOptions options;
+    options.format = Touchstone::Format::DB;
+    options.frequencyUnit = QStringLiteral("GHz");
+
+    if (hasInfo && info.references.size() == network.ports)
+        network.references = info.references;
+    for (double z : qAsConst(network.references)) {
+        if (z != network.references.first())
+            options.version = 2;
+    }
+
+    QString baseName = QDir(dataDir).dirName();
+    if (baseName == QLatin1String("mesh") && !info.name.isEmpty())
+        baseName = info.name;
+
+    outPath = QDir(dataDir).filePath(baseName + nameSuffix + QLatin1Char('.') + Touchstone::fileSuffix(network.ports));
+    return Touchstone::write(outPath, network, options, outError);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns \a points equally spaced frequencies from \a fStart to \a fStop.
+ **********************************************************************************************************************/
+QVector<double> SParameterCombiner::linearGrid(double fStart, double fStop, int points)
+{
+    QVector<double> grid;
+    if (points < 1)
+        return grid;
+
+    grid.resize(points);
+    for (int i = 0; i < points; ++i)
+        grid[i] = points > 1 ? fStart + (fStop - fStart) * i / (points - 1) : fStart;
+    return grid;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses an interpolation name: "linear", "spline" (or "cubic") and "rational".
+ **********************************************************************************************************************/
+bool SParameterCombiner::parseInterpolation(const QString &name, Interpolation &out)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == QLatin1String("linear"))
+        out = Interpolation::Linear;
+    else if (key == QLatin1String("spline") || key == QLatin1String("cubic"))
+        out = Interpolation::Spline;
+    else if (key == QLatin1String("rational"))
+        out = Interpolation::Rational;
+    else
+        return false;
+    return true;
+}
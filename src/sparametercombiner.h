@@ -0,0 +1,91 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SPARAMETERCOMBINER_H
+#define SPARAMETERCOMBINER_H
+
+#include <QList>
+#include <QVector>
+#include <QString>
+#include <QStringList>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class SParameterCombiner
+ * \brief Native combine and extend workflow for S-parameter sweeps, replacing scripts/combine_extend_snp.py.
+ *
+ * - readSweep() loads Touchstone files, Palace port-S.csv tables and Elmer scalar results alike.
+ * - merge() joins several sweeps of one model into one network sorted by frequency. Frequencies that agree
+ *   within a relative tolerance count as one point; the sweep listed last wins.
+ * - resample() interpolates onto a target grid: linearly, with natural cubic splines of magnitude and unwrapped
+ *   phase (like scikit-rf's "cubic"/"polar"), or with Floater-Hormann barycentric rational interpolation
+ *   (degree 3, on a window of kRationalWindow points around each target). Targets outside the sweep keep the
+ *   nearest end value.
+ * - extendToDc() adds a DC point, estimated as the real part of the linear extrapolation from the two lowest
+ *   points, and fills the gap below the sweep with the polar spline, like scikit-rf's extrapolate_to_dc().
+ *
+ * Everything that depends only on the frequencies (interpolation stencils, spline factorization, interval
+ * lookup) is computed once; the per entry work runs on contiguous arrays and is spread over threads by port pair.
+ *
+ * convert() is the per-run workflow of the script: it writes \c <name>.sNp next to a result file, plus
+ * \c <name>_dc.sNp if the sweep qualifies for DC extension.
+ **********************************************************************************************************************/
+class SParameterCombiner
+{
+public:
+    enum class Interpolation { Linear, Spline, Rational };
+
+    struct Options
+    {
+        Interpolation           interpolation = Interpolation::Spline;
+        QVector<double>         targetFrequencies;          // Hz; empty keeps the merged frequencies
+        bool                    extendToDc = true;
+        int                     dcMinPoints = 21;           // as combine_extend_snp.py: more than 20 points
+        double                  dcMaxStart = 1e9;           // Hz; the sweep must start at or below
+        double                  duplicateTolerance = 1e-9;  // relative
+        int                     threads = 0;                // 0 = hardware concurrency
+    };
+
+    static bool                 readSweep(const QString &path, Touchstone::Network &out, QString &outError);
+    static bool                 merge(const QList<Touchstone::Network> &sweeps, double duplicateTolerance,
+                                      Touchstone::Network &out, QString &outError);
+    static bool                 resample(const Touchstone::Network &in, const QVector<double> &target,
+                                         Interpolation method, int threads, Touchstone::Network &out,
+                                         QString &outError);
+    static bool                 extendToDc(const Touchstone::Network &in, int threads, Touchstone::Network &out,
+                                           QString &outError);
+    static bool                 canExtendToDc(const Touchstone::Network &network, const Options &options);
+
+    static bool                 combine(const QStringList &paths, const Options &options, Touchstone::Network &out,
+                                        QString &outError);
+    static bool                 convert(const QString &resultPath, const Options &options, QStringList &outFiles,
+                                        QString &outError);
+    static bool                 writeNextToResults(Touchstone::Network network, const QString &dataDir,
+                                                   const QString &nameSuffix, QString &outPath, QString &outError);
+
+    static QVector<double>      linearGrid(double fStart, double fStop, int points);
+    static bool                 parseInterpolation(const QString &name, Interpolation &out);
+
+    static constexpr int        kRationalWindow = 8;
+    static constexpr int        kMaxDcPoints = 1000;
+};
+
+#endif // SPARAMETERCOMBINER_H
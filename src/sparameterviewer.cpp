@@ -0,0 +1,982 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QLabel>
+#include <QPainter>
+#include <QSplitter>
+#include <QComboBox>
+#include <QFileInfo>
+#include <QBoxLayout>
+#include <QListWidget>
+#include <QPushButton>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDirIterator>
+#include <QApplication>
+#include <QSignalBlocker>
+#include <QRegularExpression>
+
+#include <cmath>
+#include <limits>
+
+#include "sparameterviewer.h"
+#include "sparametercombiner.h"
+#include "tracer.h"
+#include "vectorfit.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+constexpr int    kMaxLegendEntries = 12;
+
+/*!*******************************************************************************************************************
+ * \brief Returns a 1/2/5 * 10^n tick step that splits \a span into roughly \a ticks intervals.
+ **********************************************************************************************************************/
+double niceStep(double span, int ticks)
+{
+    if (!(span > 0.0) || ticks < 1)
+        return 1.0;
+
+    const double raw = span / ticks;
+    const double magnitude = std::pow(10.0, std::floor(std::log10(raw)));
+    const double fraction = raw / magnitude;
+
+    if (fraction <= 1.0)
+        return magnitude;
+    if (fraction <= 2.0)
+        return 2.0 * magnitude;
+    if (fraction <= 5.0)
+        return 5.0 * magnitude;
+    return 10.0 * magnitude;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the name of a trace, "S21" for up to nine ports and "S12,3" style beyond.
+ **********************************************************************************************************************/
+QString traceName(QChar parameter, int row, int column, int ports)
+{
+    if (ports < 10)
+        return QString("%1%2%3").arg(parameter).arg(row + 1).arg(column + 1);
+    return QString("%1%2,%3").arg(parameter).arg(row + 1).arg(column + 1);
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Creates an empty plot in magnitude mode.
+ *
+ * \param parent Optional parent widget.
+ **********************************************************************************************************************/
+SParameterPlot::SParameterPlot(QWidget *parent)
+    : QWidget(parent)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAutoFillBackground(false);
+    setMinimumSize(240, 180);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Replaces the plotted network; cached series and paths are dropped.
+ **********************************************************************************************************************/
+void SParameterPlot::setNetwork(const Touchstone::Network &network)
+{
+    m_network = network;
+
+    m_frequencies.resize(network.frequencies.size());
+    for (int i = 0; i < network.frequencies.size(); ++i)
+        m_frequencies[i] = network.frequencies.at(i) / 1e9;
+
+    invalidateCache();
+    update();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Switches between magnitude, phase and Smith chart.
+ **********************************************************************************************************************/
+void SParameterPlot::setMode(Mode mode)
+{
+    if (mode == m_mode)
+        return;
+
+    m_mode = mode;
+    invalidateCache();
+    update();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the traces to draw; series and paths of traces that stay selected are reused.
+ **********************************************************************************************************************/
+void SParameterPlot::setTraces(const QVector<Trace> &traces)
+{
+    m_traces = traces;
+    update();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a size that leaves room for axes, labels and a legend.
+ **********************************************************************************************************************/
+QSize SParameterPlot::sizeHint() const
+{
+    return QSize(640, 400);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Builds the path of a cartesian trace with per-pixel min/max decimation.
+ *
+ * Points are mapped into \a area using the data \a range (x: left..right, y: top..top + height, y growing upwards).
+ * Consecutive points that fall into the same pixel column are reduced to the entry point, the minimum, the maximum
+ * and the exit point of that column, in the order they occur, so the path keeps every visible extreme while its
+ * size is bounded by four points per column. Non-finite values interrupt the path.
+ *
+ * \param x     Frequencies, ascending.
+ * \param y     Values, one per frequency.
+ * \param count Number of points.
+ * \param area  Target rectangle in widget coordinates.
+ * \param range Data range that maps onto \a area.
+ * \return The decimated path.
+ **********************************************************************************************************************/
+QPainterPath SParameterPlot::decimatedPath(const double *x, const double *y, int count,
+                                           const QRectF &area, const QRectF &range)
+{
+    QPainterPath path;
+    if (count <= 0 || range.width() <= 0.0 || range.height() <= 0.0)
+        return path;
+
+    const double sx = area.width() / range.width();
+    const double sy = area.height() / range.height();
+
+    struct Column
+    {
+        QPointF first, min, max, last;
+        int     minIndex = 0;
+        int     maxIndex = 0;
+        int     lastIndex = 0;
+    };
+
+    Column column;
+    qint64 columnKey = std::numeric_limits<qint64>::min();
+    bool open = false;          // a column is being collected
+    bool penDown = false;       // the path has a current point to continue from
+
+    auto flush = [&]() {
+        if (!open)
+            return;
+        // The entry point has already been added; add the extremes in order of appearance, then the exit point.
+        const bool minFirst = column.minIndex <= column.maxIndex;
+        const QPointF &a = minFirst ? column.min : column.max;
+        const QPointF &b = minFirst ? column.max : column.min;
+        const int ia = minFirst ? column.minIndex : column.maxIndex;
+        const int ib = minFirst ? column.maxIndex : column.minIndex;
+        if (ia != 0)
+            path.lineTo(a);
+        if (ib != 0 && ib != ia)
+            path.lineTo(b);
+        if (column.lastIndex != 0 && column.lastIndex != ia && column.lastIndex != ib)
+            path.lineTo(column.last);
+        open = false;
+    };
+
+    for (int i = 0; i < count; ++i) {
+        const double yv = y[i];
+        if (!std::isfinite(yv) || !std::isfinite(x[i])) {
+            flush();
+            penDown = false;
+            continue;
+        }
+
+        const QPointF p(area.left() + (x[i] - range.left()) * sx,
+                        area.bottom() - (yv - range.top()) * sy);
+        const qint64 key = qint64(std::floor(p.x()));
+
+        if (open && key == columnKey) {
+            const int rel = ++column.lastIndex;     // index within the column; 0 is the entry point
+            column.last = p;
+            if (p.y() < column.min.y()) { column.min = p; column.minIndex = rel; }
+            if (p.y() > column.max.y()) { column.max = p; column.maxIndex = rel; }
+            continue;
+        }
+
+        flush();
+
+        if (penDown)
+            path.lineTo(p);
+        else
+            path.moveTo(p);
+        penDown = true;
+
+        column = Column();
+        column.first = column.min = column.max = column.last = p;
+        columnKey = key;
+        open = true;
+    }
+    flush();
+
+    return path;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Builds the path of a trace on the Smith chart (reflection coefficient plane).
+ *
+ * Points that round to the same pixel as the previously added point are skipped; the last point is always kept.
+ *
+ * \param values First value of the trace.
+ * \param stride Distance between consecutive frequency points in \a values.
+ * \param count  Number of frequency points.
+ * \param area   Square that holds the unit circle.
+ * \return The decimated path.
+ **********************************************************************************************************************/
+QPainterPath SParameterPlot::smithPath(const Touchstone::Complex *values, int stride, int count, const QRectF &area)
+{
+    QPainterPath path;
+    if (count <= 0)
+        return path;
+
+    const QPointF center = area.center();
+    const double radius = qMin(area.width(), area.height()) / 2.0;
+
+    QPoint lastPixel;
+    QPointF pending;
+    bool hasPending = false;
+    bool penDown = false;
+
+    for (int i = 0; i < count; ++i) {
+        const Touchstone::Complex v = values[qint64(i) * stride];
+        if (!std::isfinite(v.real()) || !std::isfinite(v.imag())) {
+            if (hasPending)
+                path.lineTo(pending);
+            hasPending = false;
+            penDown = false;
+            continue;
+        }
+
+        const QPointF p(center.x() + v.real() * radius, center.y() - v.imag() * radius);
+        const QPoint pixel = p.toPoint();
+
+        if (!penDown) {
+            path.moveTo(p);
+            lastPixel = pixel;
+            penDown = true;
+            hasPending = false;
+            continue;
+        }
+
+        if (pixel == lastPixel) {
+            pending = p;
+            hasPending = true;
+            continue;
+        }
+
+        path.lineTo(p);
+        lastPixel = pixel;
+        hasPending = false;
+    }
+    if (hasPending)
+        path.lineTo(pending);
+
+    return path;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the pen colour of the \a index-th selected trace.
+ **********************************************************************************************************************/
+QColor SParameterPlot::traceColor(int index)
+{
+    static const QColor colors[] = {
+        QColor(0x1f, 0x77, 0xb4), QColor(0xd6, 0x27, 0x28), QColor(0x2c, 0xa0, 0x2c), QColor(0xff, 0x7f, 0x0e),
+        QColor(0x94, 0x67, 0xbd), QColor(0x8c, 0x56, 0x4b), QColor(0xe3, 0x77, 0xc2), QColor(0x17, 0xbe, 0xcf),
+        QColor(0xbc, 0xbd, 0x22), QColor(0x7f, 0x7f, 0x7f),
+    };
+    constexpr int n = int(sizeof(colors) / sizeof(colors[0]));
+
+    if (index < n)
+        return colors[index];
+    return QColor::fromHsv((index * 47) % 360, 200, 200);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the per-frequency values of \a trace for the current mode, computing them on first use.
+ **********************************************************************************************************************/
+const SParameterPlot::Series &SParameterPlot::series(const Trace &trace)
+{
+    const int key = trace.row * m_network.ports + trace.column;
+    auto it = m_series.find(key);
+    if (it != m_series.end())
+        return it.value();
+
+    Series s;
+    const int count = m_network.frequencyCount();
+    const int stride = m_network.ports * m_network.ports;
+    const Touchstone::Complex *v = m_network.values.constData() + key;
+
+    s.values.resize(count);
+    s.min = std::numeric_limits<double>::infinity();
+    s.max = -std::numeric_limits<double>::infinity();
+
+    for (int f = 0; f < count; ++f) {
+        const Touchstone::Complex c = v[qint64(f) * stride];
+        double value;
+        if (m_mode == Mode::Phase) {
+            value = std::arg(c) * 180.0 / kPi;
+        } else {
+            const double mag = std::abs(c);
+            value = mag > 0.0 ? 20.0 * std::log10(mag) : -300.0;
+        }
+        s.values[f] = value;
+        if (std::isfinite(value)) {
+            s.min = qMin(s.min, value);
+            s.max = qMax(s.max, value);
+        }
+    }
+
+    return m_series.insert(key, s).value();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the data range of the selected traces (x in GHz), padded by 5 % in y.
+ **********************************************************************************************************************/
+QRectF SParameterPlot::dataRange()
+{
+    double xMin = m_frequencies.isEmpty() ? 0.0 : m_frequencies.first();
+    double xMax = m_frequencies.isEmpty() ? 1.0 : m_frequencies.last();
+    if (!(xMax > xMin)) {
+        xMin -= 0.5;
+        xMax += 0.5;
+    }
+
+    double yMin = std::numeric_limits<double>::infinity();
+    double yMax = -std::numeric_limits<double>::infinity();
+    for (const Trace &trace : m_traces) {
+        const Series &s = series(trace);
+        yMin = qMin(yMin, s.min);
+        yMax = qMax(yMax, s.max);
+    }
+
+    if (m_mode == Mode::Phase) {
+        yMin = -180.0;
+        yMax = 180.0;
+    } else if (!std::isfinite(yMin) || !std::isfinite(yMax)) {
+        yMin = -40.0;
+        yMax = 0.0;
+    } else if (yMax - yMin < 1e-9) {
+        yMin -= 1.0;
+        yMax += 1.0;
+    } else {
+        const double pad = 0.05 * (yMax - yMin);
+        yMin -= pad;
+        yMax += pad;
+    }
+
+    return QRectF(xMin, yMin, xMax - xMin, yMax - yMin);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the plot rectangle inside the widget, leaving margins for tick labels.
+ **********************************************************************************************************************/
+QRectF SParameterPlot::plotArea() const
+{
+    const QFontMetrics fm = fontMetrics();
+    const QRectF inner = QRectF(rect()).adjusted(8, 8, -8, -8);
+
+    if (m_mode == Mode::Smith) {
+        const double side = qMin(inner.width(), inner.height());
+        return QRectF(inner.center().x() - side / 2.0, inner.center().y() - side / 2.0, side, side);
+    }
+
+    const double left = fm.horizontalAdvance(QStringLiteral("-000.0")) + 6;
+    const double bottom = fm.height() * 2 + 4;
+    return inner.adjusted(left, 0, 0, -bottom);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Drops all cached series and paths.
+ **********************************************************************************************************************/
+void SParameterPlot::invalidateCache()
+{
+    m_series.clear();
+    m_paths.clear();
+    m_pathArea = QRectF();
+    m_pathRange = QRectF();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Paints grid, traces and legend; trace paths are rebuilt only when area, range or data changed.
+ **********************************************************************************************************************/
+void SParameterPlot::paintEvent(QPaintEvent *)
+{
+    EMSTUDIO_TRACE_SCOPE("sparams.paint");
+
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+
+    if (!m_network.isValid()) {
+        painter.setPen(palette().color(QPalette::Disabled, QPalette::Text));
+        painter.drawText(rect(), Qt::AlignCenter, QStringLiteral("No S-parameter data"));
+        return;
+    }
+
+    const QRectF area = plotArea();
+    const QRectF range = m_mode == Mode::Smith ? QRectF(-1.0, -1.0, 2.0, 2.0) : dataRange();
+
+    if (area != m_pathArea || range != m_pathRange) {
+        m_paths.clear();
+        m_pathArea = area;
+        m_pathRange = range;
+    }
+
+    if (m_mode == Mode::Smith)
+        drawSmithGrid(painter, area);
+    else
+        drawCartesianGrid(painter, area, range);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+    if (m_mode == Mode::Smith) {
+        QPainterPath clip;
+        clip.addEllipse(area.adjusted(-1, -1, 1, 1));
+        painter.setClipPath(clip);
+    } else {
+        painter.setClipRect(area.adjusted(-1, -1, 1, 1));
+    }
+
+    const int count = m_network.frequencyCount();
+    const int stride = m_network.ports * m_network.ports;
+
+    for (int i = 0; i < m_traces.size(); ++i) {
+        const Trace &trace = m_traces.at(i);
+        const int key = trace.row * m_network.ports + trace.column;
+
+        auto it = m_paths.find(key);
+        if (it == m_paths.end()) {
+            QPainterPath path;
+            if (m_mode == Mode::Smith) {
+                path = smithPath(m_network.values.constData() + key, stride, count, area);
+            } else {
+                const Series &s = series(trace);
+                path = decimatedPath(m_frequencies.constData(), s.values.constData(), count, area, range);
+            }
+            it = m_paths.insert(key, path);
+        }
+
+        painter.setPen(QPen(traceColor(i), 1.4));
+        painter.drawPath(it.value());
+    }
+    painter.restore();
+
+    drawLegend(painter, area);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Draws frame, grid lines and tick labels of the magnitude and phase plots.
+ **********************************************************************************************************************/
+void SParameterPlot::drawCartesianGrid(QPainter &painter, const QRectF &area, const QRectF &range) const
+{
+    const QFontMetrics fm = fontMetrics();
+    const QColor gridColor = palette().color(QPalette::Mid);
+    const QColor textColor = palette().color(QPalette::Text);
+
+    const double xStep = niceStep(range.width(), qMax(2, int(area.width() / 90)));
+    const double yStep = m_mode == Mode::Phase ? 45.0 : niceStep(range.height(), qMax(2, int(area.height() / 40)));
+
+    for (double x = std::ceil(range.left() / xStep) * xStep; x <= range.right() + 1e-9 * xStep; x += xStep) {
+        const double px = area.left() + (x - range.left()) / range.width() * area.width();
+        painter.setPen(QPen(gridColor, 0, Qt::DotLine));
+        painter.drawLine(QPointF(px, area.top()), QPointF(px, area.bottom()));
+        painter.setPen(textColor);
+        const QString label = QString::number(std::abs(x) < 1e-12 * xStep ? 0.0 : x, 'g', 6);
+        painter.drawText(QRectF(px - 40, area.bottom() + 2, 80, fm.height()), Qt::AlignHCenter | Qt::AlignTop, label);
+    }
+
+    for (double y = std::ceil(range.top() / yStep) * yStep; y <= range.bottom() + 1e-9 * yStep; y += yStep) {
+        const double py = area.bottom() - (y - range.top()) / range.height() * area.height();
+        painter.setPen(QPen(gridColor, 0, Qt::DotLine));
+        painter.drawLine(QPointF(area.left(), py), QPointF(area.right(), py));
+        painter.setPen(textColor);
+        const QString label = QString::number(std::abs(y) < 1e-12 * yStep ? 0.0 : y, 'g', 5);
+        painter.drawText(QRectF(0, py - fm.height() / 2.0, area.left() - 4, fm.height()),
+                         Qt::AlignRight | Qt::AlignVCenter, label);
+    }
+
+    painter.setPen(textColor);
+    painter.drawRect(area);
+    painter.drawText(QRectF(area.left(), area.bottom() + fm.height() + 2, area.width(), fm.height()),
+                     Qt::AlignHCenter | Qt::AlignTop,
+                     m_mode == Mode::Phase ? QStringLiteral("Frequency (GHz) — phase (deg)")
+                                           : QStringLiteral("Frequency (GHz) — magnitude (dB)"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Draws the unit circle with constant-resistance circles and constant-reactance arcs.
+ **********************************************************************************************************************/
+void SParameterPlot::drawSmithGrid(QPainter &painter, const QRectF &area) const
+{
+    const QPointF c = area.center();
+    const double radius = area.width() / 2.0;
+    const QColor gridColor = palette().color(QPalette::Mid);
+
+    painter.save();
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    QPainterPath unit;
+    unit.addEllipse(c, radius, radius);
+
+    painter.setPen(QPen(gridColor, 0));
+    painter.drawLine(QPointF(area.left(), c.y()), QPointF(area.right(), c.y()));
+
+    painter.setClipPath(unit);
+    static const double steps[] = { 0.2, 0.5, 1.0, 2.0, 5.0 };
+    for (double r : steps) {
+        // Constant resistance r: centre (r / (1 + r), 0), radius 1 / (1 + r).
+        const double rc = radius / (1.0 + r);
+        painter.drawEllipse(QPointF(c.x() + radius * r / (1.0 + r), c.y()), rc, rc);
+    }
+    for (double x : steps) {
+        // Constant reactance +-x: centre (1, +-1 / x), radius 1 / x.
+        const double rx = radius / x;
+        painter.drawEllipse(QPointF(c.x() + radius, c.y() - rx), rx, rx);
+        painter.drawEllipse(QPointF(c.x() + radius, c.y() + rx), rx, rx);
+    }
+    painter.setClipping(false);
+
+    painter.setPen(QPen(palette().color(QPalette::Text), 0));
+    painter.drawPath(unit);
+    painter.restore();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Draws the names of the first selected traces in their colours in the top right corner of \a area.
+ **********************************************************************************************************************/
+void SParameterPlot::drawLegend(QPainter &painter, const QRectF &area) const
+{
+    if (m_traces.isEmpty())
+        return;
+
+    const QFontMetrics fm = fontMetrics();
+    const int shown = qMin(m_traces.size(), kMaxLegendEntries);
+    const double lineHeight = fm.height();
+    const double width = fm.horizontalAdvance(QStringLiteral("+000 more")) + 24;
+    const double height = lineHeight * (shown + (m_traces.size() > shown ? 1 : 0)) + 6;
+
+    const QRectF box(area.right() - width - 4, area.top() + 4, width, height);
+    QColor background = palette().color(QPalette::Base);
+    background.setAlpha(220);
+    painter.fillRect(box, background);
+
+    for (int i = 0; i < shown; ++i) {
+        const Trace &t = m_traces.at(i);
+        const double y = box.top() + 3 + i * lineHeight;
+        painter.setPen(QPen(traceColor(i), 2));
+        painter.drawLine(QPointF(box.left() + 4, y + lineHeight / 2), QPointF(box.left() + 16, y + lineHeight / 2));
+        painter.setPen(palette().color(QPalette::Text));
+        painter.drawText(QRectF(box.left() + 20, y, width - 20, lineHeight), Qt::AlignLeft | Qt::AlignVCenter,
+                         traceName(m_network.parameter, t.row, t.column, m_network.ports));
+    }
+    if (m_traces.size() > shown) {
+        painter.drawText(QRectF(box.left() + 20, box.top() + 3 + shown * lineHeight, width - 20, lineHeight),
+                         Qt::AlignLeft | Qt::AlignVCenter, QString("+%1 more").arg(m_traces.size() - shown));
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates the viewer with its mode selector, trace list and plot.
+ *
+ * \param parent Optional parent widget.
+ **********************************************************************************************************************/
+SParameterViewer::SParameterViewer(QWidget *parent)
+    : QWidget(parent)
+{
+    m_mode = new QComboBox(this);
+    m_mode->addItem(tr("|Sij| (dB)"), int(SParameterPlot::Mode::Magnitude));
+    m_mode->addItem(tr("Phase (deg)"), int(SParameterPlot::Mode::Phase));
+    m_mode->addItem(tr("Smith chart"), int(SParameterPlot::Mode::Smith));
+
+    QPushButton *btnOpen = new QPushButton(tr("Open..."), this);
+    btnOpen->setToolTip(tr("Load a Touchstone file or Palace port-S.csv"));
+
+    QPushButton *btnCombine = new QPushButton(tr("Combine..."), this);
+    btnCombine->setToolTip(tr("Merge several sweeps of one model, extend them to DC and save the result"));
+
+    m_btnExport = new QPushButton(tr("Export..."), this);
+    m_btnExport->setToolTip(tr("Save the shown S-parameters as Touchstone file, also while the solver runs"));
+
+    m_btnFit = new QPushButton(tr("Fit model..."), this);
+    m_btnFit->setToolTip(tr("Fit a passive rational model to the shown S-parameters and save it as SPICE subcircuit"));
+
+    m_status = new QLabel(this);
+    m_status->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    QHBoxLayout *top = new QHBoxLayout;
+    top->addWidget(m_mode);
+    top->addWidget(btnOpen);
+    top->addWidget(btnCombine);
+    top->addWidget(m_btnExport);
+    top->addWidget(m_btnFit);
+    top->addWidget(m_status, 1);
+
+    m_traceList = new QListWidget(this);
+    m_traceList->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_traceList->setUniformItemSizes(true);
+
+    m_plot = new SParameterPlot(this);
+
+    QSplitter *splitter = new QSplitter(Qt::Horizontal, this);
+    splitter->addWidget(m_traceList);
+    splitter->addWidget(m_plot);
+    splitter->setStretchFactor(1, 1);
+    splitter->setSizes({ 90, 600 });
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->setContentsMargins(0, 0, 0, 0);
+    layout->addLayout(top);
+    layout->addWidget(splitter, 1);
+
+    connect(m_mode, QOverload<int>::of(&QComboBox::currentIndexChanged), this, [this]() {
+        m_plot->setMode(SParameterPlot::Mode(m_mode->currentData().toInt()));
+    });
+    connect(m_traceList, &QListWidget::itemSelectionChanged, this, &SParameterViewer::applySelection);
+    connect(btnOpen, &QPushButton::clicked, this, &SParameterViewer::openFile);
+    connect(btnCombine, &QPushButton::clicked, this, &SParameterViewer::combineFiles);
+    connect(m_btnExport, &QPushButton::clicked, this, &SParameterViewer::exportFile);
+    connect(m_btnFit, &QPushButton::clicked, this, &SParameterViewer::fitModel);
+
+    m_timer.setInterval(kRefreshIntervalMs);
+    connect(&m_timer, &QTimer::timeout, this, &SParameterViewer::refresh);
+
+    clear();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the run directory to search for results and loads the newest result file found there.
+ **********************************************************************************************************************/
+void SParameterViewer::setRunDirectory(const QString &dir)
+{
+    if (dir == m_runDir && !m_sourcePath.isEmpty())
+        return;
+
+    m_runDir = dir;
+    m_sourcePath.clear();
+    m_sourceSize = -1;
+    m_sourceModified = QDateTime();
+    refresh();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starts or stops polling the result file; stopping reloads it one last time.
+ **********************************************************************************************************************/
+void SParameterViewer::setLive(bool live)
+{
+    m_live = live;
+    if (live) {
+        m_timer.start();
+    } else {
+        m_timer.stop();
+        refresh();
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Forgets run directory, source file and data.
+ **********************************************************************************************************************/
+void SParameterViewer::clear()
+{
+    m_runDir.clear();
+    m_sourcePath.clear();
+    m_sourceSize = -1;
+    m_sourceModified = QDateTime();
+    m_network = Touchstone::Network();
+    m_palace.setPath(QString());
+
+    m_plot->setNetwork(m_network);
+    m_btnExport->setEnabled(false);
+    m_btnFit->setEnabled(false);
+    rebuildTraceList(false);
+    m_status->setText(tr("No results loaded"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Loads a Touchstone file or Palace port-S.csv and shows it.
+ *
+ * Touchstone files are re-read completely; a port-S.csv that was loaded before is only read from where the
+ * previous load stopped.
+ *
+ * If the port count is unchanged (e.g. the same file reloaded while the solver appends to it), the trace selection
+ * is kept.
+ *
+ * \param path     File to load.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise (the previous data stays visible).
+ **********************************************************************************************************************/
+bool SParameterViewer::loadFile(const QString &path, QString &outError)
+{
+    EMSTUDIO_TRACE_SCOPE("sparams.load");
+
+    const QFileInfo fi(path);
+    Touchstone::Network network;
+
+    if (fi.suffix().compare(QLatin1String("csv"), Qt::CaseInsensitive) == 0) {
+        // Palace tables are tailed: only rows appended since the previous load are parsed.
+        if (m_palace.path() != path)
+            m_palace.setPath(path);
+        outError.clear();
+        m_palace.poll(outError);
+        if (!outError.isEmpty())
+            return false;
+        network = m_palace.network();
+    } else if (!Touchstone::read(path, network, outError)) {
+        return false;
+    }
+
+    if (!network.isValid()) {
+        outError = QString("%1 contains no frequency points").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    const bool samePorts = network.ports == m_network.ports && path == m_sourcePath;
+
+    m_sourcePath = path;
+    m_sourceSize = fi.size();
+    m_sourceModified = fi.lastModified();
+    m_network = network;
+
+    m_plot->setNetwork(m_network);
+    m_btnExport->setEnabled(true);
+    m_btnFit->setEnabled(true);
+    rebuildTraceList(samePorts);
+
+    m_status->setText(tr("%1 — %2 ports, %3 points, %4 … %5 GHz%6")
+                          .arg(fi.fileName())
+                          .arg(m_network.ports)
+                          .arg(m_network.frequencyCount())
+                          .arg(m_network.frequencies.first() / 1e9, 0, 'g', 6)
+                          .arg(m_network.frequencies.last() / 1e9, 0, 'g', 6)
+                          .arg(m_live ? tr(" (live)") : QString()));
+    m_status->setToolTip(QDir::toNativeSeparators(path));
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the most recently modified *.sNp or port-S.csv file below \a dir, or an empty string.
+ **********************************************************************************************************************/
+QString SParameterViewer::findResultFile(const QString &dir)
+{
+    if (dir.isEmpty() || !QFileInfo(dir).isDir())
+        return QString();
+
+    static const QRegularExpression snp(QStringLiteral("\\.s\\d+p$"), QRegularExpression::CaseInsensitiveOption);
+
+    QString best;
+    QDateTime bestTime;
+
+    QDirIterator it(dir, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        it.next();
+        const QFileInfo fi = it.fileInfo();
+        if (fi.fileName() != QLatin1String("port-S.csv") && !snp.match(fi.fileName()).hasMatch())
+            continue;
+        if (best.isEmpty() || fi.lastModified() > bestTime) {
+            best = fi.absoluteFilePath();
+            bestTime = fi.lastModified();
+        }
+    }
+    return best;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reloads the result file if it changed since the last load; locates one first if none is known yet.
+ **********************************************************************************************************************/
+void SParameterViewer::refresh()
+{
+    QString path = m_sourcePath;
+    if (path.isEmpty() || !QFileInfo::exists(path))
+        path = findResultFile(m_runDir);
+    if (path.isEmpty())
+        return;
+
+    const QFileInfo fi(path);
+    if (path == m_sourcePath && fi.size() == m_sourceSize && fi.lastModified() == m_sourceModified)
+        return;
+
+    QString error;
+    if (!loadFile(path, error) && !m_live)
+        m_status->setText(error);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Fills the trace list for the current network.
+ *
+ * \param keepSelection Keep the list and its selection if the port count did not change.
+ **********************************************************************************************************************/
+void SParameterViewer::rebuildTraceList(bool keepSelection)
+{
+    const int ports = m_network.ports;
+    if (keepSelection && m_traceList->count() == ports * ports) {
+        applySelection();
+        return;
+    }
+
+    QSignalBlocker blocker(m_traceList);
+    m_traceList->clear();
+
+    for (int row = 0; row < ports; ++row) {
+        for (int column = 0; column < ports; ++column) {
+            QListWidgetItem *item = new QListWidgetItem(traceName(m_network.parameter, row, column, ports), m_traceList);
+            item->setData(Qt::UserRole, row * ports + column);
+            // Default: reflection and transmission for an excitation at port 1.
+            item->setSelected(column == 0 && row < 4);
+        }
+    }
+    blocker.unblock();
+
+    applySelection();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Passes the selected list entries to the plot in list order.
+ **********************************************************************************************************************/
+void SParameterViewer::applySelection()
+{
+    const int ports = qMax(1, m_network.ports);
+
+    QVector<SParameterPlot::Trace> traces;
+    for (int i = 0; i < m_traceList->count(); ++i) {
+        const QListWidgetItem *item = m_traceList->item(i);
+        if (!item->isSelected())
+            continue;
+        const int key = item->data(Qt::UserRole).toInt();
+        SParameterPlot::Trace t;
+        t.row = key / ports;
+        t.column = key % ports;
+        traces.append(t);
+    }
+    m_plot->setTraces(traces);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Lets the user pick a result file and shows it.
+ **********************************************************************************************************************/
+void SParameterViewer::openFile()
+{
+    const QString start = m_sourcePath.isEmpty() ? m_runDir : QFileInfo(m_sourcePath).absolutePath();
+    const QString path = QFileDialog::getOpenFileName(this, tr("Open S-Parameters"), start,
+                                                      tr("S-parameters (*.s*p *.csv);;All files (*)"));
+    if (path.isEmpty())
+        return;
+
+    QString error;
+    if (!loadFile(path, error))
+        m_status->setText(error);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Lets the user pick several sweeps, combines them with SParameterCombiner, saves and shows the result.
+ *
+ * The sweeps are merged on the union of their frequencies and extended to DC if they qualify; see
+ * SParameterCombiner::combine().
+ **********************************************************************************************************************/
+void SParameterViewer::combineFiles()
+{
+    const QString start = m_sourcePath.isEmpty() ? m_runDir : QFileInfo(m_sourcePath).absolutePath();
+    const QStringList paths = QFileDialog::getOpenFileNames(this, tr("Combine S-Parameter Sweeps"), start,
+                                                            tr("S-parameters (*.s*p *.csv *.names);;All files (*)"));
+    if (paths.isEmpty())
+        return;
+
+    Touchstone::Network network;
+    QString error;
+    if (!SParameterCombiner::combine(paths, SParameterCombiner::Options(), network, error)) {
+        QMessageBox::warning(this, tr("Combine S-Parameter Sweeps"), error);
+        return;
+    }
+
+    const QFileInfo first(paths.first());
+    const QString suggested = first.dir().filePath(first.completeBaseName() + QStringLiteral("_combined.") +
+                                                   Touchstone::fileSuffix(network.ports));
+    const QString path = QFileDialog::getSaveFileName(this, tr("Save Combined S-Parameters"), suggested,
+                                                      tr("Touchstone (*.s%1p)").arg(network.ports));
+    if (path.isEmpty())
+        return;
+
+    Touchstone::WriteOptions options;
+    if (!Touchstone::write(path, network, options, error) || !loadFile(path, error))
+        QMessageBox::warning(this, tr("Combine S-Parameter Sweeps"), error);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes the shown network as Touchstone file; while a run is live this is the state read so far.
+ **********************************************************************************************************************/
+void SParameterViewer::exportFile()
+{
+    if (!m_network.isValid())
+        return;
+
+    const QFileInfo source(m_sourcePath);
+    const QString suggested = source.dir().filePath(source.completeBaseName() + QLatin1Char('.') +
+                                                    Touchstone::fileSuffix(m_network.ports));
+    const QString path = QFileDialog::getSaveFileName(this, tr("Export S-Parameters"), suggested,
+                                                      tr("Touchstone (*.s%1p)").arg(m_network.ports));
+    if (path.isEmpty())
+        return;
+
+    Touchstone::WriteOptions options;
+    QString error;
+    if (!Touchstone::write(path, m_network, options, error))
+        QMessageBox::warning(this, tr("Export S-Parameters"), error);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Fits a passive rational model to the shown network with VectorFit and saves it as SPICE subcircuit.
+ *
+ * The poles and residues are written as JSON next to the netlist; the fit summary is shown when done.
+ **********************************************************************************************************************/
+void SParameterViewer::fitModel()
+{
+    if (!m_network.isValid())
+        return;
+
+    VectorFit::Model model;
+    QString error;
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    const bool ok = VectorFit::fit(m_network, VectorFit::Options(), model, error);
+    QApplication::restoreOverrideCursor();
+    if (!ok) {
+        QMessageBox::warning(this, tr("Fit Model"), error);
+        return;
+    }
+
+    const QFileInfo source(m_sourcePath);
+    const QString suggested = source.dir().filePath(source.completeBaseName() + QStringLiteral("_vf.cir"));
+    const QString path = QFileDialog::getSaveFileName(this, tr("Save Model"), suggested,
+                                                      tr("SPICE subcircuit (*.cir *.sp *.lib)"));
+    if (path.isEmpty())
+        return;
+
+    const QFileInfo target(path);
+    const QString jsonPath = target.dir().filePath(target.completeBaseName() + QStringLiteral(".json"));
+    if (!VectorFit::writeSpice(path, model, error) || !VectorFit::writeJson(jsonPath, model, error)) {
+        QMessageBox::warning(this, tr("Fit Model"), error);
+        return;
+    }
+
+    const QString text = model.summary().join(QLatin1Char('\n'));
+    if (model.passive)
+        QMessageBox::information(this, tr("Fit Model"), text);
+    else
+        QMessageBox::warning(this, tr("Fit Model"), text);
+}
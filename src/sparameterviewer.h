@@ -0,0 +1,165 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef SPARAMETERVIEWER_H
+#define SPARAMETERVIEWER_H
+
+#include <QHash>
+#include <QTimer>
+#include <QWidget>
+#include <QVector>
+#include <QDateTime>
+#include <QPainterPath>
+
+#include "touchstone.h"
+#include "palacesparameters.h"
+
+class QLabel;
+class QComboBox;
+class QListWidget;
+class QPushButton;
+
+/*!*******************************************************************************************************************
+ * \class SParameterPlot
+ * \brief Custom-painted chart of selected S-parameter traces as |Sij| in dB, phase in degrees or on a Smith chart.
+ *
+ * Traces are turned into one QPainterPath each and cached until the data, the plot mode or the plot area changes,
+ * so repaints only stroke ready-made paths. Cartesian traces are decimated to at most four points per pixel column
+ * (entry, minimum, maximum, exit value), Smith traces drop points that land on the pixel of their predecessor;
+ * the cost of a repaint therefore depends on the widget size, not on the number of frequency points.
+ **********************************************************************************************************************/
+class SParameterPlot : public QWidget
+{
+public:
+    enum class Mode { Magnitude, Phase, Smith };
+
+    struct Trace
+    {
+        int                     row = 0;
+        int                     column = 0;
+    };
+
+    explicit SParameterPlot(QWidget *parent = nullptr);
+
+    void                        setNetwork(const Touchstone::Network &network);
+    void                        setMode(Mode mode);
+    void                        setTraces(const QVector<Trace> &traces);
+
+    Mode                        mode() const { return m_mode; }
+
+    QSize                       sizeHint() const override;
+
+    static QPainterPath         decimatedPath(const double *x, const double *y, int count,
+                                              const QRectF &area, const QRectF &range);
+    static QPainterPath         smithPath(const Touchstone::Complex *values, int stride, int count,
+                                          const QRectF &area);
+    static QColor               traceColor(int index);
+
+protected:
+    void                        paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Series
+    {
+        QVector<double>         values;
+        double                  min = 0.0;
+        double                  max = 0.0;
+    };
+
+    const Series               &series(const Trace &trace);
+    QRectF                      dataRange();
+    QRectF                      plotArea() const;
+    void                        invalidateCache();
+
+    void                        drawCartesianGrid(QPainter &painter, const QRectF &area, const QRectF &range) const;
+    void                        drawSmithGrid(QPainter &painter, const QRectF &area) const;
+    void                        drawLegend(QPainter &painter, const QRectF &area) const;
+
+private:
+    Touchstone::Network         m_network;
+    QVector<double>             m_frequencies;  // GHz
+    Mode                        m_mode = Mode::Magnitude;
+    QVector<Trace>              m_traces;
+
+    QHash<int, Series>          m_series;       // key: row * ports + column, for m_mode
+    QHash<int, QPainterPath>    m_paths;        // key as above, for m_pathArea/m_pathRange
+    QRectF                      m_pathArea;
+    QRectF                      m_pathRange;
+};
+
+/*!*******************************************************************************************************************
+ * \class SParameterViewer
+ * \brief Results panel that shows the S-parameters of the current run.
+ *
+ * The viewer looks for the newest Touchstone file (*.sNp) or Palace port-S.csv below the run directory and plots
+ * the selected Sij traces with an SParameterPlot. While a run is live the source file is polled and reloaded when
+ * its size or time stamp changes, so frequency points appear as the solver appends them; Palace tables are tailed
+ * with a PalaceSParameters, so a reload only parses the appended rows. The shown data can be exported as
+ * Touchstone file at any time; several sweeps can be combined into one file with SParameterCombiner, and a passive
+ * SPICE model of the shown data can be fitted with VectorFit.
+ **********************************************************************************************************************/
+class SParameterViewer : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SParameterViewer(QWidget *parent = nullptr);
+
+    void                        setRunDirectory(const QString &dir);
+    void                        setLive(bool live);
+    void                        clear();
+
+    bool                        loadFile(const QString &path, QString &outError);
+
+    QString                     sourcePath() const { return m_sourcePath; }
+    const Touchstone::Network  &network() const { return m_network; }
+
+    static QString              findResultFile(const QString &dir);
+
+    static constexpr int        kRefreshIntervalMs = 1000;
+
+private:
+    void                        refresh();
+    void                        rebuildTraceList(bool keepSelection);
+    void                        applySelection();
+    void                        openFile();
+    void                        combineFiles();
+    void                        exportFile();
+    void                        fitModel();
+
+private:
+    QComboBox                   *m_mode = nullptr;
+    QLabel                      *m_status = nullptr;
+    QPushButton                 *m_btnExport = nullptr;
+    QPushButton                 *m_btnFit = nullptr;
+    QListWidget                 *m_traceList = nullptr;
+    SParameterPlot              *m_plot = nullptr;
+    QTimer                      m_timer;
+
+    QString                     m_runDir;
+    QString                     m_sourcePath;
+    qint64                      m_sourceSize = -1;
+    QDateTime                   m_sourceModified;
+    Touchstone::Network         m_network;
+    PalaceSParameters           m_palace;       // tail of the current port-S.csv source
+    bool                        m_live = false;
+};
+
+#endif // SPARAMETERVIEWER_H
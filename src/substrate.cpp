@@ -23,6 +23,8 @@
 #include <QXmlStreamReader>
 #include <QDebug>
 
+#include "tracer.h"
+
 /*!*******************************************************************************************************************
  * \brief Default constructor for the Substrate class.
  *
@@ -44,6 +46,7 @@ Substrate::Substrate()
  **********************************************************************************************************************/
 bool Substrate::parseXmlFile(const QString &filePath)
 {
+    EMSTUDIO_TRACE_SCOPE("substrate.parseXml", filePath);
     m_materials.clear();
     m_dielectrics.clear();
     m_layers.clear();
@@ -26,6 +26,7 @@
 #include <QGraphicsRectItem>
 
 #include "substrateview.h"
+#include "tracer.h"
 
 /*!*******************************************************************************************************************
  * \brief Constructor for SubstrateView.
@@ -304,6 +305,7 @@ int SubstrateView::getLayerPositionInDielectric(const QString& layerName,
  **********************************************************************************************************************/
 void SubstrateView::drawSubstrate()
 {
+    EMSTUDIO_TRACE_SCOPE("substrateView.drawSubstrate");
     m_scene->clear();
 
     const double dielWidth   = 300.0;
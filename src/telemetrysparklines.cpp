@@ -0,0 +1,163 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QPainter>
+#include <QPainterPath>
+
+#include "telemetrysparklines.h"
+
+/*!*******************************************************************************************************************
+ * \brief Creates an empty sparkline view.
+ *
+ * \param parent Optional parent widget.
+ **********************************************************************************************************************/
+TelemetrySparklines::TelemetrySparklines(QWidget *parent)
+    : QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+    setToolTip(tr("Process telemetry of the running simulation"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Appends a telemetry sample; the I/O rate is derived from the previous sample.
+ **********************************************************************************************************************/
+void TelemetrySparklines::addSample(const ProcessTelemetry::Sample &sample)
+{
+    double ioRate = 0.0;
+    if (m_hasLast && sample.elapsedMs > m_last.elapsedMs) {
+        const qint64 bytes = (sample.readBytes - m_last.readBytes) + (sample.writeBytes - m_last.writeBytes);
+        ioRate = double(qMax<qint64>(0, bytes)) / (1024.0 * 1024.0) /
+                 (double(sample.elapsedMs - m_last.elapsedMs) / 1000.0);
+    }
+
+    append(m_cpu, sample.cpuPercent);
+    append(m_rss, double(sample.rssBytes) / (1024.0 * 1024.0));
+    append(m_io, ioRate);
+
+    m_last = sample;
+    m_hasLast = true;
+
+    setToolTip(tr("Stage: %1\nProcesses: %2, threads: %3\nCPU: %4 %\nRSS: %5 MiB (peak %6 MiB)\n"
+                  "Read: %7 MiB, written: %8 MiB")
+                   .arg(sample.stage)
+                   .arg(sample.processes)
+                   .arg(sample.threads)
+                   .arg(sample.cpuPercent, 0, 'f', 0)
+                   .arg(double(sample.rssBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                   .arg(double(sample.peakRssBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                   .arg(double(sample.readBytes) / (1024.0 * 1024.0), 0, 'f', 1)
+                   .arg(double(sample.writeBytes) / (1024.0 * 1024.0), 0, 'f', 1));
+    update();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Drops all samples, e.g. when a new run starts.
+ **********************************************************************************************************************/
+void TelemetrySparklines::clear()
+{
+    m_cpu.clear();
+    m_rss.clear();
+    m_io.clear();
+    m_hasLast = false;
+    setToolTip(tr("Process telemetry of the running simulation"));
+    update();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns a size that fits three sparklines next to the progress bar.
+ **********************************************************************************************************************/
+QSize TelemetrySparklines::sizeHint() const
+{
+    return QSize(360, qMax(22, fontMetrics().height() + 6));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Appends a value and drops the oldest one beyond kMaxPoints.
+ **********************************************************************************************************************/
+void TelemetrySparklines::append(QVector<double> &series, double value)
+{
+    series.append(value);
+    if (series.size() > kMaxPoints)
+        series.remove(0, series.size() - kMaxPoints);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Paints the CPU, memory and I/O sparklines, each scaled to its own maximum.
+ **********************************************************************************************************************/
+void TelemetrySparklines::paintEvent(QPaintEvent *)
+{
+    if (m_cpu.isEmpty())
+        return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    struct Line
+    {
+        const QVector<double>  *series;
+        QString                 label;
+        QColor                  color;
+    };
+
+    const Line lines[] = {
+        { &m_cpu, QString("CPU %1 %").arg(m_cpu.last(), 0, 'f', 0),      QColor(0x2b, 0x7b, 0xd6) },
+        { &m_rss, QString("RSS %1 MiB").arg(m_rss.last(), 0, 'f', 0),    QColor(0x3a, 0xa0, 0x4a) },
+        { &m_io,  QString("I/O %1 MiB/s").arg(m_io.last(), 0, 'f', 1),   QColor(0xd6, 0x7a, 0x1e) },
+    };
+
+    const int cellWidth = width() / 3;
+    const int textWidth = fontMetrics().horizontalAdvance(QStringLiteral("I/O 0000.0 MiB/s"));
+
+    for (int i = 0; i < 3; ++i) {
+        const Line &line = lines[i];
+        const QRect cell(i * cellWidth, 0, cellWidth - 6, height());
+
+        painter.setPen(palette().color(QPalette::WindowText));
+        const QRect textRect(cell.left(), cell.top(), qMin(textWidth, cell.width() / 2), cell.height());
+        painter.drawText(textRect, Qt::AlignVCenter | Qt::AlignLeft, line.label);
+
+        const QRectF plot(textRect.right() + 4, cell.top() + 3,
+                          cell.right() - textRect.right() - 4, cell.height() - 6);
+        if (plot.width() <= 2 || line.series->size() < 2)
+            continue;
+
+        double maxValue = 0.0;
+        for (double v : *line.series)
+            maxValue = qMax(maxValue, v);
+        if (maxValue <= 0.0)
+            maxValue = 1.0;
+
+        const int n = line.series->size();
+        const double dx = plot.width() / double(kMaxPoints - 1);
+        const double x0 = plot.right() - dx * (n - 1);
+
+        QPainterPath path;
+        for (int k = 0; k < n; ++k) {
+            const QPointF p(x0 + dx * k, plot.bottom() - plot.height() * line.series->at(k) / maxValue);
+            if (k == 0)
+                path.moveTo(p);
+            else
+                path.lineTo(p);
+        }
+
+        painter.setPen(QPen(line.color, 1.2));
+        painter.drawPath(path);
+    }
+}
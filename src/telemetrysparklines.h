@@ -0,0 +1,65 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef TELEMETRYSPARKLINES_H
+#define TELEMETRYSPARKLINES_H
+
+#include <QWidget>
+#include <QVector>
+
+#include "processtelemetry.h"
+
+/*!*******************************************************************************************************************
+ * \class TelemetrySparklines
+ * \brief Compact live view of the process telemetry of the running simulation.
+ *
+ * Draws three sparklines side by side — CPU usage, resident memory and I/O throughput — over the most recent
+ * kMaxPoints samples of a ProcessTelemetry, each labelled with its current value. The tool tip shows the
+ * full figures of the last sample.
+ **********************************************************************************************************************/
+class TelemetrySparklines : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TelemetrySparklines(QWidget *parent = nullptr);
+
+    void                        addSample(const ProcessTelemetry::Sample &sample);
+    void                        clear();
+
+    QSize                       sizeHint() const override;
+
+    static constexpr int        kMaxPoints = 120;
+
+protected:
+    void                        paintEvent(QPaintEvent *event) override;
+
+private:
+    void                        append(QVector<double> &series, double value);
+
+private:
+    QVector<double>             m_cpu;          // percent of one core
+    QVector<double>             m_rss;          // MiB
+    QVector<double>             m_io;           // MiB/s, read + write
+    ProcessTelemetry::Sample    m_last;
+    bool                        m_hasLast = false;
+};
+
+#endif // TELEMETRYSPARKLINES_H
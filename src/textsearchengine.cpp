@@ -0,0 +1,393 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include "textsearchengine.h"
+
+#include <QElapsedTimer>
+#include <QTextDocument>
+
+/*!*******************************************************************************************************************
+ * \brief Constructs a search engine bound to \a doc.
+ *
+ * \param doc    Document to search.
+ * \param parent Parent object (optional).
+ **********************************************************************************************************************/
+TextSearchEngine::TextSearchEngine(QTextDocument *doc, QObject *parent)
+    : QObject(parent)
+    , m_doc(doc)
+{
+    m_sliceTimer.setSingleShot(true);
+    m_sliceTimer.setInterval(0);
+    connect(&m_sliceTimer, &QTimer::timeout, this, &TextSearchEngine::scanSlice);
+
+    if (m_doc)
+        connect(m_doc, &QTextDocument::contentsChange, this, &TextSearchEngine::onContentsChange);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sets the search query and starts (or incrementally continues) scanning.
+ *
+ * If the new query only extends the previous plain-text pattern with the same options, only
+ * blocks that matched the previous pattern are searched again. The first time slice
+ * runs synchronously, so small documents are fully searched when this function returns.
+ *
+ * \param pattern    Search string or regular expression.
+ * \param matchCase  Case-sensitive matching.
+ * \param wholeWords Match whole words only.
+ * \param useRegex   Interpret \a pattern as regular expression.
+ **********************************************************************************************************************/
+void TextSearchEngine::setPattern(const QString &pattern, bool matchCase, bool wholeWords, bool useRegex)
+{
+    if (pattern.isEmpty()) {
+        clear();
+        return;
+    }
+
+    if (hasQuery(pattern, matchCase, wholeWords, useRegex))
+        return;
+
+    const bool extends = !m_pattern.isEmpty() && !useRegex && !m_useRegex &&
+                         !wholeWords && !m_wholeWords && matchCase == m_matchCase &&
+                         pattern.startsWith(m_pattern, matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive);
+
+    m_pattern    = pattern;
+    m_matchCase  = matchCase;
+    m_wholeWords = wholeWords;
+    m_useRegex   = useRegex;
+
+    if (m_useRegex) {
+        const QString expr = m_wholeWords ? QStringLiteral("\\b%1\\b").arg(m_pattern) : m_pattern;
+        m_regex = QRegularExpression(expr, m_matchCase ? QRegularExpression::NoPatternOption
+                                                       : QRegularExpression::CaseInsensitiveOption);
+    }
+
+    if (extends)
+        refineExtendedPattern();
+    else
+        restartScan();
+
+    scanSlice();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Clears the query and all cached matches.
+ **********************************************************************************************************************/
+void TextSearchEngine::clear()
+{
+    m_sliceTimer.stop();
+    m_pattern.clear();
+    m_blockMatches.clear();
+    m_nextBlock  = 0;
+    m_matchCount = 0;
+    emit matchesUpdated();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if the whole document has been scanned for the current query.
+ **********************************************************************************************************************/
+bool TextSearchEngine::isFinished() const
+{
+    return isActive() && m_doc && m_nextBlock >= m_doc->blockCount();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if the engine currently holds exactly this query.
+ **********************************************************************************************************************/
+bool TextSearchEngine::hasQuery(const QString &pattern, bool matchCase, bool wholeWords, bool useRegex) const
+{
+    return isActive() && pattern == m_pattern && matchCase == m_matchCase &&
+           wholeWords == m_wholeWords && useRegex == m_useRegex;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Builds text cursors for all cached matches between \a first and \a last (inclusive).
+ *
+ * \param first First block of the range.
+ * \param last  Last block of the range.
+ * \return Cursors selecting the matches.
+ **********************************************************************************************************************/
+QVector<QTextCursor> TextSearchEngine::cursorsInRange(const QTextBlock &first, const QTextBlock &last) const
+{
+    QVector<QTextCursor> out;
+    if (!isActive() || !first.isValid())
+        return out;
+
+    const int lastNumber = qMin(last.isValid() ? last.blockNumber() : first.blockNumber(),
+                                m_nextBlock - 1);
+
+    for (QTextBlock b = first; b.isValid() && b.blockNumber() <= lastNumber; b = b.next()) {
+        const int n = b.blockNumber();
+        if (n >= m_blockMatches.size())
+            break;
+        for (const Match &m : m_blockMatches.at(n))
+            out.push_back(cursorFor(b, m));
+    }
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Finds the next or previous cached match relative to \a position.
+ *
+ * Mirrors QTextDocument::find(): searching forward returns the first match starting at or after
+ * \a position, searching backward the last match starting before it.
+ *
+ * \param position Document position to search from.
+ * \param forward  Search direction.
+ * \param wrap     Wrap around the document ends.
+ * \return Cursor selecting the match, or a null cursor if there is none.
+ **********************************************************************************************************************/
+QTextCursor TextSearchEngine::findFrom(int position, bool forward, bool wrap) const
+{
+    if (!isActive() || !m_doc || m_matchCount == 0)
+        return QTextCursor();
+
+    const QTextBlock startBlock = m_doc->findBlock(position);
+    if (!startBlock.isValid())
+        return QTextCursor();
+
+    if (forward) {
+        for (QTextBlock b = startBlock; b.isValid(); b = b.next()) {
+            const int n = b.blockNumber();
+            if (n >= m_blockMatches.size())
+                break;
+            for (const Match &m : m_blockMatches.at(n)) {
+                if (b.position() + m.start >= position)
+                    return cursorFor(b, m);
+            }
+        }
+        return wrap ? findFrom(0, true, false) : QTextCursor();
+    }
+
+    for (QTextBlock b = startBlock; b.isValid(); b = b.previous()) {
+        const int n = b.blockNumber();
+        if (n >= m_blockMatches.size())
+            continue;
+        const QVector<Match> &matches = m_blockMatches.at(n);
+        for (int i = matches.size() - 1; i >= 0; --i) {
+            if (b.position() + matches.at(i).start < position)
+                return cursorFor(b, matches.at(i));
+        }
+    }
+    return wrap ? findFrom(m_doc->characterCount(), false, false) : QTextCursor();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Scans blocks until the time budget of one slice is used up.
+ *
+ * Reschedules itself through the zero-interval timer while blocks remain and emits
+ * matchesUpdated() after each slice and finished() once the document is complete.
+ **********************************************************************************************************************/
+void TextSearchEngine::scanSlice()
+{
+    if (!isActive() || !m_doc)
+        return;
+
+    QElapsedTimer clock;
+    clock.start();
+
+    QTextBlock b = m_doc->findBlockByNumber(m_nextBlock);
+    while (b.isValid()) {
+        const int n = b.blockNumber();
+        if (n >= m_blockMatches.size())
+            m_blockMatches.resize(n + 1);
+
+        m_matchCount -= m_blockMatches.at(n).size();
+        m_blockMatches[n] = scanText(b.text());
+        m_matchCount += m_blockMatches.at(n).size();
+
+        m_nextBlock = n + 1;
+        b = b.next();
+
+        if (clock.elapsed() >= kSliceBudgetMs)
+            break;
+    }
+
+    emit matchesUpdated();
+
+    if (b.isValid())
+        m_sliceTimer.start();
+    else
+        emit finished(m_matchCount);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Keeps the match cache in sync with document edits.
+ *
+ * Only blocks touched by the change are rescanned; entries behind the change are shifted by
+ * the change of the block count. Changes in the part that is not scanned yet only adjust the
+ * cache size.
+ *
+ * \param position     Position of the change.
+ * \param charsRemoved Number of removed characters.
+ * \param charsAdded   Number of added characters.
+ **********************************************************************************************************************/
+void TextSearchEngine::onContentsChange(int position, int charsRemoved, int charsAdded)
+{
+    Q_UNUSED(charsRemoved);
+
+    if (!isActive())
+        return;
+
+    const QTextBlock firstBlock = m_doc->findBlock(position);
+    QTextBlock lastBlock = m_doc->findBlock(position + charsAdded);
+    if (!lastBlock.isValid())
+        lastBlock = m_doc->lastBlock();
+
+    const int delta   = m_doc->blockCount() - m_blockMatches.size();
+    const int first   = firstBlock.isValid() ? firstBlock.blockNumber() : -1;
+    const int lastNew = lastBlock.blockNumber();
+    const int lastOld = lastNew - delta;
+
+    if (first < 0 || lastOld < first - 1 || lastOld >= m_blockMatches.size()) {
+        restartScan();
+        scanSlice();
+        return;
+    }
+
+    for (int i = first; i <= lastOld; ++i)
+        m_matchCount -= m_blockMatches.at(i).size();
+    m_blockMatches.remove(first, lastOld - first + 1);
+
+    const bool rescan = first < m_nextBlock;
+
+    QVector<QVector<Match>> fresh;
+    fresh.reserve(lastNew - first + 1);
+    for (QTextBlock b = firstBlock; b.isValid() && b.blockNumber() <= lastNew; b = b.next()) {
+        fresh.push_back(rescan ? scanText(b.text()) : QVector<Match>());
+        m_matchCount += fresh.last().size();
+    }
+
+    QVector<QVector<Match>> merged;
+    merged.reserve(m_blockMatches.size() + fresh.size());
+    merged += m_blockMatches.mid(0, first);
+    merged += fresh;
+    merged += m_blockMatches.mid(first);
+    m_blockMatches.swap(merged);
+
+    if (lastOld < m_nextBlock)
+        m_nextBlock += delta;
+    else if (rescan)
+        m_nextBlock = lastNew + 1;
+
+    emit matchesUpdated();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Drops all cached matches and restarts scanning from the first block.
+ **********************************************************************************************************************/
+void TextSearchEngine::restartScan()
+{
+    m_sliceTimer.stop();
+    m_blockMatches.clear();
+    m_blockMatches.resize(m_doc ? m_doc->blockCount() : 0);
+    m_nextBlock  = 0;
+    m_matchCount = 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Updates cached matches after the plain-text pattern was extended.
+ *
+ * A block can only contain the extended pattern if it contains the previous one, so only blocks
+ * with cached matches are rescanned. The cached offsets themselves cannot simply be filtered:
+ * they are non-overlapping, and for a self-overlapping pattern ("aa" in "aaab") the match of the
+ * extended pattern ("aab" at 1) may start at an occurrence that was skipped. Blocks not scanned
+ * yet are handled by scanSlice().
+ **********************************************************************************************************************/
+void TextSearchEngine::refineExtendedPattern()
+{
+    m_matchCount = 0;
+
+    for (int n = 0; n < m_blockMatches.size() && n < m_nextBlock; ++n) {
+        QVector<Match> &matches = m_blockMatches[n];
+        if (matches.isEmpty())
+            continue;
+
+        matches = scanText(m_doc->findBlockByNumber(n).text());
+        m_matchCount += matches.size();
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Finds all non-overlapping matches of the current query in one block of text.
+ *
+ * \param text Block text.
+ * \return Matches in ascending order.
+ **********************************************************************************************************************/
+QVector<TextSearchEngine::Match> TextSearchEngine::scanText(const QString &text) const
+{
+    QVector<Match> out;
+
+    if (m_useRegex) {
+        if (!m_regex.isValid())
+            return out;
+
+        QRegularExpressionMatchIterator it = m_regex.globalMatch(text);
+        while (it.hasNext()) {
+            const QRegularExpressionMatch m = it.next();
+            if (m.capturedLength() > 0)
+                out.push_back({ m.capturedStart(), m.capturedLength() });
+        }
+        return out;
+    }
+
+    const Qt::CaseSensitivity cs = m_matchCase ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    const int len = m_pattern.size();
+
+    int from = 0;
+    while (true) {
+        const int idx = text.indexOf(m_pattern, from, cs);
+        if (idx < 0)
+            break;
+
+        if (!m_wholeWords || isWholeWord(text, idx, len)) {
+            out.push_back({ idx, len });
+            from = idx + len;
+        } else {
+            from = idx + 1;
+        }
+    }
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if the text range is not adjacent to other word characters.
+ **********************************************************************************************************************/
+bool TextSearchEngine::isWholeWord(const QString &text, int start, int length) const
+{
+    auto isWordChar = [](QChar c) { return c.isLetterOrNumber() || c == QLatin1Char('_'); };
+
+    if (start > 0 && isWordChar(text.at(start - 1)))
+        return false;
+    const int end = start + length;
+    if (end < text.size() && isWordChar(text.at(end)))
+        return false;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Creates a cursor selecting match \a m inside \a block.
+ **********************************************************************************************************************/
+QTextCursor TextSearchEngine::cursorFor(const QTextBlock &block, const Match &m) const
+{
+    QTextCursor c(m_doc);
+    c.setPosition(block.position() + m.start);
+    c.setPosition(block.position() + m.start + m.length, QTextCursor::KeepAnchor);
+    return c;
+}
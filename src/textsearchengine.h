@@ -0,0 +1,103 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef TEXTSEARCHENGINE_H
+#define TEXTSEARCHENGINE_H
+
+#include <QTimer>
+#include <QObject>
+#include <QVector>
+#include <QTextBlock>
+#include <QTextCursor>
+#include <QRegularExpression>
+
+class QTextDocument;
+
+/*!*******************************************************************************************************************
+ * \class TextSearchEngine
+ * \brief Incremental find-all engine for a QTextDocument.
+ *
+ * Scans the document block by block in short time slices driven by a zero-interval timer, so
+ * the GUI stays responsive while a large script is searched. Match offsets are cached per block
+ * and kept up to date from QTextDocument::contentsChange by rescanning only the touched blocks.
+ * When a plain-text pattern is extended (e.g. while typing), only blocks that matched the
+ * shorter pattern are re-checked.
+ *
+ * Callers materialize text cursors only for the blocks they need (usually the visible ones)
+ * via cursorsInRange().
+ **********************************************************************************************************************/
+class TextSearchEngine : public QObject
+{
+    Q_OBJECT
+
+    struct Match
+    {
+        int start  = 0;      // relative to block position
+        int length = 0;
+    };
+
+public:
+    explicit TextSearchEngine(QTextDocument *doc, QObject *parent = nullptr);
+
+    void                        setPattern(const QString &pattern, bool matchCase, bool wholeWords, bool useRegex);
+    void                        clear();
+
+    bool                        isActive() const { return !m_pattern.isEmpty(); }
+    bool                        isFinished() const;
+    bool                        hasQuery(const QString &pattern, bool matchCase, bool wholeWords, bool useRegex) const;
+    int                         matchCount() const { return m_matchCount; }
+
+    QVector<QTextCursor>        cursorsInRange(const QTextBlock &first, const QTextBlock &last) const;
+    QTextCursor                 findFrom(int position, bool forward, bool wrap) const;
+
+signals:
+    void                        matchesUpdated();
+    void                        finished(int matchCount);
+
+private slots:
+    void                        scanSlice();
+    void                        onContentsChange(int position, int charsRemoved, int charsAdded);
+
+private:
+    void                        restartScan();
+    void                        refineExtendedPattern();
+    QVector<Match>              scanText(const QString &text) const;
+    bool                        isWholeWord(const QString &text, int start, int length) const;
+    QTextCursor                 cursorFor(const QTextBlock &block, const Match &m) const;
+
+private:
+    QTextDocument               *m_doc = nullptr;
+
+    QString                     m_pattern;
+    bool                        m_matchCase = false;
+    bool                        m_wholeWords = false;
+    bool                        m_useRegex = false;
+    QRegularExpression          m_regex;
+
+    QVector<QVector<Match>>     m_blockMatches;
+    int                         m_nextBlock = 0;
+    int                         m_matchCount = 0;
+
+    QTimer                      m_sliceTimer;
+
+    static constexpr int        kSliceBudgetMs = 8;
+};
+
+#endif // TEXTSEARCHENGINE_H
@@ -0,0 +1,632 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QRegularExpression>
+
+#include <cmath>
+#include <cstring>
+#include <utility>
+
+#include "touchstone.h"
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846;
+
+/// Exactly representable powers of ten for the fast number path.
+constexpr double kPow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+enum class MatrixFormat { Full, Lower, Upper };
+
+inline bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\f' || c == '\v';
+}
+
+inline bool isDigit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the multiplier from \a unit to Hz, or 0 for an unknown unit.
+ **********************************************************************************************************************/
+double unitMultiplier(const QString &unit)
+{
+    const QString u = unit.trimmed().toUpper();
+    if (u == QLatin1String("HZ"))  return 1.0;
+    if (u == QLatin1String("KHZ")) return 1e3;
+    if (u == QLatin1String("MHZ")) return 1e6;
+    if (u == QLatin1String("GHZ")) return 1e9;
+    if (u == QLatin1String("THZ")) return 1e12;
+    return 0.0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Converts a data pair in \a format to a complex value.
+ **********************************************************************************************************************/
+inline Touchstone::Complex toComplex(double a, double b, Touchstone::Format format)
+{
+    switch (format) {
+    case Touchstone::Format::RI:
+        return Touchstone::Complex(a, b);
+    case Touchstone::Format::MA:
+        return a * Touchstone::Complex(std::cos(b * kPi / 180.0), std::sin(b * kPi / 180.0));
+    case Touchstone::Format::DB:
+        return std::pow(10.0, a / 20.0) * Touchstone::Complex(std::cos(b * kPi / 180.0), std::sin(b * kPi / 180.0));
+    }
+    return Touchstone::Complex();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the text of a keyword line ("[Number of Ports] 4") split into lower-case keyword and argument.
+ **********************************************************************************************************************/
+bool splitKeyword(const QByteArray &line, QByteArray &keyword, QByteArray &argument)
+{
+    const int close = line.indexOf(']');
+    if (close < 0)
+        return false;
+
+    keyword = line.mid(1, close - 1).simplified().toLower();
+    argument = line.mid(close + 1).trimmed();
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Appends a number with the given precision (locale-independent).
+ **********************************************************************************************************************/
+inline void appendNumber(QByteArray &out, double value, int precision)
+{
+    out += QByteArray::number(value, 'g', precision);
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if the network has ports, frequencies and a complete value array.
+ **********************************************************************************************************************/
+bool Touchstone::Network::isValid() const
+{
+    return ports > 0 && !frequencies.isEmpty() && values.size() == frequencies.size() * ports * ports;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sizes the network for \a portCount ports and \a frequencyCount points; references default to 50 ohms.
+ **********************************************************************************************************************/
+void Touchstone::Network::resize(int portCount, int frequencyCount)
+{
+    ports = portCount;
+    frequencies.resize(frequencyCount);
+    values.resize(frequencyCount * portCount * portCount);
+    if (references.size() != portCount)
+        references.fill(50.0, portCount);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses one number at \a pos, skipping leading blanks; advances \a pos past it on success.
+ *
+ * Decimal numbers with up to 15 significant digits and a decimal exponent within +-22 are converted exactly with
+ * one multiplication or division; anything else falls back to Qt's (locale-independent) conversion. A number may
+ * end at a blank, a line break, a '!' comment or a ',' (the separator of CSV tables such as Palace's port-S.csv).
+ *
+ * \return False at the end of the range or if the next token is not a number (\a pos then points to it).
+ **********************************************************************************************************************/
+bool Touchstone::parseNumber(const char *&pos, const char *end, double &out)
+{
+    const char *p = pos;
+    while (p < end && isSpace(*p))
+        ++p;
+    pos = p;
+    if (p == end)
+        return false;
+
+    const char *start = p;
+    bool negative = false;
+    if (*p == '+' || *p == '-') {
+        negative = (*p == '-');
+        ++p;
+    }
+
+    quint64 mantissa = 0;
+    int significant = 0;
+    int exponent = 0;
+    bool anyDigit = false;
+    bool exact = true;
+
+    for (; p < end && isDigit(*p); ++p) {
+        anyDigit = true;
+        if (significant < 19) {
+            mantissa = mantissa * 10 + quint64(*p - '0');
+            if (mantissa)
+                ++significant;
+        } else {
+            ++exponent;
+            exact = false;
+        }
+    }
+
+    if (p < end && *p == '.') {
+        ++p;
+        for (; p < end && isDigit(*p); ++p) {
+            anyDigit = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + quint64(*p - '0');
+                if (mantissa)
+                    ++significant;
+                --exponent;
+            } else {
+                exact = false;
+            }
+        }
+    }
+
+    if (!anyDigit)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        const char *q = p + 1;
+        bool expNegative = false;
+        if (q < end && (*q == '+' || *q == '-')) {
+            expNegative = (*q == '-');
+            ++q;
+        }
+        if (q == end || !isDigit(*q))
+            return false;
+
+        int e = 0;
+        for (; q < end && isDigit(*q); ++q)
+            e = qMin(e * 10 + (*q - '0'), 100000);
+        exponent += expNegative ? -e : e;
+        p = q;
+    }
+
+    if (p < end && !isSpace(*p) && *p != '\n' && *p != '!' && *p != ',')
+        return false;
+
+    if (exact && significant <= 15 && exponent >= -22 && exponent <= 22) {
+        double value = double(mantissa);
+        value = exponent < 0 ? value / kPow10[-exponent] : value * kPow10[exponent];
+        out = negative ? -value : value;
+    } else {
+        bool ok = false;
+        out = QByteArray::fromRawData(start, int(p - start)).toDouble(&ok);
+        if (!ok)
+            return false;
+    }
+
+    pos = p;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Parses Touchstone text.
+ *
+ * \param begin    Start of the file contents.
+ * \param end      End of the file contents.
+ * \param ports    Port count for v1 files (from the file name); v2 files declare their own.
+ * \param out      Parsed network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool Touchstone::parse(const char *begin, const char *end, int ports, Network &out, QString &outError)
+{
+    out = Network();
+
+    int version = 1;
+    double multiplier = 1e9;
+    Format format = Format::MA;
+    QChar parameter = QLatin1Char('S');
+    double optionReference = 50.0;
+    bool optionSeen = false;
+    bool order21_12 = true;
+    MatrixFormat matrix = MatrixFormat::Full;
+    bool inNetworkData = true;
+    bool inInformation = false;
+    int declaredFrequencies = -1;
+    QVector<double> references;
+    bool readingReferences = false;
+
+    QVector<double> record;
+    int expected = 0;
+    int lineNo = 0;
+
+    auto fail = [&](const QString &message) {
+        outError = QString("Touchstone line %1: %2").arg(lineNo).arg(message);
+        return false;
+    };
+
+    auto recordSize = [&]() {
+        const int pairs = (matrix == MatrixFormat::Full) ? ports * ports : ports * (ports + 1) / 2;
+        return 1 + 2 * pairs;
+    };
+
+    const char *line = begin;
+    while (line < end) {
+        const char *lineEnd = static_cast<const char *>(std::memchr(line, '\n', size_t(end - line)));
+        if (!lineEnd)
+            lineEnd = end;
+        ++lineNo;
+
+        const char *p = line;
+        const char *next = lineEnd < end ? lineEnd + 1 : end;
+        line = next;
+
+        while (p < lineEnd && isSpace(*p))
+            ++p;
+
+        const char *comment = static_cast<const char *>(std::memchr(p, '!', size_t(lineEnd - p)));
+        if (comment) {
+            if (out.frequencies.isEmpty() && record.isEmpty())
+                out.comments << QString::fromUtf8(comment + 1, int(lineEnd - comment - 1)).trimmed();
+        }
+        const char *contentEnd = comment ? comment : lineEnd;
+        if (p == contentEnd)
+            continue;
+
+        if (*p == '[') {
+            QByteArray keyword, argument;
+            if (!splitKeyword(QByteArray(p, int(contentEnd - p)), keyword, argument))
+                return fail(QStringLiteral("malformed keyword"));
+
+            readingReferences = false;
+
+            if (keyword == "end information") {
+                inInformation = false;
+            } else if (inInformation) {
+                continue;
+            } else if (keyword == "begin information") {
+                inInformation = true;
+            } else if (keyword == "version") {
+                version = 2;
+                inNetworkData = false;
+            } else if (keyword == "number of ports") {
+                ports = argument.toInt();
+                if (ports <= 0)
+                    return fail(QStringLiteral("invalid [Number of Ports]"));
+            } else if (keyword == "two-port data order") {
+                order21_12 = argument.startsWith("21");
+            } else if (keyword == "number of frequencies") {
+                declaredFrequencies = argument.toInt();
+            } else if (keyword == "reference") {
+                const char *q = argument.constData();
+                const char *qEnd = q + argument.size();
+                double r = 0.0;
+                while (parseNumber(q, qEnd, r))
+                    references << r;
+                readingReferences = references.size() < ports;
+            } else if (keyword == "matrix format") {
+                const QByteArray m = argument.toLower();
+                matrix = m.startsWith("lower") ? MatrixFormat::Lower
+                       : m.startsWith("upper") ? MatrixFormat::Upper
+                                               : MatrixFormat::Full;
+            } else if (keyword == "network data") {
+                inNetworkData = true;
+            } else if (keyword == "noise data") {
+                inNetworkData = false;
+            } else if (keyword == "end") {
+                break;
+            }
+            continue;
+        }
+
+        if (inInformation)
+            continue;
+
+        if (*p == '#') {
+            if (optionSeen)
+                continue;
+            optionSeen = true;
+
+            const QList<QByteArray> tokens = QByteArray(p + 1, int(contentEnd - p - 1)).simplified().split(' ');
+            for (int i = 0; i < tokens.size(); ++i) {
+                const QByteArray t = tokens.at(i).toUpper();
+                if (t.isEmpty())
+                    continue;
+                if (unitMultiplier(QString::fromLatin1(t)) > 0.0)
+                    multiplier = unitMultiplier(QString::fromLatin1(t));
+                else if (t == "RI")
+                    format = Format::RI;
+                else if (t == "MA")
+                    format = Format::MA;
+                else if (t == "DB")
+                    format = Format::DB;
+                else if (t == "R" && i + 1 < tokens.size())
+                    optionReference = tokens.at(++i).toDouble();
+                else if (t.size() == 1 && QByteArray("SYZHG").contains(t))
+                    parameter = QLatin1Char(t.at(0));
+                else
+                    return fail(QString("unknown option \"%1\"").arg(QString::fromLatin1(tokens.at(i))));
+            }
+            continue;
+        }
+
+        if (readingReferences) {
+            double r = 0.0;
+            while (parseNumber(p, contentEnd, r))
+                references << r;
+            readingReferences = references.size() < ports;
+            continue;
+        }
+
+        if (!inNetworkData)
+            continue;
+
+        if (ports <= 0)
+            return fail(QStringLiteral("unknown port count (use a .sNp file name or [Number of Ports])"));
+
+        if (expected == 0) {
+            expected = recordSize();
+            record.reserve(expected);
+            out.ports = ports;
+            out.parameter = parameter;
+        }
+
+        double v = 0.0;
+        while (parseNumber(p, contentEnd, v)) {
+            record.append(v);
+
+            // v1 2-port files may append noise parameters, which start at a lower frequency.
+            if (record.size() == 1 && version == 1 && ports == 2 && !out.frequencies.isEmpty() &&
+                v * multiplier <= out.frequencies.last()) {
+                inNetworkData = false;
+                record.clear();
+                p = contentEnd;
+                break;
+            }
+
+            if (record.size() < expected)
+                continue;
+
+            const double frequency = record.at(0) * multiplier;
+            const int f = out.frequencies.size();
+            out.frequencies.append(frequency);
+            out.values.resize((f + 1) * ports * ports);
+
+            const double *pairs = record.constData() + 1;
+            if (matrix == MatrixFormat::Full) {
+                for (int k = 0; k < ports * ports; ++k) {
+                    int row = k / ports;
+                    int column = k % ports;
+                    if (ports == 2 && order21_12 && (k == 1 || k == 2))
+                        std::swap(row, column);
+                    out.setValue(f, row, column, toComplex(pairs[2 * k], pairs[2 * k + 1], format));
+                }
+            } else {
+                int k = 0;
+                for (int row = 0; row < ports; ++row) {
+                    const int first = (matrix == MatrixFormat::Lower) ? 0 : row;
+                    const int last = (matrix == MatrixFormat::Lower) ? row : ports - 1;
+                    for (int column = first; column <= last; ++column, ++k) {
+                        const Complex c = toComplex(pairs[2 * k], pairs[2 * k + 1], format);
+                        out.setValue(f, row, column, c);
+                        out.setValue(f, column, row, c);
+                    }
+                }
+            }
+            record.clear();
+        }
+
+        if (p < contentEnd)
+            return fail(QString("unexpected text \"%1\"")
+                            .arg(QString::fromUtf8(p, int(qMin<qint64>(contentEnd - p, 20)))));
+    }
+
+    if (!record.isEmpty())
+        return fail(QStringLiteral("incomplete data record at end of file"));
+
+    if (out.frequencies.isEmpty()) {
+        outError = QStringLiteral("Touchstone file contains no network data");
+        return false;
+    }
+
+    if (declaredFrequencies >= 0 && declaredFrequencies != out.frequencies.size()) {
+        outError = QString("Touchstone file declares %1 frequencies but contains %2")
+                       .arg(declaredFrequencies)
+                       .arg(out.frequencies.size());
+        return false;
+    }
+
+    if (references.size() >= ports)
+        out.references = references.mid(0, ports);
+    else
+        out.references.fill(optionReference, ports);
+
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Reads a Touchstone file through a memory mapping.
+ *
+ * \param path     .sNp file (v1 or v2), or any file with v2 keywords.
+ * \param out      Parsed network.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool Touchstone::read(const QString &path, Network &out, QString &outError)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        outError = QString("Cannot open Touchstone file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    const qint64 size = file.size();
+    QByteArray buffer;
+    const char *data = nullptr;
+
+    if (size > 0)
+        data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data) {
+        buffer = file.readAll();
+        data = buffer.constData();
+    }
+
+    if (!parse(data, data + size, portsFromFileName(path), out, outError)) {
+        outError = QString("%1: %2").arg(QDir::toNativeSeparators(path), outError);
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes a network as Touchstone file.
+ *
+ * \param path     Output file; v1 files should carry the fileSuffix() of the port count.
+ * \param network  Network to write.
+ * \param options  Format, frequency unit, precision and Touchstone version.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool Touchstone::write(const QString &path, const Network &network, const WriteOptions &options, QString &outError)
+{
+    if (!network.isValid()) {
+        outError = QStringLiteral("Cannot write an empty or inconsistent network");
+        return false;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        outError = QString("Cannot write Touchstone file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+
+    file.write(toText(network, options));
+    if (!file.commit()) {
+        outError = QString("Cannot write Touchstone file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the network as Touchstone text.
+ *
+ * v1 files carry a single reference impedance (the one of port 1); v2 files list all of them. 2-port data is
+ * written in the v1 order 11 21 12 22 (v1) or 11 12 21 22 (v2, declared as [Two-Port Data Order] 12_21).
+ **********************************************************************************************************************/
+QByteArray Touchstone::toText(const Network &network, const WriteOptions &options)
+{
+    const int n = network.ports;
+    const int precision = qBound(1, options.precision, 17);
+    double multiplier = unitMultiplier(options.frequencyUnit);
+    QString unit = options.frequencyUnit;
+    if (multiplier <= 0.0) {
+        multiplier = 1e9;
+        unit = QStringLiteral("GHz");
+    }
+
+    const double reference = network.references.isEmpty() ? 50.0 : network.references.first();
+    const char *formatName = options.format == Format::RI ? "RI" : options.format == Format::DB ? "DB" : "MA";
+
+    QByteArray out;
+    out.reserve(network.frequencies.size() * (n * n * 2 + 1) * (precision + 8) + 1024);
+
+    for (const QString &comment : network.comments)
+        out += "! " + comment.toUtf8() + '\n';
+
+    if (options.version >= 2)
+        out += "[Version] 2.0\n";
+
+    out += "# " + unit.toLatin1() + ' ' + QString(network.parameter).toLatin1() + ' ' + formatName + " R ";
+    appendNumber(out, reference, precision);
+    out += '\n';
+
+    if (options.version >= 2) {
+        out += "[Number of Ports] " + QByteArray::number(n) + '\n';
+        if (n == 2)
+            out += "[Two-Port Data Order] 12_21\n";
+        out += "[Number of Frequencies] " + QByteArray::number(network.frequencies.size()) + '\n';
+        out += "[Reference]";
+        for (int i = 0; i < n; ++i) {
+            out += ' ';
+            appendNumber(out, i < network.references.size() ? network.references.at(i) : 50.0, precision);
+        }
+        out += "\n[Network Data]\n";
+    }
+
+    auto appendPair = [&](const Complex &c) {
+        double a = c.real();
+        double b = c.imag();
+        if (options.format != Format::RI) {
+            const double magnitude = std::abs(c);
+            b = std::arg(c) * 180.0 / kPi;
+            a = options.format == Format::DB ? 20.0 * std::log10(magnitude) : magnitude;
+        }
+        out += ' ';
+        appendNumber(out, a, precision);
+        out += ' ';
+        appendNumber(out, b, precision);
+    };
+
+    for (int f = 0; f < network.frequencies.size(); ++f) {
+        appendNumber(out, network.frequencies.at(f) / multiplier, precision);
+
+        if (n <= 2) {
+            for (int k = 0; k < n * n; ++k) {
+                int row = k / n;
+                int column = k % n;
+                if (n == 2 && options.version < 2 && (k == 1 || k == 2))
+                    std::swap(row, column);
+                appendPair(network.value(f, row, column));
+            }
+            out += '\n';
+            continue;
+        }
+
+        for (int row = 0; row < n; ++row) {
+            for (int column = 0; column < n; ++column) {
+                if (column > 0 && column % 4 == 0)
+                    out += "\n ";
+                appendPair(network.value(f, row, column));
+            }
+            out += row + 1 < n ? "\n " : "\n";
+        }
+    }
+
+    if (options.version >= 2)
+        out += "[End]\n";
+
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the port count encoded in a .sNp file name, or 0.
+ **********************************************************************************************************************/
+int Touchstone::portsFromFileName(const QString &path)
+{
+    static const QRegularExpression re(QStringLiteral("^s(\\d+)p$"), QRegularExpression::CaseInsensitiveOption);
+    const QRegularExpressionMatch m = re.match(QFileInfo(path).suffix());
+    return m.hasMatch() ? m.captured(1).toInt() : 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the conventional file suffix for \a ports ports, e.g. "s4p".
+ **********************************************************************************************************************/
+QString Touchstone::fileSuffix(int ports)
+{
+    return QString("s%1p").arg(ports);
+}
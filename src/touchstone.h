@@ -0,0 +1,95 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef TOUCHSTONE_H
+#define TOUCHSTONE_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+#include <complex>
+
+/*!*******************************************************************************************************************
+ * \class Touchstone
+ * \brief Reader and writer for Touchstone v1 (.sNp) and v2 network parameter files.
+ *
+ * read() memory-maps the file and scans it in place: comments and keyword lines are skipped line by line,
+ * numbers are converted by a locale-independent parser (exact fast path for up to 15 significant digits,
+ * Qt's double conversion otherwise) and stored in one contiguous array of complex values per file.
+ *
+ * Supported are RI, MA and DB data, any port count (v1: from the .sNp extension; v2: [Number of Ports]), the
+ * v1 2-port column order, v2 [Two-Port Data Order], full/lower/upper [Matrix Format], per-port [Reference]
+ * impedances and Hz/kHz/MHz/GHz units. Noise data of 2-port files is skipped.
+ *
+ * write() produces v1 or v2 files in any of the three formats; v1 files wrap rows after four pairs like the
+ * specification examples.
+ **********************************************************************************************************************/
+class Touchstone
+{
+public:
+    enum class Format { RI, MA, DB };
+
+    typedef std::complex<double> Complex;
+
+    struct Network
+    {
+        int                     ports = 0;
+        QChar                   parameter = QLatin1Char('S');   // S, Y, Z, H or G
+        QVector<double>         references;                     // ohms, one per port
+        QVector<double>         frequencies;                    // Hz
+        QVector<Complex>        values;                         // [frequency][row][column]
+        QStringList             comments;
+
+        bool                    isValid() const;
+        int                     frequencyCount() const { return frequencies.size(); }
+        void                    resize(int portCount, int frequencyCount);
+
+        Complex                 value(int f, int row, int column) const
+        {
+            return values.at((f * ports + row) * ports + column);
+        }
+        void                    setValue(int f, int row, int column, const Complex &v)
+        {
+            values[(f * ports + row) * ports + column] = v;
+        }
+    };
+
+    struct WriteOptions
+    {
+        Format                  format = Format::RI;
+        QString                 frequencyUnit = QStringLiteral("GHz");
+        int                     precision = 12;
+        int                     version = 1;
+    };
+
+    static bool                 read(const QString &path, Network &out, QString &outError);
+    static bool                 parse(const char *begin, const char *end, int ports, Network &out, QString &outError);
+    static bool                 write(const QString &path, const Network &network, const WriteOptions &options,
+                                      QString &outError);
+    static QByteArray           toText(const Network &network, const WriteOptions &options);
+
+    static int                  portsFromFileName(const QString &path);
+    static QString              fileSuffix(int ports);
+    static bool                 parseNumber(const char *&pos, const char *end, double &out);
+};
+
+#endif // TOUCHSTONE_H
@@ -0,0 +1,297 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QMap>
+#include <QMutex>
+#include <QVector>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QCoreApplication>
+
+#include <algorithm>
+
+#include "tracer.h"
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+namespace {
+
+/// Upper bound of buffered events; later events are counted as dropped.
+constexpr int kMaxEvents = 2000000;
+
+struct TraceEvent
+{
+    const char                 *name = nullptr;
+    qint64                      startUs = 0;
+    qint64                      durationUs = 0;
+    int                         tid = 0;
+    QString                     detail;
+};
+
+struct TraceState
+{
+    QMutex                      mutex;
+    QVector<TraceEvent>         events;
+    QMap<int, QString>          threadNames;
+    QString                     path;
+    QElapsedTimer               clock;
+    int                         dropped = 0;
+    bool                        postRoutineAdded = false;
+};
+
+TraceState &traceState()
+{
+    static TraceState state;
+    return state;
+}
+
+std::atomic<int> g_nextThreadId{1};
+thread_local int t_threadId = 0;
+
+/*!*******************************************************************************************************************
+ * \brief Returns a small, stable id for the calling thread (1 for the first traced thread).
+ **********************************************************************************************************************/
+int currentThreadId()
+{
+    if (t_threadId == 0)
+        t_threadId = g_nextThreadId.fetch_add(1);
+    return t_threadId;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes a pending trace when the application object is destroyed.
+ **********************************************************************************************************************/
+void writeTraceAtExit()
+{
+    if (!Tracer::isEnabled())
+        return;
+
+    QString err;
+    if (!Tracer::stop(err))
+        qWarning("%s", qPrintable(err));
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Enables tracing and drops all previously recorded events.
+ *
+ * The calling thread is named "main" in the trace.
+ *
+ * \param outputPath Chrome trace JSON file written by stop() or at application exit.
+ **********************************************************************************************************************/
+void Tracer::start(const QString &outputPath)
+{
+    TraceState &state = traceState();
+    {
+        QMutexLocker lock(&state.mutex);
+        state.events.clear();
+        state.threadNames.clear();
+        state.dropped = 0;
+        state.path = outputPath;
+        state.clock.start();
+
+        if (!state.postRoutineAdded) {
+            qAddPostRoutine(writeTraceAtExit);
+            state.postRoutineAdded = true;
+        }
+    }
+
+    setThreadName(QStringLiteral("main"));
+    s_enabled.store(true, std::memory_order_relaxed);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Enables tracing if the EMSTUDIO_TRACE environment variable names an output file.
+ *
+ * \return True if tracing was enabled.
+ **********************************************************************************************************************/
+bool Tracer::startFromEnvironment()
+{
+    const QString path = qEnvironmentVariable("EMSTUDIO_TRACE").trimmed();
+    if (path.isEmpty())
+        return false;
+
+    start(path);
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Disables tracing and writes the recorded events to the output file.
+ *
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise.
+ **********************************************************************************************************************/
+bool Tracer::stop(QString &outError)
+{
+    s_enabled.store(false, std::memory_order_relaxed);
+
+    const QByteArray json = toJson();
+    const QString path = outputPath();
+    {
+        TraceState &state = traceState();
+        QMutexLocker lock(&state.mutex);
+        state.events.clear();
+    }
+
+    if (path.isEmpty())
+        return true;
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit()) {
+        outError = QString("Cannot write trace file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the file the trace is written to.
+ **********************************************************************************************************************/
+QString Tracer::outputPath()
+{
+    TraceState &state = traceState();
+    QMutexLocker lock(&state.mutex);
+    return state.path;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Names the calling thread in the trace (shown as track name by the viewers).
+ **********************************************************************************************************************/
+void Tracer::setThreadName(const QString &name)
+{
+    const int tid = currentThreadId();
+
+    TraceState &state = traceState();
+    QMutexLocker lock(&state.mutex);
+    state.threadNames[tid] = name;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the trace clock in microseconds since start().
+ **********************************************************************************************************************/
+qint64 Tracer::nowUs()
+{
+    const QElapsedTimer &clock = traceState().clock;
+    return clock.isValid() ? clock.nsecsElapsed() / 1000 : 0;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Records a complete event on the calling thread.
+ *
+ * \param name       Event name; must outlive the tracer (string literal).
+ * \param startUs    Start time from nowUs().
+ * \param durationUs Duration in microseconds.
+ * \param detail     Optional argument shown with the event, e.g. the file being processed.
+ **********************************************************************************************************************/
+void Tracer::addEvent(const char *name, qint64 startUs, qint64 durationUs, const QString &detail)
+{
+    if (!isEnabled())
+        return;
+
+    TraceEvent event;
+    event.name = name;
+    event.startUs = startUs;
+    event.durationUs = durationUs;
+    event.tid = currentThreadId();
+    event.detail = detail;
+
+    TraceState &state = traceState();
+    QMutexLocker lock(&state.mutex);
+    if (state.events.size() >= kMaxEvents) {
+        ++state.dropped;
+        return;
+    }
+    state.events.append(event);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of recorded events.
+ **********************************************************************************************************************/
+int Tracer::eventCount()
+{
+    TraceState &state = traceState();
+    QMutexLocker lock(&state.mutex);
+    return state.events.size();
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the recorded events in Chrome trace event format.
+ *
+ * Thread names are emitted as "thread_name" metadata events; events are sorted by start time.
+ **********************************************************************************************************************/
+QByteArray Tracer::toJson()
+{
+    TraceState &state = traceState();
+    QMutexLocker lock(&state.mutex);
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray events;
+
+    QJsonObject processName;
+    processName["name"] = QStringLiteral("process_name");
+    processName["ph"]   = QStringLiteral("M");
+    processName["pid"]  = double(pid);
+    processName["args"] = QJsonObject{{QStringLiteral("name"), QStringLiteral("EMStudio")}};
+    events.append(processName);
+
+    for (auto it = state.threadNames.cbegin(); it != state.threadNames.cend(); ++it) {
+        QJsonObject threadName;
+        threadName["name"] = QStringLiteral("thread_name");
+        threadName["ph"]   = QStringLiteral("M");
+        threadName["pid"]  = double(pid);
+        threadName["tid"]  = it.key();
+        threadName["args"] = QJsonObject{{QStringLiteral("name"), it.value()}};
+        events.append(threadName);
+    }
+
+    QVector<TraceEvent> sorted = state.events;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const TraceEvent &a, const TraceEvent &b) {
+        return a.startUs < b.startUs;
+    });
+
+    for (const TraceEvent &event : qAsConst(sorted)) {
+        QJsonObject o;
+        o["name"] = QString::fromLatin1(event.name);
+        o["cat"]  = QStringLiteral("emstudio");
+        o["ph"]   = QStringLiteral("X");
+        o["ts"]   = double(event.startUs);
+        o["dur"]  = double(event.durationUs);
+        o["pid"]  = double(pid);
+        o["tid"]  = event.tid;
+        if (!event.detail.isEmpty())
+            o["args"] = QJsonObject{{QStringLiteral("detail"), event.detail}};
+        events.append(o);
+    }
+
+    QJsonObject other;
+    other["emstudio_version"] = QCoreApplication::applicationVersion();
+    other["dropped_events"]   = state.dropped;
+
+    QJsonObject root;
+    root["displayTimeUnit"] = QStringLiteral("ms");
+    root["traceEvents"]     = events;
+    root["otherData"]       = other;
+    return QJsonDocument(root).toJson(QJsonDocument::Compact);
+}
@@ -0,0 +1,104 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <QString>
+#include <QByteArray>
+
+#include <atomic>
+
+/*!*******************************************************************************************************************
+ * \class Tracer
+ * \brief Process-wide scoped tracing that writes Chrome trace JSON (chrome://tracing, ui.perfetto.dev).
+ *
+ * Hot paths are marked with EMSTUDIO_TRACE_SCOPE("name"). While tracing is off, a scope costs a single relaxed
+ * atomic load; while it is on, each scope records one complete event ("ph":"X") with its start, duration and
+ * thread. Nested scopes on one thread are shown nested by the viewers.
+ *
+ * Tracing is enabled with the -trace <file> command-line option or the EMSTUDIO_TRACE environment variable.
+ * The trace is written when the application object is destroyed, or explicitly with stop().
+ **********************************************************************************************************************/
+class Tracer
+{
+public:
+    static bool                 isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    static void                 start(const QString &outputPath);
+    static bool                 startFromEnvironment();
+    static bool                 stop(QString &outError);
+    static QString              outputPath();
+
+    static void                 setThreadName(const QString &name);
+    static qint64               nowUs();
+    static void                 addEvent(const char *name, qint64 startUs, qint64 durationUs,
+                                         const QString &detail = QString());
+    static int                  eventCount();
+    static QByteArray           toJson();
+
+private:
+    static std::atomic<bool>    s_enabled;
+};
+
+/*!*******************************************************************************************************************
+ * \class TraceScope
+ * \brief RAII helper that records the lifetime of a scope as one trace event.
+ *
+ * \a name must be a string literal (it is stored by pointer). The optional \a detail (e.g. a file name) is
+ * only copied while tracing is on.
+ **********************************************************************************************************************/
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : m_name(Tracer::isEnabled() ? name : nullptr)
+    {
+        if (m_name)
+            m_startUs = Tracer::nowUs();
+    }
+
+    TraceScope(const char *name, const QString &detail)
+        : TraceScope(name)
+    {
+        if (m_name)
+            m_detail = detail;
+    }
+
+    ~TraceScope()
+    {
+        if (m_name)
+            Tracer::addEvent(m_name, m_startUs, Tracer::nowUs() - m_startUs, m_detail);
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char                 *m_name = nullptr;
+    qint64                      m_startUs = 0;
+    QString                     m_detail;
+};
+
+#define EMSTUDIO_TRACE_CONCAT_INNER(a, b) a##b
+#define EMSTUDIO_TRACE_CONCAT(a, b) EMSTUDIO_TRACE_CONCAT_INNER(a, b)
+#define EMSTUDIO_TRACE_SCOPE(...) TraceScope EMSTUDIO_TRACE_CONCAT(emstudioTraceScope_, __LINE__)(__VA_ARGS__)
+
+#endif // TRACER_H
@@ -0,0 +1,1409 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QRegularExpression>
+#include <QtMath>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include "parallelfor.h"
+#include "sparameterchecks.h"
+#include "vectorfit.h"
+
+namespace {
+
+typedef Touchstone::Complex Complex;
+
+const double kRelaxedLimit = 1e-8;
+const int kMinPassivitySamples = 1000;
+const int kResonanceSamples = 64;   // per side of a resonance, equally spaced in the phase of 1 / (s - p)
+const int kMaxJacobiSweeps = 60;
+const int kMaxQrIterations = 60;    // per eigenvalue
+const double kCompressionTolerance = 1e-6;
+
+/*!*******************************************************************************************************************
+ * \brief Returns the number of real basis functions for \a poles: two per conjugate pair, one per real pole.
+ **********************************************************************************************************************/
+int realColumns(const QVector<Complex> &poles)
+{
+    int n = 0;
+    for (const Complex &p : poles)
+        n += p.imag() > 0.0 ? 2 : 1;
+    return n;
+}
+
+double dot(const double *a, const double *b, int n)
+{
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+void axpy(double alpha, const double *x, double *y, int n)
+{
+    for (int i = 0; i < n; ++i)
+        y[i] += alpha * x[i];
+}
+
+/*!*******************************************************************************************************************
+ * \brief Real-form partial fraction basis on normalized frequencies.
+ *
+ * Each column holds the real parts at all frequencies followed by the imaginary parts. A real pole a gives
+ * 1/(s - a); a pair a, a* gives 1/(s - a) + 1/(s - a*) and j/(s - a) - j/(s - a*), so real coefficients c1, c2
+ * stand for the residue c1 + j c2 of a (and its conjugate of a*). The optional last column is the constant 1.
+ **********************************************************************************************************************/
+struct Basis
+{
+    int                         frequencies = 0;
+    int                         columns = 0;
+    std::vector<double>         values;     // column-major, 2 * frequencies rows
+
+    int                         rows() const { return 2 * frequencies; }
+    const double               *column(int c) const { return values.data() + size_t(c) * size_t(rows()); }
+};
+
+Basis makeBasis(const QVector<Complex> &poles, const std::vector<double> &omega, bool withConstant)
+{
+    const int ns = int(omega.size());
+
+    Basis basis;
+    basis.frequencies = ns;
+    basis.columns = realColumns(poles) + (withConstant ? 1 : 0);
+    basis.values.assign(size_t(basis.columns) * size_t(2 * ns), 0.0);
+
+    int c = 0;
+    for (const Complex &p : poles) {
+        double *x = basis.values.data() + size_t(c) * size_t(2 * ns);
+        if (p.imag() > 0.0) {
+            double *y = x + 2 * ns;
+            for (int k = 0; k < ns; ++k) {
+                const Complex s(0.0, omega[k]);
+                const Complex a = 1.0 / (s - p);
+                const Complex b = 1.0 / (s - std::conj(p));
+                const Complex v1 = a + b;
+                const Complex v2 = Complex(0.0, 1.0) * (a - b);
+                x[k] = v1.real();
+                x[ns + k] = v1.imag();
+                y[k] = v2.real();
+                y[ns + k] = v2.imag();
+            }
+            c += 2;
+        } else {
+            for (int k = 0; k < ns; ++k) {
+                const Complex v = 1.0 / (Complex(0.0, omega[k]) - p.real());
+                x[k] = v.real();
+                x[ns + k] = v.imag();
+            }
+            c += 1;
+        }
+    }
+    if (withConstant)
+        std::fill_n(basis.values.begin() + size_t(c) * size_t(2 * ns), ns, 1.0);
+    return basis;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Thin QR factorization A = Q R by Gram-Schmidt with reorthogonalization.
+ *
+ * Columns that depend on the previous ones within rounding get a zero column in Q and a zero diagonal in R; the
+ * least-squares solution sets their coefficient to zero.
+ **********************************************************************************************************************/
+struct ThinQr
+{
+    int                         rows = 0;
+    int                         columns = 0;
+    std::vector<double>         q;          // column-major
+    std::vector<double>         r;          // row-major, columns x columns
+
+    const double               *column(int c) const { return q.data() + size_t(c) * size_t(rows); }
+};
+
+ThinQr thinQr(const double *a, int rows, int columns)
+{
+    ThinQr qr;
+    qr.rows = rows;
+    qr.columns = columns;
+    qr.q.assign(a, a + size_t(rows) * size_t(columns));
+    qr.r.assign(size_t(columns) * size_t(columns), 0.0);
+
+    for (int j = 0; j < columns; ++j) {
+        double *v = qr.q.data() + size_t(j) * size_t(rows);
+        const double norm0 = std::sqrt(dot(v, v, rows));
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int i = 0; i < j; ++i) {
+                const double *qi = qr.column(i);
+                const double h = dot(qi, v, rows);
+                qr.r[size_t(i) * columns + j] += h;
+                axpy(-h, qi, v, rows);
+            }
+        }
+        const double norm = std::sqrt(dot(v, v, rows));
+        if (norm == 0.0 || norm <= 1e-12 * norm0) {
+            std::fill(v, v + rows, 0.0);
+            continue;
+        }
+        qr.r[size_t(j) * columns + j] = norm;
+        for (int i = 0; i < rows; ++i)
+            v[i] /= norm;
+    }
+    return qr;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Solves min |A x - b| with the factorization of A; \a work needs qr.columns elements.
+ **********************************************************************************************************************/
+void solveLeastSquares(const ThinQr &qr, const double *b, double *x, double *work)
+{
+    const int n = qr.columns;
+    for (int j = 0; j < n; ++j)
+        work[j] = dot(qr.column(j), b, qr.rows);
+
+    for (int j = n - 1; j >= 0; --j) {
+        const double diagonal = qr.r[size_t(j) * n + j];
+        if (diagonal == 0.0) {
+            x[j] = 0.0;
+            continue;
+        }
+        double sum = work[j];
+        for (int i = j + 1; i < n; ++i)
+            sum -= qr.r[size_t(j) * n + i] * x[i];
+        x[j] = sum / diagonal;
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Solves the symmetric positive (semi)definite system G x = g by Cholesky factorization after diagonal
+ *        equilibration; a tiny ridge is added if the factorization breaks down.
+ **********************************************************************************************************************/
+bool solveSymmetric(std::vector<double> g, std::vector<double> rhs, int n, std::vector<double> &x)
+{
+    std::vector<double> d(n);
+    for (int i = 0; i < n; ++i)
+        d[i] = g[size_t(i) * n + i] > 0.0 ? 1.0 / std::sqrt(g[size_t(i) * n + i]) : 1.0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j)
+            g[size_t(i) * n + j] *= d[i] * d[j];
+        rhs[i] *= d[i];
+    }
+
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        std::vector<double> l = g;
+        if (attempt > 0) {
+            for (int i = 0; i < n; ++i)
+                l[size_t(i) * n + i] += 1e-10;
+        }
+
+        bool ok = true;
+        for (int j = 0; j < n && ok; ++j) {
+            double diagonal = l[size_t(j) * n + j] - dot(&l[size_t(j) * n], &l[size_t(j) * n], j);
+            if (!(diagonal > 0.0)) {
+                ok = false;
+                break;
+            }
+            diagonal = std::sqrt(diagonal);
+            l[size_t(j) * n + j] = diagonal;
+            for (int i = j + 1; i < n; ++i)
+                l[size_t(i) * n + j] = (l[size_t(i) * n + j] - dot(&l[size_t(i) * n], &l[size_t(j) * n], j)) / diagonal;
+        }
+        if (!ok)
+            continue;
+
+        std::vector<double> y(n);
+        for (int i = 0; i < n; ++i)
+            y[i] = (rhs[i] - dot(&l[size_t(i) * n], y.data(), i)) / l[size_t(i) * n + i];
+        x.assign(n, 0.0);
+        for (int i = n - 1; i >= 0; --i) {
+            double sum = y[i];
+            for (int k = i + 1; k < n; ++k)
+                sum -= l[size_t(k) * n + i] * x[k];
+            x[i] = sum / l[size_t(i) * n + i];
+        }
+        for (int i = 0; i < n; ++i)
+            x[i] *= d[i];
+        return true;
+    }
+    return false;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Singular value decomposition A = U diag(s) V^H of a square complex matrix by one-sided Jacobi rotations.
+ *
+ * \param a Row-major n x n matrix.
+ * \param u Receives the left singular vectors, column-major.
+ * \param s Receives the singular values (unsorted).
+ * \param v Receives the right singular vectors, column-major.
+ **********************************************************************************************************************/
+void singularValueDecomposition(const Complex *a, int n, std::vector<Complex> &u, std::vector<double> &s,
+                                std::vector<Complex> &v)
+{
+    u.resize(size_t(n) * n);
+    v.assign(size_t(n) * n, Complex());
+    s.assign(n, 0.0);
+    for (int r = 0; r < n; ++r) {
+        for (int c = 0; c < n; ++c)
+            u[size_t(c) * n + r] = a[size_t(r) * n + c];
+        v[size_t(r) * n + r] = 1.0;
+    }
+
+    for (int sweep = 0; sweep < kMaxJacobiSweeps; ++sweep) {
+        bool rotated = false;
+        for (int p = 0; p + 1 < n; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                Complex *up = &u[size_t(p) * n];
+                Complex *uq = &u[size_t(q) * n];
+                double alpha = 0.0;
+                double beta = 0.0;
+                Complex gamma;
+                for (int r = 0; r < n; ++r) {
+                    alpha += std::norm(up[r]);
+                    beta += std::norm(uq[r]);
+                    gamma += std::conj(up[r]) * uq[r];
+                }
+                const double g = std::abs(gamma);
+                if (g <= 1e-15 * std::sqrt(alpha * beta))
+                    continue;
+                rotated = true;
+
+                // Make the inner product real with a phase on column q, then rotate like real Jacobi.
+                const Complex phase = std::conj(gamma) / g;
+                const double zeta = (beta - alpha) / (2.0 * g);
+                const double t = (zeta >= 0.0 ? 1.0 : -1.0) / (std::abs(zeta) + std::sqrt(1.0 + zeta * zeta));
+                const double c = 1.0 / std::sqrt(1.0 + t * t);
+                const double sn = c * t;
+
+                Complex *vp = &v[size_t(p) * n];
+                Complex *vq = &v[size_t(q) * n];
+                for (int r = 0; r < n; ++r) {
+                    const Complex x = up[r];
+                    const Complex y = uq[r] * phase;
+                    up[r] = c * x - sn * y;
+                    uq[r] = sn * x + c * y;
+                    const Complex vx = vp[r];
+                    const Complex vy = vq[r] * phase;
+                    vp[r] = c * vx - sn * vy;
+                    vq[r] = sn * vx + c * vy;
+                }
+            }
+        }
+        if (!rotated)
+            break;
+    }
+
+    for (int c = 0; c < n; ++c) {
+        Complex *uc = &u[size_t(c) * n];
+        double norm = 0.0;
+        for (int r = 0; r < n; ++r)
+            norm += std::norm(uc[r]);
+        s[c] = std::sqrt(norm);
+        if (s[c] > 0.0) {
+            for (int r = 0; r < n; ++r)
+                uc[r] /= s[c];
+        }
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Sorts poles by imaginary, then real part; real poles come first.
+ **********************************************************************************************************************/
+void sortPoles(QVector<Complex> &poles)
+{
+    std::sort(poles.begin(), poles.end(), [](const Complex &a, const Complex &b) {
+        return a.imag() != b.imag() ? a.imag() < b.imag() : a.real() < b.real();
+    });
+}
+
+/*!*******************************************************************************************************************
+ * \brief Starting poles: complex pairs with imaginary parts spread over the band and damping 1/100, plus one real
+ *        pole at the top of the band if \a count is odd (normalized frequencies).
+ **********************************************************************************************************************/
+QVector<Complex> startingPoles(int count, double omegaMin)
+{
+    QVector<Complex> poles;
+    const int pairs = count / 2;
+    const double low = qBound(0.01, omegaMin, 1.0);
+    for (int i = 0; i < pairs; ++i) {
+        const double beta = pairs > 1 ? low + (1.0 - low) * i / (pairs - 1) : 1.0;
+        poles << Complex(-beta / 100.0, beta);
+    }
+    if (count % 2)
+        poles << Complex(-1.0, 0.0);
+    sortPoles(poles);
+    return poles;
+}
+
+struct EntryScratch
+{
+    std::vector<double>         columns;
+    std::vector<double>         rhs;
+    std::vector<double>         solution;
+    std::vector<double>         work;
+    std::vector<double>         re;
+    std::vector<double>         im;
+    std::vector<Complex>        u;
+    std::vector<Complex>        v;
+    std::vector<double>         s;
+};
+
+/*!*******************************************************************************************************************
+ * \brief Measured data, one contiguous array of real and one of imaginary parts per matrix entry.
+ **********************************************************************************************************************/
+struct Samples
+{
+    int                         entries = 0;
+    std::vector<double>         omega;      // normalized angular frequencies
+    std::vector<double>         re;         // [entry][frequency]
+    std::vector<double>         im;
+
+    int                         frequencies() const { return int(omega.size()); }
+};
+
+/*!*******************************************************************************************************************
+ * \brief Eigen-decomposition of a symmetric matrix by cyclic Jacobi rotations.
+ *
+ * \param a       Row-major n x n matrix; destroyed.
+ * \param values  Receives the eigenvalues.
+ * \param vectors Receives the eigenvectors, column i for values[i] (row-major n x n).
+ **********************************************************************************************************************/
+void symmetricEigen(std::vector<double> &a, int n, std::vector<double> &values, std::vector<double> &vectors)
+{
+    vectors.assign(size_t(n) * n, 0.0);
+    for (int i = 0; i < n; ++i)
+        vectors[size_t(i) * n + i] = 1.0;
+
+    for (int sweep = 0; sweep < kMaxJacobiSweeps; ++sweep) {
+        double diagonal = 0.0;
+        double off = 0.0;
+        for (int p = 0; p < n; ++p) {
+            diagonal += a[size_t(p) * n + p] * a[size_t(p) * n + p];
+            for (int q = p + 1; q < n; ++q)
+                off += a[size_t(p) * n + q] * a[size_t(p) * n + q];
+        }
+        if (off <= 1e-30 * diagonal)
+            break;
+
+        for (int p = 0; p + 1 < n; ++p) {
+            for (int q = p + 1; q < n; ++q) {
+                const double apq = a[size_t(p) * n + q];
+                if (apq == 0.0)
+                    continue;
+                const double theta = (a[size_t(q) * n + q] - a[size_t(p) * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double sn = t * c;
+                for (int k = 0; k < n; ++k) {
+                    double *row = &a[size_t(k) * n];
+                    const double kp = row[p];
+                    row[p] = c * kp - sn * row[q];
+                    row[q] = sn * kp + c * row[q];
+                    double *v = &vectors[size_t(k) * n];
+                    const double vp = v[p];
+                    v[p] = c * vp - sn * v[q];
+                    v[q] = sn * vp + c * v[q];
+                }
+                double *rp = &a[size_t(p) * n];
+                double *rq = &a[size_t(q) * n];
+                for (int k = 0; k < n; ++k) {
+                    const double pk = rp[k];
+                    rp[k] = c * pk - sn * rq[k];
+                    rq[k] = sn * pk + c * rq[k];
+                }
+            }
+        }
+    }
+
+    values.resize(n);
+    for (int i = 0; i < n; ++i)
+        values[i] = a[size_t(i) * n + i];
+}
+
+/*!*******************************************************************************************************************
+ * \brief Replaces the entries by the dominant real combinations of them, for pole relocation.
+ *
+ * All entries of a model with N poles lie in the span of the N + 1 real-form basis functions, so the responses
+ * of a many-port result are nearly rank deficient. The combinations are the principal components of the
+ * real-form responses (eigenvectors of their Gram matrix) with singular values above kCompressionTolerance of the
+ * largest; real coefficients keep the combinations responses of a real system. Relocation then costs the same
+ * for 16 ports as for a handful of entries, with the same poles.
+ **********************************************************************************************************************/
+Samples compress(const Samples &data, int threads)
+{
+    const int ns = data.frequencies();
+    const int entries = data.entries;
+    if (entries <= 1)
+        return data;
+
+    std::vector<double> gram(size_t(entries) * entries);
+    parallelFor<int>(entries, threads, [&](int i, int &) {
+        const double *ri = data.re.data() + size_t(i) * ns;
+        const double *ii = data.im.data() + size_t(i) * ns;
+        for (int j = 0; j <= i; ++j) {
+            const double g = dot(ri, data.re.data() + size_t(j) * ns, ns) +
+                             dot(ii, data.im.data() + size_t(j) * ns, ns);
+            gram[size_t(i) * entries + j] = g;
+            gram[size_t(j) * entries + i] = g;
+        }
+    });
+
+    std::vector<double> values;
+    std::vector<double> vectors;
+    symmetricEigen(gram, entries, values, vectors);
+
+    std::vector<int> order(entries);
+    for (int i = 0; i < entries; ++i)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return values[a] > values[b]; });
+
+    const double limit = kCompressionTolerance * kCompressionTolerance * qMax(values[order.front()], 0.0);
+    int kept = 0;
+    while (kept < entries && values[order[kept]] > limit)
+        ++kept;
+    if (kept == 0 || kept == entries)
+        return data;
+
+    Samples out;
+    out.entries = kept;
+    out.omega = data.omega;
+    out.re.assign(size_t(kept) * ns, 0.0);
+    out.im.assign(size_t(kept) * ns, 0.0);
+    parallelFor<int>(kept, threads, [&](int i, int &) {
+        for (int e = 0; e < entries; ++e) {
+            const double weight = vectors[size_t(e) * entries + order[i]];
+            axpy(weight, data.re.data() + size_t(e) * ns, out.re.data() + size_t(i) * ns, ns);
+            axpy(weight, data.im.data() + size_t(e) * ns, out.im.data() + size_t(i) * ns, ns);
+        }
+    });
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief One vector fitting pole relocation step.
+ *
+ * For every entry k the sigma unknowns (c~, and d~ if relaxed) solve [Phi 1 | -H_k Phi -H_k] x = 0 (or = H_k
+ * with d~ = 1). The left block is the same for all entries, so it is factored once and each entry only projects
+ * its sigma columns onto the orthogonal complement and adds their Gram matrix. The relaxed system gets the
+ * normalization Re sum(sigma) = number of frequencies. Falls back to d~ = 1 if d~ comes out tiny or huge.
+ *
+ * \param deviation Receives max |sigma / d~ - 1| over the frequencies, which goes to zero as the poles converge.
+ * \return False if the eigenvalue iteration did not converge; \a out is unchanged then.
+ **********************************************************************************************************************/
+bool relocatePoles(const QVector<Complex> &poles, const Samples &data, int threads, bool relaxed,
+                   QVector<Complex> &out, double &deviation)
+{
+    const int ns = data.frequencies();
+    const Basis basis = makeBasis(poles, data.omega, true);
+    const int rows = basis.rows();
+    const int n = basis.columns - 1;
+    const int n1 = basis.columns;
+    const int n2 = relaxed ? n + 1 : n;
+    const ThinQr left = thinQr(basis.values.data(), rows, n1);
+
+    std::vector<double> gram(size_t(data.entries) * n2 * n2);
+    std::vector<double> rhs(size_t(data.entries) * n2, 0.0);
+
+    parallelFor<EntryScratch>(data.entries, threads, [&](int e, EntryScratch &s) {
+        const double *hr = data.re.data() + size_t(e) * ns;
+        const double *hi = data.im.data() + size_t(e) * ns;
+
+        // Sigma columns -H_k * basis, plus H_k as right-hand side for the non-relaxed system.
+        s.columns.resize(size_t(n2 + 1) * rows);
+        for (int c = 0; c < n2; ++c) {
+            const double *phi = basis.column(c);
+            double *col = s.columns.data() + size_t(c) * rows;
+            for (int k = 0; k < ns; ++k) {
+                col[k] = -(hr[k] * phi[k] - hi[k] * phi[ns + k]);
+                col[ns + k] = -(hr[k] * phi[ns + k] + hi[k] * phi[k]);
+            }
+        }
+        double *b = s.columns.data() + size_t(n2) * rows;
+        std::copy(hr, hr + ns, b);
+        std::copy(hi, hi + ns, b + ns);
+
+        const int projected = relaxed ? n2 : n2 + 1;
+        for (int c = 0; c < projected; ++c) {
+            double *col = s.columns.data() + size_t(c) * rows;
+            for (int i = 0; i < n1; ++i)
+                axpy(-dot(left.column(i), col, rows), left.column(i), col, rows);
+        }
+
+        double *g = gram.data() + size_t(e) * n2 * n2;
+        for (int a = 0; a < n2; ++a) {
+            const double *ca = s.columns.data() + size_t(a) * rows;
+            for (int c = 0; c <= a; ++c)
+                g[a * n2 + c] = g[c * n2 + a] = dot(ca, s.columns.data() + size_t(c) * rows, rows);
+            if (!relaxed)
+                rhs[size_t(e) * n2 + a] = dot(ca, b, rows);
+        }
+    });
+
+    std::vector<double> system(size_t(n2) * n2, 0.0);
+    std::vector<double> target(n2, 0.0);
+    for (int e = 0; e < data.entries; ++e) {
+        axpy(1.0, gram.data() + size_t(e) * n2 * n2, system.data(), n2 * n2);
+        axpy(1.0, rhs.data() + size_t(e) * n2, target.data(), n2);
+    }
+
+    if (relaxed) {
+        const double scale = std::sqrt(dot(data.re.data(), data.re.data(), int(data.re.size())) +
+                                       dot(data.im.data(), data.im.data(), int(data.im.size()))) / ns;
+        std::vector<double> row(n2);
+        for (int c = 0; c < n2; ++c) {
+            const double *phi = basis.column(c);
+            double sum = 0.0;
+            for (int k = 0; k < ns; ++k)
+                sum += phi[k];
+            row[c] = scale * sum;
+        }
+        for (int a = 0; a < n2; ++a) {
+            for (int c = 0; c < n2; ++c)
+                system[size_t(a) * n2 + c] += row[a] * row[c];
+            target[a] += row[a] * ns * scale;
+        }
+    }
+
+    std::vector<double> x;
+    if (!solveSymmetric(system, target, n2, x))
+        return false;
+
+    double dTilde = 1.0;
+    if (relaxed) {
+        dTilde = x[n];
+        if (!(std::abs(dTilde) >= kRelaxedLimit && std::abs(dTilde) <= 1.0 / kRelaxedLimit))
+            return relocatePoles(poles, data, threads, false, out, deviation);
+    }
+
+    deviation = 0.0;
+    for (int k = 0; k < ns; ++k) {
+        Complex sigma(relaxed ? 0.0 : 1.0, 0.0);
+        for (int c = 0; c < n2; ++c)
+            sigma += x[c] * Complex(basis.column(c)[k], basis.column(c)[ns + k]);
+        deviation = qMax(deviation, std::abs(sigma / dTilde - 1.0));
+    }
+
+    // Zeros of sigma: eigenvalues of A - b c~^T / d~ in real block-diagonal form.
+    std::vector<double> m(size_t(n) * n, 0.0);
+    std::vector<double> bv(n, 0.0);
+    int c = 0;
+    for (const Complex &p : poles) {
+        if (p.imag() > 0.0) {
+            m[size_t(c) * n + c] = p.real();
+            m[size_t(c) * n + c + 1] = p.imag();
+            m[size_t(c + 1) * n + c] = -p.imag();
+            m[size_t(c + 1) * n + c + 1] = p.real();
+            bv[c] = 2.0;
+            c += 2;
+        } else {
+            m[size_t(c) * n + c] = p.real();
+            bv[c] = 1.0;
+            c += 1;
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j)
+            m[size_t(i) * n + j] -= bv[i] * x[j] / dTilde;
+    }
+
+    QVector<Complex> zeros;
+    if (!VectorFit::eigenvalues(m.data(), n, zeros))
+        return false;
+
+    // Mirror unstable poles and keep one pole per conjugate pair.
+    QVector<Complex> next;
+    for (const Complex &z : qAsConst(zeros)) {
+        double re = z.real();
+        if (re > 0.0)
+            re = -re;
+        if (re == 0.0)
+            re = -1e-6 * qMax(std::abs(z), 1e-3);
+        if (std::abs(z.imag()) <= 1e-8 * std::abs(z))
+            next << Complex(re, 0.0);
+        else if (z.imag() > 0.0)
+            next << Complex(re, z.imag());
+    }
+    sortPoles(next);
+    out = next;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Least-squares residues and constant terms of every entry for fixed poles.
+ *
+ * \param coefficients Receives the real-form coefficients, [entry][realColumns(poles)].
+ * \param constant     Receives the constant terms, [entry].
+ **********************************************************************************************************************/
+void fitResidues(const QVector<Complex> &poles, const Samples &data, int threads, std::vector<double> &coefficients,
+                 std::vector<double> &constant)
+{
+    const int ns = data.frequencies();
+    const Basis basis = makeBasis(poles, data.omega, true);
+    const ThinQr qr = thinQr(basis.values.data(), basis.rows(), basis.columns);
+    const int n = basis.columns - 1;
+
+    coefficients.assign(size_t(data.entries) * n, 0.0);
+    constant.assign(data.entries, 0.0);
+
+    parallelFor<EntryScratch>(data.entries, threads, [&](int e, EntryScratch &s) {
+        s.rhs.resize(2 * ns);
+        std::copy(data.re.begin() + size_t(e) * ns, data.re.begin() + size_t(e + 1) * ns, s.rhs.begin());
+        std::copy(data.im.begin() + size_t(e) * ns, data.im.begin() + size_t(e + 1) * ns, s.rhs.begin() + ns);
+        s.solution.resize(n + 1);
+        s.work.resize(n + 1);
+        solveLeastSquares(qr, s.rhs.data(), s.solution.data(), s.work.data());
+        std::copy(s.solution.begin(), s.solution.begin() + n, coefficients.begin() + size_t(e) * n);
+        constant[e] = s.solution[n];
+    });
+}
+
+/*!*******************************************************************************************************************
+ * \brief RMS and largest magnitude of the difference between model and data over all entries and frequencies.
+ **********************************************************************************************************************/
+void fitErrors(const QVector<Complex> &poles, const Samples &data, int threads,
+               const std::vector<double> &coefficients, const std::vector<double> &constant, double &rms,
+               double &maximum)
+{
+    const int ns = data.frequencies();
+    const Basis basis = makeBasis(poles, data.omega, false);
+    const int n = basis.columns;
+
+    std::vector<double> sumSquares(data.entries);
+    std::vector<double> largest(data.entries);
+
+    parallelFor<EntryScratch>(data.entries, threads, [&](int e, EntryScratch &s) {
+        s.re.assign(ns, constant[e]);
+        s.im.assign(ns, 0.0);
+        axpy(-1.0, data.re.data() + size_t(e) * ns, s.re.data(), ns);
+        axpy(-1.0, data.im.data() + size_t(e) * ns, s.im.data(), ns);
+        for (int c = 0; c < n; ++c) {
+            const double coefficient = coefficients[size_t(e) * n + c];
+            axpy(coefficient, basis.column(c), s.re.data(), ns);
+            axpy(coefficient, basis.column(c) + ns, s.im.data(), ns);
+        }
+        double sum = 0.0;
+        double peak = 0.0;
+        for (int k = 0; k < ns; ++k) {
+            const double sq = s.re[k] * s.re[k] + s.im[k] * s.im[k];
+            sum += sq;
+            peak = qMax(peak, sq);
+        }
+        sumSquares[e] = sum;
+        largest[e] = peak;
+    });
+
+    double total = 0.0;
+    maximum = 0.0;
+    for (int e = 0; e < data.entries; ++e) {
+        total += sumSquares[e];
+        maximum = qMax(maximum, largest[e]);
+    }
+    rms = std::sqrt(total / (double(data.entries) * ns));
+    maximum = std::sqrt(maximum);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns true if all singular values of the n x n matrix (re, im) are below \a bound.
+ *
+ * Tests whether bound^2 I - S^H S is positive definite by a Cholesky factorization, which is much cheaper than
+ * finding the largest singular value when most of the samples are clearly passive.
+ **********************************************************************************************************************/
+bool singularValuesBelow(const double *re, const double *im, int n, double bound, std::vector<Complex> &work)
+{
+    work.assign(size_t(n) * n, Complex());
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j <= i; ++j) {
+            Complex sum = i == j ? Complex(bound * bound, 0.0) : Complex();
+            for (int r = 0; r < n; ++r) {
+                const size_t a = size_t(r) * n;
+                sum -= std::conj(Complex(re[a + i], im[a + i])) * Complex(re[a + j], im[a + j]);
+            }
+            work[size_t(i) * n + j] = sum;
+        }
+    }
+
+    for (int j = 0; j < n; ++j) {
+        double pivot = work[size_t(j) * n + j].real();
+        for (int k = 0; k < j; ++k)
+            pivot -= std::norm(work[size_t(j) * n + k]);
+        if (!(pivot > 0.0))
+            return false;
+        pivot = std::sqrt(pivot);
+        work[size_t(j) * n + j] = pivot;
+        for (int i = j + 1; i < n; ++i) {
+            Complex sum = work[size_t(i) * n + j];
+            for (int k = 0; k < j; ++k)
+                sum -= work[size_t(i) * n + k] * std::conj(work[size_t(j) * n + k]);
+            work[size_t(i) * n + j] = sum / pivot;
+        }
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Passivity check and enforcement by singular value perturbation (normalized frequencies).
+ *
+ * First the singular values of the constant term are clipped to 1 - margin if it is not passive by itself. Then
+ * the model is sampled up to twice the highest fitted frequency, and densely around the resonance of every pole
+ * pair, whose peak is too sharp for the uniform grid. Wherever a singular value exceeds 1 - margin it is reduced
+ * to that value; the residue correction is the least-squares fit of this perturbation with the model's poles, in
+ * which the violating samples together weigh as much as all others. Since the fit smooths the perturbation, this
+ * repeats until the model is passive on the grid or \a maxIterations corrections were made (0: check only).
+ * Samples are screened with singularValuesBelow(); the largest singular value is only computed where the screen
+ * fails and, once, for the result.
+ *
+ * \return True if the model is passive on the grid; \a maxSigma receives the largest singular value found.
+ **********************************************************************************************************************/
+bool enforcePassivity(const QVector<Complex> &poles, int ports, int ns, int maxIterations, double margin,
+                      int threads, std::vector<double> &coefficients, std::vector<double> &constant,
+                      double &maxSigma)
+{
+    const int entries = ports * ports;
+
+    std::vector<Complex> u;
+    std::vector<Complex> v;
+    std::vector<double> s;
+    if (maxIterations > 0) {
+        std::vector<Complex> d(constant.begin(), constant.end());
+        singularValueDecomposition(d.data(), ports, u, s, v);
+        if (*std::max_element(s.begin(), s.end()) >= 1.0) {
+            std::fill(constant.begin(), constant.end(), 0.0);
+            for (int i = 0; i < ports; ++i) {
+                const double clipped = qMin(s[i], 1.0 - margin);
+                for (int r = 0; r < ports; ++r) {
+                    for (int c = 0; c < ports; ++c)
+                        constant[size_t(r) * ports + c] +=
+                            clipped * (u[size_t(i) * ports + r] * std::conj(v[size_t(i) * ports + c])).real();
+                }
+            }
+        }
+    }
+
+    Samples grid;
+    grid.entries = entries;
+    const int samples = qMax(kMinPassivitySamples, 2 * ns);
+    for (int g = 0; g < samples; ++g)
+        grid.omega.push_back(2.0 * g / (samples - 1));
+    for (const Complex &p : poles) {
+        if (p.imag() <= 0.0)
+            continue;
+        for (int k = -kResonanceSamples; k <= kResonanceSamples; ++k) {
+            const double omega = p.imag() - p.real() * std::tan(M_PI_2 * k / (kResonanceSamples + 1));
+            if (omega > 0.0)
+                grid.omega.push_back(omega);
+        }
+    }
+
+    const int ng = grid.frequencies();
+    const Basis basis = makeBasis(poles, grid.omega, false);
+    const int n = basis.columns;
+
+    std::vector<double> sigma(ng);
+    std::vector<double> weights(ng);
+    std::vector<double> weighted(basis.values.size());
+    grid.re.resize(size_t(entries) * ng);
+    grid.im.resize(size_t(entries) * ng);
+
+    for (int iteration = 0;; ++iteration) {
+        std::fill(grid.re.begin(), grid.re.end(), 0.0);
+        std::fill(grid.im.begin(), grid.im.end(), 0.0);
+
+        const bool screen = iteration < maxIterations;
+        parallelFor<EntryScratch>(ng, threads, [&](int g, EntryScratch &w) {
+            w.re.assign(constant.begin(), constant.end());
+            w.im.assign(entries, 0.0);
+            for (int e = 0; e < entries; ++e) {
+                const double *coefficient = coefficients.data() + size_t(e) * n;
+                double re = 0.0;
+                double im = 0.0;
+                for (int c = 0; c < n; ++c) {
+                    re += coefficient[c] * basis.column(c)[g];
+                    im += coefficient[c] * basis.column(c)[ng + g];
+                }
+                w.re[e] += re;
+                w.im[e] += im;
+            }
+
+            if (screen && singularValuesBelow(w.re.data(), w.im.data(), ports, 1.0 - margin, w.u)) {
+                sigma[g] = 0.0;
+                return;
+            }
+            if (!screen) {
+                sigma[g] = SParameterChecks::largestSingularValue(w.re.data(), w.im.data(), ports);
+                return;
+            }
+
+            std::vector<Complex> matrix(entries);
+            for (int e = 0; e < entries; ++e)
+                matrix[e] = Complex(w.re[e], w.im[e]);
+            singularValueDecomposition(matrix.data(), ports, w.u, w.s, w.v);
+            sigma[g] = *std::max_element(w.s.begin(), w.s.end());
+            for (int i = 0; i < ports; ++i) {
+                const double excess = w.s[i] - (1.0 - margin);
+                if (excess <= 0.0)
+                    continue;
+                for (int r = 0; r < ports; ++r) {
+                    for (int c = 0; c < ports; ++c) {
+                        const Complex delta = excess * w.u[size_t(i) * ports + r] *
+                                              std::conj(w.v[size_t(i) * ports + c]);
+                        grid.re[size_t(r * ports + c) * ng + g] += delta.real();
+                        grid.im[size_t(r * ports + c) * ng + g] += delta.imag();
+                    }
+                }
+            }
+        });
+
+        maxSigma = *std::max_element(sigma.begin(), sigma.end());
+        if (!screen)
+            return maxSigma <= 1.0;
+        if (maxSigma <= 1.0) {
+            // Passive on the grid; one more pass without corrections reports the largest singular value.
+            maxIterations = iteration;
+            continue;
+        }
+
+        // The few violating samples weigh as much as all others, or the fit dilutes their correction.
+        const int violations = int(std::count_if(sigma.begin(), sigma.end(),
+                                                 [margin](double value) { return value > 1.0 - margin; }));
+        const double heavy = std::sqrt(qMax(1.0, double(ng - violations) / violations));
+        for (int g = 0; g < ng; ++g)
+            weights[g] = sigma[g] > 1.0 - margin ? heavy : 1.0;
+        for (int c = 0; c < n; ++c) {
+            for (int g = 0; g < ng; ++g) {
+                weighted[size_t(c) * 2 * ng + g] = weights[g] * basis.column(c)[g];
+                weighted[size_t(c) * 2 * ng + ng + g] = weights[g] * basis.column(c)[ng + g];
+            }
+        }
+        const ThinQr qr = thinQr(weighted.data(), basis.rows(), n);
+
+        parallelFor<EntryScratch>(entries, threads, [&](int e, EntryScratch &w) {
+            w.rhs.resize(2 * ng);
+            for (int g = 0; g < ng; ++g) {
+                w.rhs[g] = weights[g] * grid.re[size_t(e) * ng + g];
+                w.rhs[ng + g] = weights[g] * grid.im[size_t(e) * ng + g];
+            }
+            w.solution.resize(n);
+            w.work.resize(n);
+            solveLeastSquares(qr, w.rhs.data(), w.solution.data(), w.work.data());
+            axpy(-1.0, w.solution.data(), coefficients.data() + size_t(e) * n, n);
+        });
+    }
+}
+
+QByteArray number(double value)
+{
+    return QByteArray::number(value, 'g', 12);
+}
+
+} // namespace
+
+/*!*******************************************************************************************************************
+ * \brief Returns whether the model has poles and consistently sized residues and constant terms.
+ **********************************************************************************************************************/
+bool VectorFit::Model::isValid() const
+{
+    return ports > 0 && !poles.isEmpty() && residues.size() == ports * ports * poles.size() &&
+           constant.size() == ports * ports;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the model order: the number of poles, counting conjugate pairs twice.
+ **********************************************************************************************************************/
+int VectorFit::Model::order() const
+{
+    return realColumns(poles);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Evaluates one entry of the model at \a frequency (Hz).
+ **********************************************************************************************************************/
+Touchstone::Complex VectorFit::Model::value(double frequency, int row, int column) const
+{
+    const Complex s(0.0, 2.0 * M_PI * frequency);
+    const int entry = row * ports + column;
+    const Complex *r = residues.constData() + size_t(entry) * poles.size();
+
+    Complex sum = constant.at(entry);
+    for (int n = 0; n < poles.size(); ++n) {
+        const Complex &p = poles.at(n);
+        sum += r[n] / (s - p);
+        if (p.imag() > 0.0)
+            sum += std::conj(r[n]) / (s - std::conj(p));
+    }
+    return sum;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Evaluates the model at \a frequencies (Hz).
+ **********************************************************************************************************************/
+Touchstone::Network VectorFit::Model::evaluate(const QVector<double> &frequencies) const
+{
+    Touchstone::Network network;
+    network.resize(ports, frequencies.size());
+    network.frequencies = frequencies;
+    if (references.size() == ports)
+        network.references = references;
+
+    for (int f = 0; f < frequencies.size(); ++f) {
+        for (int row = 0; row < ports; ++row) {
+            for (int column = 0; column < ports; ++column)
+                network.setValue(f, row, column, value(frequencies.at(f), row, column));
+        }
+    }
+    return network;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns one line each for model order, fit error and passivity.
+ **********************************************************************************************************************/
+QStringList VectorFit::Model::summary() const
+{
+    QStringList lines;
+    lines << QString("order:     %1 poles (%2 relocation iterations)").arg(order()).arg(iterations);
+    lines << QString("fit error: RMS %1, max %2").arg(rmsError, 0, 'g', 3).arg(maxError, 0, 'g', 3);
+    lines << QString("passivity: %1 (max singular value %2)")
+                 .arg(passive ? QStringLiteral("PASS") : QStringLiteral("FAIL"))
+                 .arg(maxSingularValue, 0, 'f', 6);
+    return lines;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Fits a rational model to S-parameters.
+ *
+ * \param network  S-parameters with ascending frequencies.
+ * \param options  Model order, iteration limits, passivity enforcement and thread count.
+ * \param out      Receives the model.
+ * \param outError Human-readable error message in case of failure.
+ * \return True on success; false otherwise. A model that could not be made passive is still returned, with
+ *         \c passive set to false.
+ **********************************************************************************************************************/
+bool VectorFit::fit(const Touchstone::Network &network, const Options &options, Model &out, QString &outError)
+{
+    if (!network.isValid()) {
+        outError = QStringLiteral("Nothing to fit");
+        return false;
+    }
+    if (network.parameter != QLatin1Char('S')) {
+        outError = QString("Vector fitting needs S-parameters, not %1-parameters").arg(network.parameter);
+        return false;
+    }
+    if (options.poles < 1 || network.frequencyCount() <= options.poles + 1) {
+        outError = QString("Fitting %1 poles needs more than %2 frequency points")
+                       .arg(options.poles)
+                       .arg(options.poles + 1);
+        return false;
+    }
+
+    const int ports = network.ports;
+    const int ns = network.frequencyCount();
+    const double fMax = network.frequencies.last();
+    if (!(fMax > 0.0)) {
+        outError = QStringLiteral("The highest frequency must be positive");
+        return false;
+    }
+
+    Samples data;
+    data.entries = ports * ports;
+    data.omega.resize(ns);
+    data.re.resize(size_t(data.entries) * ns);
+    data.im.resize(size_t(data.entries) * ns);
+    for (int k = 0; k < ns; ++k) {
+        data.omega[k] = network.frequencies.at(k) / fMax;
+        const Complex *row = network.values.constData() + size_t(k) * data.entries;
+        for (int e = 0; e < data.entries; ++e) {
+            data.re[size_t(e) * ns + k] = row[e].real();
+            data.im[size_t(e) * ns + k] = row[e].imag();
+        }
+    }
+
+    const int threads = parallelThreadCount(options.threads);
+
+    Model model;
+    model.ports = ports;
+    model.references = network.references;
+
+    const Samples compressed = compress(data, threads);
+    QVector<Complex> poles = startingPoles(options.poles, data.omega.front());
+    for (int iteration = 0; iteration < options.maxIterations; ++iteration) {
+        QVector<Complex> next;
+        double deviation = 0.0;
+        if (!relocatePoles(poles, compressed, threads, true, next, deviation))
+            break;
+        ++model.iterations;
+        poles = next;
+        if (deviation < options.tolerance)
+            break;
+    }
+
+    std::vector<double> coefficients;
+    std::vector<double> constant;
+    fitResidues(poles, data, threads, coefficients, constant);
+
+    model.passive = enforcePassivity(poles, ports, ns, options.enforcePassivity ? options.maxPassivityIterations : 0,
+                                     options.passivityMargin, threads, coefficients, constant,
+                                     model.maxSingularValue);
+    fitErrors(poles, data, threads, coefficients, constant, model.rmsError, model.maxError);
+
+    // Back to rad/s: r / (s/w0 - a) = r w0 / (s - a w0).
+    const double w0 = 2.0 * M_PI * fMax;
+    const int n = realColumns(poles);
+    model.poles.reserve(poles.size());
+    for (const Complex &p : qAsConst(poles))
+        model.poles << p * w0;
+    model.residues.resize(data.entries * poles.size());
+    model.constant.resize(data.entries);
+    for (int e = 0; e < data.entries; ++e) {
+        const double *c = coefficients.data() + size_t(e) * n;
+        int column = 0;
+        for (int i = 0; i < poles.size(); ++i) {
+            const bool pair = poles.at(i).imag() > 0.0;
+            model.residues[e * poles.size() + i] = Complex(c[column], pair ? c[column + 1] : 0.0) * w0;
+            column += pair ? 2 : 1;
+        }
+        model.constant[e] = constant[e];
+    }
+
+    out = model;
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Serializes a model as JSON: poles (rad/s, one entry per conjugate pair), residues per matrix entry and
+ *        constant terms, plus the fit and passivity figures.
+ **********************************************************************************************************************/
+QByteArray VectorFit::toJson(const Model &model)
+{
+    auto complexValue = [](const Complex &z) { return QJsonArray{ z.real(), z.imag() }; };
+
+    QJsonArray references;
+    for (double z : model.references)
+        references.append(z);
+
+    QJsonArray poles;
+    for (const Complex &p : model.poles)
+        poles.append(complexValue(p));
+
+    QJsonArray constant;
+    QJsonArray residues;
+    for (int row = 0; row < model.ports; ++row) {
+        QJsonArray constantRow;
+        QJsonArray residueRow;
+        for (int column = 0; column < model.ports; ++column) {
+            const int entry = row * model.ports + column;
+            constantRow.append(model.constant.at(entry));
+            QJsonArray entryResidues;
+            for (int n = 0; n < model.poles.size(); ++n)
+                entryResidues.append(complexValue(model.residues.at(entry * model.poles.size() + n)));
+            residueRow.append(entryResidues);
+        }
+        constant.append(constantRow);
+        residues.append(residueRow);
+    }
+
+    QJsonObject root;
+    root["format"]             = QStringLiteral("pole-residue");
+    root["description"]        = QStringLiteral("S(s) = constant + sum residue / (s - pole), s in rad/s; poles with "
+                                                "positive imaginary part stand for a conjugate pair");
+    root["ports"]              = model.ports;
+    root["references"]         = references;
+    root["poles"]              = poles;
+    root["residues"]           = residues;
+    root["constant"]           = constant;
+    root["iterations"]         = model.iterations;
+    root["rms_error"]          = model.rmsError;
+    root["max_error"]          = model.maxError;
+    root["max_singular_value"] = model.maxSingularValue;
+    root["passive"]            = model.passive;
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes a model as SPICE subcircuit with the terminals p1 ... pN and the common reference node ref.
+ *
+ * Every port is a resistor Z0 in series with a voltage source 2 sqrt(Z0) b; the incident wave
+ * a = (V + Z0 I) / (2 sqrt(Z0)) and the reflected waves b = D a + sum of states are nodes with 1 ohm to ref
+ * driven by voltage controlled current sources. Each pole and input port has one state node (two per conjugate
+ * pair) built from a capacitor 1/|p|, a resistor and controlled sources, scaled so that the state voltages stay of
+ * the order of the waves. Only R, C, E and G elements are used, so any SPICE dialect reads the netlist.
+ **********************************************************************************************************************/
+QByteArray VectorFit::toSpice(const Model &model, const QString &name)
+{
+    QString subckt = name;
+    subckt.replace(QRegularExpression(QStringLiteral("[^A-Za-z0-9_]")), QStringLiteral("_"));
+    if (subckt.isEmpty() || subckt.at(0).isDigit())
+        subckt.prepend(QStringLiteral("m_"));
+
+    const int ports = model.ports;
+    const QByteArray ref = "ref";
+    auto idx = [](int i) { return QByteArray::number(i + 1); };
+    auto line = [](const QByteArray &element, const QByteArray &n1, const QByteArray &n2, const QByteArray &rest) {
+        return element + ' ' + n1 + ' ' + n2 + ' ' + rest + '\n';
+    };
+    // Current gain * V(control) into node.
+    auto inject = [&](const QByteArray &element, const QByteArray &node, const QByteArray &control, double gain) {
+        return line(element, ref, node, control + ' ' + ref + ' ' + number(gain));
+    };
+
+    QByteArray out;
+    out += "* " + subckt.toUtf8() + ": rational S-parameter macromodel, " + QByteArray::number(ports) + " ports, " +
+           QByteArray::number(model.order()) + " poles\n";
+    out += "* Fitted by EMStudio: RMS error " + number(model.rmsError) + ", max singular value " +
+           number(model.maxSingularValue) + (model.passive ? " (passive)\n" : " (NOT passive)\n");
+    out += ".SUBCKT " + subckt.toUtf8();
+    for (int i = 0; i < ports; ++i)
+        out += " p" + idx(i);
+    out += ' ' + ref + '\n';
+
+    for (int j = 0; j < ports; ++j) {
+        const double z0 = model.references.size() == ports ? model.references.at(j) : 50.0;
+        const QByteArray p = "p" + idx(j);
+        const QByteArray n = "n" + idx(j);
+        const QByteArray a = "a" + idx(j);
+        const QByteArray b = "b" + idx(j);
+
+        out += "* port " + idx(j) + ", Z0 = " + number(z0) + " ohm\n";
+        out += line("RP" + idx(j), p, n, number(z0));
+        out += line("EP" + idx(j), n, ref, b + ' ' + ref + ' ' + number(2.0 * std::sqrt(z0)));
+        out += line("RA" + idx(j), a, ref, "1");
+        out += inject("GA" + idx(j) + "P", a, p, 1.0 / std::sqrt(z0));
+        out += inject("GA" + idx(j) + "N", a, n, -0.5 / std::sqrt(z0));
+        out += line("RB" + idx(j), b, ref, "1");
+    }
+
+    for (int j = 0; j < ports; ++j) {
+        out += "* states driven by a" + idx(j) + '\n';
+        for (int k = 0; k < model.poles.size(); ++k) {
+            const Complex &p = model.poles.at(k);
+            const double w = std::abs(p);
+            const QByteArray x = "x" + idx(j) + '_' + idx(k);
+            out += line("C" + x, x, ref, number(1.0 / w));
+            out += line("R" + x, x, ref, number(w / -p.real()));
+            out += inject("G" + x, x, "a" + idx(j), 1.0);
+            if (p.imag() > 0.0) {
+                const QByteArray y = x + 'i';
+                out += inject("G" + x + 'C', x, y, p.imag() / w);
+                out += line("C" + y, y, ref, number(1.0 / w));
+                out += line("R" + y, y, ref, number(w / -p.real()));
+                out += inject("G" + y + 'C', y, x, -p.imag() / w);
+            }
+        }
+    }
+
+    for (int i = 0; i < ports; ++i) {
+        out += "* reflected wave b" + idx(i) + '\n';
+        for (int j = 0; j < ports; ++j) {
+            const int entry = i * ports + j;
+            const QByteArray element = "GB" + idx(i) + '_' + idx(j);
+            if (model.constant.at(entry) != 0.0)
+                out += inject(element, "b" + idx(i), "a" + idx(j), model.constant.at(entry));
+            for (int k = 0; k < model.poles.size(); ++k) {
+                const Complex &p = model.poles.at(k);
+                const Complex &r = model.residues.at(entry * model.poles.size() + k);
+                const double w = std::abs(p);
+                const QByteArray x = "x" + idx(j) + '_' + idx(k);
+                if (p.imag() > 0.0) {
+                    out += inject(element + '_' + idx(k), "b" + idx(i), x, 2.0 * r.real() / w);
+                    out += inject(element + '_' + idx(k) + 'i', "b" + idx(i), x + 'i', 2.0 * r.imag() / w);
+                } else {
+                    out += inject(element + '_' + idx(k), "b" + idx(i), x, r.real() / w);
+                }
+            }
+        }
+    }
+
+    out += ".ENDS " + subckt.toUtf8() + '\n';
+    return out;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes toJson() of \a model to \a path.
+ **********************************************************************************************************************/
+bool VectorFit::writeJson(const QString &path, const Model &model, QString &outError)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(toJson(model)) < 0 || !file.commit()) {
+        outError = QString("Cannot write model file %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Writes toSpice() of \a model to \a path; the subcircuit is named after the file.
+ **********************************************************************************************************************/
+bool VectorFit::writeSpice(const QString &path, const Model &model, QString &outError)
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text) ||
+        file.write(toSpice(model, QFileInfo(path).completeBaseName())) < 0 || !file.commit()) {
+        outError = QString("Cannot write netlist %1").arg(QDir::toNativeSeparators(path));
+        return false;
+    }
+    return true;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Eigenvalues of a real square matrix.
+ *
+ * Householder reduction to Hessenberg form followed by complex QR iteration with Wilkinson shifts (and an
+ * exceptional shift every tenth step) and deflation; only the active block is updated, as no vectors are needed.
+ *
+ * \param matrix Row-major n x n matrix.
+ * \param n      Dimension.
+ * \param out    Receives the n eigenvalues.
+ * \return False if the iteration did not converge.
+ **********************************************************************************************************************/
+bool VectorFit::eigenvalues(const double *matrix, int n, QVector<Touchstone::Complex> &out)
+{
+    out.clear();
+    if (n <= 0)
+        return true;
+
+    std::vector<double> a(matrix, matrix + size_t(n) * n);
+    std::vector<double> v(n);
+    for (int k = 0; k + 2 < n; ++k) {
+        double alpha = 0.0;
+        for (int i = k + 1; i < n; ++i)
+            alpha += a[size_t(i) * n + k] * a[size_t(i) * n + k];
+        alpha = std::sqrt(alpha);
+        if (alpha == 0.0)
+            continue;
+        if (a[size_t(k + 1) * n + k] > 0.0)
+            alpha = -alpha;
+
+        double norm2 = 0.0;
+        for (int i = k + 1; i < n; ++i) {
+            v[i] = a[size_t(i) * n + k] - (i == k + 1 ? alpha : 0.0);
+            norm2 += v[i] * v[i];
+        }
+        if (norm2 == 0.0)
+            continue;
+
+        for (int j = 0; j < n; ++j) {
+            double s = 0.0;
+            for (int i = k + 1; i < n; ++i)
+                s += v[i] * a[size_t(i) * n + j];
+            s *= 2.0 / norm2;
+            for (int i = k + 1; i < n; ++i)
+                a[size_t(i) * n + j] -= s * v[i];
+        }
+        for (int i = 0; i < n; ++i) {
+            double s = 0.0;
+            for (int j = k + 1; j < n; ++j)
+                s += a[size_t(i) * n + j] * v[j];
+            s *= 2.0 / norm2;
+            for (int j = k + 1; j < n; ++j)
+                a[size_t(i) * n + j] -= s * v[j];
+        }
+    }
+
+    std::vector<Complex> h(size_t(n) * n);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j)
+            h[size_t(i) * n + j] = j + 1 >= i ? a[size_t(i) * n + j] : 0.0;
+    }
+    auto at = [&](int i, int j) -> Complex & { return h[size_t(i) * n + j]; };
+
+    const double eps = std::numeric_limits<double>::epsilon();
+    std::vector<double> cs(n);
+    std::vector<Complex> sn(n);
+    QVector<Complex> result(n);
+
+    int hi = n - 1;
+    int iteration = 0;
+    while (hi >= 0) {
+        int l = hi;
+        while (l > 0) {
+            const double scale = std::abs(at(l, l)) + std::abs(at(l - 1, l - 1));
+            if (std::abs(at(l, l - 1)) <= eps * scale) {
+                at(l, l - 1) = 0.0;
+                break;
+            }
+            --l;
+        }
+        if (l == hi) {
+            result[hi] = at(hi, hi);
+            --hi;
+            iteration = 0;
+            continue;
+        }
+        if (++iteration > kMaxQrIterations)
+            return false;
+
+        const Complex a11 = at(hi - 1, hi - 1);
+        const Complex a12 = at(hi - 1, hi);
+        const Complex a21 = at(hi, hi - 1);
+        const Complex a22 = at(hi, hi);
+        Complex mu;
+        if (iteration % 10 == 0) {
+            mu = a22 + std::abs(a21);
+        } else {
+            const Complex half = 0.5 * (a11 + a22);
+            const Complex disc = std::sqrt(half * half - (a11 * a22 - a12 * a21));
+            const Complex m1 = half + disc;
+            const Complex m2 = half - disc;
+            mu = std::abs(m1 - a22) < std::abs(m2 - a22) ? m1 : m2;
+        }
+
+        for (int k = l; k <= hi; ++k)
+            at(k, k) -= mu;
+        for (int k = l; k < hi; ++k) {
+            const Complex x = at(k, k);
+            const Complex y = at(k + 1, k);
+            const double ax = std::abs(x);
+            const double r = std::hypot(ax, std::abs(y));
+            double c = 1.0;
+            Complex s;
+            if (r > 0.0) {
+                c = ax / r;
+                s = (ax > 0.0 ? x / ax : Complex(1.0)) * std::conj(y) / r;
+            }
+            cs[k] = c;
+            sn[k] = s;
+            for (int j = k; j <= hi; ++j) {
+                const Complex p = at(k, j);
+                const Complex q = at(k + 1, j);
+                at(k, j) = c * p + s * q;
+                at(k + 1, j) = -std::conj(s) * p + c * q;
+            }
+        }
+        for (int k = l; k < hi; ++k) {
+            const double c = cs[k];
+            const Complex s = sn[k];
+            for (int i = l; i <= qMin(k + 2, hi); ++i) {
+                const Complex p = at(i, k);
+                const Complex q = at(i, k + 1);
+                at(i, k) = c * p + std::conj(s) * q;
+                at(i, k + 1) = -s * p + c * q;
+            }
+        }
+        for (int k = l; k <= hi; ++k)
+            at(k, k) += mu;
+    }
+
+    out = result;
+    return true;
+}
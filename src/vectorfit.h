@@ -0,0 +1,98 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ ************************************************************************/
+
+#ifndef VECTORFIT_H
+#define VECTORFIT_H
+
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QStringList>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \class VectorFit
+ * \brief Rational macromodels of S-parameter results by vector fitting, with passivity enforcement and SPICE export.
+ *
+ * All entries of S share one set of stable poles; every entry has its own residues and a constant term:
+ * S_ij(s) = d_ij + sum_n r_ijn / (s - p_n).
+ *
+ * - Pole relocation uses relaxed vector fitting (Gustavsen 2006). The unknowns of the partial-fraction part are
+ *   the same basis for every entry, so its QR factorization is computed once per iteration; each entry only
+ *   projects its sigma columns onto the orthogonal complement and contributes a small Gram matrix (fast VF,
+ *   Deschrijver et al. 2008). The entries run in parallel; the new poles are the eigenvalues of A - b c^T / d.
+ *   Unstable poles are mirrored into the left half plane. Many-port results are first compressed to the dominant
+ *   real combinations of their entries, which share the poles of the entries.
+ * - The final residues are a linear least-squares fit per entry with the same factorization.
+ * - Passivity is enforced by singular value perturbation: the model is sampled on a dense grid up to twice the
+ *   highest frequency and at its resonances, singular values above one are pushed below 1 - passivityMargin and
+ *   the residues are corrected by the least-squares fit of that perturbation, until no violation is left.
+ *
+ * Frequencies are normalized to the highest frequency during fitting. Models are written as JSON (poles and
+ * residues) or as SPICE subcircuit built from R, C and controlled sources only.
+ **********************************************************************************************************************/
+class VectorFit
+{
+public:
+    struct Options
+    {
+        int                     poles = 16;                     // complex pairs, plus one real pole if odd
+        int                     maxIterations = 20;             // pole relocation iterations
+        double                  tolerance = 1e-6;               // relocation ends when max |sigma - 1| is below
+        bool                    enforcePassivity = true;
+        int                     maxPassivityIterations = 50;
+        double                  passivityMargin = 1e-3;
+        int                     threads = 0;                    // 0 = hardware concurrency
+    };
+
+    struct Model
+    {
+        int                     ports = 0;
+        QVector<double>         references;                     // ohms, one per port
+        QVector<Touchstone::Complex> poles;                     // rad/s; Im > 0 stands for a conjugate pair
+        QVector<Touchstone::Complex> residues;                  // [row][column][pole]
+        QVector<double>         constant;                       // [row][column]
+
+        int                     iterations = 0;
+        double                  rmsError = 0.0;
+        double                  maxError = 0.0;
+        double                  maxSingularValue = 0.0;         // on the passivity grid
+        bool                    passive = false;
+
+        bool                    isValid() const;
+        int                     order() const;
+        Touchstone::Complex     value(double frequency, int row, int column) const;
+        Touchstone::Network     evaluate(const QVector<double> &frequencies) const;
+        QStringList             summary() const;
+    };
+
+    static bool                 fit(const Touchstone::Network &network, const Options &options, Model &out,
+                                    QString &outError);
+
+    static QByteArray           toJson(const Model &model);
+    static QByteArray           toSpice(const Model &model, const QString &name);
+    static bool                 writeJson(const QString &path, const Model &model, QString &outError);
+    static bool                 writeSpice(const QString &path, const Model &model, QString &outError);
+
+    static bool                 eigenvalues(const double *matrix, int n, QVector<Touchstone::Complex> &out);
+};
+
+#endif // VECTORFIT_H
@@ -8,6 +8,9 @@
 #include <QProcess>
 
 #include "mainwindow.h"
+#include "simulationlog.h"
+#include "simulationrunner.h"
+#include "simulationloganalyzer.h"
 #include "ui_mainwindow.h"
 
 /*!*******************************************************************************************************************
@@ -356,19 +359,17 @@ QString MainWindow::testWriteEditorToTempPyFile(const QString& fileNameHint) con
  **********************************************************************************************************************/
 QString MainWindow::testSimulationLogText() const
 {
-    return (m_ui && m_ui->editSimulationLog)
-    ? m_ui->editSimulationLog->toPlainText()
-    : QString();
+    return m_simLog ? m_simLog->text() : QString();
 }
 
 /*!*******************************************************************************************************************
  * \brief Returns whether a simulation process is currently running.
  *
- * \return True if m_simProcess exists and is running, false otherwise.
+ * \return True if the simulation runner has a running process, false otherwise.
  **********************************************************************************************************************/
 bool MainWindow::testIsSimulationRunning() const
 {
-    return m_simProcess && m_simProcess->state() == QProcess::Running;
+    return m_runner->isRunning();
 }
 
 /*!*******************************************************************************************************************
@@ -432,26 +433,6 @@ void MainWindow::testRunPalace(bool interactive)
     runPalace(interactive);
 }
 
-/*!*******************************************************************************************************************
- * \brief Starts headless backend dispatch from tests without exposing private production API.
- *
- * \param simKeyLower Backend key to dispatch ("palace", "openems", or other).
- **********************************************************************************************************************/
-void MainWindow::testRunHeadless(const QString& simKeyLower)
-{
-    runHeadless(simKeyLower);
-}
-
-/*!*******************************************************************************************************************
- * \brief Returns whether MainWindow is currently in headless mode.
- *
- * \return True if headless mode is enabled, false otherwise.
- **********************************************************************************************************************/
-bool MainWindow::testIsHeadless() const
-{
-    return m_headless;
-}
-
 /*!*******************************************************************************************************************
  * \brief Exposes toLinuxPathPortable() for automated tests.
  *
@@ -530,6 +511,52 @@ void MainWindow::testClickAddPort()
     on_btnAddPort_clicked();
 }
 
+/*!*******************************************************************************************************************
+ * \brief Proposes ports from a GDS file in test mode.
+ *
+ * Rebuilds the layer mapping from the current substrate before proposing.
+ *
+ * \param gdsPath    GDS file to scan.
+ * \param topCell    Cell to scan, or empty for all cells.
+ * \param portLayers Port layers, or empty for all non-substrate layers.
+ * \param outError   Optional error output.
+ * \return Proposed ports.
+ **********************************************************************************************************************/
+QVector<MainWindow::PortInfo> MainWindow::testProposePortsFromGds(const QString& gdsPath,
+                                                                  const QString& topCell,
+                                                                  const QSet<int>& portLayers,
+                                                                  QString* outError)
+{
+    rebuildLayerMapping();
+
+    QString err;
+    const auto ports = proposePortsFromGds(gdsPath, topCell, portLayers, err);
+    if (outError)
+        *outError = err;
+    return ports;
+}
+
+/*!*******************************************************************************************************************
+ * \brief Returns the formatted diff between proposed ports and the ports in the editor script.
+ *
+ * \param proposed Proposed ports.
+ * \return Diff text as produced by formatPortDiff().
+ **********************************************************************************************************************/
+QString MainWindow::testDiffProposedPorts(const QVector<PortInfo>& proposed)
+{
+    return formatPortDiff(diffPorts(parsePortsFromScript(m_ui->editRunPythonScript->toPlainText()), proposed));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Bulk-inserts proposed ports into the Ports table in test mode.
+ *
+ * \param proposed Ports to insert.
+ **********************************************************************************************************************/
+void MainWindow::testApplyProposedPorts(const QVector<PortInfo>& proposed)
+{
+    applyProposedPorts(proposed);
+}
+
 /*!*******************************************************************************************************************
  * \brief Calls on_btnReomovePort_clicked() in test mode.
  **********************************************************************************************************************/
@@ -614,9 +641,11 @@ bool MainWindow::testBuildPalaceRunContext(QString* outError,
     if (outError)
         *outError = QString();
 
-    PalaceRunContext ctx;
+    syncRunnerState();
+
+    SimulationRunner::PalaceRunContext ctx;
     QString err;
-    const bool ok = buildPalaceRunContext(ctx, err);
+    const bool ok = m_runner->buildPalaceRunContext(ctx, err);
 
     if (!ok) {
         if (outError)
@@ -643,15 +672,19 @@ bool MainWindow::testBuildPalaceRunContext(QString* outError,
 /*!*******************************************************************************************************************
  * \brief Sets simulation log text directly for tests.
  *
- * \param text Full log text to place into editSimulationLog.
+ * \param text Full log text to place into the simulation log.
  **********************************************************************************************************************/
 void MainWindow::testSetSimulationLogText(const QString& text)
 {
-    if (!m_ui || !m_ui->editSimulationLog)
+    if (!m_simLog)
         return;
 
-    QSignalBlocker b(m_ui->editSimulationLog);
-    m_ui->editSimulationLog->setPlainText(text);
+    clearSimulationLog();
+    m_simLog->appendText(text);
+    m_simLog->flush();
+
+    m_runner->logAnalyzer()->feed(text.toUtf8());
+    m_runner->logAnalyzer()->finish();
 }
 
 /*!*******************************************************************************************************************
@@ -659,7 +692,7 @@ void MainWindow::testSetSimulationLogText(const QString& text)
  **********************************************************************************************************************/
 QString MainWindow::testDetectRunDirFromLog() const
 {
-    return detectRunDirFromLog();
+    return m_runner->detectRunDirFromLog();
 }
 
 /*!*******************************************************************************************************************
@@ -668,7 +701,7 @@ QString MainWindow::testDetectRunDirFromLog() const
 QString MainWindow::testGuessDefaultPalaceRunDir(const QString& modelFile,
                                                  const QString& baseName) const
 {
-    return guessDefaultPalaceRunDir(modelFile, baseName);
+    return m_runner->guessDefaultPalaceRunDir(modelFile, baseName);
 }
 
 /*!*******************************************************************************************************************
@@ -677,7 +710,7 @@ QString MainWindow::testGuessDefaultPalaceRunDir(const QString& modelFile,
 QString MainWindow::testChooseSearchDir(const QString& detectedRunDir,
                                         const QString& defaultRunDir) const
 {
-    return chooseSearchDir(detectedRunDir, defaultRunDir);
+    return m_runner->chooseSearchDir(detectedRunDir, defaultRunDir);
 }
 
 /*!*******************************************************************************************************************
@@ -685,7 +718,7 @@ QString MainWindow::testChooseSearchDir(const QString& detectedRunDir,
  **********************************************************************************************************************/
 QString MainWindow::testFindPalaceConfigJson(const QString& runDir) const
 {
-    return findPalaceConfigJson(runDir);
+    return m_runner->findPalaceConfigJson(runDir);
 }
 
 /*!*******************************************************************************************************************
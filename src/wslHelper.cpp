@@ -5,7 +5,7 @@
 #include <QStandardPaths>
 
 #include "wslHelper.h"
-#include "mainwindow.h"
+#include "pathprobe.h"
 
 /*!*******************************************************************************************************************
  * \brief Quotes a string for safe use as a single-quoted literal in bash.
@@ -26,91 +26,6 @@ QString shellQuoteSingle(const QString &s)
 
 #ifdef Q_OS_WIN
 
-/*!*******************************************************************************************************************
- * \brief Checks whether a file system path is readable inside a WSL distribution.
- *
- * Executes \c test -r <path> inside the given WSL distro and returns true
- * if the path exists and is readable.
- *
- * \param distro    WSL distribution name (e.g. "Ubuntu").
- * \param linuxPath Absolute Linux path inside WSL.
- * \param timeoutMs Maximum time to wait for completion, in milliseconds.
- * \return True if the path is readable inside WSL; false otherwise.
- **********************************************************************************************************************/
-static bool wslPathIsReadable(const QString &distro, const QString &linuxPath, int timeoutMs)
-{
-    const QString cmd = QString("test -r %1 && echo 1 || echo 0").arg(shellQuoteSingle(linuxPath));
-    const QString out = runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs);
-    return out.trimmed() == QLatin1String("1");
-}
-
-/*!*******************************************************************************************************************
- * \brief Converts a Windows path to a Linux path suitable for WSL, preserving Linux paths.
- *
- * On Windows:
- *  - If \a path starts with '/', it is assumed to be already a Linux path (WSL) and returned as-is.
- *  - Otherwise, \c wslpath -a is used inside the selected WSL distro to convert the Windows path
- *    into an absolute Linux path.
- *
- * \param path      Input path (Windows path or WSL absolute path).
- * \param distro    WSL distribution name.
- * \param timeoutMs Timeout for WSL conversion in milliseconds.
- * \return Linux/WSL absolute path on success; empty string on failure.
- **********************************************************************************************************************/
-static QString toLinuxPathForWsl(const QString &path, const QString &distro, int timeoutMs)
-{
-    const QString p = path.trimmed();
-    if (p.isEmpty())
-        return QString();
-
-    if (p.startsWith('~') || p.startsWith('/'))
-        return p;
-
-    const QString cmd =
-        QString("wslpath -a %1").arg(shellQuoteSingle(QDir::toNativeSeparators(p)));
-
-    const QString out =
-        runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs);
-
-    return out.trimmed();
-}
-
-/*!*******************************************************************************************************************
- * \brief Checks whether a file system path exists inside a WSL distribution.
- *
- * Executes \c test -e <path> inside the given WSL distro and returns true
- * if the path exists (file or directory).
- *
- * \param distro    WSL distribution name (e.g. "Ubuntu").
- * \param linuxPath Absolute Linux path inside WSL (e.g. "/home/...", "/mnt/c/...").
- * \param timeoutMs Maximum time to wait for completion, in milliseconds.
- * \return True if the path exists inside WSL; false otherwise.
- **********************************************************************************************************************/
-static bool wslPathExists(const QString &distro, const QString &linuxPath, int timeoutMs)
-{
-    const QString cmd = QString("test -e %1 && echo 1 || echo 0").arg(shellQuoteSingle(linuxPath));
-    const QString out = runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs);
-    return out.trimmed() == QLatin1String("1");
-}
-
-/*!*******************************************************************************************************************
- * \brief Checks whether a file system path is executable inside a WSL distribution.
- *
- * Executes \c test -x <path> inside the given WSL distro and returns true
- * if the path exists and is executable.
- *
- * \param distro    WSL distribution name (e.g. "Ubuntu").
- * \param linuxPath Absolute Linux path inside WSL.
- * \param timeoutMs Maximum time to wait for completion, in milliseconds.
- * \return True if the path is executable inside WSL; false otherwise.
- **********************************************************************************************************************/
-static bool wslPathIsExecutable(const QString &distro, const QString &linuxPath, int timeoutMs)
-{
-    const QString cmd = QString("test -x %1 && echo 1 || echo 0").arg(shellQuoteSingle(linuxPath));
-    const QString out = runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs);
-    return out.trimmed() == QLatin1String("1");
-}
-
 /*!*******************************************************************************************************************
  * \brief Finds the absolute path to wsl.exe on Windows.
  *
@@ -350,40 +265,6 @@ QString runWslCmdCapture(const QString &distro,
     return QString::fromUtf8(p.readAllStandardOutput()).trimmed();
 }
 
-/*!*******************************************************************************************************************
- * \brief Checks whether a path exists in a platform-portable way (Windows / Linux / WSL).
- *
- * On Linux, this function delegates to \c QFileInfo::exists().
- *
- * On Windows:
- *  - If \a path starts with '/', it is treated as a WSL absolute path and checked
- *    inside the WSL distribution via \c test -e.
- *  - Otherwise it is treated as a Windows path and checked via \c QFileInfo::exists().
- *
- * \param path      Path to check (Windows path or WSL absolute path).
- * \param distro    WSL distribution name (Windows only; ignored on Linux).
- * \param timeoutMs Timeout for WSL checks in milliseconds (Windows only; ignored on Linux).
- * \return True if the path exists in the respective environment; false otherwise.
- **********************************************************************************************************************/
-bool MainWindow::pathExistsPortable(const QString &path, const QString &distro, int timeoutMs) const
-{
-#ifdef Q_OS_WIN
-    const QString p = path.trimmed();
-    if (p.isEmpty())
-        return false;
-
-    // WSL absolute path: /home/... or /mnt/c/...
-    if (p.startsWith('/') || p.startsWith('~'))
-        return wslPathExists(distro, p, timeoutMs);
-
-    return QFileInfo::exists(p);
-#else
-    Q_UNUSED(distro);
-    Q_UNUSED(timeoutMs);
-    return QFileInfo::exists(path);
-#endif
-}
-
 /*!*******************************************************************************************************************
  * \brief Checks whether a path is executable in a platform-portable way (Windows / Linux / WSL).
  *
@@ -391,7 +272,7 @@ bool MainWindow::pathExistsPortable(const QString &path, const QString &distro,
  *
  * On Windows:
  *  - If \a path starts with '/', it is treated as a WSL absolute path and checked
- *    inside the WSL distribution via \c test -x.
+ *    inside the WSL distribution via \c test -x (answers are cached by PathProbe).
  *  - Otherwise it is treated as a Windows path and checked via \c QFileInfo::isExecutable().
  *
  * \param path      Path to check (Windows path or WSL absolute path).
@@ -399,22 +280,9 @@ bool MainWindow::pathExistsPortable(const QString &path, const QString &distro,
  * \param timeoutMs Timeout for WSL checks in milliseconds (Windows only; ignored on Linux).
  * \return True if the path is executable in the respective environment; false otherwise.
  **********************************************************************************************************************/
-bool MainWindow::pathIsExecutablePortable(const QString &path, const QString &distro, int timeoutMs) const
+bool isExecutablePortable(const QString &path, const QString &distro, int timeoutMs)
 {
-#ifdef Q_OS_WIN
-    const QString p = path.trimmed();
-    if (p.isEmpty())
-        return false;
-
-    if (p.startsWith('/') || p.startsWith('~'))
-        return wslPathIsExecutable(distro, p, timeoutMs);
-
-    return QFileInfo(p).isExecutable();
-#else
-    Q_UNUSED(distro);
-    Q_UNUSED(timeoutMs);
-    return QFileInfo(path).isExecutable();
-#endif
+    return PathProbe::shared().isExecutable(path, distro, timeoutMs);
 }
 
 /*!*******************************************************************************************************************
@@ -431,32 +299,12 @@ bool isWslAvailable()
 
 /*!*******************************************************************************************************************
  * \brief Checks readability by trying local filesystem first, then WSL for Linux-style absolute paths.
+ *
+ * WSL answers are cached by PathProbe.
  **********************************************************************************************************************/
 bool isReadableLocalThenWsl(const QString &path, const QString &distro, int timeoutMs)
 {
-    const QString p = path.trimmed();
-    if (p.isEmpty())
-        return false;
-
-    // 1) First try locally (host FS)
-    if (QFileInfo(p).isReadable())
-        return true;
-
-#ifdef Q_OS_WIN
-    // 2) Fallback to WSL (convert Windows path if needed)
-    if (!isWslAvailable())
-        return false;
-
-    const QString linuxPath = toLinuxPathForWsl(p, distro, timeoutMs);
-    if (linuxPath.isEmpty())
-        return false;
-
-    return wslPathIsReadable(distro, linuxPath, timeoutMs);
-#else
-    Q_UNUSED(distro);
-    Q_UNUSED(timeoutMs);
-    return false;
-#endif
+    return PathProbe::shared().isReadable(path, distro, timeoutMs);
 }
 
 /*!*******************************************************************************************************************
@@ -467,37 +315,14 @@ bool isReadableLocalThenWsl(const QString &path, const QString &distro, int time
  * On Windows:
  *  - If \a path starts with '/', it is assumed to be already a Linux path (WSL) and returned as-is.
  *  - Otherwise, \c wslpath -a is used inside the selected WSL distro to convert the Windows path
- *    into an absolute Linux path.
+ *    into an absolute Linux path; translations are cached by PathProbe.
  *
  * \param path      Input path (Windows path or WSL absolute path).
  * \param distro    WSL distribution name (Windows only; ignored on Linux).
  * \param timeoutMs Timeout for WSL conversion in milliseconds (Windows only; ignored on Linux).
  * \return Linux/WSL absolute path on Windows; original \a path on Linux; empty string on failure.
  **********************************************************************************************************************/
-QString MainWindow::toLinuxPathPortable(const QString &path, const QString &distro, int timeoutMs) const
+QString toLinuxPathPortable(const QString &path, const QString &distro, int timeoutMs)
 {
-#ifdef Q_OS_WIN
-    const QString p = path.trimmed();
-    if (p.isEmpty())
-        return QString();
-
-    if (p.startsWith('/'))
-        return p;
-
-    if (p == QLatin1String("~") || p.startsWith("~/")) {
-        const QString tail = (p == QLatin1String("~")) ? QString() : p.mid(2);
-        const QString cmd = QString("printf '%s' \"$HOME%1\"")
-                                .arg(tail.isEmpty() ? QString() : QLatin1String("/") + tail);
-        return runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs).trimmed();
-    }
-
-    const QString cmd =
-        QString("wslpath -a %1").arg(shellQuoteSingle(QDir::toNativeSeparators(p)));
-
-    return runWslCmdCapture(distro, QStringList() << "bash" << "-lc" << cmd, timeoutMs).trimmed();
-#else
-    Q_UNUSED(distro);
-    Q_UNUSED(timeoutMs);
-    return path;
-#endif
+    return PathProbe::shared().toLinuxPath(path, distro, timeoutMs);
 }
@@ -23,6 +23,7 @@
 #include <QXmlStreamReader>
 
 #include "mainwindow.h"
+#include "tracer.h"
 
 /*!*******************************************************************************************************************
  * \brief Parses the given XML substrate file and extracts the names of all layers of type "conductor".
@@ -35,6 +36,7 @@
  **********************************************************************************************************************/
 QStringList MainWindow::readSubstrateLayers(const QString &xmlFilePath)
 {
+    EMSTUDIO_TRACE_SCOPE("substrate.readLayers", xmlFilePath);
     QStringList layerNames;
 
     QFile file(xmlFilePath);
@@ -68,6 +70,7 @@ QStringList MainWindow::readSubstrateLayers(const QString &xmlFilePath)
 
 QHash<int, QString> MainWindow::readSubstrateLayerMap(const QString &xmlFilePath)
 {
+    EMSTUDIO_TRACE_SCOPE("substrate.readLayerMap", xmlFilePath);
     QHash<int, QString> map;
     QFile file(xmlFilePath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) return map;
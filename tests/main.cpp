@@ -9,15 +9,30 @@
 #include <functional>
 #include <cstdio>
 
+#include "tst_tracer.h"
+#include "tst_run_cache.h"
+#include "tst_run_report.h"
+#include "tst_touchstone.h"
+#include "tst_vector_fit.h"
 #include "tst_wsl_helper.h"
 #include "tst_find_dialog.h"
 #include "tst_about_dialog.h"
+#include "tst_result_store.h"
+#include "tst_elmer_results.h"
 #include "tst_palace_golden.h"
 #include "tst_python_editor.h"
 #include "tst_openems_golden.h"
+#include "tst_parameter_sweep.h"
 #include "tst_mainwindow_ports.h"
+#include "tst_simulation_queue.h"
+#include "tst_hardware_topology.h"
 #include "tst_headless_dispatch.h"
+#include "tst_process_telemetry.h"
+#include "tst_sparameter_checks.h"
+#include "tst_sparameter_viewer.h"
+#include "tst_palace_sparameters.h"
 #include "tst_preferences_dialog.h"
+#include "tst_sparameter_combiner.h"
 #include "tst_keywords_editor_dialog.h"
 
 namespace
@@ -122,6 +137,21 @@ int main(int argc, char **argv)
 
     const QList<TestEntry> tests = {
         ADD_TEST(HeadlessDispatchTest),
+        ADD_TEST(SimulationQueueTest),
+        ADD_TEST(ParameterSweepTest),
+        ADD_TEST(RunCacheTest),
+        ADD_TEST(HardwareTopologyTest),
+        ADD_TEST(ProcessTelemetryTest),
+        ADD_TEST(RunReportTest),
+        ADD_TEST(TracerTest),
+        ADD_TEST(TouchstoneTest),
+        ADD_TEST(SParameterViewerTest),
+        ADD_TEST(ElmerResultsTest),
+        ADD_TEST(PalaceSParametersTest),
+        ADD_TEST(ResultStoreTest),
+        ADD_TEST(SParameterChecksTest),
+        ADD_TEST(SParameterCombinerTest),
+        ADD_TEST(VectorFitTest),
         ADD_TEST(WslHelperTest),
         ADD_TEST(MainWindowPortsTest),
         ADD_TEST(PythonEditorTest),
@@ -26,6 +26,7 @@
 #include <QRegularExpression>
 #include <QStringList>
 #include <QtGlobal>
+#include <QtTest/QtTest>
 
 namespace GoldenTestUtils
 {
@@ -217,4 +218,18 @@ void updateGoldenOnce(const QString& goldenPath,
     Q_ASSERT_X(ok, "updateGoldenOnce", qPrintable(err));
 }
 
+/*!*******************************************************************************************************************
+ * \brief Resolves the platform-specific OpenEMS Python launcher stub for unit tests.
+ *
+ * \return Absolute path to the OpenEMS python stub script, or empty string if not found.
+ **********************************************************************************************************************/
+QString ensureTestOpenemsPythonStub()
+{
+#ifdef Q_OS_WIN
+    return QFINDTESTDATA("tools/openems_python_stub.cmd");
+#else
+    return QFINDTESTDATA("tools/openems_python_stub.sh");
+#endif
+}
+
 } // namespace GoldenTestUtils
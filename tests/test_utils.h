@@ -21,6 +21,8 @@ bool writeUtf8Atomic(const QString& path,
 
 void updateGoldenOnce(const QString& goldenPath,
                       const QString& normalizedContent);
+
+QString ensureTestOpenemsPythonStub();
 }
 
 #endif // TEST_UTILS_H
@@ -11,27 +11,57 @@ SOURCES += \
     main.cpp \
     test_utils.cpp \
     tst_about_dialog.cpp \
+    tst_elmer_results.cpp \
     tst_find_dialog.cpp \
+    tst_hardware_topology.cpp \
     tst_headless_dispatch.cpp \
     tst_keywords_editor_dialog.cpp \
     tst_mainwindow_ports.cpp \
     tst_openems_golden.cpp \
     tst_palace_golden.cpp \
+    tst_palace_sparameters.cpp \
+    tst_parameter_sweep.cpp \
     tst_preferences_dialog.cpp \
+    tst_process_telemetry.cpp \
     tst_python_editor.cpp \
+    tst_result_store.cpp \
+    tst_run_cache.cpp \
+    tst_run_report.cpp \
+    tst_simulation_queue.cpp \
+    tst_sparameter_checks.cpp \
+    tst_sparameter_combiner.cpp \
+    tst_sparameter_viewer.cpp \
+    tst_touchstone.cpp \
+    tst_tracer.cpp \
+    tst_vector_fit.cpp \
     tst_wsl_helper.cpp
 
 HEADERS += \
     test_utils.h \
     tst_about_dialog.h \
+    tst_elmer_results.h \
     tst_find_dialog.h \
+    tst_hardware_topology.h \
     tst_headless_dispatch.h \
     tst_keywords_editor_dialog.h \
     tst_mainwindow_ports.h \
     tst_openems_golden.h \
     tst_palace_golden.h \
+    tst_palace_sparameters.h \
+    tst_parameter_sweep.h \
     tst_preferences_dialog.h \
+    tst_process_telemetry.h \
     tst_python_editor.h \
+    tst_result_store.h \
+    tst_run_cache.h \
+    tst_run_report.h \
+    tst_simulation_queue.h \
+    tst_sparameter_checks.h \
+    tst_sparameter_combiner.h \
+    tst_sparameter_viewer.h \
+    tst_touchstone.h \
+    tst_tracer.h \
+    tst_vector_fit.h \
     tst_wsl_helper.h
 
 FORMS += \
@@ -0,0 +1,78 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_elmer_results.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "elmerresults.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that Elmer scalar results are mapped into the S-matrix (conjugated, frequency from omega), that
+ *        an unfinished last row is ignored and that convert() names the file after port_information.json.
+ **********************************************************************************************************************/
+void ElmerResultsTest::elmerResults_convertsScalarResultsToTouchstone()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("model/mesh"));
+
+    QFile names(dir.filePath("model/mesh/scalar_results.names"));
+    QVERIFY(names.open(QIODevice::WriteOnly));
+    names.write("Elmer version: 9.0\n"
+                "Variables in columns of matrix: scalar_results\n"
+                "   1: res: angular frequency\n"
+                "   2: res: cmf 1 1\n   3: res: cmf 1 2\n   4: res: cmf 2 1\n   5: res: cmf 2 2\n"
+                "   6: res: cmf im 1 1\n   7: res: cmf im 1 2\n   8: res: cmf im 2 1\n   9: res: cmf im 2 2\n"
+                "  10: res: iterations\n");
+    names.close();
+
+    const double w1 = 2 * M_PI * 1e9;
+    const double w2 = 2 * M_PI * 2e9;
+    QFile data(dir.filePath("model/mesh/scalar_results"));
+    QVERIFY(data.open(QIODevice::WriteOnly));
+    data.write(QString("  %1 0.1 0.2 0.3 0.4 0.5 0.6 0.7 0.8 1\n"
+                       "  %2 0.2 0.9 0.9 0.2 0.0 -0.1 -0.1 0.0 1\n"
+                       "  %3 0.3 0.8")
+                   .arg(w1, 0, 'g', 17).arg(w2, 0, 'g', 17).arg(3 * w1, 0, 'g', 17).toUtf8());
+    data.close();
+
+    QFile info(dir.filePath("model/port_information.json"));
+    QVERIFY(info.open(QIODevice::WriteOnly));
+    info.write(R"({"name": "inductor", "ports": [{"portnumber": 1, "Z0": 50}, {"portnumber": 2, "Z0": 25}]})");
+    info.close();
+
+    QCOMPARE(ElmerResults::findNamesFile(dir.path()), QFileInfo(names).absoluteFilePath());
+
+    Touchstone::Network net;
+    QString err;
+    QVERIFY2(ElmerResults::read(names.fileName(), net, err), qPrintable(err));
+    QCOMPARE(net.ports, 2);
+    QCOMPARE(net.frequencyCount(), 2);
+    QVERIFY(qAbs(net.frequencies.at(1) - 2e9) < 1e-3);
+    QVERIFY(net.value(0, 0, 1) == Touchstone::Complex(0.2, -0.6));
+    QVERIFY(net.value(0, 1, 0) == Touchstone::Complex(0.3, -0.7));
+
+    QString snp;
+    QVERIFY2(ElmerResults::convert(names.fileName(), snp, err), qPrintable(err));
+    QCOMPARE(QFileInfo(snp).fileName(), QString("inductor.s2p"));
+
+    Touchstone::Network back;
+    QVERIFY2(Touchstone::read(snp, back, err), qPrintable(err));
+    QCOMPARE(back.references, QVector<double>({50.0, 25.0}));
+    QVERIFY(std::abs(back.value(1, 1, 0) - net.value(1, 1, 0)) < 1e-9);
+}
@@ -0,0 +1,96 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_hardware_topology.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "hardwaretopology.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies the sysfs topology parser and the NUMA-aware MPI launch plans on a dual-socket layout.
+ *
+ * The fake sysfs tree has two sockets with one NUMA node each, two cores per socket and two hardware threads
+ * per core (8 logical CPUs, 4 physical cores).
+ **********************************************************************************************************************/
+void HardwareTopologyTest::hardwareTopology_parsesSysfsAndPlansNumaAwareLaunch()
+{
+    QCOMPARE(HardwareTopology::parseCpuList("0-2,5,7-8\n"), QList<int>() << 0 << 1 << 2 << 5 << 7 << 8);
+    QVERIFY(HardwareTopology::parseCpuList("3-1").isEmpty());
+    QCOMPARE(HardwareTopology::parseSysfsDump("cpu/online=0-1\r\nnode/node0/cpulist=0-1\n").size(), 2);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto writeFile = [&dir](const QString &relPath, const QByteArray &content) {
+        QDir().mkpath(QFileInfo(dir.filePath(relPath)).absolutePath());
+        QFile f(dir.filePath(relPath));
+        return f.open(QIODevice::WriteOnly) && f.write(content) == content.size();
+    };
+
+    QVERIFY(writeFile("cpu/online", "0-7\n"));
+    for (int cpu = 0; cpu < 8; ++cpu) {
+        const QByteArray package = QByteArray::number((cpu / 2) % 2);
+        const QByteArray core    = QByteArray::number(cpu % 2);
+        QVERIFY(writeFile(QString("cpu/cpu%1/topology/physical_package_id").arg(cpu), package + "\n"));
+        QVERIFY(writeFile(QString("cpu/cpu%1/topology/core_id").arg(cpu), core + "\n"));
+    }
+    QVERIFY(writeFile("cpu/cpufreq/placeholder", ""));
+    QVERIFY(writeFile("node/node0/cpulist", "0-1,4-5\n"));
+    QVERIFY(writeFile("node/node1/cpulist", "2-3,6-7\n"));
+
+    const HardwareTopology::Topology topo = HardwareTopology::fromSysfs(HardwareTopology::readSysfs(dir.path()));
+    QVERIFY(topo.isValid());
+    QCOMPARE(topo.logicalCpus, 8);
+    QCOMPARE(topo.physicalCores, 4);
+    QCOMPARE(topo.sockets, 2);
+    QCOMPARE(topo.nodes.size(), 2);
+    QCOMPARE(topo.nodes.at(1).cpus, QList<int>() << 2 << 3 << 6 << 7);
+    QCOMPARE(topo.nodes.at(1).physicalCores, 2);
+
+    HardwareTopology::LaunchOptions options;
+    HardwareTopology::LaunchPlan plan = HardwareTopology::planMpiLaunch(topo, options);
+    QCOMPARE(plan.ranks, 4);
+    QCOMPARE(plan.launcherArgs, QString("--bind-to core --map-by numa"));
+    QVERIFY2(plan.description.contains("2 NUMA node(s)"), qPrintable(plan.description));
+
+    options.reservedCores = 1;
+    QCOMPARE(HardwareTopology::planMpiLaunch(topo, options).ranks, 3);
+
+    options.reservedCores = 0;
+    options.ranksPerNumaNode = 1;
+    plan = HardwareTopology::planMpiLaunch(topo, options);
+    QCOMPARE(plan.ranks, 2);
+    QCOMPARE(plan.launcherArgs, QString("--bind-to core --map-by ppr:1:numa"));
+
+    options.ranksPerNumaNode = 0;
+    options.rankLimit = 2;
+    plan = HardwareTopology::planMpiLaunch(topo, options);
+    QCOMPARE(plan.ranks, 2);
+    QCOMPARE(plan.binding, HardwareTopology::Binding::None);
+    QCOMPARE(plan.launcherArgs, QString("--oversubscribe"));
+
+    QMap<QString, QVariant> prefs;
+    prefs["PALACE_MPI_BINDING"] = 1;
+    prefs["RESERVED_CORES"] = 2;
+    options = HardwareTopology::launchOptionsFromPreferences(prefs);
+    QCOMPARE(options.binding, HardwareTopology::Binding::None);
+    plan = HardwareTopology::planMpiLaunch(topo, options);
+    QCOMPARE(plan.ranks, 2);
+    QCOMPARE(plan.launcherArgs, QString("--oversubscribe"));
+
+    QCOMPARE(HardwareTopology::planMpiLaunch(HardwareTopology::Topology(), HardwareTopology::LaunchOptions()).binding,
+             HardwareTopology::Binding::None);
+}
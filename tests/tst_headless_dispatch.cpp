@@ -15,51 +15,79 @@
 #include <QtTest/QtTest>
 #include <QFile>
 #include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
 
-#include "mainwindow.h"
+#include "commandline.h"
+#include "headlessrun.h"
+#include "simulationrunner.h"
+#include "test_utils.h"
 
 /*!*******************************************************************************************************************
- * \brief Resolves the platform-specific OpenEMS Python launcher stub for unit tests.
- *
- * \return Absolute path to the OpenEMS python stub script, or empty string if not found.
+ * \brief Verifies that the command line selects the headless modes and rejects incomplete or conflicting commands.
  **********************************************************************************************************************/
-static QString ensureTestOpenemsPythonStub()
+void HeadlessDispatchTest::commandLine_parsesHeadlessModes()
 {
-#ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/openems_python_stub.cmd");
-#else
-    return QFINDTESTDATA("tools/openems_python_stub.sh");
-#endif
-}
+    CommandLine::Options options;
+    QString err;
 
-/*!*******************************************************************************************************************
- * \brief Resolves the platform-specific Palace launcher stub for unit tests.
- *
- * \return Absolute path to the Palace launcher stub script, or empty string if not found.
- **********************************************************************************************************************/
-static QString ensureTestPalaceLauncher()
-{
-#ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/palace_launcher_stub.cmd");
-#else
-    return QFINDTESTDATA("tools/palace_launcher_stub.sh");
-#endif
+    QVERIFY2(CommandLine::parse({"EMStudio", "model.py", "-gdsfile", "a.gds", "-topcell", "t1"}, options, err),
+             qPrintable(err));
+    QVERIFY(options.mode == CommandLine::Mode::Gui);
+    QCOMPARE(options.pythonFiles, QStringList({"model.py"}));
+    QCOMPARE(options.gdsFile, QString("a.gds"));
+    QCOMPARE(options.topCell, QString("t1"));
+
+    QVERIFY2(CommandLine::parse({"EMStudio", "-run", "-openems", "-cores", "4", "-nocache", "-pipeline",
+                                 "-trace", "trace.json", "a.py", "b.py"}, options, err),
+             qPrintable(err));
+    QVERIFY(options.mode == CommandLine::Mode::Run);
+    QCOMPARE(options.runTool, QString("openems"));
+    QCOMPARE(options.coreBudget, 4);
+    QVERIFY(!options.useRunCache);
+    QVERIFY(options.pipelined);
+    QCOMPARE(options.traceFile, QString("trace.json"));
+    QCOMPARE(options.pythonFiles, QStringList({"a.py", "b.py"}));
+
+    QVERIFY2(CommandLine::parse({"EMStudio", "-combine", "out.s2p", "a.s2p", "b.s2p", "-nodc",
+                                 "-grid", "1:10:10"}, options, err),
+             qPrintable(err));
+    QVERIFY(options.mode == CommandLine::Mode::Combine);
+    QCOMPARE(options.target, QString("out.s2p"));
+    QCOMPARE(options.inputs, QStringList({"a.s2p", "b.s2p"}));
+    QVERIFY(!options.combineOptions.extendToDc);
+    QCOMPARE(options.combineOptions.targetFrequencies.size(), 10);
+
+    QVERIFY(CommandLine::parse({"EMStudio", "-run", "-h"}, options, err));
+    QVERIFY(options.mode == CommandLine::Mode::Help);
+
+    QVERIFY(!CommandLine::parse({"EMStudio", "-run", "a.py"}, options, err));
+    QVERIFY2(err.contains("-palace or -openems"), qPrintable(err));
+    QVERIFY(!CommandLine::parse({"EMStudio", "-check", "a.s2p", "-vectorfit", "b.s2p"}, options, err));
+    QVERIFY2(err.contains("-vectorfit"), qPrintable(err));
+    QVERIFY(!CommandLine::parse({"EMStudio", "-grid", "1:10"}, options, err));
+    QVERIFY(!CommandLine::parse({"EMStudio", "-bogus"}, options, err));
+    QVERIFY2(err.contains("-bogus"), qPrintable(err));
+
+    char arg0[] = "EMStudio";
+    char argRun[] = "-run";
+    char argModel[] = "model.py";
+    char *headlessArgv[] = {arg0, argRun, argModel};
+    char *guiArgv[] = {arg0, argModel};
+    QVERIFY(CommandLine::requestsHeadless(3, headlessArgv));
+    QVERIFY(!CommandLine::requestsHeadless(2, guiArgv));
 }
 
 /*!*******************************************************************************************************************
- * \brief Prepares a deterministic OpenEMS model for headless dispatch tests.
+ * \brief Verifies that a headless run can be prepared and executed without constructing MainWindow.
  *
- * \param w Main window under test.
+ * The model settings are derived by HeadlessRun::prepareSimSettings() and the OpenEMS python stub is run
+ * through SimulationRunner directly; the test checks the resolved backend keys, the forwarded output and
+ * the reported exit code.
  **********************************************************************************************************************/
-static void prepareOpenems(MainWindow& w)
+void HeadlessDispatchTest::headlessRun_openems_runsWithoutMainWindow()
 {
-    const QString gdsPath = QFINDTESTDATA("golden/line_simple_viaport.gds");
-    QVERIFY2(!gdsPath.isEmpty(), "Golden GDS file not found via QFINDTESTDATA");
-
-    const QString xmlPath = QFINDTESTDATA("golden/SG13G2_200um.xml");
-    QVERIFY2(!xmlPath.isEmpty(), "Golden XML file not found via QFINDTESTDATA");
-
-    const QString pyStub = ensureTestOpenemsPythonStub();
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
     QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
 
 #ifndef Q_OS_WIN
@@ -70,136 +98,67 @@ static void prepareOpenems(MainWindow& w)
                               QFileDevice::ExeOther);
 #endif
 
-    w.setGdsFile(gdsPath);
-    w.setTopCell("t1");
-    w.setSubstrateFile(xmlPath);
-
-    w.testSetPreference("Python Path", pyStub);
-    w.refreshSimToolOptionsForTests();
-
-    QString terr;
-    QVERIFY2(w.testSetSimToolKey("openems", &terr), qPrintable(terr));
-    QVERIFY2(w.testInitDefaultOpenemsModel(), "testInitDefaultOpenemsModel() failed");
-
-    QString err;
-    const QString regenerated = w.testGenerateScriptFromGuiState(&err);
-    QVERIFY2(!regenerated.isEmpty(), qPrintable(err));
-    w.testSetEditorText(regenerated);
-
-    const QString scriptPath = w.testWriteEditorToTempPyFile("headless_openems_test.py");
-    QVERIFY2(!scriptPath.isEmpty(), "Failed to create temporary OpenEMS script");
-
-    w.testSetRunPythonScriptPath(scriptPath);
-    w.testSetSimSetting("RunDir", QFileInfo(scriptPath).absolutePath());
-}
-
-/*!*******************************************************************************************************************
- * \brief Prepares a deterministic Palace model for headless dispatch tests.
- *
- * \param w Main window under test.
- **********************************************************************************************************************/
-static void preparePalace(MainWindow& w)
-{
-    const QString gdsPath = QFINDTESTDATA("golden/line_simple_viaport.gds");
-    QVERIFY2(!gdsPath.isEmpty(), "Golden GDS file not found via QFINDTESTDATA");
-
-    const QString xmlPath = QFINDTESTDATA("golden/SG13G2_200um.xml");
-    QVERIFY2(!xmlPath.isEmpty(), "Golden XML file not found via QFINDTESTDATA");
-
-    const QString launcherPath = ensureTestPalaceLauncher();
-    QVERIFY2(!launcherPath.isEmpty(), "Palace launcher stub not found via QFINDTESTDATA");
-
-#ifndef Q_OS_WIN
-    QFile::setPermissions(launcherPath,
-                          QFile::permissions(launcherPath) |
-                              QFileDevice::ExeUser |
-                              QFileDevice::ExeGroup |
-                              QFileDevice::ExeOther);
-#endif
-
-    w.setGdsFile(gdsPath);
-    w.setTopCell("t1");
-    w.setSubstrateFile(xmlPath);
-
-    w.testSetPreference("PALACE_RUN_MODE", 1);
-    w.testSetPreference("PALACE_RUN_SCRIPT", launcherPath);
-    w.testSetPreference("PALACE_INSTALL_PATH", QString());
-    w.refreshSimToolOptionsForTests();
-
-    QString terr;
-    QVERIFY2(w.testSetSimToolKey("palace", &terr), qPrintable(terr));
-    QVERIFY2(w.testInitDefaultPalaceModel(), "testInitDefaultPalaceModel() failed");
-
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString openemsModel = dir.filePath("headless_core.py");
+    {
+        QFile f(openemsModel);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("from openEMS import openEMS\n"
+                "gds_filename = \"line.gds\"\n"
+                "energy_limit = -50\n");
+    }
+
+    const QString elmerModel = dir.filePath("headless_elmer.py");
+    {
+        QFile f(elmerModel);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("settings = {}\n"
+                "settings['elmer'] = True\n");
+    }
+
+    HeadlessRun::Options options;
+    QMap<QString, QVariant> simSettings;
+    QString simKey;
     QString err;
-    const QString regenerated = w.testGenerateScriptFromGuiState(&err);
-    QVERIFY2(!regenerated.isEmpty(), qPrintable(err));
-    w.testSetEditorText(regenerated);
-
-    const QString scriptPath = w.testWriteEditorToTempPyFile("headless_palace_test.py");
-    QVERIFY2(!scriptPath.isEmpty(), "Failed to create temporary Palace script");
-
-    w.testSetRunPythonScriptPath(scriptPath);
-    w.testSetSimSetting("RunDir", QFileInfo(scriptPath).absolutePath());
-}
-
-/*!*******************************************************************************************************************
- * \brief Verifies that headless dispatch for OpenEMS enables headless mode and starts OpenEMS flow.
- **********************************************************************************************************************/
-void HeadlessDispatchTest::runHeadless_openems_dispatchesToOpenems()
-{
-    MainWindow w;
-    prepareOpenems(w);
-
-    w.testRunHeadless("openems");
-
-    QVERIFY2(w.testIsHeadless(), "Headless flag shall be set after runHeadless(openems)");
-
-    const bool finished = QTest::qWaitFor([&w]() {
-        return !w.testIsSimulationRunning();
-    }, 5000);
-
-    QVERIFY2(finished, "OpenEMS headless dispatch did not finish in time");
-
-    const QString log = w.testSimulationLogText();
-    QVERIFY2(log.contains("Starting OpenEMS simulation"),
-             qPrintable(QString("Missing OpenEMS start message:\n%1").arg(log)));
-}
-
-/*!*******************************************************************************************************************
- * \brief Verifies that headless dispatch for Palace enables headless mode and starts Palace flow.
- **********************************************************************************************************************/
-void HeadlessDispatchTest::runHeadless_palace_dispatchesToPalace()
-{
-    MainWindow w;
-    preparePalace(w);
-
-    w.testRunHeadless("palace");
-
-    QVERIFY2(w.testIsHeadless(), "Headless flag shall be set after runHeadless(palace)");
-
-    const bool finished = QTest::qWaitFor([&w]() {
-        return !w.testIsSimulationRunning();
-    }, 5000);
-
-    QVERIFY2(finished, "Palace headless dispatch did not finish in time");
-
-    const QString log = w.testSimulationLogText();
-    QVERIFY2(log.contains("Starting Palace Python preprocessing"),
-             qPrintable(QString("Missing Palace start message:\n%1").arg(log)));
-}
-
-/*!*******************************************************************************************************************
- * \brief Verifies that an unknown backend in headless mode still sets headless state and requests application exit.
- *
- * This test only checks that the unknown-backend branch executes. It does not assert the exact exit code
- * because QCoreApplication::exit() is asynchronous and process-global in Qt tests.
- **********************************************************************************************************************/
-void HeadlessDispatchTest::runHeadless_unknownBackend_setsHeadlessAndRequestsExit()
-{
-    MainWindow w;
-
-    w.testRunHeadless("unknown_backend");
 
-    QVERIFY2(w.testIsHeadless(), "Headless flag shall be set even for unknown backend");
-    QVERIFY(true);
+    options.simKey = "unknown_backend";
+    options.pythonFile = openemsModel;
+    QVERIFY(!HeadlessRun::prepareSimSettings(options, simSettings, simKey, err));
+    QVERIFY2(err.contains("Unknown backend"), qPrintable(err));
+
+    options.simKey = "palace";
+    options.pythonFile = elmerModel;
+    QVERIFY2(HeadlessRun::prepareSimSettings(options, simSettings, simKey, err), qPrintable(err));
+    QCOMPARE(simKey, QString("elmer"));
+
+    options.simKey = "openems";
+    options.pythonFile = openemsModel;
+    options.topCell = "t1";
+    QVERIFY2(HeadlessRun::prepareSimSettings(options, simSettings, simKey, err), qPrintable(err));
+    QCOMPARE(simKey, QString("openems"));
+    QCOMPARE(simSettings.value("RunPythonScript").toString(), QFileInfo(openemsModel).absoluteFilePath());
+    QCOMPARE(simSettings.value("RunDir").toString(), QFileInfo(openemsModel).absolutePath());
+    QCOMPARE(simSettings.value("TopCell").toString(), QString("t1"));
+
+    SimulationRunner runner;
+    QMap<QString, QVariant> prefs;
+    prefs["Python Path"] = pyStub;
+    runner.setPreferences(prefs);
+    runner.setSimSettings(simSettings);
+    runner.setSimToolKey(simKey);
+
+    QByteArray output;
+    connect(&runner, &SimulationRunner::output, &runner, [&output](const QByteArray &data) {
+        output += data;
+    });
+    QSignalSpy finishedSpy(&runner, &SimulationRunner::finished);
+
+    QVERIFY(runner.runOpenEMS());
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 5000);
+    QCOMPARE(finishedSpy.at(0).at(0).toInt(), 0);
+    QVERIFY(!runner.isRunning());
+    QVERIFY2(output.contains("Starting OpenEMS simulation"), output.constData());
+    QVERIFY2(output.contains("[Simulation finished with exit code 0]"), output.constData());
 }
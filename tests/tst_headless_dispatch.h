@@ -20,9 +20,8 @@ class HeadlessDispatchTest : public QObject
     Q_OBJECT
 
 private slots:
-    void runHeadless_openems_dispatchesToOpenems();
-    void runHeadless_palace_dispatchesToPalace();
-    void runHeadless_unknownBackend_setsHeadlessAndRequestsExit();
+    void commandLine_parsesHeadlessModes();
+    void headlessRun_openems_runsWithoutMainWindow();
 };
 
 #endif // TST_HEADLESS_DISPATCH_H
@@ -2,35 +2,95 @@
 
 #include <QtTest/QtTest>
 #include <QFile>
+#include <QDataStream>
+#include <QTemporaryDir>
+
+#include <tuple>
 
 #include "mainwindow.h"
+#include "test_utils.h"
 
 /*!*******************************************************************************************************************
- * \brief Resolves the platform-specific OpenEMS Python launcher stub for unit tests.
+ * \brief Resolves the platform-specific Palace launcher stub for unit tests.
  *
- * \return Absolute path to the OpenEMS launcher stub script, or empty string if not found.
+ * \return Absolute path to the Palace launcher stub script, or empty string if not found.
  **********************************************************************************************************************/
-static QString ensureTestOpenemsPythonStub()
+static QString ensureTestPalaceLauncher()
 {
 #ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/openems_python_stub.cmd");
+    return QFINDTESTDATA("tools/palace_launcher_stub.cmd");
 #else
-    return QFINDTESTDATA("tools/openems_python_stub.sh");
+    return QFINDTESTDATA("tools/palace_launcher_stub.sh");
 #endif
 }
 
 /*!*******************************************************************************************************************
- * \brief Resolves the platform-specific Palace launcher stub for unit tests.
+ * \brief Writes a minimal GDSII file with one cell containing the given port polygons and labels.
  *
- * \return Absolute path to the Palace launcher stub script, or empty string if not found.
+ * \param path   Output file path.
+ * \param cell   Cell name.
+ * \param boxes  Rectangles as (layer, rect) pairs.
+ * \param labels Labels as (layer, text, position) triples.
+ * \return true on success.
  **********************************************************************************************************************/
-static QString ensureTestPalaceLauncher()
+static bool writeTestGds(const QString& path,
+                         const QString& cell,
+                         const QVector<QPair<int, QRect>>& boxes,
+                         const QVector<std::tuple<int, QString, QPoint>>& labels)
 {
-#ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/palace_launcher_stub.cmd");
-#else
-    return QFINDTESTDATA("tools/palace_launcher_stub.sh");
-#endif
+    QFile f(path);
+    if (!f.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&f);
+    out.setByteOrder(QDataStream::BigEndian);
+
+    auto rec = [&](quint8 type, quint8 dtype, const QByteArray& data) {
+        out << quint16(4 + data.size()) << type << dtype;
+        out.writeRawData(data.constData(), data.size());
+    };
+    auto i16 = [](int v) {
+        QByteArray b; QDataStream s(&b, QIODevice::WriteOnly); s << qint16(v); return b;
+    };
+    auto xy = [](const QVector<QPoint>& pts) {
+        QByteArray b; QDataStream s(&b, QIODevice::WriteOnly);
+        for (const QPoint& p : pts) s << qint32(p.x()) << qint32(p.y());
+        return b;
+    };
+    auto str = [](const QString& t) {
+        QByteArray b = t.toLatin1();
+        if (b.size() & 1) b.append('\0');
+        return b;
+    };
+
+    rec(0x00, 0x02, i16(600));                          // HEADER
+    rec(0x01, 0x02, QByteArray(24, '\0'));              // BGNLIB
+    rec(0x02, 0x06, str("LIB"));                        // LIBNAME
+    rec(0x05, 0x02, QByteArray(24, '\0'));              // BGNSTR
+    rec(0x06, 0x06, str(cell));                         // STRNAME
+
+    for (const auto& b : boxes) {
+        const QRect& r = b.second;
+        rec(0x08, 0x00, QByteArray());                  // BOUNDARY
+        rec(0x0D, 0x02, i16(b.first));                  // LAYER
+        rec(0x0E, 0x02, i16(0));                        // DATATYPE
+        rec(0x10, 0x03, xy({ r.topLeft(), r.topRight(), r.bottomRight(), r.bottomLeft(), r.topLeft() }));
+        rec(0x11, 0x00, QByteArray());                  // ENDEL
+    }
+
+    for (const auto& l : labels) {
+        rec(0x0C, 0x00, QByteArray());                  // TEXT
+        rec(0x0D, 0x02, i16(std::get<0>(l)));           // LAYER
+        rec(0x16, 0x02, i16(0));                        // TEXTTYPE
+        rec(0x10, 0x03, xy({ std::get<2>(l) }));        // XY
+        rec(0x19, 0x06, str(std::get<1>(l)));           // STRING
+        rec(0x11, 0x00, QByteArray());                  // ENDEL
+    }
+
+    rec(0x07, 0x00, QByteArray());                      // ENDSTR
+    rec(0x04, 0x00, QByteArray());                      // ENDLIB
+
+    return out.status() == QDataStream::Ok;
 }
 
 /*!*******************************************************************************************************************
@@ -265,6 +325,75 @@ void MainWindowPortsTest::toggleSubLayerNames_convertsNumericLayersToNamesAndBac
     QCOMPARE(w.testPortComboText(0, 6), QString("z"));
 }
 
+/*!*******************************************************************************************************************
+ * \brief Verifies port proposals from GDS labels and port-layer polygons, the dry-run diff and bulk insertion.
+ *
+ * The generated layout holds:
+ *  - label "P1" inside a tall polygon on layer 201 (in-plane port, direction x),
+ *  - label "P2 8 126 -z" inside a polygon on layer 202 (vertical port with explicit layers),
+ *  - an unlabelled polygon on layer 203 (gets the next free port number).
+ * The script already defines port 1 with the same geometry and port 2 with a different
+ * direction, so the diff must report one unchanged, one changed and one new port.
+ **********************************************************************************************************************/
+void MainWindowPortsTest::generatePortsFromGds_labelsAndPolygons_proposesAndInserts()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString gdsPath = dir.filePath("ports.gds");
+    QVERIFY(writeTestGds(gdsPath, "top",
+                         { qMakePair(201, QRect(QPoint(0, 0),     QPoint(10, 100))),
+                           qMakePair(202, QRect(QPoint(500, 0),   QPoint(520, 20))),
+                           qMakePair(203, QRect(QPoint(1000, 0),  QPoint(1100, 10))) },
+                         { std::make_tuple(201, QString("P1"),          QPoint(5, 50)),
+                           std::make_tuple(202, QString("P2 8 126 -z"), QPoint(510, 10)),
+                           std::make_tuple(63,  QString("ignored"),     QPoint(0, 0)) }));
+
+    MainWindow w;
+
+    QString err;
+    const auto ports = w.testProposePortsFromGds(gdsPath, "top", { 201, 202, 203 }, &err);
+    QVERIFY2(err.isEmpty(), qPrintable(err));
+    QCOMPARE(ports.size(), 3);
+
+    QCOMPARE(ports[0].portnumber, 1);
+    QCOMPARE(ports[0].sourceLayer, QString("201"));
+    QCOMPARE(ports[0].direction, QString("x"));
+
+    QCOMPARE(ports[1].portnumber, 2);
+    QCOMPARE(ports[1].sourceLayer, QString("202"));
+    QCOMPARE(ports[1].fromLayer, QString("8"));
+    QCOMPARE(ports[1].toLayer, QString("126"));
+    QCOMPARE(ports[1].direction, QString("-z"));
+
+    QCOMPARE(ports[2].portnumber, 3);
+    QCOMPARE(ports[2].sourceLayer, QString("203"));
+    QCOMPARE(ports[2].direction, QString("y"));
+
+    w.testSetEditorText(
+        "simulation_ports.add_port(simulation_setup.simulation_port("
+        "portnumber=1, voltage=1, port_Z0=50, source_layernum=201, direction='x'))\n"
+        "simulation_ports.add_port(simulation_setup.simulation_port("
+        "portnumber=2, voltage=1, port_Z0=50, source_layernum=202, "
+        "from_layername='8', to_layername='126', direction='z'))\n");
+
+    const QStringList diff = w.testDiffProposedPorts(ports).split('\n');
+    QCOMPARE(diff.size(), 3);
+    QVERIFY2(diff[0].startsWith("+ P3"), qPrintable(diff[0]));
+    QVERIFY2(diff[1].startsWith("~ P2"), qPrintable(diff[1]));
+    QVERIFY2(diff[2].startsWith("= P1"), qPrintable(diff[2]));
+
+    w.testClickAddPort();
+    QCOMPARE(w.testPortsRowCount(), 1);
+
+    w.testApplyProposedPorts(ports);
+    QCOMPARE(w.testPortsRowCount(), 3);
+    QCOMPARE(w.testPortCellText(0, 0), QString("1"));
+    QCOMPARE(w.testPortComboText(0, 6), QString("x"));
+    QCOMPARE(w.testPortCellText(2, 0), QString("3"));
+    QCOMPARE(w.testPortComboText(2, 6), QString("y"));
+}
+
 /*!*******************************************************************************************************************
  * \brief Verifies that switching simulation tools through test wrappers works without errors.
  *
@@ -275,7 +404,7 @@ void MainWindowPortsTest::switchSimTool_updatesState()
 {
     MainWindow w;
 
-    const QString pyStub = ensureTestOpenemsPythonStub();
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
     QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
 
     const QString launcherPath = ensureTestPalaceLauncher();
@@ -326,7 +455,7 @@ void MainWindowPortsTest::defaultScriptGeneration_openems_and_palace_notEmpty()
     const QString xmlPath = QFINDTESTDATA("golden/SG13G2_200um.xml");
     QVERIFY2(!xmlPath.isEmpty(), "Golden XML file not found via QFINDTESTDATA");
 
-    const QString pyStub = ensureTestOpenemsPythonStub();
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
     QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
 
     const QString launcherPath = ensureTestPalaceLauncher();
@@ -398,7 +527,7 @@ void MainWindowPortsTest::boundaryOptions_updateOnToolChange_withoutCrash()
 {
     MainWindow w;
 
-    const QString pyStub = ensureTestOpenemsPythonStub();
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
     QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
 
     const QString launcherPath = ensureTestPalaceLauncher();
@@ -452,7 +581,7 @@ void MainWindowPortsTest::saveAction_writesScriptToFile_and_updatesState()
     const QString xmlPath = QFINDTESTDATA("golden/SG13G2_200um.xml");
     QVERIFY2(!xmlPath.isEmpty(), "Golden XML file not found via QFINDTESTDATA");
 
-    const QString pyStub = ensureTestOpenemsPythonStub();
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
     QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
 
 #ifndef Q_OS_WIN
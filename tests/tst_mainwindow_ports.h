@@ -12,6 +12,7 @@ private slots:
     void importPortsFromEditor_targetLayer_onlyToLayerFilled();
     void addAndRemovePorts_flow_works();
     void toggleSubLayerNames_convertsNumericLayersToNamesAndBack();
+    void generatePortsFromGds_labelsAndPolygons_proposesAndInserts();
 
     void switchSimTool_updatesState();
     void defaultScriptGeneration_openems_and_palace_notEmpty();
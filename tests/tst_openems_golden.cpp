@@ -10,23 +10,6 @@
 
 using namespace GoldenTestUtils;
 
-/*!*******************************************************************************************************************
- * \brief Resolves the platform-specific OpenEMS Python launcher stub for unit tests.
- *
- * Returns a path to a lightweight stub script that emulates the configured OpenEMS
- * "Python Path" in test/CI environments. The stub is located via QFINDTESTDATA().
- *
- * \return Absolute path to the OpenEMS python stub script, or empty string if not found.
- **********************************************************************************************************************/
-static QString ensureTestOpenemsPythonStub()
-{
-#ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/openems_python_stub.cmd");
-#else
-    return QFINDTESTDATA("tools/openems_python_stub.sh");
-#endif
-}
-
 /*!*******************************************************************************************************************
  * \brief Golden test: regenerates OpenEMS script after changing GUI settings and compares to golden file.
  *
@@ -8,8 +8,11 @@
 #include <QCoreApplication>
 #include <QTemporaryDir>
 #include <QTextStream>
+#include <QPlainTextEdit>
 
 #include "mainwindow.h"
+#include "simulationlog.h"
+#include "simulationloganalyzer.h"
 
 using namespace GoldenTestUtils;
 
@@ -27,20 +30,6 @@ static QString ensureTestPalaceLauncher()
 #endif
 }
 
-/*!*******************************************************************************************************************
- * \brief Resolves the platform-specific OpenEMS Python launcher stub for unit tests.
- *
- * \return Absolute path to the OpenEMS python stub script, or empty string if not found.
- **********************************************************************************************************************/
-static QString ensureTestOpenemsPythonStub()
-{
-#ifdef Q_OS_WIN
-    return QFINDTESTDATA("tools/openems_python_stub.cmd");
-#else
-    return QFINDTESTDATA("tools/openems_python_stub.sh");
-#endif
-}
-
 /*!*******************************************************************************************************************
  * \brief Golden test: regenerates Palace script after changing GUI settings and compares to golden file.
  *
@@ -442,6 +431,96 @@ void PalaceGolden::detectRunDirFromLog_parsesSimulationDirectory()
     QVERIFY2(!detected.isEmpty(), "Expected run directory to be detected");
 }
 
+/*!*******************************************************************************************************************
+ * \brief Verifies that SimulationLog batches output, bounds the view and keeps the full log on disk.
+ *
+ * Chunks (including a UTF-8 sequence split across two chunks) must not reach the view before a flush,
+ * the view must keep only the configured number of lines, and the spool file must contain everything.
+ **********************************************************************************************************************/
+void PalaceGolden::simulationLog_batchesBoundsViewAndSpoolsFullLog()
+{
+    QPlainTextEdit view;
+    SimulationLog log(&view);
+    log.setMaxLines(10);
+
+    const QByteArray umlaut = QString::fromUtf8("\xc3\xa4").toUtf8();
+
+    QByteArray expected;
+    for (int i = 0; i < 100; ++i) {
+        const QByteArray line = QByteArray("line ") + QByteArray::number(i) + "\n";
+        log.append(line);
+        expected += line;
+    }
+    log.append(QByteArray("tail ") + umlaut.left(1));
+    log.append(umlaut.mid(1) + "\n");
+    expected += QByteArray("tail ") + umlaut + "\n";
+
+    QVERIFY2(view.toPlainText().isEmpty(), "Output shall be batched until the next flush");
+
+    QTRY_VERIFY2(!view.toPlainText().isEmpty(), "Flush timer shall append pending output");
+
+    const QString shown = log.text();
+    QVERIFY2(shown.contains(QString::fromUtf8("tail \xc3\xa4")), qPrintable(shown));
+    QVERIFY2(!shown.contains("line 0\n"), "Oldest lines shall be dropped from the view");
+    QVERIFY2(view.blockCount() <= 10, qPrintable(QString::number(view.blockCount())));
+
+    QVERIFY(!log.spoolFilePath().isEmpty());
+    QCOMPARE(log.fullText(), QString::fromUtf8(expected));
+
+    log.clear();
+    QVERIFY(log.text().isEmpty());
+    QVERIFY(log.fullText().isEmpty());
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that SimulationLogAnalyzer parses solver output fed in arbitrary chunks.
+ *
+ * Lines are split across chunk boundaries on purpose. The run directory, Palace sweep steps, openEMS
+ * energy progress and Elmer scan steps must be reported as events and advance the progress fraction.
+ **********************************************************************************************************************/
+void PalaceGolden::simulationLogAnalyzer_streamsRunDirProgressAndEvents()
+{
+    SimulationLogAnalyzer analyzer;
+
+    QVector<SimulationLogAnalyzer::Event> events;
+    connect(&analyzer, &SimulationLogAnalyzer::eventParsed, &analyzer,
+            [&events](const SimulationLogAnalyzer::Event &ev) { events.append(ev); });
+
+    analyzer.feed("prep\nSimulation data direc");
+    QVERIFY(analyzer.runDirectory().isEmpty());
+    analyzer.feed("tory: /tmp/palace_model/t1_data\r\n");
+    QCOMPARE(analyzer.runDirectory(), QString("/tmp/palace_model/t1_data"));
+
+    analyzer.feed("It 3/4: \xcf\x89/2\xcf\x80 = 2.500e+01 GHz (elapsed time = 1.0e+00 s)\n");
+    analyzer.feed("    GMRES solver converged in 25 iterations (avg. reduction factor: 6.3e-01)\n");
+
+    QCOMPARE(events.size(), 3);
+    QVERIFY(events.at(0).type == SimulationLogAnalyzer::EventType::RunDirectory);
+    QVERIFY(events.at(1).type == SimulationLogAnalyzer::EventType::SweepStep);
+    QCOMPARE(events.at(1).step, 3);
+    QCOMPARE(events.at(1).total, 4);
+    QCOMPARE(events.at(1).value, 25.0);
+    QVERIFY(events.at(2).type == SimulationLogAnalyzer::EventType::SolverConverged);
+    QCOMPARE(events.at(2).step, 25);
+    QCOMPARE(analyzer.progress(), 0.5);
+    QVERIFY(analyzer.etaSeconds() >= 0);
+
+    analyzer.reset();
+    analyzer.setEnergyLimitDb(-40.0);
+    analyzer.feed("[@ 4s] Timestep:         2000 || Speed:  285.8 MC/s (3.473e-03 s/TS) || Energy: ~5.60e-16 (-20.00dB)");
+    QCOMPARE(analyzer.progress(), 0.0);
+    analyzer.finish();
+    QCOMPARE(analyzer.progress(), 0.5);
+    QVERIFY(events.last().type == SimulationLogAnalyzer::EventType::TimeStep);
+    QCOMPARE(events.last().step, 2000);
+
+    analyzer.reset();
+    analyzer.feed("MAIN: Scanning: 2/5\nplain line\n");
+    QVERIFY(events.last().type == SimulationLogAnalyzer::EventType::SolverStep);
+    QCOMPARE(analyzer.progress(), 0.2);
+    QVERIFY(analyzer.runDirectory().isEmpty());
+}
+
 /*!*******************************************************************************************************************
  * \brief Verifies that guessDefaultPalaceRunDir() returns an existing expected path and empty otherwise.
  **********************************************************************************************************************/
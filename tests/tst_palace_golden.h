@@ -18,6 +18,8 @@ private slots:
     void buildPalaceRunContext_scriptMode_succeeds();
 
     void detectRunDirFromLog_parsesSimulationDirectory();
+    void simulationLog_batchesBoundsViewAndSpoolsFullLog();
+    void simulationLogAnalyzer_streamsRunDirProgressAndEvents();
     void guessDefaultPalaceRunDir_returnsExistingPathOnly();
     void chooseSearchDir_prefersDetectedDir();
     void findPalaceConfigJson_prefersConfigJson_and_handlesEmptyDir();
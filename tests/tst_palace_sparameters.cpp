@@ -0,0 +1,143 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_palace_sparameters.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "palacesparameters.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that PalaceSParameters parses only appended rows, merges excitation rows, restarts on a
+ *        rewritten file and reports band convergence once the interpolated band stops changing.
+ **********************************************************************************************************************/
+void PalaceSParametersTest::palaceSParameters_tailsAppendedRows()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("port-S.csv");
+
+    auto appendToFile = [&path](const QByteArray &text, bool truncate = false) {
+        QFile f(path);
+        QVERIFY(f.open(truncate ? QIODevice::WriteOnly : QIODevice::Append));
+        f.write(text);
+    };
+
+    const QByteArray header = "f (GHz), |S[1][1]| (dB), arg(S[1][1]) (deg.), |S[2][1]| (dB), arg(S[2][1]) (deg.), "
+                              "|S[1][2]| (dB), arg(S[1][2]) (deg.), |S[2][2]| (dB), arg(S[2][2]) (deg.)\n";
+
+    PalaceSParameters tail(path);
+    tail.setBand(1.5e9, 2.5e9, 1e-6);
+
+    QString err;
+    QVERIFY(!tail.poll(err));                           // not written yet
+    QVERIFY(err.isEmpty());
+
+    appendToFile(header + "1.0, -20, 0, -3, 90, 0, 0, -20, 0\n2.0, -20, 0, -3");
+    QVERIFY(tail.poll(err));
+    QCOMPARE(tail.frequencyCount(), 1);
+    QCOMPARE(tail.ports(), 2);
+
+    appendToFile(", 90, 0, 0, -20, 0\n3.0, -20, 0, -3, 90, 0, 0, -20, 0\n");
+    QVERIFY(tail.poll(err));
+    QCOMPARE(tail.frequencyCount(), 3);
+    QVERIFY(!tail.bandConverged());
+
+    // Rows in between change nothing inside the band: after kStableUpdates updates the band has converged.
+    for (int i = 0; i < PalaceSParameters::kStableUpdates; ++i) {
+        QVERIFY(!tail.bandConverged());
+        appendToFile(QByteArray::number(4.0 + i) + ", -20, 0, -3, 90, 0, 0, -20, 0\n");
+        QVERIFY(tail.poll(err));
+    }
+    QVERIFY(tail.bandConverged());
+    QCOMPARE(tail.lastBandChange(), 0.0);
+
+    // A second excitation row for 2 GHz changes S12 and breaks the convergence streak.
+    appendToFile("2.0, -20, 0, -3, 90, -6.0206, 45, -20, 0\n");
+    QVERIFY(tail.poll(err));
+    QVERIFY(!tail.bandConverged());
+
+    const Touchstone::Network net = tail.network();
+    QCOMPARE(net.frequencyCount(), 5);
+    QVERIFY(std::abs(net.value(1, 0, 1) - std::polar(0.5, M_PI / 4)) < 1e-5);
+    QVERIFY(std::abs(net.value(1, 1, 0) - Touchstone::Complex(0.0, std::pow(10.0, -3.0 / 20.0))) < 1e-9);
+
+    // A rewritten (shorter) file starts over.
+    appendToFile(header + "7.0, -1, 0, -1, 0, -1, 0, -1, 0\n", true);
+    QVERIFY(tail.poll(err));
+    QCOMPARE(tail.frequencyCount(), 1);
+    QCOMPARE(tail.network().frequencies.first(), 7e9);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that a band still holding NaN entries (the second excitation of a two-port run has not reached
+ *        it yet) never counts as converged, and converges once those entries are reported and stable.
+ **********************************************************************************************************************/
+void PalaceSParametersTest::palaceSParameters_nanEntriesBlockBandConvergence()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("port-S.csv");
+
+    auto appendToFile = [&path](const QByteArray &text) {
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::Append));
+        f.write(text);
+    };
+
+    // Excitation 1 sweeps the band; the columns of excitation 2 are not written yet.
+    appendToFile("f (GHz), |S[1][1]| (dB), arg(S[1][1]) (deg.), |S[2][1]| (dB), arg(S[2][1]) (deg.), "
+                 "|S[1][2]| (dB), arg(S[1][2]) (deg.), |S[2][2]| (dB), arg(S[2][2]) (deg.)\n"
+                 "1.0, -20, 0, -3, 90, nan, nan, NULL, NULL\n"
+                 "2.0, -20, 0, -3, 90, nan, nan, NULL, NULL\n"
+                 "3.0, -20, 0, -3, 90, nan, nan, NULL, NULL\n");
+
+    PalaceSParameters tail(path);
+    tail.setBand(1.5e9, 2.5e9, 1e-6);
+
+    QString err;
+    QVERIFY(tail.poll(err));
+    QCOMPARE(tail.frequencyCount(), 3);
+    QCOMPARE(tail.ports(), 2);
+    QVERIFY(std::isnan(tail.network().value(1, 0, 1).real()));
+    QVERIFY(std::isnan(tail.network().value(1, 1, 1).real()));
+
+    // Quiet polls while the band is half reported do not converge.
+    for (int i = 0; i < 2 * PalaceSParameters::kStableUpdates; ++i) {
+        appendToFile(QByteArray::number(4.0 + i) + ", -20, 0, -3, 90, nan, nan, NULL, NULL\n");
+        QVERIFY(tail.poll(err));
+        QVERIFY(!tail.bandConverged());
+    }
+
+    // Excitation 2 fills its columns without touching those of excitation 1.
+    appendToFile("1.0, nan, nan, nan, nan, -3, 90, -20, 0\n"
+                 "2.0, nan, nan, nan, nan, -3, 90, -20, 0\n"
+                 "3.0, nan, nan, nan, nan, -3, 90, -20, 0\n");
+    QVERIFY(tail.poll(err));
+    QVERIFY(!tail.bandConverged());
+
+    const Touchstone::Network net = tail.network();
+    QVERIFY(std::abs(net.value(1, 0, 0) - Touchstone::Complex(0.1, 0.0)) < 1e-9);
+    QVERIFY(std::abs(net.value(1, 1, 1) - Touchstone::Complex(0.1, 0.0)) < 1e-9);
+
+    for (int i = 0; i < PalaceSParameters::kStableUpdates; ++i) {
+        QVERIFY(!tail.bandConverged());
+        appendToFile(QByteArray::number(8.0 + i) + ", nan, nan, nan, nan, -3, 90, -20, 0\n");
+        QVERIFY(tail.poll(err));
+    }
+    QVERIFY(tail.bandConverged());
+    QCOMPARE(tail.lastBandChange(), 0.0);
+}
@@ -0,0 +1,110 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_parameter_sweep.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "parametersweep.h"
+#include "simulationqueue.h"
+#include "test_utils.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that ParameterSweep writes one script per distinct variant, runs them and collects results.
+ *
+ * The value list contains a duplicate, which must not produce a second variant. A pre-created Touchstone file
+ * of the first variant has to show up in the result folder and the summary table.
+ **********************************************************************************************************************/
+void ParameterSweepTest::parameterSweep_generatesDistinctVariantsAndCollectsResults()
+{
+    QString err;
+    const QVariantList range = ParameterSweep::parseValues("1e9:1e9:3e9", err);
+    QCOMPARE(range.size(), 3);
+    QCOMPARE(range.at(2).toDouble(), 3e9);
+    QCOMPARE(ParameterSweep::parseValues("2:2:6", err), QVariantList() << 2 << 4 << 6);
+
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
+    QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
+
+#ifndef Q_OS_WIN
+    QFile::setPermissions(pyStub,
+                          QFile::permissions(pyStub) |
+                              QFileDevice::ExeUser |
+                              QFileDevice::ExeGroup |
+                              QFileDevice::ExeOther);
+#endif
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString model = dir.filePath("sweep_line.py");
+    {
+        QFile f(model);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("from openEMS import openEMS\n"
+                "cells_per_wavelength = 20   # mesh density\n"
+                "energy_limit = -50\n");
+    }
+
+    ParameterSweep sweep;
+    QVERIFY(!sweep.parseDefinition("unknown_key = 1, 2", err) || !sweep.generate(model, err));
+
+    QVERIFY2(sweep.parseDefinition("# convergence study\n"
+                                   "cells_per_wavelength = 10, 30, 10\n", err), qPrintable(err));
+    QVERIFY2(sweep.generate(model, err), qPrintable(err));
+    QCOMPARE(sweep.variants().size(), 2);
+
+    const ParameterSweep::Variant first = sweep.variants().at(0);
+    QCOMPARE(first.name, QString("sweep_line_sweep_001"));
+    {
+        QFile f(first.scriptPath);
+        QVERIFY(f.open(QIODevice::ReadOnly | QIODevice::Text));
+        const QString text = QString::fromUtf8(f.readAll());
+        QVERIFY2(text.contains("cells_per_wavelength = 10   # mesh density"), qPrintable(text));
+        QVERIFY2(text.contains("energy_limit = -50"), qPrintable(text));
+    }
+
+    QVERIFY(QDir().mkpath(dir.filePath("output/" + first.name)));
+    {
+        QFile f(dir.filePath("output/" + first.name + "/" + first.name + ".s2p"));
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("# Hz S RI R 50\n1e9 0 0 1 0 1 0 0 0\n");
+    }
+
+    QMap<QString, QVariant> prefs;
+    prefs["Python Path"] = pyStub;
+
+    QMap<QString, QVariant> simSettings;
+    simSettings["cells_per_wavelength"] = 20;
+
+    SimulationQueue queue;
+    queue.setCoreBudget(2);
+    QSignalSpy finishedSpy(&sweep, &ParameterSweep::finished);
+
+    QVERIFY2(sweep.dispatch(&queue, "openems", simSettings, prefs, err), qPrintable(err));
+    QTRY_COMPARE_WITH_TIMEOUT(finishedSpy.count(), 1, 10000);
+
+    const QString summaryPath = finishedSpy.at(0).at(0).toString();
+    QFile summary(summaryPath);
+    QVERIFY2(summary.open(QIODevice::ReadOnly | QIODevice::Text), qPrintable(summaryPath));
+    const QStringList lines = QString::fromUtf8(summary.readAll()).split('\n', Qt::SkipEmptyParts);
+
+    QCOMPARE(lines.size(), 3);
+    QCOMPARE(lines.at(0), QString("variant,cells_per_wavelength,state,exit_code,touchstone"));
+    QCOMPARE(lines.at(1), QString("sweep_line_sweep_001,10,Finished,0,sweep_line_sweep_001.s2p"));
+    QCOMPARE(lines.at(2), QString("sweep_line_sweep_002,30,Finished,0,"));
+    QVERIFY(QFileInfo::exists(QDir(sweep.resultDir()).filePath("sweep_line_sweep_001.s2p")));
+}
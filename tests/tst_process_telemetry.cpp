@@ -0,0 +1,143 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_process_telemetry.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include "processtelemetry.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that ProcessTelemetry walks a /proc tree, accumulates per-stage figures and writes the series.
+ *
+ * A fake proc directory holds a root process with a child and a grandchild (whose name contains spaces and
+ * parentheses) and an unrelated process. I/O of a process that exits between samples must be kept.
+ **********************************************************************************************************************/
+void ProcessTelemetryTest::processTelemetry_samplesProcessTreeAndWritesSeries()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto writeProc = [&dir](qint64 pid, qint64 ppid, const QString &name, int utime, int threads,
+                            int rssKb, int readBytes) {
+        const QString base = dir.filePath(QString("proc/%1").arg(pid));
+        if (!QDir().mkpath(base))
+            return false;
+
+        QFile stat(base + "/stat");
+        QFile status(base + "/status");
+        QFile io(base + "/io");
+        if (!stat.open(QIODevice::WriteOnly) || !status.open(QIODevice::WriteOnly) || !io.open(QIODevice::WriteOnly))
+            return false;
+
+        stat.write(QString("%1 (%2) S %3 %1 %1 0 -1 4194560 100 0 0 0 %4 10 0 0 20 0 %5 0 12345 1000 250\n")
+                       .arg(pid).arg(name).arg(ppid).arg(utime).arg(threads).toUtf8());
+        status.write(QString("Name:\t%1\nVmHWM:\t%2 kB\nVmRSS:\t%3 kB\nThreads:\t%4\n")
+                         .arg(name).arg(rssKb * 2).arg(rssKb).arg(threads).toUtf8());
+        io.write(QString("rchar: 1\nwchar: 2\nread_bytes: %1\nwrite_bytes: 512\n").arg(readBytes).toUtf8());
+        return true;
+    };
+
+    const QString procRoot = dir.filePath("proc");
+    QVERIFY(writeProc(100, 1, "python3", 100, 1, 1024, 4096));
+    QVERIFY(writeProc(101, 100, "mpirun", 10, 2, 2048, 0));
+    QVERIFY(writeProc(102, 101, "palace (rank 0)", 500, 4, 4096, 8192));
+    QVERIFY(writeProc(200, 1, "bash", 900, 1, 512, 0));
+
+    ProcessTelemetry::ProcessStat stat;
+    QVERIFY(ProcessTelemetry::parseStat("102 (palace (rank 0)) R 101 1 1 0 -1 0 0 0 0 0 500 10 0 0 20 0 4 0", stat));
+    QCOMPARE(stat.name, QString("palace (rank 0)"));
+    QCOMPARE(stat.ppid, qint64(101));
+    QCOMPARE(stat.cpuTicks, qint64(510));
+    QCOMPARE(stat.threads, 4);
+    QVERIFY(!ProcessTelemetry::parseStat("garbage", stat));
+
+    const QList<ProcessTelemetry::ProcessStat> tree = ProcessTelemetry::readProcessTree(procRoot, 100);
+    QCOMPARE(tree.size(), 3);
+    QCOMPARE(tree.at(0).pid, qint64(100));
+    QCOMPARE(tree.at(2).name, QString("palace (rank 0)"));
+    QCOMPARE(tree.at(2).rssBytes, qint64(4096) * 1024);
+    QCOMPARE(tree.at(2).peakRssBytes, qint64(8192) * 1024);
+    QCOMPARE(tree.at(2).readBytes, qint64(8192));
+    QVERIFY(ProcessTelemetry::readProcessTree(procRoot, 999).isEmpty());
+
+    ProcessTelemetry telemetry;
+    telemetry.setProcRoot(procRoot);
+    telemetry.setInterval(1000);
+    telemetry.reset();
+
+    telemetry.attach(100, "preprocess");
+    QVERIFY(telemetry.isAttached());
+    QVERIFY(writeProc(102, 101, "palace (rank 0)", 700, 4, 4096, 16384));
+    QTest::qWait(20);
+    telemetry.sampleNow();
+
+    QCOMPARE(telemetry.samples().size(), 1);
+    const ProcessTelemetry::Sample first = telemetry.samples().first();
+    QCOMPARE(first.stage, QString("preprocess"));
+    QCOMPARE(first.processes, 3);
+    QCOMPARE(first.threads, 7);
+    QCOMPARE(first.rssBytes, qint64(1024 + 2048 + 4096) * 1024);
+    QCOMPARE(first.readBytes, qint64(4096 + 16384));
+    QVERIFY(first.cpuPercent > 0.0);
+
+    // The grandchild exits; its I/O stays in the cumulative totals.
+    QVERIFY(QDir(procRoot + "/102").removeRecursively());
+    telemetry.attach(100, "solver");
+    telemetry.sampleNow();
+    telemetry.detach();
+    QVERIFY(!telemetry.isAttached());
+
+    QCOMPARE(telemetry.samples().size(), 2);
+    const ProcessTelemetry::Sample second = telemetry.samples().last();
+    QCOMPARE(second.processes, 2);
+    QCOMPARE(second.readBytes, qint64(4096 + 16384));
+    QCOMPARE(second.peakRssBytes, first.rssBytes);
+
+    const QList<ProcessTelemetry::StageSummary> stages = telemetry.stageSummaries();
+    QCOMPARE(stages.size(), 2);
+    QCOMPARE(stages.at(0).stage, QString("preprocess"));
+    QCOMPARE(stages.at(1).stage, QString("solver"));
+    QCOMPARE(stages.at(0).maxThreads, 7);
+    QCOMPARE(stages.at(1).readBytes, qint64(0));
+
+    const QList<QByteArray> rows = telemetry.toCsv().trimmed().split('\n');
+    QCOMPARE(rows.size(), 3);
+    QVERIFY(rows.at(0).startsWith("elapsed_ms,stage,processes,threads,cpu_percent"));
+    QVERIFY2(rows.at(2).contains(",solver,2,3,"), rows.at(2).constData());
+
+    const QString runDir = dir.filePath("palace_model/line_data");
+    QCOMPARE(ProcessTelemetry::filePathFor(runDir, ProcessTelemetry::Format::Json),
+             dir.filePath("palace_model/line_data_telemetry.json"));
+
+    QVERIFY(QDir().mkpath(runDir));
+    const QString jsonPath = ProcessTelemetry::filePathFor(runDir, ProcessTelemetry::Format::Json);
+    QString err;
+    QVERIFY2(telemetry.write(jsonPath, ProcessTelemetry::Format::Json, err), qPrintable(err));
+
+    QFile json(jsonPath);
+    QVERIFY(json.open(QIODevice::ReadOnly));
+    const QJsonObject root = QJsonDocument::fromJson(json.readAll()).object();
+    QCOMPARE(root.value("samples").toArray().size(), 2);
+    QCOMPARE(root.value("stages").toArray().at(1).toObject().value("stage").toString(), QString("solver"));
+
+    if (ProcessTelemetry::isSupported()) {
+        const QList<ProcessTelemetry::ProcessStat> self =
+            ProcessTelemetry::readProcessTree("/proc", QCoreApplication::applicationPid());
+        QVERIFY(!self.isEmpty());
+        QVERIFY(self.first().rssBytes > 0);
+    }
+}
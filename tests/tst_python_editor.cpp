@@ -60,11 +60,10 @@ void PythonEditorTest::updateVariableList_addsIdentifiersToCompleter()
         "for i in range(3):\n"
         "    gamma = i\n");
 
-    QCoreApplication::processEvents();
+    QTRY_VERIFY2(completionStrings(e).contains("alpha"), "Identifier 'alpha' not found in completer");
 
     const QStringList items = completionStrings(e);
 
-    QVERIFY2(items.contains("alpha"), "Identifier 'alpha' not found in completer");
     QVERIFY2(items.contains("beta_value"), "Identifier 'beta_value' not found in completer");
     QVERIFY2(items.contains("gamma"), "Identifier 'gamma' not found in completer");
 
@@ -238,3 +237,136 @@ void PythonEditorTest::setPlainTextUndoable_restoresPreviousTextWithUndo()
     e.undo();
     QCOMPARE(e.toPlainText(), QString("old text"));
 }
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that extra keywords are highlighted in code but not inside triple-quoted strings.
+ *
+ * The keyword appears once as plain code and once inside a string spanning several lines,
+ * which exercises the block state of the highlighter. Setting the keywords after the text
+ * checks that the visible region is refreshed without a full rehighlight.
+ **********************************************************************************************************************/
+void PythonEditorTest::extraKeywords_highlightedOutsideMultilineStrings()
+{
+    PythonEditor e;
+    e.resize(600, 400);
+
+    const QString text =
+        "tipkey = 1\n"
+        "doc = \"\"\"first\n"
+        "tipkey inside\n"
+        "\"\"\"\n"
+        "x = tipkey\n";
+
+    e.setPlainText(text);
+    e.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&e));
+
+    QVERIFY(!e.testIsExtraKeywordFormatAt(0));
+
+    e.setExtraHighlightKeywords(QStringList() << "tipkey");
+
+    QVERIFY2(e.testIsExtraKeywordFormatAt(0), "Extra keyword in code is not highlighted");
+    QVERIFY2(!e.testIsExtraKeywordFormatAt(text.indexOf("tipkey inside")),
+             "Extra keyword inside a multi-line string must not be highlighted");
+    QVERIFY2(e.testIsExtraKeywordFormatAt(text.lastIndexOf("tipkey")),
+             "Extra keyword after the multi-line string is not highlighted");
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that the identifier index follows incremental edits.
+ *
+ * Inserting a line adds its identifier, deleting the only occurrence of an identifier
+ * removes it from the completer, and identifiers in untouched lines stay available.
+ **********************************************************************************************************************/
+void PythonEditorTest::identifierIndex_followsIncrementalEdits()
+{
+    PythonEditor e;
+
+    e.setPlainText(
+        "alpha = 1\n"
+        "beta = 2\n");
+
+    e.testUpdateVariableList();
+    QVERIFY(completionStrings(e).contains("alpha"));
+    QVERIFY(completionStrings(e).contains("beta"));
+
+    QTextCursor c(e.document());
+    c.movePosition(QTextCursor::End);
+    c.insertText("gamma = alpha\n");
+
+    e.testUpdateVariableList();
+    QVERIFY(completionStrings(e).contains("gamma"));
+
+    c.movePosition(QTextCursor::Start);
+    c.movePosition(QTextCursor::Down);
+    c.select(QTextCursor::LineUnderCursor);
+    c.removeSelectedText();
+
+    e.testUpdateVariableList();
+    const QStringList items = completionStrings(e);
+    QVERIFY2(!items.contains("beta"), "Removed identifier 'beta' is still offered");
+    QVERIFY(items.contains("alpha"));
+    QVERIFY(items.contains("gamma"));
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that highlight-all refines cached matches and follows document edits.
+ *
+ * Extending the pattern narrows the match set, an edit adds a match without a new query,
+ * and findNext() with the active query walks the cached matches.
+ **********************************************************************************************************************/
+void PythonEditorTest::highlightAll_incrementalPatternAndEdits()
+{
+    PythonEditor e;
+
+    e.setPlainText(
+        "alpha alp alphabet\n"
+        "alpha\n");
+
+    e.highlightAll("alp", false, false, false);
+    QCOMPARE(e.testSearchMatchCount(), 4);
+
+    e.highlightAll("alpha", false, false, false);
+    QCOMPARE(e.testSearchMatchCount(), 3);
+
+    QTextCursor c(e.document());
+    c.movePosition(QTextCursor::End);
+    c.insertText("x = alpha\n");
+    QCOMPARE(e.testSearchMatchCount(), 4);
+
+    c.movePosition(QTextCursor::Start);
+    e.setTextCursor(c);
+    e.findNext("alpha", false, false, false);
+    QCOMPARE(e.textCursor().selectionStart(), 0);
+    QCOMPARE(e.textCursor().selectedText(), QString("alpha"));
+
+    e.clearHighlights();
+    QCOMPARE(e.testSearchMatchCount(), 0);
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that extending a self-overlapping pattern finds matches between the cached ones.
+ *
+ * "aa" in "aaab" is cached at offset 0 only, while "aab" matches at offset 1.
+ **********************************************************************************************************************/
+void PythonEditorTest::highlightAll_extendsSelfOverlappingPattern()
+{
+    PythonEditor e;
+
+    e.setPlainText(
+        "aaab\n"
+        "ab aab\n");
+
+    e.highlightAll("aa", false, false, false);
+    QCOMPARE(e.testSearchMatchCount(), 2);
+
+    e.highlightAll("aab", false, false, false);
+    QCOMPARE(e.testSearchMatchCount(), 2);
+
+    QTextCursor c(e.document());
+    c.movePosition(QTextCursor::Start);
+    e.setTextCursor(c);
+    e.findNext("aab", false, false, false);
+    QCOMPARE(e.textCursor().selectionStart(), 1);
+    QCOMPARE(e.textCursor().selectedText(), QString("aab"));
+}
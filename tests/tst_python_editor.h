@@ -28,6 +28,10 @@ private slots:
     void openFindDialog_createsDialog();
     void zoomAndFontSize_updateEditorFont_and_emitSignal();
     void setPlainTextUndoable_restoresPreviousTextWithUndo();
+    void extraKeywords_highlightedOutsideMultilineStrings();
+    void identifierIndex_followsIncrementalEdits();
+    void highlightAll_incrementalPatternAndEdits();
+    void highlightAll_extendsSelfOverlappingPattern();
 };
 
 #endif // TST_PYTHON_EDITOR_H
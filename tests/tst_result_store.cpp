@@ -0,0 +1,121 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_result_store.h"
+
+#include <QtTest/QtTest>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "resultstore.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that ResultStore ingests runs into mapped blocks, lists them newest first, reads single traces
+ *        and reports the deviation from the golden run, interpolating onto other frequency grids.
+ **********************************************************************************************************************/
+void ResultStoreTest::resultStore_ingestsAndComparesRuns()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto makeNetwork = [](const QVector<double> &ghz, double s21Offset) {
+        Touchstone::Network net;
+        net.resize(2, ghz.size());
+        for (int f = 0; f < ghz.size(); ++f) {
+            net.frequencies[f] = ghz.at(f) * 1e9;
+            net.setValue(f, 0, 0, Touchstone::Complex(0.1 * ghz.at(f), -0.05));
+            net.setValue(f, 1, 0, Touchstone::Complex(0.9 - 0.1 * ghz.at(f), 0.2 * ghz.at(f)));
+            net.setValue(f, 0, 1, net.value(f, 1, 0));
+            net.setValue(f, 1, 1, Touchstone::Complex(0.3, 0.0));
+        }
+        net.values[(1 * 2 + 1) * 2 + 0] += s21Offset;     // S21 at the second frequency
+        return net;
+    };
+
+    QJsonObject stage;
+    stage["name"] = "solver";
+    stage["duration_ms"] = 1500.0;
+    QJsonObject report;
+    report["model"] = "/work/inductor.py";
+    report["sim_key"] = "palace";
+    report["started"] = "2025-03-01T10:00:00.000";
+    report["stages"] = QJsonArray({stage, stage});
+
+    ResultStore::RunInfo base = ResultStore::infoFromReport(report);
+    QCOMPARE(base.cell, QString("inductor"));
+    QCOMPARE(base.stageMs.value("solver"), qint64(3000));
+
+    ResultStore store(dir.path());
+    QString err;
+    QStringList ids;
+    const QList<Touchstone::Network> networks = {
+        makeNetwork({1.0, 2.0, 3.0}, 0.0),
+        makeNetwork({1.0, 2.0, 3.0}, 0.1),
+        makeNetwork({1.5, 2.5}, 0.0),
+    };
+    for (int i = 0; i < networks.size(); ++i) {
+        ResultStore::RunInfo info = base;
+        info.created = base.created.addSecs(i);
+        QVERIFY2(store.ingest(networks.at(i), info, err), qPrintable(err));
+        QVERIFY(QFileInfo::exists(dir.filePath(info.id + ResultStore::kBlockSuffix)));
+        ids << info.id;
+    }
+
+    const QList<ResultStore::RunInfo> runs = ResultStore(dir.path()).runs("inductor");
+    QCOMPARE(runs.size(), 3);
+    QCOMPARE(runs.first().id, ids.at(2));
+    QCOMPARE(runs.last().frequencies, 3);
+    QVERIFY(store.runs("other").isEmpty());
+
+    ResultStore::Trace trace;
+    QVERIFY2(store.readTrace(ids.at(1), 1, 0, trace, err), qPrintable(err));
+    QCOMPARE(trace.frequencies, networks.at(1).frequencies);
+    QVERIFY(trace.values.at(1) == networks.at(1).value(1, 1, 0));
+    QVERIFY(!store.readTrace(ids.at(1), 2, 0, trace, err));
+
+    Touchstone::Network back;
+    QVERIFY2(store.readNetwork(ids.at(0), back, err), qPrintable(err));
+    QCOMPARE(back.values, networks.at(0).values);
+    QCOMPARE(back.references, networks.at(0).references);
+
+    const QList<ResultStore::Trace> overlay = store.overlay("inductor", 1, 0, 2);
+    QCOMPARE(overlay.size(), 2);
+    QCOMPARE(overlay.first().runId, ids.at(2));
+
+    QVERIFY2(store.setGolden("inductor", ids.at(0), err), qPrintable(err));
+    QCOMPARE(ResultStore(dir.path()).golden("inductor"), ids.at(0));
+
+    ResultStore::Deviation d;
+    QVERIFY2(store.compare(ids.at(1), ids.at(0), d, err), qPrintable(err));
+    QVERIFY(qAbs(d.maxDeviation - 0.1) < 1e-12);
+    QCOMPARE(d.row, 1);
+    QCOMPARE(d.column, 0);
+    QCOMPARE(d.frequency, 2e9);
+
+    const QList<ResultStore::Deviation> deviations = store.deviationsFromGolden("inductor", -1);
+    QCOMPARE(deviations.size(), 2);
+    QCOMPARE(deviations.first().runId, ids.at(2));
+    QVERIFY(deviations.first().maxDeviation < 1e-12);
+
+    const QList<QByteArray> csv = store.summaryCsv("inductor", -1).split('\n');
+    QVERIFY(csv.at(0).startsWith("id,created,cell,sim_key,ports,frequencies,solver_s,golden,max_deviation"));
+    QVERIFY(csv.at(2).startsWith(ids.at(1).toUtf8() + ','));
+    QVERIFY(csv.at(2).contains(",3.000,0,0.1,S21,2,"));
+
+    QVERIFY2(store.remove(ids.at(0), err), qPrintable(err));
+    QCOMPARE(store.runs().size(), 2);
+    QVERIFY(store.golden("inductor").isEmpty());
+    QVERIFY(!QFileInfo::exists(dir.filePath(ids.at(0) + ResultStore::kBlockSuffix)));
+}
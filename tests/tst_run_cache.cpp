@@ -0,0 +1,244 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_run_cache.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "pathprobe.h"
+#include "runcache.h"
+#include "shellsession.h"
+#include "simulationrunner.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that RunCache serves a repeated openEMS run from its results and reruns it on changed inputs.
+ *
+ * A shell stub stands in for Python: it reports a data directory, writes a Touchstone file there and counts
+ * its invocations. The second identical run must be a cache hit, a changed GDS file must run again.
+ **********************************************************************************************************************/
+void RunCacheTest::runCache_reusesIdenticalRunsAndDetectsChangedInputs()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Uses a POSIX shell stub as Python interpreter");
+#else
+    QStandardPaths::setTestModeEnabled(true);
+    QFile::remove(RunCache::defaultIndexPath());
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto writeFile = [](const QString &path, const QByteArray &content) {
+        QFile f(path);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate))
+            return false;
+        return f.write(content) == content.size();
+    };
+
+    const QString pyStub = dir.filePath("python_stub.sh");
+    QVERIFY(writeFile(pyStub,
+                      "#!/bin/sh\n"
+                      "d=\"$(dirname \"$1\")/output/cached_line\"\n"
+                      "mkdir -p \"$d\"\n"
+                      "echo \"Simulation data directory: $d\"\n"
+                      "echo run >> \"$(dirname \"$1\")/runs.txt\"\n"
+                      "printf '# Hz S RI R 50\\n1e9 0.5 0\\n' > \"$d/cached_line.s1p\"\n"));
+    QFile::setPermissions(pyStub, QFile::permissions(pyStub) | QFileDevice::ExeUser);
+
+    const QString model = dir.filePath("cached_line.py");
+    const QString gds   = dir.filePath("cached_line.gds");
+    const QString xml   = dir.filePath("stack.xml");
+    QVERIFY(writeFile(model, "from openEMS import openEMS\n"));
+    QVERIFY(writeFile(gds, "GDS-A"));
+    QVERIFY(writeFile(xml, "<Stack/>"));
+
+    QMap<QString, QVariant> simSettings;
+    simSettings["RunPythonScript"] = model;
+    simSettings["RunDir"]          = dir.path();
+    simSettings["GdsFile"]         = gds;
+    simSettings["SubstrateFile"]   = xml;
+
+    QMap<QString, QVariant> prefs;
+    prefs["Python Path"] = pyStub;
+
+    auto runOnce = [&](QByteArray &output) {
+        SimulationRunner runner;
+        runner.setPreferences(prefs);
+        runner.setSimSettings(simSettings);
+        runner.setSimToolKey("openems");
+        connect(&runner, &SimulationRunner::output, &runner, [&output](const QByteArray &data) {
+            output += data;
+        });
+        QSignalSpy finishedSpy(&runner, &SimulationRunner::finished);
+        runner.runOpenEMS();
+        return finishedSpy.count() == 1 || finishedSpy.wait(5000) ? finishedSpy.at(0).at(0).toInt() : -1;
+    };
+    auto runCount = [&dir]() {
+        QFile f(dir.filePath("runs.txt"));
+        return f.open(QIODevice::ReadOnly) ? f.readAll().count('\n') : 0;
+    };
+
+    QByteArray first;
+    QCOMPARE(runOnce(first), 0);
+    QCOMPARE(runCount(), 1);
+    QVERIFY2(!first.contains("[Run cache hit"), first.constData());
+
+    QByteArray second;
+    QCOMPARE(runOnce(second), 0);
+    QCOMPARE(runCount(), 1);
+    QVERIFY2(second.contains("[Run cache hit"), second.constData());
+    QVERIFY2(second.contains("cached_line.s1p"), second.constData());
+
+    QVERIFY(writeFile(gds, "GDS-B changed"));
+    QByteArray third;
+    QCOMPARE(runOnce(third), 0);
+    QCOMPARE(runCount(), 2);
+    QVERIFY2(!third.contains("[Run cache hit"), third.constData());
+
+    prefs["RUN_CACHE"] = false;
+    QByteArray fourth;
+    QCOMPARE(runOnce(fourth), 0);
+    QCOMPARE(runCount(), 3);
+
+    // A changed solver only invalidates the run key; the preprocessing key stays the same.
+    const QString solverA = dir.filePath("palace-0.13");
+    const QString solverB = dir.filePath("palace-0.14");
+    QVERIFY(writeFile(solverA, "palace 0.13"));
+    QVERIFY(writeFile(solverB, "palace 0.14"));
+
+    RunCache::Inputs inputs;
+    inputs.simKey       = "palace";
+    inputs.scriptPath   = model;
+    inputs.gdsPath      = gds;
+    inputs.preprocessor = pyStub;
+    inputs.solver       = solverA;
+    const RunCache::Key a = RunCache::fingerprint(inputs);
+    inputs.solver = solverB;
+    const RunCache::Key b = RunCache::fingerprint(inputs);
+    QVERIFY(a.isValid() && b.isValid());
+    QCOMPARE(a.prep, b.prep);
+    QVERIFY(a.run != b.run);
+
+    // A tool that cannot be identified yields no key: such a run is never served from the cache.
+    inputs.solver = dir.filePath("missing/palace");
+    QVERIFY(!RunCache::fingerprint(inputs).isValid());
+    inputs.solver = solverB;
+
+    RunCache cache(dir.filePath("index.json"));
+    const QString runDir = dir.filePath("palace_data");
+    QVERIFY(QDir().mkpath(runDir));
+    QString err;
+    QVERIFY2(cache.recordPreprocessed(a, runDir, err), qPrintable(err));
+    QCOMPARE(cache.lookupPreprocessed(b).runDir, QFileInfo(runDir).absoluteFilePath());
+    QVERIFY(!cache.lookupResults(a).isValid());
+
+    cache.invalidate(runDir);
+    QVERIFY(!cache.lookupPreprocessed(b).isValid());
+
+    QStandardPaths::setTestModeEnabled(false);
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that tools inside WSL are identified through the shell and change identity when upgraded.
+ *
+ * A local /bin/sh stands in for the WSL session; the solver is found by path and by name in the shell's PATH.
+ **********************************************************************************************************************/
+void RunCacheTest::runCache_identifiesWslToolsThroughShell()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Uses a local /bin/sh as stand-in for the WSL shell");
+#else
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString binDir = dir.filePath("bin");
+    QVERIFY(QDir().mkpath(binDir));
+    const QString palace = QDir(binDir).filePath("emstudio_test_palace");
+    {
+        QFile f(palace);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write("#!/bin/sh\n");
+    }
+    QFile::setPermissions(palace, QFile::permissions(palace) | QFileDevice::ExeUser);
+
+    ShellSession shell;
+    PathProbe probe(&shell);
+
+    const QString byPath = RunCache::wslToolIdentity(palace, QString(), probe);
+    QVERIFY2(byPath.startsWith("wsl|" + palace + "|"), qPrintable(byPath));
+
+    // Upgrading the solver inside WSL changes its identity.
+    {
+        QFile f(palace);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Append));
+        f.write("echo upgraded\n");
+    }
+    QVERIFY(RunCache::wslToolIdentity(palace, QString(), probe) != byPath);
+
+    QVERIFY(RunCache::wslToolIdentity(QDir(binDir).filePath("missing"), QString(), probe).isEmpty());
+    QVERIFY(RunCache::wslToolIdentity("emstudio_missing_solver", QString(), probe).isEmpty());
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that bare tool names resolve in a login shell, like the solver and Python runs do, so a PATH
+ *        entry from the profile wins over the PATH of the probing shell.
+ **********************************************************************************************************************/
+void RunCacheTest::runCache_resolvesWslToolsInLoginShell()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Uses a local /bin/sh as stand-in for the WSL shell");
+#else
+    if (QStandardPaths::findExecutable("bash").isEmpty())
+        QSKIP("bash not available");
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    auto writeTool = [](const QString &path, const QByteArray &body) {
+        QVERIFY(QDir().mkpath(QFileInfo(path).absolutePath()));
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write(body);
+        f.close();
+        QFile::setPermissions(path, QFile::permissions(path) | QFileDevice::ExeUser);
+    };
+
+    // The venv interpreter is on the login PATH only; the probing shell sees a system one of the same name.
+    const QString venvPython = dir.filePath("venv/bin/emstudio_test_python3");
+    const QString systemPython = dir.filePath("usr/bin/emstudio_test_python3");
+    writeTool(venvPython, "#!/bin/sh\n# venv\n");
+    writeTool(systemPython, "#!/bin/sh\n");
+    {
+        QFile profile(dir.filePath(".bash_profile"));
+        QVERIFY(profile.open(QIODevice::WriteOnly));
+        profile.write(QString("PATH=\"%1:$PATH\"\nexport PATH\necho profile output\n")
+                          .arg(QFileInfo(venvPython).absolutePath()).toUtf8());
+    }
+
+    ShellSession shell;
+    PathProbe probe(&shell);
+    QVERIFY(shell.run(QString("HOME='%1'; PATH='%2':$PATH; export HOME PATH")
+                          .arg(dir.path(), QFileInfo(systemPython).absolutePath())).ok);
+
+    const ShellSession::Reply nonLogin = shell.run("command -v emstudio_test_python3");
+    QCOMPARE(nonLogin.text(), systemPython);
+
+    const QString identity = RunCache::wslToolIdentity("emstudio_test_python3", QString(), probe);
+    QVERIFY2(identity.startsWith("wsl|" + venvPython + "|"), qPrintable(identity));
+    QCOMPARE(identity, RunCache::wslToolIdentity(venvPython, QString(), probe));
+#endif
+}
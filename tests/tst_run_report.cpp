@@ -0,0 +1,79 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_run_report.h"
+
+#include <QtTest/QtTest>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+#include "runreport.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that RunReport records stage timings and exit codes, and that reports found below a directory
+ *        are aggregated into one CSV table with a column per stage, in start order.
+ **********************************************************************************************************************/
+void RunReportTest::runReport_recordsStagesAndAggregatesCsv()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("first/out"));
+    QVERIFY(QDir(dir.path()).mkpath("second"));
+
+    RunReport first;
+    first.begin("palace", dir.filePath("first/model.py"));
+    first.setCacheStatus("miss");
+    first.setFingerprint("prepkey", "runkey");
+    first.setCores(4);
+    first.addStage("save", QDateTime::currentDateTime().addMSecs(-1500), 1500);
+    first.beginStage("preprocess");
+    QVERIFY(first.hasOpenStage());
+    first.beginStage("solver");
+    const RunReport::Stage solver = first.endStage(0);
+    QCOMPARE(solver.name, QString("solver"));
+    QVERIFY(!first.hasOpenStage());
+    first.beginStage("postprocess");
+    first.finish(0);
+    QVERIFY(!first.isActive());
+
+    QCOMPARE(first.stages().size(), 4);
+    QCOMPARE(first.stages().at(0).durationMs(), qint64(1500));
+    QVERIFY(first.stages().at(3).finished.isValid());
+
+    const QJsonObject json = first.toJson();
+    QCOMPARE(json.value("sim_key").toString(), QString("palace"));
+    QCOMPARE(json.value("cores").toInt(), 4);
+    QCOMPARE(json.value("cache").toString(), QString("miss"));
+    QCOMPARE(json.value("fingerprints").toObject().value("run").toString(), QString("runkey"));
+    QCOMPARE(json.value("stages").toArray().size(), 4);
+
+    QString err;
+    QVERIFY2(first.write(dir.filePath("first/out/" + RunReport::fileName()), err), qPrintable(err));
+
+    QTest::qWait(20);
+    RunReport second;
+    second.begin("openems", dir.filePath("second/other.py"));
+    second.setCacheStatus("hit");
+    second.finish(3);
+    QVERIFY2(second.write(dir.filePath("second/" + RunReport::fileName()), err), qPrintable(err));
+
+    const QStringList reports = RunReport::findReports(dir.path());
+    QCOMPARE(reports.size(), 2);
+
+    const QStringList lines = QString::fromUtf8(RunReport::aggregateCsv(reports)).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(lines.size(), 3);
+    QVERIFY(lines.at(0).startsWith("started,model,sim_key,exit_code,cores,cache,wall_s,"
+                                   "save_s,preprocess_s,solver_s,postprocess_s,report"));
+    QVERIFY(lines.at(1).contains(",model,palace,0,4,miss,"));
+    QVERIFY(lines.at(1).contains(",1.500,"));
+    QVERIFY(lines.at(2).contains(",other,openems,3,0,hit,"));
+}
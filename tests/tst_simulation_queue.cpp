@@ -0,0 +1,210 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_simulation_queue.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+
+#include "simulationqueue.h"
+#include "test_utils.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that SimulationQueue splits the core budget, runs jobs concurrently and keeps per-job logs.
+ *
+ * Three OpenEMS stub jobs share a budget of four cores and start at once; a fourth job of an already running
+ * model has to wait until that model's run is done.
+ **********************************************************************************************************************/
+void SimulationQueueTest::simulationQueue_runsJobsConcurrentlyWithinCoreBudget()
+{
+    QCOMPARE(SimulationQueue::coresForJob(0, 16, 16, 1), 16);
+    QCOMPARE(SimulationQueue::coresForJob(0, 16, 16, 30), 1);
+    QCOMPARE(SimulationQueue::coresForJob(0, 16, 16, 2), 8);
+    QCOMPARE(SimulationQueue::coresForJob(32, 16, 16, 1), 16);
+    QCOMPARE(SimulationQueue::coresForJob(0, 0, 16, 1), 0);
+
+    const QString pyStub = GoldenTestUtils::ensureTestOpenemsPythonStub();
+    QVERIFY2(!pyStub.isEmpty(), "OpenEMS python stub not found via QFINDTESTDATA");
+
+#ifndef Q_OS_WIN
+    QFile::setPermissions(pyStub,
+                          QFile::permissions(pyStub) |
+                              QFileDevice::ExeUser |
+                              QFileDevice::ExeGroup |
+                              QFileDevice::ExeOther);
+#endif
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    QMap<QString, QVariant> prefs;
+    prefs["Python Path"] = pyStub;
+
+    SimulationQueue queue;
+    queue.setCoreBudget(4);
+    QSignalSpy idleSpy(&queue, &SimulationQueue::idle);
+
+    int maxRunning = 0;
+    connect(&queue, &SimulationQueue::jobStateChanged, &queue, [&queue, &maxRunning]() {
+        maxRunning = qMax(maxRunning, queue.runningCount());
+        QVERIFY(queue.usedCores() <= queue.coreBudget());
+    });
+
+    QList<int> ids;
+    for (int i = 0; i < 4; ++i) {
+        const QString model = dir.filePath(QString("queued_%1.py").arg(i == 3 ? 0 : i));
+        QFile f(model);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("from openEMS import openEMS\n");
+        f.close();
+
+        SimulationQueue::JobSpec spec;
+        spec.name = QFileInfo(model).completeBaseName();
+        spec.simKey = "openems";
+        spec.preferences = prefs;
+        spec.simSettings["RunPythonScript"] = QFileInfo(model).absoluteFilePath();
+        spec.simSettings["RunDir"] = dir.path();
+        ids << queue.enqueue(spec);
+    }
+
+    QCOMPARE(queue.pendingCount(), 4);
+    QCOMPARE(queue.runningCount(), 0);
+
+    QTRY_VERIFY_WITH_TIMEOUT(idleSpy.count() >= 1, 10000);
+    QVERIFY(queue.isIdle());
+    QCOMPARE(queue.usedCores(), 0);
+    QCOMPARE(maxRunning, 3);
+
+    QCOMPARE(queue.jobInfo(ids.at(0)).cores, 1);
+    QCOMPARE(queue.jobInfo(ids.at(1)).cores, 1);
+    QCOMPARE(queue.jobInfo(ids.at(2)).cores, 2);
+
+    for (int id : ids) {
+        const SimulationQueue::JobInfo job = queue.jobInfo(id);
+        QCOMPARE(job.state, SimulationQueue::JobState::Finished);
+
+        const QByteArray log = queue.jobLog(id);
+        QVERIFY2(log.contains(QString("[Job %1]").arg(id).toUtf8()), log.constData());
+        QVERIFY2(log.contains("[Simulation finished with exit code 0]"), log.constData());
+    }
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that a pipelined SimulationQueue preprocesses the next Palace model while the current solver runs.
+ *
+ * Shell stubs stand in for the gds2palace Python model and the Palace launcher and log their start and end
+ * into a shared event file. The preprocessing of the second model must start before the first solver ends,
+ * while the solvers themselves run one after the other on the cores not reserved for preprocessing.
+ **********************************************************************************************************************/
+void SimulationQueueTest::simulationQueue_pipelinesPreprocessingWithSolver()
+{
+#ifdef Q_OS_WIN
+    QSKIP("Uses POSIX shell stubs as Python interpreter and Palace launcher");
+#else
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString events = dir.filePath("events.txt");
+
+    auto writeScript = [](const QString &path, const QByteArray &content) {
+        QFile f(path);
+        if (!f.open(QIODevice::WriteOnly | QIODevice::Truncate) || f.write(content) != content.size())
+            return false;
+        f.close();
+        return QFile::setPermissions(path, QFile::permissions(path) | QFileDevice::ExeUser);
+    };
+
+    const QString pyStub = dir.filePath("python_stub.sh");
+    QVERIFY(writeScript(pyStub,
+                        "#!/bin/sh\n"
+                        "m=$(basename \"$1\" .py)\n"
+                        "d=\"$(dirname \"$1\")/palace_model/${m}_data\"\n"
+                        "echo \"prep-start $m\" >> \"$(dirname \"$1\")/events.txt\"\n"
+                        "mkdir -p \"$d\" && echo '{}' > \"$d/config.json\"\n"
+                        "sleep 0.2\n"
+                        "echo \"prep-end $m\" >> \"$(dirname \"$1\")/events.txt\"\n"));
+
+    const QString launcher = dir.filePath("launcher_stub.sh");
+    QVERIFY(writeScript(launcher,
+                        QString("#!/bin/sh\n"
+                                "m=$(basename \"$(dirname \"$1\")\" _data)\n"
+                                "echo \"solve-start $m\" >> '%1'\n"
+                                "sleep 1\n"
+                                "echo \"solve-end $m\" >> '%1'\n").arg(events).toUtf8()));
+
+    QMap<QString, QVariant> prefs;
+    prefs["PALACE_PYTHON"]          = pyStub;
+    prefs["PALACE_RUN_MODE"]        = 1;
+    prefs["PALACE_RUN_SCRIPT"]      = launcher;
+    prefs["RUN_CACHE"]              = false;
+    prefs["PIPELINE_PREPROCESSING"] = true;
+    prefs["PREPROCESS_CORES"]       = 1;
+
+    SimulationQueue queue;
+    queue.setCoreBudget(3);
+    queue.applyPreferences(prefs);
+    QVERIFY(queue.isPipelined());
+    QSignalSpy idleSpy(&queue, &SimulationQueue::idle);
+
+    int maxSolvers = 0;
+    connect(&queue, &SimulationQueue::jobStateChanged, &queue, [&queue, &maxSolvers]() {
+        int solvers = 0;
+        for (int id : queue.jobIds()) {
+            if (queue.jobInfo(id).state == SimulationQueue::JobState::Running)
+                ++solvers;
+        }
+        maxSolvers = qMax(maxSolvers, solvers);
+    });
+
+    QList<int> ids;
+    for (int i = 0; i < 3; ++i) {
+        const QString model = dir.filePath(QString("pipe_%1.py").arg(i));
+        QFile f(model);
+        QVERIFY(f.open(QIODevice::WriteOnly | QIODevice::Text));
+        f.write("settings = {}\n");
+        f.close();
+
+        SimulationQueue::JobSpec spec;
+        spec.name = QFileInfo(model).completeBaseName();
+        spec.simKey = "palace";
+        spec.preferences = prefs;
+        spec.simSettings["RunPythonScript"] = QFileInfo(model).absoluteFilePath();
+        spec.simSettings["RunDir"] = dir.path();
+        ids << queue.enqueue(spec);
+    }
+
+    QTRY_VERIFY_WITH_TIMEOUT(idleSpy.count() >= 1, 20000);
+    QCOMPARE(queue.usedCores(), 0);
+    QCOMPARE(maxSolvers, 1);
+
+    for (int id : ids) {
+        const SimulationQueue::JobInfo job = queue.jobInfo(id);
+        QVERIFY2(job.state == SimulationQueue::JobState::Finished, queue.jobLog(id).constData());
+        QCOMPARE(job.cores, 2);
+    }
+
+    QVERIFY2(queue.jobLog(ids.at(1)).contains("[Preprocessing done, solver stage waiting for free cores]"),
+             queue.jobLog(ids.at(1)).constData());
+
+    QFile f(events);
+    QVERIFY(f.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList order = QString::fromUtf8(f.readAll()).split('\n', Qt::SkipEmptyParts);
+    QCOMPARE(order.size(), 12);
+
+    QVERIFY2(order.indexOf("prep-start pipe_1") < order.indexOf("solve-end pipe_0"), qPrintable(order.join(", ")));
+    QVERIFY2(order.indexOf("solve-end pipe_0") < order.indexOf("solve-start pipe_1"), qPrintable(order.join(", ")));
+    QVERIFY2(order.indexOf("solve-end pipe_1") < order.indexOf("solve-start pipe_2"), qPrintable(order.join(", ")));
+#endif
+}
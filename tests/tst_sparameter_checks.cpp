@@ -0,0 +1,80 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_sparameter_checks.h"
+
+#include <QtTest/QtTest>
+#include <QtMath>
+
+#include "sparameterchecks.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies the passivity, reciprocity and causality checks on a matched delay line and on variants that
+ *        violate one property each.
+ **********************************************************************************************************************/
+void SParameterChecksTest::sParameterChecks_flagsNonPassiveAndNonCausalData()
+{
+    const double re[4] = {1.0, 2.0, 3.0, 4.0};
+    const double im[4] = {0.0, 0.0, 0.0, 0.0};
+    QVERIFY(qAbs(SParameterChecks::largestSingularValue(re, im, 2) - 5.46498570421904) < 1e-9);
+    QVERIFY(qAbs(SParameterChecks::asymmetry(re, im, 2) - qSqrt(2.0 / 30.0)) < 1e-12);
+
+    // Lossy 2-port delay line, 0.1-20 GHz: S21 = S12 = 0.9 exp(-jwt), small reflections.
+    auto makeLine = [](double delay, double gain, double sign) {
+        Touchstone::Network net;
+        net.resize(2, 201);
+        for (int f = 0; f < net.frequencyCount(); ++f) {
+            const double hz = 0.1e9 + f * 0.0995e9;
+            const Touchstone::Complex s21 = std::polar(0.9 * gain, -sign * 2 * M_PI * hz * delay);
+            net.frequencies[f] = hz;
+            net.setValue(f, 0, 0, Touchstone::Complex(0.1, 0.0));
+            net.setValue(f, 1, 1, Touchstone::Complex(0.1, 0.0));
+            net.setValue(f, 1, 0, s21);
+            net.setValue(f, 0, 1, s21);
+        }
+        return net;
+    };
+
+    SParameterChecks::Options options;
+    options.threads = 4;
+
+    const SParameterChecks::Result good = SParameterChecks::check(makeLine(200e-12, 1.0, 1.0), options);
+    QCOMPARE(good.ports, 2);
+    QCOMPARE(good.frequencies, 201);
+    QVERIFY(good.maxSingularValue > 0.99 && good.maxSingularValue <= 1.0 + 1e-12);
+    QVERIFY(good.maxAsymmetry < 1e-15);
+    QVERIFY(good.maxNonCausalEnergy >= 0.0 && good.maxNonCausalEnergy < 1e-3);
+    QVERIFY(good.passed());
+
+    const SParameterChecks::Result gain = SParameterChecks::check(makeLine(200e-12, 1.2, 1.0), options);
+    QVERIFY(!gain.passive);
+    QVERIFY(gain.reciprocal && gain.causal);
+
+    const SParameterChecks::Result advance = SParameterChecks::check(makeLine(200e-12, 1.0, -1.0), options);
+    QVERIFY(!advance.causal);
+    QVERIFY(advance.nonCausalRow != advance.nonCausalColumn);
+    QVERIFY(advance.summary().last().contains("FAIL"));
+
+    Touchstone::Network skewed = makeLine(200e-12, 1.0, 1.0);
+    skewed.setValue(100, 0, 1, Touchstone::Complex(0.0, 0.0));
+    const SParameterChecks::Result nonReciprocal = SParameterChecks::check(skewed, options);
+    QVERIFY(!nonReciprocal.reciprocal);
+    QCOMPARE(nonReciprocal.asymmetryFrequency, skewed.frequencies.at(100));
+
+    Touchstone::Network coarse = makeLine(200e-12, 1.0, 1.0);
+    coarse.resize(2, SParameterChecks::kMinCausalitySamples - 1);
+    const SParameterChecks::Result skipped = SParameterChecks::check(coarse, options);
+    QVERIFY(skipped.maxNonCausalEnergy < 0.0);
+    QVERIFY(skipped.causal);
+    QVERIFY(skipped.summary().last().contains("skipped"));
+}
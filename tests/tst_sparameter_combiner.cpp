@@ -0,0 +1,124 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_sparameter_combiner.h"
+
+#include <QtTest/QtTest>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "sparametercombiner.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies merging of overlapping sweeps, the three interpolation methods, DC extension and the per-run
+ *        conversion that replaces combine_extend_snp.py.
+ **********************************************************************************************************************/
+void SParameterCombinerTest::sParameterCombiner_mergesResamplesAndExtendsToDc()
+{
+    // Matched 100 ps line: S21 = S12 = 0.9 exp(-jwt), constant reflections.
+    auto s21 = [](double hz) { return std::polar(0.9, -2 * M_PI * hz * 100e-12); };
+    auto makeSweep = [&](double fStart, int points, double s11) {
+        Touchstone::Network net;
+        net.resize(2, points);
+        for (int f = 0; f < points; ++f) {
+            const double hz = fStart + f * 0.5e9;
+            net.frequencies[f] = hz;
+            net.setValue(f, 0, 0, Touchstone::Complex(s11, 0.05));
+            net.setValue(f, 1, 1, Touchstone::Complex(s11, 0.05));
+            net.setValue(f, 1, 0, s21(hz));
+            net.setValue(f, 0, 1, s21(hz));
+        }
+        return net;
+    };
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("inductor"));
+
+    const QString low = dir.filePath("inductor/low.s2p");
+    const QString high = dir.filePath("inductor/high.s2p");
+    Touchstone::WriteOptions options;
+    options.precision = 15;
+    QString err;
+    QVERIFY2(Touchstone::write(low, makeSweep(0.5e9, 20, 0.1), options, err), qPrintable(err));
+    QVERIFY2(Touchstone::write(high, makeSweep(10e9, 41, 0.2), options, err), qPrintable(err));
+
+    // 0.5-10 GHz and 10-30 GHz share 10 GHz, which is taken from the sweep listed last.
+    SParameterCombiner::Options noDc;
+    noDc.extendToDc = false;
+    Touchstone::Network merged;
+    QVERIFY2(SParameterCombiner::combine({ low, high }, noDc, merged, err), qPrintable(err));
+    QCOMPARE(merged.frequencyCount(), 60);
+    QCOMPARE(merged.frequencies.at(19), 10e9);
+    QVERIFY(std::abs(merged.value(19, 0, 0) - Touchstone::Complex(0.2, 0.05)) < 1e-12);
+    QVERIFY(std::abs(merged.value(18, 0, 0) - Touchstone::Complex(0.1, 0.05)) < 1e-12);
+
+    Touchstone::Network threePort;
+    threePort.resize(3, 1);
+    threePort.frequencies[0] = 1e9;
+    Touchstone::Network failed;
+    QVERIFY(!SParameterCombiner::merge({ merged, threePort }, 1e-9, failed, err));
+
+    // The line is exactly linear in polar form, so the spline reproduces it; the rational interpolant on real and
+    // imaginary parts beats linear interpolation by far.
+    const QVector<double> grid = SParameterCombiner::linearGrid(1e9, 29e9, 281);
+    double maxError[3] = { 0.0, 0.0, 0.0 };
+    for (SParameterCombiner::Interpolation method : { SParameterCombiner::Interpolation::Linear,
+                                                      SParameterCombiner::Interpolation::Spline,
+                                                      SParameterCombiner::Interpolation::Rational }) {
+        Touchstone::Network resampled;
+        QVERIFY2(SParameterCombiner::resample(merged, grid, method, 4, resampled, err), qPrintable(err));
+        QCOMPARE(resampled.frequencies, grid);
+        for (int f = 0; f < grid.size(); ++f) {
+            double &e = maxError[int(method)];
+            e = qMax(e, std::abs(resampled.value(f, 1, 0) - s21(grid.at(f))));
+        }
+    }
+    QVERIFY(maxError[int(SParameterCombiner::Interpolation::Spline)] < 1e-9);
+    QVERIFY(maxError[int(SParameterCombiner::Interpolation::Rational)] < 1e-3);
+    QVERIFY(maxError[int(SParameterCombiner::Interpolation::Linear)] > 5e-3);
+
+    SParameterCombiner::Interpolation parsed;
+    QVERIFY(SParameterCombiner::parseInterpolation("Rational", parsed));
+    QVERIFY(parsed == SParameterCombiner::Interpolation::Rational);
+    QVERIFY(!SParameterCombiner::parseInterpolation("quadratic", parsed));
+
+    // Starting at 0.5 GHz with 0.5 GHz spacing, one point is added: the real DC estimate.
+    QVERIFY(SParameterCombiner::canExtendToDc(merged, SParameterCombiner::Options()));
+    QVERIFY(!SParameterCombiner::canExtendToDc(merged, noDc));
+    Touchstone::Network extended;
+    QVERIFY2(SParameterCombiner::extendToDc(merged, 2, extended, err), qPrintable(err));
+    QCOMPARE(extended.frequencyCount(), 61);
+    QCOMPARE(extended.frequencies.at(0), 0.0);
+    QCOMPARE(extended.value(0, 0, 0), Touchstone::Complex(0.1, 0.0));
+    QCOMPARE(extended.value(0, 1, 0).imag(), 0.0);
+    QVERIFY(extended.value(1, 1, 0) == merged.value(0, 1, 0));
+
+    // Per-run conversion: named after the directory, with a DC-extended copy for a qualifying sweep.
+    const QString combined = dir.filePath("inductor/combined.s2p");
+    QVERIFY2(Touchstone::write(combined, merged, options, err), qPrintable(err));
+    QStringList written;
+    QVERIFY2(SParameterCombiner::convert(combined, SParameterCombiner::Options(), written, err), qPrintable(err));
+    QCOMPARE(written.size(), 2);
+    QCOMPARE(QFileInfo(written.at(0)).fileName(), QString("inductor.s2p"));
+    QCOMPARE(QFileInfo(written.at(1)).fileName(), QString("inductor_dc.s2p"));
+
+    Touchstone::Network back;
+    QVERIFY2(Touchstone::read(written.at(1), back, err), qPrintable(err));
+    QCOMPARE(back.frequencyCount(), 61);
+    QVERIFY(std::abs(back.value(30, 1, 0) - merged.value(29, 1, 0)) < 1e-6);
+
+    QVERIFY2(SParameterCombiner::convert(low, SParameterCombiner::Options(), written, err), qPrintable(err));
+    QCOMPARE(written.size(), 1);
+}
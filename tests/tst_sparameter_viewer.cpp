@@ -0,0 +1,76 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_sparameter_viewer.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "palacesparameters.h"
+#include "sparameterviewer.h"
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that plot paths stay bounded by the pixel width but keep the extremes, and that Palace port-S.csv
+ *        files are read with missing entries left NaN and an incomplete last row ignored.
+ **********************************************************************************************************************/
+void SParameterViewerTest::sparameterViewer_decimatesAndReadsPalaceCsv()
+{
+    const int n = 100000;
+    QVector<double> x(n);
+    QVector<double> y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = i;
+        y[i] = std::sin(i * 0.37);
+    }
+    y[54321] = 5.0;
+
+    const QRectF area(0, 0, 200, 100);
+    const QRectF range(0, -1, n - 1, 6);
+    const QPainterPath path = SParameterPlot::decimatedPath(x.constData(), y.constData(), n, area, range);
+    QVERIFY(path.elementCount() <= 4 * 201);
+    QCOMPARE(path.boundingRect().top(), 0.0);           // the single spike at y = 5 survives decimation
+
+    QVector<Touchstone::Complex> circle(n);
+    for (int i = 0; i < n; ++i)
+        circle[i] = std::polar(0.5, 2 * M_PI * i / n);
+    const QPainterPath smith = SParameterPlot::smithPath(circle.constData(), 1, n, QRectF(0, 0, 100, 100));
+    QVERIFY(smith.elementCount() < 400);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(QDir(dir.path()).mkpath("postpro"));
+    const QString csvPath = dir.filePath("postpro/port-S.csv");
+
+    QFile csv(csvPath);
+    QVERIFY(csv.open(QIODevice::WriteOnly));
+    csv.write("            f (GHz),      |S[1][1]| (dB),  arg(S[1][1]) (deg.),      |S[2][1]| (dB),  arg(S[2][1]) (deg.)\n"
+              " 1.000000000000e+00, -2.000000000000e+01, +9.000000000000e+01, -6.020599913280e+00, +0.000000000000e+00\n"
+              " 2.000000000000e+00, -1.000000000000e+01, -9.000000000000e+01, -3.000000000000e+00, +4.500000000000e+01\n"
+              " 3.000000000000e+00, -1.0");
+    csv.close();
+
+    QCOMPARE(SParameterViewer::findResultFile(dir.path()), QFileInfo(csvPath).absoluteFilePath());
+
+    Touchstone::Network net;
+    QString err;
+    QVERIFY2(PalaceSParameters::read(csvPath, net, err), qPrintable(err));
+    QCOMPARE(net.ports, 2);
+    QCOMPARE(net.frequencyCount(), 2);
+    QCOMPARE(net.frequencies.at(1), 2e9);
+    QVERIFY(std::abs(net.value(0, 0, 0) - Touchstone::Complex(0.0, 0.1)) < 1e-12);
+    QVERIFY(std::abs(net.value(0, 1, 0) - Touchstone::Complex(0.5, 0.0)) < 1e-9);
+    QVERIFY(std::isnan(net.value(0, 0, 1).real()));      // port 2 was not excited
+}
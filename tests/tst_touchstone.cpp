@@ -0,0 +1,122 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_touchstone.h"
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "touchstone.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies Touchstone parsing (v1 2-port order, MA data, noise section, v2 lower matrix and references)
+ *        and that networks survive a write/read round trip in RI, MA and DB format and both versions.
+ **********************************************************************************************************************/
+void TouchstoneTest::touchstone_readsAndWritesAllFormats()
+{
+    const char *numbers = "  1.5e3 -0.25 12345678901234567890 7x";
+    const char *pos = numbers;
+    const char *end = numbers + qstrlen(numbers);
+    double v = 0.0;
+    QVERIFY(Touchstone::parseNumber(pos, end, v));
+    QCOMPARE(v, 1500.0);
+    QVERIFY(Touchstone::parseNumber(pos, end, v));
+    QCOMPARE(v, -0.25);
+    QVERIFY(Touchstone::parseNumber(pos, end, v));
+    QCOMPARE(v, 12345678901234567890.0);
+    QVERIFY(!Touchstone::parseNumber(pos, end, v));
+
+    QString err;
+    Touchstone::Network net;
+
+    const QByteArray v1 =
+        "! two-port example\n"
+        "# MHz S MA R 50\n"
+        "100 0.5 -90 0.9 45 0.8 30 0.4 180\n"
+        "200 0.6 0   0.7 90 0.1 -90\n"
+        "    0.3 0\n"
+        "! noise parameters\n"
+        "50 1.2 0.3 40 0.5\n";
+    QVERIFY2(Touchstone::parse(v1.constData(), v1.constData() + v1.size(), 2, net, err), qPrintable(err));
+    QCOMPARE(net.ports, 2);
+    QCOMPARE(net.frequencyCount(), 2);
+    QCOMPARE(net.frequencies.at(1), 200e6);
+    QCOMPARE(net.comments.first(), QString("two-port example"));
+    QVERIFY(std::abs(net.value(0, 0, 0) - Touchstone::Complex(0.0, -0.5)) < 1e-12);
+    QVERIFY(std::abs(net.value(0, 1, 0) - std::polar(0.9, M_PI / 4)) < 1e-12);
+    QVERIFY(std::abs(net.value(0, 0, 1) - std::polar(0.8, M_PI / 6)) < 1e-12);
+    QVERIFY(std::abs(net.value(1, 1, 1) - Touchstone::Complex(0.3, 0.0)) < 1e-12);
+
+    const QByteArray v2 =
+        "[Version] 2.0\n"
+        "# GHz S RI R 50\n"
+        "[Number of Ports] 2\n"
+        "[Number of Frequencies] 1\n"
+        "[Reference] 50\n"
+        "75\n"
+        "[Matrix Format] Lower\n"
+        "[Network Data]\n"
+        "1 0.1 0 0.2 0.1 0.3 0\n"
+        "[End]\n";
+    QVERIFY2(Touchstone::parse(v2.constData(), v2.constData() + v2.size(), 0, net, err), qPrintable(err));
+    QCOMPARE(net.references, QVector<double>({50.0, 75.0}));
+    QVERIFY(net.value(0, 1, 0) == Touchstone::Complex(0.2, 0.1));
+    QVERIFY(net.value(0, 0, 1) == Touchstone::Complex(0.2, 0.1));
+    QCOMPARE(net.frequencies.first(), 1e9);
+
+    const QByteArray truncated = "# GHz S RI\n1 0.1 0 0.2\n";
+    QVERIFY(!Touchstone::parse(truncated.constData(), truncated.constData() + truncated.size(), 2, net, err));
+    QVERIFY(err.contains("incomplete"));
+
+    Touchstone::Network source;
+    source.resize(5, 7);
+    source.comments << "round trip";
+    for (int f = 0; f < source.frequencyCount(); ++f) {
+        source.frequencies[f] = 1e9 + f * 0.5e9;
+        for (int r = 0; r < 5; ++r)
+            for (int c = 0; c < 5; ++c)
+                source.setValue(f, r, c, std::polar(0.05 + 0.01 * (r + c + f), 0.1 * (r - 2 * c + f)));
+    }
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QList<QPair<Touchstone::Format, int>> variants = {
+        {Touchstone::Format::RI, 1}, {Touchstone::Format::MA, 1}, {Touchstone::Format::DB, 2}
+    };
+    for (const auto &variant : variants) {
+        Touchstone::WriteOptions options;
+        options.format = variant.first;
+        options.version = variant.second;
+        options.frequencyUnit = "MHz";
+        options.precision = 15;
+
+        const QString path = dir.filePath(QString("net_%1_v%2.%3")
+                                              .arg(int(variant.first))
+                                              .arg(variant.second)
+                                              .arg(Touchstone::fileSuffix(5)));
+        QVERIFY2(Touchstone::write(path, source, options, err), qPrintable(err));
+
+        Touchstone::Network back;
+        QVERIFY2(Touchstone::read(path, back, err), qPrintable(err));
+        QCOMPARE(back.ports, 5);
+        QCOMPARE(back.frequencyCount(), source.frequencyCount());
+        QCOMPARE(back.comments, source.comments);
+        for (int f = 0; f < source.frequencyCount(); ++f) {
+            QVERIFY(qAbs(back.frequencies.at(f) - source.frequencies.at(f)) < 1e-3);
+            for (int r = 0; r < 5; ++r)
+                for (int c = 0; c < 5; ++c)
+                    QVERIFY(std::abs(back.value(f, r, c) - source.value(f, r, c)) < 1e-12);
+        }
+    }
+}
@@ -0,0 +1,93 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_tracer.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+#include <thread>
+
+#include "tracer.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that trace scopes record nothing while tracing is off, and that enabled scopes are written as
+ *        Chrome trace complete events with nesting, thread ids and thread names.
+ **********************************************************************************************************************/
+void TracerTest::tracer_writesNestedScopesAsChromeTrace()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("trace.json");
+
+    QVERIFY(!Tracer::isEnabled());
+    {
+        EMSTUDIO_TRACE_SCOPE("test.disabled");
+    }
+    QCOMPARE(Tracer::eventCount(), 0);
+
+    Tracer::start(path);
+    QVERIFY(Tracer::isEnabled());
+    {
+        EMSTUDIO_TRACE_SCOPE("test.outer", QStringLiteral("model.py"));
+        QTest::qWait(5);
+        {
+            EMSTUDIO_TRACE_SCOPE("test.inner");
+            QTest::qWait(5);
+        }
+    }
+
+    std::thread worker([]() {
+        Tracer::setThreadName(QStringLiteral("worker"));
+        EMSTUDIO_TRACE_SCOPE("test.worker");
+    });
+    worker.join();
+    QCOMPARE(Tracer::eventCount(), 3);
+
+    QString err;
+    QVERIFY2(Tracer::stop(err), qPrintable(err));
+    QVERIFY(!Tracer::isEnabled());
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    QVERIFY(doc.isObject());
+
+    QMap<QString, QJsonObject> complete;
+    QMap<int, QString> threadNames;
+    for (const QJsonValue &value : doc.object().value("traceEvents").toArray()) {
+        const QJsonObject event = value.toObject();
+        if (event.value("ph").toString() == "X")
+            complete[event.value("name").toString()] = event;
+        else if (event.value("name").toString() == "thread_name")
+            threadNames[event.value("tid").toInt()] = event.value("args").toObject().value("name").toString();
+    }
+
+    QCOMPARE(complete.size(), 3);
+    const QJsonObject outer = complete.value("test.outer");
+    const QJsonObject inner = complete.value("test.inner");
+    const QJsonObject worker = complete.value("test.worker");
+
+    QCOMPARE(outer.value("args").toObject().value("detail").toString(), QString("model.py"));
+    QCOMPARE(outer.value("tid").toInt(), inner.value("tid").toInt());
+    QVERIFY(inner.value("ts").toDouble() >= outer.value("ts").toDouble());
+    QVERIFY(inner.value("ts").toDouble() + inner.value("dur").toDouble()
+            <= outer.value("ts").toDouble() + outer.value("dur").toDouble());
+    QVERIFY(outer.value("dur").toDouble() >= 10000.0);
+
+    QVERIFY(worker.value("tid").toInt() != outer.value("tid").toInt());
+    QCOMPARE(threadNames.value(outer.value("tid").toInt()), QString("main"));
+    QCOMPARE(threadNames.value(worker.value("tid").toInt()), QString("worker"));
+}
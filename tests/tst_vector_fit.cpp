@@ -0,0 +1,119 @@
+/************************************************************************
+ *  EMStudio – GUI tool for setting up, running and analysing
+ *  electromagnetic simulations with IHP PDKs.
+ *
+ *  Copyright (C) 2023–2025 IHP Authors
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ ************************************************************************/
+
+#include "tst_vector_fit.h"
+
+#include <QtTest/QtTest>
+#include <QFile>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+#include <QtMath>
+
+#include "sparameterchecks.h"
+#include "touchstone.h"
+#include "vectorfit.h"
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that vector fitting recovers the poles of a rational 2-port, that passivity enforcement makes a
+ *        slightly active response passive, and that the model is written as JSON and SPICE subcircuit.
+ **********************************************************************************************************************/
+void VectorFitTest::vectorFit_fitsPassiveModelAndWritesNetlist()
+{
+    // Two resonances in transmission, a real pole in reflection: five poles in total.
+    const double w = 2 * M_PI * 1e9;
+    const Touchstone::Complex p1(-0.3 * w, 4 * w);
+    const Touchstone::Complex p2(-0.5 * w, 11 * w);
+    const double p3 = -6 * w;
+    auto reference = [&](double hz, int row, int column) {
+        const Touchstone::Complex s(0.0, 2 * M_PI * hz);
+        auto pair = [&](Touchstone::Complex p, Touchstone::Complex r) {
+            return r / (s - p) + std::conj(r) / (s - std::conj(p));
+        };
+        if (row == column)
+            return 0.05 + 0.3 * w / (s - p3) + pair(p1, Touchstone::Complex(0.02 * w, 0.01 * w));
+        return pair(p1, Touchstone::Complex(0.25 * w, 0.0)) + pair(p2, Touchstone::Complex(0.4 * w, 0.05 * w));
+    };
+    auto makeNetwork = [&](double scale) {
+        Touchstone::Network net;
+        net.resize(2, 301);
+        for (int f = 0; f < 301; ++f) {
+            net.frequencies[f] = 0.1e9 + f * 0.1e9;
+            for (int row = 0; row < 2; ++row) {
+                for (int column = 0; column < 2; ++column)
+                    net.setValue(f, row, column, scale * reference(net.frequencies[f], row, column));
+            }
+        }
+        return net;
+    };
+
+    VectorFit::Options options;
+    options.poles = 5;
+    options.enforcePassivity = false;
+    VectorFit::Model model;
+    QString err;
+    QVERIFY2(VectorFit::fit(makeNetwork(1.0), options, model, err), qPrintable(err));
+    QVERIFY(model.isValid());
+    QCOMPARE(model.order(), 5);
+    QVERIFY(model.rmsError < 1e-9);
+    QVERIFY(model.passive);
+    QCOMPARE(model.poles.size(), 3);
+    QVERIFY(std::abs(model.poles.at(0) - Touchstone::Complex(p3, 0.0)) < 1e-6 * w);
+    QVERIFY(std::abs(model.poles.at(1) - p1) < 1e-6 * w);
+    QVERIFY(std::abs(model.poles.at(2) - p2) < 1e-6 * w);
+    QVERIFY(std::abs(model.value(7.3e9, 1, 0) - reference(7.3e9, 1, 0)) < 1e-9);
+
+    Touchstone::Network tooShort;
+    tooShort.resize(2, 5);
+    QVERIFY(!VectorFit::fit(tooShort, options, model, err));
+
+    // 10 % gain makes the transmission peaks active; the enforced model is passive also between the grid points.
+    const Touchstone::Network active = makeNetwork(1.1);
+    QVERIFY(!SParameterChecks::check(active).passed());
+    options.enforcePassivity = true;
+    QVERIFY2(VectorFit::fit(active, options, model, err), qPrintable(err));
+    QVERIFY(model.passive);
+    QVERIFY(model.maxSingularValue <= 1.0);
+    QVERIFY(model.rmsError < 0.02);
+    double largest = 0.0;
+    for (int k = 0; k <= 4000; ++k) {
+        double re[4];
+        double im[4];
+        for (int entry = 0; entry < 4; ++entry) {
+            const Touchstone::Complex v = model.value(k * 15e6, entry / 2, entry % 2);
+            re[entry] = v.real();
+            im[entry] = v.imag();
+        }
+        largest = qMax(largest, SParameterChecks::largestSingularValue(re, im, 2));
+    }
+    QVERIFY2(largest <= 1.0, qPrintable(QString::number(largest)));
+
+    const QByteArray netlist = VectorFit::toSpice(model, "dut");
+    QVERIFY(netlist.contains(".SUBCKT dut p1 p2 ref"));
+    QVERIFY(netlist.contains(".ENDS"));
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY2(VectorFit::writeSpice(dir.filePath("balun_vf.cir"), model, err), qPrintable(err));
+    QVERIFY2(VectorFit::writeJson(dir.filePath("balun_vf.json"), model, err), qPrintable(err));
+
+    QFile cir(dir.filePath("balun_vf.cir"));
+    QVERIFY(cir.open(QIODevice::ReadOnly));
+    QVERIFY(cir.readAll().contains(".SUBCKT balun_vf p1 p2 ref"));
+
+    QFile json(dir.filePath("balun_vf.json"));
+    QVERIFY(json.open(QIODevice::ReadOnly));
+    const QJsonObject root = QJsonDocument::fromJson(json.readAll()).object();
+    QCOMPARE(root.value("ports").toInt(), 2);
+    QCOMPARE(root.value("poles").toArray().size(), 3);
+    QCOMPARE(root.value("residues").toArray().at(1).toArray().at(0).toArray().size(), 3);
+}
@@ -15,10 +15,14 @@
 #include <QtTest/QtTest>
 #include <QDir>
 #include <QMap>
+#include <QFile>
 #include <QVariant>
+#include <QTemporaryDir>
 
 #include "wslHelper.h"
 #include "mainwindow.h"
+#include "pathprobe.h"
+#include "shellsession.h"
 
 /*!*******************************************************************************************************************
  * \brief Verifies that plain local 8-bit/UTF-8 style WSL output is decoded correctly.
@@ -153,3 +157,127 @@ void WslHelperTest::mainWindow_pathExistsPortable_checksLocalPath()
     QVERIFY(w.testPathExistsPortable(QDir::tempPath(), QString(), 1000));
     QVERIFY(!w.testPathExistsPortable(QDir::tempPath() + "/definitely_not_existing_123456", QString(), 1000));
 }
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that ShellSession runs single and batched requests in one local shell, returns stdout and exit
+ *        status per request, and restarts the shell after a command ended it.
+ **********************************************************************************************************************/
+void WslHelperTest::shellSession_framesRequestsOverOneShell()
+{
+#ifdef Q_OS_WIN
+    QSKIP("ShellSession tests require a local /bin/sh");
+#else
+    ShellSession session;
+
+    const ShellSession::Reply echo = session.run("printf 'a b'");
+    QVERIFY(echo.ok);
+    QCOMPARE(echo.exitCode, 0);
+    QCOMPARE(echo.output, QByteArray("a b"));
+
+    const ShellSession::Reply lines = session.run("printf 'x\\n\\ny\\n'");
+    QVERIFY(lines.ok);
+    QCOMPARE(lines.output, QByteArray("x\n\ny\n"));
+
+    QVERIFY(session.run("test -e " + shellQuoteSingle(QDir::tempPath())).exitCode == 0);
+    QCOMPARE(session.run("test -e /definitely_not_existing_123456").exitCode, 1);
+    QCOMPARE(session.run("cat").output, QByteArray());
+
+    const QList<ShellSession::Reply> batch =
+        session.runBatch(QStringList() << "echo one" << "false" << "exit_code() { return 7; }; exit_code"
+                                       << "echo three");
+    QCOMPARE(batch.size(), 4);
+    QCOMPARE(batch.at(0).text(), QString("one"));
+    QCOMPARE(batch.at(1).exitCode, 1);
+    QCOMPARE(batch.at(2).exitCode, 7);
+    QCOMPARE(batch.at(3).text(), QString("three"));
+
+    for (int i = 0; i < 200; ++i)
+        QVERIFY(session.run("test -d /").ok);
+    QCOMPARE(session.startCount(), 1);
+
+    const ShellSession::Reply ended = session.run("exit 3");
+    QVERIFY(!ended.ok);
+    QVERIFY(!ended.timedOut);
+    QVERIFY(!session.isRunning());
+
+    QCOMPARE(session.run("echo back").text(), QString("back"));
+    QCOMPARE(session.startCount(), 2);
+
+    const ShellSession::Reply slow = session.run("sleep 2", 100);
+    QVERIFY(!slow.ok);
+    QVERIFY(slow.timedOut);
+    QCOMPARE(session.run("echo again").text(), QString("again"));
+#endif
+}
+
+/*!*******************************************************************************************************************
+ * \brief Verifies that PathProbe answers mixed queries with one shell round trip, serves repeats from its cache,
+ *        expires negative answers after their TTL and drops everything on invalidate().
+ **********************************************************************************************************************/
+void WslHelperTest::pathProbe_batchesAndMemoizesShellQueries()
+{
+#ifdef Q_OS_WIN
+    QSKIP("PathProbe tests require a local /bin/sh");
+#else
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QString exe = dir.filePath("solver.sh");
+    const QString plain = dir.filePath("model.py");
+    const QString missing = dir.filePath("later.json");
+    for (const QString &path : {exe, plain}) {
+        QFile f(path);
+        QVERIFY(f.open(QIODevice::WriteOnly));
+        f.write("#!/bin/sh\n");
+    }
+    QVERIFY(QFile::setPermissions(exe, QFile::permissions(exe) | QFileDevice::ExeOwner));
+
+    ShellSession session;
+    PathProbe probe(&session);
+    probe.setTtl(60000, 150);
+
+    const QList<PathProbe::Request> requests = {
+        {PathProbe::Query::Exists,     dir.path()},
+        {PathProbe::Query::Executable, exe},
+        {PathProbe::Query::Executable, plain},
+        {PathProbe::Query::Exists,     missing},
+        {PathProbe::Query::LinuxPath,  "~"},
+        {PathProbe::Query::LinuxPath,  dir.path()},
+        {PathProbe::Query::Readable,   plain}
+    };
+
+    QList<PathProbe::Result> results = probe.resolve(requests, QString(), 5000);
+    QCOMPARE(results.size(), requests.size());
+    QVERIFY(results.at(0).ok);
+    QVERIFY(results.at(1).ok);
+    QVERIFY(!results.at(2).ok);
+    QVERIFY(!results.at(3).ok);
+    QCOMPARE(results.at(4).linuxPath, QString::fromLocal8Bit(qgetenv("HOME")));
+    QCOMPARE(results.at(5).linuxPath, dir.path());
+    QVERIFY(results.at(6).ok);
+    QCOMPARE(probe.roundTrips(), 1);
+
+    results = probe.resolve(requests, QString(), 5000);
+    QVERIFY(results.at(1).ok);
+    QVERIFY(!results.at(3).ok);
+    QCOMPARE(probe.roundTrips(), 1);
+    QCOMPARE(probe.cacheHits(), 5);
+
+    QFile later(missing);
+    QVERIFY(later.open(QIODevice::WriteOnly));
+    later.close();
+
+    QVERIFY(!probe.exists(missing, QString(), 5000));
+    QTest::qWait(200);
+    QVERIFY(probe.exists(missing, QString(), 5000));
+    QCOMPARE(probe.roundTrips(), 2);
+
+    QVERIFY(probe.isExecutable(exe, QString(), 5000));
+    QCOMPARE(probe.roundTrips(), 2);
+    probe.invalidate();
+    QVERIFY(probe.isExecutable(exe, QString(), 5000));
+    QCOMPARE(probe.roundTrips(), 3);
+
+    QCOMPARE(session.startCount(), 1);
+#endif
+}
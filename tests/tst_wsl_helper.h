@@ -28,6 +28,8 @@ private slots:
     void listWslDistrosFromSystem_returnsSomething_ifWslAvailable();
     void mainWindow_toLinuxPathPortable_handlesBasicCases_ifWslAvailable();
     void mainWindow_pathExistsPortable_checksLocalPath();
+    void shellSession_framesRequestsOverOneShell();
+    void pathProbe_batchesAndMemoizesShellQueries();
 };
 
 #endif // TST_WSL_HELPER_H